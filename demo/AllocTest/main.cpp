@@ -0,0 +1,230 @@
+// AllocTest/main.cpp : Benchmark the time and the memory allocations of text analysis with different SSML documents.
+//
+
+#include <locale.h>
+#include <stdlib.h>
+#include <new>
+#include <string>
+#include <sstream>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "utils/utl_string.h"
+#include "cmn/cmn_textfile.h"
+#include "ttsbase/tts.text/tts_textparser.h"
+#include "ttsbase/tts.synth/tts_synthesizer.h"
+#include "ttsbase/datamanage/base_utterance.h"
+
+using namespace cst;
+using namespace cst::tts;
+
+///
+/// @brief  Counter of the memory allocations by operator new during the measured calls
+///
+/// The global operator new and new[] of this tool increase the counter atomically (the engine
+/// may allocate memory in other threads), but only between start() and stop(), so that the
+/// allocations of initialization and of the result documents are not counted.
+///
+class CAllocCounter
+{
+public:
+    /// Start counting from zero
+    static void start() {s_count = 0; s_counting = 1;}
+
+    /// Stop counting, return the number of allocations since start()
+    static long stop() {s_counting = 0; return s_count;}
+
+    /// Count one allocation if counting
+    static void count()
+    {
+        if (!s_counting)
+            return;
+#if defined(WIN32)
+        InterlockedIncrement(&s_count);
+#else
+        __sync_fetch_and_add(&s_count, 1);
+#endif
+    }
+
+private:
+    static volatile long s_count;       ///< Number of allocations since start()
+    static volatile long s_counting;    ///< Whether the allocations are counted
+};
+
+volatile long CAllocCounter::s_count    = 0;
+volatile long CAllocCounter::s_counting = 0;
+
+void *operator new(size_t size)
+{
+    CAllocCounter::count();
+    void *p = malloc(size > 0 ? size : 1);
+    if (p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) throw()
+{
+    free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+    operator delete(p);
+}
+
+void displayUsage()
+{
+    std::wcout << L"Usage: AllocTest config_file text_file [repeat]" << std::endl;
+    std::wcout << L"       Perform text analysis, unit segmentation and prosody prediction of the text file for the given" << std::endl;
+    std::wcout << L"       times (default 100), and report the time and the number of memory allocations of each time:" << std::endl;
+    std::wcout << L"       (1) with heap and arena allocated SSML documents, and" << std::endl;
+    std::wcout << L"       (2) through SSML documents and typed utterances." << std::endl;
+    std::wcout << L"       The result documents of each comparison are checked to be identical." << std::endl;
+    std::wcout << L"       The text file is ANSI, or Unicode with byte order mark." << std::endl;
+    std::wcout << L"       (e.g. AllocTest ../../data/putonghua/config.xml text.txt 100)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+/// Text analysis, unit segmentation and prosody prediction, i.e. all passes before waveform generation
+void analyzeText(base::CTextParser &textParser, base::CSynthesizer &synthesizer, const std::wstring &strContent, int path, xml::CSSMLDocument &document)
+{
+    if (path == 0)
+    {
+        // passes on the SSML document
+        textParser.process(strContent.c_str(), ITT_TEXT_RAW, document);
+        synthesizer.unitSegment(&document);
+        synthesizer.prosodyPredict(&document);
+    }
+    else
+    {
+        // passes on the typed utterance
+        base::CUtterance utterance;
+        textParser.process(strContent.c_str(), ITT_TEXT_RAW, utterance);
+        synthesizer.unitSegment(utterance);
+        synthesizer.prosodyPredict(utterance);
+        utterance.toSSML(document);
+    }
+}
+
+/// Compare the text analysis of the given SSML document allocation modes and paths
+void benchAnalysis(base::CTextParser &textParser, base::CSynthesizer &synthesizer, const std::wstring &strContent, int repeat,
+                   const xml::CXMLDocument::EAllocMode allocModes[2], const int paths[2], const wchar_t *names[2])
+{
+    std::wstring strResults[2];
+    double baseTime = 0;
+    for (int m = 0; m < 2; m++)
+    {
+        CAllocCounter::start();
+        double beginTime = getWallTime();
+        for (int i = 0; i < repeat; i++)
+        {
+            if (paths[m] == 0)
+            {
+                xml::CSSMLDocument document(allocModes[m]);
+                analyzeText(textParser, synthesizer, strContent, 0, document);
+            }
+            else
+            {
+                // without converting the utterance to SSML document
+                base::CUtterance utterance;
+                textParser.process(strContent.c_str(), ITT_TEXT_RAW, utterance);
+                synthesizer.unitSegment(utterance);
+                synthesizer.prosodyPredict(utterance);
+            }
+        }
+        double analysisTime = (getWallTime() - beginTime) / repeat;
+        long numAllocations = CAllocCounter::stop() / repeat;
+        if (m == 0)
+            baseTime = analysisTime;
+
+        // the result document (not measured)
+        xml::CSSMLDocument document(allocModes[m]);
+        analyzeText(textParser, synthesizer, strContent, paths[m], document);
+        std::wostringstream stream;
+        document.print(stream);
+        strResults[m] = stream.str();
+
+        std::wcout << L"  " << names[m] << L"\t" << analysisTime * 1000 << L"ms\t" << numAllocations << L" allocations";
+        std::wcout << L"\tspeedup: " << (analysisTime > 0 ? baseTime / analysisTime : 0) << std::endl;
+    }
+    std::wcout << L"  SSML documents are " << (strResults[0] == strResults[1] ? L"identical" : L"DIFFERENT") << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+#if defined(WIN32)
+    setlocale(LC_CTYPE, "chs");
+#elif defined(__GNUC__)
+    setlocale(LC_CTYPE, "en_US.UTF-8");
+#endif
+
+    if (argc < 3)
+    {
+        displayUsage();
+        return -1;
+    }
+    int repeat = (argc > 3) ? atoi(argv[3]) : 100;
+    if (repeat <= 0)
+        repeat = 1;
+
+    // read the whole text file
+    std::wstring strTextFile = str::mbstowcs(argv[2]);
+    cmn::CTextFile textFile;
+    if (!textFile.open(strTextFile.c_str(), L"rb"))
+    {
+        std::wcout << L"Error loading text file " << strTextFile << std::endl;
+        return -1;
+    }
+    std::wstring strContent;
+    textFile.readString(strContent);
+    textFile.close();
+
+    // initialize the TTS engine
+    std::wstring strCfgFile = str::mbstowcs(argv[1]);
+    base::CTextParser  textParser;
+    base::CSynthesizer synthesizer;
+    if (textParser.initialize(strCfgFile.c_str()) != ERROR_SUCCESS || synthesizer.initialize(strCfgFile.c_str()) != ERROR_SUCCESS)
+    {
+        std::wcout << L"Error initializing TTS engine " << strCfgFile << std::endl;
+        return -1;
+    }
+
+    std::wcout << L"Text analysis of " << strContent.length() << L" characters, " << repeat << L" times:" << std::endl;
+
+    // heap and arena allocated SSML documents
+    const xml::CXMLDocument::EAllocMode docModes[] = {xml::CXMLDocument::ALLOC_HEAP, xml::CXMLDocument::ALLOC_ARENA};
+    const int docPaths[] = {0, 0};
+    const wchar_t *docNames[] = {L"heap: ", L"arena:"};
+    benchAnalysis(textParser, synthesizer, strContent, repeat, docModes, docPaths, docNames);
+
+    // SSML documents and typed utterances
+    const xml::CXMLDocument::EAllocMode uttModes[] = {xml::CXMLDocument::ALLOC_ARENA, xml::CXMLDocument::ALLOC_ARENA};
+    const int uttPaths[] = {0, 1};
+    const wchar_t *uttNames[] = {L"document: ", L"utterance:"};
+    benchAnalysis(textParser, synthesizer, strContent, repeat, uttModes, uttPaths, uttNames);
+
+    return 0;
+}
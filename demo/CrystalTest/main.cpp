@@ -2,11 +2,21 @@
 //
 
 #include <locale.h>
+#include <stdlib.h>
+#include <string.h>
 #include <string>
 #include <fstream>
 #include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
 
 #include "utils/utl_string.h"
+#include "cmn/cmn_textfile.h"
+#include "cmn/cmn_thread.h"
+#include "cmn/cmn_trace.h"
 #include "dsp/dsp_wavefile.h"
 #include "dsp/dsp_waveplay.h"
 #include "ttsbase/tts.text/tts_textparser.h"
@@ -30,6 +40,11 @@ void displayUsage()
 #endif
     std::wcout << L"  speak  text - speak the input text" << std::endl;
     std::wcout << L"  speakW text - speak the input text to wave file" << std::endl;
+    std::wcout << L"  bench  file - benchmark synthesis of text file with 1, 2, 4, ... threads" << std::endl;
+    std::wcout << L"  benchB - benchmark appending 10k speech segments to wave data" << std::endl;
+    std::wcout << L"  benchW file - benchmark word segmentation of text file (characters per second)" << std::endl;
+    std::wcout << L"  trace  file - trace the latency of each stage of text analysis and synthesis of text file," << std::endl;
+    std::wcout << L"                save to trace.json (stages) and trace.chrome.json (chrome://tracing)" << std::endl;
     std::wcout << std::endl;
 }
 
@@ -160,6 +175,210 @@ int speakText(base::CTextParser *pTextParser, base::CSynthesizer *pSynthesizer,
     return ERROR_SUCCESS;
 }
 
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+int readTextFile(const std::wstring &strTextFile, std::wstring &strContent)
+{
+    cmn::CTextFile textFile;
+    if (!textFile.open(strTextFile.c_str(), L"rb"))
+    {
+        std::wcout << L"Text file: '" << strTextFile << L"' open failed!" << std::endl;
+        return ERROR_OPEN_FAILED;
+    }
+    textFile.readString(strContent);
+    textFile.close();
+    return ERROR_SUCCESS;
+}
+
+int benchText(base::CTextParser *pTextParser, base::CSynthesizer *pSynthesizer, const std::wstring &strTextFile)
+{
+    // read the whole text file
+    std::wstring strContent;
+    int retCode = readTextFile(strTextFile, strContent);
+    if (retCode != ERROR_SUCCESS)
+        return retCode;
+
+    // numbers of worker threads: 1, 2, 4, ..., and the number of processors
+    int numProcessors = cmn::CThread::getProcessorNumber();
+    std::vector<int> numWorkers;
+    for (int n = 1; n < numProcessors; n *= 2)
+        numWorkers.push_back(n);
+    numWorkers.push_back(numProcessors);
+    if (numProcessors == 1)
+        numWorkers.push_back(2);
+
+    base::TTSSetting setting;
+    pSynthesizer->getSetting(setting);
+
+    std::wcout << std::endl << L"Processors: " << numProcessors << std::endl;
+    double baseTime = 0;
+    for (std::vector<int>::const_iterator it = numWorkers.begin(); it != numWorkers.end(); ++it)
+    {
+        // text analysis (not measured)
+        xml::CSSMLDocument document;
+        pTextParser->process(strContent.c_str(), ITT_TEXT_RAW, document);
+
+        // speech synthesis with the number of worker threads
+        setting.workers = *it;
+        dsp::CWaveData waveData;
+        double beginTime = getWallTime();
+        pSynthesizer->process(document, waveData, setting);
+        double synthTime = getWallTime() - beginTime;
+        if (it == numWorkers.begin())
+            baseTime = synthTime;
+
+        double waveTime = (double)waveData.getLength() / (waveData.getSamplesPerSec() * waveData.getBitsPerSample() / 8 * waveData.getChannels());
+        std::wcout << L"Threads: " << *it << L"\tsynthesis: " << synthTime << L"s\tspeech: " << waveTime << L"s";
+        std::wcout << L"\treal-time factor: " << (waveTime > 0 ? synthTime / waveTime : 0);
+        std::wcout << L"\tspeedup: " << (synthTime > 0 ? baseTime / synthTime : 0) << std::endl;
+    }
+    std::wcout << std::endl;
+    return ERROR_SUCCESS;
+}
+
+int benchWordSegment(base::CTextParser *pTextParser, const std::wstring &strTextFile)
+{
+    // read the whole text file
+    std::wstring strContent;
+    int retCode = readTextFile(strTextFile, strContent);
+    if (retCode != ERROR_SUCCESS)
+        return retCode;
+
+    // text analysis before word segmentation (not measured)
+    xml::CSSMLDocument document;
+    pTextParser->preProcess(&document, strContent, ITT_TEXT_RAW);
+    pTextParser->langConvert(&document);
+    pTextParser->textSegment(&document);
+    pTextParser->docStructAnalyze(&document);
+    pTextParser->textNormalize(&document);
+
+    // word segmentation
+    double beginTime = getWallTime();
+    pTextParser->wordSegment(&document);
+    double wdsegTime = getWallTime() - beginTime;
+
+    std::wcout << std::endl << L"Word segmentation: " << strContent.length() << L" characters in " << wdsegTime << L"s";
+    std::wcout << L"\t" << (wdsegTime > 0 ? strContent.length() / wdsegTime : 0) << L" characters/s" << std::endl;
+    std::wcout << std::endl;
+    return ERROR_SUCCESS;
+}
+
+int traceText(base::CTextParser *pTextParser, base::CSynthesizer *pSynthesizer, const std::wstring &strTextFile)
+{
+    // read the whole text file
+    std::wstring strContent;
+    int retCode = readTextFile(strTextFile, strContent);
+    if (retCode != ERROR_SUCCESS)
+        return retCode;
+
+    // text analysis and speech synthesis, recording the spans of the stages in the trace
+    cmn::CTrace trace;
+    pTextParser->setTrace(&trace);
+    pSynthesizer->setTrace(&trace);
+    xml::CSSMLDocument document;
+    dsp::CWaveData waveData;
+    retCode = pTextParser->process(strContent.c_str(), ITT_TEXT_RAW, document);
+    if (retCode == ERROR_SUCCESS)
+        retCode = pSynthesizer->process(document, waveData);
+    pTextParser->setTrace(NULL);
+    pSynthesizer->setTrace(NULL);
+    if (retCode != ERROR_SUCCESS)
+    {
+        std::wcout << L"Processing failed!" << std::endl;
+        return retCode;
+    }
+
+    // the spans (indented by depth) and the counters
+#if defined(CST_DISABLE_TRACE)
+    std::wcout << std::endl << L"Tracing is disabled by CST_DISABLE_TRACE." << std::endl;
+#endif
+    std::wcout << std::endl << L"Stages of " << strContent.length() << L" characters (ms):" << std::endl;
+    const std::vector<cmn::CTrace::CSpan> &spans = trace.getSpans();
+    for (std::vector<cmn::CTrace::CSpan>::const_iterator it = spans.begin(); it != spans.end(); ++it)
+    {
+        std::wstring name = std::wstring(it->depth * 2 + 2, L' ') + str::mbstowcs(it->name);
+        name.resize((name.length() < 32) ? 32 : name.length(), L' ');
+        std::wcout << name << (it->end - it->begin) * 1000 << std::endl;
+    }
+    std::wcout << L"Counters:" << std::endl;
+    const std::vector<cmn::CTrace::CCounter> &counters = trace.getCounters();
+    for (std::vector<cmn::CTrace::CCounter>::const_iterator it = counters.begin(); it != counters.end(); ++it)
+    {
+        std::wstring name = L"  " + str::mbstowcs(it->name);
+        name.resize((name.length() < 32) ? 32 : name.length(), L' ');
+        std::wcout << name << (long)it->value << std::endl;
+    }
+
+    if (!trace.saveJSON(L"trace.json") || !trace.saveChromeTrace(L"trace.chrome.json"))
+        std::wcout << L"Trace file save failed!" << std::endl;
+    else
+        std::wcout << L"Trace saved to trace.json and trace.chrome.json" << std::endl;
+    std::wcout << std::endl;
+    return ERROR_SUCCESS;
+}
+
+int benchBuffer()
+{
+    const int numSegments = 10000;
+    const int segLength   = 320;    // 10ms of 16kHz 16-bit speech, in byte
+    std::vector<unsigned char> segment(segLength, 1);
+
+    // append with re-allocation of exact size each time (as before geometric growth)
+    double beginTime = getWallTime();
+    unsigned char *pData = NULL;
+    unsigned long nLength = 0;
+    for (int i = 0; i < numSegments; i++)
+    {
+        unsigned char *pTmpData = new unsigned char[nLength + segLength];
+        if (nLength > 0)
+            memcpy(pTmpData, pData, nLength);
+        memcpy(pTmpData + nLength, &segment[0], segLength);
+        delete[] pData;
+        pData = pTmpData;
+        nLength += segLength;
+    }
+    delete[] pData;
+    double exactTime = getWallTime() - beginTime;
+
+    // append to wave data
+    beginTime = getWallTime();
+    dsp::CWaveData waveData;
+    for (int i = 0; i < numSegments; i++)
+    {
+        waveData.appendData(&segment[0], segLength);
+    }
+    double appendTime = getWallTime() - beginTime;
+
+    // append to wave data with reserved buffer
+    beginTime = getWallTime();
+    dsp::CWaveData waveReserved;
+    waveReserved.reserve(numSegments * segLength);
+    for (int i = 0; i < numSegments; i++)
+    {
+        waveReserved.appendData(&segment[0], segLength);
+    }
+    double reserveTime = getWallTime() - beginTime;
+
+    std::wcout << std::endl << L"Appending " << numSegments << L" segments of " << segLength << L" bytes:" << std::endl;
+    std::wcout << L"  exact-size re-allocation: " << exactTime << L"s" << std::endl;
+    std::wcout << L"  CWaveData::appendData:    " << appendTime << L"s" << std::endl;
+    std::wcout << L"  with CWaveData::reserve:  " << reserveTime << L"s" << std::endl;
+    std::wcout << std::endl;
+    return ERROR_SUCCESS;
+}
+
 void parseCommand(const std::wstring &cmdline, std::wstring &command, std::wstring &argument)
 {
     size_t i = 0, j = 0, len = cmdline.length();
@@ -272,6 +491,22 @@ int main(int argc, char* argv[])
             std::getline(std::wcin, waveFile);
             speakText(pTextParser, pSynthesizer, strText, isStepMode, isPartialSSML, waveFile, false);
         }
+        else if (command == L"bench")
+        {
+            benchText(pTextParser, pSynthesizer, strText);
+        }
+        else if (command == L"benchB")
+        {
+            benchBuffer();
+        }
+        else if (command == L"benchW")
+        {
+            benchWordSegment(pTextParser, strText);
+        }
+        else if (command == L"trace")
+        {
+            traceText(pTextParser, pSynthesizer, strText);
+        }
         else
         {
             displayUsage();
@@ -0,0 +1,214 @@
+// HtsThreadTest/main.cpp : Check that HTS synthesis contexts running concurrently give the same speech as running one by one.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "htslib/hts_synthesizer.h"
+#include "cmn/cmn_thread.h"
+
+using namespace cst;
+using namespace cst::tts;
+
+void displayUsage()
+{
+    std::cout << "Usage: HtsThreadTest model_path config_file label_file [threads] [repeat]" << std::endl;
+    std::cout << "       Synthesize the labels of the label file with several speech rates, pitches and streaming settings one by one," << std::endl;
+    std::cout << "       then synthesize them again by the given number of threads (default 4) sharing the same HTS synthesizer" << std::endl;
+    std::cout << "       for the given times (default 5), and check that the speech of each thread is identical to the former." << std::endl;
+    std::cout << "       The label file can be saved by the HTS synthesizer (SynthCfg::fnOutDur)." << std::endl;
+    std::cout << "       (e.g. HtsThreadTest ../../data/putonghua/hts hts.cfg utterance.lab 8 10)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+///
+/// @brief  The wave sink collecting the speech of all chunks
+///
+class CCollectSink : public hts::CWaveSink
+{
+public:
+    CCollectSink(std::vector<short> &wave) : wavData(wave) {}
+    virtual bool write(const short *data, int numSamples)
+    {
+        wavData.insert(wavData.end(), data, data + numSamples);
+        return true;
+    }
+protected:
+    std::vector<short> &wavData;    ///< The collected speech
+};
+
+///
+/// @brief  One synthesis request: the settings and the speech synthesized one by one
+///
+struct SynthJob
+{
+    float speedRate;                ///< Speech rate
+    float halfTone;                 ///< Pitch shift in half-tones
+    bool  streaming;                ///< Whether the speech is passed to the wave sink chunk by chunk
+    std::vector<short> reference;   ///< The speech synthesized one by one
+};
+
+/// Synthesize the labels with the settings of the job
+bool synthesize(const hts::CHtsSynthesizer &synthesizer, const std::vector<hts::LabelInfo> &labels, const SynthJob &job, std::vector<short> &wavData)
+{
+    hts::SynthCfg synCfg;
+    CCollectSink sink(wavData);
+    synCfg.usePhoneAlignment = false;
+    synCfg.speedRate  = job.speedRate;
+    synCfg.halfTone   = job.halfTone;
+    synCfg.outWavData = !job.streaming;
+    synCfg.waveSink   = job.streaming ? &sink : NULL;
+    wavData.clear();
+    if (!synthesizer.synthesize(labels, synCfg))
+        return false;
+    if (!job.streaming)
+        wavData.swap(synCfg.wavData);
+    return true;
+}
+
+///
+/// @brief  The thread synthesizing all jobs for the given times, starting from different jobs
+///
+class CSynthThread : public cmn::CThread
+{
+public:
+    CSynthThread(const hts::CHtsSynthesizer &synth, const std::vector<hts::LabelInfo> &labelInfo, const std::vector<SynthJob> &synthJobs, int first, int times) :
+        synthesizer(synth), labels(labelInfo), jobs(synthJobs), firstJob(first), repeat(times), numSynthesized(0), numDiffs(0) {}
+protected:
+    virtual void run()
+    {
+        std::vector<short> wavData;
+        for (int i = 0; i < repeat * (int)jobs.size(); i++)
+        {
+            const SynthJob &job = jobs[(firstJob + i) % jobs.size()];
+            if (!synthesize(synthesizer, labels, job, wavData) || wavData != job.reference)
+                numDiffs++;
+            numSynthesized++;
+        }
+    }
+public:
+    const hts::CHtsSynthesizer &synthesizer;    ///< The synthesizer shared by all threads
+    const std::vector<hts::LabelInfo> &labels;  ///< The labels to be synthesized
+    const std::vector<SynthJob> &jobs;          ///< The jobs with the speech synthesized one by one
+    int firstJob;                               ///< Index of the first job of the thread
+    int repeat;                                 ///< Times of synthesizing all jobs
+    int numSynthesized;                         ///< Number of synthesized jobs
+    int numDiffs;                               ///< Number of jobs whose speech are different from the reference
+};
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        displayUsage();
+        return -1;
+    }
+    int numThreads = (argc > 4) ? atoi(argv[4]) : 4;
+    int repeat = (argc > 5) ? atoi(argv[5]) : 5;
+
+    // load labels, time information is removed
+    std::ifstream fin(argv[3]);
+    if (!fin)
+    {
+        std::cout << "Error loading label file " << argv[3] << std::endl;
+        return -1;
+    }
+    std::string line;
+    std::vector<hts::LabelInfo> labels;
+    while (std::getline(fin, line))
+    {
+        std::string::size_type pos = line.find_last_of(" \t");
+        hts::LabelInfo label;
+        label.context = (pos == std::string::npos) ? line : line.substr(pos + 1);
+        if (!label.context.empty() && label.context[label.context.length()-1] == '\r')
+            label.context.erase(label.context.length()-1);
+        if (!label.context.empty())
+            labels.push_back(label);
+    }
+
+    hts::CHtsSynthesizer synthesizer;
+    if (!synthesizer.open(argv[1], argv[2]))
+    {
+        std::cout << "Error loading HTS models " << argv[1] << "/" << argv[2] << std::endl;
+        return -1;
+    }
+
+    // synthesize all jobs one by one as the reference
+    const float speedRates[] = {1.0f, 1.3f, 0.8f};
+    const float halfTones[]  = {0.0f, 2.0f, -3.0f};
+    std::vector<SynthJob> jobs;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int streaming = 0; streaming < 2; streaming++)
+        {
+            SynthJob job;
+            job.speedRate = speedRates[i];
+            job.halfTone  = halfTones[i];
+            job.streaming = (streaming != 0);
+            jobs.push_back(job);
+        }
+    }
+    double serialTime = getWallTime();
+    for (std::vector<SynthJob>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+    {
+        if (!synthesize(synthesizer, labels, *it, it->reference) || it->reference.empty())
+        {
+            std::cout << "Error synthesizing labels " << argv[3] << std::endl;
+            return -1;
+        }
+    }
+    serialTime = getWallTime() - serialTime;
+
+    // synthesize all jobs by the threads concurrently
+    std::vector<CSynthThread*> threads;
+    double concurrentTime = getWallTime();
+    for (int i = 0; i < numThreads; i++)
+    {
+        CSynthThread *pThread = new CSynthThread(synthesizer, labels, jobs, i, repeat);
+        if (!pThread->start())
+        {
+            std::cout << "Error starting thread " << i << std::endl;
+            delete pThread;
+            break;
+        }
+        threads.push_back(pThread);
+    }
+    int numSynthesized = 0, numDiffs = 0;
+    for (std::vector<CSynthThread*>::iterator it = threads.begin(); it != threads.end(); ++it)
+    {
+        (*it)->join();
+        numSynthesized += (*it)->numSynthesized;
+        numDiffs += (*it)->numDiffs;
+        delete *it;
+    }
+    concurrentTime = getWallTime() - concurrentTime;
+
+    std::cout << "One by one: " << jobs.size() << " jobs in " << serialTime * 1e3 << "ms" << std::endl;
+    std::cout << "Concurrent: " << numSynthesized << " jobs by " << threads.size() << " threads in " << concurrentTime * 1e3 << "ms";
+    std::cout << "\tspeedup: " << (concurrentTime > 0 ? serialTime * numSynthesized / jobs.size() / concurrentTime : 0) << std::endl;
+    std::cout << "Different from one by one: " << numDiffs << std::endl;
+    return (numDiffs == 0 && numSynthesized == numThreads * repeat * (int)jobs.size()) ? 0 : 1;
+}
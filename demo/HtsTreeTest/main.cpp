@@ -0,0 +1,369 @@
+// HtsTreeTest/main.cpp : Check that the compiled decision trees of HTS engine find the same PDFs as the trees in the tree files.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "htslib/hts_synthesizer.h"
+
+using namespace cst::tts;
+
+void displayUsage()
+{
+    std::cout << "Usage: HtsTreeTest model_path config_file label_file [variants]" << std::endl;
+    std::cout << "       Find the tree and PDF of the duration and of each state of mgc, lf0 and lpf for the labels of the label file," << std::endl;
+    std::cout << "       and for the given number (default 20) of variants of each label mixing its fields with another label," << std::endl;
+    std::cout << "       by the compiled decision trees of HTS engine and by matching the patterns of the tree files directly," << std::endl;
+    std::cout << "       then check that they are identical." << std::endl;
+    std::cout << "       The configuration should give the tree files. The label file can be saved by the HTS synthesizer (SynthCfg::fnOutDur)." << std::endl;
+    std::cout << "       (e.g. HtsTreeTest ../../data/putonghua/hts hts.cfg utterance.lab 50)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+/// Match the string with the pattern, where '*' matches any characters and '?' matches one character
+bool matchPattern(const char *str, const char *pattern)
+{
+    for (; *pattern != '\0'; str++, pattern++)
+    {
+        if (*pattern == '*')
+        {
+            for (const char *p = str; ; p++)
+            {
+                if (matchPattern(p, pattern + 1))
+                    return true;
+                if (*p == '\0')
+                    return false;
+            }
+        }
+        if (*str == '\0' || (*pattern != '?' && *pattern != *str))
+            return false;
+    }
+    return *str == '\0';
+}
+
+/// Whether the string matches any of the patterns
+bool matchAny(const std::string &str, const std::vector<std::string> &patterns)
+{
+    for (std::vector<std::string>::const_iterator it = patterns.begin(); it != patterns.end(); ++it)
+    {
+        if (matchPattern(str.c_str(), it->c_str()))
+            return true;
+    }
+    return false;
+}
+
+///
+/// @brief  Decision trees searched by matching the patterns of the tree file directly, as the reference
+///
+class CReferenceTrees
+{
+public:
+    /// Load the questions and the trees of the tree file
+    bool load(const std::string &fileName)
+    {
+        std::ifstream fin(fileName.c_str());
+        if (!fin)
+            return false;
+        std::string token;
+        while (fin >> token)
+        {
+            if (token == "QS")
+            {
+                // QS name { "pattern","pattern",... }
+                std::string name, line;
+                fin >> name;
+                std::getline(fin, line);
+                std::vector<std::string> &patterns = questions[name];
+                for (std::string::size_type pos = line.find('"'); pos != std::string::npos; pos = line.find('"', pos))
+                {
+                    std::string::size_type end = line.find('"', pos + 1);
+                    patterns.push_back(line.substr(pos + 1, end - pos - 1));
+                    pos = end + 1;
+                }
+            }
+            else if (token.find('[') != std::string::npos)
+            {
+                // {pattern,pattern,...}[state], followed by the nodes, or the name of PDF if it is a single leaf
+                CTree tree;
+                tree.state = atoi(token.c_str() + token.find('[') + 1);
+                std::string::size_type left = token.find('{'), right = token.rfind('}');
+                std::string list = (left != std::string::npos && right != std::string::npos) ? token.substr(left + 1, right - left - 1) : "";
+                if (!list.empty() && list[0] == '(' && list[list.length()-1] == ')')
+                    list = list.substr(1, list.length() - 2);
+                for (std::string::size_type pos = 0; !list.empty(); )
+                {
+                    std::string::size_type end = list.find(',', pos);
+                    tree.patterns.push_back(list.substr(pos, end - pos));
+                    if (end == std::string::npos)
+                        break;
+                    pos = end + 1;
+                }
+                fin >> token;
+                if (token == "{")
+                {
+                    // index question no yes
+                    std::string index, quest, no, yes;
+                    while (fin >> index && index != "}" && fin >> quest >> no >> yes)
+                    {
+                        CNode &node = tree.nodes[atoi(index.c_str())];
+                        node.quest = &questions[quest];
+                        node.child[0] = parseChild(no, node.leaf[0]);
+                        node.child[1] = parseChild(yes, node.leaf[1]);
+                    }
+                }
+                else
+                {
+                    bool leaf;
+                    tree.pdf = parseChild(token, leaf);
+                }
+                trees.push_back(tree);
+            }
+        }
+        return !trees.empty();
+    }
+
+    /// Find the tree (starting from 2) of the state (any state if negative) and its PDF (starting from 1), false if not found
+    bool find(const std::string &label, int state, int &treeIndex, int &pdfIndex) const
+    {
+        for (size_t i = 0; i < trees.size(); i++)
+        {
+            const CTree &tree = trees[i];
+            if ((state >= 0 && tree.state != state) || (!tree.patterns.empty() && !matchAny(label, tree.patterns)))
+                continue;
+            treeIndex = (int)i + 2;
+            if (tree.nodes.empty())
+            {
+                pdfIndex = tree.pdf;
+                return true;
+            }
+            std::map<int, CNode>::const_iterator it = tree.nodes.find(0);
+            while (it != tree.nodes.end())
+            {
+                int answer = matchAny(label, *it->second.quest) ? 1 : 0;
+                if (it->second.leaf[answer])
+                {
+                    pdfIndex = it->second.child[answer];
+                    return true;
+                }
+                it = tree.nodes.find(it->second.child[answer]);
+            }
+            return false;
+        }
+        return false;
+    }
+
+protected:
+    /// Parse the child, which is either the index of node or the name of PDF ending with its index
+    static int parseChild(const std::string &str, bool &leaf)
+    {
+        std::string::size_type pos = str.find_last_not_of("0123456789\"");
+        leaf = (str.find_first_not_of("-0123456789") != std::string::npos);
+        return leaf ? atoi(str.c_str() + pos + 1) : atoi(str.c_str());
+    }
+
+    struct CNode
+    {
+        const std::vector<std::string> *quest;  ///< Patterns of the question
+        int child[2];                           ///< Children for answer no/yes, index of node or PDF
+        bool leaf[2];                           ///< Whether the children are PDFs
+    };
+
+    struct CTree
+    {
+        CTree() : state(0), pdf(0) {}
+        int state;                              ///< State of the tree
+        std::vector<std::string> patterns;      ///< Patterns of the labels using the tree, empty for all labels
+        std::map<int, CNode> nodes;             ///< Nodes by their indices, empty if the tree is a single leaf
+        int pdf;                                ///< PDF if the tree is a single leaf
+    };
+
+    std::map<std::string, std::vector<std::string> > questions; ///< Patterns of questions by their names
+    std::vector<CTree> trees;                                    ///< Trees in the order of tree file
+};
+
+///
+/// @brief  HTS synthesizer which exposes the models of the engine
+///
+class CHtsTreeTester : public hts::CHtsSynthesizer
+{
+public:
+    /// Load the models, and the tree files of duration, mgc, lf0 and lpf as the reference
+    bool load(const char *modelPath, const char *configFile, std::vector<CReferenceTrees> &references)
+    {
+        hts::HtsCfg htsCfg;
+        if (!loadConfig(modelPath, configFile, htsCfg) || !open(htsCfg))
+            return false;
+        const std::vector<std::string> *treeFiles[] = {&htsCfg.fnTreeDur, &htsCfg.fnTreeMgc, &htsCfg.fnTreeLf0, &htsCfg.fnTreeLpf};
+        references.resize(4);
+        for (int i = 0; i < 4; i++)
+        {
+            if (treeFiles[i]->empty() || !references[i].load((*treeFiles[i])[0]))
+                return false;
+        }
+        return true;
+    }
+
+    /// Parse the label into the context features tested by the compiled trees
+    void parse(const std::string &label, std::vector<unsigned int> &feature)
+    {
+        feature.resize(HTS_ModelSet_get_feature_size(&engine.ms) + 1);
+        HTS_ModelSet_get_feature(&engine.ms, label.c_str(), &feature[0]);
+    }
+
+    /// Find the tree and PDF of the duration (stream 0) or of the state of each stream (1 for mgc, ...) by the compiled trees
+    void find(const std::vector<unsigned int> &feature, int stream, int state, int &treeIndex, int &pdfIndex)
+    {
+        if (stream == 0)
+            HTS_ModelSet_get_duration_index(&engine.ms, &feature[0], &treeIndex, &pdfIndex, 0);
+        else
+            HTS_ModelSet_get_parameter_index(&engine.ms, &feature[0], &treeIndex, &pdfIndex, stream - 1, state, 0);
+    }
+
+    /// Number of states of each model
+    int getStateNumber() {return HTS_ModelSet_get_nstate(&engine.ms);}
+};
+
+/// Split the label into fields, each of which is the separator followed by the value
+void splitFields(const std::string &label, std::vector<std::string> &fields)
+{
+    fields.clear();
+    std::string::size_type begin = 0;
+    for (std::string::size_type i = 1; i <= label.length(); i++)
+    {
+        if (i == label.length() || strchr("^-+=@_/:&#$!;|<>", label[i]) != NULL)
+        {
+            fields.push_back(label.substr(begin, i - begin));
+            begin = i;
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        displayUsage();
+        return -1;
+    }
+    int variants = (argc > 4) ? atoi(argv[4]) : 20;
+
+    // load labels, time information is removed
+    std::ifstream fin(argv[3]);
+    if (!fin)
+    {
+        std::cout << "Error loading label file " << argv[3] << std::endl;
+        return -1;
+    }
+    std::string line;
+    std::vector<std::string> labels;
+    while (std::getline(fin, line))
+    {
+        std::string::size_type pos = line.find_last_of(" \t");
+        std::string context = (pos == std::string::npos) ? line : line.substr(pos + 1);
+        if (!context.empty() && context[context.length()-1] == '\r')
+            context.erase(context.length()-1);
+        if (!context.empty())
+            labels.push_back(context);
+    }
+    if (labels.empty())
+    {
+        std::cout << "No label in label file " << argv[3] << std::endl;
+        return -1;
+    }
+
+    // variants mix the fields of two labels, so that the labels reach other branches of the trees
+    srand(0);
+    size_t numLabels = labels.size();
+    std::vector<std::string> fields1, fields2;
+    for (size_t i = 0; i < numLabels; i++)
+    {
+        for (int k = 0; k < variants; k++)
+        {
+            splitFields(labels[i], fields1);
+            splitFields(labels[rand() % numLabels], fields2);
+            std::string variant;
+            for (size_t j = 0; j < fields1.size(); j++)
+                variant += (j < fields2.size() && rand() % 2 == 0) ? fields2[j] : fields1[j];
+            labels.push_back(variant);
+        }
+    }
+
+    CHtsTreeTester tester;
+    std::vector<CReferenceTrees> references;
+    if (!tester.load(argv[1], argv[2], references))
+    {
+        std::cout << "Error loading HTS models and tree files " << argv[1] << "/" << argv[2] << std::endl;
+        return -1;
+    }
+
+    // find the trees and PDFs of all labels
+    const char *streamNames[] = {"duration", "mgc", "lf0", "lpf"};
+    int numStates = tester.getStateNumber();
+    int numErrors = 0;
+    for (int stream = 0; stream < 4; stream++)
+    {
+        int numStreamStates = (stream == 0) ? 1 : numStates;
+        std::vector<int> treeIndices(labels.size() * numStreamStates), pdfIndices(labels.size() * numStreamStates);
+
+        // each label is parsed once for all states, as in synthesis
+        std::vector<unsigned int> feature;
+        double compiledTime = getWallTime();
+        for (size_t i = 0; i < labels.size(); i++)
+        {
+            tester.parse(labels[i], feature);
+            for (int s = 0; s < numStreamStates; s++)
+                tester.find(feature, stream, s + 2, treeIndices[i * numStreamStates + s], pdfIndices[i * numStreamStates + s]);
+        }
+        compiledTime = getWallTime() - compiledTime;
+
+        int numDiffs = 0;
+        double referenceTime = getWallTime();
+        for (size_t i = 0; i < labels.size(); i++)
+        {
+            for (int s = 0; s < numStreamStates; s++)
+            {
+                int treeIndex = -1, pdfIndex = -1;
+                references[stream].find(labels[i], (stream == 0) ? -1 : s + 2, treeIndex, pdfIndex);
+                if (treeIndex == treeIndices[i * numStreamStates + s] && pdfIndex == pdfIndices[i * numStreamStates + s])
+                    continue;
+                if (numDiffs++ < 5)
+                {
+                    std::cout << "  " << streamNames[stream] << " state " << s + 2 << ": tree " << treeIndices[i * numStreamStates + s] << " pdf " << pdfIndices[i * numStreamStates + s];
+                    std::cout << ", reference tree " << treeIndex << " pdf " << pdfIndex << ", label " << labels[i] << std::endl;
+                }
+            }
+        }
+        referenceTime = getWallTime() - referenceTime;
+        numErrors += numDiffs;
+
+        std::cout << streamNames[stream] << ": " << labels.size() << " labels x " << numStreamStates << " states\tdifferent: " << numDiffs;
+        std::cout << "\tcompiled: " << compiledTime * 1e3 << "ms\treference: " << referenceTime * 1e3 << "ms" << std::endl;
+    }
+
+    std::cout << (numErrors == 0 ? "All trees and PDFs are identical." : "Trees or PDFs are different!") << std::endl;
+    return (numErrors == 0) ? 0 : 1;
+}
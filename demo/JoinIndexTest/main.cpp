@@ -0,0 +1,483 @@
+// JoinIndexTest/main.cpp : Compile the join index of a speech library, and measure the unit selection with and without it.
+//
+// Unit selection with the spectral join cost (see CJoinIndex) on a synthetic speech library with wave data:
+//  - without join index, the boundary features are extracted from the wave data of each candidate;
+//  - with join index, the features are read from the mapped sidecar file;
+//  - with join index and pairs, the join costs of the frequent pairs are looked up as well.
+// The frequent pairs are counted from the join costs evaluated in the unit selection of training sentences.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "cmn/cmn_error.h"
+#include "cmn/cmn_file.h"
+#include "utils/utl_string.h"
+#include "ttsbase/datavoice/data_voicedata.h"
+#include "ttsbase/synth.concat/splib_speechlib.h"
+#include "ttsbase/synth.concat/splib_joinindex.h"
+#include "ttsbase/synth.concat/synth_concatenate.h"
+
+using namespace cst;
+using namespace cst::tts;
+
+void displayUsage()
+{
+    std::cout << "Usage: JoinIndexTest index_file [units] [pairs] [sentences] [max_candidates] [beam]" << std::endl;
+    std::cout << "       Compile the join index of a synthetic speech library into the index file, then select the units" << std::endl;
+    std::cout << "       of random sentences without the join index, with the join index, and with the join index and the" << std::endl;
+    std::cout << "       join costs of the frequent pairs, and report the selection time per sentence." << std::endl;
+    std::cout << "       units: number of speech units of each phoneme in the library (default 200)" << std::endl;
+    std::cout << "       pairs: maximum number of frequent pairs whose join costs are precomputed (default 1000000)" << std::endl;
+    std::cout << "       sentences: number of sentences for counting the pairs, and for testing (default 200)" << std::endl;
+    std::cout << "       max_candidates: maximum number of candidates of each unit (default 64)" << std::endl;
+    std::cout << "       beam: beam width of the search (default 16)" << std::endl;
+    std::cout << "       (e.g. JoinIndexTest joinindex.bin 500 2000000 500 64 16)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+/// Uniform random number in [low, high)
+double uniform(double low, double high)
+{
+    return low + (high - low) * rand() / ((double)RAND_MAX + 1);
+}
+
+/// Random prosody of a syllable: duration, amplitude and a rising or falling pitch contour
+void randomProsody(float &duration, float &amplitude, float contour[10])
+{
+    duration  = (float)uniform(150, 350);
+    amplitude = (float)uniform(2000, 12000);
+    double start = uniform(100, 250), end = uniform(100, 250);
+    for (int i = 0; i < 10; i++)
+        contour[i] = (float)(start + (end - start) * i / 9);
+}
+
+///
+/// @brief  Speech library of random prosody and context, whose wave data are synthesized on request
+///
+/// The wave of each unit is a pulse train at the pitch of its contour through two formant resonators.
+/// The formants of each phoneme are fixed, and they move towards those of the context phonemes at the
+/// boundaries (coarticulation), so that the units recorded in the same context are joined smoothly.
+///
+class CWaveSpeechLib : public base::CSpeechLib
+{
+public:
+    static const uint32 NUM_PHONEMES  = 400;
+    static const int    SAMPLES_PER_SEC = 16000;
+
+    CWaveSpeechLib(uint32 unitNum)
+    {
+        formants.resize(NUM_PHONEMES);
+        for (uint32 p = 0; p < NUM_PHONEMES; p++)
+        {
+            formants[p].first  = uniform(300, 900);
+            formants[p].second = uniform(900, 2500);
+        }
+        units.resize(NUM_PHONEMES);
+        for (uint32 p = 0; p < NUM_PHONEMES; p++)
+        {
+            units[p].resize(unitNum);
+            for (uint32 u = 0; u < unitNum; u++)
+            {
+                CUnit &unit = units[p][u];
+                randomProsody(unit.tag.duration, unit.tag.amplitude, unit.tag.contour);
+                unit.label.leftPhoneme  = (rand() % 10 == 0) ? INVALID_ICODE : rand() % NUM_PHONEMES;
+                unit.label.rightPhoneme = (rand() % 10 == 0) ? INVALID_ICODE : rand() % NUM_PHONEMES;
+            }
+        }
+    }
+
+    void closeJoinIndex() {m_joinIndex.close();}
+
+    virtual bool initialize(const std::wstring &wstrPath) {return true;}
+    virtual bool terminate() {return true;}
+    virtual int getSamplesPerSec() const {return SAMPLES_PER_SEC;}
+    virtual int getBitsPerSample() const {return 16;}
+    virtual int getChannels() const {return 1;}
+
+    virtual icode_t getICodeFromPhoneme(const std::wstring &wstrPhoneme) const {return INVALID_ICODE;}
+    virtual std::wstring getPhonemeFromICode(icode_t iCode) const {return L"";}
+    virtual uint32 getPhonemeNumber() const {return NUM_PHONEMES;}
+    virtual uint32 getUnitNumber(icode_t iCode) const {return (iCode < NUM_PHONEMES) ? (uint32)units[iCode].size() : 0;}
+    virtual bool getContextLabels(icode_t iCode, base::CContextLabel *retLabels, uint32 &labelNum) const {return false;}
+
+    virtual bool getContextLabel(icode_t iCode, uint32 nIndex, base::CContextLabel &retLabel) const
+    {
+        retLabel = units[iCode][nIndex].label;
+        return true;
+    }
+
+    virtual bool getProsodyTag(icode_t iCode, uint32 nIndex, base::CProsodyTag &retTag) const
+    {
+        retTag = units[iCode][nIndex].tag;
+        return true;
+    }
+
+    virtual uint32 getWaveLength(icode_t iCode, uint32 nIndex) const
+    {
+        return (uint32)(units[iCode][nIndex].tag.duration / 1000 * SAMPLES_PER_SEC) * 2;
+    }
+
+    virtual bool getWave(icode_t iCode, uint32 nIndex, uint8 *waveData, uint32 &waveLen) const
+    {
+        const CUnit &unit = units[iCode][nIndex];
+        uint32 sampleNum = getWaveLength(iCode, nIndex) / 2;
+        if (waveLen < sampleNum * 2)
+            return false;
+        waveLen = sampleNum * 2;
+
+        // formants at the boundaries, half way to the context phonemes
+        std::pair<double, double> head = formants[iCode], tail = formants[iCode];
+        if (unit.label.leftPhoneme != INVALID_ICODE)
+        {
+            head.first  = (head.first  + formants[unit.label.leftPhoneme].first)  / 2;
+            head.second = (head.second + formants[unit.label.leftPhoneme].second) / 2;
+        }
+        if (unit.label.rightPhoneme != INVALID_ICODE)
+        {
+            tail.first  = (tail.first  + formants[unit.label.rightPhoneme].first)  / 2;
+            tail.second = (tail.second + formants[unit.label.rightPhoneme].second) / 2;
+        }
+
+        // pulse train through two resonators, the formants move from the beginning to the middle and to the end,
+        // the coefficients of the resonators are updated every 10 ms
+        const double pi = 3.14159265358979323846;
+        const uint32 block = SAMPLES_PER_SEC / 100;
+        double radius = exp(-pi * 100 / SAMPLES_PER_SEC);
+        double phase = 0, coef[2] = {0, 0}, y1[2] = {0, 0}, y2[2] = {0, 0};
+        short *samples = (short*)waveData;
+        for (uint32 i = 0; i < sampleNum; i++)
+        {
+            double pos = (double)i / sampleNum;
+            if (i % block == 0)
+            {
+                double weight = (pos < 0.5) ? 1 - 2 * pos : 2 * pos - 1;
+                const std::pair<double, double> &edge = (pos < 0.5) ? head : tail;
+                coef[0] = 2 * radius * cos(2 * pi * (formants[iCode].first  * (1 - weight) + edge.first  * weight) / SAMPLES_PER_SEC);
+                coef[1] = 2 * radius * cos(2 * pi * (formants[iCode].second * (1 - weight) + edge.second * weight) / SAMPLES_PER_SEC);
+            }
+
+            phase += unit.tag.contour[(int)(pos * 9.999)] / SAMPLES_PER_SEC;
+            double value = 0;
+            if (phase >= 1)
+            {
+                phase -= 1;
+                value = 1;
+            }
+            for (int f = 0; f < 2; f++)
+            {
+                double y = value + coef[f] * y1[f] - radius * radius * y2[f];
+                y2[f] = y1[f];
+                y1[f] = y;
+                value = y;
+            }
+            double sample = value * unit.tag.amplitude / 8;
+            samples[i] = (short)((sample > 32767) ? 32767 : ((sample < -32768) ? -32768 : sample));
+        }
+        return true;
+    }
+
+protected:
+    struct CUnit
+    {
+        base::CContextLabel label;
+        base::CProsodyTag   tag;
+    };
+    std::vector<std::vector<CUnit> > units;
+    std::vector<std::pair<double, double> > formants;
+};
+
+///
+/// @brief  Voice data using the synthetic speech library
+///
+class CWaveVoiceData : public base::CVoiceData
+{
+public:
+    CWaveVoiceData(uint32 unitNum) {m_pWavSynthesizer = new CWaveSpeechLib(unitNum);}
+    CWaveSpeechLib &getSpeechLib() {return *(CWaveSpeechLib*)m_pWavSynthesizer;}
+};
+
+///
+/// @brief  Concatenative synthesizer exposing the unit selection, and counting the pairs whose join costs are evaluated
+///
+class CJoinIndexTester : public base::CSynthConcatenate
+{
+public:
+    typedef base::CSynthesize::CUnitItem CUnitItem;
+
+    CJoinIndexTester(const base::CDataManager *pDataManager, const std::vector<double> &frequency)
+        : base::CSynthConcatenate(pDataManager), phonemeFrequency(frequency), counting(false) {}
+
+    /// Random sentence of the given number of units by the phoneme frequency, with a break at every 8 units
+    void randomSentence(size_t length, std::vector<CUnitItem> &sentence) const
+    {
+        sentence.resize(length);
+        for (size_t i = 0; i < length; i++)
+        {
+            CUnitItem &unit = sentence[i];
+            unit.clear();
+            unit.isBreak = (i % 8 == 7);
+            if (unit.isBreak)
+            {
+                unit.duration = 200;
+                continue;
+            }
+            double value = uniform(0, phonemeFrequency.back());
+            unit.phonemeID = (icode_t)(std::lower_bound(phonemeFrequency.begin(), phonemeFrequency.end(), value) - phonemeFrequency.begin());
+            randomProsody(unit.duration, unit.amplitude, unit.contour);
+        }
+    }
+
+    /// Select the units with the given search settings
+    int select(std::vector<CUnitItem> &sentence, int maxCandidates, int beamWidth)
+    {
+        base::TTSSetting setting;
+        setting.maxCandidates = maxCandidates;
+        setting.beamWidth     = beamWidth;
+        return selectUnit(sentence, setting);
+    }
+
+    /// Start or stop counting the pairs evaluated in unit selection
+    void setCounting(bool enable) {counting = enable;}
+
+    /// The most frequent pairs evaluated in unit selection
+    void getFrequentPairs(size_t maxPairs, std::vector<base::CUnitPair> &pairs) const
+    {
+        std::vector<std::pair<uint32, std::pair<uint64, uint64> > > sorted;
+        sorted.reserve(pairCounts.size());
+        for (std::map<std::pair<uint64, uint64>, uint32>::const_iterator it = pairCounts.begin(); it != pairCounts.end(); ++it)
+            sorted.push_back(std::make_pair(it->second, it->first));
+        size_t num = std::min(maxPairs, sorted.size());
+        std::partial_sort(sorted.begin(), sorted.begin() + num, sorted.end(), moreFrequent);
+        pairs.clear();
+        for (size_t i = 0; i < num; i++)
+        {
+            const std::pair<uint64, uint64> &pair = sorted[i].second;
+            pairs.push_back(base::CUnitPair((icode_t)(pair.first >> 32), (uint32)pair.first, (icode_t)(pair.second >> 32), (uint32)pair.second));
+        }
+    }
+
+    /// Number of distinct pairs evaluated in unit selection
+    size_t getPairNumber() const {return pairCounts.size();}
+
+    /// Sum of the target and join costs of the selected units, with the features extracted from wave data
+    double pathCost(const std::vector<CUnitItem> &sentence) const
+    {
+        const base::CSpeechLib *splib = (base::CSpeechLib*)&getDataManager<base::CVoiceData>()->getWavSynthesizer();
+        double cost = 0;
+        CCandidate prev;
+        bool hasPrev = false;
+        for (size_t i = 0; i < sentence.size(); i++)
+        {
+            if (sentence[i].isBreak || sentence[i].unitID == INVALID_UNITID)
+            {
+                hasPrev = false;
+                continue;
+            }
+            CCandidate cand;
+            cand.position  = i;
+            cand.phonemeID = sentence[i].phonemeID;
+            cand.unitID    = sentence[i].unitID;
+            splib->getContextLabel(cand.phonemeID, cand.unitID, cand.label);
+            splib->getProsodyTag(cand.phonemeID, cand.unitID, cand.tag);
+            cand.hasFeatures = base::CJoinIndex::extractFeatures(*splib, cand.phonemeID, cand.unitID, cand.headFeature, cand.tailFeature);
+            cost += getTargetCost(sentence, cand);
+            if (hasPrev)
+                cost += base::CSynthConcatenate::getJoinCost(prev, cand);
+            prev    = cand;
+            hasPrev = true;
+        }
+        return cost;
+    }
+
+protected:
+    virtual double getJoinCost(const CCandidate &prevCandidate, const CCandidate &candidate) const
+    {
+        if (counting)
+        {
+            std::pair<uint64, uint64> key(((uint64)prevCandidate.phonemeID << 32) | prevCandidate.unitID, ((uint64)candidate.phonemeID << 32) | candidate.unitID);
+            pairCounts[key]++;
+        }
+        return base::CSynthConcatenate::getJoinCost(prevCandidate, candidate);
+    }
+
+    static bool moreFrequent(const std::pair<uint32, std::pair<uint64, uint64> > &left, const std::pair<uint32, std::pair<uint64, uint64> > &right)
+    {
+        return left.first > right.first;
+    }
+
+protected:
+    const std::vector<double> &phonemeFrequency;
+    bool counting;
+    mutable std::map<std::pair<uint64, uint64>, uint32> pairCounts;
+};
+
+/// Select the units of all sentences, return the time per sentence (in second)
+double selectAll(CJoinIndexTester &tester, std::vector<std::vector<CJoinIndexTester::CUnitItem> > &sentences, int maxCandidates, int beamWidth)
+{
+    double beginTime = getWallTime();
+    for (size_t i = 0; i < sentences.size(); i++)
+    {
+        if (tester.select(sentences[i], maxCandidates, beamWidth) != ERROR_SUCCESS)
+        {
+            std::cout << "Unit selection failed!" << std::endl;
+            exit(-1);
+        }
+    }
+    return (getWallTime() - beginTime) / sentences.size();
+}
+
+/// Ratio of the units same as the reference
+double sameUnits(const std::vector<std::vector<CJoinIndexTester::CUnitItem> > &result, const std::vector<std::vector<CJoinIndexTester::CUnitItem> > &reference)
+{
+    size_t same = 0, total = 0;
+    for (size_t i = 0; i < result.size(); i++)
+    {
+        for (size_t j = 0; j < result[i].size(); j++)
+        {
+            if (result[i][j].isBreak)
+                continue;
+            total++;
+            if (result[i][j].unitID == reference[i][j].unitID)
+                same++;
+        }
+    }
+    return total ? (double)same / total : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 7)
+    {
+        displayUsage();
+        return -1;
+    }
+
+    std::wstring strIndexFile = str::mbstowcs(argv[1]);
+    std::wstring strPairFile  = strIndexFile + L".pairs";
+    uint32 unitNum     = (argc > 2) ? atoi(argv[2]) : 200;
+    size_t maxPairs    = (argc > 3) ? atoi(argv[3]) : 1000000;
+    size_t sentenceNum = (argc > 4) ? atoi(argv[4]) : 200;
+    int maxCandidates  = (argc > 5) ? atoi(argv[5]) : 64;
+    int beamWidth      = (argc > 6) ? atoi(argv[6]) : 16;
+    size_t length      = 20;
+    if (unitNum == 0 || sentenceNum == 0 || maxCandidates <= 0 || beamWidth < 0)
+    {
+        displayUsage();
+        return -1;
+    }
+
+    // the library and sentences are the same for each run, the phonemes follow Zipf's law
+    srand(1);
+    CWaveVoiceData voiceData(unitNum);
+    CWaveSpeechLib &splib = voiceData.getSpeechLib();
+    std::vector<double> frequency(CWaveSpeechLib::NUM_PHONEMES);
+    for (uint32 p = 0; p < CWaveSpeechLib::NUM_PHONEMES; p++)
+        frequency[p] = ((p > 0) ? frequency[p-1] : 0) + 1.0 / (p + 1);
+    CJoinIndexTester tester(&voiceData, frequency);
+    std::vector<std::vector<CJoinIndexTester::CUnitItem> > training(sentenceNum), sentences(sentenceNum);
+    for (size_t i = 0; i < sentenceNum; i++)
+        tester.randomSentence(length, training[i]);
+    for (size_t i = 0; i < sentenceNum; i++)
+        tester.randomSentence(length, sentences[i]);
+
+    // compile the join index of features only
+    double beginTime = getWallTime();
+    if (!base::CJoinIndex::save(strIndexFile.c_str(), splib, std::vector<base::CUnitPair>()))
+    {
+        std::cout << "Join index save failed!" << std::endl;
+        return -1;
+    }
+    double compileTime = getWallTime() - beginTime;
+    if (!splib.loadJoinIndex(strIndexFile.c_str()))
+    {
+        std::cout << "Join index load failed!" << std::endl;
+        return -1;
+    }
+
+    // count the pairs evaluated in the selection of the training sentences, and compile them into the join index
+    tester.setCounting(true);
+    selectAll(tester, training, maxCandidates, beamWidth);
+    tester.setCounting(false);
+    std::vector<base::CUnitPair> pairs;
+    tester.getFrequentPairs(maxPairs, pairs);
+    beginTime = getWallTime();
+    if (!base::CJoinIndex::save(strPairFile.c_str(), splib, pairs))
+    {
+        std::cout << "Join index save failed!" << std::endl;
+        return -1;
+    }
+    double pairCompileTime = getWallTime() - beginTime;
+
+    long long indexSize = 0, pairSize = 0;
+    cmn::CFile file;
+    if (file.open(strIndexFile.c_str(), L"rb") && file.seek(0, SEEK_END))
+        indexSize = file.tell();
+    file.close();
+    if (file.open(strPairFile.c_str(), L"rb") && file.seek(0, SEEK_END))
+        pairSize = file.tell();
+    file.close();
+
+    printf("%u phonemes x %u units, %d candidates at most, beam %d, %d sentences of %d units\n",
+        CWaveSpeechLib::NUM_PHONEMES, unitNum, maxCandidates, beamWidth, (int)sentenceNum, (int)length);
+    printf("Join index: %.1f KB compiled in %.2f s\n", indexSize / 1024.0, compileTime);
+    printf("Join index with pairs: %.1f KB compiled in %.2f s, %d of %d pairs evaluated in training\n\n",
+        pairSize / 1024.0, pairCompileTime, (int)pairs.size(), (int)tester.getPairNumber());
+
+    // without join index, features extracted from wave data
+    splib.closeJoinIndex();
+    std::vector<std::vector<CJoinIndexTester::CUnitItem> > reference(sentences);
+    double refTime = selectAll(tester, reference, maxCandidates, beamWidth);
+    double refCost = 0;
+    for (size_t i = 0; i < sentenceNum; i++)
+        refCost += tester.pathCost(reference[i]);
+
+    printf("%-24s %12s %10s %12s %12s\n", "", "ms/sentence", "speedup", "cost+%", "same units%");
+    printf("%-24s %12.3f %10.1f %12.2f %12.1f\n", "wave data", refTime * 1000, 1.0, 0.0, 100.0);
+
+    // with join index, and with join index and pairs
+    const wchar_t *files[] = {strIndexFile.c_str(), strPairFile.c_str()};
+    const char *names[] = {"join index", "join index with pairs"};
+    for (int f = 0; f < 2; f++)
+    {
+        if (!splib.loadJoinIndex(files[f]))
+        {
+            std::cout << "Join index load failed!" << std::endl;
+            return -1;
+        }
+        std::vector<std::vector<CJoinIndexTester::CUnitItem> > result(sentences);
+        double time = selectAll(tester, result, maxCandidates, beamWidth);
+
+        double cost = 0;
+        for (size_t i = 0; i < sentenceNum; i++)
+            cost += tester.pathCost(result[i]);
+        printf("%-24s %12.3f %10.1f %12.2f %12.1f\n", names[f], time * 1000, refTime / time,
+            (cost - refCost) / refCost * 100, sameUnits(result, reference) * 100);
+    }
+
+    return 0;
+}
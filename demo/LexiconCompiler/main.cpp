@@ -0,0 +1,223 @@
+// LexiconCompiler/main.cpp : Compile the CSV lexicon files into the binary lexicon image.
+//
+
+#include <locale.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "utils/utl_string.h"
+#include "ttschinese/textparse/lexicon_data.h"
+
+using namespace cst;
+using namespace cst::tts;
+
+void displayUsage()
+{
+    std::wcout << L"Usage: LexiconCompiler image_file lexicon_file [lexicon_file ...]" << std::endl;
+    std::wcout << L"       Compile the CSV lexicon files (loaded in order) into the binary image file" << std::endl;
+    std::wcout << L"       LexiconCompiler -bench image_file lexicon_file [lexicon_file ...]" << std::endl;
+    std::wcout << L"       Compare load time, memory and lookup time of the CSV lexicon files and the binary image file" << std::endl;
+    std::wcout << L"       (e.g. LexiconCompiler lexicon.dat gbk.bin symbol.lex)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+/// Get the resident memory size (working set) of current process, in KB
+size_t getResidentMemory()
+{
+#if defined(WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return 0;
+    return pmc.WorkingSetSize / 1024;
+#else
+    unsigned long size = 0, resident = 0;
+    FILE *fp = fopen("/proc/self/statm", "r");
+    if (fp == NULL)
+        return 0;
+    if (fscanf(fp, "%lu %lu", &size, &resident) != 2)
+        resident = 0;
+    fclose(fp);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+}
+
+/// Load the lexicon files in order
+bool loadLexicon(Chinese::CLexiconData &lexicon, const std::vector<std::wstring> &lexFiles)
+{
+    for (std::vector<std::wstring>::const_iterator it = lexFiles.begin(); it != lexFiles.end(); ++it)
+    {
+        if (!lexicon.load(it->c_str()))
+        {
+            std::wcout << L"Error loading lexicon file " << *it << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Look up all words in the lexicon, return the number of found lexemes
+size_t lookupAll(const Chinese::CLexiconData &lexicon, const std::vector<std::wstring> &words, size_t repeat)
+{
+    size_t found = 0;
+    std::vector<base::CLexeme> lexemes;
+    for (size_t n = 0; n < repeat; n++)
+    {
+        for (std::vector<std::wstring>::const_iterator it = words.begin(); it != words.end(); ++it)
+        {
+            lexemes.clear();
+            found += lexicon.lookupWord(*it, lexemes);
+        }
+    }
+    return found;
+}
+
+int benchLexicon(const std::wstring &imageFile, const std::vector<std::wstring> &lexFiles)
+{
+    // all CJK unified ideographs, and the same number of missing words
+    std::vector<std::wstring> words;
+    for (wchar_t ch = 0x4E00; ch < 0x9FA6; ch++)
+    {
+        std::wstring word(1, ch);
+        words.push_back(word);
+        words.push_back(word + word);
+    }
+    const size_t repeat = 20;
+
+    // CSV lexicon files
+    size_t memBase = getResidentMemory();
+    double beginTime = getWallTime();
+    Chinese::CLexiconData *pText = new Chinese::CLexiconData();
+    if (!loadLexicon(*pText, lexFiles))
+    {
+        delete pText;
+        return -1;
+    }
+    double textLoad = getWallTime() - beginTime;
+    size_t textMem = getResidentMemory() - memBase;
+    beginTime = getWallTime();
+    size_t textFound = lookupAll(*pText, words, repeat);
+    double textLookup = (getWallTime() - beginTime) / (words.size() * repeat);
+
+    // compile the binary image
+    if (!pText->save(imageFile.c_str()))
+    {
+        std::wcout << L"Error saving binary image file " << imageFile << std::endl;
+        delete pText;
+        return -1;
+    }
+
+    // binary image file
+    memBase = getResidentMemory();
+    beginTime = getWallTime();
+    Chinese::CLexiconData *pImage = new Chinese::CLexiconData();
+    pImage->load(imageFile.c_str());
+    double imageLoad = getWallTime() - beginTime;
+    size_t imageMem = getResidentMemory() - memBase;
+    beginTime = getWallTime();
+    size_t imageFound = lookupAll(*pImage, words, repeat);
+    double imageLookup = (getWallTime() - beginTime) / (words.size() * repeat);
+    size_t imageTouched = getResidentMemory() - memBase;
+
+    // check the results
+    bool same = (textFound == imageFound);
+    std::vector<base::CLexeme> textLexemes, imageLexemes;
+    for (std::vector<std::wstring>::const_iterator it = words.begin(); same && it != words.end(); ++it)
+    {
+        textLexemes.clear();
+        imageLexemes.clear();
+        pText->lookupWord(*it, textLexemes);
+        pImage->lookupWord(*it, imageLexemes);
+        same = textLexemes.size() == imageLexemes.size();
+        for (size_t i = 0; same && i < textLexemes.size(); i++)
+        {
+            same = textLexemes[i].wstrPhoneme == imageLexemes[i].wstrPhoneme && textLexemes[i].wstrPOS == imageLexemes[i].wstrPOS && textLexemes[i].nFrequency == imageLexemes[i].nFrequency;
+        }
+    }
+
+    std::wcout << L"            load time (ms)\tmemory (KB)\tlookup time (ns)" << std::endl;
+    std::wcout << L"CSV files:  " << textLoad * 1e3 << L"\t\t" << textMem << L"\t\t" << textLookup * 1e9 << std::endl;
+    std::wcout << L"Image file: " << imageLoad * 1e3 << L"\t\t" << imageMem << L" (" << imageTouched << L" after lookup)\t" << imageLookup * 1e9 << std::endl;
+    std::wcout << L"Lookup results of " << words.size() << L" words are " << (same ? L"identical" : L"DIFFERENT") << std::endl;
+
+    delete pText;
+    delete pImage;
+    return same ? 0 : -1;
+}
+
+#if defined(WIN32)
+int wmain(int argc, wchar_t* argv[])
+#else
+int main(int argc, char* argv[])
+#endif
+{
+#if defined(WIN32)
+    std::wcout.imbue(std::locale("chs", LC_CTYPE));
+#elif defined(__GNUC__)
+    std::setlocale(LC_CTYPE, "en_US.UTF-8");
+#endif
+
+    // parse the arguments
+    std::vector<std::wstring> args;
+    for (int i = 1; i < argc; i++)
+    {
+#if defined(WIN32)
+        args.push_back(argv[i]);
+#else
+        args.push_back(str::mbstowcs(argv[i]));
+#endif
+    }
+    bool isBench = (!args.empty() && args[0] == L"-bench");
+    if (isBench)
+    {
+        args.erase(args.begin());
+    }
+    if (args.size() < 2)
+    {
+        displayUsage();
+        return -1;
+    }
+    std::wstring imageFile = args[0];
+    std::vector<std::wstring> lexFiles(args.begin() + 1, args.end());
+
+    if (isBench)
+    {
+        return benchLexicon(imageFile, lexFiles);
+    }
+
+    // compile the lexicon files
+    Chinese::CLexiconData lexicon;
+    if (!loadLexicon(lexicon, lexFiles))
+    {
+        return -1;
+    }
+    if (!lexicon.save(imageFile.c_str()))
+    {
+        std::wcout << L"Error saving binary image file " << imageFile << std::endl;
+        return -1;
+    }
+    std::wcout << L"Binary image file " << imageFile << L" is saved" << std::endl;
+    return 0;
+}
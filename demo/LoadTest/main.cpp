@@ -0,0 +1,251 @@
+// LoadTest/main.cpp : Replay a text corpus to the TTS service at a target rate, and report the throughput and tail latency.
+//
+
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "utils/utl_string.h"
+#include "cmn/cmn_error.h"
+#include "cmn/cmn_textfile.h"
+#include "cmn/cmn_thread.h"
+#include "ttsbase/tts.service/tts_service.h"
+
+using namespace cst;
+using namespace cst::tts;
+
+void displayUsage()
+{
+    std::cout << "Usage: LoadTest config_file corpus_file qps seconds [workers] [max_pending] [stream] [cache_mb]" << std::endl;
+    std::cout << "       Submit the lines of the corpus (repeatedly) to the TTS service at the given requests per second" << std::endl;
+    std::cout << "       for the given duration without waiting for the results (open loop), then report the throughput" << std::endl;
+    std::cout << "       and the latency percentiles of each stage. Requests are rejected when the queue is full." << std::endl;
+    std::cout << "       workers: number of worker threads (default number of processors)" << std::endl;
+    std::cout << "       max_pending: maximum number of requests waiting in the queue (default 4 times of workers)" << std::endl;
+    std::cout << "       stream: 1 for streaming requests, the first speech latency is measured by the first piece (default 0)" << std::endl;
+    std::cout << "       cache_mb: memory of the cache of synthetic speech in MB, 0 for not using cache (default 0)," << std::endl;
+    std::cout << "                 the analyzed utterances of 4096 texts at most are cached as well" << std::endl;
+    std::cout << "       (e.g. LoadTest CrystalCfg.xml corpus.txt 20 30 4 16 1 64)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+void sleepSeconds(double seconds)
+{
+    if (seconds <= 0)
+        return;
+#if defined(WIN32)
+    Sleep((DWORD)(seconds * 1000));
+#else
+    usleep((useconds_t)(seconds * 1e6));
+#endif
+}
+
+/// Callback counting the finished requests and the synthetic speech, the requests are deleted when finished
+class CLoadCallback : public base::CTTSCallback
+{
+public:
+    CLoadCallback() : outstanding(0), speechBytes(0) {}
+
+    virtual bool onSpeech(base::CTTSRequest &request, const unsigned char *pData, unsigned long nByteLen)
+    {
+        // the streaming speech is discarded, as a client only playing it
+        return true;
+    }
+
+    virtual void onComplete(base::CTTSRequest &request)
+    {
+        mutex.lock();
+        if (request.retCode == ERROR_SUCCESS)
+            speechBytes += request.speechLength;
+        mutex.unlock();
+        delete &request;
+        addOutstanding(-1);
+    }
+
+    void addOutstanding(long number)
+    {
+        cmn::CAutoLock lock(mutex);
+        outstanding += number;
+        if (outstanding == 0)
+            finished.broadcast();
+    }
+
+    void waitFinished()
+    {
+        cmn::CAutoLock lock(mutex);
+        while (outstanding > 0)
+            finished.wait(mutex);
+    }
+
+    double getSpeechBytes()
+    {
+        cmn::CAutoLock lock(mutex);
+        return speechBytes;
+    }
+
+protected:
+    cmn::CMutex mutex;
+    cmn::CCondition finished;
+    long outstanding;
+    double speechBytes;
+};
+
+int main(int argc, char *argv[])
+{
+#if defined(__GNUC__)
+    setlocale(LC_CTYPE, "en_US.UTF-8");
+#endif
+
+    if (argc < 5 || argc > 9)
+    {
+        displayUsage();
+        return -1;
+    }
+
+    std::wstring strCfgFile    = str::mbstowcs(argv[1]);
+    std::wstring strCorpusFile = str::mbstowcs(argv[2]);
+    double qps      = atof(argv[3]);
+    double duration = atof(argv[4]);
+    int numWorkers  = (argc > 5) ? atoi(argv[5]) : 0;
+    if (numWorkers <= 0)
+        numWorkers = cmn::CThread::getProcessorNumber();
+    size_t maxPending = (argc > 6) ? atoi(argv[6]) : 0;
+    if (maxPending == 0)
+        maxPending = numWorkers * 4;
+    bool streaming = (argc > 7) && atoi(argv[7]) != 0;
+    double cacheMB = (argc > 8) ? atof(argv[8]) : 0;
+    if (qps <= 0 || duration <= 0)
+    {
+        displayUsage();
+        return -1;
+    }
+
+    // read the corpus, one request per non-empty line
+    cmn::CTextFile textFile;
+    if (!textFile.open(strCorpusFile.c_str(), L"rb"))
+    {
+        std::cout << "Corpus file open failed!" << std::endl;
+        return -1;
+    }
+    std::wstring strContent;
+    textFile.readString(strContent);
+    textFile.close();
+    std::vector<std::wstring> corpus;
+    size_t start = 0;
+    while (start < strContent.length())
+    {
+        size_t end = strContent.find_first_of(L"\r\n", start);
+        if (end == std::wstring::npos)
+            end = strContent.length();
+        if (end > start)
+            corpus.push_back(strContent.substr(start, end - start));
+        start = end + 1;
+    }
+    if (corpus.empty())
+    {
+        std::cout << "Corpus file is empty!" << std::endl;
+        return -1;
+    }
+
+    std::cout << "Initializing " << numWorkers << " workers..." << std::endl;
+    double initTime = getWallTime();
+    base::CTTSService service;
+    if (service.initialize(strCfgFile.c_str(), numWorkers, maxPending) != ERROR_SUCCESS)
+    {
+        std::cout << "TTS service initialization error, please ensure the correct path." << std::endl;
+        return -1;
+    }
+    std::cout << "Initialized in " << getWallTime() - initTime << " s" << std::endl;
+
+    base::CSynthCache cache((size_t)(cacheMB * 1024 * 1024), 4096);
+    if (cacheMB > 0)
+        service.setCache(&cache);
+
+    ushort nChannels, nBitsPerSample;
+    ulong  nSamplesPerSec;
+    service.getWaveFormat(nChannels, nBitsPerSample, nSamplesPerSec);
+    double bytesPerSec = (double)nSamplesPerSec * nChannels * nBitsPerSample / 8;
+
+    // submit the requests at the scheduled time, regardless of the finished ones (open loop)
+    CLoadCallback callback;
+    size_t numSubmitted = 0, numRejected = 0;
+    double startTime = getWallTime();
+    for (size_t i = 0; ; i++)
+    {
+        double schedule = startTime + i / qps;
+        if (schedule - startTime >= duration)
+            break;
+        sleepSeconds(schedule - getWallTime());
+
+        base::CTTSRequest *pRequest = new base::CTTSRequest();
+        pRequest->wstrText  = corpus[i % corpus.size()];
+        pRequest->streaming = streaming;
+        pRequest->pCallback = &callback;
+        callback.addOutstanding(1);
+        if (service.submit(*pRequest) != ERROR_SUCCESS)
+        {
+            // rejected, the callback is not called
+            delete pRequest;
+            callback.addOutstanding(-1);
+            numRejected++;
+            continue;
+        }
+        numSubmitted++;
+    }
+    callback.waitFinished();
+    double elapsed = getWallTime() - startTime;
+
+    base::CTTSStatistics statistics;
+    service.getStatistics(statistics);
+    service.terminate();
+    base::CSynthCacheStatistics cacheStatistics;
+    cache.getStatistics(cacheStatistics);
+
+    double speechSeconds = callback.getSpeechBytes() / bytesPerSec;
+    printf("\nTarget: %.1f req/s, %.1f s, %d workers, %d pending at most, %s\n", qps, duration, numWorkers, (int)maxPending, streaming ? "streaming" : "whole speech");
+    printf("Requests: %d submitted, %d rejected, %lu completed, %lu failed\n", (int)numSubmitted, (int)numRejected, statistics.numCompleted, statistics.numFailed);
+    printf("Throughput: %.2f req/s, %.2f s speech/s (%.1f s speech in %.1f s)\n", statistics.numCompleted / elapsed, speechSeconds / elapsed, speechSeconds, elapsed);
+    if (cacheMB > 0)
+    {
+        unsigned long speechLookups    = cacheStatistics.numSpeechHits + cacheStatistics.numSpeechMisses;
+        unsigned long utteranceLookups = cacheStatistics.numUtteranceHits + cacheStatistics.numUtteranceMisses;
+        printf("Cache: speech %lu/%lu hits (%.1f%%), %lu entries, %.1f MB; utterance %lu/%lu hits (%.1f%%), %lu entries\n",
+            cacheStatistics.numSpeechHits, speechLookups, speechLookups ? 100.0 * cacheStatistics.numSpeechHits / speechLookups : 0.0,
+            cacheStatistics.numSpeechEntries, cacheStatistics.speechBytes / 1048576.0,
+            cacheStatistics.numUtteranceHits, utteranceLookups, utteranceLookups ? 100.0 * cacheStatistics.numUtteranceHits / utteranceLookups : 0.0,
+            cacheStatistics.numUtteranceEntries);
+    }
+    printf("\n%-12s %10s %10s %10s %10s (ms)\n", "Stage", "p50", "p90", "p99", "max");
+    const char *stageNames[base::CTTSRequest::NUM_STAGES] = {"queue", "text", "synthesis", "first speech", "total"};
+    for (int i = 0; i < base::CTTSRequest::NUM_STAGES; i++)
+    {
+        base::CTTSRequest::EStage stage = (base::CTTSRequest::EStage)i;
+        printf("%-12s %10.1f %10.1f %10.1f %10.1f\n", stageNames[i],
+            statistics.percentile(stage, 50) * 1000, statistics.percentile(stage, 90) * 1000,
+            statistics.percentile(stage, 99) * 1000, statistics.percentile(stage, 100) * 1000);
+    }
+
+    return 0;
+}
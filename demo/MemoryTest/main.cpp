@@ -0,0 +1,201 @@
+// MemoryTest/main.cpp : Check that the peak memory of synthesizing a long utterance is about one copy of the speech.
+//
+
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "utils/utl_string.h"
+#include "cmn/cmn_textfile.h"
+#include "ttsbase/tts.text/tts_textparser.h"
+#include "ttsbase/tts.synth/tts_synthesizer.h"
+
+using namespace cst;
+using namespace cst::tts;
+
+void displayUsage()
+{
+    std::wcout << L"Usage: MemoryTest config_file text_file [repeat] [max_ratio]" << std::endl;
+    std::wcout << L"       Repeat the text of the text file for the given times (default 3) as one long document," << std::endl;
+    std::wcout << L"       synthesize it by one worker thread, and check that the peak memory during synthesis exceeds" << std::endl;
+    std::wcout << L"       the memory kept after synthesis by at most the given ratio (default 0.25) of the speech size," << std::endl;
+    std::wcout << L"       i.e. the speech is not copied on the way, and the peak is about one copy of the speech." << std::endl;
+    std::wcout << L"       The text file is ANSI, or Unicode with byte order mark." << std::endl;
+    std::wcout << L"       (e.g. MemoryTest ../../data/putonghua/config.xml text.txt 10)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+#if !defined(WIN32)
+/// Get the value of the given field of /proc/self/status, in KB
+size_t getProcStatus(const char *field)
+{
+    char line[256];
+    size_t value = 0;
+    size_t length = strlen(field);
+    FILE *fp = fopen("/proc/self/status", "r");
+    if (fp == NULL)
+        return 0;
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        if (strncmp(line, field, length) == 0 && line[length] == ':')
+        {
+            value = strtoul(line + length + 1, NULL, 10);
+            break;
+        }
+    }
+    fclose(fp);
+    return value;
+}
+#endif
+
+/// Get the memory size of current process, in KB (private usage on Windows, resident size on Linux)
+size_t getCurrentMemory()
+{
+#if defined(WIN32)
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc)))
+        return 0;
+    return pmc.PrivateUsage / 1024;
+#else
+    return getProcStatus("VmRSS");
+#endif
+}
+
+/// Get the peak memory size of current process, in KB (peak private usage on Windows, peak resident size on Linux)
+size_t getPeakMemory()
+{
+#if defined(WIN32)
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc)))
+        return 0;
+    return pmc.PeakPagefileUsage / 1024;
+#else
+    return getProcStatus("VmHWM");
+#endif
+}
+
+/// Reset the peak memory size to the current memory size, return false if not supported
+bool resetPeakMemory()
+{
+#if defined(WIN32)
+    return false;
+#else
+    // writing "5" to clear_refs resets the peak resident size (Linux 4.0 and later)
+    FILE *fp = fopen("/proc/self/clear_refs", "w");
+    if (fp == NULL)
+        return false;
+    bool succ = (fputs("5", fp) >= 0);
+    succ = (fclose(fp) == 0) && succ;
+    return succ && getPeakMemory() <= getCurrentMemory();
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+#if defined(WIN32)
+    setlocale(LC_CTYPE, "chs");
+#elif defined(__GNUC__)
+    setlocale(LC_CTYPE, "en_US.UTF-8");
+#endif
+
+    if (argc < 3)
+    {
+        displayUsage();
+        return -1;
+    }
+    int repeat = (argc > 3) ? atoi(argv[3]) : 3;
+    double maxRatio = (argc > 4) ? atof(argv[4]) : 0.25;
+
+    // read the text file, and repeat it as one long document
+    std::wstring strTextFile = str::mbstowcs(argv[2]);
+    cmn::CTextFile textFile;
+    if (!textFile.open(strTextFile.c_str(), L"rb"))
+    {
+        std::wcout << L"Error loading text file " << strTextFile << std::endl;
+        return -1;
+    }
+    std::wstring strText, strContent;
+    textFile.readString(strText);
+    textFile.close();
+    for (int i = 0; i < repeat; i++)
+        strContent += strText;
+
+    // initialize the TTS engine
+    std::wstring strCfgFile = str::mbstowcs(argv[1]);
+    base::CTextParser  textParser;
+    base::CSynthesizer synthesizer;
+    if (textParser.initialize(strCfgFile.c_str()) != ERROR_SUCCESS || synthesizer.initialize(strCfgFile.c_str()) != ERROR_SUCCESS)
+    {
+        std::wcout << L"Error initializing TTS engine " << strCfgFile << std::endl;
+        return -1;
+    }
+
+    // text analysis (not measured)
+    xml::CSSMLDocument document;
+    if (textParser.process(strContent.c_str(), ITT_TEXT_RAW, document) != ERROR_SUCCESS)
+    {
+        std::wcout << L"Error analyzing text file " << strTextFile << std::endl;
+        return -1;
+    }
+    strContent.clear();
+
+    // speech synthesis by one worker thread, as the sentences synthesized in parallel are held separately before being joined
+    base::TTSSetting setting;
+    synthesizer.getSetting(setting);
+    setting.workers = 1;
+    dsp::CWaveData waveData;
+    bool peakReset = resetPeakMemory();
+    size_t memBefore  = getCurrentMemory();
+    size_t peakBefore = getPeakMemory();
+    double synthTime  = getWallTime();
+    int ret = synthesizer.process(document, waveData, setting);
+    synthTime = getWallTime() - synthTime;
+    size_t memAfter  = getCurrentMemory();
+    size_t peakAfter = getPeakMemory();
+    if (ret != ERROR_SUCCESS || waveData.getLength() == 0)
+    {
+        std::wcout << L"Error synthesizing text file " << strTextFile << std::endl;
+        return -1;
+    }
+
+    double waveTime  = (double)waveData.getLength() / (waveData.getSamplesPerSec() * waveData.getBitsPerSample() / 8 * waveData.getChannels());
+    double speechMB  = waveData.getLength() / 1048576.0;
+    double peakMB    = (peakAfter > memBefore) ? (peakAfter - memBefore) / 1024.0 : 0;
+    double remainMB  = (memAfter > memBefore) ? (memAfter - memBefore) / 1024.0 : 0;
+    double copyRatio = (peakMB > remainMB) ? (peakMB - remainMB) / speechMB : 0;
+    std::wcout << L"Synthesis: " << synthTime << L"s\tspeech: " << waveTime << L"s, " << speechMB << L"MB" << std::endl;
+    std::wcout << L"Memory growth at peak: " << peakMB << L"MB\tafter synthesis: " << remainMB << L"MB" << std::endl;
+    std::wcout << L"Peak growth / speech size: " << peakMB / speechMB << std::endl;
+    std::wcout << L"Released after synthesis / speech size: " << copyRatio << L"\t(at most " << maxRatio << L")" << std::endl;
+    if (peakAfter <= peakBefore && !peakReset)
+    {
+        // the peak memory was reached before synthesis and could not be reset, so the peak during synthesis is unknown
+        std::wcout << L"Peak memory during synthesis is unknown, please repeat the text for more times" << std::endl;
+        return 1;
+    }
+    return (copyRatio <= maxRatio) ? 0 : 1;
+}
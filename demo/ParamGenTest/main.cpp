@@ -0,0 +1,156 @@
+// ParamGenTest/main.cpp : Compare the speed and the results of parameter generation solving dimensions one by one or together.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "htslib/hts_synthesizer.h"
+
+using namespace cst::tts;
+
+void displayUsage()
+{
+    std::cout << "Usage: ParamGenTest model_path config_file label_file [repeat]" << std::endl;
+    std::cout << "       Generate the speech parameters (mgc, lf0 and lpf) of the label file repeated for the given times (default 10)," << std::endl;
+    std::cout << "       solving the static dimensions one by one and all together, then compare the speed and the results." << std::endl;
+    std::cout << "       The label file can be saved by the HTS synthesizer (SynthCfg::fnOutDur)." << std::endl;
+    std::cout << "       (e.g. ParamGenTest ../../data/putonghua/hts hts.cfg utterance.lab 20)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+///
+/// @brief  HTS synthesizer which generates the speech parameters only
+///
+class CParamGenTester : public hts::CHtsSynthesizer
+{
+public:
+    /// Determine the state durations and pdfs of the labels
+    bool prepare(HTS_Context &context, const std::string &labels) const
+    {
+        HTS_Context_initialize(&context, &engine);
+        HTS_Context_load_label_from_string(&context, (char*)labels.c_str());
+        return HTS_Context_create_sstream(&context) ? true : false;
+    }
+
+    /// Generate the parameters with the given number of dimensions solved together (0 for all), in windows if overlap > 0
+    double generate(HTS_Context &context, HTS_PStreamSet &pss, int dimBlock, int overlap) const
+    {
+        double beginTime = getWallTime();
+        HTS_PStreamSet_initialize(&pss);
+        HTS_PStreamSet_set_dim_block(&pss, dimBlock);
+        HTS_PStreamSet_create_window(&pss, &context.sss, engine.global.msd_threshold, engine.global.gv_weight, overlap);
+        HTS_PStreamSet_generate_until(&pss, HTS_PStreamSet_get_total_frame(&pss));
+        return getWallTime() - beginTime;
+    }
+};
+
+/// Maximum absolute difference of the generated parameters of one stream
+double maxDifference(HTS_PStreamSet &pss1, HTS_PStreamSet &pss2, int stream)
+{
+    double maxDiff = 0;
+    HTS_PStream &pst1 = pss1.pstream[stream];
+    HTS_PStream &pst2 = pss2.pstream[stream];
+    for (int t = 0; t < pst1.length; t++)
+    {
+        for (int m = 0; m < pst1.static_length; m++)
+        {
+            double diff = fabs(pst1.par[t][m] - pst2.par[t][m]);
+            if (diff > maxDiff)
+                maxDiff = diff;
+        }
+    }
+    return maxDiff;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        displayUsage();
+        return -1;
+    }
+    int repeat = (argc > 4) ? atoi(argv[4]) : 10;
+
+    // load labels, time information is removed
+    std::ifstream fin(argv[3]);
+    if (!fin)
+    {
+        std::cout << "Error loading label file " << argv[3] << std::endl;
+        return -1;
+    }
+    std::string line, labels, utterance;
+    while (std::getline(fin, line))
+    {
+        std::string::size_type pos = line.find_last_of(" \t");
+        std::string context = (pos == std::string::npos) ? line : line.substr(pos + 1);
+        if (!context.empty() && context[context.length()-1] == '\r')
+            context.erase(context.length()-1);
+        if (!context.empty())
+            utterance += context + "\n";
+    }
+    for (int i = 0; i < repeat; i++)
+    {
+        labels += utterance;
+    }
+
+    CParamGenTester tester;
+    if (!tester.open(argv[1], argv[2]))
+    {
+        std::cout << "Error loading HTS models " << argv[1] << "/" << argv[2] << std::endl;
+        return -1;
+    }
+    HTS_Context context;
+    if (!tester.prepare(context, labels))
+    {
+        std::cout << "Error preparing labels" << std::endl;
+        HTS_Context_clear(&context);
+        return -1;
+    }
+
+    const char *streamNames[] = {"mgc", "lf0", "lpf"};
+    const int overlaps[] = {0, 30};
+    for (int i = 0; i < 2; i++)
+    {
+        HTS_PStreamSet pssScalar, pssBlock;
+        double scalarTime = tester.generate(context, pssScalar, 1, overlaps[i]);
+        double blockTime  = tester.generate(context, pssBlock, 0, overlaps[i]);
+
+        std::cout << (overlaps[i] > 0 ? "Windowed generation (overlap 30):" : "Whole utterance generation:") << std::endl;
+        std::cout << "  frames: " << HTS_PStreamSet_get_total_frame(&pssScalar);
+        std::cout << "\tone dimension: " << scalarTime * 1e3 << "ms\tall dimensions: " << blockTime * 1e3 << "ms";
+        std::cout << "\tspeedup: " << (blockTime > 0 ? scalarTime / blockTime : 0) << std::endl;
+        for (int s = 0; s < HTS_PStreamSet_get_nstream(&pssScalar); s++)
+        {
+            std::cout << "  " << (s < 3 ? streamNames[s] : "stream") << ": " << pssScalar.pstream[s].length << " frames x " << pssScalar.pstream[s].static_length << " dimensions";
+            std::cout << "\tmax difference: " << maxDifference(pssScalar, pssBlock, s) << std::endl;
+        }
+        HTS_PStreamSet_clear(&pssScalar);
+        HTS_PStreamSet_clear(&pssBlock);
+    }
+
+    HTS_Context_clear(&context);
+    return 0;
+}
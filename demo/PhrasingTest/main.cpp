@@ -0,0 +1,170 @@
+// PhrasingTest/main.cpp : Measure the text analysis throughput and the lengths of the prosodic phrases of a text corpus.
+//
+
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "utils/utl_string.h"
+#include "cmn/cmn_error.h"
+#include "cmn/cmn_textfile.h"
+#include "ttsbase/tts.text/tts_textparser.h"
+#include "ttsbase/datamanage/base_utterance.h"
+
+using namespace cst;
+using namespace cst::tts;
+
+void displayUsage()
+{
+    std::cout << "Usage: PhrasingTest config_file corpus_file [rounds]" << std::endl;
+    std::cout << "       Analyze the lines of the corpus by the text parser for the given rounds (default 1), then report" << std::endl;
+    std::cout << "       the sentences per second, the boundaries of each level, and the lengths of the prosodic phrases." << std::endl;
+    std::cout << "       The prosodic boundaries are predicted if \"phrase.dat\" or \"phrase.tree\" is in the text data path" << std::endl;
+    std::cout << "       of the configuration, run once more without it to compare." << std::endl;
+    std::cout << "       (e.g. PhrasingTest CrystalCfg.xml corpus.txt 5)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+/// Statistics of the prosodic structure of the analyzed corpus
+struct Statistics
+{
+    size_t numSentences;    ///< Number of sentences
+    size_t numWords;        ///< Number of words
+    size_t numChars;        ///< Number of characters of the words
+    size_t numBreaks[xml::CSSMLDocument::PROSBOUND_LAST_ITEM];  ///< Number of breaks after words of each boundary type
+    size_t numPhrases;      ///< Number of prosodic phrases (delimited by prosodic phrase or stronger boundary)
+    size_t maxPhrase;       ///< Number of characters of the longest prosodic phrase
+    size_t numLongPhrases;  ///< Number of prosodic phrases longer than LONG_PHRASE characters
+};
+
+/// Prosodic phrases longer than this number of characters are counted
+static const size_t LONG_PHRASE = 20;
+
+/// Count the sentences, words, breaks and prosodic phrases of the utterance
+void countUtterance(const base::CUtterance &utterance, Statistics &stat)
+{
+    for (std::vector<base::CUttParagraph>::const_iterator pit = utterance.paragraphs.begin(); pit != utterance.paragraphs.end(); ++pit)
+    {
+        for (std::vector<base::CUttSentence>::const_iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+        {
+            stat.numSentences++;
+            size_t phrase = 0;
+            for (size_t i = 0; i < sit->words.size(); i++)
+            {
+                const base::CUttWord &word = sit->words[i];
+                stat.numWords++;
+                stat.numChars += word.wstrText.length();
+                phrase += word.wstrText.length();
+
+                int boundaryType = word.breakAfter.exists ? word.breakAfter.boundaryType : xml::CSSMLDocument::PROSBOUND_NONE;
+                if (boundaryType >= 0 && boundaryType < xml::CSSMLDocument::PROSBOUND_LAST_ITEM)
+                    stat.numBreaks[boundaryType]++;
+                if (boundaryType >= xml::CSSMLDocument::PROSBOUND_PPHRASE || i + 1 == sit->words.size())
+                {
+                    if (phrase == 0)
+                        continue;
+                    stat.numPhrases++;
+                    stat.maxPhrase = (phrase > stat.maxPhrase) ? phrase : stat.maxPhrase;
+                    stat.numLongPhrases += (phrase > LONG_PHRASE) ? 1 : 0;
+                    phrase = 0;
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+#if defined(__GNUC__)
+    setlocale(LC_CTYPE, "en_US.UTF-8");
+#endif
+
+    if (argc < 3 || argc > 4)
+    {
+        displayUsage();
+        return -1;
+    }
+    std::wstring configFile = str::mbstowcs(argv[1]);
+    std::wstring corpusFile = str::mbstowcs(argv[2]);
+    int rounds = (argc > 3) ? atoi(argv[3]) : 1;
+    if (rounds <= 0)
+    {
+        displayUsage();
+        return -1;
+    }
+
+    // load the corpus, one text per line
+    cmn::CTextFile textFile;
+    std::wstring wstrCorpus;
+    if (!textFile.open(corpusFile.c_str(), L"rb") || !textFile.readString(wstrCorpus))
+    {
+        std::cout << "Error loading corpus file!" << std::endl;
+        return -1;
+    }
+    std::vector<std::wstring> lines;
+    str::tokenize(wstrCorpus, L"\r\n", lines);
+
+    base::CTextParser textParser;
+    if (textParser.initialize(configFile.c_str()) != ERROR_SUCCESS)
+    {
+        std::wcout << L"Text parser initialization failed!" << std::endl;
+        return -1;
+    }
+
+    // analyze the corpus
+    Statistics stat;
+    memset(&stat, 0, sizeof(stat));
+    base::CUtterance utterance;
+    double beginTime = getWallTime();
+    for (int r = 0; r < rounds; r++)
+    {
+        for (size_t i = 0; i < lines.size(); i++)
+        {
+            if (textParser.process(lines[i].c_str(), ITT_TEXT_RAW, utterance) != ERROR_SUCCESS)
+            {
+                std::wcout << L"Text analysis failed!" << std::endl;
+                return -1;
+            }
+            if (r == 0)
+                countUtterance(utterance, stat);
+        }
+    }
+    double elapsed = getWallTime() - beginTime;
+    textParser.terminate();
+
+    // the text parser writes to the console in wide characters
+    wprintf(L"%d lines, %d sentences, %d words, %d characters, %d rounds\n\n", (int)lines.size(), (int)stat.numSentences, (int)stat.numWords, (int)stat.numChars, rounds);
+    wprintf(L"%-24ls%10.1f\n", L"sentences per second", stat.numSentences * rounds / elapsed);
+    wprintf(L"%-24ls%10.1f\n\n", L"words per second", stat.numWords * rounds / elapsed);
+    wprintf(L"%-24ls%10d\n", L"prosodic word breaks", (int)stat.numBreaks[xml::CSSMLDocument::PROSBOUND_PWORD]);
+    wprintf(L"%-24ls%10d\n", L"prosodic phrase breaks", (int)stat.numBreaks[xml::CSSMLDocument::PROSBOUND_PPHRASE]);
+    wprintf(L"%-24ls%10d\n", L"stronger breaks", (int)(stat.numBreaks[xml::CSSMLDocument::PROSBOUND_IPHRASE] + stat.numBreaks[xml::CSSMLDocument::PROSBOUND_SENTENCE]));
+    wprintf(L"%-24ls%10d\n", L"prosodic phrases", (int)stat.numPhrases);
+    wprintf(L"%-24ls%10.1f\n", L"characters per phrase", stat.numPhrases ? (double)stat.numChars / stat.numPhrases : 0.0);
+    wprintf(L"%-24ls%10d\n", L"longest phrase", (int)stat.maxPhrase);
+    wprintf(L"phrases over %2d chars   %10d\n", (int)LONG_PHRASE, (int)stat.numLongPhrases);
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+// RegexpTest/main.cpp : Compare the speed and the results of the regexp interpreter and the character class table, and match concurrently.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "cmn/cmn_thread.h"
+#include "utils/utl_regexp.h"
+
+using namespace cst;
+
+void displayUsage()
+{
+    std::cout << "Usage: RegexpTest [threads] [inputs]" << std::endl;
+    std::cout << "       Match the regular expressions used by the engine against the generated input strings (default 100000)" << std::endl;
+    std::cout << "       by the backtracking interpreter and by the character class table, then compare the speed and the results." << std::endl;
+    std::cout << "       Then match the shared regular expressions by the given number of threads (default number of processors)" << std::endl;
+    std::cout << "       at the same time, and check the results are the same as the single thread results." << std::endl;
+    std::cout << "       (e.g. RegexpTest 8 200000)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+/// Regular expressions to be tested, the first ones are used by the engine
+const wchar_t *patterns[] =
+{
+    L"^[a-zA-Z]+[0-9]?",                                                        // CUnitSegment::segmentPhoneme
+    L"^([a-zA-Z]+)([0-2])$",                                                    // CSSML2Lab, English vowel
+    L"[\x19]|[\u3002|\uff0e|.|\uff0c|,|\uff1a|:|\uff1f|?|\uff01|!]",            // CSymbolDetect::detectPunctuation
+    L"^[\u3002|\uff0e|.|\uff0c|,|\uff1a|:|\uff1f|?|\uff01|!]",                  // CSymbolDetect::regTerminator
+    L"[a-z]*[0-9]+",
+    L"_[^_]*$",
+    L"^(zh|ch|sh)[aeiou]+",
+    L"[a-z]+[a-z0-9]",
+    L"a.*[0-9]",
+};
+const int numPatterns = sizeof(patterns) / sizeof(patterns[0]);
+
+/// Generate the input strings of letters, digits, punctuations and Chinese characters
+void generateInputs(size_t number, std::vector<std::wstring> &inputs)
+{
+    const wchar_t alphabet[] = L"aabcdeghinoszAEZ0123459_-.,!?\x19\u3002\uff0c\u4e2d\u6587";
+    const size_t alphabetSize = sizeof(alphabet) / sizeof(alphabet[0]) - 1;
+    unsigned int seed = 12345;
+    inputs.resize(number);
+    for (size_t i = 0; i < number; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        size_t length = (seed >> 16) % 13;
+        for (size_t j = 0; j < length; j++)
+        {
+            seed = seed * 1103515245 + 12345;
+            inputs[i] += alphabet[(seed >> 16) % alphabetSize];
+        }
+    }
+}
+
+/// Match result of one input string, as the positions of all sub-strings (empty if not matched)
+typedef std::vector<int> MatchPositions;
+
+/// Match all the input strings, return the time
+double matchAll(const cmn::CRegexp &regexp, const std::vector<std::wstring> &inputs, std::vector<MatchPositions> &results)
+{
+    cmn::CRegexpMatch match;
+    results.resize(inputs.size());
+    double beginTime = getWallTime();
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        results[i].clear();
+        if (regexp.match(inputs[i].c_str(), match))
+        {
+            for (int s = 0; s < match.substrings(); s++)
+            {
+                results[i].push_back(match.substart(s));
+                results[i].push_back(match.sublength(s));
+            }
+        }
+    }
+    return getWallTime() - beginTime;
+}
+
+///
+/// @brief  Thread which matches all the shared regular expressions against the input strings
+///
+class CMatchThread : public cmn::CThread
+{
+public:
+    CMatchThread(const std::vector<cmn::CRegexp*> &regexps, const std::vector<std::wstring> &inputs, const std::vector<std::vector<MatchPositions> > &expected)
+        : m_regexps(regexps), m_inputs(inputs), m_expected(expected), m_numDiff(0) {}
+
+    /// Number of the input strings with different results from the single thread results
+    size_t getDiffNumber() const {return m_numDiff;}
+
+protected:
+    virtual void run()
+    {
+        std::vector<MatchPositions> results;
+        for (size_t p = 0; p < m_regexps.size(); p++)
+        {
+            matchAll(*m_regexps[p], m_inputs, results);
+            for (size_t i = 0; i < results.size(); i++)
+            {
+                if (results[i] != m_expected[p][i])
+                    m_numDiff ++;
+            }
+        }
+    }
+
+protected:
+    const std::vector<cmn::CRegexp*> &m_regexps;
+    const std::vector<std::wstring> &m_inputs;
+    const std::vector<std::vector<MatchPositions> > &m_expected;
+    size_t m_numDiff;
+};
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help"))
+    {
+        displayUsage();
+        return 0;
+    }
+    int numThreads = (argc > 1) ? atoi(argv[1]) : cmn::CThread::getProcessorNumber();
+    size_t numInputs = (argc > 2) ? (size_t)atoi(argv[2]) : 100000;
+    if (numThreads < 1)
+        numThreads = 1;
+
+    std::vector<std::wstring> inputs;
+    generateInputs(numInputs, inputs);
+
+    // compare the interpreter and the character class table
+    bool same = true;
+    std::vector<cmn::CRegexp*> regexps;
+    std::vector<std::vector<MatchPositions> > expected(numPatterns);
+    std::cout << "pattern\ttable\tinterpreter (matches/s)\ttable (matches/s)\tspeedup\tresults" << std::endl;
+    for (int p = 0; p < numPatterns; p++)
+    {
+        cmn::CRegexp interpreter(patterns[p], false, false);
+        cmn::CRegexp *pTable = new cmn::CRegexp(patterns[p]);
+        regexps.push_back(pTable);
+        if (!interpreter.compiled() || !pTable->compiled())
+        {
+            std::cout << p << "\tError compiling regular expression" << std::endl;
+            same = false;
+            continue;
+        }
+        std::vector<MatchPositions> results;
+        double interpreterTime = matchAll(interpreter, inputs, expected[p]);
+        double tableTime = matchAll(*pTable, inputs, results);
+        bool patternSame = (results == expected[p]);
+        same = same && patternSame;
+        std::cout << p << "\t" << (pTable->optimized() ? "yes" : "no") << "\t" << (interpreterTime > 0 ? inputs.size() / interpreterTime : 0);
+        std::cout << "\t\t" << (tableTime > 0 ? inputs.size() / tableTime : 0) << "\t\t" << (tableTime > 0 ? interpreterTime / tableTime : 0);
+        std::cout << "\t" << (patternSame ? "identical" : "DIFFERENT") << std::endl;
+    }
+
+    // match the shared regular expressions concurrently
+    std::vector<CMatchThread*> threads;
+    double beginTime = getWallTime();
+    for (int t = 0; t < numThreads; t++)
+    {
+        threads.push_back(new CMatchThread(regexps, inputs, expected));
+        threads.back()->start();
+    }
+    size_t numDiff = 0;
+    for (int t = 0; t < numThreads; t++)
+    {
+        threads[t]->join();
+        numDiff += threads[t]->getDiffNumber();
+        delete threads[t];
+    }
+    double time = getWallTime() - beginTime;
+    std::cout << numThreads << " threads: " << (time > 0 ? numThreads * inputs.size() * regexps.size() / time : 0) << " matches/s, ";
+    std::cout << numDiff << " results different from single thread" << std::endl;
+
+    for (size_t p = 0; p < regexps.size(); p++)
+    {
+        delete regexps[p];
+    }
+    return (same && numDiff == 0) ? 0 : -1;
+}
@@ -0,0 +1,277 @@
+// UnitSelectTest/main.cpp : Measure the search time and the path cost of unit selection against beam width.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "cmn/cmn_error.h"
+#include "ttsbase/datavoice/data_voicedata.h"
+#include "ttsbase/synth.concat/splib_speechlib.h"
+#include "ttsbase/synth.concat/synth_concatenate.h"
+
+using namespace cst;
+using namespace cst::tts;
+
+void displayUsage()
+{
+    std::cout << "Usage: UnitSelectTest [units] [max_candidates] [sentences] [length]" << std::endl;
+    std::cout << "       Select the units of random sentences from a random speech library with increasing beam width," << std::endl;
+    std::cout << "       then report the search time per sentence, and the path cost and the units compared with full search." << std::endl;
+    std::cout << "       units: number of speech units of each phoneme in the library (default 500)" << std::endl;
+    std::cout << "       max_candidates: maximum number of candidates of each unit, 0 for all (default 64)" << std::endl;
+    std::cout << "       sentences: number of sentences (default 200)" << std::endl;
+    std::cout << "       length: number of units of each sentence (default 20)" << std::endl;
+    std::cout << "       (e.g. UnitSelectTest 1000 100 200 30)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+/// Uniform random number in [low, high)
+double uniform(double low, double high)
+{
+    return low + (high - low) * rand() / ((double)RAND_MAX + 1);
+}
+
+/// Random prosody of a syllable: duration, amplitude and a rising or falling pitch contour
+void randomProsody(float &duration, float &amplitude, float contour[10])
+{
+    duration  = (float)uniform(150, 350);
+    amplitude = (float)uniform(2000, 12000);
+    double start = uniform(100, 250), end = uniform(100, 250);
+    for (int i = 0; i < 10; i++)
+        contour[i] = (float)(start + (end - start) * i / 9);
+}
+
+///
+/// @brief  Speech library of random prosody and context without wave data, for testing unit selection only
+///
+class CRandomSpeechLib : public base::CSpeechLib
+{
+public:
+    static const uint32 NUM_PHONEMES = 400;
+
+    CRandomSpeechLib(uint32 unitNum)
+    {
+        units.resize(NUM_PHONEMES);
+        for (uint32 p = 0; p < NUM_PHONEMES; p++)
+        {
+            units[p].resize(unitNum);
+            for (uint32 u = 0; u < unitNum; u++)
+            {
+                CUnit &unit = units[p][u];
+                randomProsody(unit.tag.duration, unit.tag.amplitude, unit.tag.contour);
+                unit.label.leftPhoneme  = (rand() % 10 == 0) ? INVALID_ICODE : rand() % NUM_PHONEMES;
+                unit.label.rightPhoneme = (rand() % 10 == 0) ? INVALID_ICODE : rand() % NUM_PHONEMES;
+            }
+        }
+    }
+
+    virtual bool initialize(const std::wstring &wstrPath) {return true;}
+    virtual bool terminate() {return true;}
+    virtual int getSamplesPerSec() const {return 16000;}
+    virtual int getBitsPerSample() const {return 16;}
+    virtual int getChannels() const {return 1;}
+
+    virtual icode_t getICodeFromPhoneme(const std::wstring &wstrPhoneme) const {return INVALID_ICODE;}
+    virtual std::wstring getPhonemeFromICode(icode_t iCode) const {return L"";}
+    virtual uint32 getPhonemeNumber() const {return NUM_PHONEMES;}
+    virtual uint32 getUnitNumber(icode_t iCode) const {return (iCode < NUM_PHONEMES) ? (uint32)units[iCode].size() : 0;}
+    virtual bool getContextLabels(icode_t iCode, base::CContextLabel *retLabels, uint32 &labelNum) const {return false;}
+
+    virtual bool getContextLabel(icode_t iCode, uint32 nIndex, base::CContextLabel &retLabel) const
+    {
+        retLabel = units[iCode][nIndex].label;
+        return true;
+    }
+
+    virtual bool getProsodyTag(icode_t iCode, uint32 nIndex, base::CProsodyTag &retTag) const
+    {
+        retTag = units[iCode][nIndex].tag;
+        return true;
+    }
+
+    virtual bool getWave(icode_t iCode, uint32 nIndex, uint8 *waveData, uint32 &waveLen) const {return false;}
+    virtual uint32 getWaveLength(icode_t iCode, uint32 nIndex) const {return 2;}
+
+protected:
+    struct CUnit
+    {
+        base::CContextLabel label;
+        base::CProsodyTag   tag;
+    };
+    std::vector<std::vector<CUnit> > units;
+};
+
+///
+/// @brief  Voice data using the random speech library
+///
+class CRandomVoiceData : public base::CVoiceData
+{
+public:
+    CRandomVoiceData(uint32 unitNum) {m_pWavSynthesizer = new CRandomSpeechLib(unitNum);}
+};
+
+///
+/// @brief  Concatenative synthesizer exposing the unit selection
+///
+class CUnitSelectTester : public base::CSynthConcatenate
+{
+public:
+    typedef base::CSynthesize::CUnitItem CUnitItem;
+
+    CUnitSelectTester(const base::CDataManager *pDataManager) : base::CSynthConcatenate(pDataManager) {}
+
+    /// Random sentence of the given number of units, with a break at every 8 units
+    void randomSentence(size_t length, std::vector<CUnitItem> &sentence) const
+    {
+        sentence.resize(length);
+        for (size_t i = 0; i < length; i++)
+        {
+            CUnitItem &unit = sentence[i];
+            unit.clear();
+            unit.isBreak = (i % 8 == 7);
+            if (unit.isBreak)
+            {
+                unit.duration = 200;
+                continue;
+            }
+            unit.phonemeID = rand() % CRandomSpeechLib::NUM_PHONEMES;
+            randomProsody(unit.duration, unit.amplitude, unit.contour);
+        }
+    }
+
+    /// Select the units with the given search settings
+    int select(std::vector<CUnitItem> &sentence, int maxCandidates, int beamWidth)
+    {
+        base::TTSSetting setting;
+        setting.maxCandidates = maxCandidates;
+        setting.beamWidth     = beamWidth;
+        return selectUnit(sentence, setting);
+    }
+
+    /// Sum of the target and join costs of the selected units
+    double pathCost(const std::vector<CUnitItem> &sentence) const
+    {
+        const base::CSpeechLib *splib = (base::CSpeechLib*)&getDataManager<base::CVoiceData>()->getWavSynthesizer();
+        double cost = 0;
+        CCandidate prev;
+        bool hasPrev = false;
+        for (size_t i = 0; i < sentence.size(); i++)
+        {
+            if (sentence[i].isBreak || sentence[i].unitID == INVALID_UNITID)
+            {
+                hasPrev = false;
+                continue;
+            }
+            CCandidate cand;
+            cand.position  = i;
+            cand.phonemeID = sentence[i].phonemeID;
+            cand.unitID    = sentence[i].unitID;
+            splib->getContextLabel(cand.phonemeID, cand.unitID, cand.label);
+            splib->getProsodyTag(cand.phonemeID, cand.unitID, cand.tag);
+            cost += getTargetCost(sentence, cand);
+            if (hasPrev)
+                cost += getJoinCost(prev, cand);
+            prev    = cand;
+            hasPrev = true;
+        }
+        return cost;
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    if (argc > 5)
+    {
+        displayUsage();
+        return -1;
+    }
+
+    uint32 unitNum      = (argc > 1) ? atoi(argv[1]) : 500;
+    int maxCandidates   = (argc > 2) ? atoi(argv[2]) : 64;
+    size_t sentenceNum  = (argc > 3) ? atoi(argv[3]) : 200;
+    size_t length       = (argc > 4) ? atoi(argv[4]) : 20;
+    if (unitNum == 0 || maxCandidates < 0 || sentenceNum == 0 || length == 0)
+    {
+        displayUsage();
+        return -1;
+    }
+
+    // the random library and sentences are the same for each run
+    srand(1);
+    CRandomVoiceData voiceData(unitNum);
+    CUnitSelectTester tester(&voiceData);
+    std::vector<std::vector<CUnitSelectTester::CUnitItem> > sentences(sentenceNum);
+    for (size_t i = 0; i < sentenceNum; i++)
+        tester.randomSentence(length, sentences[i]);
+
+    // full search as the reference
+    std::vector<std::vector<CUnitSelectTester::CUnitItem> > reference(sentences);
+    double refCost = 0;
+    for (size_t i = 0; i < sentenceNum; i++)
+    {
+        tester.select(reference[i], maxCandidates, 0);
+        refCost += tester.pathCost(reference[i]);
+    }
+
+    printf("%u units per phoneme, %d candidates at most, %d sentences of %d units\n\n", unitNum, maxCandidates, (int)sentenceNum, (int)length);
+    printf("%6s %12s %12s %12s %12s\n", "beam", "ms/sentence", "cost", "cost+%", "same units%");
+    int beams[] = {1, 2, 4, 8, 16, 32, 64, 0};
+    for (size_t b = 0; b < sizeof(beams) / sizeof(beams[0]); b++)
+    {
+        std::vector<std::vector<CUnitSelectTester::CUnitItem> > result(sentences);
+        double beginTime = getWallTime();
+        for (size_t i = 0; i < sentenceNum; i++)
+        {
+            if (tester.select(result[i], maxCandidates, beams[b]) != ERROR_SUCCESS)
+            {
+                std::cout << "Unit selection failed!" << std::endl;
+                return -1;
+            }
+        }
+        double elapsed = getWallTime() - beginTime;
+
+        double cost = 0;
+        size_t same = 0, total = 0;
+        for (size_t i = 0; i < sentenceNum; i++)
+        {
+            cost += tester.pathCost(result[i]);
+            for (size_t j = 0; j < length; j++)
+            {
+                if (result[i][j].isBreak)
+                    continue;
+                total++;
+                if (result[i][j].unitID == reference[i][j].unitID)
+                    same++;
+            }
+        }
+
+        char beam[16];
+        sprintf(beam, (beams[b] > 0) ? "%d" : "full", beams[b]);
+        printf("%6s %12.3f %12.2f %12.2f %12.1f\n", beam, elapsed * 1000 / sentenceNum, cost / sentenceNum,
+            (cost - refCost) / refCost * 100, total ? 100.0 * same / total : 100.0);
+    }
+
+    return 0;
+}
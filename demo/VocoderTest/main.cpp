@@ -0,0 +1,160 @@
+// VocoderTest/main.cpp : Compare the speed and the accuracy of the double precision and single precision HTS vocoders.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "htslib/hts_synthesizer.h"
+
+using namespace cst::tts;
+
+void displayUsage()
+{
+    std::cout << "Usage: VocoderTest model_path config_file label_file [repeat] [volume]" << std::endl;
+    std::cout << "       Synthesize the speech of the label file repeated for the given times (default 10) from the same speech parameters" << std::endl;
+    std::cout << "       by the double precision vocoder and the single precision vocoders, then compare the speed (samples per second)" << std::endl;
+    std::cout << "       and the SNR of the single precision speech against the double precision speech." << std::endl;
+    std::cout << "       The volume (default 1.0) can be raised to measure the SNR of quiet voices above the 16-bit quantization noise." << std::endl;
+    std::cout << "       The label file can be saved by the HTS synthesizer (SynthCfg::fnOutDur)." << std::endl;
+    std::cout << "       (e.g. VocoderTest ../../data/putonghua/hts hts.cfg utterance.lab 20)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+///
+/// @brief  HTS synthesizer which vocodes the same speech parameters by different vocoders
+///
+class CVocoderTester : public hts::CHtsSynthesizer
+{
+public:
+    /// Determine the state durations and generate the speech parameters of the labels
+    bool prepare(HTS_Context &context, const std::string &labels) const
+    {
+        HTS_Context_initialize(&context, &engine);
+        HTS_Context_load_label_from_string(&context, (char*)labels.c_str());
+        return HTS_Context_create_sstream(&context) && HTS_Context_create_pstream(&context);
+    }
+
+    /// Synthesize the speech by the given vocoder type, return the time
+    double synthesize(HTS_Context &context, int vocoderType, std::vector<short> &speech) const
+    {
+        const HTS_Global &global = engine.global;
+        HTS_GStreamSet gss;
+        speech.resize(global.fperiod * HTS_PStreamSet_get_total_frame(&context.pss));
+        HTS_GStreamSet_initialize(&gss);
+        HTS_GStreamSet_set_speech_buffer(&gss, &speech[0]);
+
+        double beginTime = getWallTime();
+        HTS_GStreamSet_create(&gss, &context.pss, global.stage, global.use_log_gain, global.sampling_rate, global.fperiod,
+            global.alpha, global.beta, &context.stop, context.volume, vocoderType, NULL);
+        double time = getWallTime() - beginTime;
+
+        HTS_GStreamSet_clear(&gss);
+        return time;
+    }
+};
+
+/// Signal to noise ratio (dB) of the speech against the reference speech
+double signalToNoise(const std::vector<short> &reference, const std::vector<short> &speech)
+{
+    double signal = 0, noise = 0;
+    for (size_t i = 0; i < reference.size(); i++)
+    {
+        double diff = (double)speech[i] - reference[i];
+        signal += (double)reference[i] * reference[i];
+        noise  += diff * diff;
+    }
+    if (noise == 0)
+        return HUGE_VAL;
+    return 10 * log10(signal / noise);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        displayUsage();
+        return -1;
+    }
+    int repeat = (argc > 4) ? atoi(argv[4]) : 10;
+    double volume = (argc > 5) ? atof(argv[5]) : 1.0;
+
+    // load labels, time information is removed
+    std::ifstream fin(argv[3]);
+    if (!fin)
+    {
+        std::cout << "Error loading label file " << argv[3] << std::endl;
+        return -1;
+    }
+    std::string line, labels, utterance;
+    while (std::getline(fin, line))
+    {
+        std::string::size_type pos = line.find_last_of(" \t");
+        std::string context = (pos == std::string::npos) ? line : line.substr(pos + 1);
+        if (!context.empty() && context[context.length()-1] == '\r')
+            context.erase(context.length()-1);
+        if (!context.empty())
+            utterance += context + "\n";
+    }
+    for (int i = 0; i < repeat; i++)
+    {
+        labels += utterance;
+    }
+
+    CVocoderTester tester;
+    if (!tester.open(argv[1], argv[2]))
+    {
+        std::cout << "Error loading HTS models " << argv[1] << "/" << argv[2] << std::endl;
+        return -1;
+    }
+    HTS_Context context;
+    if (!tester.prepare(context, labels))
+    {
+        std::cout << "Error preparing labels" << std::endl;
+        HTS_Context_clear(&context);
+        return -1;
+    }
+    HTS_Context_set_volume(&context, volume);
+
+    const int vocoderTypes[] = {HTS_VOCODER_DOUBLE, HTS_VOCODER_FLOAT_C, HTS_VOCODER_FLOAT};
+    std::vector<short> reference, speech;
+    double referenceTime = tester.synthesize(context, HTS_VOCODER_DOUBLE, reference);
+    std::cout << "samples: " << reference.size() << "\tmel-cepstrum order: " << HTS_PStreamSet_get_static_length(&context.pss, 0) - 1 << std::endl;
+    std::cout << "vocoder\t\t\tsamples/s\tspeedup\tSNR (dB)" << std::endl;
+    for (int i = 0; i < 3; i++)
+    {
+        double time = (vocoderTypes[i] == HTS_VOCODER_DOUBLE) ? referenceTime : tester.synthesize(context, vocoderTypes[i], speech);
+        std::string name = HTS_Vocoder_get_kernel_name(vocoderTypes[i]);
+        std::cout << name << (name.length() < 16 ? "\t\t" : "\t") << (time > 0 ? reference.size() / time : 0);
+        std::cout << "\t" << (time > 0 ? referenceTime / time : 0);
+        if (vocoderTypes[i] == HTS_VOCODER_DOUBLE)
+            std::cout << "\t-" << std::endl;
+        else
+            std::cout << "\t" << signalToNoise(reference, speech) << std::endl;
+    }
+
+    HTS_Context_clear(&context);
+    return 0;
+}
@@ -0,0 +1,230 @@
+// VoiceCompiler/main.cpp : Compile the HTS voice models into the compiled voice image.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "htslib/hts_synthesizer.h"
+
+using namespace cst::tts;
+
+void displayUsage()
+{
+    std::cout << "Usage: VoiceCompiler model_path config_file image_file" << std::endl;
+    std::cout << "       Compile the tree, pdf, GV and window files of the HTS voice into the compiled voice image," << std::endl;
+    std::cout << "       which is used by adding \"-vi image_file\" to the configuration instead of the model files" << std::endl;
+    std::cout << "       VoiceCompiler -bench model_path config_file image_file [label_file]" << std::endl;
+    std::cout << "       Compare startup time and memory of loading the model files and mapping the compiled voice image," << std::endl;
+    std::cout << "       and check the speech of the label file synthesized by both are identical" << std::endl;
+    std::cout << "       (e.g. VoiceCompiler ../../data/putonghua/hts hts.cfg voice.img)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+/// Get the resident memory size (working set) of current process, in KB
+size_t getResidentMemory()
+{
+#if defined(WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return 0;
+    return pmc.WorkingSetSize / 1024;
+#else
+    unsigned long size = 0, resident = 0;
+    FILE *fp = fopen("/proc/self/statm", "r");
+    if (fp == NULL)
+        return 0;
+    if (fscanf(fp, "%lu %lu", &size, &resident) != 2)
+        resident = 0;
+    fclose(fp);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+}
+
+/// Get the private memory size of current process (which is not shared with other processes), in KB
+size_t getPrivateMemory()
+{
+#if defined(WIN32)
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc)))
+        return 0;
+    return pmc.PrivateUsage / 1024;
+#else
+    unsigned long size = 0, resident = 0, shared = 0;
+    FILE *fp = fopen("/proc/self/statm", "r");
+    if (fp == NULL)
+        return 0;
+    if (fscanf(fp, "%lu %lu %lu", &size, &resident, &shared) != 3)
+        resident = shared = 0;
+    fclose(fp);
+    return (resident - shared) * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+}
+
+///
+/// @brief  HTS synthesizer which exposes the configuration loading
+///
+class CVoiceCompiler : public hts::CHtsSynthesizer
+{
+public:
+    /// Load the configuration of the voice models
+    bool loadConfig(const char *modelPath, const char *configFile, hts::HtsCfg &cfg)
+    {
+        return hts::CHtsSynthesizer::loadConfig(modelPath, configFile, cfg);
+    }
+};
+
+/// Synthesize the speech of the label file
+bool synthesizeLabel(const CVoiceCompiler &synthesizer, const char *labelFile, std::vector<short> &speech)
+{
+    hts::SynthCfg synCfg;
+    synCfg.outWavData = true;
+    if (!synthesizer.synthesize(labelFile, synCfg))
+        return false;
+    speech.swap(synCfg.wavData);
+    return true;
+}
+
+int benchVoice(const hts::HtsCfg &textCfg, const char *imageFile, const char *labelFile)
+{
+    hts::HtsCfg imageCfg = textCfg;
+    imageCfg.fnVoiceImage = imageFile;
+
+    // model files
+    size_t memBase = getResidentMemory();
+    size_t privBase = getPrivateMemory();
+    double beginTime = getWallTime();
+    CVoiceCompiler *pText = new CVoiceCompiler();
+    if (!pText->open(textCfg))
+    {
+        std::cout << "Error loading HTS models" << std::endl;
+        delete pText;
+        return -1;
+    }
+    double textLoad = getWallTime() - beginTime;
+    size_t textMem = getResidentMemory() - memBase;
+    size_t textPriv = getPrivateMemory() - privBase;
+
+    // compile the voice image
+    if (!pText->saveVoiceImage(imageFile))
+    {
+        std::cout << "Error saving voice image file " << imageFile << std::endl;
+        delete pText;
+        return -1;
+    }
+
+    // compiled voice image
+    memBase = getResidentMemory();
+    privBase = getPrivateMemory();
+    beginTime = getWallTime();
+    CVoiceCompiler *pImage = new CVoiceCompiler();
+    if (!pImage->open(imageCfg))
+    {
+        std::cout << "Error mapping voice image file " << imageFile << std::endl;
+        delete pText;
+        delete pImage;
+        return -1;
+    }
+    double imageLoad = getWallTime() - beginTime;
+    size_t imageMem = getResidentMemory() - memBase;
+    size_t imagePriv = getPrivateMemory() - privBase;
+
+    std::cout << "             startup (ms)\tresident (KB)\tprivate (KB)" << std::endl;
+    std::cout << "Model files:  " << textLoad * 1e3 << "\t\t" << textMem << "\t\t" << textPriv << std::endl;
+    std::cout << "Voice image:  " << imageLoad * 1e3 << "\t\t" << imageMem << "\t\t" << imagePriv << std::endl;
+
+    // check the synthetic speech
+    bool same = true;
+    if (labelFile != NULL)
+    {
+        std::vector<short> textSpeech, imageSpeech;
+        memBase = getResidentMemory();
+        beginTime = getWallTime();
+        bool succ = synthesizeLabel(*pImage, labelFile, imageSpeech);
+        double imageSynth = getWallTime() - beginTime;
+        size_t imageTouched = getResidentMemory() - memBase;
+        beginTime = getWallTime();
+        succ = synthesizeLabel(*pText, labelFile, textSpeech) && succ;
+        double textSynth = getWallTime() - beginTime;
+        if (!succ)
+        {
+            std::cout << "Error synthesizing label file " << labelFile << std::endl;
+            delete pText;
+            delete pImage;
+            return -1;
+        }
+        same = (textSpeech == imageSpeech);
+        std::cout << "First synthesis (ms): " << textSynth * 1e3 << " by model files, " << imageSynth * 1e3 << " by voice image";
+        std::cout << " (" << imageTouched << " KB of voice image paged in)" << std::endl;
+        std::cout << "Speech of " << textSpeech.size() << " samples is " << (same ? "identical" : "DIFFERENT") << std::endl;
+    }
+
+    delete pText;
+    delete pImage;
+    return same ? 0 : -1;
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<char*> args(argv + 1, argv + argc);
+    bool isBench = (!args.empty() && std::string(args[0]) == "-bench");
+    if (isBench)
+    {
+        args.erase(args.begin());
+    }
+    if (args.size() < 3)
+    {
+        displayUsage();
+        return -1;
+    }
+
+    CVoiceCompiler compiler;
+    hts::HtsCfg cfg;
+    if (!compiler.loadConfig(args[0], args[1], cfg) || !cfg.fnVoiceImage.empty())
+    {
+        std::cout << "Error loading configuration of HTS models " << args[0] << "/" << args[1] << std::endl;
+        return -1;
+    }
+
+    if (isBench)
+    {
+        return benchVoice(cfg, args[2], args.size() > 3 ? args[3] : NULL);
+    }
+
+    // compile the voice models
+    if (!compiler.open(cfg))
+    {
+        std::cout << "Error loading HTS models " << args[0] << "/" << args[1] << std::endl;
+        return -1;
+    }
+    if (!compiler.saveVoiceImage(args[2]))
+    {
+        std::cout << "Error saving voice image file " << args[2] << std::endl;
+        return -1;
+    }
+    std::cout << "Voice image file " << args[2] << " is saved" << std::endl;
+    return 0;
+}
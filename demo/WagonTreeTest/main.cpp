@@ -0,0 +1,220 @@
+// WagonTreeTest/main.cpp : Compare the results and the speed of the Wagon Tree and the compiled Wagon Tree.
+//
+
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "cmn/cmn_textfile.h"
+#include "utils/utl_string.h"
+#include "utils/utl_wagontree.h"
+
+using namespace cst;
+using namespace cst::Wagon;
+
+void displayUsage()
+{
+    std::cout << "Usage: WagonTreeTest binary_file [tree_file] [inputs]" << std::endl;
+    std::cout << "       Load the Wagon Tree from the text file (or generate a random tree of 4000 questions), compile it," << std::endl;
+    std::cout << "       save it into the binary file and load it back. Then predict random properties (default 100000)" << std::endl;
+    std::cout << "       by the Wagon Tree and by the compiled Wagon Trees, check the results are the same, and compare the speed." << std::endl;
+    std::cout << "       (e.g. WagonTreeTest tree.bin phrase.tree 200000)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+/// Number of features and of values of each categorical feature of the random tree
+static const int RANDOM_FEATURES = 40;
+static const int RANDOM_VALUES   = 12;
+
+/// Generate the text of a random tree with the given number of questions
+void randomTree(int questions, std::wostringstream &tree)
+{
+    if (questions == 0)
+    {
+        // leaf with two to four values
+        int num = 2 + rand() % 3;
+        tree << L"((";
+        for (int i = 0; i < num; i++)
+            tree << L"(v" << rand() % 20 << L" " << (rand() % 1000) / 1000.0 << L")";
+        tree << L" v" << rand() % 20 << L"))";
+        return;
+    }
+
+    // half of the features are categorical, the others are numeric
+    static const wchar_t *numericOP[] = {L" = ", L" < ", L" > "};
+    int feature = rand() % RANDOM_FEATURES;
+    tree << L"((f" << feature;
+    if (feature % 2 == 0)
+        tree << ((rand() % 4 == 0) ? L" is not " : L" is ") << L"s" << rand() % RANDOM_VALUES;
+    else
+        tree << numericOP[rand() % 3] << rand() % 10;
+    tree << L") ";
+    int yes = rand() % questions;
+    randomTree(yes, tree);
+    tree << L" ";
+    randomTree(questions - 1 - yes, tree);
+    tree << L")";
+}
+
+/// Generate random properties of the features of the tree, some are missing or unknown
+void randomProperties(const CCompiledWagonTree &compiled, std::map<std::wstring, TestProperty> &test)
+{
+    test.clear();
+    for (size_t i = 0; i < compiled.getFeatureNumber(); i++)
+    {
+        if (rand() % 10 == 0)
+            continue;
+        const std::wstring &feature = compiled.getFeatureName((int)i);
+        TestProperty property(feature, (float)(rand() % 11));
+        property.sValue = (rand() % 10 == 0) ? L"unknown" : str::format(L"s%d", rand() % RANDOM_VALUES);
+        test.insert(std::make_pair(feature, property));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+#if defined(__GNUC__)
+    setlocale(LC_CTYPE, "en_US.UTF-8");
+#endif
+
+    if (argc < 2 || argc > 4)
+    {
+        displayUsage();
+        return -1;
+    }
+    std::wstring strBinaryFile = str::mbstowcs(argv[1]);
+    int numInputs = (argc > 3) ? atoi(argv[3]) : 100000;
+    if (numInputs <= 0)
+    {
+        displayUsage();
+        return -1;
+    }
+
+    // load the text of the tree
+    srand(1);
+    std::wstring strTree;
+    if (argc > 2)
+    {
+        cmn::CTextFile textFile;
+        if (!textFile.open(str::mbstowcs(argv[2]).c_str(), L"rb"))
+        {
+            std::cout << "Tree file open failed!" << std::endl;
+            return -1;
+        }
+        textFile.readString(strTree);
+    }
+    else
+    {
+        std::wostringstream tree;
+        randomTree(4000, tree);
+        strTree = tree.str();
+    }
+
+    // the Wagon Tree, the compiled tree, and the compiled tree from binary file
+    CWagonTree wagonTree;
+    std::wistringstream treeStream(strTree);
+    if (!wagonTree.loadFromText(treeStream))
+    {
+        std::cout << "Wagon Tree load failed!" << std::endl;
+        return -1;
+    }
+    CCompiledWagonTree compiled, binary;
+    treeStream.clear();
+    treeStream.str(strTree);
+    if (!compiled.loadFromText(treeStream) || !compiled.save(strBinaryFile.c_str()))
+    {
+        std::cout << "Wagon Tree compile failed!" << std::endl;
+        return -1;
+    }
+    double beginTime = getWallTime();
+    if (!binary.load(strBinaryFile.c_str()))
+    {
+        std::cout << "Compiled Wagon Tree load failed!" << std::endl;
+        return -1;
+    }
+    double loadTime = getWallTime() - beginTime;
+    beginTime = getWallTime();
+    CWagonTree textTree;
+    treeStream.clear();
+    treeStream.str(strTree);
+    textTree.loadFromText(treeStream);
+    double textTime = getWallTime() - beginTime;
+    printf("%d features, %d values, loaded from text in %.2f ms, from binary file in %.2f ms\n\n",
+        (int)binary.getFeatureNumber(), (int)binary.getValueNumber(), textTime * 1000, loadTime * 1000);
+
+    // random inputs
+    std::vector<std::map<std::wstring, TestProperty> > inputs(numInputs);
+    for (int i = 0; i < numInputs; i++)
+        randomProperties(binary, inputs[i]);
+    size_t numFeatures = binary.getFeatureNumber();
+    std::vector<CCompiledWagonTree::CFeatureValue> vectors(numInputs * numFeatures), features;
+    for (int i = 0; i < numInputs; i++)
+    {
+        binary.getFeatures(inputs[i], features);
+        std::copy(features.begin(), features.end(), vectors.begin() + i * numFeatures);
+    }
+
+    // Wagon Tree
+    std::vector<std::wstring> expected(numInputs);
+    std::vector<CWagonNode::typeLeafPairs> expectedPairs(numInputs);
+    beginTime = getWallTime();
+    for (int i = 0; i < numInputs; i++)
+        expectedPairs[i] = wagonTree.predict(inputs[i], expected[i]);
+    double treeTime = getWallTime() - beginTime;
+
+    // compiled tree, converting each property map
+    std::vector<int> leaves(numInputs);
+    beginTime = getWallTime();
+    for (int i = 0; i < numInputs; i++)
+    {
+        binary.getFeatures(inputs[i], features);
+        leaves[i] = binary.predictLeaf(features.empty() ? NULL : &features[0]);
+    }
+    double mapTime = getWallTime() - beginTime;
+
+    // compiled tree, batch of feature vectors
+    std::vector<int> batchLeaves(numInputs);
+    beginTime = getWallTime();
+    binary.predict(vectors.empty() ? NULL : &vectors[0], numInputs, &batchLeaves[0]);
+    double batchTime = getWallTime() - beginTime;
+
+    // compare the results
+    int numDiff = 0;
+    CWagonNode::typeLeafPairs leafPairs;
+    for (int i = 0; i < numInputs; i++)
+    {
+        binary.getLeafPairs(batchLeaves[i], leafPairs);
+        if (leaves[i] != batchLeaves[i] || binary.getValue(binary.getMostProbValue(batchLeaves[i])) != expected[i] || leafPairs != expectedPairs[i])
+            numDiff++;
+    }
+
+    printf("%-24s %12s %10s\n", "", "ns/predict", "speedup");
+    printf("%-24s %12.1f %10.1f\n", "Wagon Tree", treeTime * 1e9 / numInputs, 1.0);
+    printf("%-24s %12.1f %10.1f\n", "compiled, property map", mapTime * 1e9 / numInputs, treeTime / mapTime);
+    printf("%-24s %12.1f %10.1f\n", "compiled, batch", batchTime * 1e9 / numInputs, treeTime / batchTime);
+    printf("\n%d inputs, %d different results\n", numInputs, numDiff);
+
+    return (numDiff == 0) ? 0 : -1;
+}
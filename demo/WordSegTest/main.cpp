@@ -0,0 +1,266 @@
+// WordSegTest/main.cpp : Compare the accuracy and speed of forward maximum matching and lattice word segmentation.
+//
+
+#include <locale.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "utils/utl_string.h"
+#include "cmn/cmn_textfile.h"
+#include "ttsbase/textparse/wdseg_latticesegment.h"
+#include "ttschinese/textparse/lexicon_data.h"
+
+using namespace cst;
+using namespace cst::tts;
+
+void displayUsage()
+{
+    std::wcout << L"Usage: WordSegTest [-bigram bigram_file] corpus_file lexicon_file [lexicon_file ...]" << std::endl;
+    std::wcout << L"       Segment the sentences of the corpus by forward maximum matching and by word lattice," << std::endl;
+    std::wcout << L"       then report the precision, recall and F1 of the words, the accuracy of POS and the speed." << std::endl;
+    std::wcout << L"       Each line of the corpus file is a sentence of words separated by spaces, as \"word/POS word/POS ...\"" << std::endl;
+    std::wcout << L"       (e.g. WordSegTest -bigram posbigram.arpa corpus.txt gbk.bin symbol.lex)" << std::endl;
+}
+
+double getWallTime()
+{
+#if defined(WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+}
+
+/// Word with its position in sentence
+struct Word
+{
+    size_t start;
+    size_t length;
+    std::wstring wstrPOS;
+};
+
+/// Sentence of the corpus with the gold words
+struct Sentence
+{
+    std::wstring wstrText;
+    std::vector<Word> words;
+};
+
+/// Accuracy and speed result of one segmentation method
+struct Result
+{
+    size_t numGold;         ///< Number of the words in corpus
+    size_t numOutput;       ///< Number of the words output by segmentation
+    size_t numCorrect;      ///< Number of the output words with correct boundaries
+    size_t numTagged;       ///< Number of the output words with correct boundaries and POS
+    double time;            ///< Time for segmenting the corpus (in seconds)
+};
+
+///
+/// @brief  Word segmentation which runs the forward maximum matching and lattice segmentation directly on the text
+///
+class CWordSegTester : public base::CLatticeWordSegment
+{
+public:
+    CWordSegTester() : base::CLatticeWordSegment(NULL) {}
+
+    /// Segment the text by forward maximum matching (useLattice=false) or word lattice (useLattice=true)
+    void segment(bool useLattice, const base::CLexicon &lexicon, const cmn::CBigram *pBigram, const std::wstring &wstrText, std::vector<Word> &words)
+    {
+        CTextItem textItem;
+        textItem.wstrText = wstrText;
+        m_results.clear();
+        if (useLattice)
+            latticeMatch(lexicon, pBigram, textItem, m_results);
+        else
+            forwardMatch(lexicon, textItem, m_results);
+
+        words.resize(m_results.size());
+        size_t start = 0;
+        for (size_t i = 0; i < m_results.size(); i++)
+        {
+            words[i].start   = start;
+            words[i].length  = m_results[i].wstrText.length();
+            words[i].wstrPOS = m_results[i].wstrPOS;
+            start += words[i].length;
+        }
+    }
+
+protected:
+    std::vector<CTextItem> m_results;
+};
+
+/// Load the corpus of "word/POS" sentences
+bool loadCorpus(const std::wstring &corpusFile, std::vector<Sentence> &sentences)
+{
+    cmn::CTextFile textFile;
+    std::wstring wstrCorpus;
+    if (!textFile.open(corpusFile.c_str(), L"rb") || !textFile.readString(wstrCorpus))
+    {
+        std::wcout << L"Error loading corpus file " << corpusFile << std::endl;
+        return false;
+    }
+
+    std::vector<std::wstring> lines, tokens;
+    str::tokenize(wstrCorpus, L"\r\n", lines);
+    for (std::vector<std::wstring>::const_iterator it = lines.begin(); it != lines.end(); ++it)
+    {
+        Sentence sentence;
+        tokens.clear();
+        str::tokenize(*it, L" \t", tokens);
+        for (std::vector<std::wstring>::const_iterator itToken = tokens.begin(); itToken != tokens.end(); ++itToken)
+        {
+            // "word/POS", the word itself may contain "/"
+            std::wstring::size_type slash = itToken->rfind(L'/');
+            Word word;
+            word.start   = sentence.wstrText.length();
+            word.wstrPOS = (slash == std::wstring::npos || slash == 0) ? L"" : itToken->substr(slash + 1);
+            sentence.wstrText += (slash == std::wstring::npos || slash == 0) ? *itToken : itToken->substr(0, slash);
+            word.length  = sentence.wstrText.length() - word.start;
+            sentence.words.push_back(word);
+        }
+        if (!sentence.words.empty())
+            sentences.push_back(sentence);
+    }
+    return true;
+}
+
+/// Segment all the sentences of the corpus, and compare with the gold words
+Result evaluate(CWordSegTester &tester, bool useLattice, const base::CLexicon &lexicon, const cmn::CBigram *pBigram, const std::vector<Sentence> &sentences)
+{
+    Result result = {0, 0, 0, 0, 0};
+    std::vector<std::vector<Word> > outputs(sentences.size());
+
+    // speed
+    double beginTime = getWallTime();
+    for (size_t i = 0; i < sentences.size(); i++)
+    {
+        tester.segment(useLattice, lexicon, pBigram, sentences[i].wstrText, outputs[i]);
+    }
+    result.time = getWallTime() - beginTime;
+
+    // accuracy
+    for (size_t i = 0; i < sentences.size(); i++)
+    {
+        const std::vector<Word> &gold = sentences[i].words;
+        const std::vector<Word> &output = outputs[i];
+        result.numGold   += gold.size();
+        result.numOutput += output.size();
+
+        // both are sorted by position
+        size_t g = 0, o = 0;
+        while (g < gold.size() && o < output.size())
+        {
+            if (gold[g].start == output[o].start && gold[g].length == output[o].length)
+            {
+                result.numCorrect ++;
+                if (gold[g].wstrPOS == output[o].wstrPOS)
+                    result.numTagged ++;
+                g ++;
+                o ++;
+            }
+            else if (gold[g].start + gold[g].length <= output[o].start + output[o].length)
+                g ++;
+            else
+                o ++;
+        }
+    }
+    return result;
+}
+
+void printResult(const wchar_t *name, const Result &result, size_t numChars)
+{
+    double precision = result.numOutput ? (double)result.numCorrect / result.numOutput : 0;
+    double recall    = result.numGold ? (double)result.numCorrect / result.numGold : 0;
+    double f1        = (precision + recall > 0) ? 2 * precision * recall / (precision + recall) : 0;
+    double posAcc    = result.numCorrect ? (double)result.numTagged / result.numCorrect : 0;
+    double speed     = result.time > 0 ? numChars / result.time : 0;
+    std::wcout << name << precision * 100 << L"\t" << recall * 100 << L"\t" << f1 * 100 << L"\t" << posAcc * 100 << L"\t\t" << speed << std::endl;
+}
+
+#if defined(WIN32)
+int wmain(int argc, wchar_t* argv[])
+#else
+int main(int argc, char* argv[])
+#endif
+{
+#if defined(WIN32)
+    std::wcout.imbue(std::locale("chs", LC_CTYPE));
+#elif defined(__GNUC__)
+    std::setlocale(LC_CTYPE, "en_US.UTF-8");
+#endif
+
+    // parse the arguments
+    std::vector<std::wstring> args;
+    for (int i = 1; i < argc; i++)
+    {
+#if defined(WIN32)
+        args.push_back(argv[i]);
+#else
+        args.push_back(str::mbstowcs(argv[i]));
+#endif
+    }
+    std::wstring bigramFile;
+    if (args.size() >= 2 && args[0] == L"-bigram")
+    {
+        bigramFile = args[1];
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if (args.size() < 2)
+    {
+        displayUsage();
+        return -1;
+    }
+
+    // load data
+    std::vector<Sentence> sentences;
+    if (!loadCorpus(args[0], sentences))
+    {
+        return -1;
+    }
+    Chinese::CLexiconData lexicon;
+    for (std::vector<std::wstring>::const_iterator it = args.begin() + 1; it != args.end(); ++it)
+    {
+        if (!lexicon.load(it->c_str()))
+        {
+            std::wcout << L"Error loading lexicon file " << *it << std::endl;
+            return -1;
+        }
+    }
+    cmn::CBigram bigram;
+    if (!bigramFile.empty() && !bigram.loadBigramFromARPA(bigramFile))
+    {
+        std::wcout << L"Error loading bigram file " << bigramFile << std::endl;
+        return -1;
+    }
+    const cmn::CBigram *pBigram = bigramFile.empty() ? NULL : &bigram;
+
+    size_t numChars = 0;
+    for (std::vector<Sentence>::const_iterator it = sentences.begin(); it != sentences.end(); ++it)
+    {
+        numChars += it->wstrText.length();
+    }
+
+    // compare
+    CWordSegTester tester;
+    Result fmmResult = evaluate(tester, false, lexicon, pBigram, sentences);
+    Result latResult = evaluate(tester, true,  lexicon, pBigram, sentences);
+
+    std::wcout << sentences.size() << L" sentences, " << fmmResult.numGold << L" words, " << numChars << L" characters" << std::endl;
+    std::wcout << L"          precision\trecall\tF1\tPOS accuracy\tspeed (chars/s)" << std::endl;
+    printResult(L"Forward:  ", fmmResult, numChars);
+    printResult(L"Lattice:  ", latResult, numChars);
+    return 0;
+}
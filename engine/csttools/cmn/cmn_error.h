@@ -96,6 +96,8 @@ namespace cst
 #define ERROR_UNSUPPORTED_LANGUAGE          ( ERROR_MAX_EXIST_ERROR_NO + 4 )
 #define ERROR_DATA_READ_FAULT               ( ERROR_MAX_EXIST_ERROR_NO + 5 )
 #define ERROR_NOT_IMPLEMENTED               ( ERROR_MAX_EXIST_ERROR_NO + 6 )
+#define ERROR_OPERATION_ABORTED             ( ERROR_MAX_EXIST_ERROR_NO + 7 )
+#define ERROR_SERVICE_BUSY                  ( ERROR_MAX_EXIST_ERROR_NO + 8 )
 
 
 } // End of namespace cst
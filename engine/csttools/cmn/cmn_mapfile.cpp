@@ -0,0 +1,117 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Implementation file of read-only memory-mapped file manipulation.
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+///
+
+#if defined(WIN32) || defined(WINCE)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "utils/utl_string.h"
+#endif
+
+#include "cmn_mapfile.h"
+
+namespace cst
+{
+    namespace cmn
+    {
+        bool CMappedFile::open(const wchar_t *filename)
+        {
+            close();
+#if defined(WIN32) || defined(WINCE)
+            HANDLE hFile = CreateFileW(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (hFile == INVALID_HANDLE_VALUE)
+                return false;
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0 || (unsigned long long)fileSize.QuadPart > (size_t)-1)
+            {
+                CloseHandle(hFile);
+                return false;
+            }
+            HANDLE hMapping = CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (hMapping == NULL)
+            {
+                CloseHandle(hFile);
+                return false;
+            }
+            const void *pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+            if (pData == NULL)
+            {
+                CloseHandle(hMapping);
+                CloseHandle(hFile);
+                return false;
+            }
+            m_hFile    = hFile;
+            m_hMapping = hMapping;
+            m_pData    = pData;
+            m_nSize    = (size_t)fileSize.QuadPart;
+            return true;
+#else
+            // convert file name to UTF-8 as wfopen()
+            std::string mbsName = str::wcstombs(filename);
+            int fd = ::open(mbsName.c_str(), O_RDONLY);
+            if (fd < 0)
+                return false;
+            struct stat fileStat;
+            if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+            {
+                ::close(fd);
+                return false;
+            }
+            void *pData = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);    // mapping is kept after the file is closed
+            if (pData == MAP_FAILED)
+                return false;
+            m_pData = pData;
+            m_nSize = (size_t)fileStat.st_size;
+            return true;
+#endif
+        }
+
+        bool CMappedFile::close()
+        {
+            if (m_pData == NULL)
+                return true;
+#if defined(WIN32) || defined(WINCE)
+            bool succ = (UnmapViewOfFile(m_pData) != FALSE);
+            CloseHandle((HANDLE)m_hMapping);
+            CloseHandle((HANDLE)m_hFile);
+            m_hMapping = NULL;
+            m_hFile    = NULL;
+#else
+            bool succ = (munmap((void*)m_pData, m_nSize) == 0);
+#endif
+            m_pData = NULL;
+            m_nSize = 0;
+            return succ;
+        }
+    }
+}
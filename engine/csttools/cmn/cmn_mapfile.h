@@ -0,0 +1,103 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Definition of read-only memory-mapped file manipulation.
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+///
+
+#ifndef _CST_TOOLS_CMN_MAPFILE_H_
+#define _CST_TOOLS_CMN_MAPFILE_H_
+
+#include <cstddef>
+
+namespace cst
+{
+    namespace cmn
+    {
+        ///
+        /// @brief  The encapsulated class for mapping the whole file into memory (read-only)
+        ///
+        /// The pages of the mapped file are loaded on demand by the operating system,
+        /// and they are shared by all processes which map the same file.
+        /// On Windows, file mapping object is used. On Linux, mmap() is used.
+        ///
+        class CMappedFile
+        {
+        public:
+            ///
+            /// @brief  Default constructor
+            ///
+            CMappedFile() : m_pData(NULL), m_nSize(0), m_hFile(NULL), m_hMapping(NULL) {}
+
+            ///
+            /// @brief  Default destructor, unmap the file
+            ///
+            virtual ~CMappedFile() {close();}
+
+            ///
+            /// @brief  Map the whole file into memory for reading
+            ///
+            /// @param  [in] filename   The name of the file to be mapped
+            ///
+            /// @return Whether file is mapped successfully or not
+            ///
+            bool open(const wchar_t *filename);
+
+            ///
+            /// @brief  Unmap the file if mapped
+            ///
+            /// @return Whether file is unmapped successfully or not
+            ///
+            bool close();
+
+            ///
+            /// @brief  Get the mapped data of the file
+            ///
+            const void *getData() const {return m_pData;}
+
+            ///
+            /// @brief  Get the size of the mapped file (in byte)
+            ///
+            size_t getSize() const {return m_nSize;}
+
+            ///
+            /// @brief  Detect whether file has been mapped
+            ///
+            bool opened() const {return (m_pData != NULL);}
+
+        private:
+            CMappedFile(const CMappedFile &);               ///< Forbid copy constructor
+            CMappedFile &operator=(const CMappedFile &);    ///< Forbid assignment operator
+
+        protected:
+            const void *m_pData;    ///< The mapped data
+            size_t      m_nSize;    ///< The size of the mapped data
+            void       *m_hFile;    ///< Handle to the file (Windows only)
+            void       *m_hMapping; ///< Handle to the file mapping object (Windows only)
+        };
+    }
+}
+
+#endif//_CST_TOOLS_CMN_MAPFILE_H_
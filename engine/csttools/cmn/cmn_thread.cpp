@@ -0,0 +1,304 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Implementation file of encapsulated thread and mutex manipulation.
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added condition variable
+/// - Version:  0.1.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Implemented the condition variable of Windows CE by semaphore
+///
+
+#if defined(WIN32) || defined(WINCE)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/time.h>
+#endif
+
+#include "cmn_thread.h"
+
+namespace cst
+{
+    namespace cmn
+    {
+        //////////////////////////////////////////////////////////////////////////
+        //
+        //  Mutex
+        //
+        //////////////////////////////////////////////////////////////////////////
+
+        CMutex::CMutex()
+        {
+#if defined(WIN32) || defined(WINCE)
+            CRITICAL_SECTION *pMutex = new CRITICAL_SECTION;
+            InitializeCriticalSection(pMutex);
+#else
+            pthread_mutex_t *pMutex = new pthread_mutex_t;
+            pthread_mutex_init(pMutex, NULL);
+#endif
+            m_pMutex = pMutex;
+        }
+
+        CMutex::~CMutex()
+        {
+#if defined(WIN32) || defined(WINCE)
+            CRITICAL_SECTION *pMutex = (CRITICAL_SECTION*)m_pMutex;
+            DeleteCriticalSection(pMutex);
+#else
+            pthread_mutex_t *pMutex = (pthread_mutex_t*)m_pMutex;
+            pthread_mutex_destroy(pMutex);
+#endif
+            delete pMutex;
+        }
+
+        void CMutex::lock()
+        {
+#if defined(WIN32) || defined(WINCE)
+            EnterCriticalSection((CRITICAL_SECTION*)m_pMutex);
+#else
+            pthread_mutex_lock((pthread_mutex_t*)m_pMutex);
+#endif
+        }
+
+        void CMutex::unlock()
+        {
+#if defined(WIN32) || defined(WINCE)
+            LeaveCriticalSection((CRITICAL_SECTION*)m_pMutex);
+#else
+            pthread_mutex_unlock((pthread_mutex_t*)m_pMutex);
+#endif
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        //  Condition
+        //
+        //////////////////////////////////////////////////////////////////////////
+
+#if defined(WINCE)
+        ///
+        /// @brief  Condition variable of Windows CE which has no CONDITION_VARIABLE, implemented by a semaphore
+        ///
+        /// The semaphore is released once for each waiting thread to be woken up. The counters are protected
+        /// by the internal lock, as signal() and broadcast() may be called without locking the mutex.
+        ///
+        struct CECondition
+        {
+            CRITICAL_SECTION lock;      ///< Lock of the counters
+            HANDLE semaphore;           ///< Semaphore released to wake up the waiting threads
+            long waiters;               ///< Number of the waiting threads
+            long released;              ///< Number of the releases of the semaphore not yet taken by the waiting threads
+        };
+#endif
+
+        CCondition::CCondition()
+        {
+#if defined(WINCE)
+            CECondition *pCondition = new CECondition;
+            InitializeCriticalSection(&pCondition->lock);
+            pCondition->semaphore = CreateSemaphore(NULL, 0, 0x7FFFFFFF, NULL);
+            pCondition->waiters   = 0;
+            pCondition->released  = 0;
+#elif defined(WIN32)
+            CONDITION_VARIABLE *pCondition = new CONDITION_VARIABLE;
+            InitializeConditionVariable(pCondition);
+#else
+            pthread_cond_t *pCondition = new pthread_cond_t;
+            pthread_cond_init(pCondition, NULL);
+#endif
+            m_pCondition = pCondition;
+        }
+
+        CCondition::~CCondition()
+        {
+#if defined(WINCE)
+            CECondition *pCondition = (CECondition*)m_pCondition;
+            CloseHandle(pCondition->semaphore);
+            DeleteCriticalSection(&pCondition->lock);
+            delete pCondition;
+#elif defined(WIN32)
+            delete (CONDITION_VARIABLE*)m_pCondition;
+#else
+            pthread_cond_t *pCondition = (pthread_cond_t*)m_pCondition;
+            pthread_cond_destroy(pCondition);
+            delete pCondition;
+#endif
+        }
+
+        bool CCondition::wait(CMutex &mutex, long timeout)
+        {
+#if defined(WINCE)
+            CECondition *pCondition = (CECondition*)m_pCondition;
+            EnterCriticalSection(&pCondition->lock);
+            pCondition->waiters++;
+            LeaveCriticalSection(&pCondition->lock);
+
+            LeaveCriticalSection((CRITICAL_SECTION*)mutex.m_pMutex);
+            bool signaled = (WaitForSingleObject(pCondition->semaphore, (timeout < 0) ? INFINITE : (DWORD)timeout) == WAIT_OBJECT_0);
+
+            EnterCriticalSection(&pCondition->lock);
+            // a release for every waiting thread is pending, one of which was made for this timed out thread
+            if (!signaled && pCondition->released >= pCondition->waiters)
+                signaled = (WaitForSingleObject(pCondition->semaphore, 0) == WAIT_OBJECT_0);
+            pCondition->waiters--;
+            if (signaled)
+                pCondition->released--;
+            LeaveCriticalSection(&pCondition->lock);
+
+            EnterCriticalSection((CRITICAL_SECTION*)mutex.m_pMutex);
+            return signaled;
+#elif defined(WIN32)
+            return SleepConditionVariableCS((CONDITION_VARIABLE*)m_pCondition, (CRITICAL_SECTION*)mutex.m_pMutex, (timeout < 0) ? INFINITE : (DWORD)timeout) != FALSE;
+#else
+            pthread_cond_t *pCondition = (pthread_cond_t*)m_pCondition;
+            pthread_mutex_t *pMutex = (pthread_mutex_t*)mutex.m_pMutex;
+            if (timeout < 0)
+                return pthread_cond_wait(pCondition, pMutex) == 0;
+
+            // absolute time of timeout
+            struct timeval now;
+            gettimeofday(&now, NULL);
+            struct timespec abstime;
+            long usec = now.tv_usec + (timeout % 1000) * 1000;
+            abstime.tv_sec  = now.tv_sec + timeout / 1000 + usec / 1000000;
+            abstime.tv_nsec = (usec % 1000000) * 1000;
+            return pthread_cond_timedwait(pCondition, pMutex, &abstime) != ETIMEDOUT;
+#endif
+        }
+
+        void CCondition::signal()
+        {
+#if defined(WINCE)
+            CECondition *pCondition = (CECondition*)m_pCondition;
+            EnterCriticalSection(&pCondition->lock);
+            if (pCondition->waiters > pCondition->released)
+            {
+                pCondition->released++;
+                ReleaseSemaphore(pCondition->semaphore, 1, NULL);
+            }
+            LeaveCriticalSection(&pCondition->lock);
+#elif defined(WIN32)
+            WakeConditionVariable((CONDITION_VARIABLE*)m_pCondition);
+#else
+            pthread_cond_signal((pthread_cond_t*)m_pCondition);
+#endif
+        }
+
+        void CCondition::broadcast()
+        {
+#if defined(WINCE)
+            CECondition *pCondition = (CECondition*)m_pCondition;
+            EnterCriticalSection(&pCondition->lock);
+            long count = pCondition->waiters - pCondition->released;
+            if (count > 0)
+            {
+                pCondition->released += count;
+                ReleaseSemaphore(pCondition->semaphore, count, NULL);
+            }
+            LeaveCriticalSection(&pCondition->lock);
+#elif defined(WIN32)
+            WakeAllConditionVariable((CONDITION_VARIABLE*)m_pCondition);
+#else
+            pthread_cond_broadcast((pthread_cond_t*)m_pCondition);
+#endif
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        //  Thread
+        //
+        //////////////////////////////////////////////////////////////////////////
+
+#if defined(WIN32) || defined(WINCE)
+        unsigned long __stdcall CThread::threadProc(void *param)
+        {
+            ((CThread*)param)->run();
+            return 0;
+        }
+#else
+        void *CThread::threadProc(void *param)
+        {
+            ((CThread*)param)->run();
+            return NULL;
+        }
+#endif
+
+        bool CThread::start()
+        {
+            if (m_pThread != 0)
+                return false;
+#if defined(WIN32) || defined(WINCE)
+            m_pThread = CreateThread(NULL, 0, threadProc, this, 0, NULL);
+            return (m_pThread != NULL);
+#else
+            pthread_t *pThread = new pthread_t;
+            if (pthread_create(pThread, NULL, threadProc, this) != 0)
+            {
+                delete pThread;
+                return false;
+            }
+            m_pThread = pThread;
+            return true;
+#endif
+        }
+
+        bool CThread::join()
+        {
+            if (m_pThread == 0)
+                return false;
+#if defined(WIN32) || defined(WINCE)
+            bool succ = (WaitForSingleObject((HANDLE)m_pThread, INFINITE) == WAIT_OBJECT_0);
+            CloseHandle((HANDLE)m_pThread);
+#else
+            pthread_t *pThread = (pthread_t*)m_pThread;
+            bool succ = (pthread_join(*pThread, NULL) == 0);
+            delete pThread;
+#endif
+            m_pThread = 0;
+            return succ;
+        }
+
+        int CThread::getProcessorNumber()
+        {
+#if defined(WIN32) || defined(WINCE)
+            SYSTEM_INFO sysInfo;
+            GetSystemInfo(&sysInfo);
+            return (int)sysInfo.dwNumberOfProcessors;
+#else
+            long num = sysconf(_SC_NPROCESSORS_ONLN);
+            return (num > 0) ? (int)num : 1;
+#endif
+        }
+    }
+}
@@ -0,0 +1,219 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Definition of encapsulated thread and mutex manipulation.
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added condition variable
+/// - Version:  0.1.3
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Asserted that the thread is joined before destruction instead of joining it in destructor
+///
+
+#ifndef _CST_TOOLS_CMN_THREAD_H_
+#define _CST_TOOLS_CMN_THREAD_H_
+
+#include <assert.h>
+
+namespace cst
+{
+    namespace cmn
+    {
+        ///
+        /// @brief  The encapsulated class for mutual exclusion between threads
+        ///
+        /// On Windows, critical section is used. On Linux, pthread mutex is used.
+        ///
+        class CMutex
+        {
+        public:
+            ///
+            /// @brief  Default constructor
+            ///
+            CMutex();
+
+            ///
+            /// @brief  Default destructor
+            ///
+            ~CMutex();
+
+            ///
+            /// @brief  Lock the mutex, wait until it is available
+            ///
+            void lock();
+
+            ///
+            /// @brief  Unlock the mutex
+            ///
+            void unlock();
+
+        private:
+            CMutex(const CMutex &);             ///< Forbid copy constructor
+            CMutex &operator=(const CMutex &);  ///< Forbid assignment operator
+
+        protected:
+            void *m_pMutex;                     ///< Handle to the system mutex
+
+            friend class CCondition;
+        };
+
+        ///
+        /// @brief  The encapsulated class for threads waiting until a condition becomes true
+        ///
+        /// The condition is checked and changed with the associated mutex locked.
+        /// On Windows, condition variable (Vista or later) is used. On Windows CE, which has no condition variable,
+        /// a semaphore is used. On Linux, pthread condition variable is used.
+        ///
+        class CCondition
+        {
+        public:
+            ///
+            /// @brief  Default constructor
+            ///
+            CCondition();
+
+            ///
+            /// @brief  Default destructor
+            ///
+            ~CCondition();
+
+            ///
+            /// @brief  Unlock the mutex and wait until signaled, the mutex is locked again before return
+            ///
+            /// @param  [in] mutex      The mutex locked by current thread
+            /// @param  [in] timeout    Maximum time to wait (in millisecond), negative for waiting infinitely
+            ///
+            /// @return Whether signaled (true) or timed out (false)
+            ///
+            bool wait(CMutex &mutex, long timeout = -1);
+
+            ///
+            /// @brief  Wake up one waiting thread
+            ///
+            void signal();
+
+            ///
+            /// @brief  Wake up all waiting threads
+            ///
+            void broadcast();
+
+        private:
+            CCondition(const CCondition &);             ///< Forbid copy constructor
+            CCondition &operator=(const CCondition &);  ///< Forbid assignment operator
+
+        protected:
+            void *m_pCondition;                 ///< Handle to the system condition variable
+        };
+
+        ///
+        /// @brief  Lock the mutex during the life time of the object
+        ///
+        class CAutoLock
+        {
+        public:
+            ///
+            /// @brief  Constructor, lock the mutex
+            ///
+            CAutoLock(CMutex &mutex) : m_mutex(mutex) {m_mutex.lock();}
+
+            ///
+            /// @brief  Destructor, unlock the mutex
+            ///
+            ~CAutoLock() {m_mutex.unlock();}
+
+        private:
+            CAutoLock(const CAutoLock &);               ///< Forbid copy constructor
+            CAutoLock &operator=(const CAutoLock &);    ///< Forbid assignment operator
+
+        protected:
+            CMutex &m_mutex;                    ///< The locked mutex
+        };
+
+        ///
+        /// @brief  The base encapsulated class for thread manipulation
+        ///
+        /// The derived class implements run() which is executed in the new thread after start() is called.
+        ///
+        class CThread
+        {
+        public:
+            ///
+            /// @brief  Default constructor
+            ///
+            CThread() : m_pThread(0) {}
+
+            ///
+            /// @brief  Default destructor
+            ///
+            /// The thread should have been joined by join() before destruction, otherwise run() might
+            /// be executing while the derived object is being destroyed.
+            ///
+            virtual ~CThread() {assert(m_pThread == 0);}
+
+            ///
+            /// @brief  Create the thread and execute run() in it
+            ///
+            /// @return Whether the thread is created successfully or not
+            ///
+            bool start();
+
+            ///
+            /// @brief  Wait until the thread ends
+            ///
+            /// @return Whether operation is successful
+            ///
+            bool join();
+
+            ///
+            /// @brief  Get the number of processors (cores) available for running threads
+            ///
+            static int getProcessorNumber();
+
+        protected:
+            ///
+            /// @brief  The procedure executed in the thread
+            ///
+            virtual void run() = 0;
+
+        private:
+            CThread(const CThread &);               ///< Forbid copy constructor
+            CThread &operator=(const CThread &);    ///< Forbid assignment operator
+
+#if defined(WIN32) || defined(WINCE)
+            static unsigned long __stdcall threadProc(void *param);
+#else
+            static void *threadProc(void *param);
+#endif
+
+        protected:
+            void *m_pThread;                    ///< Handle to the system thread
+        };
+    }
+}
+
+#endif//_CST_TOOLS_CMN_THREAD_H_
@@ -0,0 +1,231 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Implementation of the latency trace of the processing stages.
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+///
+
+#if defined(WIN32) || defined(WINCE)
+#include <windows.h>
+#else
+#include <time.h>
+#include <sys/time.h>
+#endif
+
+#include <string.h>
+#include <stdio.h>
+#include <sstream>
+#include "cmn_trace.h"
+#include "cmn_file.h"
+
+namespace cst
+{
+    namespace cmn
+    {
+        ///
+        /// @brief  Write the string in JSON format (quoted and escaped)
+        ///
+        static void writeJSONString(std::ostream &out, const char *str)
+        {
+            out << '"';
+            for (const char *p = str; *p != '\0'; p++)
+            {
+                if (*p == '"' || *p == '\\')
+                    out << '\\' << *p;
+                else if ((unsigned char)*p < 0x20)
+                {
+                    char buf[8];
+                    sprintf(buf, "\\u%04x", (unsigned char)*p);
+                    out << buf;
+                }
+                else
+                    out << *p;
+            }
+            out << '"';
+        }
+
+        CTrace::CTrace()
+        {
+            clear();
+        }
+
+        void CTrace::clear()
+        {
+            m_spans.clear();
+            m_counters.clear();
+            m_depth  = 0;
+            m_origin = getTime();
+        }
+
+        int CTrace::beginSpan(const char *name)
+        {
+            CSpan span;
+            span.name  = name;
+            span.depth = m_depth++;
+            span.begin = getTime() - m_origin;
+            span.end   = -1;
+            m_spans.push_back(span);
+            return (int)m_spans.size() - 1;
+        }
+
+        void CTrace::endSpan(int index)
+        {
+            // the span may be cleared before it is ended
+            if (index < 0 || index >= (int)m_spans.size() || m_spans[index].end >= 0)
+                return;
+            m_spans[index].end = getTime() - m_origin;
+            m_depth--;
+        }
+
+        void CTrace::addCount(const char *name, long long value)
+        {
+            for (std::vector<CCounter>::iterator it = m_counters.begin(); it != m_counters.end(); ++it)
+            {
+                if (strcmp(it->name, name) == 0)
+                {
+                    it->value += value;
+                    return;
+                }
+            }
+            CCounter counter;
+            counter.name  = name;
+            counter.value = value;
+            m_counters.push_back(counter);
+        }
+
+        double CTrace::getDuration(const char *name) const
+        {
+            double duration = 0;
+            for (std::vector<CSpan>::const_iterator it = m_spans.begin(); it != m_spans.end(); ++it)
+            {
+                if (it->end >= 0 && strcmp(it->name, name) == 0)
+                    duration += it->end - it->begin;
+            }
+            return duration;
+        }
+
+        long long CTrace::getCount(const char *name) const
+        {
+            for (std::vector<CCounter>::const_iterator it = m_counters.begin(); it != m_counters.end(); ++it)
+            {
+                if (strcmp(it->name, name) == 0)
+                    return it->value;
+            }
+            return 0;
+        }
+
+        void CTrace::writeJSON(std::ostream &out) const
+        {
+            std::streamsize precision = out.precision(12);
+            out << "{\n  \"spans\": [";
+            for (size_t i = 0; i < m_spans.size(); i++)
+            {
+                const CSpan &span = m_spans[i];
+                out << ((i == 0) ? "\n    {\"name\": " : ",\n    {\"name\": ");
+                writeJSONString(out, span.name);
+                out << ", \"depth\": " << span.depth << ", \"begin_ms\": " << span.begin * 1e3;
+                out << ", \"duration_ms\": " << ((span.end >= 0) ? (span.end - span.begin) * 1e3 : 0.0) << "}";
+            }
+            out << "\n  ],\n  \"counters\": {";
+            for (size_t i = 0; i < m_counters.size(); i++)
+            {
+                out << ((i == 0) ? "\n    " : ",\n    ");
+                writeJSONString(out, m_counters[i].name);
+                out << ": " << m_counters[i].value;
+            }
+            out << "\n  }\n}\n";
+            out.precision(precision);
+        }
+
+        void CTrace::writeChromeTrace(std::ostream &out) const
+        {
+            // the time stamps are in microseconds
+            double last = 0;
+            std::streamsize precision = out.precision(12);
+            out << "{\"traceEvents\": [";
+            for (size_t i = 0; i < m_spans.size(); i++)
+            {
+                const CSpan &span = m_spans[i];
+                double end = (span.end >= 0) ? span.end : span.begin;
+                last = (end > last) ? end : last;
+                out << ((i == 0) ? "\n  {\"name\": " : ",\n  {\"name\": ");
+                writeJSONString(out, span.name);
+                out << ", \"cat\": \"tts\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1";
+                out << ", \"ts\": " << span.begin * 1e6 << ", \"dur\": " << (end - span.begin) * 1e6 << "}";
+            }
+            for (size_t i = 0; i < m_counters.size(); i++)
+            {
+                out << ((i == 0 && m_spans.empty()) ? "\n  {\"name\": " : ",\n  {\"name\": ");
+                writeJSONString(out, m_counters[i].name);
+                out << ", \"cat\": \"tts\", \"ph\": \"C\", \"pid\": 1, \"tid\": 1";
+                out << ", \"ts\": " << last * 1e6 << ", \"args\": {\"value\": " << m_counters[i].value << "}}";
+            }
+            out << "\n], \"displayTimeUnit\": \"ms\"}\n";
+            out.precision(precision);
+        }
+
+        bool CTrace::saveJSON(const wchar_t *fileName) const
+        {
+            return save(fileName, &CTrace::writeJSON);
+        }
+
+        bool CTrace::saveChromeTrace(const wchar_t *fileName) const
+        {
+            return save(fileName, &CTrace::writeChromeTrace);
+        }
+
+        bool CTrace::save(const wchar_t *fileName, void (CTrace::*write)(std::ostream &) const) const
+        {
+            std::ostringstream out;
+            (this->*write)(out);
+            std::string data = out.str();
+
+            CFile file;
+            if (!file.open(fileName, L"wb"))
+                return false;
+            bool ret = (file.write(data.c_str(), 1, data.size()) == data.size());
+            return file.close() && ret;
+        }
+
+        double CTrace::getTime()
+        {
+#if defined(WIN32) || defined(WINCE)
+            LARGE_INTEGER freq, count;
+            QueryPerformanceFrequency(&freq);
+            QueryPerformanceCounter(&count);
+            return (double)count.QuadPart / freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return ts.tv_sec + ts.tv_nsec / 1e9;
+#else
+            struct timeval tv;
+            gettimeofday(&tv, NULL);
+            return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+        }
+
+    }
+}
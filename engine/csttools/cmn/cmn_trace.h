@@ -0,0 +1,214 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Definition of the latency trace of the processing stages.
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+///
+
+#ifndef _CST_TOOLS_CMN_TRACE_H_
+#define _CST_TOOLS_CMN_TRACE_H_
+
+#include <vector>
+#include <iostream>
+
+///
+/// CST_TRACE_SPAN opens a span of the trace until the end of the current scope (at most one span in a scope),
+/// and CST_TRACE_COUNT adds the value to the counter of the trace. The trace may be NULL, then nothing
+/// is recorded. All tracing is removed at compile time when CST_DISABLE_TRACE is defined.
+///
+#if defined(CST_DISABLE_TRACE)
+#   define CST_TRACE_SPAN(pTrace, name)
+#   define CST_TRACE_COUNT(pTrace, name, value)
+#else
+#   define CST_TRACE_SPAN(pTrace, name)         cst::cmn::CTraceSpan traceSpan_(pTrace, name)
+#   define CST_TRACE_COUNT(pTrace, name, value) if ((pTrace) == NULL) {} else (pTrace)->addCount(name, value)
+#endif
+
+namespace cst
+{
+    namespace cmn
+    {
+        ///
+        /// @brief  The trace recording the time spans of the processing stages and the counters of the processed items
+        ///
+        /// The time is measured by the monotonic clock. The names of the spans and counters are not copied,
+        /// they must be string literals. The spans and counters are accumulated until clear() is called,
+        /// so that the stages of several calls (e.g. text analysis and synthesis) can be recorded together.
+        ///
+        /// The trace is not synchronized, it should be used by one thread at the same time.
+        ///
+        class CTrace
+        {
+        public:
+            ///
+            /// @brief  The time span of a processing stage
+            ///
+            class CSpan
+            {
+            public:
+                const char *name;       ///< Name of the stage
+                int         depth;      ///< Depth of the span, 0 for the outermost span
+                double      begin;      ///< Begin time (in seconds) since the trace is cleared
+                double      end;        ///< End time (in seconds) since the trace is cleared, negative if the span is not ended
+            };
+
+            ///
+            /// @brief  The counter of processed items
+            ///
+            class CCounter
+            {
+            public:
+                const char *name;       ///< Name of the counter
+                long long   value;      ///< Accumulated value
+            };
+
+        public:
+            ///
+            /// @brief  Constructor
+            ///
+            CTrace();
+
+            ///
+            /// @brief  Clear all the spans and counters, and restart the time
+            ///
+            void clear();
+
+            ///
+            /// @brief  Begin a span of the stage
+            ///
+            /// @param  [in]  name      Name of the stage (string literal)
+            ///
+            /// @return The index of the span, which is passed to endSpan()
+            ///
+            int beginSpan(const char *name);
+
+            ///
+            /// @brief  End the span of the stage
+            ///
+            /// @param  [in]  index     The index of the span returned by beginSpan()
+            ///
+            void endSpan(int index);
+
+            ///
+            /// @brief  Add the value to the counter, the counter is created if not existing
+            ///
+            /// @param  [in]  name      Name of the counter (string literal)
+            /// @param  [in]  value     The value to be added
+            ///
+            void addCount(const char *name, long long value);
+
+            ///
+            /// @brief  Get all the spans in the order of their beginning
+            ///
+            const std::vector<CSpan> &getSpans() const {return m_spans;}
+
+            ///
+            /// @brief  Get all the counters in the order of their creation
+            ///
+            const std::vector<CCounter> &getCounters() const {return m_counters;}
+
+            ///
+            /// @brief  Get the total time (in seconds) of the ended spans of the stage
+            ///
+            double getDuration(const char *name) const;
+
+            ///
+            /// @brief  Get the value of the counter, 0 if the counter does not exist
+            ///
+            long long getCount(const char *name) const;
+
+            ///
+            /// @brief  Write the spans and the counters in JSON format
+            ///
+            /// The spans are written as {"name": , "depth": , "begin_ms": , "duration_ms": }, and the counters as
+            /// {"name": value} in the object {"spans": [], "counters": {}}.
+            ///
+            void writeJSON(std::ostream &out) const;
+
+            ///
+            /// @brief  Write the spans and the counters in the trace event format of Chrome (chrome://tracing)
+            ///
+            /// The spans are complete events ("ph": "X") and the counters are counter events ("ph": "C")
+            /// at the end of the trace, all of which are in one thread.
+            ///
+            void writeChromeTrace(std::ostream &out) const;
+
+            ///
+            /// @brief  Save the spans and the counters in JSON format (see writeJSON())
+            ///
+            bool saveJSON(const wchar_t *fileName) const;
+
+            ///
+            /// @brief  Save the spans and the counters in the trace event format of Chrome (see writeChromeTrace())
+            ///
+            bool saveChromeTrace(const wchar_t *fileName) const;
+
+            ///
+            /// @brief  Get the time (in seconds) of the monotonic clock
+            ///
+            static double getTime();
+
+        protected:
+            ///
+            /// @brief  Save the spans and the counters by the given writing function
+            ///
+            bool save(const wchar_t *fileName, void (CTrace::*write)(std::ostream &) const) const;
+
+        protected:
+            std::vector<CSpan>      m_spans;    ///< The spans
+            std::vector<CCounter>   m_counters; ///< The counters
+            double                  m_origin;   ///< Time of the monotonic clock when the trace is cleared
+            int                     m_depth;    ///< Number of the spans not ended
+        };
+
+        ///
+        /// @brief  The span of the trace which begins at construction and ends at destruction (see CST_TRACE_SPAN)
+        ///
+        class CTraceSpan
+        {
+        public:
+            ///
+            /// @brief  Begin the span if the trace is not NULL
+            ///
+            CTraceSpan(CTrace *pTrace, const char *name) : m_pTrace(pTrace), m_index((pTrace != NULL) ? pTrace->beginSpan(name) : -1) {}
+
+            ///
+            /// @brief  End the span
+            ///
+            ~CTraceSpan() {if (m_pTrace != NULL) m_pTrace->endSpan(m_index);}
+
+        private:
+            CTraceSpan(const CTraceSpan &);             ///< Forbid copy constructor
+            CTraceSpan &operator=(const CTraceSpan &);  ///< Forbid assignment operator
+
+        protected:
+            CTrace *m_pTrace;       ///< The trace, NULL if not traced
+            int     m_index;        ///< Index of the span in the trace
+        };
+
+    }
+}
+
+#endif//_CST_TOOLS_CMN_TRACE_H_
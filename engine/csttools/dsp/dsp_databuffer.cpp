@@ -29,15 +29,15 @@
 
 
 #include <memory.h>
+#include <stdlib.h>
 #include "dsp_databuffer.h"
 
 namespace cst
 {
     namespace dsp
     {
-        CDataBuffer::CDataBuffer(const CDataBuffer &right)
+        CDataBuffer::CDataBuffer(const CDataBuffer &right) : m_pData(0), m_nLength(0), m_nCapacity(0)
         {
-            this->clear();
             this->appendData(right.m_pData, right.m_nLength);
         }
 
@@ -46,17 +46,119 @@ namespace cst
             // handle self assignment
             if (this != &right)
             {
-                this->clear();
+                // keep the allocated buffer if it is large enough
+                m_nLength = 0;
                 this->appendData(right.m_pData, right.m_nLength);
             }
             return (*this);
         }
 
+#if defined(CST_RVALUE_REFERENCE_SUPPORT)
+        CDataBuffer::CDataBuffer(CDataBuffer &&right) : m_pData(0), m_nLength(0), m_nCapacity(0)
+        {
+            this->swap(right);
+        }
+
+        CDataBuffer &CDataBuffer::operator = (CDataBuffer &&right)
+        {
+            // handle self assignment
+            if (this != &right)
+            {
+                this->clear();
+                this->swap(right);
+            }
+            return (*this);
+        }
+#endif
+
         bool CDataBuffer::clear()
         {
-            delete[] m_pData;
-            m_nLength =0;
-            m_pData   = 0;
+            release();
+            return true;
+        }
+
+        void CDataBuffer::release()
+        {
+            if (m_adoptedSamples.empty())
+            {
+                free(m_pData);
+            }
+            else
+            {
+                // free the memory of adopted samples
+                std::vector<short>().swap(m_adoptedSamples);
+            }
+            m_pData     = 0;
+            m_nLength   = 0;
+            m_nCapacity = 0;
+        }
+
+        void CDataBuffer::swap(CDataBuffer &right)
+        {
+            // swapping vectors keeps the address of the adopted samples
+            unsigned char *pData  = m_pData;     m_pData     = right.m_pData;     right.m_pData     = pData;
+            unsigned long nLength = m_nLength;   m_nLength   = right.m_nLength;   right.m_nLength   = nLength;
+            unsigned long nCapacity = m_nCapacity; m_nCapacity = right.m_nCapacity; right.m_nCapacity = nCapacity;
+            m_adoptedSamples.swap(right.m_adoptedSamples);
+        }
+
+        bool CDataBuffer::reserve(unsigned long nByteCapacity)
+        {
+            if (nByteCapacity <= m_nCapacity)
+            {
+                return true;
+            }
+            return reallocate(nByteCapacity);
+        }
+
+        bool CDataBuffer::reallocate(unsigned long nByteCapacity)
+        {
+            unsigned long nLength = (m_nLength < nByteCapacity) ? m_nLength : nByteCapacity;
+            if (m_adoptedSamples.empty())
+            {
+                // re-allocate own buffer, large buffer might be extended without copying
+                unsigned char *pTmpData = (unsigned char*)realloc(m_pData, nByteCapacity);
+                if (pTmpData==0)
+                {
+                    // memory overflow
+                    return false;
+                }
+                m_pData = pTmpData;
+            }
+            else
+            {
+                // create buffer for the adopted samples
+                unsigned char *pTmpData = (unsigned char*)malloc(nByteCapacity);
+                if (pTmpData==0)
+                {
+                    // memory overflow
+                    return false;
+                }
+                memcpy(pTmpData, m_pData, sizeof(unsigned char)*nLength);
+                release();
+                m_pData = pTmpData;
+            }
+            m_nLength   = nLength;
+            m_nCapacity = nByteCapacity;
+            return true;
+        }
+
+        bool CDataBuffer::adoptData(std::vector<short> &samples)
+        {
+            if (m_nLength > 0 || samples.empty())
+            {
+                // append to existing data
+                bool succ = samples.empty() || appendData((const unsigned char*)&samples[0], (unsigned long)(samples.size()*sizeof(short)));
+                std::vector<short>().swap(samples);
+                return succ;
+            }
+
+            // take over the samples without copying
+            release();
+            m_adoptedSamples.swap(samples);
+            m_pData     = (unsigned char*)&m_adoptedSamples[0];
+            m_nLength   = (unsigned long)(m_adoptedSamples.size()*sizeof(short));
+            m_nCapacity = m_nLength;
             return true;
         }
 
@@ -77,26 +179,32 @@ namespace cst
 
         bool CDataBuffer::appendData(const unsigned char *pData, unsigned long nByteLen)
         {
-            // create buffer
-            unsigned char *pTmpData = new unsigned char[m_nLength+nByteLen];
-            if (pTmpData==0)
+            if (m_nLength+nByteLen > m_nCapacity)
             {
-                // memory overflow
-                return false;
+                // grow the buffer geometrically (at least 1.5 times) for amortized linear appending
+                unsigned long nNewCapacity = m_nCapacity + m_nCapacity/2;
+                if (nNewCapacity < m_nLength+nByteLen)
+                    nNewCapacity = m_nLength+nByteLen;
+                // the appended data might be part of this data
+                bool isSelfData = (pData != 0 && pData >= m_pData && pData < m_pData+m_nLength);
+                unsigned long nOffset = isSelfData ? (unsigned long)(pData-m_pData) : 0;
+                if (!reallocate(nNewCapacity))
+                {
+                    return false;
+                }
+                if (isSelfData)
+                    pData = m_pData+nOffset;
             }
-            memcpy(pTmpData, m_pData, sizeof(unsigned char)*m_nLength);
             if (pData==0)
             {
                 // append the zero
-                memset(pTmpData+m_nLength, 0, sizeof(unsigned char)*nByteLen);
+                memset(m_pData+m_nLength, 0, sizeof(unsigned char)*nByteLen);
             }
             else
             {
                 // append the data
-                memcpy(pTmpData+m_nLength, pData, sizeof(unsigned char)*nByteLen);
+                memcpy(m_pData+m_nLength, pData, sizeof(unsigned char)*nByteLen);
             }
-            delete[] m_pData;
-            m_pData    = pTmpData;
             m_nLength += nByteLen;
             return true;
         }
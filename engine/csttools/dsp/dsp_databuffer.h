@@ -31,6 +31,13 @@
 #ifndef _CST_TTS_BASE_DSP_DATABUFFER_H_
 #define _CST_TTS_BASE_DSP_DATABUFFER_H_
 
+#include <vector>
+
+// whether the compiler supports rvalue reference (move constructor and move assignment)
+#if (defined(_MSC_VER) && _MSC_VER >= 1600) || (__cplusplus >= 201103L)
+#   define CST_RVALUE_REFERENCE_SUPPORT
+#endif
+
 namespace cst
 {
     namespace dsp
@@ -38,19 +45,34 @@ namespace cst
         ///
         /// @brief  The class which manipulates the data buffer automatically
         ///
+        /// The buffer grows geometrically when data is appended, so that appending many small
+        /// pieces of data (e.g. the speech of each unit) takes amortized linear time.
+        ///
         class CDataBuffer
         {
         public:
             ///
             /// @brief  Default constructor
             ///
-            CDataBuffer () : m_pData(0), m_nLength(0) {}
+            CDataBuffer () : m_pData(0), m_nLength(0), m_nCapacity(0) {}
 
             ///
             /// @brief  Copy constructor
             ///
             CDataBuffer(const CDataBuffer &right);
 
+#if defined(CST_RVALUE_REFERENCE_SUPPORT)
+            ///
+            /// @brief  Move constructor, take over the data of right operand without copying
+            ///
+            CDataBuffer(CDataBuffer &&right);
+
+            ///
+            /// @brief  Move assignment operator, take over the data of right operand without copying
+            ///
+            CDataBuffer &operator = (CDataBuffer &&right);
+#endif
+
             ///
             /// @brief  Destructor, clear the data
             ///
@@ -75,6 +97,38 @@ namespace cst
             ///
             bool clear();
 
+            ///
+            /// @brief  Reserve the data buffer for the data of at least the given size
+            ///
+            /// The length of the data is not changed. Appending data will not re-allocate
+            /// the buffer until the length of the data exceeds the reserved size.
+            ///
+            /// @param  [in] nByteCapacity  The size of the data buffer to be reserved (in byte)
+            ///
+            /// @return Whether operation is successful
+            ///
+            bool reserve(unsigned long nByteCapacity);
+
+            ///
+            /// @brief  Swap the data of two data buffers without copying
+            ///
+            /// @param  [in] right  The other data buffer to be swapped with
+            ///
+            void swap(CDataBuffer &right);
+
+            ///
+            /// @brief  Take over the samples of the vector as the data of this buffer
+            ///
+            /// If this buffer is empty, the samples are adopted without copying.
+            /// Otherwise, the samples are appended to the end of the data.
+            /// The input vector is always empty after calling this function.
+            ///
+            /// @param  [in] samples    The 16-bit samples to be taken over
+            ///
+            /// @return Whether operation is successful
+            ///
+            bool adoptData(std::vector<short> &samples);
+
             ///
             /// @brief  Resize the data buffer to the new size
             ///
@@ -134,9 +188,27 @@ namespace cst
             ///
             unsigned long getLength() const {return m_nLength;}
 
+            ///
+            /// @brief  Get the size of the allocated data buffer (in byte)
+            ///
+            unsigned long getCapacity() const {return m_nCapacity;}
+
+        protected:
+            ///
+            /// @brief  Re-allocate the data buffer for the data of the given size, keep the data
+            ///
+            bool reallocate(unsigned long nByteCapacity);
+
+            ///
+            /// @brief  Free the data buffer
+            ///
+            void release();
+
         protected:
             unsigned char *m_pData;     ///< The data buffer
             unsigned long  m_nLength;   ///< The length of the data buffer (unit: in byte)
+            unsigned long  m_nCapacity; ///< The size of the allocated data buffer (unit: in byte)
+            std::vector<short> m_adoptedSamples;    ///< The adopted samples which hold the data buffer, empty if the buffer is allocated by itself
         };
     }
 }
@@ -53,6 +53,25 @@ namespace cst
             return (*this);
         }
 
+#if defined(CST_RVALUE_REFERENCE_SUPPORT)
+        CWaveData::CWaveData(CWaveData &&right)
+        {
+            this->setFormat(right.m_nSamplesPerSec, right.m_wBitsPerSample, right.m_nChannels, right.m_wFormatTag);
+            this->swap(right);
+        }
+
+        CWaveData &CWaveData::operator = (CWaveData &&right)
+        {
+            // handle self assignment
+            if (this != &right)
+            {
+                this->setFormat(right.m_nSamplesPerSec, right.m_wBitsPerSample, right.m_nChannels, right.m_wFormatTag);
+                this->swap(right);
+            }
+            return (*this);
+        }
+#endif
+
         bool CWaveData::setFormat(unsigned long nSamplesPerSec, unsigned short wBitsPerSample, unsigned short nChannels, unsigned short wFormat)
         {
             if (wFormat != 1)
@@ -68,6 +68,18 @@ namespace cst
             ///
             CWaveData &operator = (const CWaveData &right);
 
+#if defined(CST_RVALUE_REFERENCE_SUPPORT)
+            ///
+            /// @brief  Move constructor, take over the data of right operand without copying
+            ///
+            CWaveData(CWaveData &&right);
+
+            ///
+            /// @brief  Move assignment operator, take over the data of right operand without copying
+            ///
+            CWaveData &operator = (CWaveData &&right);
+#endif
+
         public:
             //////////////////////////////////////////////////////////////////////////
             //
@@ -154,6 +166,30 @@ namespace cst
             unsigned long   m_nSamplesPerSec;   ///< Sampling rate, in samples per second (hertz, Hz)
             unsigned short  m_wBitsPerSample;   ///< Bits per sample. If wFormatTag is WAVE_FORMAT_PCM, it should be 8 or 16.
         };
+
+        ///
+        /// @brief  The interface for receiving the waveform-audio data piece by piece (e.g. streaming synthesis)
+        ///
+        class CWaveSink
+        {
+        public:
+            ///
+            /// @brief  Destructor
+            ///
+            virtual ~CWaveSink() {}
+
+            ///
+            /// @brief  Receive a piece of waveform-audio data as soon as it is available
+            ///
+            /// The format of the data is the same as the whole waveform-audio data being generated.
+            ///
+            /// @param  [in] pData      The new piece of waveform-audio data
+            /// @param  [in] nByteLen   The length of the new data (in byte)
+            ///
+            /// @return Whether to continue generating the following data, return false to abort
+            ///
+            virtual bool write(const unsigned char *pData, unsigned long nByteLen) = 0;
+        };
     }
 }
 
@@ -0,0 +1,212 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Implementation of double-array trie for fast dictionary lookup
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+///
+
+#include "utl_datrie.h"
+
+namespace cst
+{
+    namespace cmn
+    {
+        bool CDoubleArrayTrie::build(const std::vector<std::string> &keys, const std::vector<int> &values)
+        {
+            clear();
+            if (keys.size() != values.size())
+                return false;
+
+            // root node
+            m_vecUnits.resize(1);
+            m_vecUnits[0].base  = 0;
+            m_vecUnits[0].check = 0;
+            m_nNextFree = 1;
+            if (keys.size() > 0 && !insert(0, keys, values, 0, keys.size(), 0))
+            {
+                clear();
+                return false;
+            }
+
+            // remove the free units at the end
+            size_t size = m_vecUnits.size();
+            while (size > 1 && m_vecUnits[size-1].check < 0)
+                size--;
+            std::vector<Unit>(m_vecUnits.begin(), m_vecUnits.begin() + size).swap(m_vecUnits);
+
+            m_pUnits = &m_vecUnits[0];
+            m_nUnits = m_vecUnits.size();
+            return true;
+        }
+
+        void CDoubleArrayTrie::assign(const Unit *pUnits, size_t numUnits)
+        {
+            clear();
+            m_pUnits = pUnits;
+            m_nUnits = numUnits;
+        }
+
+        void CDoubleArrayTrie::clear()
+        {
+            std::vector<Unit>().swap(m_vecUnits);
+            m_pUnits = NULL;
+            m_nUnits = 0;
+        }
+
+        int CDoubleArrayTrie::exactMatch(const char *key, size_t len) const
+        {
+            size_t node = 0;
+            if (!traverse(node, key, len))
+                return -1;
+            return getValue(node);
+        }
+
+        bool CDoubleArrayTrie::traverse(size_t &node, const char *key, size_t len) const
+        {
+            if (m_nUnits == 0)
+                return false;
+            size_t cur = node;
+            for (size_t i = 0; i < len; i++)
+            {
+                size_t next = (size_t)m_pUnits[cur].base + (unsigned char)key[i] + 1;
+                if (next >= m_nUnits || m_pUnits[next].check != (int)cur)
+                    return false;
+                cur = next;
+            }
+            node = cur;
+            return true;
+        }
+
+        int CDoubleArrayTrie::getValue(size_t node) const
+        {
+            if (node >= m_nUnits || m_pUnits[node].base < 0)
+                return -1;
+            size_t leaf = (size_t)m_pUnits[node].base;
+            if (leaf >= m_nUnits || m_pUnits[leaf].check != (int)node || m_pUnits[leaf].base >= 0)
+                return -1;
+            return -m_pUnits[leaf].base - 1;
+        }
+
+        bool CDoubleArrayTrie::insert(size_t node, const std::vector<std::string> &keys, const std::vector<int> &values, size_t begin, size_t end, size_t depth)
+        {
+            // collect the labels of the transitions, 0 for the end of key
+            std::vector<int>    labels;
+            std::vector<size_t> bounds;
+            for (size_t i = begin; i < end; i++)
+            {
+                int label = (depth < keys[i].length()) ? (unsigned char)keys[i][depth] + 1 : 0;
+                if (labels.empty() || labels.back() != label)
+                {
+                    if (!labels.empty() && labels.back() > label)
+                        return false;   // keys are not sorted
+                    if (label == 0 && !labels.empty())
+                        return false;   // keys are not sorted
+                    labels.push_back(label);
+                    bounds.push_back(i);
+                }
+                else if (label == 0)
+                {
+                    return false;       // duplicated keys
+                }
+            }
+            bounds.push_back(end);
+
+            // place all the transitions
+            size_t base = findBase(labels);
+            m_vecUnits[node].base = (int)base;
+            for (size_t i = 0; i < labels.size(); i++)
+            {
+                m_vecUnits[base + labels[i]].check = (int)node;
+            }
+
+            // insert the children
+            for (size_t i = 0; i < labels.size(); i++)
+            {
+                size_t child = base + labels[i];
+                if (labels[i] == 0)
+                {
+                    if (values[bounds[i]] < 0)
+                        return false;
+                    m_vecUnits[child].base = -values[bounds[i]] - 1;
+                }
+                else if (!insert(child, keys, values, bounds[i], bounds[i+1], depth + 1))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        size_t CDoubleArrayTrie::findBase(const std::vector<int> &labels)
+        {
+            // skip the used units at the beginning
+            while (m_nNextFree < m_vecUnits.size() && m_vecUnits[m_nNextFree].check >= 0)
+                m_nNextFree++;
+
+            size_t numUsed = 0;
+            size_t pos = m_nNextFree;
+            for (;; pos++)
+            {
+                reserve(pos);
+                if (m_vecUnits[pos].check >= 0)
+                {
+                    numUsed++;
+                    continue;
+                }
+                // the first label is placed at this free unit
+                if (pos <= (size_t)labels[0])
+                    continue;
+                size_t base = pos - labels[0];
+                size_t i = 1;
+                for (; i < labels.size(); i++)
+                {
+                    reserve(base + labels[i]);
+                    if (m_vecUnits[base + labels[i]].check >= 0)
+                        break;
+                }
+                if (i == labels.size())
+                {
+                    // move the start of search forward if the units before are densely used
+                    if ((double)numUsed / (pos - m_nNextFree + 1) >= 0.95)
+                        m_nNextFree = pos;
+                    return base;
+                }
+            }
+        }
+
+        void CDoubleArrayTrie::reserve(size_t pos)
+        {
+            if (pos < m_vecUnits.size())
+                return;
+            Unit freeUnit;
+            freeUnit.base  = 0;
+            freeUnit.check = -1;
+            size_t newSize = m_vecUnits.size() * 2;
+            if (newSize <= pos)
+                newSize = pos + 1;
+            m_vecUnits.resize(newSize, freeUnit);
+        }
+    }
+}
@@ -0,0 +1,152 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Definition of double-array trie for fast dictionary lookup
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+///
+
+#ifndef _CST_TOOLS_UTL_DATRIE_H_
+#define _CST_TOOLS_UTL_DATRIE_H_
+
+#include <vector>
+#include <string>
+
+namespace cst
+{
+    namespace cmn
+    {
+        ///
+        /// @brief  Double-array trie mapping byte string keys (e.g. UTF-8 words) to integer values
+        ///
+        /// The trie is stored as an array of units (base, check), so it can be saved into
+        /// a binary image and used directly from a memory-mapped file without any loading.
+        ///
+        /// The transition from node s by byte c goes to node t = base[s] + c + 1 if check[t] == s.
+        /// The key of node s ends if t = base[s] is with check[t] == s, where -base[t]-1 is the value.
+        ///
+        class CDoubleArrayTrie
+        {
+        public:
+            ///
+            /// @brief  Unit of the double array, the binary layout is saved in the image
+            ///
+            struct Unit
+            {
+                int base;   ///< Base of the transitions, or -(value+1) for the end of key
+                int check;  ///< Parent node of this unit, negative if this unit is not used
+            };
+
+        public:
+            ///
+            /// @brief  Constructor
+            ///
+            CDoubleArrayTrie() : m_pUnits(NULL), m_nUnits(0) {}
+
+            ///
+            /// @brief  Build the double-array trie for the keys
+            ///
+            /// @param  [in] keys       The keys to be inserted, which must be sorted in ascending order without duplication
+            /// @param  [in] values     The non-negative values of the keys
+            ///
+            /// @return Whether the trie is built successfully
+            ///
+            bool build(const std::vector<std::string> &keys, const std::vector<int> &values);
+
+            ///
+            /// @brief  Use the units which are already built (e.g. in memory-mapped file) without copying
+            ///
+            /// @param  [in] pUnits     The units of the double array, which must be kept valid when trie is used
+            /// @param  [in] numUnits   The number of units
+            ///
+            void assign(const Unit *pUnits, size_t numUnits);
+
+            ///
+            /// @brief  Clear the double-array trie
+            ///
+            void clear();
+
+            ///
+            /// @brief  Search the value of the key which <b>whole matches</b> the input string
+            ///
+            /// @param  [in] key    The key to be searched
+            /// @param  [in] len    The length of the key (in byte)
+            ///
+            /// @return The value of the key, or -1 if the key is not found
+            ///
+            int exactMatch(const char *key, size_t len) const;
+
+            ///
+            /// @brief  Move from the node along the input string
+            ///
+            /// @param  [in]  node  The node from which to move, 0 for root
+            /// @param  [out] node  Return the node which is reached
+            /// @param  [in]  key   The string along which to move
+            /// @param  [in]  len   The length of the string (in byte)
+            ///
+            /// @return Whether the whole string is moved along successfully
+            ///
+            bool traverse(size_t &node, const char *key, size_t len) const;
+
+            ///
+            /// @brief  Get the value of the key which ends at the node, or -1 if no key ends at the node
+            ///
+            int getValue(size_t node) const;
+
+            ///
+            /// @brief  Get the units of the double array
+            ///
+            const Unit *getUnits() const {return m_pUnits;}
+
+            ///
+            /// @brief  Get the number of units of the double array
+            ///
+            size_t getSize() const {return m_nUnits;}
+
+        protected:
+            ///
+            /// @brief  Insert the keys [begin, end) which share the same prefix of depth bytes under the node
+            ///
+            bool insert(size_t node, const std::vector<std::string> &keys, const std::vector<int> &values, size_t begin, size_t end, size_t depth);
+
+            ///
+            /// @brief  Find the base for the transition labels, where all the target units are not used
+            ///
+            size_t findBase(const std::vector<int> &labels);
+
+            ///
+            /// @brief  Make sure the double array being built holds the unit at the position
+            ///
+            void reserve(size_t pos);
+
+        protected:
+            const Unit       *m_pUnits;     ///< The units of the double array (owned or assigned)
+            size_t            m_nUnits;     ///< The number of units
+            std::vector<Unit> m_vecUnits;   ///< The units owned by the trie when it is built
+            size_t            m_nNextFree;  ///< The position from which free unit is searched when building
+        };
+    }
+}
+
+#endif//_CST_TOOLS_UTL_DATRIE_H_
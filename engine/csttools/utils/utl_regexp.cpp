@@ -44,6 +44,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <algorithm>
 #include "utl_regexp.h"
 
 // type definitions
@@ -569,9 +570,9 @@ lbl_done:
         //
         //////////////////////////////////////////////////////////////////////////
 
-        executor::executor(program* prog, const TCHAR* inputstr)
+        executor::executor(const program* prog, const TCHAR* inputstr, TCHAR** subbeg, TCHAR** subend)
             : strinput((TCHAR*)inputstr), strbegin((TCHAR*)inputstr), 
-            regprog(prog), subbegp(prog->subbegp), subendp(prog->subendp)
+            regprog(prog), subbegp(subbeg), subendp(subend)
         {
         }
         /**
@@ -581,7 +582,7 @@ lbl_done:
         {
             strinput    = str;
             // clear all beginning/ending indicator
-            for (int i=0; i<CLOSE-OPEN; i++)
+            for (int i=0; i<MAXSUBEXP; i++)
             {
                 subbegp[i] = NULL;
                 subendp[i] = NULL;
@@ -793,14 +794,10 @@ lbl_done:
         //
         //////////////////////////////////////////////////////////////////////////
 
-        program::program(const TCHAR* exp, bool icase)
-            : programchar(0), programsize(0), compiledok(false), regstart(0), reganch(false), regmust(0), regmustlen(0)
+        program::program(const TCHAR* exp, bool icase, bool optimize)
+            : programchar(0), programsize(0), compiledok(false), usetable(false), regstart(0), reganch(false), regmust(0), regmustlen(0)
         {
-            strinput= 0;
-            subbegp = new TCHAR*[CLOSE-OPEN];
-            subendp = new TCHAR*[CLOSE-OPEN];
-            subnum  = 0;
-            if (icase==false)
+            if (icase==false || exp==NULL)
                 compiledok = compile(exp);
             else
             {
@@ -809,23 +806,21 @@ lbl_done:
                 compiledok = compile(out);
                 delete []out;
             }
+            // the simple regular expression is matched by table lookup
+            if (compiledok && optimize)
+                usetable = classtable.build(programchar);
         }
-        program::program(const program& right)
+        program::program(const program& right) : classtable(right.classtable)
         {
             programsize = right.programsize;
             programchar = new TCHAR[programsize];
             memcpy(programchar, right.programchar, sizeof(TCHAR)*programsize);
             compiledok = right.compiledok;
+            usetable = right.usetable;
             regstart = right.regstart;
             reganch  = right.reganch;
-            regmust  = right.regmust;
+            regmust  = (right.regmust==NULL) ? NULL : programchar+(right.regmust-right.programchar);
             regmustlen=right.regmustlen;
-            subbegp  = new TCHAR*[CLOSE-OPEN];
-            subendp  = new TCHAR*[CLOSE-OPEN];
-            subnum   = right.subnum;
-            memcpy(subbegp, right.subbegp, sizeof(TCHAR*)*(CLOSE-OPEN));
-            memcpy(subendp, right.subendp, sizeof(TCHAR*)*(CLOSE-OPEN));
-            strinput = right.strinput;
         }
         /**
         *  @brief  clear the regular expression information
@@ -833,18 +828,15 @@ lbl_done:
         bool program::clear()
         {
             delete []programchar;
-            delete []subbegp;
-            delete []subendp;
             programchar = 0;
             programsize = 0;
             compiledok  = false;
+            usetable = false;
+            classtable.clear();
             regstart = 0;
             reganch  = false;
             regmust  = 0;
             regmustlen = 0;
-            subbegp  = 0;
-            subendp  = 0;
-            subnum   = 0;
             return true;
         }
         /**
@@ -970,79 +962,320 @@ lbl_done:
         }
         /**
         *  @brief  match a regular expression against an input string
+        *
+        *  The program is not changed, the sub-strings are returned in result.
         */
-        bool program::match(const TCHAR* instr)
+        bool program::match(const TCHAR* instr, matchresult& result) const
         {
-            subnum = 0;
-            strinput = (TCHAR*)instr;
-            if (strinput==NULL)
-            {
-                seterror(REGERR_NULL_ARG);
+            result.subnum = 0;
+            if (instr==NULL || !compiledok)
                 return false;
-            }
             // check validity of the program
             if (*programchar!=MAGIC)
-            {
-                seterror(REGERR_CORRUPTION);
                 return false;
-            }
+            // simple character classes: table lookup
+            if (usetable)
+                return classtable.match(instr, result);
             // if there is a "must appear" string, look for it
-            if (regmust!=NULL && _tcsstr(strinput, regmust)==NULL)
+            if (regmust!=NULL && _tcsstr(instr, regmust)==NULL)
                 return false;
 
-            executor regexe(this, strinput);
+            TCHAR*   subbegp[MAXSUBEXP];
+            TCHAR*   subendp[MAXSUBEXP];
+            TCHAR*   strinput = (TCHAR*)instr;
+            TCHAR*   strmatch = NULL;
+            executor regexe(this, strinput, subbegp, subendp);
 
-            // simplest case: anchored match, need be tried only once
             if (reganch)
             {
+                // simplest case: anchored match, need be tried only once
                 if (regexe.matchtry(strinput))
+                    strmatch = strinput;
+            }
+            else if (regstart!='\0')
+            {
+                // messy cases: unanchored match, we know what TCHAR it must start with
+                for (TCHAR* str=strinput; str!=NULL; str=(*str=='\0')?NULL:_tcschr(str+1, regstart))
                 {
-                    // count the sub-strings
-                    for (subnum=0; subnum<CLOSE-OPEN && subbegp[subnum]; subnum++)
+                    if (regexe.matchtry(str))
                     {
-                        if (subendp[subnum]==NULL)
-                            subendp[subnum] = subbegp[subnum];
+                        strmatch = str;
+                        break;
                     }
-                    return true;
                 }
-                return false;
             }
-
-            // messy cases: unanchored match
-            if (regstart!='\0')
+            else
             {
-                // we know what TCHAR it must start with
-                for (TCHAR* str=strinput; str!=NULL; str=_tcschr(str+1, regstart))
+                // we do not know - general case: match it one TCHAR by one TCHAR
+                for (TCHAR* str=strinput; (*str)!='\0'; str++)
                 {
                     if (regexe.matchtry(str))
                     {
-                        for (subnum=0; subnum<CLOSE-OPEN && subbegp[subnum]; subnum++)
-                        {
-                            if (subendp[subnum]==NULL)
-                                subendp[subnum] = subbegp[subnum];
-                        }
-                        return true;
+                        strmatch = str;
+                        break;
                     }
                 }
+            }
+            if (strmatch==NULL)
                 return false;
+
+            // count the sub-strings
+            for (result.subnum=0; result.subnum<MAXSUBEXP && subbegp[result.subnum]; result.subnum++)
+            {
+                if (subendp[result.subnum]==NULL)
+                    subendp[result.subnum] = subbegp[result.subnum];
+                result.subbeg[result.subnum] = (int)(subbegp[result.subnum]-strinput);
+                result.subend[result.subnum] = (int)(subendp[result.subnum]-strinput);
             }
+            return true;
+        }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        //  classprogram
+        //
+        //////////////////////////////////////////////////////////////////////////
+
+        /**
+        *  @brief  Whether the character (not '\0') is in the character class
+        */
+        bool classprogram::charset::contains(TCHAR c) const
+        {
+            bool found;
+            if ((unsigned int)c<128)
+                found = ascii[(unsigned int)c];
             else
+                found = std::binary_search(others.begin(), others.end(), c);
+            return found!=negate;
+        }
+        /**
+        *  @brief  Whether no character is in both of the character classes
+        */
+        bool classprogram::charset::disjoint(const charset& right) const
+        {
+            if (negate && right.negate)
+                return false;
+            if (negate || right.negate)
             {
-                // we do not know - general case: match it one TCHAR by one TCHAR
-                for (TCHAR* str=strinput; (*str)!='\0'; str++)
+                // all characters of the positive class must be excluded by the negative class
+                const charset& pos = negate ? right : *this;
+                const charset& neg = negate ? *this : right;
+                for (int c=1; c<128; c++)
                 {
-                    if (regexe.matchtry(str))
+                    if (pos.ascii[c] && !neg.ascii[c])
+                        return false;
+                }
+                for (size_t i=0; i<pos.others.size(); i++)
+                {
+                    if (!std::binary_search(neg.others.begin(), neg.others.end(), pos.others[i]))
+                        return false;
+                }
+                return true;
+            }
+            for (int c=1; c<128; c++)
+            {
+                if (ascii[c] && right.ascii[c])
+                    return false;
+            }
+            for (size_t i=0; i<others.size(); i++)
+            {
+                if (std::binary_search(right.others.begin(), right.others.end(), others[i]))
+                    return false;
+            }
+            return true;
+        }
+        /**
+        *  @brief  Clear the sequence of steps
+        */
+        void classprogram::clear()
+        {
+            steps.clear();
+            anchored = false;
+            mustend  = false;
+            groupnum = 0;
+        }
+        /**
+        *  @brief  Append the character class of the program node as one step, return false if it is not a character class
+        */
+        bool classprogram::addclass(TCHAR* prognode, size_t minrep, size_t maxrep)
+        {
+            step cls;
+            cls.minrep = minrep;
+            cls.maxrep = maxrep;
+            const TCHAR* opnd = OPERAND(prognode);
+            switch (OPERATOR(prognode))
+            {
+            case ANY:
+                cls.chars.negate = true;
+                opnd = NULL;
+                break;
+            case ANYBUT:
+                cls.chars.negate = true;
+                break;
+            case ANYOF:
+                break;
+            case EXACTLY:
+                // the characters after the first one are compared ignoring case by executor
+                if (opnd[0]=='\0' || opnd[1]!='\0')
+                    return false;
+                break;
+            default:
+                return false;
+            }
+            for (; opnd!=NULL && *opnd!='\0'; opnd++)
+            {
+                if ((unsigned int)*opnd<128)
+                    cls.chars.ascii[(unsigned int)*opnd] = true;
+                else
+                    cls.chars.others.push_back(*opnd);
+            }
+            std::sort(cls.chars.others.begin(), cls.chars.others.end());
+            steps.push_back(cls);
+            return true;
+        }
+        /**
+        *  @brief  Build the sequence of character classes from the compiled program,
+        *          return false if it is not a simple regular expression of character classes
+        */
+        bool classprogram::build(TCHAR* program)
+        {
+            clear();
+            TCHAR* scan = program+1;    // first BRANCH
+            if (OPERATOR(REGNEXT(scan))!=END)
+            {
+                // alternatives of single characters, which are merged into one character class
+                step alt;
+                for (; OPERATOR(scan)==BRANCH; scan=REGNEXT(scan))
+                {
+                    TCHAR* node = OPERAND(scan);
+                    if ((OPERATOR(node)!=ANYOF && OPERATOR(node)!=EXACTLY) || OPERATOR(REGNEXT(node))!=END || !addclass(node, 1, 1))
                     {
-                        for (subnum=0; subnum<CLOSE-OPEN && subbegp[subnum]; subnum++)
-                        {
-                            if (subendp[subnum]==NULL)
-                                subendp[subnum] = subbegp[subnum];
-                        }
-                        return true;
+                        clear();
+                        return false;
                     }
+                    const charset& chars = steps.back().chars;
+                    for (int c=0; c<128; c++)
+                        alt.chars.ascii[c] = alt.chars.ascii[c] || chars.ascii[c];
+                    alt.chars.others.insert(alt.chars.others.end(), chars.others.begin(), chars.others.end());
+                    steps.pop_back();
+                }
+                std::sort(alt.chars.others.begin(), alt.chars.others.end());
+                steps.push_back(alt);
+                return true;
+            }
+
+            // sequence of character classes
+            for (TCHAR* next; OPERATOR(scan)!=END; scan=next)
+            {
+                const TCHAR op = OPERATOR(scan);
+                next = REGNEXT(scan);
+                if (op==BOL && scan==OPERAND(program+1) && steps.empty())
+                    anchored = true;
+                else if (op==EOL && OPERATOR(next)==END)
+                    mustend = true;
+                else if (op==NOTHING)
+                    continue;
+                else if (op==STAR || op==PLUS)
+                {
+                    if (!addclass(OPERAND(scan), (op==STAR) ? 0 : 1, (size_t)-1))
+                        break;
+                }
+                else if (op==BRANCH && OPERATOR(next)!=BRANCH)
+                {
+                    // no choice
+                    next = OPERAND(scan);
+                }
+                else if (op==BRANCH)
+                {
+                    // x? is emitted as (x|), where both x and the second BRANCH are followed by the same NOTHING
+                    TCHAR* empty = OPERAND(next);
+                    if (OPERATOR(empty)!=NOTHING || REGNEXT(next)!=empty || REGNEXT(OPERAND(scan))!=empty || !addclass(OPERAND(scan), 0, 1))
+                        break;
+                    next = REGNEXT(empty);
+                }
+                else if (op>OPEN && op<CLOSE)
+                {
+                    step mark;
+                    mark.group = op-OPEN;
+                    steps.push_back(mark);
+                    groupnum = (mark.group>groupnum) ? mark.group : groupnum;
+                }
+                else if (op>CLOSE && op<CLOSE+(CLOSE-OPEN))
+                {
+                    step mark;
+                    mark.group = CLOSE-op;
+                    steps.push_back(mark);
                 }
+                else if (!addclass(scan, 1, 1))
+                    break;
+            }
+            if (OPERATOR(scan)!=END)
+            {
+                clear();
                 return false;
             }
+
+            // greedy match is the same as backtracking match only if the repeated class is disjoint from the following classes
+            for (size_t i=0; i<steps.size(); i++)
+            {
+                if (steps[i].group!=0 || steps[i].minrep==steps[i].maxrep)
+                    continue;
+                for (size_t j=i+1; j<steps.size(); j++)
+                {
+                    if (steps[j].group==0 && !steps[i].chars.disjoint(steps[j].chars))
+                    {
+                        clear();
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+        /**
+        *  @brief  Match the sequence of character classes at the specific point
+        */
+        bool classprogram::matchat(const TCHAR* str, const TCHAR* strbegin, matchresult& result) const
+        {
+            const TCHAR* scan = str;
+            for (std::vector<step>::const_iterator it=steps.begin(); it!=steps.end(); ++it)
+            {
+                if (it->group>0)
+                    result.subbeg[it->group] = (int)(scan-strbegin);
+                else if (it->group<0)
+                    result.subend[-it->group] = (int)(scan-strbegin);
+                else
+                {
+                    size_t count = 0;
+                    while (count<it->maxrep && *scan!='\0' && it->chars.contains(*scan))
+                    {
+                        scan++;
+                        count++;
+                    }
+                    if (count<it->minrep)
+                        return false;
+                }
+            }
+            if (mustend && *scan!='\0')
+                return false;
+            result.subbeg[0] = (int)(str-strbegin);
+            result.subend[0] = (int)(scan-strbegin);
+            result.subnum = groupnum+1;
+            return true;
+        }
+        /**
+        *  @brief  Match the sequence of character classes against the input string, at the same points as executor
+        */
+        bool classprogram::match(const TCHAR* str, matchresult& result) const
+        {
+            if (anchored)
+                return matchat(str, str, result);
+            for (const TCHAR* scan=str; *scan!='\0'; scan++)
+            {
+                if (matchat(scan, str, result))
+                    return true;
+            }
+            return false;
         }
 
 
@@ -1060,8 +1293,9 @@ lbl_done:
         *
         *  @param  expstr     [in]  The string representation of the regular expression
         *  @param  ignorecase [in]  Whether the match operation will be case insensitive
+        *  @param  optimize   [in]  Whether the simple regular expression of character classes is matched by table lookup
         */
-        regexp::regexp(const TCHAR* expstr, bool ignorecase)  : regprog(new program(expstr, ignorecase))
+        regexp::regexp(const TCHAR* expstr, bool ignorecase, bool optimize)  : regprog(new program(expstr, ignorecase, optimize))
         {
         }
         regexp::regexp(const regexp& right) : regprog(new program(*(right.regprog)))
@@ -1104,50 +1338,82 @@ lbl_done:
             return (regprog==NULL)?false:regprog->compiled();
         }
         /**
+        *  @brief  Judge whether the regular expression is matched by table lookup instead of the backtracking executor
+        */
+        bool regexp::optimized() const
+        {
+            return (regprog==NULL)?false:regprog->optimized();
+        }
+        /**
+        *  @brief  Match a string against the regular expression, return true if there is a match
+        *
+        *  @param  str [in]  The string to be matched against the regular expression
+        *  @return Whether there is a match between the string and the regular expression
+        */
+        bool regexp::match(const TCHAR* str) const
+        {
+            matchresult result;
+            return match(str, result);
+        }
+        /**
         *  @brief  Match a string against the regular expression, return true if there is a match
         *
         *  Examine the string with this regular expression, return true if there is a match.
-        *  After a successful match, the sub-strings of the match can be obtained.
+        *  After a successful match, the sub-strings of the match can be obtained from result.
         *  The 0th sub-string is the substring that matches the whole regular expression.
         *  The others are those who matches parenthesized expressions within the regular expression,
         *  which are numbered in left-to-right order of their opening parentheses.
         *  If a parenthesized expression does not participate in the match at all, its length is 0.
         *
-        *  @param  str [in]  The string to be matched against the regular expression
+        *  The regular expression is not changed, so it can be matched by several threads at the same time.
+        *
+        *  @param  str    [in]  The string to be matched against the regular expression
+        *  @param  result [out] Return the sub-strings of the match
         *  @return Whether there is a match between the string and the regular expression
         */
-        bool regexp::match(const TCHAR* str) const
+        bool regexp::match(const TCHAR* str, matchresult& result) const
         {
             if (regprog==0)
+            {
+                result = matchresult();
                 return false;
+            }
             else
-                return regprog->match(str);
+                return regprog->match(str, result);
         }
+
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        //  matchresult
+        //
+        //////////////////////////////////////////////////////////////////////////
+
         /**
-        *  @brief  Return the number of sub-strings after a successful match. -1 for error.
+        *  @brief  Return the number of sub-strings after a successful match, 0 if not matched.
         */
-        int regexp::substrings() const
+        int matchresult::substrings() const
         {
-            return (regprog==0)?-1:regprog->subnum;
+            return subnum;
         }
         /**
         *  @brief  Get the starting offset of the i-th matched sub-string from the
         *          beginning of the input string used in match(). -1 for error.
         */
-        int regexp::substart(int idx) const
+        int matchresult::substart(int idx) const
         {
-            if (regprog==0)
+            if (idx<0 || idx>=subnum)
                 return -1;
-            return (int)(regprog->subbegp[idx]-regprog->strinput);
+            return subbeg[idx];
         }
         /**
         *  @brief  Get the length of the i-th match sub-string. -1 for error.
         */
-        int regexp::sublength(int idx) const
+        int matchresult::sublength(int idx) const
         {
-            if (regprog==0)
+            if (idx<0 || idx>=subnum)
                 return -1;
-            return (int)(regprog->subendp[idx]-regprog->subbegp[idx]);
+            return subend[idx]-subbeg[idx];
         }
     } // End of namespace REGEXP
 } // End of namespace cst
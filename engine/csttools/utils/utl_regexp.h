@@ -12,6 +12,8 @@
 #endif
 
 
+#include <vector>
+
 namespace cst
 {
     namespace RegExp
@@ -22,6 +24,35 @@ namespace cst
         */
         class program;
 
+        /**
+        *  @brief  The maximum number of sub-strings, \0 is the whole matched string
+        */
+        const int MAXSUBEXP = 79;
+
+        /**
+        *  @brief  The sub-strings of a successful match
+        *
+        *  The match result is kept by the caller rather than by the regexp,
+        *  so that one compiled regexp can be shared and matched by several threads at the same time.
+        */
+        class matchresult
+        {
+        public:
+            matchresult() : subnum(0) {}
+
+        public:
+            int  substrings() const;
+            int  substart(int idx) const;
+            int  sublength(int idx) const;
+
+        private:
+            friend class program;
+            friend class classprogram;
+            int  subnum;            // numbers of the sub-strings
+            int  subbeg[MAXSUBEXP]; // offsets of the sub-string beginning, from the beginning of the input string
+            int  subend[MAXSUBEXP]; // offsets of the sub-string ending
+        };
+
         /**
         *  @brief  A simple class for regular expression operations
         *
@@ -30,11 +61,14 @@ namespace cst
         *  So the user should declare a STATIC regexp object in his/her program,
         *  and just compile once in the construction of the regexp object,
         *  and use compiled() to determine whether the regexp is compiled OK.
+        *
+        *  The compiled regexp is not changed by matching, the sub-strings are returned in matchresult,
+        *  so the static regexp object can be used by several threads at the same time.
         */
         class regexp
         {
         public:
-            regexp(const TCHAR* expstr, bool ignorecase=false);
+            regexp(const TCHAR* expstr, bool ignorecase=false, bool optimize=true);
             regexp(const regexp& right);
             ~regexp();
             const regexp& operator=(const regexp& right);
@@ -42,10 +76,9 @@ namespace cst
         public:
             /*const TCHAR* errormsg() const;*/
             bool compiled() const;
+            bool optimized() const;
             bool match(const TCHAR* str) const;
-            int  substrings() const;
-            int  substart(int idx) const;
-            int  sublength(int idx) const;
+            bool match(const TCHAR* str, matchresult& result) const;
 
         private:
             program* regprog;
@@ -196,7 +229,7 @@ namespace cst
         class executor : public accessor
         {
         public:
-            executor(program* prog, const TCHAR* inputstr);
+            executor(const program* prog, const TCHAR* inputstr, TCHAR** subbeg, TCHAR** subend);
             bool matchtry(TCHAR* str);
         protected:
             bool match(TCHAR* program);
@@ -206,7 +239,53 @@ namespace cst
             TCHAR*  strbegin;    // beginning of the string, for ^ check
             TCHAR** subbegp;     // pointer to the sub-string beginning
             TCHAR** subendp;     // pointer to the sub-string ending
-            program* regprog;   // pointer to the regexp being executed
+            const program* regprog; // pointer to the regexp being executed
+        };
+
+        /**
+        *  @brief  The class to match the simple regular expression of character classes by table lookup
+        *
+        *  The simple regular expression is a sequence of character classes (".", "[...]", "[^...]" or one character),
+        *  each of which may be followed by "*", "+" or "?", with optional "^", "$" and not repeated "()",
+        *  or the alternatives of single character classes (e.g. "[a-z]|[0-9]").
+        *  Each character class is converted to a lookup table, and the sequence is matched greedily without backtracking.
+        *  So it is only used when each repeated class is disjoint from all the classes following it,
+        *  where the greedy match always gives the same result as the backtracking match of executor.
+        */
+        class classprogram : public accessor
+        {
+        public:
+            classprogram() : anchored(false), mustend(false), groupnum(0) {}
+            bool build(TCHAR* program);
+            bool match(const TCHAR* str, matchresult& result) const;
+            void clear();
+        protected:
+            /// the set of characters matched by one character class
+            struct charset
+            {
+                charset() : negate(false) {for (int c=0; c<128; c++) ascii[c] = false;}
+                bool  negate;               // match the characters not in the set
+                bool  ascii[128];           // whether ASCII character is in the set
+                std::vector<TCHAR> others;  // sorted none-ASCII characters in the set
+                bool  contains(TCHAR c) const;
+                bool  disjoint(const charset& right) const;
+            };
+            /// one step of the sequence, a repeated character class or a sub-string mark
+            struct step
+            {
+                step() : group(0), minrep(1), maxrep(1) {}
+                int     group;              // sub-string number, positive for "(", negative for ")", 0 for character class
+                charset chars;              // the character class
+                size_t  minrep;             // minimum number of repeat
+                size_t  maxrep;             // maximum number of repeat
+            };
+            bool addclass(TCHAR* prognode, size_t minrep, size_t maxrep);
+            bool matchat(const TCHAR* str, const TCHAR* strbegin, matchresult& result) const;
+        private:
+            std::vector<step> steps;    // the sequence of steps
+            bool  anchored;             // is the match anchored (at beginning-of-line only)?
+            bool  mustend;              // must the match end at end-of-line?
+            int   groupnum;             // number of sub-strings, excluding \0
         };
 
         /**
@@ -215,12 +294,13 @@ namespace cst
         class program : public accessor
         {
         public:
-            program(const TCHAR* exp, bool icase);
+            program(const TCHAR* exp, bool icase, bool optimize);
             program(const program& right);
             ~program() {clear();}
         protected:
             bool compiled() const {return compiledok;}
-            bool match(const TCHAR* instr);
+            bool optimized() const {return compiledok && usetable;}
+            bool match(const TCHAR* instr, matchresult& result) const;
             void igncase(const TCHAR* src, TCHAR* out);
             bool compile(const TCHAR* expstr);
             bool clear();
@@ -234,10 +314,8 @@ namespace cst
             bool  compiledok;   // whether the regular expression is compiled OK or not
             TCHAR* programchar;  // the compiled regular expression "program"
             int   programsize;  // the size of the compiled regular expression
-            TCHAR**subbegp;      // pointers to the sub-string beginning, \0 is the whole matched string
-            TCHAR**subendp;      // pointers to the sub-string ending
-            int   subnum;       // numbers  of the sub-strings
-            TCHAR* strinput;     // keeps pointer to the input string for the last matching
+            bool  usetable;     // whether the regular expression is matched by classtable instead of executor
+            classprogram classtable; // the simple regular expression of character classes, for table lookup
         private:
             TCHAR  regstart;     // TCHAR that must begin a match, '\0' if none obvious
             bool  reganch;      // is the match anchored (at beginning-of-line only)?
@@ -267,9 +345,13 @@ namespace cst
         class CRegexp:public RegExp::regexp
         {
         public:
-            CRegexp(const TCHAR* expstr, bool ignorecase=false):regexp(expstr,ignorecase){}
+            CRegexp(const TCHAR* expstr, bool ignorecase=false, bool optimize=true):regexp(expstr,ignorecase,optimize){}
             CRegexp(const CRegexp& right):regexp(right){}
         };
+
+        class CRegexpMatch:public RegExp::matchresult
+        {
+        };
     }
 }
 
@@ -72,9 +72,15 @@
 ///   Date:     2008/05/31
 ///   Changed:  Changed some interfaces for IVTDataSource and CViterbiDecoder,
 ///             Fixed the memory leak bug in CViterbiDecoder destructor.
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the beam pruning of the search, created one path for each candidate
 ///
 
 #include <string.h>
+#include <vector>
+#include <algorithm>
 #include "utl_viterbi.h"
 
 namespace cst
@@ -199,40 +205,62 @@ namespace cst
                 // initialize the sate paths array according to the candidates
                 initDynamicStates(point, point->cands);
 
-                // calculate the accumulative score for 
-                // each "new candidate" and "previous path" combination
-                for (unsigned int i = 0; i< prev_point->num_states; ++i)
+                // calculate the accumulative score for each "new candidate" with the best "previous path",
+                // only the best path is created for each candidate as others are discarded by addPath() anyway
+                for (CVTCandidate *c = point->cands; c != NULL; c = c->next)
                 {
-                    for (CVTCandidate *c = point->cands; c != NULL; c = c->next)
+                    CVTPath *best = NULL;
+                    double bestScore = 0;
+                    bool found = false;
+                    for (unsigned int i = 0; i < prev_point->num_states; ++i)
                     {
-                        CVTPath *path = new CVTPath();
-                        if (path == NULL)
+                        CVTPath *prev = prev_point->state_paths[i];
+                        if (prev == NULL && prev_point != timeline)
                         {
-                            // path creation error, just continue to next candidate
+                            // the path is pruned
                             continue;
                         }
 
-                        // fill up candidate information, including candidate (target) score
-                        path->from  = prev_point->state_paths[i];
-                        path->cand  = c;
-                        path->state = c->pos;
-                        path->score = c->score;
+                        // candidate (target) score
+                        double score = c->score;
 
                         // compute the path accumulative score
-                        if (prev_point->state_paths[i] != NULL)
+                        if (prev != NULL)
                         {
-                            // transition (combine) score
-                            CVTCandidate *preCand = prev_point->state_paths[i]->cand;
-                            path->score += dataSource->getTransitionScore(preCand, c);
+                            // transition (combine) score and path accumulative score
+                            score += dataSource->getTransitionScore(prev->cand, c);
+                            score += prev->score;
+                        }
 
-                            // path accumulative score
-                            path->score += prev_point->state_paths[i]->score;
+                        if (!found || betterThan(score, bestScore))
+                        {
+                            found     = true;
+                            best      = prev;
+                            bestScore = score;
                         }
+                    }
+                    if (!found)
+                        continue;
 
-                        // set the new paths in the decoder table
-                        addPaths(point, path);
+                    CVTPath *path = new CVTPath();
+                    if (path == NULL)
+                    {
+                        // path creation error, just continue to next candidate
+                        continue;
                     }
+
+                    // fill up candidate information and the accumulative score
+                    path->from  = best;
+                    path->cand  = c;
+                    path->state = c->pos;
+                    path->score = bestScore;
+
+                    // set the new paths in the decoder table
+                    addPaths(point, path);
                 }
+
+                // keep the best paths in the beam
+                prunePaths(point);
             }
         }
 
@@ -268,6 +296,52 @@ namespace cst
             }
         }
 
+        void CViterbiDecoder::prunePaths(CVTPoint *point)
+        {
+            if (beam_width == 0 || point->num_states <= beam_width)
+                return;
+
+            // find the score of the worst path in the beam
+            std::vector<double> scores;
+            scores.reserve(point->num_states);
+            for (unsigned int i = 0; i < point->num_states; ++i)
+            {
+                if (point->state_paths[i] != NULL)
+                    scores.push_back(point->state_paths[i]->score);
+            }
+            if (scores.size() <= beam_width)
+                return;
+            std::vector<double>::iterator nth = scores.begin() + (beam_width - 1);
+            if (big_is_good)
+                std::nth_element(scores.begin(), nth, scores.end(), std::greater<double>());
+            else
+                std::nth_element(scores.begin(), nth, scores.end());
+            double threshold = *nth;
+
+            // the paths tied with the threshold fill the rest of the beam in order of state
+            unsigned int ties = beam_width;
+            for (std::vector<double>::iterator it = scores.begin(); it != scores.end(); ++it)
+            {
+                if (betterThan(*it, threshold))
+                    --ties;
+            }
+
+            // remove the paths out of the beam
+            for (unsigned int i = 0; i < point->num_states; ++i)
+            {
+                CVTPath *path = point->state_paths[i];
+                if (path == NULL || betterThan(path->score, threshold))
+                    continue;
+                if (path->score == threshold && ties > 0)
+                {
+                    --ties;
+                    continue;
+                }
+                delete path;
+                point->state_paths[i] = NULL;
+            }
+        }
+
         unsigned int CViterbiDecoder::getResult(CVTList *results, double *scores, unsigned int n) const
         {
             if (timeline == NULL || timeline->next == NULL || results == NULL || scores == NULL || n == 0)
@@ -324,8 +398,9 @@ namespace cst
             if (n > t->num_states)
                 n = t->num_states;
 
-            // find N best paths
-            paths[0] = NULL;
+            // find N best paths, some states may be pruned
+            for (unsigned int i = 0; i < n; ++i)
+                paths[i] = NULL;
             for (unsigned int i = 0; i < t->num_states; ++i)
             {
                 if (t->state_paths[i] == NULL)
@@ -347,6 +422,8 @@ namespace cst
                     paths[j] = t->state_paths[i];
             }
 
+            while (n > 0 && paths[n-1] == NULL)
+                --n;
             return n;
         }
     }
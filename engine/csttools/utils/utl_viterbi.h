@@ -72,6 +72,10 @@
 ///   Date:     2008/05/31
 ///   Changed:  Changed some interfaces for IVTDataSource and CViterbiDecoder,
 ///             Fixed the memory leak bug in CViterbiDecoder destructor.
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the beam pruning of the search
 ///
 
 #ifndef _CST_TTS_BASE_UTL_VITERBI_H_
@@ -267,7 +271,7 @@ namespace cst
             /// @param  [in] dataSrc    Data source where candidates, target and combine score function are specified
             /// @param  [in] bigIsGood  Whether bigger (e.g. likelihood) or smaller (e.g. cost) score is better
             ///
-            CViterbiDecoder(const IVTDataSource *dataSrc, bool bigIsGood) : dataSource(dataSrc), timeline(NULL), big_is_good(bigIsGood) {}
+            CViterbiDecoder(const IVTDataSource *dataSrc, bool bigIsGood) : dataSource(dataSrc), timeline(NULL), big_is_good(bigIsGood), beam_width(0) {}
 
             ///
             /// @brief  Destructor
@@ -284,6 +288,17 @@ namespace cst
             ///
             bool initialize(const CVTList &input);
 
+            ///
+            /// @brief  Set the beam width for pruning the search
+            ///
+            /// Only the best "beamWidth" paths at each decoder table node are extended to the next node,
+            /// so that the search time grows linearly with the beam width instead of the square of the
+            /// number of candidates. The result may not be the global best path when pruned.
+            ///
+            /// @param  [in] beamWidth  The maximum number of paths kept at each node, 0 for no pruning (full search)
+            ///
+            void setBeamWidth(unsigned int beamWidth) {beam_width = beamWidth;}
+
             ///
             /// @brief  Perform the actual Viterbi search
             ///
@@ -372,6 +387,13 @@ namespace cst
             ///
             void addPath(CVTPoint *point, CVTPath *newpath);
 
+            ///
+            /// @brief  Remove the paths out of the beam from the decoder table node
+            ///
+            /// @param  [in] point      Decoder table node whose paths are pruned
+            ///
+            void prunePaths(CVTPoint *point);
+
             ///
             /// @brief  Determine whether a is "better" than b according to "big_is_good" flag
             ///
@@ -406,6 +428,11 @@ namespace cst
             ///
             bool big_is_good;
 
+            ///
+            /// @brief  The maximum number of paths kept at each node, 0 for no pruning
+            ///
+            unsigned int beam_width;
+
             ///
             /// @brief  The data source
             ///
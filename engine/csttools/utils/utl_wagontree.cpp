@@ -28,12 +28,23 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2011/06/09
 ///   Changed:  Modified by re-organizing the classes and adding comments
+/// - Version:  0.2.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the compiled Wagon Tree with integer features and binary format
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Defined the constants of the compiled Wagon Tree
 ///
 
 
+#include <string.h>
 #include <string>
 #include <stack>
 #include <iostream>
+#include "cmn/cmn_file.h"
+#include "utl_string.h"
 #include "utl_wagontree.h"
 
 #ifdef _DEBUG
@@ -420,5 +431,383 @@ namespace cst
             return (!error && m_pRoot != NULL);
         }
 
+
+        //////////////////////////////////////////////////////////////////////////
+        //
+        //  CompiledWagonTree
+        //
+        //////////////////////////////////////////////////////////////////////////
+
+        const int CCompiledWagonTree::SYMBOL_UNKNOWN;
+        const int CCompiledWagonTree::SYMBOL_MISSING;
+        const int CCompiledWagonTree::INVALID_ID;
+
+        /// Magic string of the binary file of compiled Wagon Tree
+        static const char WAGON_TREE_MAGIC[8] = "CSTWAGN";
+
+        /// Version of the format of the binary file of compiled Wagon Tree
+        static const unsigned int WAGON_TREE_VERSION = 1;
+
+        ///
+        /// @brief  Header of the binary file of compiled Wagon Tree.
+        ///
+        /// The header is followed by the sections of nodes, leaves, leaf pairs, and the UTF-8 strings
+        /// (zero-terminated) of the feature names, the symbols and the values in the order of their IDs.
+        ///
+        struct WagonTreeHeader
+        {
+            char         magic[8];      ///< Magic string "CSTWAGN" for identifying the file
+            unsigned int version;       ///< Version of the format of the binary file
+            unsigned int byteOrder;     ///< 0x01020304 in the byte order of the machine where file is saved
+            unsigned int numNodes;      ///< Number of nodes
+            unsigned int numLeaves;     ///< Number of leaves
+            unsigned int numPairs;      ///< Number of leaf pairs
+            unsigned int numFeatures;   ///< Number of feature names
+            unsigned int numSymbols;    ///< Number of symbols
+            unsigned int numValues;     ///< Number of values
+            unsigned int sizeStrings;   ///< Size of the string section (in byte)
+        };
+
+        ///
+        /// @brief  Intern the string into the table, return its ID
+        ///
+        static int internString(const std::wstring &str, std::map<std::wstring, int> &table)
+        {
+            std::map<std::wstring, int>::iterator it = table.find(str);
+            if (it != table.end())
+                return it->second;
+            int id = (int)table.size();
+            table.insert(std::make_pair(str, id));
+            return id;
+        }
+
+        ///
+        /// @brief  Convert the interned table into the vector indexed by ID
+        ///
+        static void tableToVector(const std::map<std::wstring, int> &table, std::vector<std::wstring> &strings)
+        {
+            strings.resize(table.size());
+            for (std::map<std::wstring, int>::const_iterator it = table.begin(); it != table.end(); ++it)
+                strings[it->second] = it->first;
+        }
+
+        bool CCompiledWagonTree::compile(const CWagonTree &tree)
+        {
+            clear();
+            if (tree.getRoot() == NULL)
+                return false;
+
+            std::map<std::wstring, int> features, symbols, values;
+            if (compileNode(tree.getRoot(), features, symbols, values) == INVALID_ID)
+            {
+                clear();
+                return false;
+            }
+            m_featureIDs = features;
+            m_symbolIDs  = symbols;
+            tableToVector(features, m_features);
+            tableToVector(symbols, m_symbols);
+            tableToVector(values, m_values);
+            return true;
+        }
+
+        int CCompiledWagonTree::compileNode(const CWagonNode *node, std::map<std::wstring, int> &features, std::map<std::wstring, int> &symbols, std::map<std::wstring, int> &values)
+        {
+            int index = (int)m_nodes.size();
+            m_nodes.push_back(CompiledNode());
+
+            const CWagonNodeLeaf *leaf = dynamic_cast<const CWagonNodeLeaf*>(node);
+            if (leaf != NULL)
+            {
+                CompiledLeaf compiledLeaf;
+                compiledLeaf.mostProbValue = internString(leaf->getMostProbValue(), values);
+                compiledLeaf.firstPair     = (int)m_pairs.size();
+                compiledLeaf.numPairs      = (int)leaf->getLeafPairs().size();
+                for (CWagonNode::typeLeafPairs::const_iterator it = leaf->getLeafPairs().begin(); it != leaf->getLeafPairs().end(); ++it)
+                {
+                    CompiledPair pair;
+                    pair.value       = internString(it->first, values);
+                    pair.probability = it->second;
+                    m_pairs.push_back(pair);
+                }
+
+                CompiledNode &compiledNode = m_nodes[index];
+                compiledNode.feature = INVALID_ID;
+                compiledNode.op      = QuestionEvaluator::OP_MAX;
+                compiledNode.symbol  = SYMBOL_UNKNOWN;
+                compiledNode.number  = 0;
+                compiledNode.next    = (int)m_leaves.size();
+                m_leaves.push_back(compiledLeaf);
+                return index;
+            }
+
+            const CWagonNodeQuestion *question = dynamic_cast<const CWagonNodeQuestion*>(node);
+            if (question == NULL || question->getChild(0) == NULL || question->getChild(1) == NULL)
+                return INVALID_ID;
+            const QuestionEvaluator &evaluator = question->getQuestion();
+            int feature = internString(evaluator.getFeature(), features);
+            int op      = (evaluator.getOP() >= 0 && evaluator.getOP() < QuestionEvaluator::OP_MAX) ? evaluator.getOP() : QuestionEvaluator::OP_MAX;
+            int symbol  = (op == QuestionEvaluator::OP_IS || op == QuestionEvaluator::OP_IS_NOT) ? internString(evaluator.getValue(), symbols) : SYMBOL_UNKNOWN;
+
+            // YES child follows the node, then NO child
+            if (compileNode(question->getChild(0), features, symbols, values) == INVALID_ID)
+                return INVALID_ID;
+            int no = compileNode(question->getChild(1), features, symbols, values);
+            if (no == INVALID_ID)
+                return INVALID_ID;
+
+            CompiledNode &compiledNode = m_nodes[index];
+            compiledNode.feature = feature;
+            compiledNode.op      = op;
+            compiledNode.symbol  = symbol;
+            compiledNode.number  = evaluator.getFloatValue();
+            compiledNode.next    = no;
+            return index;
+        }
+
+        bool CCompiledWagonTree::loadFromText(std::wistream &iStream)
+        {
+            CWagonTree tree;
+            if (!tree.loadFromText(iStream))
+            {
+                clear();
+                return false;
+            }
+            return compile(tree);
+        }
+
+        bool CCompiledWagonTree::save(const wchar_t *fileName) const
+        {
+            if (empty())
+                return false;
+
+            // string section
+            std::string strings;
+            const std::vector<std::wstring> *tables[3] = {&m_features, &m_symbols, &m_values};
+            for (int t = 0; t < 3; t++)
+            {
+                for (std::vector<std::wstring>::const_iterator it = tables[t]->begin(); it != tables[t]->end(); ++it)
+                {
+                    strings += str::wcstombs(*it, str::ENC_UTF8);
+                    strings += '\0';
+                }
+            }
+
+            WagonTreeHeader header;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, WAGON_TREE_MAGIC, sizeof(header.magic));
+            header.version     = WAGON_TREE_VERSION;
+            header.byteOrder   = 0x01020304;
+            header.numNodes    = (unsigned int)m_nodes.size();
+            header.numLeaves   = (unsigned int)m_leaves.size();
+            header.numPairs    = (unsigned int)m_pairs.size();
+            header.numFeatures = (unsigned int)m_features.size();
+            header.numSymbols  = (unsigned int)m_symbols.size();
+            header.numValues   = (unsigned int)m_values.size();
+            header.sizeStrings = (unsigned int)strings.size();
+
+            cmn::CFile binFile;
+            if (!binFile.open(fileName, L"wb"))
+                return false;
+            bool succ = binFile.write(&header, sizeof(header), 1) == 1;
+            succ = succ && binFile.write(&m_nodes[0], sizeof(CompiledNode), m_nodes.size()) == m_nodes.size();
+            succ = succ && binFile.write(&m_leaves[0], sizeof(CompiledLeaf), m_leaves.size()) == m_leaves.size();
+            succ = succ && (m_pairs.empty() || binFile.write(&m_pairs[0], sizeof(CompiledPair), m_pairs.size()) == m_pairs.size());
+            succ = succ && (strings.empty() || binFile.write(strings.c_str(), 1, strings.size()) == strings.size());
+            return succ;
+        }
+
+        bool CCompiledWagonTree::load(const wchar_t *fileName)
+        {
+            clear();
+            cmn::CFile binFile;
+            if (!binFile.open(fileName, L"rb"))
+                return false;
+
+            // check the header
+            WagonTreeHeader header;
+            if (binFile.read(&header, sizeof(header), 1) != 1 ||
+                memcmp(header.magic, WAGON_TREE_MAGIC, sizeof(WAGON_TREE_MAGIC)) != 0 ||
+                header.version != WAGON_TREE_VERSION || header.byteOrder != 0x01020304 ||
+                header.numNodes == 0 || header.numNodes > 0x7FFFFFFF || header.numLeaves > header.numNodes ||
+                header.numPairs > 0x7FFFFFFF || header.numFeatures > header.numNodes || header.numSymbols > header.numNodes ||
+                header.numValues > header.numPairs + header.numLeaves)
+                return false;
+
+            // the sections must fit in the file
+            long long sizeHeader = binFile.tell();
+            if (!binFile.seek(0, SEEK_END))
+                return false;
+            long long sizeSections = (long long)header.numNodes * sizeof(CompiledNode) + (long long)header.numLeaves * sizeof(CompiledLeaf) +
+                (long long)header.numPairs * sizeof(CompiledPair) + header.sizeStrings;
+            if (binFile.tell() - sizeHeader != sizeSections || !binFile.seek(sizeHeader, SEEK_SET))
+                return false;
+
+            // read all sections
+            m_nodes.resize(header.numNodes);
+            m_leaves.resize(header.numLeaves);
+            m_pairs.resize(header.numPairs);
+            std::string strings(header.sizeStrings, '\0');
+            bool succ = binFile.read(&m_nodes[0], sizeof(CompiledNode), m_nodes.size()) == m_nodes.size();
+            succ = succ && (m_leaves.empty() || binFile.read(&m_leaves[0], sizeof(CompiledLeaf), m_leaves.size()) == m_leaves.size());
+            succ = succ && (m_pairs.empty() || binFile.read(&m_pairs[0], sizeof(CompiledPair), m_pairs.size()) == m_pairs.size());
+            succ = succ && (strings.empty() || binFile.read(&strings[0], 1, strings.size()) == strings.size());
+
+            // strings
+            std::vector<std::wstring> *tables[3] = {&m_features, &m_symbols, &m_values};
+            unsigned int counts[3] = {header.numFeatures, header.numSymbols, header.numValues};
+            size_t pos = 0;
+            for (int t = 0; succ && t < 3; t++)
+            {
+                tables[t]->resize(counts[t]);
+                for (unsigned int i = 0; succ && i < counts[t]; i++)
+                {
+                    size_t end = strings.find('\0', pos);
+                    succ = (end != std::string::npos);
+                    if (succ)
+                        (*tables[t])[i] = str::mbstowcs(strings.substr(pos, end - pos), str::ENC_UTF8);
+                    pos = end + 1;
+                }
+            }
+
+            // the children follow their parents, so that prediction always terminates
+            int numNodes = (int)m_nodes.size();
+            for (int i = 0; succ && i < numNodes; i++)
+            {
+                const CompiledNode &node = m_nodes[i];
+                if (node.feature == INVALID_ID)
+                    succ = node.next >= 0 && node.next < (int)m_leaves.size();
+                else
+                    succ = node.feature >= 0 && node.feature < (int)m_features.size() &&
+                        node.op >= 0 && node.op <= QuestionEvaluator::OP_MAX &&
+                        node.symbol >= SYMBOL_UNKNOWN && node.symbol < (int)m_symbols.size() &&
+                        i + 1 < numNodes && node.next > i + 1 && node.next < numNodes;
+            }
+            for (size_t i = 0; succ && i < m_leaves.size(); i++)
+            {
+                const CompiledLeaf &leaf = m_leaves[i];
+                succ = leaf.mostProbValue >= 0 && leaf.mostProbValue < (int)m_values.size() &&
+                    leaf.firstPair >= 0 && leaf.numPairs >= 0 && leaf.numPairs <= (int)m_pairs.size() - leaf.firstPair;
+            }
+            for (size_t i = 0; succ && i < m_pairs.size(); i++)
+                succ = m_pairs[i].value >= 0 && m_pairs[i].value < (int)m_values.size();
+            if (!succ)
+            {
+                clear();
+                return false;
+            }
+
+            for (int i = 0; i < (int)m_features.size(); i++)
+                m_featureIDs.insert(std::make_pair(m_features[i], i));
+            for (int i = 0; i < (int)m_symbols.size(); i++)
+                m_symbolIDs.insert(std::make_pair(m_symbols[i], i));
+            return true;
+        }
+
+        void CCompiledWagonTree::clear()
+        {
+            m_features.clear();
+            m_featureIDs.clear();
+            m_symbols.clear();
+            m_symbolIDs.clear();
+            m_values.clear();
+            m_nodes.clear();
+            m_leaves.clear();
+            m_pairs.clear();
+        }
+
+        int CCompiledWagonTree::getFeatureID(const std::wstring &feature) const
+        {
+            std::map<std::wstring, int>::const_iterator it = m_featureIDs.find(feature);
+            return (it != m_featureIDs.end()) ? it->second : INVALID_ID;
+        }
+
+        int CCompiledWagonTree::getSymbolID(const std::wstring &value) const
+        {
+            std::map<std::wstring, int>::const_iterator it = m_symbolIDs.find(value);
+            return (it != m_symbolIDs.end()) ? it->second : SYMBOL_UNKNOWN;
+        }
+
+        void CCompiledWagonTree::getFeatures(const std::map<std::wstring, TestProperty> &test, std::vector<CFeatureValue> &features) const
+        {
+            features.assign(m_features.size(), CFeatureValue());
+
+            // both maps are sorted by feature name, merge them instead of looking up each feature
+            std::map<std::wstring, int>::const_iterator itFeature = m_featureIDs.begin();
+            std::map<std::wstring, TestProperty>::const_iterator itTest = test.begin();
+            while (itFeature != m_featureIDs.end() && itTest != test.end())
+            {
+                int cmp = itFeature->first.compare(itTest->first);
+                if (cmp < 0)
+                    ++itFeature;
+                else if (cmp > 0)
+                    ++itTest;
+                else
+                {
+                    CFeatureValue &value = features[itFeature->second];
+                    value.symbol = getSymbolID(itTest->second.sValue);
+                    value.number = itTest->second.fValue;
+                    ++itFeature;
+                    ++itTest;
+                }
+            }
+        }
+
+        int CCompiledWagonTree::predictLeaf(const CFeatureValue *features) const
+        {
+            const CompiledNode *nodes = &m_nodes[0];
+            int index = 0;
+            while (nodes[index].feature != INVALID_ID)
+            {
+                const CompiledNode &node = nodes[index];
+                const CFeatureValue &value = features[node.feature];
+                bool yes = false;
+                if (value.symbol != SYMBOL_MISSING)
+                {
+                    switch (node.op)
+                    {
+                    case QuestionEvaluator::OP_IS_NOT:
+                        yes = value.symbol != node.symbol;
+                        break;
+                    case QuestionEvaluator::OP_IS:
+                        yes = value.symbol == node.symbol;
+                        break;
+                    case QuestionEvaluator::OP_EQ:
+                        yes = value.number == node.number;
+                        break;
+                    case QuestionEvaluator::OP_GT:
+                        yes = value.number > node.number;
+                        break;
+                    case QuestionEvaluator::OP_LT:
+                        yes = value.number < node.number;
+                        break;
+                    default:
+                        break;
+                    }
+                }
+                index = yes ? index + 1 : node.next;
+            }
+            return nodes[index].next;
+        }
+
+        void CCompiledWagonTree::predict(const CFeatureValue *features, size_t numVectors, int *leaves) const
+        {
+            size_t numFeatures = m_features.size();
+            for (size_t i = 0; i < numVectors; i++)
+                leaves[i] = predictLeaf(features + i * numFeatures);
+        }
+
+        void CCompiledWagonTree::getLeafPairs(int leaf, CWagonNode::typeLeafPairs &leafPairs) const
+        {
+            const CompiledLeaf &compiledLeaf = m_leaves[leaf];
+            leafPairs.resize(compiledLeaf.numPairs);
+            for (int i = 0; i < compiledLeaf.numPairs; i++)
+            {
+                const CompiledPair &pair = m_pairs[compiledLeaf.firstPair + i];
+                leafPairs[i].first  = m_values[pair.value];
+                leafPairs[i].second = pair.probability;
+            }
+        }
+
     }
 }
@@ -28,6 +28,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2011/06/09
 ///   Changed:  Modified by re-organizing the classes and adding comments
+/// - Version:  0.2.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the compiled Wagon Tree with integer features and binary format
 ///
 
 
@@ -35,6 +39,7 @@
 #define _CST_TOOLS_UTL_WAGONTREE_H_
 
 #include <map>
+#include <string>
 #include <vector>
 
 namespace cst
@@ -113,6 +118,11 @@ namespace cst
             ///
             const std::wstring &getValue()const {return m_sValue;}
 
+            ///
+            /// @brief  Return the float value of the question
+            ///
+            float getFloatValue()const {return m_fValue;}
+
             ///
             /// @brief  Get the operator of the question
             ///
@@ -205,6 +215,16 @@ namespace cst
             ///
             virtual const CWagonNode::typeLeafPairs &predict(const std::map<std::wstring, TestProperty> &test, std::wstring &mostProbValue);
 
+            ///
+            /// @brief  Get the child node according to the index (0: yes_child, 1: no_child)
+            ///
+            const CWagonNode *getChild(int idx) const {return (idx == 0) ? m_pChildYes : m_pChildNo;}
+
+            ///
+            /// @brief  Get the question evaluator of the node
+            ///
+            const QuestionEvaluator &getQuestion() const {return m_question;}
+
         private:
             CWagonNode       *m_pChildYes;  ///< Link to child node (yes node)
             CWagonNode       *m_pChildNo;   ///< Link to child node (no node)
@@ -241,6 +261,16 @@ namespace cst
             ///
             virtual const CWagonNode::typeLeafPairs &predict(const std::map<std::wstring, TestProperty> &test, std::wstring &mostProbValue);
 
+            ///
+            /// @brief  Get the pair values (Value, Probability) of the leaf node
+            ///
+            const typeLeafPairs &getLeafPairs() const {return m_leafPairs;}
+
+            ///
+            /// @brief  Get the most probable value of the leaf node
+            ///
+            const std::wstring &getMostProbValue() const {return m_mostProbValue;}
+
         private:
             typeLeafPairs m_leafPairs;      ///< Pair values (Value, Probability) of the leaf node
             std::wstring  m_mostProbValue;  ///< Value in the pair values which has the biggest probability
@@ -302,6 +332,11 @@ namespace cst
             ///
             const CWagonNode::typeLeafPairs &predict(const std::map<std::wstring, TestProperty> &test, std::wstring &mostProbValue);
 
+            ///
+            /// @brief  Get the root node of the Wagon Tree, NULL if the tree is not loaded
+            ///
+            const CWagonNode *getRoot() const {return m_pRoot;}
+
         private:
             ///
             /// @brief  State for parsing the input text of Wagon Tree
@@ -337,6 +372,230 @@ namespace cst
             static wchar_t nextCh(std::wistream &iStream, bool ignoreWhiteSpace);
         };
 
+
+
+        ///
+        /// @brief  Class for the compiled Wagon Tree, which evaluates the features by integer IDs
+        ///
+        /// The features of the questions are numbered by dense IDs, and the string values of the questions
+        /// are interned as symbol IDs. The properties to be evaluated are given as a vector of CFeatureValue
+        /// indexed by the feature ID, so that a question compares integers or floats without looking up
+        /// the feature name or comparing strings. The nodes are kept in one array in pre-order: the YES
+        /// child of a question node is the next node, and the index of the NO child is kept in the node.
+        ///
+        /// The results are the same as CWagonTree::predict() with the same properties, including the
+        /// features not found (all questions are 'NO'), and the values not appearing in the tree
+        /// (only "is not" questions are 'YES').
+        ///
+        /// The compiled tree can be saved into a binary file, and loaded without parsing the text.
+        ///
+        class CCompiledWagonTree
+        {
+        public:
+            static const int SYMBOL_UNKNOWN = -1;   ///< Symbol ID of the string value not appearing in the tree
+            static const int SYMBOL_MISSING = -2;   ///< Symbol ID of the feature not given, all questions on it are 'NO'
+            static const int INVALID_ID     = -1;   ///< Feature ID or value ID not found
+
+            ///
+            /// @brief  Value of a feature in the feature vector
+            ///
+            class CFeatureValue
+            {
+            public:
+                int     symbol;     ///< Symbol ID of the string value (see getSymbolID()), SYMBOL_MISSING if feature not given
+                float   number;     ///< Float value
+
+            public:
+                CFeatureValue() : symbol(SYMBOL_MISSING), number(0.0f) {}
+            };
+
+        public:
+            ///
+            /// @brief  Constructor
+            ///
+            CCompiledWagonTree() {}
+
+            ///
+            /// @brief  Compile the Wagon Tree
+            ///
+            /// @param  [in] tree   The Wagon Tree loaded from text
+            ///
+            /// @return Whether Wagon Tree is compiled successfully
+            ///
+            bool compile(const CWagonTree &tree);
+
+            ///
+            /// @brief  Load the Wagon Tree from a text stream and compile it
+            ///
+            /// @param  [in] iStream  Stream to load Wagon Tree from
+            ///
+            /// @return Whether Wagon Tree is loaded successfully
+            ///
+            bool loadFromText(std::wistream &iStream);
+
+            ///
+            /// @brief  Save the compiled Wagon Tree into binary file, which can be loaded by load()
+            ///
+            /// @param  [in] fileName   Name of the binary file
+            ///
+            /// @return Whether Wagon Tree is saved successfully
+            ///
+            bool save(const wchar_t *fileName) const;
+
+            ///
+            /// @brief  Load the compiled Wagon Tree from binary file saved by save()
+            ///
+            /// @param  [in] fileName   Name of the binary file
+            ///
+            /// @return Whether Wagon Tree is loaded successfully
+            ///
+            bool load(const wchar_t *fileName);
+
+            ///
+            /// @brief  Clear the compiled Wagon Tree
+            ///
+            void clear();
+
+            ///
+            /// @brief  Whether the compiled Wagon Tree is empty (not loaded)
+            ///
+            bool empty() const {return m_nodes.empty();}
+
+        public:
+            //////////////////////////////////////////////////////////////////////////
+            //
+            //  Features and values
+            //
+            //////////////////////////////////////////////////////////////////////////
+
+            ///
+            /// @brief  Get the number of features, i.e. the length of the feature vector
+            ///
+            size_t getFeatureNumber() const {return m_features.size();}
+
+            ///
+            /// @brief  Get the name of the feature
+            ///
+            const std::wstring &getFeatureName(int featureID) const {return m_features[featureID];}
+
+            ///
+            /// @brief  Get the ID of the feature, i.e. the index in the feature vector
+            ///
+            /// @return The ID of the feature, INVALID_ID(-1) if the feature is not asked in the tree
+            ///
+            int getFeatureID(const std::wstring &feature) const;
+
+            ///
+            /// @brief  Get the symbol ID of the string value, which is kept in CFeatureValue::symbol
+            ///
+            /// @return The symbol ID of the string value, SYMBOL_UNKNOWN(-1) if the value is not asked in the tree
+            ///
+            int getSymbolID(const std::wstring &value) const;
+
+            ///
+            /// @brief  Convert the properties to the feature vector
+            ///
+            /// @param  [in]  test      The properties to be evaluated
+            /// @param  [out] features  Return the feature vector, the features not given are SYMBOL_MISSING
+            ///
+            void getFeatures(const std::map<std::wstring, TestProperty> &test, std::vector<CFeatureValue> &features) const;
+
+            ///
+            /// @brief  Get the number of the distinct values of leaf nodes (output values)
+            ///
+            size_t getValueNumber() const {return m_values.size();}
+
+            ///
+            /// @brief  Get the output value by value ID
+            ///
+            const std::wstring &getValue(int valueID) const {return m_values[valueID];}
+
+        public:
+            //////////////////////////////////////////////////////////////////////////
+            //
+            //  Prediction
+            //
+            //////////////////////////////////////////////////////////////////////////
+
+            ///
+            /// @brief  Get the leaf node matching the feature vector
+            ///
+            /// @param  [in] features   The feature vector of getFeatureNumber() values
+            ///
+            /// @return The index of the leaf node
+            ///
+            int predictLeaf(const CFeatureValue *features) const;
+
+            ///
+            /// @brief  Get the leaf nodes matching a batch of feature vectors
+            ///
+            /// @param  [in]  features      The feature vectors, getFeatureNumber() values for each vector one by one
+            /// @param  [in]  numVectors    The number of feature vectors
+            /// @param  [out] leaves        Return the indexes of the leaf nodes, numVectors values
+            ///
+            void predict(const CFeatureValue *features, size_t numVectors, int *leaves) const;
+
+            ///
+            /// @brief  Get the most probable value of the leaf node (value ID, see getValue())
+            ///
+            int getMostProbValue(int leaf) const {return m_leaves[leaf].mostProbValue;}
+
+            ///
+            /// @brief  Get the leaf pair values (Value, Probability) of the leaf node
+            ///
+            /// @param  [in]  leaf      The index of the leaf node
+            /// @param  [out] leafPairs Return the leaf pair values, the same as CWagonTree::predict()
+            ///
+            void getLeafPairs(int leaf, CWagonNode::typeLeafPairs &leafPairs) const;
+
+        protected:
+            ///
+            /// @brief  Node of the compiled Wagon Tree
+            ///
+            struct CompiledNode
+            {
+                int    feature;     ///< Feature ID of the question, INVALID_ID(-1) for leaf node
+                int    op;          ///< Operator of the question (QuestionEvaluator::EWagonOp)
+                int    symbol;      ///< Symbol ID of the string value of the question
+                float  number;      ///< Float value of the question
+                int    next;        ///< Index of the NO child for question node, index of the leaf for leaf node
+            };
+
+            ///
+            /// @brief  Leaf of the compiled Wagon Tree
+            ///
+            struct CompiledLeaf
+            {
+                int    mostProbValue;   ///< Value ID of the most probable value
+                int    firstPair;       ///< Index of the first leaf pair
+                int    numPairs;        ///< Number of leaf pairs
+            };
+
+            ///
+            /// @brief  Leaf pair (Value, Probability) of the compiled Wagon Tree
+            ///
+            struct CompiledPair
+            {
+                int    value;           ///< Value ID
+                float  probability;     ///< Probability
+            };
+
+            ///
+            /// @brief  Compile the node and its children in pre-order, return the index of the node
+            ///
+            int compileNode(const CWagonNode *node, std::map<std::wstring, int> &features, std::map<std::wstring, int> &symbols, std::map<std::wstring, int> &values);
+
+        protected:
+            std::vector<std::wstring>   m_features;     ///< Names of the features by feature ID
+            std::map<std::wstring, int> m_featureIDs;   ///< Mapping from feature name to feature ID
+            std::vector<std::wstring>   m_symbols;      ///< String values of the questions by symbol ID
+            std::map<std::wstring, int> m_symbolIDs;    ///< Mapping from string value to symbol ID
+            std::vector<std::wstring>   m_values;       ///< Output values by value ID
+            std::vector<CompiledNode>   m_nodes;        ///< Nodes in pre-order
+            std::vector<CompiledLeaf>   m_leaves;       ///< Leaves
+            std::vector<CompiledPair>   m_pairs;        ///< Leaf pairs of all leaves
+        };
+
     }//namespace Wagon
 }
 
@@ -35,6 +35,10 @@
 ///   Author:   Jackie (jackiecao@gmail.com)
 ///   Date:     2007/05/21
 ///   Changed:  Changed to cmn::wstring
+/// - Version:  0.4.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Compared element and attribute names by interned identifiers
 ///
 
 
@@ -54,7 +58,7 @@ namespace cst
             CXMLNode *pNextWord = (pWord==NULL) ? NULL : pWord->nextSibling();
             while (pNextWord != NULL)
             {
-                if (pNextWord->type() == XML_ELEMENT && pNextWord->value() == L"w")
+                if (pNextWord->type() == XML_ELEMENT && pNextWord->nameId() == XML_NAME_W)
                 {
                     return pNextWord;
                 }
@@ -68,7 +72,7 @@ namespace cst
             CXMLNode *pPrevWord = (pWord==NULL) ? NULL : pWord->prevSibling();
             while (pPrevWord != NULL)
             {
-                if (pPrevWord->type() == XML_ELEMENT && pPrevWord->value() == L"w")
+                if (pPrevWord->type() == XML_ELEMENT && pPrevWord->nameId() == XML_NAME_W)
                 {
                     return pPrevWord;
                 }
@@ -82,7 +86,7 @@ namespace cst
             CXMLNode *pFirstWord = (pSentence==NULL) ? NULL : pSentence->firstChild();
             while (pFirstWord != NULL)
             {
-                if (pFirstWord->type() == XML_ELEMENT && pFirstWord->value() == L"w")
+                if (pFirstWord->type() == XML_ELEMENT && pFirstWord->nameId() == XML_NAME_W)
                 {
                     return cst_dynamic_cast<CXMLElement *>(pFirstWord);
                 }
@@ -94,13 +98,13 @@ namespace cst
         const cmn::wstring &CSSMLDocument::getWordPOS(const CXMLNode *pWord)
         {
             static const cmn::wstring wstrDefaultPOS(L"w");
-            if (pWord == NULL || pWord->type() != XML_ELEMENT || pWord->value() != L"w")
+            if (pWord == NULL || pWord->type() != XML_ELEMENT || pWord->nameId() != XML_NAME_W)
             {
                 return wstrDefaultPOS;
             }
 
             const CXMLElement  *pElementWord = cst_dynamic_cast<const CXMLElement *>(pWord);
-            const cmn::wstring &wstrPOS = pElementWord->getAttribute(L"pos");
+            const cmn::wstring &wstrPOS = pElementWord->getAttribute(XML_NAME_POS);
             if (wstrPOS.length() == 0)
             {
                 return wstrDefaultPOS;
@@ -126,11 +130,11 @@ namespace cst
                     {
                         return pNode->value();
                     }
-                    else if(pNode->type() == XML_ELEMENT && pNode->value() == L"say-as")
+                    else if(pNode->type() == XML_ELEMENT && pNode->nameId() == XML_NAME_SAY_AS)
                     {
-                        return cst_dynamic_cast<CXMLElement *>(pNode)->getAttribute(L"read-as");
+                        return cst_dynamic_cast<CXMLElement *>(pNode)->getAttribute(XML_NAME_READ_AS);
                     }
-                    else if(pNode->type() == XML_ELEMENT && pNode->value() == L"phoneme")
+                    else if(pNode->type() == XML_ELEMENT && pNode->nameId() == XML_NAME_PHONEME)
                     {
                         pSSMLWord = cst_dynamic_cast<CXMLElement *>(pNode);
                         break;
@@ -151,7 +155,7 @@ namespace cst
                 return 0;
             }
 
-            if (pSSMLWord->value() == L"break")
+            if (pSSMLWord->nameId() == XML_NAME_BREAK)
             {
                 return pSSMLWord;
             }
@@ -162,7 +166,7 @@ namespace cst
             {
                 if (pSSMLW->type() == CXMLNode::XML_ELEMENT)
                 {
-                    if (pSSMLW->value() == L"break")
+                    if (pSSMLW->nameId() == XML_NAME_BREAK)
                     {
                         return cst_dynamic_cast<CXMLElement *>(pSSMLW);
                     }
@@ -176,27 +180,27 @@ namespace cst
 
         int CSSMLDocument::getBoundaryType(CXMLElement *pSSMLBreak)
         {
-            if (pSSMLBreak == NULL || pSSMLBreak->value() != L"break")
+            if (pSSMLBreak == NULL || pSSMLBreak->nameId() != XML_NAME_BREAK)
             {
                 return PROSBOUND_NONE;
             }
-            else if(pSSMLBreak->getAttribute(L"strength") == L"none")
+            else if(pSSMLBreak->getAttribute(XML_NAME_STRENGTH) == L"none")
             {
                 return PROSBOUND_NONE;
             }
-            else if(pSSMLBreak->getAttribute(L"strength") == L"x-weak")
+            else if(pSSMLBreak->getAttribute(XML_NAME_STRENGTH) == L"x-weak")
             {
                 return PROSBOUND_X_WEAK;
             }
-            else if(pSSMLBreak->getAttribute(L"strength") == L"weak")
+            else if(pSSMLBreak->getAttribute(XML_NAME_STRENGTH) == L"weak")
             {
                 return PROSBOUND_WEAK;
             }
-            else if(pSSMLBreak->getAttribute(L"strength") == L"strong")
+            else if(pSSMLBreak->getAttribute(XML_NAME_STRENGTH) == L"strong")
             {
                 return PROSBOUND_STRONG;
             }
-            else if(pSSMLBreak->getAttribute(L"strength") == L"x-strong")
+            else if(pSSMLBreak->getAttribute(XML_NAME_STRENGTH) == L"x-strong")
             {
                 return PROSBOUND_X_STRONG;
             }
@@ -222,8 +226,7 @@ namespace cst
             CXMLElement *pSSMLBreak = findProsodyBoundaryElemenet(pSSMLWord);
             if (pSSMLBreak != 0)
             {
-                pSSMLBreak->unlink();
-                delete pSSMLBreak;
+                CXMLNode::remove(pSSMLBreak);
             }
         }
 
@@ -243,7 +246,7 @@ namespace cst
             CXMLElement *pSSMLBreak = findProsodyBoundaryElemenet(pSSMLWord);
             if (pSSMLBreak == 0)
             {
-                pSSMLBreak = new CXMLElement(L"break");
+                pSSMLBreak = createElement(L"break");
                 pSSMLWord->insertAfter(pSSMLBreak);
                 //pSSMLBreak->insertBefore(pSSMLWord);
             }
@@ -271,7 +274,7 @@ namespace cst
                 break;
             }
 
-            pSSMLBreak->setAttribute(L"strength", pwstrBoundaryType);
+            pSSMLBreak->setAttribute(XML_NAME_STRENGTH, pwstrBoundaryType);
         }
 
 
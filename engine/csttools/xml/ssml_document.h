@@ -39,6 +39,10 @@
 ///   Author:   Yongxin Wang (fefe.wyx@gmail.com)
 ///   Data:     2007/06/13
 ///   Changed:  Added getBoundaryType to take a "break" element as parameter
+/// - Version:  0.5.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Allocated the document nodes in arena by default
 ///
 
 
@@ -66,8 +70,15 @@ namespace cst
         class CSSMLDocument : public CXMLDocument
         {
         public:
-            /// Constructor
-            CSSMLDocument() {}
+            ///
+            /// @brief  Constructor
+            ///
+            /// The SSML document is built and discarded for each synthesis request,
+            /// its nodes are allocated in the document arena by default.
+            ///
+            /// @param  [in] eAllocMode The allocation mode of the document nodes
+            ///
+            CSSMLDocument(EAllocMode eAllocMode=ALLOC_ARENA) : CXMLDocument(eAllocMode) {}
 
             /// Destructor
             virtual ~CSSMLDocument() {}
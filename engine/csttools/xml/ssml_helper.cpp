@@ -27,6 +27,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/05/28
 ///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Used local buffers for composing and parsing strings to be thread safe
 ///
 
 
@@ -42,7 +46,7 @@ namespace cst
         int CSSMLHelper::composeString(std::wstring &wstrResult, const wchar_t *format, ...)
         {
             static const int SBUF_SIZE = 260;
-            static wchar_t sBuf[SBUF_SIZE];
+            wchar_t sBuf[SBUF_SIZE];
 
 #pragma warning( push )
 #pragma warning( disable : 4996 )
@@ -74,7 +78,7 @@ namespace cst
         float CSSMLHelper::parseTime(const std::wstring  &wstrTime)
         {
             static const int SBUF_SIZE = 64;
-            static wchar_t s_buf[SBUF_SIZE];
+            wchar_t s_buf[SBUF_SIZE];
             wchar_t *pBuf = s_buf;
             float flTime = 0;
 
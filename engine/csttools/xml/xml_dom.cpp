@@ -58,12 +58,17 @@ must not be misrepresented as being the original software.
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2010/11/10
 ///   Change:   Added forward class CNodeStack to prevernt include <stack> in head file
+/// - Version:  0.4.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Change:   Added arena allocation mode, interned element and attribute names, and inline attributes
 ///
 
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <stack>
+#include <new>
 #include "xml_dom.h"
 #include "cmn/cmn_textfile.h"
 
@@ -71,6 +76,72 @@ namespace cst
 {
     namespace xml
     {
+        //////////////////////////////////////////////////////////////////////////
+        //
+        //  CXMLArena: the arena for the nodes of a document
+        //
+        //////////////////////////////////////////////////////////////////////////
+
+        ///
+        /// @brief  The arena which allocates memory from large blocks, and releases all blocks in one shot
+        ///
+        class CXMLArena
+        {
+        public:
+            /// Constructor
+            CXMLArena() : m_pBlock(NULL), m_nUsed(0), m_nSize(0) {}
+
+            /// Destructor
+            ~CXMLArena() {release();}
+
+            /// Allocate memory of the given size, aligned for any node or attribute
+            void *allocate(size_t nSize)
+            {
+                nSize = (nSize + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+                if (m_nUsed + nSize > m_nSize)
+                {
+                    // new block, large objects get a block of their own
+                    size_t nBlockSize = (nSize > BLOCK_SIZE / 4) ? nSize : BLOCK_SIZE;
+                    SBlock *pBlock = (SBlock*) ::operator new(HEADER_SIZE + nBlockSize);
+                    pBlock->pPrev = m_pBlock;
+                    m_pBlock = pBlock;
+                    m_nUsed  = 0;
+                    m_nSize  = nBlockSize;
+                }
+                void *pData = (char*)m_pBlock + HEADER_SIZE + m_nUsed;
+                m_nUsed += nSize;
+                return pData;
+            }
+
+            /// Release all the memory blocks
+            void release()
+            {
+                while (m_pBlock != NULL)
+                {
+                    SBlock *pPrev = m_pBlock->pPrev;
+                    ::operator delete(m_pBlock);
+                    m_pBlock = pPrev;
+                }
+                m_nUsed = m_nSize = 0;
+            }
+
+        protected:
+            /// Header of the memory block
+            struct SBlock
+            {
+                SBlock *pPrev;  ///< previous allocated block
+            };
+
+            static const size_t ALIGNMENT   = 16;
+            static const size_t HEADER_SIZE = (sizeof(SBlock) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+            static const size_t BLOCK_SIZE  = 32768 - HEADER_SIZE;
+
+            SBlock *m_pBlock;   ///< The current (last allocated) block
+            size_t  m_nUsed;    ///< Used size of the current block
+            size_t  m_nSize;    ///< Total size of the current block
+        };
+
+
         //////////////////////////////////////////////////////////////////////////
         //
         //  CXMLDOMHandler: XML document and error handling
@@ -99,7 +170,7 @@ namespace cst
         {
             // m_pDocument must NOT be NULL
             // It is user's responsibility to check the validation
-            m_pDocument->clearChildren();
+            m_pDocument->clear();
             m_bHaveError = false;
             // clear stack
             while (m_pNodeStack->size()>0)
@@ -119,7 +190,7 @@ namespace cst
 
         bool CXMLDOMHandler::startElement(const wchar_t *pName, const wchar_t **pAttributes, size_t nAttrib)
         {
-            CXMLElement* pElement = new CXMLElement(pName);
+            CXMLElement* pElement = m_pDocument->createElement(pName);
             for (size_t i=0; i<nAttrib; i++)
             {
                 pElement->setAttribute(pAttributes[2*i], pAttributes[2*i+1]);
@@ -139,7 +210,7 @@ namespace cst
         {
             std::wstring strText = pChars;
             CXMLText::decodeEscapes(strText);
-            CXMLText* pTextObj = new CXMLText(strText);
+            CXMLText* pTextObj = m_pDocument->createText(strText);
             m_pNodeStack->top()->linkLastChild(pTextObj);
             return true;
         }
@@ -177,6 +248,25 @@ namespace cst
         //
         //////////////////////////////////////////////////////////////////////////
 
+        void CXMLNode::assignValue(const wchar_t *pValue, const std::wstring &strValue)
+        {
+            m_nNameId = (m_eNodeType == XML_ELEMENT) ? CXMLNameTable::find(pValue) : XML_NAME_NONE;
+            if (m_nNameId != XML_NAME_NONE)
+                m_strValue.clear();
+            else if (pValue == strValue.c_str())
+                m_strValue = strValue;
+            else
+                m_strValue = pValue;
+        }
+
+        void CXMLNode::destroy(CXMLNode *pNode)
+        {
+            if (pNode->m_pArena != NULL)
+                pNode->~CXMLNode();     // memory is released with the arena
+            else
+                delete pNode;
+        }
+
         void CXMLNode::clearChildren()
         {
             CXMLNode *node=m_pFstChild, *temp=NULL;
@@ -184,7 +274,7 @@ namespace cst
             {
                 temp = node;
                 node = node->m_pNext;
-                delete temp;
+                destroy(temp);
             }
             m_pFstChild = NULL;
             m_pLstChild = NULL;
@@ -221,7 +311,7 @@ namespace cst
         {
             for (CXMLNode *pNode=m_pFstChild; pNode; pNode=pNode->m_pNext)
             {
-                if (pNode->m_strValue == strValue)
+                if (pNode->value() == strValue)
                     return pNode;
             }
             return NULL;
@@ -231,7 +321,7 @@ namespace cst
         {
             for (CXMLNode *pNode=m_pFstChild; pNode; pNode=pNode->m_pNext)
             {
-                if (pNode->m_eNodeType == eNodeType && pNode->m_strValue == strValue)
+                if (pNode->m_eNodeType == eNodeType && pNode->value() == strValue)
                     return pNode;
             }
             return NULL;
@@ -251,7 +341,7 @@ namespace cst
         {
             for (CXMLNode *pNode=m_pLstChild; pNode; pNode=pNode->m_pPrev)
             {
-                if (pNode->m_strValue == strValue)
+                if (pNode->value() == strValue)
                     return pNode;
             }
             return NULL;
@@ -261,7 +351,7 @@ namespace cst
         {
             for (CXMLNode *pNode=m_pNext; pNode; pNode=pNode->m_pNext)
             {
-                if (pNode->m_strValue == strValue)
+                if (pNode->value() == strValue)
                     return pNode;
             }
             return NULL;
@@ -271,7 +361,7 @@ namespace cst
         {
             for (CXMLNode *pNode=m_pNext; pNode; pNode=pNode->m_pNext)
             {
-                if (pNode->m_eNodeType == eNodeType && pNode->m_strValue == strValue)
+                if (pNode->m_eNodeType == eNodeType && pNode->value() == strValue)
                     return pNode;
             }
             return NULL;
@@ -306,7 +396,7 @@ namespace cst
             //1.firstchild exits
             //2.the current node is not a say-as node(we won't enter into the sub tree of a say-as node)
             //3.user specified not to ignore the subtree
-            else if ( m_pFstChild != NULL && !((m_eNodeType ==CXMLNode::XML_ELEMENT) &&(m_strValue ==L"say-as"))&&!bIgnoreSubTree)
+            else if ( m_pFstChild != NULL && m_nNameId != XML_NAME_SAY_AS && !bIgnoreSubTree)
             {
                 pNode = m_pFstChild;
             }
@@ -333,11 +423,11 @@ namespace cst
             }
             while ( pNode != NULL && pNode != pRootNode)
             {
-                if ( pNode->m_eNodeType == eNodeType && (strValue.empty()?true:(pNode->m_strValue == strValue)))
+                if ( pNode->m_eNodeType == eNodeType && (strValue.empty()?true:(pNode->value() == strValue)))
                 {
                     return (CXMLNode*)pNode;
                 }
-                if (!(pNode->m_eNodeType == CXMLNode::XML_ELEMENT && pNode->m_strValue ==L"say-as") &&pNode->m_pFstChild != NULL)
+                if (pNode->m_nNameId != XML_NAME_SAY_AS && pNode->m_pFstChild != NULL)
                 {
                     pNode = pNode->m_pFstChild;
                     continue;
@@ -452,7 +542,7 @@ namespace cst
         {
             for (CXMLNode* pNode=m_pPrev; pNode; pNode=pNode->m_pPrev)
             {
-                if (pNode->m_strValue == strValue)
+                if (pNode->value() == strValue)
                     return pNode;
             }
             return NULL;
@@ -462,7 +552,7 @@ namespace cst
         {
             for (CXMLNode *pNode=m_pPrev; pNode; pNode=pNode->m_pPrev)
             {
-                if (pNode->m_eNodeType == eNodeType && pNode->m_strValue == strValue)
+                if (pNode->m_eNodeType == eNodeType && pNode->value() == strValue)
                     return pNode;
             }
             return NULL;
@@ -496,7 +586,17 @@ namespace cst
         void CXMLNode::remove(CXMLNode *pNode)
         {
             pNode->unlink();
-            delete pNode;
+            destroy(pNode);
+        }
+
+        CXMLDocument* CXMLNode::ownerDocument() const
+        {
+            const CXMLNode *pNode = this;
+            while (pNode->m_pParent != NULL)
+            {
+                pNode = pNode->m_pParent;
+            }
+            return (pNode->m_eNodeType == XML_DOCUMENT) ? (CXMLDocument*)pNode : NULL;
         }
 
         void CXMLNode::insertBefore(CXMLNode *pOrphanNode)
@@ -717,8 +817,17 @@ namespace cst
         {
             m_pNext    = NULL;
             m_pPrev    = NULL;
-            m_strName  = strName;
             m_strValue = strValue;
+            setName(strName);
+        }
+
+        void CXMLAttribute::setName(const std::wstring &strName)
+        {
+            m_nNameId = CXMLNameTable::find(strName.c_str());
+            if (m_nNameId != XML_NAME_NONE)
+                m_strName.clear();
+            else
+                m_strName = strName;
         }
 
         bool CXMLAttribute::print(std::wostream &outStream, int nDepth) const
@@ -726,11 +835,11 @@ namespace cst
             // attribute
             if (m_strValue.find(L'\"') == m_strValue.npos)
             {
-                outStream << m_strName << L"=\"" << m_strValue << L"\"";
+                outStream << name() << L"=\"" << m_strValue << L"\"";
             }
             else
             {
-                outStream << m_strName << L"=\'" << m_strValue << L"\'";
+                outStream << name() << L"=\'" << m_strValue << L"\'";
             }
             return true;
         }
@@ -747,11 +856,28 @@ namespace cst
             return true;
         }
 
-        CXMLAttribute* CXMLAttribList::find(const std::wstring &strName) const
+        CXMLAttribute* CXMLAttribList::find(const wchar_t *pName) const
+        {
+            int nNameId = CXMLNameTable::find(pName);
+            if (nNameId != XML_NAME_NONE)
+            {
+                return find((EXMLName)nNameId);
+            }
+            for (CXMLAttribute *pNode=m_sentinel.m_pNext; pNode!=&m_sentinel; pNode=pNode->m_pNext)
+            {
+                if (pNode->m_nNameId==XML_NAME_NONE && pNode->m_strName==pName)
+                {
+                    return pNode;
+                }
+            }
+            return NULL;
+        }
+
+        CXMLAttribute* CXMLAttribList::find(EXMLName eName) const
         {
             for (CXMLAttribute *pNode=m_sentinel.m_pNext; pNode!=&m_sentinel; pNode=pNode->m_pNext)
             {
-                if (pNode->m_strName==strName)
+                if (pNode->m_nNameId==eName)
                 {
                     return pNode;
                 }
@@ -759,9 +885,55 @@ namespace cst
             return NULL;
         }
 
+        CXMLAttribute* CXMLAttribList::create(int nNameId, const wchar_t *pName, const std::wstring &strValue, CXMLArena *pArena)
+        {
+            CXMLAttribute *pAttrib = NULL;
+            for (int i=0; i<INLINE_ATTRIBUTES && pAttrib==NULL; i++)
+            {
+                if ((m_nInlineUsed & (1u << i)) == 0)
+                {
+                    // free inline attribute
+                    pAttrib = &m_inline[i];
+                    m_nInlineUsed |= (1u << i);
+                }
+            }
+            if (pAttrib == NULL)
+            {
+                if (pArena != NULL)
+                    pAttrib = new (pArena->allocate(sizeof(CXMLAttribute))) CXMLAttribute();
+                else
+                    pAttrib = new CXMLAttribute();
+            }
+            pAttrib->m_nNameId = nNameId;
+            if (nNameId == XML_NAME_NONE)
+                pAttrib->m_strName = pName;
+            pAttrib->m_strValue = strValue;
+            return pAttrib;
+        }
+
+        void CXMLAttribList::destroy(CXMLAttribute *pAttrib, CXMLArena *pArena)
+        {
+            if (pAttrib >= &m_inline[0] && pAttrib < &m_inline[INLINE_ATTRIBUTES])
+            {
+                // inline attribute, mark as free
+                m_nInlineUsed &= ~(1u << (pAttrib - &m_inline[0]));
+                pAttrib->m_nNameId = XML_NAME_NONE;
+                pAttrib->m_strName.clear();
+                pAttrib->m_strValue.clear();
+            }
+            else if (pArena != NULL)
+            {
+                pAttrib->~CXMLAttribute();  // memory is released with the arena
+            }
+            else
+            {
+                delete pAttrib;
+            }
+        }
+
         bool CXMLAttribList::add(CXMLAttribute* pAttrib)
         {
-            if (find(pAttrib->m_strName.c_str())!=NULL)    // Should not be added multiply
+            if ((pAttrib->m_nNameId!=XML_NAME_NONE ? find((EXMLName)pAttrib->m_nNameId) : find(pAttrib->m_strName.c_str()))!=NULL)    // Should not be added multiply
                 return false;
             pAttrib->m_pNext = &m_sentinel;
             pAttrib->m_pPrev = m_sentinel.m_pPrev;
@@ -802,7 +974,7 @@ namespace cst
             while ((pNode = m_attribList.first()) != NULL)
             {
                 m_attribList.remove(pNode);
-                delete pNode;
+                m_attribList.destroy(pNode, m_pArena);
             }
         }
 
@@ -811,7 +983,7 @@ namespace cst
             for (int i=0; i<nDepth; i++)
                 outStream << L"    ";
             // element start
-            outStream << L"<" << m_strValue;
+            outStream << L"<" << value();
             // attributes
             m_attribList.print(outStream, nDepth);
             // There are 3 different formatting approaches:
@@ -826,7 +998,7 @@ namespace cst
             {
                 outStream << L">";
                 m_pFstChild->print(outStream, nDepth+1);
-                outStream << L"</" << m_strValue << L">";
+                outStream << L"</" << value() << L">";
             }
             else
             {
@@ -840,14 +1012,24 @@ namespace cst
                 outStream << L"\r\n";
                 for (int i=0; i<nDepth; i++)
                     outStream << L"    ";
-                outStream << L"</" << m_strValue << L">";
+                outStream << L"</" << value() << L">";
             }
             return true;
         }
 
-        bool CXMLElement::setAttribute(const std::wstring &strName, const std::wstring &strValue)
+        bool CXMLElement::setAttribute(const wchar_t *pName, const std::wstring &strValue)
         {
-            CXMLAttribute* node = m_attribList.find(strName);
+            return setAttribute(CXMLNameTable::find(pName), pName, strValue);
+        }
+
+        bool CXMLElement::setAttribute(EXMLName eName, const std::wstring &strValue)
+        {
+            return setAttribute(eName, CXMLNameTable::name(eName).c_str(), strValue);
+        }
+
+        bool CXMLElement::setAttribute(int nNameId, const wchar_t *pName, const std::wstring &strValue)
+        {
+            CXMLAttribute* node = (nNameId!=XML_NAME_NONE) ? m_attribList.find((EXMLName)nNameId) : m_attribList.find(pName);
             if (node!=NULL)
             {
                 // attribute exist, update
@@ -855,7 +1037,7 @@ namespace cst
                 return true;
             }
             // create new attribute
-            CXMLAttribute* attrib = new CXMLAttribute(strName, strValue);
+            CXMLAttribute* attrib = m_attribList.create(nNameId, pName, strValue, m_pArena);
             if (attrib!=NULL)
             {
                 m_attribList.add(attrib);
@@ -869,14 +1051,23 @@ namespace cst
             if (node!=NULL)
             {
                 m_attribList.remove(node);
-                delete node;
+                m_attribList.destroy(node, m_pArena);
             }
         }
 
-        const std::wstring& CXMLElement::getAttribute(const std::wstring &strName) const
+        const std::wstring& CXMLElement::getAttribute(const wchar_t *pName) const
         {
             const static std::wstring wstrEmpty; // empty return value
-            CXMLAttribute* node = m_attribList.find(strName);
+            CXMLAttribute* node = m_attribList.find(pName);
+            if (node!=NULL)
+                return node->value();
+            return wstrEmpty;
+        }
+
+        const std::wstring& CXMLElement::getAttribute(EXMLName eName) const
+        {
+            const static std::wstring wstrEmpty; // empty return value
+            CXMLAttribute* node = m_attribList.find(eName);
             if (node!=NULL)
                 return node->value();
             return wstrEmpty;
@@ -889,6 +1080,44 @@ namespace cst
         //
         //////////////////////////////////////////////////////////////////////////
 
+        CXMLDocument::CXMLDocument(EAllocMode eAllocMode) : CXMLNode(XML_DOCUMENT, L""), m_bHaveError(false)
+        {
+            m_pNodeArena = (eAllocMode == ALLOC_ARENA) ? new CXMLArena() : NULL;
+        }
+
+        CXMLDocument::~CXMLDocument()
+        {
+            // the nodes must be destroyed before the arena
+            clearChildren();
+            delete m_pNodeArena;
+            m_pNodeArena = NULL;
+        }
+
+        CXMLElement *CXMLDocument::createElement(const wchar_t *pName)
+        {
+            if (m_pNodeArena == NULL)
+                return new CXMLElement(pName);
+            CXMLElement *pElement = new (m_pNodeArena->allocate(sizeof(CXMLElement))) CXMLElement(pName);
+            pElement->m_pArena = m_pNodeArena;
+            return pElement;
+        }
+
+        CXMLText *CXMLDocument::createText(const std::wstring &strText)
+        {
+            if (m_pNodeArena == NULL)
+                return new CXMLText(strText);
+            CXMLText *pText = new (m_pNodeArena->allocate(sizeof(CXMLText))) CXMLText(strText);
+            pText->m_pArena = m_pNodeArena;
+            return pText;
+        }
+
+        void CXMLDocument::clear()
+        {
+            clearChildren();
+            if (m_pNodeArena != NULL)
+                m_pNodeArena->release();
+        }
+
         bool CXMLDocument::parse(const wchar_t *pDataSource, bool bCreateNewBuf, EXMLEncoding eDataEncoding)
         {
             if (eDataEncoding != XML_ENCODING_UTF16)
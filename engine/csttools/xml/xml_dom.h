@@ -58,6 +58,10 @@ must not be misrepresented as being the original software.
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2010/11/10
 ///   Change:   Added forward class CNodeStack to prevernt include <stack> in head file
+/// - Version:  0.4.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Change:   Added arena allocation mode, interned element and attribute names, and inline attributes
 ///
 
 
@@ -66,12 +70,17 @@ must not be misrepresented as being the original software.
 
 #include <string>
 #include "xml_sax.h"
+#include "xml_nametable.h"
 #include "utils/utl_string.h"
 
 namespace cst
 {
     namespace xml
     {
+        // forward class reference
+        class CXMLArena;
+        class CXMLDocument;
+
         ///
         /// @brief  A base class for XML DOM specification
         ///
@@ -157,7 +166,12 @@ namespace cst
             ///
             /// @brief  Get the attribute name
             ///
-            const std::wstring &name() const {return m_strName;}
+            const std::wstring &name() const {return (m_nNameId != XML_NAME_NONE) ? CXMLNameTable::name(m_nNameId) : m_strName;}
+
+            ///
+            /// @brief  Get the identifier of the attribute name in CXMLNameTable, XML_NAME_NONE if not in the table
+            ///
+            int nameId() const {return m_nNameId;}
 
             ///
             /// @brief  Get the attribute value
@@ -167,7 +181,7 @@ namespace cst
             ///
             /// @brief  Set the attribute name
             ///
-            void setName(const std::wstring &strName) {m_strName=strName;}
+            void setName(const std::wstring &strName);
 
             ///
             /// @brief  Set the attribute value
@@ -184,7 +198,7 @@ namespace cst
             ///
             /// @return Pointer to next attribute, NULL for end of list
             ///
-            CXMLAttribute* next() const {if (m_pNext->m_strName.length()==0) return NULL; return m_pNext;}
+            CXMLAttribute* next() const {if (m_pNext->name().length()==0) return NULL; return m_pNext;}
 
             ///
             /// @brief  Get previous attribute in attribute list, NULL at beginning
@@ -194,7 +208,7 @@ namespace cst
             ///
             /// @return Pointer to previous attribute, NULL for beginning of list
             ///
-            inline CXMLAttribute* prev() const {if (m_pPrev->m_strName.length()==0) return NULL; return m_pPrev;}
+            inline CXMLAttribute* prev() const {if (m_pPrev->name().length()==0) return NULL; return m_pPrev;}
 
             ///
             /// @brief  Print the attribute
@@ -202,8 +216,15 @@ namespace cst
             virtual bool print(std::wostream &outStream, int nDepth) const;
 
         protected:
-            std::wstring    m_strName;  ///< Attribute name
+            ///
+            /// @brief  Constructor of an unnamed attribute, for the list sentinel and the inline attributes
+            ///
+            CXMLAttribute() : m_nNameId(XML_NAME_NONE), m_pNext(NULL), m_pPrev(NULL) {}
+
+        protected:
+            std::wstring    m_strName;  ///< Attribute name, empty if the name is interned
             std::wstring    m_strValue; ///< Attribute value
+            int             m_nNameId;  ///< Interned attribute name identifier
             CXMLAttribute  *m_pNext;    ///< Next attribute
             CXMLAttribute  *m_pPrev;    ///< Previous attribute
         };
@@ -214,6 +235,9 @@ namespace cst
         ///
         /// The list is implemented in circular list for easier boundary checking
         ///
+        /// The first INLINE_ATTRIBUTES attributes created by the list are stored inside the list,
+        /// so that most elements need no separate allocation for their attributes.
+        ///
         class CXMLAttribList : public CXMLBase
         {
         public:
@@ -222,7 +246,7 @@ namespace cst
             ///
             /// Initialize the Sentinel element as the base element in the circular list
             ///
-            CXMLAttribList() : m_sentinel(L"",L"sentinel") {m_sentinel.m_pNext=&m_sentinel; m_sentinel.m_pPrev=&m_sentinel;}
+            CXMLAttribList() : m_nInlineUsed(0) {m_sentinel.m_pNext=&m_sentinel; m_sentinel.m_pPrev=&m_sentinel;}
 
             ///
             /// @brief  Destructor
@@ -236,7 +260,37 @@ namespace cst
             ///
             /// @return Whether attribute is found. NULL if not found.
             ///
-            CXMLAttribute* find(const std::wstring &strName) const;
+            CXMLAttribute* find(const std::wstring &strName) const {return find(strName.c_str());}
+            CXMLAttribute* find(const wchar_t *pName) const;
+
+            ///
+            /// @brief  Find a specific attribute in the list with the interned attribute name
+            ///
+            /// @param  [in] eName  Identifier of the attribute name in CXMLNameTable
+            ///
+            /// @return Whether attribute is found. NULL if not found.
+            ///
+            CXMLAttribute* find(EXMLName eName) const;
+
+            ///
+            /// @brief  Create a new attribute (not added to the list), in the inline storage if available
+            ///
+            /// @param  [in] nNameId    Identifier of the attribute name in CXMLNameTable
+            /// @param  [in] pName      Name of the attribute, used only if nNameId is XML_NAME_NONE
+            /// @param  [in] strValue   Value of the attribute
+            /// @param  [in] pArena     The arena for the attributes not stored inline, NULL for heap
+            ///
+            /// @return The created attribute, which must be released by destroy() with the same arena
+            ///
+            CXMLAttribute* create(int nNameId, const wchar_t *pName, const std::wstring &strValue, CXMLArena *pArena);
+
+            ///
+            /// @brief  Destroy an attribute created by create(), the attribute must have been removed from the list
+            ///
+            /// @param  [in] pAttrib    The attribute to be destroyed
+            /// @param  [in] pArena     The arena with which the attribute was created
+            ///
+            void destroy(CXMLAttribute *pAttrib, CXMLArena *pArena);
 
             ///
             /// @brief  Add a new attribute to the list
@@ -272,8 +326,14 @@ namespace cst
             ///
             virtual bool print(std::wostream &outStream, int nDepth) const;
 
+        public:
+            /// Number of attributes stored inside the list
+            static const int INLINE_ATTRIBUTES = 3;
+
         protected:
-            CXMLAttribute m_sentinel;  ///< The list sentinel
+            CXMLAttribute m_sentinel;   ///< The list sentinel
+            CXMLAttribute m_inline[INLINE_ATTRIBUTES];  ///< The inline attribute storage
+            unsigned int  m_nInlineUsed;    ///< Bit mask of the inline attributes in use
         };
 
 
@@ -289,6 +349,7 @@ namespace cst
         ///
         class CXMLNode : public CXMLBase
         {
+            friend class CXMLDocument;
         public:
             /// The types of supported XML nodes. (All the unsupported types are picked by UNKNOWN)
             enum ENodeType
@@ -308,9 +369,22 @@ namespace cst
             /// @param  [in] eType      The node type
             /// @param  [in] strValue   Node value, has different meaning in different type of node
             ///
-            CXMLNode(ENodeType eType, const std::wstring &strValue) : m_eNodeType(eType), m_strValue(strValue)
+            CXMLNode(ENodeType eType, const std::wstring &strValue) : m_eNodeType(eType), m_nNameId(XML_NAME_NONE), m_pArena(NULL)
             {
                 m_pParent = m_pFstChild = m_pLstChild = m_pNext = m_pPrev = NULL;
+                assignValue(strValue.c_str(), strValue);
+            }
+
+            ///
+            /// @brief  Constructor
+            ///
+            /// @param  [in] eType      The node type
+            /// @param  [in] pValue     Node value, has different meaning in different type of node
+            ///
+            CXMLNode(ENodeType eType, const wchar_t *pValue) : m_eNodeType(eType), m_nNameId(XML_NAME_NONE), m_pArena(NULL)
+            {
+                m_pParent = m_pFstChild = m_pLstChild = m_pNext = m_pPrev = NULL;
+                assignValue(pValue, std::wstring());
             }
 
             ///
@@ -318,9 +392,24 @@ namespace cst
             ///
             virtual ~CXMLNode() {clearChildren();}
 
+            ///
+            /// @brief  Set the node value, the names of elements are interned in CXMLNameTable
+            ///
+            /// @param  [in] pValue     The node value
+            /// @param  [in] strValue   The node value as string, used (to keep the length) only if pValue is strValue.c_str()
+            ///
+            void assignValue(const wchar_t *pValue, const std::wstring &strValue);
+
+            ///
+            /// @brief  Destroy the node, which must have been unlinked, with the allocator which created it
+            ///
+            static void destroy(CXMLNode *pNode);
+
         protected:
-            std::wstring  m_strValue;   ///< The value of the XML node
+            std::wstring  m_strValue;   ///< The value of the XML node, empty if the element name is interned
             ENodeType     m_eNodeType;  ///< Type of this node
+            int           m_nNameId;    ///< Interned element name identifier
+            CXMLArena    *m_pArena;     ///< The arena in which the node is allocated, NULL for heap
             CXMLNode     *m_pParent;    ///< Parent node
             CXMLNode     *m_pFstChild;  ///< First child
             CXMLNode     *m_pLstChild;  ///< Last child
@@ -336,12 +425,22 @@ namespace cst
             ///
             /// @brief  Get node value
             ///
-            const std::wstring &value() const {return m_strValue;}
+            const std::wstring &value() const {return (m_nNameId != XML_NAME_NONE) ? CXMLNameTable::name(m_nNameId) : m_strValue;}
+
+            ///
+            /// @brief  Get the identifier of the element name in CXMLNameTable
+            ///
+            /// Comparing the identifier with an EXMLName (e.g. XML_NAME_W) is equivalent to,
+            /// but faster than, checking the node is an element and comparing its value with the name.
+            ///
+            /// @return The name identifier, XML_NAME_NONE for the other node types or for names not in the table
+            ///
+            int nameId() const {return m_nNameId;}
 
             ///
             /// @brief  Set node value
             ///
-            virtual void setValue(const std::wstring &strValue) {m_strValue = strValue;}
+            virtual void setValue(const std::wstring &strValue) {assignValue(strValue.c_str(), strValue);}
 
         public:
             //////////////////////////////////////////////////////////////////////////
@@ -364,8 +463,16 @@ namespace cst
             ///
             /// This node and all children will be unlinked from the node tree, and the memory would be released.
             ///
+            /// @note   Nodes created by CXMLDocument::createElement() or CXMLDocument::createText()
+            ///         must be released by this function, not by operator delete
+            ///
             static void remove(CXMLNode *pNode);
 
+            ///
+            /// @brief  Get the document containing this node, NULL if the node is not in a document
+            ///
+            CXMLDocument* ownerDocument() const;
+
             ///
             /// @brief  Insert this node after the node pNode. This node will be the next sibling of pNode.
             ///
@@ -482,6 +589,7 @@ namespace cst
             /// @param  [in] strName    The element name (node value)
             ///
             CXMLElement(const std::wstring &strName) : CXMLNode(XML_ELEMENT, strName) {}
+            CXMLElement(const wchar_t *pName) : CXMLNode(XML_ELEMENT, pName) {}
 
             ///
             /// @brief  Destructor
@@ -497,7 +605,19 @@ namespace cst
             ///
             /// @return Whether the operations is successful
             ///
-            bool setAttribute(const std::wstring &strName, const std::wstring &strValue);
+            bool setAttribute(const std::wstring &strName, const std::wstring &strValue) {return setAttribute(strName.c_str(), strValue);}
+            bool setAttribute(const wchar_t *pName, const std::wstring &strValue);
+
+            ///
+            /// @brief  Set the attribute of the interned name to a given value.
+            ///         The attribute will be created if it does not exist, or updated if it does.
+            ///
+            /// @param  [in] eName      Identifier of the attribute name in CXMLNameTable
+            /// @param  [in] strValue   Attribute value
+            ///
+            /// @return Whether the operations is successful
+            ///
+            bool setAttribute(EXMLName eName, const std::wstring &strValue);
 
             ///
             /// @brief  Remove the attribute with the specified name. Do nothing if it does not exist
@@ -513,7 +633,17 @@ namespace cst
             ///
             /// @return The attribute value. Empty string ("") is return if the given attribute name not found.
             ///
-            const std::wstring &getAttribute(const std::wstring &strName) const;
+            const std::wstring &getAttribute(const std::wstring &strName) const {return getAttribute(strName.c_str());}
+            const std::wstring &getAttribute(const wchar_t *pName) const;
+
+            ///
+            /// @brief  Get the attribute value given the interned name, or "" if not found
+            ///
+            /// @param  [in] eName  Identifier of the attribute name in CXMLNameTable
+            ///
+            /// @return The attribute value. Empty string ("") is return if the given attribute name not found.
+            ///
+            const std::wstring &getAttribute(EXMLName eName) const;
 
         public:
             ///
@@ -531,6 +661,12 @@ namespace cst
             ///
             virtual bool print(std::wostream &outStream, int nDepth) const;
 
+        protected:
+            ///
+            /// @brief  Set the attribute given both the name identifier and the name
+            ///
+            bool setAttribute(int nNameId, const wchar_t *pName, const std::wstring &strValue);
+
         protected:
             CXMLAttribList m_attribList; ///< The attribute list
         };
@@ -707,9 +843,6 @@ namespace cst
         };
 
 
-        // forward class reference
-        class CXMLDocument;
-
         ///
         ///  @brief  Class for XML document and error handling
         ///
@@ -826,18 +959,70 @@ namespace cst
         ///                 XMLText         "Do bills"
         /// @endverbatim
         ///
+        /// In the arena allocation mode, the element and text nodes created by the parser or by
+        /// createElement() and createText() are allocated in an arena owned by the document.
+        /// The arena is released in one shot when the document is cleared or destroyed,
+        /// instead of releasing the nodes one by one.
+        ///
+        /// @note   The nodes allocated in the arena of a document must not be moved to another document,
+        ///         and must be released by CXMLNode::remove(), not by operator delete.\n
+        ///         Like the other operations on the document, the arena is not thread safe.
+        ///
         class CXMLDocument : public CXMLNode
         {
+        public:
+            /// The allocation modes of the document nodes
+            enum EAllocMode
+            {
+                ALLOC_HEAP,     ///< each node is allocated separately by operator new
+                ALLOC_ARENA     ///< the nodes are allocated in the arena of the document
+            };
+
         public:
             ///
             /// @brief  Constructor
             ///
-            CXMLDocument() : CXMLNode(XML_DOCUMENT, L""), m_bHaveError(false) {}
+            /// @param  [in] eAllocMode The allocation mode of the document nodes
+            ///
+            CXMLDocument(EAllocMode eAllocMode=ALLOC_HEAP);
 
             ///
             /// @brief  Destructor
             ///
-            virtual ~CXMLDocument() {}
+            virtual ~CXMLDocument();
+
+        public:
+            ///
+            /// @brief  Get the allocation mode of the document nodes
+            ///
+            EAllocMode allocMode() const {return (m_pNodeArena != NULL) ? ALLOC_ARENA : ALLOC_HEAP;}
+
+            ///
+            /// @brief  Create an element node with the allocator of the document
+            ///
+            /// The node is not linked to the document tree.
+            ///
+            /// @param  [in] pName      The element name
+            ///
+            /// @return The created element
+            ///
+            CXMLElement *createElement(const wchar_t *pName);
+
+            ///
+            /// @brief  Create a text node with the allocator of the document
+            ///
+            /// The node is not linked to the document tree.
+            ///
+            /// @param  [in] strText    The text content, with "&amp; &gt; &lt;" already decoded
+            ///
+            /// @return The created text node
+            ///
+            CXMLText *createText(const std::wstring &strText);
+
+            ///
+            /// @brief  Delete all the nodes of the document, and release the arena in one shot
+            ///
+            void clear();
 
         public:
             ///
@@ -900,6 +1085,8 @@ namespace cst
         protected:
             /// Whether there is an error occurred when parsing document
             bool m_bHaveError;
+            /// The arena of the document nodes, NULL in heap allocation mode
+            CXMLArena *m_pNodeArena;
         };
 
     }
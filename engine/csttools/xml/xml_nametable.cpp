@@ -0,0 +1,109 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Implementation of the interned name table for XML element and attribute names.
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+///
+
+#include <cwchar>
+#include "xml_nametable.h"
+
+namespace cst
+{
+    namespace xml
+    {
+        // in the same order as EXMLName
+        const std::wstring CXMLNameTable::m_names[XML_NAME_COUNT] =
+        {
+            L"",
+            L"alias",
+            L"alphabet",
+            L"amplitude",
+            L"audio",
+            L"break",
+            L"continuous",
+            L"contour",
+            L"detail",
+            L"dratio",
+            L"duration",
+            L"emphasis",
+            L"format",
+            L"gender",
+            L"id",
+            L"interpret-as",
+            L"level",
+            L"lexicon",
+            L"mark",
+            L"meta",
+            L"metadata",
+            L"name",
+            L"p",
+            L"ph",
+            L"phoneme",
+            L"pitch",
+            L"pos",
+            L"pratio",
+            L"prosody",
+            L"range",
+            L"rate",
+            L"read-as",
+            L"role",
+            L"s",
+            L"say-as",
+            L"speak",
+            L"strength",
+            L"sub",
+            L"syllable",
+            L"time",
+            L"uid",
+            L"unit",
+            L"version",
+            L"voice",
+            L"volume",
+            L"vratio",
+            L"w",
+            L"xml:lang",
+            L"xmlns",
+        };
+
+        int CXMLNameTable::find(const wchar_t *pName)
+        {
+            // binary search in the sorted names, the empty name is excluded
+            int nLow = XML_NAME_NONE + 1, nHigh = XML_NAME_COUNT - 1;
+            while (nLow <= nHigh)
+            {
+                int nMid = (nLow + nHigh) / 2;
+                int nCmp = std::wcscmp(pName, m_names[nMid].c_str());
+                if (nCmp == 0)
+                    return nMid;
+                else if (nCmp < 0)
+                    nHigh = nMid - 1;
+                else
+                    nLow = nMid + 1;
+            }
+            return XML_NAME_NONE;
+        }
+    }
+}
@@ -0,0 +1,136 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Definition of the interned name table for XML element and attribute names.
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+///
+
+#ifndef _CST_TOOLS_XML_NAMETABLE_H_
+#define _CST_TOOLS_XML_NAMETABLE_H_
+
+#include <string>
+
+namespace cst
+{
+    namespace xml
+    {
+        ///
+        /// @brief  The identifiers of the element and attribute names known to the engine
+        ///
+        /// The names are those of the SSML specification and of the SSML extensions used by the engine.
+        /// The identifiers are in the ascending order of the names (compared by wcscmp),
+        /// new names must be inserted at the right position, both here and in the name table.
+        ///
+        enum EXMLName
+        {
+            XML_NAME_NONE = 0,      ///< name not in the table
+            XML_NAME_ALIAS,
+            XML_NAME_ALPHABET,
+            XML_NAME_AMPLITUDE,
+            XML_NAME_AUDIO,
+            XML_NAME_BREAK,
+            XML_NAME_CONTINUOUS,
+            XML_NAME_CONTOUR,
+            XML_NAME_DETAIL,
+            XML_NAME_DRATIO,
+            XML_NAME_DURATION,
+            XML_NAME_EMPHASIS,
+            XML_NAME_FORMAT,
+            XML_NAME_GENDER,
+            XML_NAME_ID,
+            XML_NAME_INTERPRET_AS,
+            XML_NAME_LEVEL,
+            XML_NAME_LEXICON,
+            XML_NAME_MARK,
+            XML_NAME_META,
+            XML_NAME_METADATA,
+            XML_NAME_NAME,
+            XML_NAME_P,
+            XML_NAME_PH,
+            XML_NAME_PHONEME,
+            XML_NAME_PITCH,
+            XML_NAME_POS,
+            XML_NAME_PRATIO,
+            XML_NAME_PROSODY,
+            XML_NAME_RANGE,
+            XML_NAME_RATE,
+            XML_NAME_READ_AS,
+            XML_NAME_ROLE,
+            XML_NAME_S,
+            XML_NAME_SAY_AS,
+            XML_NAME_SPEAK,
+            XML_NAME_STRENGTH,
+            XML_NAME_SUB,
+            XML_NAME_SYLLABLE,
+            XML_NAME_TIME,
+            XML_NAME_UID,
+            XML_NAME_UNIT,
+            XML_NAME_VERSION,
+            XML_NAME_VOICE,
+            XML_NAME_VOLUME,
+            XML_NAME_VRATIO,
+            XML_NAME_W,
+            XML_NAME_XML_LANG,
+            XML_NAME_XMLNS,
+            XML_NAME_COUNT          ///< number of identifiers, used only for boundary check
+        };
+
+        ///
+        /// @brief  The interned name table for XML element and attribute names
+        ///
+        /// Each known name is stored once, and the elements and attributes holding a known name
+        /// refer to the shared string by its identifier. Names are then compared as integers.
+        ///
+        /// The table is constant, it can be shared by any number of documents and threads.
+        ///
+        class CXMLNameTable
+        {
+        public:
+            ///
+            /// @brief  Find the identifier of the name
+            ///
+            /// @param  [in] pName  The element or attribute name
+            ///
+            /// @return The name identifier, XML_NAME_NONE if the name is not in the table
+            ///
+            static int find(const wchar_t *pName);
+
+            ///
+            /// @brief  Get the name of the identifier
+            ///
+            /// @param  [in] nNameId    The name identifier, must be in range [0, XML_NAME_COUNT)
+            ///
+            /// @return The shared name string, empty string for XML_NAME_NONE
+            ///
+            static const std::wstring &name(int nNameId) {return m_names[nNameId];}
+
+        protected:
+            /// The shared name strings, indexed by name identifier
+            static const std::wstring m_names[XML_NAME_COUNT];
+        };
+    }
+}
+
+#endif//_CST_TOOLS_XML_NAMETABLE_H_
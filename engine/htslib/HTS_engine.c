@@ -60,19 +60,12 @@ HTS_ENGINE_C_START;
 /* hts_engine libraries */
 #include "HTS_hidden.h"
 
-/* HTS_Engine_initialize: initialize engine */
-void HTS_Engine_initialize(HTS_Engine * engine, int nstream)
+/* HTS_Engine_initialize_stream: initialize settings of each stream */
+static void HTS_Engine_initialize_stream(HTS_Engine * engine, int nstream)
 {
    int i;
 
-   /* default value for control parameter */
-   engine->global.stage = 0;
-   engine->global.use_log_gain = FALSE;
-   engine->global.sampling_rate = 16000;
-   engine->global.fperiod = 80;
-   engine->global.alpha = 0.42;
-   engine->global.beta = 0.0;
-   engine->global.audio_buff_size = 0;
+   /* MSD threshold */
    engine->global.msd_threshold = (double *) HTS_calloc(nstream, sizeof(double));
    for (i = 0; i < nstream; i++)
       engine->global.msd_threshold[i] = 0.5;
@@ -80,7 +73,6 @@ void HTS_Engine_initialize(HTS_Engine * engine, int nstream)
    /* interpolation weight */
    engine->global.parameter_iw = (double **) HTS_calloc(nstream, sizeof(double *));
    engine->global.gv_iw = (double **) HTS_calloc(nstream, sizeof(double *));
-   engine->global.duration_iw = NULL;
    for (i = 0; i < nstream; i++)
       engine->global.parameter_iw[i] = NULL;
    for (i = 0; i < nstream; i++)
@@ -90,11 +82,28 @@ void HTS_Engine_initialize(HTS_Engine * engine, int nstream)
    engine->global.gv_weight = (double *) HTS_calloc(nstream, sizeof(double));
    for (i = 0; i < nstream; i++)
       engine->global.gv_weight[i] = 1.0;
+}
+
+/* HTS_Engine_initialize: initialize engine */
+void HTS_Engine_initialize(HTS_Engine * engine, int nstream)
+{
+   /* default value for control parameter */
+   engine->global.stage = 0;
+   engine->global.use_log_gain = FALSE;
+   engine->global.sampling_rate = 16000;
+   engine->global.fperiod = 80;
+   engine->global.alpha = 0.42;
+   engine->global.beta = 0.0;
+   engine->global.audio_buff_size = 0;
+   engine->global.duration_iw = NULL;
+   HTS_Engine_initialize_stream(engine, nstream);
 
    /* stop flag */
    engine->global.stop = FALSE;
    /* volume */
    engine->global.volume = 1.0;
+   /* vocoder */
+   engine->global.vocoder_type = HTS_VOCODER_DOUBLE;
 
    /* initialize audio */
    HTS_Audio_initialize(&engine->audio, engine->global.sampling_rate, engine->global.audio_buff_size);
@@ -243,6 +252,57 @@ HTS_Boolean HTS_Engine_load_gv_from_fp(HTS_Engine * engine, HTS_File ** pdf_fp,
    return TRUE;
 }
 
+/* HTS_Engine_load_image_from_fn: map models of all streams from compiled voice image, instead of loading files of each stream */
+HTS_Boolean HTS_Engine_load_image_from_fn(HTS_Engine * engine, char *fn)
+{
+   int i, j, size;
+   const int nstream = HTS_ModelSet_get_nstream(&engine->ms);
+
+   if (HTS_ModelSet_load_image(&engine->ms, fn) == FALSE)
+      return FALSE;
+   /* # of streams is given by image */
+   if (HTS_ModelSet_get_nstream(&engine->ms) != nstream) {
+      HTS_free(engine->global.msd_threshold);
+      HTS_free(engine->global.parameter_iw);
+      HTS_free(engine->global.gv_iw);
+      HTS_free(engine->global.gv_weight);
+      HTS_Engine_initialize_stream(engine, HTS_ModelSet_get_nstream(&engine->ms));
+   }
+   /* default interpolation weights */
+   size = HTS_ModelSet_get_duration_interpolation_size(&engine->ms);
+   engine->global.duration_iw = (double *) HTS_calloc(size, sizeof(double));
+   for (i = 0; i < size; i++)
+      engine->global.duration_iw[i] = 1.0 / size;
+   for (i = 0; i < HTS_ModelSet_get_nstream(&engine->ms); i++) {
+      size = HTS_ModelSet_get_parameter_interpolation_size(&engine->ms, i);
+      engine->global.parameter_iw[i] = (double *) HTS_calloc(size, sizeof(double));
+      for (j = 0; j < size; j++)
+         engine->global.parameter_iw[i][j] = 1.0 / size;
+      if (HTS_ModelSet_use_gv(&engine->ms, i)) {
+         size = HTS_ModelSet_get_gv_interpolation_size(&engine->ms, i);
+         engine->global.gv_iw[i] = (double *) HTS_calloc(size, sizeof(double));
+         for (j = 0; j < size; j++)
+            engine->global.gv_iw[i][j] = 1.0 / size;
+      }
+   }
+
+   return TRUE;
+}
+
+/* HTS_Engine_save_image_to_fn: save loaded models of all streams into compiled voice image */
+HTS_Boolean HTS_Engine_save_image_to_fn(const HTS_Engine * engine, char *fn)
+{
+   HTS_File *fp = HTS_fopen(fn, "wb");
+   HTS_Boolean result;
+
+   if (fp == NULL)
+      return FALSE;
+   result = HTS_ModelSet_save_image(&engine->ms, fp);
+   HTS_fclose(fp);
+
+   return result;
+}
+
 /* HTS_Engine_load_gv_switch_from_fn: load GV switch from file name */
 HTS_Boolean HTS_Engine_load_gv_switch_from_fn(HTS_Engine * engine, char *fn)
 {
@@ -273,7 +333,7 @@ void HTS_Engine_set_sampling_rate(HTS_Engine * engine, int i)
 }
 
 /* HTS_Engine_get_sampling_rate: get sampling rate */
-int HTS_Engine_get_sampling_rate(HTS_Engine * engine)
+int HTS_Engine_get_sampling_rate(const HTS_Engine * engine)
 {
    return engine->global.sampling_rate;
 }
@@ -289,7 +349,7 @@ void HTS_Engine_set_fperiod(HTS_Engine * engine, int i)
 }
 
 /* HTS_Engine_get_fperiod: get frame shift */
-int HTS_Engine_get_fperiod(HTS_Engine * engine)
+int HTS_Engine_get_fperiod(const HTS_Engine * engine)
 {
    return engine->global.fperiod;
 }
@@ -340,7 +400,7 @@ void HTS_Engine_set_audio_buff_size(HTS_Engine * engine, int i)
 }
 
 /* HTS_Engine_get_audio_buff_size: get audio buffer size */
-int HTS_Engine_get_audio_buff_size(HTS_Engine * engine)
+int HTS_Engine_get_audio_buff_size(const HTS_Engine * engine)
 {
    return engine->global.audio_buff_size;
 }
@@ -397,6 +457,14 @@ void HTS_Engine_set_volume(HTS_Engine * engine, double f)
    engine->global.volume = f;
 }
 
+/* HTS_Engine_set_vocoder_type: set vocoder type (HTS_VOCODER_DOUBLE, HTS_VOCODER_FLOAT or HTS_VOCODER_FLOAT_C) */
+void HTS_Engine_set_vocoder_type(HTS_Engine * engine, int i)
+{
+   if (i != HTS_VOCODER_FLOAT && i != HTS_VOCODER_FLOAT_C)
+      i = HTS_VOCODER_DOUBLE;
+   engine->global.vocoder_type = i;
+}
+
 /* HTS_Engine_get_total_state: get total number of state */
 int HTS_Engine_get_total_state(HTS_Engine * engine)
 {
@@ -457,6 +525,18 @@ void HTS_Engine_load_label_from_string_list(HTS_Engine * engine, char **data, in
    HTS_Label_load_from_string_list(&engine->label, engine->global.sampling_rate, engine->global.fperiod, data, size);
 }
 
+/* HTS_Engine_load_label_from_context_list: load label from context names and times */
+void HTS_Engine_load_label_from_context_list(HTS_Engine * engine, char **name, double *start, double *end, int size)
+{
+   HTS_Label_load_from_context_list(&engine->label, engine->global.sampling_rate, engine->global.fperiod, name, start, end, size);
+}
+
+/* HTS_Engine_load_label_from_feature_list: load label from context features, names and times */
+void HTS_Engine_load_label_from_feature_list(HTS_Engine * engine, unsigned int *feature, char **name, double *start, double *end, int size)
+{
+   HTS_Label_load_from_feature_list(&engine->label, engine->global.sampling_rate, engine->global.fperiod, feature, HTS_ModelSet_get_feature_size(&engine->ms), name, start, end, size);
+}
+
 /* HTS_Engine_create_sstream: parse label and determine state duration */
 HTS_Boolean HTS_Engine_create_sstream(HTS_Engine * engine)
 {
@@ -472,19 +552,14 @@ HTS_Boolean HTS_Engine_create_pstream(HTS_Engine * engine)
 /* HTS_Engine_create_gstream: synthesis speech */
 HTS_Boolean HTS_Engine_create_gstream(HTS_Engine * engine)
 {
-   return HTS_GStreamSet_create(&engine->gss, &engine->pss, engine->global.stage, engine->global.use_log_gain, engine->global.sampling_rate, engine->global.fperiod, engine->global.alpha, engine->global.beta, &engine->global.stop, engine->global.volume, engine->global.audio_buff_size > 0 ? &engine->audio : NULL);
+   return HTS_GStreamSet_create(&engine->gss, &engine->pss, engine->global.stage, engine->global.use_log_gain, engine->global.sampling_rate, engine->global.fperiod, engine->global.alpha, engine->global.beta, &engine->global.stop, engine->global.volume, engine->global.vocoder_type, engine->global.audio_buff_size > 0 ? &engine->audio : NULL);
 }
 
-/* HTS_Engine_save_information: output trace information */
-void HTS_Engine_save_information(HTS_Engine * engine, HTS_File * fp)
+/* HTS_save_information: output trace information of engine or context */
+static void HTS_save_information(const HTS_Global * global, const HTS_ModelSet * ms, HTS_Label * label, HTS_SStreamSet * sss, HTS_PStreamSet * pss, HTS_File * fp)
 {
    int i, j, k, l, m, n;
    double temp;
-   HTS_Global *global = &engine->global;
-   HTS_ModelSet *ms = &engine->ms;
-   HTS_Label *label = &engine->label;
-   HTS_SStreamSet *sss = &engine->sss;
-   HTS_PStreamSet *pss = &engine->pss;
 
    /* global parameter */
    fprintf(fp, "[Global parameter]\n");
@@ -507,10 +582,7 @@ void HTS_Engine_save_information(HTS_Engine * engine, HTS_File * fp)
    for (i = 0, temp = 0.0; i < HTS_ModelSet_get_duration_interpolation_size(ms); i++)
       temp += global->duration_iw[i];
    for (i = 0; i < HTS_ModelSet_get_duration_interpolation_size(ms); i++)
-      if (global->duration_iw[i] != 0.0)
-         global->duration_iw[i] /= temp;
-   for (i = 0; i < HTS_ModelSet_get_duration_interpolation_size(ms); i++)
-      fprintf(fp, "         Interpolation weight[%2d]      -> %8.0f(%%)\n", i, (float) (100 * global->duration_iw[i]));
+      fprintf(fp, "         Interpolation weight[%2d]      -> %8.0f(%%)\n", i, (float) (global->duration_iw[i] != 0.0 ? 100 * global->duration_iw[i] / temp : 0.0));
    fprintf(fp, "\n");
 
    fprintf(fp, "[Stream parameter]\n");
@@ -523,10 +595,7 @@ void HTS_Engine_save_information(HTS_Engine * engine, HTS_File * fp)
       for (j = 0, temp = 0.0; j < HTS_ModelSet_get_parameter_interpolation_size(ms, i); j++)
          temp += global->parameter_iw[i][j];
       for (j = 0; j < HTS_ModelSet_get_parameter_interpolation_size(ms, i); j++)
-         if (global->parameter_iw[i][j] != 0.0)
-            global->parameter_iw[i][j] /= temp;
-      for (j = 0; j < HTS_ModelSet_get_parameter_interpolation_size(ms, i); j++)
-         fprintf(fp, "           Interpolation weight[%2d]    -> %8.0f(%%)\n", j, (float) (100 * global->parameter_iw[i][j]));
+         fprintf(fp, "           Interpolation weight[%2d]    -> %8.0f(%%)\n", j, (float) (global->parameter_iw[i][j] != 0.0 ? 100 * global->parameter_iw[i][j] / temp : 0.0));
       /* MSD */
       if (HTS_ModelSet_is_msd(ms, i)) { /* for MSD */
          fprintf(fp, "           MSD flag                    ->     TRUE\n");
@@ -555,10 +624,7 @@ void HTS_Engine_save_information(HTS_Engine * engine, HTS_File * fp)
          for (j = 0, temp = 0.0; j < HTS_ModelSet_get_gv_interpolation_size(ms, i); j++)
             temp += global->gv_iw[i][j];
          for (j = 0; j < HTS_ModelSet_get_gv_interpolation_size(ms, i); j++)
-            if (global->gv_iw[i][j] != 0.0)
-               global->gv_iw[i][j] /= temp;
-         for (j = 0; j < HTS_ModelSet_get_gv_interpolation_size(ms, i); j++)
-            fprintf(fp, "           GV interpolation weight[%2d] -> %8.0f(%%)\n", j, (float) (100 * global->gv_iw[i][j]));
+            fprintf(fp, "           GV interpolation weight[%2d] -> %8.0f(%%)\n", j, (float) (global->gv_iw[i][j] != 0.0 ? 100 * global->gv_iw[i][j] / temp : 0.0));
       } else {
          fprintf(fp, "           GV flag                     ->    FALSE\n");
       }
@@ -574,11 +640,11 @@ void HTS_Engine_save_information(HTS_Engine * engine, HTS_File * fp)
 
    for (i = 0; i < HTS_Label_get_size(label); i++) {
       fprintf(fp, "HMM[%2d]\n", i);
-      fprintf(fp, "  Name                                 -> %s\n", HTS_Label_get_string(label, i));
+      fprintf(fp, "  Name                                 -> %s\n", HTS_Label_get_string(label, i) ? HTS_Label_get_string(label, i) : "");
       fprintf(fp, "  Duration\n");
       for (j = 0; j < HTS_ModelSet_get_duration_interpolation_size(ms); j++) {
          fprintf(fp, "    Interpolation[%2d]\n", j);
-         HTS_ModelSet_get_duration_index(ms, HTS_Label_get_string(label, i), &k, &l, j);
+         HTS_ModelSet_get_duration_index(ms, HTS_Label_get_feature(label, i), &k, &l, j);
          fprintf(fp, "      Tree index                       -> %8d\n", k);
          fprintf(fp, "      PDF index                        -> %8d\n", l);
       }
@@ -595,7 +661,7 @@ void HTS_Engine_save_information(HTS_Engine * engine, HTS_File * fp)
             }
             for (l = 0; l < HTS_ModelSet_get_parameter_interpolation_size(ms, k); l++) {
                fprintf(fp, "      Interpolation[%2d]\n", l);
-               HTS_ModelSet_get_parameter_index(ms, HTS_Label_get_string(label, i), &m, &n, k, j + 2, l);
+               HTS_ModelSet_get_parameter_index(ms, HTS_Label_get_feature(label, i), &m, &n, k, j + 2, l);
                fprintf(fp, "        Tree index                     -> %8d\n", m);
                fprintf(fp, "        PDF index                      -> %8d\n", n);
             }
@@ -604,32 +670,29 @@ void HTS_Engine_save_information(HTS_Engine * engine, HTS_File * fp)
    }
 }
 
-/* HTS_Engine_save_label: output label with time */
-void HTS_Engine_save_label(HTS_Engine * engine, HTS_File * fp)
+/* HTS_save_label: output label with time of engine or context */
+static void HTS_save_label(const HTS_Global * global, const HTS_ModelSet * ms, HTS_Label * label, HTS_SStreamSet * sss, HTS_File * fp)
 {
    int i, j;
    int frame, state, duration;
 
-   HTS_Label *label = &engine->label;
-   HTS_SStreamSet *sss = &engine->sss;
-   const int nstate = HTS_ModelSet_get_nstate(&engine->ms);
-   const double rate = engine->global.fperiod * 1e+7 / engine->global.sampling_rate;
+   const int nstate = HTS_ModelSet_get_nstate(ms);
+   const double rate = global->fperiod * 1e+7 / global->sampling_rate;
 
    for (i = 0, state = 0, frame = 0; i < HTS_Label_get_size(label); i++) {
       for (j = 0, duration = 0; j < nstate; j++)
          duration += HTS_SStreamSet_get_duration(sss, state++);
       /* in HTK & HTS format */
-      fprintf(fp, "%lu %lu %s\n", (unsigned long) (frame * rate), (unsigned long) ((frame + duration) * rate), HTS_Label_get_string(label, i));
+      fprintf(fp, "%lu %lu %s\n", (unsigned long) (frame * rate), (unsigned long) ((frame + duration) * rate), HTS_Label_get_string(label, i) ? HTS_Label_get_string(label, i) : "");
       frame += duration;
    }
 }
 
-/* HTS_Engine_save_generated_parameter: output generated parameter */
-void HTS_Engine_save_generated_parameter(HTS_Engine * engine, HTS_File * fp, int stream_index)
+/* HTS_save_generated_parameter: output generated parameter of engine or context */
+static void HTS_save_generated_parameter(HTS_GStreamSet * gss, HTS_File * fp, int stream_index)
 {
    int i, j;
    float temp;
-   HTS_GStreamSet *gss = &engine->gss;
 
    for (i = 0; i < HTS_GStreamSet_get_total_frame(gss); i++)
       for (j = 0; j < HTS_GStreamSet_get_static_length(gss, stream_index); j++) {
@@ -638,12 +701,11 @@ void HTS_Engine_save_generated_parameter(HTS_Engine * engine, HTS_File * fp, int
       }
 }
 
-/* HTS_Engine_save_generated_speech: output generated speech */
-void HTS_Engine_save_generated_speech(HTS_Engine * engine, HTS_File * fp)
+/* HTS_save_generated_speech: output generated speech of engine or context */
+static void HTS_save_generated_speech(HTS_GStreamSet * gss, HTS_File * fp)
 {
    int i;
    short temp;
-   HTS_GStreamSet *gss = &engine->gss;
 
    for (i = 0; i < HTS_GStreamSet_get_total_nsample(gss); i++) {
       temp = HTS_GStreamSet_get_speech(gss, i);
@@ -651,13 +713,12 @@ void HTS_Engine_save_generated_speech(HTS_Engine * engine, HTS_File * fp)
    }
 }
 
-/* HTS_Engine_save_riff: output RIFF format file */
-void HTS_Engine_save_riff(HTS_Engine * engine, HTS_File * fp)
+/* HTS_save_riff: output RIFF format file of engine or context */
+static void HTS_save_riff(const HTS_Global * global, HTS_GStreamSet * gss, HTS_File * fp)
 {
    int i;
    short temp;
 
-   HTS_GStreamSet *gss = &engine->gss;
    char data_01_04[] = { 'R', 'I', 'F', 'F' };
    int data_05_08 = HTS_GStreamSet_get_total_nsample(gss) * sizeof(short) + 36;
    char data_09_12[] = { 'W', 'A', 'V', 'E' };
@@ -665,8 +726,8 @@ void HTS_Engine_save_riff(HTS_Engine * engine, HTS_File * fp)
    int data_17_20 = 16;
    short data_21_22 = 1;        /* PCM */
    short data_23_24 = 1;        /* monoral */
-   int data_25_28 = engine->global.sampling_rate;
-   int data_29_32 = engine->global.sampling_rate * sizeof(short);
+   int data_25_28 = global->sampling_rate;
+   int data_29_32 = global->sampling_rate * sizeof(short);
    short data_33_34 = sizeof(short);
    short data_35_36 = (short) (sizeof(short) * 8);
    char data_37_40[] = { 'd', 'a', 't', 'a' };
@@ -693,6 +754,36 @@ void HTS_Engine_save_riff(HTS_Engine * engine, HTS_File * fp)
    }
 }
 
+/* HTS_Engine_save_information: output trace information */
+void HTS_Engine_save_information(HTS_Engine * engine, HTS_File * fp)
+{
+   HTS_save_information(&engine->global, &engine->ms, &engine->label, &engine->sss, &engine->pss, fp);
+}
+
+/* HTS_Engine_save_label: output label with time */
+void HTS_Engine_save_label(HTS_Engine * engine, HTS_File * fp)
+{
+   HTS_save_label(&engine->global, &engine->ms, &engine->label, &engine->sss, fp);
+}
+
+/* HTS_Engine_save_generated_parameter: output generated parameter */
+void HTS_Engine_save_generated_parameter(HTS_Engine * engine, HTS_File * fp, int stream_index)
+{
+   HTS_save_generated_parameter(&engine->gss, fp, stream_index);
+}
+
+/* HTS_Engine_save_generated_speech: output generated speech */
+void HTS_Engine_save_generated_speech(HTS_Engine * engine, HTS_File * fp)
+{
+   HTS_save_generated_speech(&engine->gss, fp);
+}
+
+/* HTS_Engine_save_riff: output RIFF format file */
+void HTS_Engine_save_riff(HTS_Engine * engine, HTS_File * fp)
+{
+   HTS_save_riff(&engine->global, &engine->gss, fp);
+}
+
 /* HTS_Engine_refresh: free model per one time synthesis */
 void HTS_Engine_refresh(HTS_Engine * engine)
 {
@@ -728,6 +819,149 @@ void HTS_Engine_clear(HTS_Engine * engine)
    HTS_Audio_clear(&engine->audio);
 }
 
+/* HTS_Context_initialize: initialize synthesis context for given engine */
+void HTS_Context_initialize(HTS_Context * context, const HTS_Engine * engine)
+{
+   context->engine = engine;
+   context->stop = FALSE;
+   context->volume = engine->global.volume;
+   HTS_Label_initialize(&context->label);
+   HTS_SStreamSet_initialize(&context->sss);
+   HTS_PStreamSet_initialize(&context->pss);
+   HTS_GStreamSet_initialize(&context->gss);
+}
+
+/* HTS_Context_set_stop_flag: set stop flag */
+void HTS_Context_set_stop_flag(HTS_Context * context, HTS_Boolean b)
+{
+   context->stop = b;
+}
+
+/* HTS_Context_set_volume: set volume */
+void HTS_Context_set_volume(HTS_Context * context, double f)
+{
+   if (f < 0.0)
+      f = 0.0;
+   context->volume = f;
+}
+
+/* HTS_Context_load_label_from_fn: load label from file name */
+void HTS_Context_load_label_from_fn(HTS_Context * context, char *fn)
+{
+   HTS_Label_load_from_fn(&context->label, context->engine->global.sampling_rate, context->engine->global.fperiod, fn);
+}
+
+/* HTS_Context_load_label_from_string: load label from string */
+void HTS_Context_load_label_from_string(HTS_Context * context, char *data)
+{
+   HTS_Label_load_from_string(&context->label, context->engine->global.sampling_rate, context->engine->global.fperiod, data);
+}
+
+/* HTS_Context_load_label_from_context_list: load label from context names and times */
+void HTS_Context_load_label_from_context_list(HTS_Context * context, char **name, double *start, double *end, int size)
+{
+   HTS_Label_load_from_context_list(&context->label, context->engine->global.sampling_rate, context->engine->global.fperiod, name, start, end, size);
+}
+
+/* HTS_Context_load_label_from_feature_list: load label from context features, names and times */
+void HTS_Context_load_label_from_feature_list(HTS_Context * context, unsigned int *feature, char **name, double *start, double *end, int size)
+{
+   HTS_Label_load_from_feature_list(&context->label, context->engine->global.sampling_rate, context->engine->global.fperiod, feature, HTS_ModelSet_get_feature_size(&context->engine->ms), name, start, end, size);
+}
+
+/* HTS_Context_create_sstream: parse label and determine state duration */
+HTS_Boolean HTS_Context_create_sstream(HTS_Context * context)
+{
+   const HTS_Engine *engine = context->engine;
+
+   return HTS_SStreamSet_create(&context->sss, &engine->ms, &context->label, engine->global.duration_iw, engine->global.parameter_iw, engine->global.gv_iw);
+}
+
+/* HTS_Context_create_pstream: generate speech parameter vector sequence */
+HTS_Boolean HTS_Context_create_pstream(HTS_Context * context)
+{
+   return HTS_PStreamSet_create(&context->pss, &context->sss, context->engine->global.msd_threshold, context->engine->global.gv_weight);
+}
+
+/* HTS_Context_create_pstream_window: prepare speech parameter generation in overlapped windows, parameters are generated by HTS_Context_create_gstream_incremental */
+HTS_Boolean HTS_Context_create_pstream_window(HTS_Context * context, int overlap)
+{
+   return HTS_PStreamSet_create_window(&context->pss, &context->sss, context->engine->global.msd_threshold, context->engine->global.gv_weight, overlap);
+}
+
+/* HTS_Context_set_speech_buffer: synthesis speech into the buffer provided by user, which should hold fperiod * total_frame samples */
+void HTS_Context_set_speech_buffer(HTS_Context * context, short *speech)
+{
+   HTS_GStreamSet_set_speech_buffer(&context->gss, speech);
+}
+
+/* HTS_Context_create_gstream: synthesis speech */
+HTS_Boolean HTS_Context_create_gstream(HTS_Context * context)
+{
+   const HTS_Global *global = &context->engine->global;
+
+   return HTS_GStreamSet_create(&context->gss, &context->pss, global->stage, global->use_log_gain, global->sampling_rate, global->fperiod, global->alpha, global->beta, &context->stop, context->volume, global->vocoder_type, NULL);
+}
+
+/* HTS_Context_create_gstream_incremental: synthesis speech chunk by chunk, callback is called after every chunk_frame frames are synthesized */
+HTS_Boolean HTS_Context_create_gstream_incremental(HTS_Context * context, int chunk_frame, HTS_GStreamCallback callback, void *user_data)
+{
+   const HTS_Global *global = &context->engine->global;
+
+   return HTS_GStreamSet_create_incremental(&context->gss, &context->pss, global->stage, global->use_log_gain, global->sampling_rate, global->fperiod, global->alpha, global->beta, &context->stop, context->volume, global->vocoder_type, NULL, chunk_frame, callback, user_data);
+}
+
+/* HTS_Context_save_information: output trace information */
+void HTS_Context_save_information(HTS_Context * context, HTS_File * fp)
+{
+   HTS_save_information(&context->engine->global, &context->engine->ms, &context->label, &context->sss, &context->pss, fp);
+}
+
+/* HTS_Context_save_label: output label with time */
+void HTS_Context_save_label(HTS_Context * context, HTS_File * fp)
+{
+   HTS_save_label(&context->engine->global, &context->engine->ms, &context->label, &context->sss, fp);
+}
+
+/* HTS_Context_save_generated_parameter: output generated parameter */
+void HTS_Context_save_generated_parameter(HTS_Context * context, HTS_File * fp, int stream_index)
+{
+   HTS_save_generated_parameter(&context->gss, fp, stream_index);
+}
+
+/* HTS_Context_save_generated_speech: output generated speech */
+void HTS_Context_save_generated_speech(HTS_Context * context, HTS_File * fp)
+{
+   HTS_save_generated_speech(&context->gss, fp);
+}
+
+/* HTS_Context_save_riff: output RIFF format file */
+void HTS_Context_save_riff(HTS_Context * context, HTS_File * fp)
+{
+   HTS_save_riff(&context->engine->global, &context->gss, fp);
+}
+
+/* HTS_Context_refresh: free memory per one time synthesis */
+void HTS_Context_refresh(HTS_Context * context)
+{
+   /* free generated parameter stream set */
+   HTS_GStreamSet_clear(&context->gss);
+   /* free parameter stream set */
+   HTS_PStreamSet_clear(&context->pss);
+   /* free state stream set */
+   HTS_SStreamSet_clear(&context->sss);
+   /* free label list */
+   HTS_Label_clear(&context->label);
+   /* stop flag */
+   context->stop = FALSE;
+}
+
+/* HTS_Context_clear: free context */
+void HTS_Context_clear(HTS_Context * context)
+{
+   HTS_Context_refresh(context);
+}
+
 /* HTS_get_copyright: write copyright to string */
 void HTS_get_copyright(char *str)
 {
@@ -79,6 +79,10 @@ HTS_File *HTS_fopen(const char *name, const char *opt);
 /* HTS_fclose: wrapper for fclose */
 void HTS_fclose(HTS_File * fp);
 
+/* HTS_get_alloc_count: number of memory allocations (calloc and realloc) of the current thread since it started, */
+/*                      or 0 if tracing is disabled (CST_DISABLE_TRACE) or on Windows CE */
+unsigned long HTS_get_alloc_count(void);
+
 /*  ------------------------ copyright ----------------------------  */
 
 #define HTS_VERSION   "1.06"
@@ -173,45 +177,74 @@ typedef struct _HTS_Window {
    int max_width;               /* maximum width of windows */
 } HTS_Window;
 
-/* HTS_Pattern: List of patterns in a question and a tree. */
+/* HTS_Pattern: Compiled pattern of a question or a tree. */
 typedef struct _HTS_Pattern {
-   char *string;                /* pattern string */
-   struct _HTS_Pattern *next;   /* pointer to the next pattern */
+   int string;                  /* offset of pattern string in string pool of model */
+   int body;                    /* offset of pattern string without leading and trailing '*' */
+   int length;                  /* length of body */
+   int type;                    /* compiled type of pattern (HTS_PATTERN_*) */
 } HTS_Pattern;
 
-/* HTS_Question: List of questions in a tree. */
+/* HTS_Question: Question of trees, matching any of its patterns. */
 typedef struct _HTS_Question {
-   char *string;                /* name of this question */
-   HTS_Pattern *head;           /* pointer to the head of pattern list */
-   struct _HTS_Question *next;  /* pointer to the next question */
+   int string;                  /* offset of name of this question in string pool of model */
+   int pattern;                 /* index of the first pattern of this question */
+   int npattern;                /* # of patterns */
 } HTS_Question;
 
-/* HTS_Node: List of tree nodes in a tree. */
+/* HTS_Node: List of tree nodes in a tree (only used while loading). */
 typedef struct _HTS_Node {
    int index;                   /* index of this node */
    int pdf;                     /* index of PDF for this node  ( leaf node only ) */
-   struct _HTS_Node *yes;       /* pointer to its child node (yes) */
-   struct _HTS_Node *no;        /* pointer to its child node (no) */
+   struct _HTS_Node *yes;       /* pointer to its child node (yes), NULL for leaf node */
+   struct _HTS_Node *no;        /* pointer to its child node (no), NULL for leaf node */
    struct _HTS_Node *next;      /* pointer to the next node */
-   HTS_Question *quest;         /* question applied at this node */
+   int quest;                   /* index of question applied at this node */
 } HTS_Node;
 
-/* HTS_Tree: List of decision trees in a model. */
+/* HTS_FlatNode: Compiled tree node stored in a flat array. */
+typedef struct _HTS_FlatNode {
+   int quest;                   /* index of question applied at this node */
+   int child[2];                /* child for answer no/yes: node index if >= 0, or -(pdf + 1) for leaf */
+} HTS_FlatNode;
+
+/* HTS_Test: Test of compiled question or tree, true if any bit of mask is set in the word of context features. */
+typedef struct _HTS_Test {
+   int word;                    /* index of word in context features */
+   unsigned int mask;           /* bits of patterns in the word */
+} HTS_Test;
+
+/* HTS_Tree: Decision tree of a model. */
 typedef struct _HTS_Tree {
-   HTS_Pattern *head;           /* pointer to the head of pattern list for this tree */
-   struct _HTS_Tree *next;      /* pointer to next tree */
-   HTS_Node *root;              /* root node of this tree */
    int state;                   /* state index of this tree */
+   int pattern;                 /* index of the first pattern for this tree */
+   int npattern;                /* # of patterns (0 if the tree is used for all models) */
+   int node;                    /* index of the root in compiled nodes of model */
+   int nnode;                   /* # of compiled nodes (0 if the tree is a single leaf) */
+   int pdf;                     /* index of PDF if the tree is a single leaf */
 } HTS_Tree;
 
 /* HTS_Model: Set of PDFs, decision trees and questions. */
+/* All members are flat arrays, which are either allocated by loading files or point into a mapped voice image. */
 typedef struct _HTS_Model {
    int vector_length;           /* vector length (include static and dynamic features) */
-   int ntree;                   /* # of trees */
+   int pdf_length;              /* length of each PDF (means, variances and MSD weight) */
+   int ntree;                   /* # of trees (# of PDF tables) */
    int *npdf;                   /* # of PDFs at each tree */
-   double ***pdf;               /* PDFs */
-   HTS_Tree *tree;              /* pointer to the list of trees */
-   HTS_Question *question;      /* pointer to the list of questions */
+   int *pdf_offset;             /* offset of the first PDF of each tree in pdf */
+   float *pdf;                  /* PDFs of all trees */
+   HTS_Tree *tree;              /* trees (NULL if PDFs are not clustered by trees) */
+   HTS_FlatNode *node;          /* compiled nodes of all trees */
+   int nnode;                   /* # of compiled nodes */
+   HTS_Question *question;      /* questions indexed by HTS_FlatNode.quest */
+   int nquestion;               /* # of questions */
+   HTS_Pattern *pattern;        /* patterns of questions and trees */
+   int npattern;                /* # of patterns */
+   char *string;                /* string pool of names of questions and patterns */
+   int nstring;                 /* size of string pool */
+   int *test_offset;            /* index of the first test of each question and then of each tree (nquestion + ntree + 1) */
+   HTS_Test *test;              /* tests of questions and trees on context features (allocated even if mapped) */
+   HTS_Boolean mapped;          /* arrays point into mapped voice image, and are not freed */
 } HTS_Model;
 
 /* HTS_Stream: Set of models and a window. */
@@ -223,6 +256,48 @@ typedef struct _HTS_Stream {
    int interpolation_size;      /* # of models for interpolation */
 } HTS_Stream;
 
+/* HTS_Image: Compiled voice image mapped into memory read-only. */
+typedef struct _HTS_Image {
+   char *data;                  /* mapped data (NULL if no image is mapped) */
+   size_t size;                 /* size of mapped data */
+   void *file;                  /* file handle (Windows only) */
+   void *mapping;               /* file mapping handle (Windows only) */
+} HTS_Image;
+
+/* HTS_Field: Field of labels between left and right delimiters, whose values are tested by patterns. */
+typedef struct _HTS_Field {
+   int left;                    /* offset of left delimiter in string pool of features (empty if field begins label) */
+   int nleft;                   /* length of left delimiter */
+   int right;                   /* offset of right delimiter in string pool of features (empty if field ends label) */
+   int nright;                  /* length of right delimiter */
+   int value;                   /* index of the first value, literal values are sorted and followed by values with '?' */
+   int nliteral;                /* # of literal values */
+   int nwildcard;               /* # of values with '?' */
+   int max_length;              /* maximum length of values */
+} HTS_Field;
+
+/* HTS_Value: Value of field or whole label in patterns, with the bit of the pattern in context features. */
+typedef struct _HTS_Value {
+   int string;                  /* offset of value in string pool of features */
+   int length;                  /* length of value */
+   int bit;                     /* index of bit in context features */
+} HTS_Value;
+
+/* HTS_FeatureSet: Context features of labels, whose bits are the answers of all distinct patterns of models. */
+/* Most patterns test the value of one field, and the others are matched with the whole label. */
+typedef struct _HTS_FeatureSet {
+   HTS_Field *field;            /* fields tested by patterns */
+   int nfield;                  /* # of fields */
+   HTS_Value *value;            /* values of all fields */
+   int nvalue;                  /* # of values */
+   HTS_Value *other;            /* patterns matched with whole label */
+   int nother;                  /* # of patterns matched with whole label */
+   int any;                     /* bit of pattern "*" (-1 if not used) */
+   char *string;                /* string pool of delimiters, values and patterns */
+   int nstring;                 /* size of string pool */
+   int size;                    /* # of words of context features */
+} HTS_FeatureSet;
+
 /* HTS_ModelSet: Set of duration models, HMMs and GV models. */
 typedef struct _HTS_ModelSet {
    HTS_Stream duration;         /* duration PDFs and trees */
@@ -231,6 +306,9 @@ typedef struct _HTS_ModelSet {
    HTS_Model gv_switch;         /* GV switch */
    int nstate;                  /* # of HMM states */
    int nstream;                 /* # of stream */
+   HTS_Model pattern;           /* patterns tested by context features besides questions */
+   HTS_FeatureSet feature;      /* context features tested by questions and trees of all models */
+   HTS_Image image;             /* voice image which models are mapped from */
 } HTS_ModelSet;
 
 /*  ----------------------- model method --------------------------  */
@@ -247,71 +325,101 @@ HTS_Boolean HTS_ModelSet_load_parameter(HTS_ModelSet * ms, HTS_File ** pdf_fp, H
 /* HTS_ModelSet_load_gv: load GV model */
 HTS_Boolean HTS_ModelSet_load_gv(HTS_ModelSet * ms, HTS_File ** pdf_fp, HTS_File ** tree_fp, int stream_index, int interpolation_size);
 
+/* HTS_ModelSet_load_image: map models of all streams from compiled voice image */
+HTS_Boolean HTS_ModelSet_load_image(HTS_ModelSet * ms, const char *fn);
+
+/* HTS_ModelSet_save_image: save models of all streams into compiled voice image */
+HTS_Boolean HTS_ModelSet_save_image(const HTS_ModelSet * ms, HTS_File * fp);
+
 /* HTS_ModelSet_have_gv_tree: if context-dependent GV is used, return true */
-HTS_Boolean HTS_ModelSet_have_gv_tree(HTS_ModelSet * ms, int stream_index);
+HTS_Boolean HTS_ModelSet_have_gv_tree(const HTS_ModelSet * ms, int stream_index);
 
 /* HTS_ModelSet_load_gv_switch: load GV switch */
 HTS_Boolean HTS_ModelSet_load_gv_switch(HTS_ModelSet * ms, HTS_File * fp);
 
 /* HTS_ModelSet_have_gv_switch: if GV switch is used, return true */
-HTS_Boolean HTS_ModelSet_have_gv_switch(HTS_ModelSet * ms);
+HTS_Boolean HTS_ModelSet_have_gv_switch(const HTS_ModelSet * ms);
 
 /* HTS_ModelSet_get_nstate: get number of state */
-int HTS_ModelSet_get_nstate(HTS_ModelSet * ms);
+int HTS_ModelSet_get_nstate(const HTS_ModelSet * ms);
 
 /* HTS_ModelSet_get_nstream: get number of stream */
-int HTS_ModelSet_get_nstream(HTS_ModelSet * ms);
+int HTS_ModelSet_get_nstream(const HTS_ModelSet * ms);
 
 /* HTS_ModelSet_get_vector_length: get vector length */
-int HTS_ModelSet_get_vector_length(HTS_ModelSet * ms, int stream_index);
+int HTS_ModelSet_get_vector_length(const HTS_ModelSet * ms, int stream_index);
 
 /* HTS_ModelSet_is_msd: get MSD flag */
-HTS_Boolean HTS_ModelSet_is_msd(HTS_ModelSet * ms, int stream_index);
+HTS_Boolean HTS_ModelSet_is_msd(const HTS_ModelSet * ms, int stream_index);
 
 /* HTS_ModelSet_get_window_size: get dynamic window size */
-int HTS_ModelSet_get_window_size(HTS_ModelSet * ms, int stream_index);
+int HTS_ModelSet_get_window_size(const HTS_ModelSet * ms, int stream_index);
 
 /* HTS_ModelSet_get_window_left_width: get left width of dynamic window */
-int HTS_ModelSet_get_window_left_width(HTS_ModelSet * ms, int stream_index, int window_index);
+int HTS_ModelSet_get_window_left_width(const HTS_ModelSet * ms, int stream_index, int window_index);
 
 /* HTS_ModelSet_get_window_right_width: get right width of dynamic window */
-int HTS_ModelSet_get_window_right_width(HTS_ModelSet * ms, int stream_index, int window_index);
+int HTS_ModelSet_get_window_right_width(const HTS_ModelSet * ms, int stream_index, int window_index);
 
 /* HTS_ModelSet_get_window_coefficient: get coefficient of dynamic window */
-double HTS_ModelSet_get_window_coefficient(HTS_ModelSet * ms, int stream_index, int window_index, int coefficient_index);
+double HTS_ModelSet_get_window_coefficient(const HTS_ModelSet * ms, int stream_index, int window_index, int coefficient_index);
 
 /* HTS_ModelSet_get_window_max_width: get max width of dynamic window */
-int HTS_ModelSet_get_window_max_width(HTS_ModelSet * ms, int stream_index);
+int HTS_ModelSet_get_window_max_width(const HTS_ModelSet * ms, int stream_index);
 
 /* HTS_ModelSet_get_duration_interpolation_size: get interpolation size (duration model) */
-int HTS_ModelSet_get_duration_interpolation_size(HTS_ModelSet * ms);
+int HTS_ModelSet_get_duration_interpolation_size(const HTS_ModelSet * ms);
 
 /* HTS_ModelSet_get_parameter_interpolation_size: get interpolation size (parameter model) */
-int HTS_ModelSet_get_parameter_interpolation_size(HTS_ModelSet * ms, int stream_index);
+int HTS_ModelSet_get_parameter_interpolation_size(const HTS_ModelSet * ms, int stream_index);
 
 /* HTS_ModelSet_get_gv_interpolation_size: get interpolation size (GV model) */
-int HTS_ModelSet_get_gv_interpolation_size(HTS_ModelSet * ms, int stream_index);
+int HTS_ModelSet_get_gv_interpolation_size(const HTS_ModelSet * ms, int stream_index);
 
 /* HTS_ModelSet_use_gv: get GV flag */
-HTS_Boolean HTS_ModelSet_use_gv(HTS_ModelSet * ms, int index);
+HTS_Boolean HTS_ModelSet_use_gv(const HTS_ModelSet * ms, int index);
+
+/* HTS_ModelSet_get_feature_size: get # of words of context features of each label */
+int HTS_ModelSet_get_feature_size(const HTS_ModelSet * ms);
+
+/* HTS_ModelSet_get_feature: parse label string into context features */
+void HTS_ModelSet_get_feature(const HTS_ModelSet * ms, const char *string, unsigned int *feature);
+
+/* HTS_ModelSet_get_field_size: get # of fields of context features (-1 if some patterns are matched with whole label string) */
+int HTS_ModelSet_get_field_size(const HTS_ModelSet * ms);
+
+/* HTS_ModelSet_get_field_list: get fields of value between given delimiters of label ("" at beginning or end), return # of fields */
+int HTS_ModelSet_get_field_list(const HTS_ModelSet * ms, const char *left, const char *right, int *field_list);
+
+/* HTS_ModelSet_add_pattern: add patterns tested by context features besides questions, and compile context features again */
+void HTS_ModelSet_add_pattern(HTS_ModelSet * ms, char **pattern, int size);
+
+/* HTS_ModelSet_get_pattern_bit: get bit of context features answering whether label matches given pattern (-1 if it is not tested) */
+int HTS_ModelSet_get_pattern_bit(const HTS_ModelSet * ms, const char *pattern);
+
+/* HTS_ModelSet_initialize_feature: initialize context features before setting values of fields */
+void HTS_ModelSet_initialize_feature(const HTS_ModelSet * ms, unsigned int *feature);
+
+/* HTS_ModelSet_set_field: set bits of value of field into context features */
+void HTS_ModelSet_set_field(const HTS_ModelSet * ms, int field_index, const char *value, unsigned int *feature);
 
 /* HTS_ModelSet_get_duration_index: get index of duration tree and PDF */
-void HTS_ModelSet_get_duration_index(HTS_ModelSet * ms, char *string, int *tree_index, int *pdf_index, int interpolation_index);
+void HTS_ModelSet_get_duration_index(const HTS_ModelSet * ms, const unsigned int *feature, int *tree_index, int *pdf_index, int interpolation_index);
 
 /* HTS_ModelSet_get_duration: get duration using interpolation weight */
-void HTS_ModelSet_get_duration(HTS_ModelSet * ms, char *string, double *mean, double *vari, double *iw);
+void HTS_ModelSet_get_duration(const HTS_ModelSet * ms, const unsigned int *feature, double *mean, double *vari, double *iw);
 
 /* HTS_ModelSet_get_parameter_index: get index of parameter tree and PDF */
-void HTS_ModelSet_get_parameter_index(HTS_ModelSet * ms, char *string, int *tree_index, int *pdf_index, int stream_index, int state_index, int interpolation_index);
+void HTS_ModelSet_get_parameter_index(const HTS_ModelSet * ms, const unsigned int *feature, int *tree_index, int *pdf_index, int stream_index, int state_index, int interpolation_index);
 
 /* HTS_ModelSet_get_parameter: get parameter using interpolation weight */
-void HTS_ModelSet_get_parameter(HTS_ModelSet * ms, char *string, double *mean, double *vari, double *msd, int stream_index, int state_index, double *iw);
+void HTS_ModelSet_get_parameter(const HTS_ModelSet * ms, const unsigned int *feature, double *mean, double *vari, double *msd, int stream_index, int state_index, double *iw);
 
 /* HTS_ModelSet_get_gv: get GV using interpolation weight */
-void HTS_ModelSet_get_gv(HTS_ModelSet * ms, char *string, double *mean, double *vari, int stream_index, double *iw);
+void HTS_ModelSet_get_gv(const HTS_ModelSet * ms, const unsigned int *feature, double *mean, double *vari, int stream_index, double *iw);
 
 /* HTS_ModelSet_get_gv_switch: get GV switch */
-HTS_Boolean HTS_ModelSet_get_gv_switch(HTS_ModelSet * ms, char *string);
+HTS_Boolean HTS_ModelSet_get_gv_switch(const HTS_ModelSet * ms, const unsigned int *feature);
 
 /* HTS_ModelSet_clear: free model set */
 void HTS_ModelSet_clear(HTS_ModelSet * ms);
@@ -332,6 +440,8 @@ typedef struct _HTS_Label {
    int size;                    /* # of label strings */
    HTS_Boolean frame_flag;      /* flag for frame length modification */
    double speech_speed;         /* speech speed rate */
+   unsigned int *feature;       /* context features of all label strings (NULL if not parsed or given) */
+   int feature_size;            /* # of words of context features of each label string */
 } HTS_Label;
 
 /*  ----------------------- label method --------------------------  */
@@ -351,6 +461,12 @@ void HTS_Label_load_from_string(HTS_Label * label, int sampling_rate, int fperio
 /* HTS_Label_load_from_string_list: load label list from string list */
 void HTS_Label_load_from_string_list(HTS_Label * label, int sampling_rate, int fperiod, char **data, int size);
 
+/* HTS_Label_load_from_context_list: load label list from context names and times (in 100ns, negative if not specified) */
+void HTS_Label_load_from_context_list(HTS_Label * label, int sampling_rate, int fperiod, char **name, double *start, double *end, int size);
+
+/* HTS_Label_load_from_feature_list: load label list from context features, names (NULL if not used) and times (in 100ns, negative if not specified) */
+void HTS_Label_load_from_feature_list(HTS_Label * label, int sampling_rate, int fperiod, unsigned int *feature, int feature_size, char **name, double *start, double *end, int size);
+
 /* HTS_Label_set_speech_speed: set speech speed rate */
 void HTS_Label_set_speech_speed(HTS_Label * label, double f);
 
@@ -360,9 +476,18 @@ void HTS_Label_set_frame_specified_flag(HTS_Label * label, HTS_Boolean i);
 /* HTS_Label_get_size: get number of label string */
 int HTS_Label_get_size(HTS_Label * label);
 
-/* HTS_Label_get_string: get label string */
+/* HTS_Label_get_string: get label string (NULL if label is loaded from context features without names) */
 char *HTS_Label_get_string(HTS_Label * label, int string_index);
 
+/* HTS_Label_set_feature_size: allocate context features of all label strings, which are cleared to 0 */
+void HTS_Label_set_feature_size(HTS_Label * label, int feature_size);
+
+/* HTS_Label_get_feature: get context features of label string (NULL if not allocated) */
+unsigned int *HTS_Label_get_feature(HTS_Label * label, int string_index);
+
+/* HTS_Label_test_feature: test bit of context features of label string (FALSE if not allocated) */
+HTS_Boolean HTS_Label_test_feature(HTS_Label * label, int string_index, int bit);
+
 /* HTS_Label_get_frame_specified_flag: get frame specified flag */
 HTS_Boolean HTS_Label_get_frame_specified_flag(HTS_Label * label);
 
@@ -412,7 +537,7 @@ typedef struct _HTS_SStreamSet {
 void HTS_SStreamSet_initialize(HTS_SStreamSet * sss);
 
 /* HTS_SStreamSet_create: parse label and determine state duration */
-HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_Label * label, double *duration_iw, double **parameter_iw, double **gv_iw);
+HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, const HTS_ModelSet * ms, HTS_Label * label, double *duration_iw, double **parameter_iw, double **gv_iw);
 
 /* HTS_SStreamSet_get_nstream: get number of stream */
 int HTS_SStreamSet_get_nstream(HTS_SStreamSet * sss);
@@ -486,9 +611,9 @@ void HTS_SStreamSet_clear(HTS_SStreamSet * sss);
 typedef struct _HTS_SMatrices {
    double **mean;               /* mean vector sequence */
    double **ivar;               /* inverse diag variance sequence */
-   double *g;                   /* vector used in the forward substitution */
-   double **wuw;                /* W' U^-1 W  */
-   double *wum;                 /* W' U^-1 mu */
+   double **g;                  /* vector used in the forward substitution, g[t][m] */
+   double **wuw;                /* W' U^-1 W, wuw[t][i * static_length + m] */
+   double **wum;                /* W' U^-1 mu, wum[t][m] */
 } HTS_SMatrices;
 
 /* HTS_PStream: Individual PDF stream. */
@@ -508,6 +633,7 @@ typedef struct _HTS_PStream {
    double *gv_vari;             /* variance vector of GV */
    HTS_Boolean *gv_switch;      /* GV flag sequence */
    int gv_length;               /* frame length for GV calculation */
+   int generated;               /* # of frames whose parameters are generated */
 } HTS_PStream;
 
 /* HTS_PStreamSet: Set of PDF streams. */
@@ -515,6 +641,9 @@ typedef struct _HTS_PStreamSet {
    HTS_PStream *pstream;        /* PDF streams */
    int nstream;                 /* # of PDF streams */
    int total_frame;             /* total frame */
+   int overlap;                 /* overlap frames of windowed parameter generation (0 for whole utterance) */
+   int generated_frame;         /* # of frames whose parameters are generated */
+   int dim_block;               /* # of static dimensions solved together (0 for all dimensions) */
 } HTS_PStreamSet;
 
 /*  ----------------------- pstream method ------------------------  */
@@ -522,9 +651,18 @@ typedef struct _HTS_PStreamSet {
 /* HTS_PStreamSet_initialize: initialize parameter stream set */
 void HTS_PStreamSet_initialize(HTS_PStreamSet * pss);
 
+/* HTS_PStreamSet_set_dim_block: set number of static dimensions solved together in parameter generation (0 for all dimensions) */
+void HTS_PStreamSet_set_dim_block(HTS_PStreamSet * pss, int dim_block);
+
 /* HTS_PStreamSet_create: parameter generation using GV weight */
 HTS_Boolean HTS_PStreamSet_create(HTS_PStreamSet * pss, HTS_SStreamSet * sss, double *msd_threshold, double *gv_weight);
 
+/* HTS_PStreamSet_create_window: prepare parameter generation in windows of given overlap (0 to generate whole utterance at once) */
+HTS_Boolean HTS_PStreamSet_create_window(HTS_PStreamSet * pss, HTS_SStreamSet * sss, double *msd_threshold, double *gv_weight, int overlap);
+
+/* HTS_PStreamSet_generate_until: generate parameters of all streams until given frame (exclusive) */
+void HTS_PStreamSet_generate_until(HTS_PStreamSet * pss, int frame);
+
 /* HTS_PStreamSet_get_nstream: get number of stream */
 int HTS_PStreamSet_get_nstream(HTS_PStreamSet * pss);
 
@@ -557,6 +695,9 @@ typedef struct _HTS_GStream {
    double **par;                /* generated parameter */
 } HTS_GStream;
 
+/* HTS_GStreamCallback: receive synthesized speech of one chunk, return FALSE to stop synthesis */
+typedef HTS_Boolean(*HTS_GStreamCallback) (short *speech, int nsample, void *user_data);
+
 /* HTS_GStreamSet: Set of generated parameter stream. */
 typedef struct _HTS_GStreamSet {
    int total_nsample;           /* total sample */
@@ -564,6 +705,7 @@ typedef struct _HTS_GStreamSet {
    int nstream;                 /* # of streams */
    HTS_GStream *gstream;        /* generated parameter streams */
    short *gspeech;              /* generated speech */
+   HTS_Boolean user_gspeech;    /* whether gspeech is provided by user (not freed) */
 } HTS_GStreamSet;
 
 /*  ----------------------- gstream method ------------------------  */
@@ -571,8 +713,14 @@ typedef struct _HTS_GStreamSet {
 /* HTS_GStreamSet_initialize: initialize generated parameter stream set */
 void HTS_GStreamSet_initialize(HTS_GStreamSet * gss);
 
+/* HTS_GStreamSet_set_speech_buffer: generate speech into the buffer provided by user, which should hold fperiod * total_frame samples */
+void HTS_GStreamSet_set_speech_buffer(HTS_GStreamSet * gss, short *speech);
+
 /* HTS_GStreamSet_create: generate speech */
-HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, int stage, HTS_Boolean use_log_gain, int sampling_rate, int fperiod, double alpha, double beta, HTS_Boolean * stop, double volume, HTS_Audio * audio);
+HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, int stage, HTS_Boolean use_log_gain, int sampling_rate, int fperiod, double alpha, double beta, HTS_Boolean * stop, double volume, int vocoder_type, HTS_Audio * audio);
+
+/* HTS_GStreamSet_create_incremental: generate speech chunk by chunk, callback is called after every chunk_frame frames are synthesized */
+HTS_Boolean HTS_GStreamSet_create_incremental(HTS_GStreamSet * gss, HTS_PStreamSet * pss, int stage, HTS_Boolean use_log_gain, int sampling_rate, int fperiod, double alpha, double beta, HTS_Boolean * stop, double volume, int vocoder_type, HTS_Audio * audio, int chunk_frame, HTS_GStreamCallback callback, void *user_data);
 
 /* HTS_GStreamSet_get_total_nsample: get total number of sample */
 int HTS_GStreamSet_get_total_nsample(HTS_GStreamSet * gss);
@@ -610,6 +758,7 @@ typedef struct _HTS_Global {
    double *gv_weight;           /* GV weights */
    HTS_Boolean stop;            /* stop flag */
    double volume;               /* volume */
+   int vocoder_type;            /* vocoder type */
 } HTS_Global;
 
 /* HTS_Engine: Engine itself. */
@@ -624,6 +773,18 @@ typedef struct _HTS_Engine {
    HTS_SStreamSet sss_voiced;
 } HTS_Engine;
 
+/* HTS_Context: Synthesis context of one request, sharing models and settings of an engine. */
+/* The engine is only read by contexts, so that one engine can serve contexts in several threads. */
+typedef struct _HTS_Context {
+   const HTS_Engine *engine;    /* engine providing models and global settings (read only) */
+   HTS_Boolean stop;            /* stop flag */
+   double volume;               /* volume */
+   HTS_Label label;             /* label */
+   HTS_SStreamSet sss;          /* set of state streams */
+   HTS_PStreamSet pss;          /* set of PDF streams */
+   HTS_GStreamSet gss;          /* set of generated parameter streams */
+} HTS_Context;
+
 /*  ----------------------- engine method -------------------------  */
 
 /* HTS_Engine_initialize: initialize engine */
@@ -653,17 +814,23 @@ HTS_Boolean HTS_Engine_load_gv_switch_from_fn(HTS_Engine * engine, char *fn);
 /* HTS_Engine_load_gv_switch_from_fp: load GV switch from file pointers */
 HTS_Boolean HTS_Engine_load_gv_switch_from_fp(HTS_Engine * engine, HTS_File * fp);
 
+/* HTS_Engine_load_image_from_fn: map models of all streams from compiled voice image, instead of loading files of each stream */
+HTS_Boolean HTS_Engine_load_image_from_fn(HTS_Engine * engine, char *fn);
+
+/* HTS_Engine_save_image_to_fn: save loaded models of all streams into compiled voice image */
+HTS_Boolean HTS_Engine_save_image_to_fn(const HTS_Engine * engine, char *fn);
+
 /* HTS_Engine_set_sampling_rate: set sampling rate */
 void HTS_Engine_set_sampling_rate(HTS_Engine * engine, int i);
 
 /* HTS_Engine_get_sampling_rate: get sampling rate */
-int HTS_Engine_get_sampling_rate(HTS_Engine * engine);
+int HTS_Engine_get_sampling_rate(const HTS_Engine * engine);
 
 /* HTS_Engine_set_fperiod: set frame shift */
 void HTS_Engine_set_fperiod(HTS_Engine * engine, int i);
 
 /* HTS_Engine_get_fperiod: get frame shift */
-int HTS_Engine_get_fperiod(HTS_Engine * engine);
+int HTS_Engine_get_fperiod(const HTS_Engine * engine);
 
 /* HTS_Engine_set_alpha: set alpha */
 void HTS_Engine_set_alpha(HTS_Engine * engine, double f);
@@ -681,7 +848,7 @@ void HTS_Engine_set_beta(HTS_Engine * engine, double f);
 void HTS_Engine_set_audio_buff_size(HTS_Engine * engine, int i);
 
 /* HTS_Engine_get_audio_buff_size: get audio buffer size */
-int HTS_Engine_get_audio_buff_size(HTS_Engine * engine);
+int HTS_Engine_get_audio_buff_size(const HTS_Engine * engine);
 
 /* HTS_Egnine_set_msd_threshold: set MSD threshold */
 void HTS_Engine_set_msd_threshold(HTS_Engine * engine, int stream_index, double f);
@@ -704,6 +871,9 @@ void HTS_Engine_set_stop_flag(HTS_Engine * engine, HTS_Boolean b);
 /* HTS_Engine_set_volume: set volume */
 void HTS_Engine_set_volume(HTS_Engine * engine, double f);
 
+/* HTS_Engine_set_vocoder_type: set vocoder type (HTS_VOCODER_DOUBLE, HTS_VOCODER_FLOAT or HTS_VOCODER_FLOAT_C) */
+void HTS_Engine_set_vocoder_type(HTS_Engine * engine, int i);
+
 /* HTS_Engine_get_total_state: get total number of state */
 int HTS_Engine_get_total_state(HTS_Engine * engine);
 
@@ -734,6 +904,12 @@ void HTS_Engine_load_label_from_string(HTS_Engine * engine, char *data);
 /* HTS_Engine_load_label_from_string_list: load label from string list */
 void HTS_Engine_load_label_from_string_list(HTS_Engine * engine, char **data, int size);
 
+/* HTS_Engine_load_label_from_context_list: load label from context names and times (in 100ns, negative if not specified) */
+void HTS_Engine_load_label_from_context_list(HTS_Engine * engine, char **name, double *start, double *end, int size);
+
+/* HTS_Engine_load_label_from_feature_list: load label from context features, names (NULL if not used) and times (in 100ns, negative if not specified) */
+void HTS_Engine_load_label_from_feature_list(HTS_Engine * engine, unsigned int *feature, char **name, double *start, double *end, int size);
+
 /* HTS_Engine_create_sstream: parse label and determine state duration */
 HTS_Boolean HTS_Engine_create_sstream(HTS_Engine * engine);
 
@@ -764,6 +940,68 @@ void HTS_Engine_refresh(HTS_Engine * engine);
 /* HTS_Engine_clear: free engine */
 void HTS_Engine_clear(HTS_Engine * engine);
 
+/*  ----------------------- context method ------------------------  */
+
+/* HTS_Context_initialize: initialize synthesis context for given engine */
+void HTS_Context_initialize(HTS_Context * context, const HTS_Engine * engine);
+
+/* HTS_Context_set_stop_flag: set stop flag */
+void HTS_Context_set_stop_flag(HTS_Context * context, HTS_Boolean b);
+
+/* HTS_Context_set_volume: set volume */
+void HTS_Context_set_volume(HTS_Context * context, double f);
+
+/* HTS_Context_load_label_from_fn: load label from file name */
+void HTS_Context_load_label_from_fn(HTS_Context * context, char *fn);
+
+/* HTS_Context_load_label_from_string: load label from string */
+void HTS_Context_load_label_from_string(HTS_Context * context, char *data);
+
+/* HTS_Context_load_label_from_context_list: load label from context names and times (in 100ns, negative if not specified) */
+void HTS_Context_load_label_from_context_list(HTS_Context * context, char **name, double *start, double *end, int size);
+
+/* HTS_Context_load_label_from_feature_list: load label from context features, names (NULL if not used) and times (in 100ns, negative if not specified) */
+void HTS_Context_load_label_from_feature_list(HTS_Context * context, unsigned int *feature, char **name, double *start, double *end, int size);
+
+/* HTS_Context_create_sstream: parse label and determine state duration */
+HTS_Boolean HTS_Context_create_sstream(HTS_Context * context);
+
+/* HTS_Context_create_pstream: generate speech parameter vector sequence */
+HTS_Boolean HTS_Context_create_pstream(HTS_Context * context);
+
+/* HTS_Context_create_pstream_window: prepare speech parameter generation in overlapped windows, parameters are generated by HTS_Context_create_gstream_incremental */
+HTS_Boolean HTS_Context_create_pstream_window(HTS_Context * context, int overlap);
+
+/* HTS_Context_set_speech_buffer: synthesis speech into the buffer provided by user, which should hold fperiod * total_frame samples */
+void HTS_Context_set_speech_buffer(HTS_Context * context, short *speech);
+
+/* HTS_Context_create_gstream: synthesis speech (audio device of engine is not used) */
+HTS_Boolean HTS_Context_create_gstream(HTS_Context * context);
+
+/* HTS_Context_create_gstream_incremental: synthesis speech chunk by chunk, callback is called after every chunk_frame frames are synthesized */
+HTS_Boolean HTS_Context_create_gstream_incremental(HTS_Context * context, int chunk_frame, HTS_GStreamCallback callback, void *user_data);
+
+/* HTS_Context_save_information: output trace information */
+void HTS_Context_save_information(HTS_Context * context, HTS_File * fp);
+
+/* HTS_Context_save_label: output label with time */
+void HTS_Context_save_label(HTS_Context * context, HTS_File * fp);
+
+/* HTS_Context_save_generated_parameter: output generated parameter */
+void HTS_Context_save_generated_parameter(HTS_Context * context, HTS_File * fp, int stream_index);
+
+/* HTS_Context_save_generated_speech: output generated speech */
+void HTS_Context_save_generated_speech(HTS_Context * context, HTS_File * fp);
+
+/* HTS_Context_save_riff: output RIFF format file */
+void HTS_Context_save_riff(HTS_Context * context, HTS_File * wavfp);
+
+/* HTS_Context_refresh: free memory per one time synthesis */
+void HTS_Context_refresh(HTS_Context * context);
+
+/* HTS_Context_clear: free context (the engine is not freed) */
+void HTS_Context_clear(HTS_Context * context);
+
 /*  -------------------------- vocoder ----------------------------  */
 
 /* HTS_Vocoder: structure for setting of vocoder */
@@ -796,12 +1034,28 @@ typedef struct _HTS_Vocoder {
    int lsp2lpc_size;            /* buffer size of lsp2lpc */
    double *gc2gc_buff;          /* used in gc2gc */
    int gc2gc_size;              /* buffer size for gc2gc */
+   int type;                    /* vocoder type (HTS_VOCODER_DOUBLE, HTS_VOCODER_FLOAT or HTS_VOCODER_FLOAT_C) */
+   int kernel;                  /* kernel of the single precision MLSA filter (selected by CPU features) */
+   float *fbuff;                /* buffer of the single precision MLSA/MGLSA filter */
+   float *fc, *finc;            /* filter coefficients and their increments (single precision) */
+   float *fd1, *fd2;            /* delay lines (single precision), fd2 is the FIR filters of all pade stages in lanes */
+   float *fin, *fout;           /* input and output of the lanes */
+   float *fx;                   /* excitation and speech of one frame (single precision) */
+   int fpos;                    /* position of the delay lines in their ring buffers */
 } HTS_Vocoder;
 
+/* vocoder types */
+#define HTS_VOCODER_DOUBLE  0   /* sample by sample in double precision (reference) */
+#define HTS_VOCODER_FLOAT   1   /* frame by frame in single precision, with SIMD selected by CPU features */
+#define HTS_VOCODER_FLOAT_C 2   /* frame by frame in single precision, without SIMD */
+
 /*  ----------------------- vocoder method ------------------------  */
 
 /* HTS_Vocoder_initialize: initialize vocoder */
-void HTS_Vocoder_initialize(HTS_Vocoder * v, const int m, const int stage, HTS_Boolean use_log_gain, const int rate, const int fperiod);
+void HTS_Vocoder_initialize(HTS_Vocoder * v, const int m, const int stage, HTS_Boolean use_log_gain, const int rate, const int fperiod, const int type);
+
+/* HTS_Vocoder_get_kernel_name: get name of the filter kernel used by the vocoder type on this CPU */
+const char *HTS_Vocoder_get_kernel_name(const int type);
 
 /* HTS_Vocoder_synthesize: pulse/noise excitation and MLSA/MGLSA filster based waveform synthesis */
 void HTS_Vocoder_synthesize(HTS_Vocoder * v, const int m, double lf0, double *spectrum, const int nlpf, double *lpf, double alpha, double beta, double volume, short *rawdata, HTS_Audio * audio);
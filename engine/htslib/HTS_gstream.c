@@ -66,20 +66,38 @@ void HTS_GStreamSet_initialize(HTS_GStreamSet * gss)
    gss->total_nsample = 0;
    gss->gstream = NULL;
    gss->gspeech = NULL;
+   gss->user_gspeech = FALSE;
+}
+
+/* HTS_GStreamSet_set_speech_buffer: generate speech into the buffer provided by user, which should hold fperiod * total_frame samples */
+void HTS_GStreamSet_set_speech_buffer(HTS_GStreamSet * gss, short *speech)
+{
+   if (gss->gspeech && gss->user_gspeech == FALSE)
+      HTS_free(gss->gspeech);
+   gss->gspeech = speech;
+   gss->user_gspeech = (speech != NULL) ? TRUE : FALSE;
 }
 
 /* HTS_GStreamSet_create: generate speech */
 /* (stream[0] == spectrum && stream[1] == lf0) */
-HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, int stage, HTS_Boolean use_log_gain, int sampling_rate, int fperiod, double alpha, double beta, HTS_Boolean * stop, double volume, HTS_Audio * audio)
+HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, int stage, HTS_Boolean use_log_gain, int sampling_rate, int fperiod, double alpha, double beta, HTS_Boolean * stop, double volume, int vocoder_type, HTS_Audio * audio)
+{
+   return HTS_GStreamSet_create_incremental(gss, pss, stage, use_log_gain, sampling_rate, fperiod, alpha, beta, stop, volume, vocoder_type, audio, 0, NULL, NULL);
+}
+
+/* HTS_GStreamSet_create_incremental: generate speech chunk by chunk, callback is called after every chunk_frame frames are synthesized */
+/* (stream[0] == spectrum && stream[1] == lf0) */
+HTS_Boolean HTS_GStreamSet_create_incremental(HTS_GStreamSet * gss, HTS_PStreamSet * pss, int stage, HTS_Boolean use_log_gain, int sampling_rate, int fperiod, double alpha, double beta, HTS_Boolean * stop, double volume, int vocoder_type, HTS_Audio * audio, int chunk_frame, HTS_GStreamCallback callback, void *user_data)
 {
    int i, j, k;
-   int msd_frame;
+   int start, end;
+   int *msd_frame;
    HTS_Vocoder v;
    int nlpf = 0;
    double *lpf = NULL;
 
    /* check */
-   if (gss->gstream || gss->gspeech) {
+   if (gss->gstream || (gss->gspeech && gss->user_gspeech == FALSE)) {
       HTS_error(1, "HTS_GStreamSet_create: HTS_GStreamSet is not initialized.\n");
       return FALSE;
    }
@@ -95,25 +113,8 @@ HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, in
       for (j = 0; j < gss->total_frame; j++)
          gss->gstream[i].par[j] = (double *) HTS_calloc(gss->gstream[i].static_length, sizeof(double));
    }
-   gss->gspeech = (short *) HTS_calloc(gss->total_nsample, sizeof(short));
-
-   /* copy generated parameter */
-   for (i = 0; i < gss->nstream; i++) {
-      if (HTS_PStreamSet_is_msd(pss, i)) {      /* for MSD */
-         for (j = 0, msd_frame = 0; j < gss->total_frame; j++)
-            if (HTS_PStreamSet_get_msd_flag(pss, i, j)) {
-               for (k = 0; k < gss->gstream[i].static_length; k++)
-                  gss->gstream[i].par[j][k] = HTS_PStreamSet_get_parameter(pss, i, msd_frame, k);
-               msd_frame++;
-            } else
-               for (k = 0; k < gss->gstream[i].static_length; k++)
-                  gss->gstream[i].par[j][k] = LZERO;
-      } else {                  /* for non MSD */
-         for (j = 0; j < gss->total_frame; j++)
-            for (k = 0; k < gss->gstream[i].static_length; k++)
-               gss->gstream[i].par[j][k] = HTS_PStreamSet_get_parameter(pss, i, j, k);
-      }
-   }
+   if (gss->user_gspeech == FALSE)
+      gss->gspeech = (short *) HTS_calloc(gss->total_nsample, sizeof(short));
 
    /* check */
    if (gss->nstream != 2 && gss->nstream != 3) {
@@ -132,16 +133,48 @@ HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, in
       return FALSE;
    }
 
+   /* whole utterance is one chunk if chunk size is not specified */
+   if (chunk_frame <= 0)
+      chunk_frame = gss->total_frame;
+   msd_frame = (int *) HTS_calloc(gss->nstream, sizeof(int));
+
    /* synthesize speech waveform */
-   HTS_Vocoder_initialize(&v, gss->gstream[0].static_length - 1, stage, use_log_gain, sampling_rate, fperiod);
+   HTS_Vocoder_initialize(&v, gss->gstream[0].static_length - 1, stage, use_log_gain, sampling_rate, fperiod, vocoder_type);
    if (gss->nstream >= 3)
       nlpf = (gss->gstream[2].static_length - 1) / 2;
-   for (i = 0; i < gss->total_frame && (*stop) == FALSE; i++) {
-      if (gss->nstream >= 3)
-         lpf = &gss->gstream[2].par[i][0];
-      HTS_Vocoder_synthesize(&v, gss->gstream[0].static_length - 1, gss->gstream[1].par[i][0], &gss->gstream[0].par[i][0], nlpf, lpf, alpha, beta, volume, &gss->gspeech[i * fperiod], audio);
+   for (start = 0; start < gss->total_frame && (*stop) == FALSE; start = end) {
+      end = (start + chunk_frame < gss->total_frame) ? start + chunk_frame : gss->total_frame;
+
+      /* generate and copy parameter of current chunk */
+      HTS_PStreamSet_generate_until(pss, end);
+      for (i = 0; i < gss->nstream; i++) {
+         if (HTS_PStreamSet_is_msd(pss, i)) {   /* for MSD */
+            for (j = start; j < end; j++)
+               if (HTS_PStreamSet_get_msd_flag(pss, i, j)) {
+                  for (k = 0; k < gss->gstream[i].static_length; k++)
+                     gss->gstream[i].par[j][k] = HTS_PStreamSet_get_parameter(pss, i, msd_frame[i], k);
+                  msd_frame[i]++;
+               } else
+                  for (k = 0; k < gss->gstream[i].static_length; k++)
+                     gss->gstream[i].par[j][k] = LZERO;
+         } else {               /* for non MSD */
+            for (j = start; j < end; j++)
+               for (k = 0; k < gss->gstream[i].static_length; k++)
+                  gss->gstream[i].par[j][k] = HTS_PStreamSet_get_parameter(pss, i, j, k);
+         }
+      }
+
+      /* vocode current chunk */
+      for (i = start; i < end && (*stop) == FALSE; i++) {
+         if (gss->nstream >= 3)
+            lpf = &gss->gstream[2].par[i][0];
+         HTS_Vocoder_synthesize(&v, gss->gstream[0].static_length - 1, gss->gstream[1].par[i][0], &gss->gstream[0].par[i][0], nlpf, lpf, alpha, beta, volume, &gss->gspeech[i * fperiod], audio);
+      }
+      if (callback && callback(&gss->gspeech[start * fperiod], (i - start) * fperiod, user_data) == FALSE)
+         (*stop) = TRUE;
    }
    HTS_Vocoder_clear(&v);
+   HTS_free(msd_frame);
    if (audio)
       HTS_Audio_flush(audio);
 
@@ -191,7 +224,7 @@ void HTS_GStreamSet_clear(HTS_GStreamSet * gss)
       }
       HTS_free(gss->gstream);
    }
-   if (gss->gspeech)
+   if (gss->gspeech && gss->user_gspeech == FALSE)
       HTS_free(gss->gspeech);
    HTS_GStreamSet_initialize(gss);
 }
@@ -78,6 +78,9 @@ int HTS_fgetc(HTS_File * fp);
 /* HTS_feof: wrapper for feof */
 int HTS_feof(HTS_File * fp);
 
+/* HTS_fwrite: wrapper for fwrite */
+size_t HTS_fwrite(const void *buf, size_t size, size_t n, HTS_File * fp);
+
 /* HTS_get_pattern_token: get pattern token */
 HTS_Boolean HTS_get_pattern_token(HTS_File * fp, char *buff);
 
@@ -105,9 +108,90 @@ double **HTS_alloc_matrix(const int x, const int y);
 /* HTS_free_matrix: free double matrix */
 void HTS_free_matrix(double **p, const int x);
 
+/* HTS_realloc: wrapper for realloc */
+char *HTS_realloc(void *p, const size_t size);
+
 /* HTS_Free: wrapper for free */
 void HTS_free(void *p);
 
+/* HTS_Image_initialize: initialize voice image */
+void HTS_Image_initialize(HTS_Image * image);
+
+/* HTS_Image_open: map file into memory read-only */
+HTS_Boolean HTS_Image_open(HTS_Image * image, const char *name);
+
+/* HTS_Image_close: unmap file */
+void HTS_Image_close(HTS_Image * image);
+
+/*  -------------------------- model ------------------------------  */
+
+/* type of compiled pattern */
+#define HTS_PATTERN_WILDCARD  0 /* general pattern with '*' inside */
+#define HTS_PATTERN_ANY       1 /* "*" */
+#define HTS_PATTERN_EXACT     2 /* "xxx" */
+#define HTS_PATTERN_PREFIX    3 /* "xxx*" */
+#define HTS_PATTERN_SUFFIX    4 /* "*xxx" */
+#define HTS_PATTERN_SUBSTRING 5 /* "*xxx*" */
+                                /* xxx may have '?' matching any character */
+
+/* bits of each word of context features */
+#define HTS_FEATURE_WORD_BITS 32
+
+/* compiled voice image */
+#define HTS_IMAGE_MAGIC      "CSTHTSV"  /* magic string identifying the image */
+#define HTS_IMAGE_VERSION    2  /* version of the format of the image */
+#define HTS_IMAGE_BYTE_ORDER 0x01020304 /* byte order mark, the image is always little-endian */
+#define HTS_IMAGE_ALIGN      16 /* alignment of each section */
+
+/* HTS_ImageHeader: Header of compiled voice image. */
+/* The image consists of the header and aligned sections of flat arrays, which are used directly */
+/* by HTS_Model after the image is mapped. All offsets are counted from the beginning of the image, */
+/* and offset 0 means the section is empty. */
+typedef struct _HTS_ImageHeader {
+   char magic[8];               /* HTS_IMAGE_MAGIC */
+   int version;                 /* HTS_IMAGE_VERSION */
+   int byte_order;              /* HTS_IMAGE_BYTE_ORDER */
+   int size;                    /* size of the image */
+   int nstream;                 /* # of streams */
+   int nstate;                  /* # of HMM states */
+   int duration;                /* offset of HTS_ImageStream of duration */
+   int stream;                  /* offset of HTS_ImageStream array of parameter streams */
+   int gv;                      /* offset of HTS_ImageStream array of GV streams */
+   int gv_switch;               /* offset of HTS_ImageModel of GV switch */
+} HTS_ImageHeader;
+
+/* HTS_ImageStream: Stream in compiled voice image. */
+typedef struct _HTS_ImageStream {
+   int vector_length;           /* vector length (include static and dynamic features) */
+   int msd_flag;                /* flag for MSD */
+   int interpolation_size;      /* # of models for interpolation */
+   int model;                   /* offset of HTS_ImageModel array */
+   int window_size;             /* # of windows */
+   int window_width;            /* offset of left widths followed by right widths of windows (int) */
+   int window_coefficient;      /* offset of coefficients of all windows (double) */
+   int ncoefficient;            /* # of coefficients of all windows */
+} HTS_ImageStream;
+
+/* HTS_ImageModel: Model in compiled voice image, each offset points to the array of HTS_Model. */
+typedef struct _HTS_ImageModel {
+   int vector_length;           /* HTS_Model.vector_length */
+   int pdf_length;              /* HTS_Model.pdf_length */
+   int ntree;                   /* HTS_Model.ntree */
+   int npdf;                    /* offset of HTS_Model.npdf (ntree) */
+   int pdf_offset;              /* offset of HTS_Model.pdf_offset (ntree) */
+   int pdf;                     /* offset of HTS_Model.pdf */
+   int pdf_size;                /* # of values in HTS_Model.pdf */
+   int tree;                    /* offset of HTS_Model.tree (ntree) */
+   int node;                    /* offset of HTS_Model.node */
+   int nnode;                   /* HTS_Model.nnode */
+   int question;                /* offset of HTS_Model.question */
+   int nquestion;               /* HTS_Model.nquestion */
+   int pattern;                 /* offset of HTS_Model.pattern */
+   int npattern;                /* HTS_Model.npattern */
+   int string;                  /* offset of HTS_Model.string */
+   int nstring;                 /* HTS_Model.nstring */
+} HTS_ImageModel;
+
 /*  -------------------------- pstream ----------------------------  */
 
 /* check variance in finv() */
@@ -162,6 +246,10 @@ void HTS_free(void *p);
 #define MULGFLG2 FALSE
 #define NGAIN    FALSE
 
+/* for single precision MLSA/MGLSA filter */
+#define FLANES  8               /* number of lanes for the pade stages of MLSA filter (>= PADEORDER) */
+#define FWINDOW 256             /* number of samples the delay lines slide in their ring buffers before wrapping */
+
 HTS_HIDDEN_H_END;
 
 #endif                          /* !HTS_HIDDEN_H */
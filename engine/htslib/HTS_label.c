@@ -57,6 +57,7 @@ HTS_LABEL_C_START;
 
 #include <stdlib.h>             /* for atof() */
 #include <ctype.h>              /* for isgraph(),isdigit() */
+#include <string.h>             /* for memcpy() */
 
 /* hts_engine libraries */
 #include "HTS_hidden.h"
@@ -78,6 +79,8 @@ void HTS_Label_initialize(HTS_Label * label)
    label->size = 0;
    label->frame_flag = FALSE;
    label->speech_speed = 1.0;
+   label->feature = NULL;
+   label->feature_size = 0;
 }
 
 /* HTS_Label_check_time: check label */
@@ -244,6 +247,80 @@ void HTS_Label_load_from_string_list(HTS_Label * label, int sampling_rate, int f
    HTS_Label_check_time(label);
 }
 
+/* HTS_Label_load_from_context_list: load label from context names and times (in 100ns, negative if not specified) */
+void HTS_Label_load_from_context_list(HTS_Label * label, int sampling_rate, int fperiod, char **name, double *start, double *end, int size)
+{
+   HTS_LabelString *lstring = NULL;
+   int i;
+   const double rate = (double) sampling_rate / ((double) fperiod * 1e+7);
+
+   if (label->head || label->size != 0) {
+      HTS_error(1, "HTS_Label_load_from_context_list: label list is not initialized.\n");
+      return;
+   }
+   /* copy label */
+   for (i = 0; i < size; i++) {
+      if (!isgraph((int) name[i][0]))
+         break;
+      label->size++;
+
+      if (lstring) {
+         lstring->next = (HTS_LabelString *) HTS_calloc(1, sizeof(HTS_LabelString));
+         lstring = lstring->next;
+      } else {                  /* first time */
+         lstring = (HTS_LabelString *) HTS_calloc(1, sizeof(HTS_LabelString));
+         label->head = lstring;
+      }
+      if (start != NULL && end != NULL && start[i] >= 0.0 && end[i] >= 0.0) {   /* has frame infomation */
+         lstring->start = rate * start[i];
+         lstring->end = rate * end[i];
+      } else {
+         lstring->start = -1.0;
+         lstring->end = -1.0;
+      }
+      lstring->name = HTS_strdup(name[i]);
+      lstring->next = NULL;
+   }
+   HTS_Label_check_time(label);
+}
+
+/* HTS_Label_load_from_feature_list: load label from context features, names (NULL if not used) and times (in 100ns, negative if not specified) */
+void HTS_Label_load_from_feature_list(HTS_Label * label, int sampling_rate, int fperiod, unsigned int *feature, int feature_size, char **name, double *start, double *end, int size)
+{
+   HTS_LabelString *lstring = NULL;
+   int i;
+   const double rate = (double) sampling_rate / ((double) fperiod * 1e+7);
+
+   if (label->head || label->size != 0) {
+      HTS_error(1, "HTS_Label_load_from_feature_list: label list is not initialized.\n");
+      return;
+   }
+   /* copy label without parsing the names, which are only kept for output */
+   for (i = 0; i < size; i++) {
+      label->size++;
+
+      if (lstring) {
+         lstring->next = (HTS_LabelString *) HTS_calloc(1, sizeof(HTS_LabelString));
+         lstring = lstring->next;
+      } else {                  /* first time */
+         lstring = (HTS_LabelString *) HTS_calloc(1, sizeof(HTS_LabelString));
+         label->head = lstring;
+      }
+      if (start != NULL && end != NULL && start[i] >= 0.0 && end[i] >= 0.0) {   /* has frame infomation */
+         lstring->start = rate * start[i];
+         lstring->end = rate * end[i];
+      } else {
+         lstring->start = -1.0;
+         lstring->end = -1.0;
+      }
+      lstring->name = (name != NULL) ? HTS_strdup(name[i]) : NULL;
+      lstring->next = NULL;
+   }
+   HTS_Label_set_feature_size(label, feature_size);
+   memcpy(label->feature, feature, label->size * feature_size * sizeof(unsigned int));
+   HTS_Label_check_time(label);
+}
+
 /* HTS_Label_set_frame_specified_flag: set frame specified flag */
 void HTS_Label_set_frame_specified_flag(HTS_Label * label, HTS_Boolean i)
 {
@@ -263,7 +340,7 @@ int HTS_Label_get_size(HTS_Label * label)
    return label->size;
 }
 
-/* HTS_Label_get_string: get label string */
+/* HTS_Label_get_string: get label string (NULL if label is loaded from context features without names) */
 char *HTS_Label_get_string(HTS_Label * label, int string_index)
 {
    HTS_LabelString *lstring = label->head;
@@ -275,6 +352,33 @@ char *HTS_Label_get_string(HTS_Label * label, int string_index)
    return lstring->name;
 }
 
+/* HTS_Label_set_feature_size: allocate context features of all label strings, which are cleared to 0 */
+void HTS_Label_set_feature_size(HTS_Label * label, int feature_size)
+{
+   if (label->feature)
+      HTS_free(label->feature);
+   label->feature_size = feature_size;
+   label->feature = (unsigned int *) HTS_calloc(label->size * feature_size + 1, sizeof(unsigned int));
+}
+
+/* HTS_Label_get_feature: get context features of label string (NULL if not allocated) */
+unsigned int *HTS_Label_get_feature(HTS_Label * label, int string_index)
+{
+   if (label->feature == NULL || string_index < 0 || string_index >= label->size)
+      return NULL;
+   return &label->feature[string_index * label->feature_size];
+}
+
+/* HTS_Label_test_feature: test bit of context features of label string (FALSE if not allocated) */
+HTS_Boolean HTS_Label_test_feature(HTS_Label * label, int string_index, int bit)
+{
+   const unsigned int *feature = HTS_Label_get_feature(label, string_index);
+
+   if (feature == NULL || bit < 0)
+      return FALSE;
+   return (feature[bit / HTS_FEATURE_WORD_BITS] >> (bit % HTS_FEATURE_WORD_BITS)) & 1U ? TRUE : FALSE;
+}
+
 /* HTS_Label_get_frame_specified_flag: get frame specified flag */
 HTS_Boolean HTS_Label_get_frame_specified_flag(HTS_Label * label)
 {
@@ -318,9 +422,12 @@ void HTS_Label_clear(HTS_Label * label)
 
    for (lstring = label->head; lstring; lstring = next_lstring) {
       next_lstring = lstring->next;
-      HTS_free(lstring->name);
+      if (lstring->name)
+         HTS_free(lstring->name);
       HTS_free(lstring);
    }
+   if (label->feature)
+      HTS_free(label->feature);
    HTS_Label_initialize(label);
 }
 
@@ -58,6 +58,14 @@ HTS_MISC_C_START;
 #include <stdlib.h>             /* for exit(),calloc(),free() */
 #include <stdarg.h>             /* for va_list */
 #include <string.h>             /* for strcpy(),strlen() */
+#if defined(_WIN32) || defined(WIN32)
+#include <windows.h>            /* for CreateFileMapping(),MapViewOfFile() */
+#else
+#include <sys/mman.h>           /* for mmap(),munmap() */
+#include <sys/stat.h>           /* for fstat() */
+#include <fcntl.h>              /* for open() */
+#include <unistd.h>             /* for close() */
+#endif                          /* _WIN32 || WIN32 */
 
 /* hts_engine libraries */
 #include "HTS_hidden.h"
@@ -287,6 +295,29 @@ int HTS_fwrite_little_endian(void *p, const int size, const int num, HTS_File *
    return block;
 }
 
+/* HTS_alloc_count: number of memory allocations of the current thread, */
+/*                  which are not counted if tracing is disabled or threads have no local storage (Windows CE) */
+#if defined(CST_DISABLE_TRACE) || defined(WINCE)
+#define HTS_COUNT_ALLOC()
+#else
+#if defined(_MSC_VER)
+static __declspec(thread) unsigned long HTS_alloc_count = 0;
+#else
+static __thread unsigned long HTS_alloc_count = 0;
+#endif                          /* _MSC_VER */
+#define HTS_COUNT_ALLOC() HTS_alloc_count++
+#endif                          /* CST_DISABLE_TRACE || WINCE */
+
+/* HTS_get_alloc_count: number of memory allocations (calloc and realloc) of the current thread since it started */
+unsigned long HTS_get_alloc_count(void)
+{
+#if defined(CST_DISABLE_TRACE) || defined(WINCE)
+   return 0;
+#else
+   return HTS_alloc_count;
+#endif                          /* CST_DISABLE_TRACE || WINCE */
+}
+
 /* HTS_calloc: wrapper for calloc */
 char *HTS_calloc(const size_t num, const size_t size)
 {
@@ -296,12 +327,29 @@ char *HTS_calloc(const size_t num, const size_t size)
    char *mem = (char *) calloc(num, size);
 #endif                          /* FESTIVAL */
 
+   HTS_COUNT_ALLOC();
    if (mem == NULL)
       HTS_error(1, "HTS_calloc: Cannot allocate memory.\n");
 
    return mem;
 }
 
+/* HTS_realloc: wrapper for realloc */
+char *HTS_realloc(void *ptr, const size_t size)
+{
+#ifdef FESTIVAL
+   char *mem = (char *) safe_wrealloc(ptr, size);
+#else
+   char *mem = (char *) realloc(ptr, size);
+#endif                          /* FESTIVAL */
+
+   HTS_COUNT_ALLOC();
+   if (mem == NULL && size > 0)
+      HTS_error(1, "HTS_realloc: Cannot allocate memory.\n");
+
+   return mem;
+}
+
 /* HTS_Free: wrapper for free */
 void HTS_free(void *ptr)
 {
@@ -345,6 +393,85 @@ void HTS_free_matrix(double **p, const int x)
    HTS_free(p);
 }
 
+/* HTS_Image_initialize: initialize voice image */
+void HTS_Image_initialize(HTS_Image * image)
+{
+   image->data = NULL;
+   image->size = 0;
+   image->file = NULL;
+   image->mapping = NULL;
+}
+
+/* HTS_Image_open: map file into memory read-only, the pages are shared by all processes mapping the same file */
+HTS_Boolean HTS_Image_open(HTS_Image * image, const char *name)
+{
+#if defined(_WIN32) || defined(WIN32)
+   HANDLE file, mapping;
+   LARGE_INTEGER size;
+   void *data;
+
+   HTS_Image_close(image);
+   file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+   if (file == INVALID_HANDLE_VALUE)
+      return FALSE;
+   if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 || (unsigned long long) size.QuadPart > (size_t) - 1) {
+      CloseHandle(file);
+      return FALSE;
+   }
+   mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+   if (mapping == NULL) {
+      CloseHandle(file);
+      return FALSE;
+   }
+   data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+   if (data == NULL) {
+      CloseHandle(mapping);
+      CloseHandle(file);
+      return FALSE;
+   }
+   image->data = (char *) data;
+   image->size = (size_t) size.QuadPart;
+   image->file = file;
+   image->mapping = mapping;
+   return TRUE;
+#else
+   int fd;
+   struct stat st;
+   void *data;
+
+   HTS_Image_close(image);
+   fd = open(name, O_RDONLY);
+   if (fd < 0)
+      return FALSE;
+   if (fstat(fd, &st) != 0 || st.st_size == 0) {
+      close(fd);
+      return FALSE;
+   }
+   data = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);                   /* mapping is kept after the file is closed */
+   if (data == MAP_FAILED)
+      return FALSE;
+   image->data = (char *) data;
+   image->size = (size_t) st.st_size;
+   return TRUE;
+#endif                          /* _WIN32 || WIN32 */
+}
+
+/* HTS_Image_close: unmap file */
+void HTS_Image_close(HTS_Image * image)
+{
+   if (image->data == NULL)
+      return;
+#if defined(_WIN32) || defined(WIN32)
+   UnmapViewOfFile(image->data);
+   CloseHandle((HANDLE) image->mapping);
+   CloseHandle((HANDLE) image->file);
+#else
+   munmap(image->data, image->size);
+#endif                          /* _WIN32 || WIN32 */
+   HTS_Image_initialize(image);
+}
+
 HTS_MISC_C_END;
 
 #endif                          /* !HTS_MISC_C */
@@ -118,6 +118,79 @@ static HTS_Boolean HTS_pattern_match(const char *string, const char *pattern)
       return HTS_dp_match(string, pattern, 0, (int) (strlen(string) - max));
 }
 
+/* HTS_grow: reallocate array so that given number of elements can be added, capacity is kept as power of 2 */
+static void *HTS_grow(void *p, const int num, const int add, const size_t size)
+{
+   int capacity, required;
+
+   for (capacity = 1; capacity < num; capacity *= 2);
+   if (num == 0)
+      capacity = 0;
+   for (required = 1; required < num + add; required *= 2);
+   if (required > capacity)
+      p = HTS_realloc(p, required * size);
+
+   return p;
+}
+
+/* HTS_add_string: add string into string pool, return its offset */
+static int HTS_add_string(char **pool, int *size, const char *string, const int length)
+{
+   const int offset = *size;
+
+   *pool = (char *) HTS_grow(*pool, *size, length + 1, sizeof(char));
+   memcpy(&(*pool)[offset], string, length);
+   (*pool)[offset + length] = '\0';
+   *size += length + 1;
+
+   return offset;
+}
+
+/* HTS_Model_add_string: add string into string pool of model, return its offset */
+static int HTS_Model_add_string(HTS_Model * model, const char *string, const int length)
+{
+   return HTS_add_string(&model->string, &model->nstring, string, length);
+}
+
+/* HTS_pattern_type: classify pattern, and get offset and length of its body without leading and trailing '*' */
+/* Patterns are classified so that most patterns can be matched without recursion */
+static int HTS_pattern_type(const char *string, int *first, int *length)
+{
+   int i, last;
+   const int string_length = strlen(string);
+
+   *first = (string_length > 0 && string[0] == '*') ? 1 : 0;
+   last = (string_length > *first && string[string_length - 1] == '*') ? 1 : 0;
+   *length = string_length - *first - last;
+   for (i = *first; i < string_length - last; i++)
+      if (string[i] == '*')
+         return HTS_PATTERN_WILDCARD;
+   if (*first && *length == 0)
+      return HTS_PATTERN_ANY;
+   else if (*first)
+      return last ? HTS_PATTERN_SUBSTRING : HTS_PATTERN_SUFFIX;
+   else
+      return last ? HTS_PATTERN_PREFIX : HTS_PATTERN_EXACT;
+}
+
+/* HTS_Model_add_pattern: compile pattern and add it into model */
+static void HTS_Model_add_pattern(HTS_Model * model, const char *string)
+{
+   int first, length;
+   HTS_Pattern *pattern;
+
+   model->pattern = (HTS_Pattern *) HTS_grow(model->pattern, model->npattern, 1, sizeof(HTS_Pattern));
+   pattern = &model->pattern[model->npattern++];
+   pattern->string = HTS_Model_add_string(model, string, strlen(string));
+   pattern->type = HTS_pattern_type(string, &first, &length);
+   pattern->body = pattern->string;
+   pattern->length = 0;
+   if (pattern->type == HTS_PATTERN_WILDCARD)
+      return;
+   pattern->length = length;
+   pattern->body = HTS_Model_add_string(model, &string[first], length);
+}
+
 /* HTS_is_num: check given buffer is number or not */
 static HTS_Boolean HTS_is_num(const char *buff)
 {
@@ -156,89 +229,55 @@ static int HTS_get_state_num(char *string)
    return atoi(string);
 }
 
-static void HTS_Question_clear(HTS_Question * question);
-
-/* HTS_Question_load: Load questions from file */
-static HTS_Boolean HTS_Question_load(HTS_Question * question, HTS_File * fp)
+/* HTS_Question_load: load question from file and add it into model */
+static HTS_Boolean HTS_Question_load(HTS_Model * model, HTS_File * fp)
 {
    char buff[HTS_MAXBUFLEN];
-   HTS_Pattern *pattern, *last_pattern;
+   HTS_Question *question;
+   int string;
 
-   if (question == NULL || fp == NULL)
+   if (model == NULL || fp == NULL)
       return FALSE;
 
    /* get question name */
    if (HTS_get_pattern_token(fp, buff) == FALSE)
       return FALSE;
-   question->string = HTS_strdup(buff);
-   question->head = NULL;
+   string = HTS_Model_add_string(model, buff, strlen(buff));
    /* get pattern list */
-   if (HTS_get_pattern_token(fp, buff) == FALSE) {
-      free(question->string);
-      question->string = NULL;
+   if (HTS_get_pattern_token(fp, buff) == FALSE)
       return FALSE;
-   }
-   last_pattern = NULL;
+   model->question = (HTS_Question *) HTS_grow(model->question, model->nquestion, 1, sizeof(HTS_Question));
+   question = &model->question[model->nquestion];
+   question->string = string;
+   question->pattern = model->npattern;
+   question->npattern = 0;
    if (strcmp(buff, "{") == 0) {
       while (1) {
-         if (HTS_get_pattern_token(fp, buff) == FALSE) {
-            HTS_Question_clear(question);
+         if (HTS_get_pattern_token(fp, buff) == FALSE)
             return FALSE;
-         }
-         pattern = (HTS_Pattern *) HTS_calloc(1, sizeof(HTS_Pattern));
-         if (question->head)
-            last_pattern->next = pattern;
-         else                   /* first time */
-            question->head = pattern;
-         pattern->string = HTS_strdup(buff);
-         pattern->next = NULL;
-         if (HTS_get_pattern_token(fp, buff) == FALSE) {
-            HTS_Question_clear(question);
+         HTS_Model_add_pattern(model, buff);
+         question->npattern++;
+         if (HTS_get_pattern_token(fp, buff) == FALSE)
             return FALSE;
-         }
          if (!strcmp(buff, "}"))
             break;
-         last_pattern = pattern;
       }
    }
+   model->nquestion++;
    return TRUE;
 }
 
-/* HTS_Question_match: check given string match given question */
-static HTS_Boolean HTS_Question_match(const HTS_Question * question, const char *string)
-{
-   HTS_Pattern *pattern;
-
-   for (pattern = question->head; pattern; pattern = pattern->next)
-      if (HTS_pattern_match(string, pattern->string))
-         return TRUE;
-
-   return FALSE;
-}
-
-/* HTS_Question_find_question: find question from question list */
-static HTS_Question *HTS_Question_find_question(HTS_Question * question, const char *buff)
+/* HTS_Question_find_question: find index of question from questions of model */
+static int HTS_Question_find_question(const HTS_Model * model, const char *buff)
 {
+   int i;
 
-   for (; question; question = question->next)
-      if (strcmp(buff, question->string) == 0)
-         return question;
+   for (i = 0; i < model->nquestion; i++)
+      if (strcmp(buff, &model->string[model->question[i].string]) == 0)
+         return i;
 
    HTS_error(1, "HTS_Question_find_question: Cannot find question %s.\n", buff);
-   return NULL;                 /* make compiler happy */
-}
-
-/* HTS_Question_clear: clear loaded question */
-static void HTS_Question_clear(HTS_Question * question)
-{
-   HTS_Pattern *pattern, *next_pattern;
-
-   HTS_free(question->string);
-   for (pattern = question->head; pattern; pattern = next_pattern) {
-      next_pattern = pattern->next;
-      HTS_free(pattern->string);
-      HTS_free(pattern);
-   }
+   return -1;                   /* make compiler happy */
 }
 
 /* HTS_Node_find: find node for given number */
@@ -255,6 +294,8 @@ static HTS_Node *HTS_Node_find(HTS_Node * node, const int num)
 /* HTS_Node_clear: recursive function to free Node */
 static void HTS_Node_clear(HTS_Node * node)
 {
+   if (node == NULL)
+      return;
    if (node->yes != NULL)
       HTS_Node_clear(node->yes);
    if (node->no != NULL)
@@ -262,14 +303,13 @@ static void HTS_Node_clear(HTS_Node * node)
    HTS_free(node);
 }
 
-/* HTS_Tree_parse_pattern: parse pattern specified for each tree */
-static void HTS_Tree_parse_pattern(HTS_Tree * tree, char *string)
+/* HTS_Tree_parse_pattern: parse pattern specified for each tree and add them into model */
+static void HTS_Tree_parse_pattern(HTS_Model * model, HTS_Tree * tree, char *string)
 {
    char *left, *right;
-   HTS_Pattern *pattern, *last_pattern;
 
-   tree->head = NULL;
-   last_pattern = NULL;
+   tree->pattern = model->npattern;
+   tree->npattern = 0;
    /* parse tree pattern */
    if ((left = strchr(string, '{')) != NULL) {  /* pattern is specified */
       string = left + 1;
@@ -283,64 +323,96 @@ static void HTS_Tree_parse_pattern(HTS_Tree * tree, char *string)
 
       /* parse pattern */
       while ((left = strchr(string, ',')) != NULL) {
-         pattern = (HTS_Pattern *) HTS_calloc(1, sizeof(HTS_Pattern));
-         if (tree->head) {
-            last_pattern->next = pattern;
-         } else {
-            tree->head = pattern;
-         }
          *left = '\0';
-         pattern->string = HTS_strdup(string);
+         HTS_Model_add_pattern(model, string);
+         tree->npattern++;
          string = left + 1;
-         pattern->next = NULL;
-         last_pattern = pattern;
       }
    }
 }
 
-static void HTS_Tree_clear(HTS_Tree * tree);
+/* HTS_Node_count: count non-leaf nodes and number them in depth-first order */
+static int HTS_Node_count(HTS_Node * node, int nnode)
+{
+   if (node == NULL || node->yes == NULL)
+      return nnode;
+   node->index = nnode++;
+   nnode = HTS_Node_count(node->no, nnode);
+   return HTS_Node_count(node->yes, nnode);
+}
+
+/* HTS_Node_flatten: store non-leaf nodes into flat array */
+static void HTS_Node_flatten(HTS_Node * node, HTS_FlatNode * flat)
+{
+   HTS_Node *child[2];
+   int i;
+
+   if (node == NULL || node->yes == NULL)
+      return;
+   child[0] = node->no;
+   child[1] = node->yes;
+   flat[node->index].quest = node->quest;
+   for (i = 0; i < 2; i++) {
+      if (child[i]->yes == NULL)
+         flat[node->index].child[i] = -child[i]->pdf - 1;
+      else
+         flat[node->index].child[i] = child[i]->index;
+      HTS_Node_flatten(child[i], flat);
+   }
+}
+
+/* HTS_Tree_compile: convert linked nodes to flat array of model and free the linked nodes */
+static HTS_Boolean HTS_Tree_compile(HTS_Model * model, HTS_Tree * tree, HTS_Node * root)
+{
+   tree->node = model->nnode;
+   tree->nnode = HTS_Node_count(root, 0);
+   tree->pdf = root->pdf;
+   if (tree->nnode > 0) {
+      model->node = (HTS_FlatNode *) HTS_grow(model->node, model->nnode, tree->nnode, sizeof(HTS_FlatNode));
+      HTS_Node_flatten(root, &model->node[tree->node]);
+      model->nnode += tree->nnode;
+   }
+   HTS_Node_clear(root);
+
+   return TRUE;
+}
 
 /* HTS_Tree_load: Load trees */
-static HTS_Boolean HTS_Tree_load(HTS_Tree * tree, HTS_File * fp, HTS_Question * question)
+static HTS_Boolean HTS_Tree_load(HTS_Model * model, HTS_Tree * tree, HTS_File * fp)
 {
    char buff[HTS_MAXBUFLEN];
-   HTS_Node *node, *last_node;
+   HTS_Node *root, *node, *last_node;
 
    if (tree == NULL || fp == NULL)
       return FALSE;
 
-   if (HTS_get_pattern_token(fp, buff) == FALSE) {
-      HTS_Tree_clear(tree);
+   if (HTS_get_pattern_token(fp, buff) == FALSE)
       return FALSE;
-   }
    node = (HTS_Node *) HTS_calloc(1, sizeof(HTS_Node));
    node->index = 0;
-   tree->root = last_node = node;
+   root = last_node = node;
 
    if (strcmp(buff, "{") == 0) {
       while (HTS_get_pattern_token(fp, buff) == TRUE && strcmp(buff, "}") != 0) {
          node = HTS_Node_find(last_node, atoi(buff));
          if (node == NULL) {
-            HTS_Tree_clear(tree);
+            HTS_Node_clear(root);
             return FALSE;
          }
          if (HTS_get_pattern_token(fp, buff) == FALSE) {
-            HTS_Tree_clear(tree);
+            HTS_Node_clear(root);
             return FALSE;
          }
-         node->quest = HTS_Question_find_question(question, buff);
-         if (node->quest == NULL) {
-            HTS_Tree_clear(tree);
+         node->quest = HTS_Question_find_question(model, buff);
+         if (node->quest < 0) {
+            HTS_Node_clear(root);
             return FALSE;
          }
          node->yes = (HTS_Node *) HTS_calloc(1, sizeof(HTS_Node));
          node->no = (HTS_Node *) HTS_calloc(1, sizeof(HTS_Node));
 
          if (HTS_get_pattern_token(fp, buff) == FALSE) {
-            node->quest = NULL;
-            free(node->yes);
-            free(node->no);
-            HTS_Tree_clear(tree);
+            HTS_Node_clear(root);
             return FALSE;
          }
          if (HTS_is_num(buff))
@@ -351,10 +423,7 @@ static HTS_Boolean HTS_Tree_load(HTS_Tree * tree, HTS_File * fp, HTS_Question *
          last_node = node->no;
 
          if (HTS_get_pattern_token(fp, buff) == FALSE) {
-            node->quest = NULL;
-            free(node->yes);
-            free(node->no);
-            HTS_Tree_clear(tree);
+            HTS_Node_clear(root);
             return FALSE;
          }
          if (HTS_is_num(buff))
@@ -368,44 +437,36 @@ static HTS_Boolean HTS_Tree_load(HTS_Tree * tree, HTS_File * fp, HTS_Question *
       node->pdf = HTS_name2num(buff);
    }
 
-   return TRUE;
+   return HTS_Tree_compile(model, tree, root);
 }
 
-/* HTS_Node_search: tree search */
-static int HTS_Tree_search_node(HTS_Tree * tree, const char *string)
+/* HTS_Model_test: check any test of given question (or of tree nquestion + tree index) is true for context features */
+static HTS_Boolean HTS_Model_test(const HTS_Model * model, const int index, const unsigned int *feature)
 {
-   HTS_Node *node = tree->root;
+   const HTS_Test *test = &model->test[model->test_offset[index]];
+   const HTS_Test *end = &model->test[model->test_offset[index + 1]];
 
-   while (node != NULL) {
-      if (node->quest == NULL)
-         return node->pdf;
-      if (HTS_Question_match(node->quest, string)) {
-         if (node->yes->pdf > 0)
-            return node->yes->pdf;
-         node = node->yes;
-      } else {
-         if (node->no->pdf > 0)
-            return node->no->pdf;
-         node = node->no;
-      }
-   }
+   for (; test < end; test++)
+      if (feature[test->word] & test->mask)
+         return TRUE;
 
-   HTS_error(1, "HTS_Tree_search_node: Cannot find node.\n");
-   return -1;                   /* make compiler happy */
+   return FALSE;
 }
 
-/* HTS_Tree_clear: clear given tree */
-static void HTS_Tree_clear(HTS_Tree * tree)
+/* HTS_Tree_search_node: tree search by testing context features */
+static int HTS_Tree_search_node(const HTS_Model * model, const HTS_Tree * tree, const unsigned int *feature)
 {
-   HTS_Pattern *pattern, *next_pattern;
+   const HTS_FlatNode *node;
+   int next = 0;
 
-   for (pattern = tree->head; pattern; pattern = next_pattern) {
-      next_pattern = pattern->next;
-      HTS_free(pattern->string);
-      HTS_free(pattern);
-   }
+   if (tree->nnode == 0)
+      return tree->pdf;
+   node = &model->node[tree->node];
+   do {
+      next = node[next].child[HTS_Model_test(model, node[next].quest, feature)];
+   } while (next >= 0);
 
-   HTS_Node_clear(tree->root);
+   return -next - 1;
 }
 
 /* HTS_Window_initialize: initialize dynamic window */
@@ -506,21 +567,40 @@ static void HTS_Window_clear(HTS_Window * win)
 static void HTS_Model_initialize(HTS_Model * model)
 {
    model->vector_length = 0;
+   model->pdf_length = 0;
    model->ntree = 0;
    model->npdf = NULL;
+   model->pdf_offset = NULL;
    model->pdf = NULL;
    model->tree = NULL;
+   model->node = NULL;
+   model->nnode = 0;
    model->question = NULL;
+   model->nquestion = 0;
+   model->pattern = NULL;
+   model->npattern = 0;
+   model->string = NULL;
+   model->nstring = 0;
+   model->test_offset = NULL;
+   model->test = NULL;
+   model->mapped = FALSE;
 }
 
 static void HTS_Model_clear(HTS_Model * model);
 
+/* HTS_Model_get_pdf: get PDF of given tree (starting from 2) and PDF index (starting from 1) */
+static const float *HTS_Model_get_pdf(const HTS_Model * model, const int tree_index, const int pdf_index)
+{
+   return &model->pdf[model->pdf_offset[tree_index - 2] + (pdf_index - 1) * model->pdf_length];
+}
+
 /* HTS_Model_load_pdf: load pdfs */
 static HTS_Boolean HTS_Model_load_pdf(HTS_Model * model, HTS_File * fp, int ntree, HTS_Boolean msd_flag)
 {
    int i, j, k, l, m;
    float temp;
-   int ssize;
+   float *pdf;
+   int ssize, size;
    HTS_Boolean result = TRUE;
 
    /* check */
@@ -535,57 +615,58 @@ static HTS_Boolean HTS_Model_load_pdf(HTS_Model * model, HTS_File * fp, int ntre
    HTS_fread_big_endian(&i, sizeof(int), 1, fp);
    if ((i != 0 || msd_flag != FALSE) && (i != 1 || msd_flag != TRUE)) {
       HTS_error(1, "HTS_Model_load_pdf: Failed to load header of pdfs.\n");
-      HTS_Model_initialize(model);
+      HTS_Model_clear(model);
       return FALSE;
    }
    /* read stream size */
    HTS_fread_big_endian(&ssize, sizeof(int), 1, fp);
    if (ssize < 1) {
       HTS_error(1, "HTS_Model_load_pdf: Failed to load header of pdfs.\n");
-      HTS_Model_initialize(model);
+      HTS_Model_clear(model);
       return FALSE;
    }
    /* read vector size */
    HTS_fread_big_endian(&model->vector_length, sizeof(int), 1, fp);
    if (model->vector_length <= 0) {
       HTS_error(1, "HTS_Model_load_pdf: # of HMM states %d should be positive.\n", model->vector_length);
-      HTS_Model_initialize(model);
+      HTS_Model_clear(model);
       return FALSE;
    }
    model->npdf = (int *) HTS_calloc(ntree, sizeof(int));
-   model->npdf -= 2;
    /* read the number of pdfs */
-   if (HTS_fread_big_endian(&model->npdf[2], sizeof(int), ntree, fp) != ntree)
+   if (HTS_fread_big_endian(model->npdf, sizeof(int), ntree, fp) != ntree)
       result = FALSE;
-   for (i = 2; i <= ntree + 1; i++)
+   for (i = 0; i < ntree; i++)
       if (model->npdf[i] <= 0) {
-         HTS_error(1, "HTS_Model_load_pdf: # of pdfs at %d-th state should be positive.\n", i);
+         HTS_error(1, "HTS_Model_load_pdf: # of pdfs at %d-th state should be positive.\n", i + 2);
          result = FALSE;
          break;
       }
    if (result == FALSE) {
-      model->npdf += 2;
-      free(model->npdf);
-      HTS_Model_initialize(model);
+      HTS_Model_clear(model);
       return FALSE;
    }
-   model->pdf = (double ***) HTS_calloc(ntree, sizeof(double **));
-   model->pdf -= 2;
+   /* PDFs of all trees are stored in one table */
+   model->pdf_length = msd_flag ? 2 * model->vector_length + 1 : 2 * model->vector_length;
+   model->pdf_offset = (int *) HTS_calloc(ntree, sizeof(int));
+   for (i = 0, size = 0; i < ntree; i++) {
+      model->pdf_offset[i] = size;
+      size += model->npdf[i] * model->pdf_length;
+   }
+   model->pdf = (float *) HTS_calloc(size, sizeof(float));
    /* read means and variances */
    if (msd_flag) {              /* for MSD */
-      for (j = 2; j <= ntree + 1; j++) {
-         model->pdf[j] = (double **) HTS_calloc(model->npdf[j], sizeof(double *));
-         model->pdf[j]--;
-         for (k = 1; k <= model->npdf[j]; k++) {
-            model->pdf[j][k] = (double *) HTS_calloc(2 * model->vector_length + 1, sizeof(double));
+      for (j = 0; j < ntree; j++) {
+         for (k = 0; k < model->npdf[j]; k++) {
+            pdf = &model->pdf[model->pdf_offset[j] + k * model->pdf_length];
             for (l = 0; l < ssize; l++) {
                for (m = 0; m < model->vector_length / ssize; m++) {
                   if (HTS_fread_big_endian(&temp, sizeof(float), 1, fp) != 1)
                      result = FALSE;
-                  model->pdf[j][k][l * model->vector_length / ssize + m] = (double) temp;
+                  pdf[l * model->vector_length / ssize + m] = temp;
                   if (HTS_fread_big_endian(&temp, sizeof(float), 1, fp) != 1)
                      result = FALSE;
-                  model->pdf[j][k][l * model->vector_length / ssize + m + model->vector_length] = (double) temp;
+                  pdf[l * model->vector_length / ssize + m + model->vector_length] = temp;
                }
                if (HTS_fread_big_endian(&temp, sizeof(float), 1, fp) != 1)
                   result = FALSE;
@@ -594,7 +675,7 @@ static HTS_Boolean HTS_Model_load_pdf(HTS_Model * model, HTS_File * fp, int ntre
                      HTS_error(1, "HTS_Model_load_pdf: MSD weight should be within 0.0 to 1.0.\n");
                      result = FALSE;
                   }
-                  model->pdf[j][k][2 * model->vector_length] = (double) temp;
+                  pdf[2 * model->vector_length] = temp;
                }
                if (HTS_fread_big_endian(&temp, sizeof(float), 1, fp) != 1)
                   result = FALSE;
@@ -602,18 +683,16 @@ static HTS_Boolean HTS_Model_load_pdf(HTS_Model * model, HTS_File * fp, int ntre
          }
       }
    } else {                     /* for non MSD */
-      for (j = 2; j <= ntree + 1; j++) {
-         model->pdf[j] = (double **) HTS_calloc(model->npdf[j], sizeof(double *));
-         model->pdf[j]--;
-         for (k = 1; k <= model->npdf[j]; k++) {
-            model->pdf[j][k] = (double *) HTS_calloc(2 * model->vector_length, sizeof(double));
+      for (j = 0; j < ntree; j++) {
+         for (k = 0; k < model->npdf[j]; k++) {
+            pdf = &model->pdf[model->pdf_offset[j] + k * model->pdf_length];
             for (l = 0; l < model->vector_length; l++) {
                if (HTS_fread_big_endian(&temp, sizeof(float), 1, fp) != 1)
                   result = FALSE;
-               model->pdf[j][k][l] = (double) temp;
+               pdf[l] = temp;
                if (HTS_fread_big_endian(&temp, sizeof(float), 1, fp) != 1)
                   result = FALSE;
-               model->pdf[j][k][l + model->vector_length] = (double) temp;
+               pdf[l + model->vector_length] = temp;
             }
          }
       }
@@ -629,8 +708,7 @@ static HTS_Boolean HTS_Model_load_pdf(HTS_Model * model, HTS_File * fp, int ntre
 static HTS_Boolean HTS_Model_load_tree(HTS_Model * model, HTS_File * fp)
 {
    char buff[HTS_MAXBUFLEN];
-   HTS_Question *question, *last_question;
-   HTS_Tree *tree, *last_tree;
+   HTS_Tree *tree;
    int state;
 
    /* check */
@@ -640,88 +718,83 @@ static HTS_Boolean HTS_Model_load_tree(HTS_Model * model, HTS_File * fp)
    }
 
    model->ntree = 0;
-   last_question = NULL;
-   last_tree = NULL;
    while (!HTS_feof(fp)) {
       HTS_get_pattern_token(fp, buff);
       /* parse questions */
       if (strcmp(buff, "QS") == 0) {
-         question = (HTS_Question *) HTS_calloc(1, sizeof(HTS_Question));
-         if (HTS_Question_load(question, fp) == FALSE) {
-            free(question);
+         if (HTS_Question_load(model, fp) == FALSE) {
             HTS_Model_clear(model);
             return FALSE;
          }
-         if (model->question)
-            last_question->next = question;
-         else
-            model->question = question;
-         question->next = NULL;
-         last_question = question;
       }
       /* parse trees */
       state = HTS_get_state_num(buff);
       if (state != 0) {
-         tree = (HTS_Tree *) HTS_calloc(1, sizeof(HTS_Tree));
-         tree->next = NULL;
-         tree->root = NULL;
-         tree->head = NULL;
+         model->tree = (HTS_Tree *) HTS_grow(model->tree, model->ntree, 1, sizeof(HTS_Tree));
+         tree = &model->tree[model->ntree];
          tree->state = state;
-         HTS_Tree_parse_pattern(tree, buff);
-         if (HTS_Tree_load(tree, fp, model->question) == FALSE) {
-            free(tree);
+         tree->node = 0;
+         tree->nnode = 0;
+         tree->pdf = 0;
+         HTS_Tree_parse_pattern(model, tree, buff);
+         if (HTS_Tree_load(model, tree, fp) == FALSE) {
             HTS_Model_clear(model);
             return FALSE;
          }
-         if (model->tree)
-            last_tree->next = tree;
-         else
-            model->tree = tree;
-         tree->next = NULL;
-         last_tree = tree;
          model->ntree++;
       }
    }
    /* No Tree information in tree file */
-   if (model->tree == NULL) {
+   if (model->ntree == 0) {
       HTS_error(1, "HTS_Model_load_tree: No trees are loaded.\n");
       return FALSE;
    }
    return TRUE;
 }
 
+/* HTS_Model_find_tree: find index (starting from 2) of tree of given state whose patterns match given context features */
+/* Trees of any state are searched if state_index is negative, and -1 is returned if no tree is found */
+static int HTS_Model_find_tree(const HTS_Model * model, const int state_index, const unsigned int *feature)
+{
+   int i;
+   const HTS_Tree *tree;
+
+   for (i = 0; i < model->ntree; i++) {
+      tree = &model->tree[i];
+      if (state_index >= 0 && tree->state != state_index)
+         continue;
+      if (tree->npattern == 0 || HTS_Model_test(model, model->nquestion + i, feature))
+         return i + 2;
+   }
+
+   return -1;
+}
+
 /* HTS_Model_clear: free pdfs and trees */
 static void HTS_Model_clear(HTS_Model * model)
 {
-   int i, j;
-   HTS_Question *question, *next_question;
-   HTS_Tree *tree, *next_tree;
-
-   for (question = model->question; question; question = next_question) {
-      next_question = question->next;
-      HTS_Question_clear(question);
-      HTS_free(question);
-   }
-   for (tree = model->tree; tree; tree = next_tree) {
-      next_tree = tree->next;
-      HTS_Tree_clear(tree);
-      HTS_free(tree);
-   }
-   if (model->pdf) {
-      for (i = 2; i <= model->ntree + 1; i++) {
-         for (j = 1; j <= model->npdf[i]; j++) {
-            HTS_free(model->pdf[i][j]);
-         }
-         model->pdf[i]++;
-         HTS_free(model->pdf[i]);
-      }
-      model->pdf += 2;
-      HTS_free(model->pdf);
-   }
-   if (model->npdf) {
-      model->npdf += 2;
-      HTS_free(model->npdf);
-   }
+   if (model->mapped == FALSE) {
+      if (model->npdf)
+         HTS_free(model->npdf);
+      if (model->pdf_offset)
+         HTS_free(model->pdf_offset);
+      if (model->pdf)
+         HTS_free(model->pdf);
+      if (model->tree)
+         HTS_free(model->tree);
+      if (model->node)
+         HTS_free(model->node);
+      if (model->question)
+         HTS_free(model->question);
+      if (model->pattern)
+         HTS_free(model->pattern);
+      if (model->string)
+         HTS_free(model->string);
+   }
+   if (model->test_offset)
+      HTS_free(model->test_offset);
+   if (model->test)
+      HTS_free(model->test);
    HTS_Model_initialize(model);
 }
 
@@ -838,6 +911,404 @@ static void HTS_Stream_clear(HTS_Stream * stream)
    HTS_Stream_initialize(stream);
 }
 
+/* HTS_PatternRef: Distinct pattern of models while compiling context features. */
+typedef struct _HTS_PatternRef {
+   const char *string;          /* pattern string in string pool of model */
+   const char *body;            /* pattern string without leading and trailing '*' */
+   const HTS_Pattern *pattern;  /* compiled pattern */
+} HTS_PatternRef;
+
+/* HTS_ValueRef: Value of field while compiling context features. */
+typedef struct _HTS_ValueRef {
+   int field;                   /* index of field */
+   HTS_Boolean wildcard;        /* value has '?' */
+   const char *string;          /* value in pattern string */
+   int length;                  /* length of value */
+   int bit;                     /* bit of pattern */
+} HTS_ValueRef;
+
+/* HTS_set_bit: set bit of context features */
+static void HTS_set_bit(unsigned int *feature, const int bit)
+{
+   feature[bit / HTS_FEATURE_WORD_BITS] |= 1U << (bit % HTS_FEATURE_WORD_BITS);
+}
+
+/* HTS_compare_value: compare value with given length */
+static int HTS_compare_value(const char *string, const int length, const char *value, const int value_length)
+{
+   const int result = memcmp(string, value, length < value_length ? length : value_length);
+
+   return result != 0 ? result : length - value_length;
+}
+
+/* HTS_compare_pattern_ref: compare patterns by strings for qsort() */
+static int HTS_compare_pattern_ref(const void *a, const void *b)
+{
+   return strcmp(((const HTS_PatternRef *) a)->string, ((const HTS_PatternRef *) b)->string);
+}
+
+/* HTS_compare_value_ref: compare values by fields, literal values before values with '?', then by values for qsort() */
+static int HTS_compare_value_ref(const void *a, const void *b)
+{
+   const HTS_ValueRef *x = (const HTS_ValueRef *) a;
+   const HTS_ValueRef *y = (const HTS_ValueRef *) b;
+
+   if (x->field != y->field)
+      return x->field - y->field;
+   if (x->wildcard != y->wildcard)
+      return x->wildcard - y->wildcard;
+   return HTS_compare_value(x->string, x->length, y->string, y->length);
+}
+
+/* HTS_is_delimiter: check given character of pattern can be delimiter of fields in labels */
+static HTS_Boolean HTS_is_delimiter(const char c)
+{
+   return (c != '\0' && c != '*' && c != '?' && !isalnum((unsigned char) c)) ? TRUE : FALSE;
+}
+
+/* HTS_delimiter_length: get length of delimiter at the beginning of string, such as "-" or "/A:" (0 if not delimiter) */
+static int HTS_delimiter_length(const char *string, const int length)
+{
+   int i;
+
+   if (length <= 0 || !HTS_is_delimiter(string[0]))
+      return 0;
+   if (string[0] == '/') {
+      for (i = 1; i < length && isalnum((unsigned char) string[i]); i++);
+      if (i > 1 && i < length && string[i] == ':')
+         return i + 1;
+   }
+   return 1;
+}
+
+/* HTS_delimiter_length_reverse: get length of delimiter at the end of string (0 if not delimiter) */
+static int HTS_delimiter_length_reverse(const char *string, const int length)
+{
+   int i;
+
+   if (length <= 0 || !HTS_is_delimiter(string[length - 1]))
+      return 0;
+   if (string[length - 1] == ':') {
+      for (i = length - 2; i >= 0 && isalnum((unsigned char) string[i]); i--);
+      if (i >= 0 && i < length - 2 && string[i] == '/')
+         return length - i;
+   }
+   return 1;
+}
+
+/* HTS_Pattern_split: split body of compiled pattern "*LvR*", "vR*", "*Lv" or "v" into left delimiters L, value v and right delimiters R */
+/* Return FALSE if the pattern cannot be tested on one field, i.e. L or R is missing while pattern is not anchored, */
+/* v has '*', or a literal v may end earlier at R so that the value of the field is not v */
+static HTS_Boolean HTS_Pattern_split(const char *body, const int type, const int length, int *nleft, int *nvalue, int *nright, HTS_Boolean * wildcard)
+{
+   int i, j;
+   const HTS_Boolean first = (type == HTS_PATTERN_SUFFIX || type == HTS_PATTERN_SUBSTRING) ? TRUE : FALSE;
+   const HTS_Boolean last = (type == HTS_PATTERN_PREFIX || type == HTS_PATTERN_SUBSTRING) ? TRUE : FALSE;
+   const char *value;
+
+   if (type == HTS_PATTERN_WILDCARD || type == HTS_PATTERN_ANY)
+      return FALSE;
+   *nleft = 0;
+   *nright = 0;
+   *wildcard = memchr(body, '?', length) != NULL ? TRUE : FALSE;
+   if (first)
+      while ((i = HTS_delimiter_length(&body[*nleft], length - *nleft)) > 0)
+         *nleft += i;
+   if (last)
+      while (*nleft + *nright < length && (i = HTS_delimiter_length_reverse(&body[*nleft], length - *nleft - *nright)) > 0)
+         *nright += i;
+   if ((first && *nleft == 0) || (last && *nright == 0))
+      return FALSE;
+   *nvalue = length - *nleft - *nright;
+   if (*wildcard == FALSE && *nright > 0) {
+      /* value is followed by R in pattern */
+      value = &body[*nleft];
+      for (i = 0; i < *nvalue; i++) {
+         for (j = 0; j < *nright; j++)
+            if (value[i + j] != value[*nvalue + j])
+               break;
+         if (j == *nright)
+            return FALSE;
+      }
+   }
+   return TRUE;
+}
+
+/* HTS_FeatureSet_initialize: initialize context features */
+static void HTS_FeatureSet_initialize(HTS_FeatureSet * fs)
+{
+   fs->field = NULL;
+   fs->nfield = 0;
+   fs->value = NULL;
+   fs->nvalue = 0;
+   fs->other = NULL;
+   fs->nother = 0;
+   fs->any = -1;
+   fs->string = NULL;
+   fs->nstring = 0;
+   fs->size = 0;
+}
+
+/* HTS_FeatureSet_clear: free context features */
+static void HTS_FeatureSet_clear(HTS_FeatureSet * fs)
+{
+   if (fs->field)
+      HTS_free(fs->field);
+   if (fs->value)
+      HTS_free(fs->value);
+   if (fs->other)
+      HTS_free(fs->other);
+   if (fs->string)
+      HTS_free(fs->string);
+   HTS_FeatureSet_initialize(fs);
+}
+
+/* HTS_FeatureSet_add_field: find field of given delimiters, or add it into context features, return its index */
+static int HTS_FeatureSet_add_field(HTS_FeatureSet * fs, const char *left, const int nleft, const char *right, const int nright)
+{
+   int i;
+   HTS_Field *field;
+
+   for (i = 0; i < fs->nfield; i++) {
+      field = &fs->field[i];
+      if (field->nleft == nleft && field->nright == nright && memcmp(&fs->string[field->left], left, nleft) == 0 && memcmp(&fs->string[field->right], right, nright) == 0)
+         return i;
+   }
+   fs->field = (HTS_Field *) HTS_grow(fs->field, fs->nfield, 1, sizeof(HTS_Field));
+   field = &fs->field[fs->nfield];
+   field->left = HTS_add_string(&fs->string, &fs->nstring, left, nleft);
+   field->nleft = nleft;
+   field->right = HTS_add_string(&fs->string, &fs->nstring, right, nright);
+   field->nright = nright;
+   field->value = 0;
+   field->nliteral = 0;
+   field->nwildcard = 0;
+   field->max_length = 0;
+
+   return fs->nfield++;
+}
+
+/* HTS_FeatureSet_compile: compile context features from distinct patterns, whose bits are their indices */
+static void HTS_FeatureSet_compile(HTS_FeatureSet * fs, const HTS_PatternRef * ref, const int nref)
+{
+   int i, nleft, nvalue, nright;
+   HTS_Boolean wildcard;
+   HTS_ValueRef *value;
+   HTS_Field *field;
+   int nvalue_ref = 0;
+
+   HTS_FeatureSet_clear(fs);
+   fs->size = (nref + HTS_FEATURE_WORD_BITS - 1) / HTS_FEATURE_WORD_BITS;
+   value = (HTS_ValueRef *) HTS_calloc(nref + 1, sizeof(HTS_ValueRef));
+   for (i = 0; i < nref; i++) {
+      if (ref[i].pattern->type == HTS_PATTERN_ANY) {
+         fs->any = i;
+      } else if (HTS_Pattern_split(ref[i].body, ref[i].pattern->type, ref[i].pattern->length, &nleft, &nvalue, &nright, &wildcard)) {
+         value[nvalue_ref].field = HTS_FeatureSet_add_field(fs, ref[i].body, nleft, &ref[i].body[nleft + nvalue], nright);
+         value[nvalue_ref].wildcard = wildcard;
+         value[nvalue_ref].string = &ref[i].body[nleft];
+         value[nvalue_ref].length = nvalue;
+         value[nvalue_ref].bit = i;
+         nvalue_ref++;
+      } else {
+         fs->other = (HTS_Value *) HTS_grow(fs->other, fs->nother, 1, sizeof(HTS_Value));
+         fs->other[fs->nother].length = strlen(ref[i].string);
+         fs->other[fs->nother].string = HTS_add_string(&fs->string, &fs->nstring, ref[i].string, fs->other[fs->nother].length);
+         fs->other[fs->nother].bit = i;
+         fs->nother++;
+      }
+   }
+   /* values of each field are stored together, and literal values are sorted for binary search */
+   qsort(value, nvalue_ref, sizeof(HTS_ValueRef), HTS_compare_value_ref);
+   fs->value = (HTS_Value *) HTS_calloc(nvalue_ref + 1, sizeof(HTS_Value));
+   fs->nvalue = nvalue_ref;
+   for (i = 0; i < nvalue_ref; i++) {
+      field = &fs->field[value[i].field];
+      if (field->nliteral + field->nwildcard == 0)
+         field->value = i;
+      if (value[i].wildcard)
+         field->nwildcard++;
+      else
+         field->nliteral++;
+      if (field->max_length < value[i].length)
+         field->max_length = value[i].length;
+      fs->value[i].string = HTS_add_string(&fs->string, &fs->nstring, value[i].string, value[i].length);
+      fs->value[i].length = value[i].length;
+      fs->value[i].bit = value[i].bit;
+   }
+   HTS_free(value);
+}
+
+/* HTS_match_wildcard: check string begins with given value having '?', followed by right delimiter (or string ends if it is empty) */
+static HTS_Boolean HTS_match_wildcard(const char *string, const char *value, const int length, const char *right, const int nright)
+{
+   int i;
+
+   for (i = 0; i < length; i++)
+      if (string[i] == '\0' || (value[i] != '?' && value[i] != string[i]))
+         return FALSE;
+   if (nright == 0)
+      return string[length] == '\0' ? TRUE : FALSE;
+   return strncmp(&string[length], right, nright) == 0 ? TRUE : FALSE;
+}
+
+/* HTS_FeatureSet_set_literal: set bit of literal value of field equal to given string */
+static void HTS_FeatureSet_set_literal(const HTS_FeatureSet * fs, const HTS_Field * field, const char *string, const int length, unsigned int *feature)
+{
+   int low, high, middle, result;
+   const HTS_Value *value = &fs->value[field->value];
+
+   for (low = 0, high = field->nliteral - 1; low <= high;) {
+      middle = (low + high) / 2;
+      result = HTS_compare_value(string, length, &fs->string[value[middle].string], value[middle].length);
+      if (result == 0) {
+         HTS_set_bit(feature, value[middle].bit);
+         break;
+      }
+      if (result < 0)
+         high = middle - 1;
+      else
+         low = middle + 1;
+   }
+}
+
+/* HTS_FeatureSet_match_field: set bits of values of field matching label string which follows left delimiter */
+static void HTS_FeatureSet_match_field(const HTS_FeatureSet * fs, const HTS_Field * field, const char *string, unsigned int *feature)
+{
+   int i, length;
+   const HTS_Value *value = &fs->value[field->value];
+   const char *right = &fs->string[field->right];
+
+   /* value ends at the first right delimiter, none of values match if it is not found */
+   for (length = 0; length <= field->max_length; length++) {
+      if (field->nright == 0 ? string[length] == '\0' : strncmp(&string[length], right, field->nright) == 0)
+         break;
+      if (string[length] == '\0')
+         return;
+   }
+   if (length > field->max_length)
+      return;
+   HTS_FeatureSet_set_literal(fs, field, string, length, feature);
+   /* values with '?' */
+   for (i = field->nliteral; i < field->nliteral + field->nwildcard; i++)
+      if (HTS_match_wildcard(string, &fs->string[value[i].string], value[i].length, right, field->nright))
+         HTS_set_bit(feature, value[i].bit);
+}
+
+/* HTS_Model_compile_test: compile questions and trees of model into tests on context features of given distinct patterns */
+static void HTS_Model_compile_test(HTS_Model * model, const HTS_PatternRef * ref, const int nref)
+{
+   int i, j, k, first, npattern, word;
+   unsigned int mask;
+   HTS_PatternRef key;
+   const HTS_PatternRef *found;
+   int ntest = 0;
+
+   if (model->test_offset)
+      HTS_free(model->test_offset);
+   if (model->test)
+      HTS_free(model->test);
+   model->test_offset = NULL;
+   model->test = NULL;
+   if (model->tree == NULL)
+      return;
+   /* each pattern belongs to one question or tree, and patterns in the same word are merged into one test */
+   model->test_offset = (int *) HTS_calloc(model->nquestion + model->ntree + 1, sizeof(int));
+   model->test = (HTS_Test *) HTS_calloc(model->npattern + 1, sizeof(HTS_Test));
+   for (i = 0; i < model->nquestion + model->ntree; i++) {
+      model->test_offset[i] = ntest;
+      if (i < model->nquestion) {
+         first = model->question[i].pattern;
+         npattern = model->question[i].npattern;
+      } else {
+         first = model->tree[i - model->nquestion].pattern;
+         npattern = model->tree[i - model->nquestion].npattern;
+      }
+      for (j = first; j < first + npattern; j++) {
+         key.string = &model->string[model->pattern[j].string];
+         found = (const HTS_PatternRef *) bsearch(&key, ref, nref, sizeof(HTS_PatternRef), HTS_compare_pattern_ref);
+         word = (int) (found - ref) / HTS_FEATURE_WORD_BITS;
+         mask = 1U << ((found - ref) % HTS_FEATURE_WORD_BITS);
+         for (k = model->test_offset[i]; k < ntest && model->test[k].word != word; k++);
+         if (k == ntest) {
+            model->test[ntest].word = word;
+            model->test[ntest].mask = 0;
+            ntest++;
+         }
+         model->test[k].mask |= mask;
+      }
+   }
+   model->test_offset[model->nquestion + model->ntree] = ntest;
+}
+
+/* HTS_ModelSet_get_model: get models with trees of model set into given array (if not NULL), return # of them */
+static int HTS_ModelSet_get_model(HTS_ModelSet * ms, HTS_Model ** model)
+{
+   int i, j;
+   int nmodel = 0;
+   HTS_Stream *stream;
+
+   for (i = -1; i < 2 * ms->nstream; i++) {
+      if (i < 0)
+         stream = &ms->duration;
+      else if (i < ms->nstream)
+         stream = ms->stream ? &ms->stream[i] : NULL;
+      else
+         stream = ms->gv ? &ms->gv[i - ms->nstream] : NULL;
+      if (stream == NULL)
+         continue;
+      for (j = 0; j < stream->interpolation_size; j++)
+         if (stream->model[j].tree != NULL) {
+            if (model)
+               model[nmodel] = &stream->model[j];
+            nmodel++;
+         }
+   }
+   if (ms->gv_switch.tree != NULL) {
+      if (model)
+         model[nmodel] = &ms->gv_switch;
+      nmodel++;
+   }
+
+   return nmodel;
+}
+
+/* HTS_ModelSet_compile_feature: compile context features from patterns of all loaded models, and tests of models on them */
+/* Labels are parsed into context features once, so that the trees are searched by testing bits without string matching */
+static void HTS_ModelSet_compile_feature(HTS_ModelSet * ms)
+{
+   int i, j, nref, nmodel;
+   HTS_Model **model;
+   HTS_PatternRef *ref;
+
+   /* distinct patterns of all models */
+   nmodel = HTS_ModelSet_get_model(ms, NULL);
+   model = (HTS_Model **) HTS_calloc(nmodel + 2, sizeof(HTS_Model *));
+   HTS_ModelSet_get_model(ms, model);
+   model[nmodel] = &ms->pattern;
+   for (i = 0, nref = 0; i <= nmodel; i++)
+      nref += model[i]->npattern;
+   ref = (HTS_PatternRef *) HTS_calloc(nref + 1, sizeof(HTS_PatternRef));
+   for (i = 0, nref = 0; i <= nmodel; i++)
+      for (j = 0; j < model[i]->npattern; j++) {
+         ref[nref].string = &model[i]->string[model[i]->pattern[j].string];
+         ref[nref].body = &model[i]->string[model[i]->pattern[j].body];
+         ref[nref].pattern = &model[i]->pattern[j];
+         nref++;
+      }
+   qsort(ref, nref, sizeof(HTS_PatternRef), HTS_compare_pattern_ref);
+   for (i = 0, j = 0; i < nref; i++)
+      if (j == 0 || strcmp(ref[i].string, ref[j - 1].string) != 0)
+         ref[j++] = ref[i];
+   nref = j;
+
+   HTS_FeatureSet_compile(&ms->feature, ref, nref);
+   for (i = 0; i < nmodel; i++)
+      HTS_Model_compile_test(model[i], ref, nref);
+   HTS_free(ref);
+   HTS_free(model);
+}
+
 /* HTS_ModelSet_initialize: initialize model set */
 void HTS_ModelSet_initialize(HTS_ModelSet * ms, int nstream)
 {
@@ -845,8 +1316,11 @@ void HTS_ModelSet_initialize(HTS_ModelSet * ms, int nstream)
    ms->stream = NULL;
    ms->gv = NULL;
    HTS_Model_initialize(&ms->gv_switch);
+   HTS_Model_initialize(&ms->pattern);
    ms->nstate = -1;
    ms->nstream = nstream;
+   HTS_FeatureSet_initialize(&ms->feature);
+   HTS_Image_initialize(&ms->image);
 }
 
 /* HTS_ModelSet_load_duration: load duration model and number of state */
@@ -876,6 +1350,7 @@ HTS_Boolean HTS_ModelSet_load_duration(HTS_ModelSet * ms, HTS_File ** pdf_fp, HT
       return FALSE;
    }
    ms->nstate = ms->duration.vector_length;
+   HTS_ModelSet_compile_feature(ms);
 
    return TRUE;
 }
@@ -923,6 +1398,7 @@ HTS_Boolean HTS_ModelSet_load_parameter(HTS_ModelSet * ms, HTS_File ** pdf_fp, H
       HTS_ModelSet_clear(ms);
       return FALSE;
    }
+   HTS_ModelSet_compile_feature(ms);
 
    return TRUE;
 }
@@ -956,6 +1432,7 @@ HTS_Boolean HTS_ModelSet_load_gv(HTS_ModelSet * ms, HTS_File ** pdf_fp, HTS_File
          HTS_ModelSet_clear(ms);
          return FALSE;
       }
+      HTS_ModelSet_compile_feature(ms);
    } else {
       if (HTS_Stream_load_pdf(&ms->gv[stream_index], pdf_fp, 1, FALSE, interpolation_size) == FALSE) {
          HTS_ModelSet_clear(ms);
@@ -967,7 +1444,7 @@ HTS_Boolean HTS_ModelSet_load_gv(HTS_ModelSet * ms, HTS_File ** pdf_fp, HTS_File
 }
 
 /* HTS_ModelSet_have_gv_tree: if context-dependent GV is used, return true */
-HTS_Boolean HTS_ModelSet_have_gv_tree(HTS_ModelSet * ms, int stream_index)
+HTS_Boolean HTS_ModelSet_have_gv_tree(const HTS_ModelSet * ms, int stream_index)
 {
    int i;
 
@@ -980,13 +1457,14 @@ HTS_Boolean HTS_ModelSet_have_gv_tree(HTS_ModelSet * ms, int stream_index)
 /* HTS_ModelSet_load_gv_switch: load GV switch */
 HTS_Boolean HTS_ModelSet_load_gv_switch(HTS_ModelSet * ms, HTS_File * fp)
 {
-   if (fp != NULL)
-      return HTS_Model_load_tree(&ms->gv_switch, fp);
-   return FALSE;
+   if (fp == NULL || HTS_Model_load_tree(&ms->gv_switch, fp) == FALSE)
+      return FALSE;
+   HTS_ModelSet_compile_feature(ms);
+   return TRUE;
 }
 
 /* HTS_ModelSet_have_gv_switch: if GV switch is used, return true */
-HTS_Boolean HTS_ModelSet_have_gv_switch(HTS_ModelSet * ms)
+HTS_Boolean HTS_ModelSet_have_gv_switch(const HTS_ModelSet * ms)
 {
    if (ms->gv_switch.tree != NULL)
       return TRUE;
@@ -994,80 +1472,476 @@ HTS_Boolean HTS_ModelSet_have_gv_switch(HTS_ModelSet * ms)
       return FALSE;
 }
 
+/* HTS_ImageBuffer: Buffer of compiled voice image to be saved. */
+typedef struct _HTS_ImageBuffer {
+   char *data;                  /* data of image */
+   int size;                    /* size of image */
+} HTS_ImageBuffer;
+
+/* HTS_ImageBuffer_swap: byte swap elements so that image is saved in little-endian */
+static void HTS_ImageBuffer_swap(char *p, const size_t size, const int num)
+{
+#ifdef WORDS_BIGENDIAN
+   int i;
+   size_t j;
+   char tmp;
+
+   for (i = 0; i < num; i++, p += size) {
+      for (j = 0; j < size / 2; j++) {
+         tmp = p[j];
+         p[j] = p[size - 1 - j];
+         p[size - 1 - j] = tmp;
+      }
+   }
+#else
+   (void) p;
+   (void) size;
+   (void) num;
+#endif                          /* WORDS_BIGENDIAN */
+}
+
+/* HTS_ImageBuffer_append: append array of elements (char, int, float or double) as an aligned section, return its offset (0 if array is empty) */
+static int HTS_ImageBuffer_append(HTS_ImageBuffer * buffer, const void *p, const size_t size, const int num)
+{
+   int offset;
+
+   if (p == NULL || num <= 0)
+      return 0;
+   offset = (buffer->size + HTS_IMAGE_ALIGN - 1) / HTS_IMAGE_ALIGN * HTS_IMAGE_ALIGN;
+   buffer->data = (char *) HTS_grow(buffer->data, buffer->size, offset - buffer->size + (int) size * num, sizeof(char));
+   memset(&buffer->data[buffer->size], 0, offset - buffer->size);
+   memcpy(&buffer->data[offset], p, size * num);
+   HTS_ImageBuffer_swap(&buffer->data[offset], size, num);
+   buffer->size = offset + (int) size * num;
+
+   return offset;
+}
+
+/* HTS_Model_save_image: append arrays of model to image */
+static void HTS_Model_save_image(const HTS_Model * model, HTS_ImageBuffer * buffer, HTS_ImageModel * image)
+{
+   const int nint = sizeof(int);
+
+   image->vector_length = model->vector_length;
+   image->pdf_length = model->pdf_length;
+   image->ntree = model->ntree;
+   image->pdf_size = (model->ntree > 0 && model->pdf) ? model->pdf_offset[model->ntree - 1] + model->npdf[model->ntree - 1] * model->pdf_length : 0;
+   image->npdf = HTS_ImageBuffer_append(buffer, model->npdf, sizeof(int), model->ntree);
+   image->pdf_offset = HTS_ImageBuffer_append(buffer, model->pdf_offset, sizeof(int), model->ntree);
+   image->pdf = HTS_ImageBuffer_append(buffer, model->pdf, sizeof(float), image->pdf_size);
+   image->tree = HTS_ImageBuffer_append(buffer, model->tree, sizeof(int), model->ntree * sizeof(HTS_Tree) / nint);
+   image->nnode = model->nnode;
+   image->node = HTS_ImageBuffer_append(buffer, model->node, sizeof(int), model->nnode * sizeof(HTS_FlatNode) / nint);
+   image->nquestion = model->nquestion;
+   image->question = HTS_ImageBuffer_append(buffer, model->question, sizeof(int), model->nquestion * sizeof(HTS_Question) / nint);
+   image->npattern = model->npattern;
+   image->pattern = HTS_ImageBuffer_append(buffer, model->pattern, sizeof(int), model->npattern * sizeof(HTS_Pattern) / nint);
+   image->nstring = model->nstring;
+   image->string = HTS_ImageBuffer_append(buffer, model->string, sizeof(char), model->nstring);
+}
+
+/* HTS_Stream_save_image: append models and windows of stream to image */
+static void HTS_Stream_save_image(const HTS_Stream * stream, HTS_ImageBuffer * buffer, HTS_ImageStream * image)
+{
+   int i, j, n;
+   HTS_ImageModel *model;
+   int *width;
+   double *coefficient;
+   const HTS_Window *win = &stream->window;
+
+   image->vector_length = stream->vector_length;
+   image->msd_flag = stream->msd_flag;
+   image->interpolation_size = stream->interpolation_size;
+   image->model = 0;
+   if (stream->interpolation_size > 0) {
+      model = (HTS_ImageModel *) HTS_calloc(stream->interpolation_size, sizeof(HTS_ImageModel));
+      for (i = 0; i < stream->interpolation_size; i++)
+         HTS_Model_save_image(&stream->model[i], buffer, &model[i]);
+      image->model = HTS_ImageBuffer_append(buffer, model, sizeof(int), stream->interpolation_size * sizeof(HTS_ImageModel) / sizeof(int));
+      HTS_free(model);
+   }
+   /* left widths, right widths and coefficients of windows */
+   image->window_size = win->size;
+   image->window_width = 0;
+   image->window_coefficient = 0;
+   image->ncoefficient = 0;
+   if (win->size > 0) {
+      width = (int *) HTS_calloc(2 * win->size, sizeof(int));
+      for (i = 0, n = 0; i < win->size; i++) {
+         width[i] = win->l_width[i];
+         width[win->size + i] = win->r_width[i];
+         n += win->r_width[i] - win->l_width[i] + 1;
+      }
+      coefficient = (double *) HTS_calloc(n, sizeof(double));
+      for (i = 0, n = 0; i < win->size; i++)
+         for (j = win->l_width[i]; j <= win->r_width[i]; j++)
+            coefficient[n++] = win->coefficient[i][j];
+      image->window_width = HTS_ImageBuffer_append(buffer, width, sizeof(int), 2 * win->size);
+      image->window_coefficient = HTS_ImageBuffer_append(buffer, coefficient, sizeof(double), n);
+      image->ncoefficient = n;
+      HTS_free(width);
+      HTS_free(coefficient);
+   }
+}
+
+/* HTS_Image_get_array: get array in image, return NULL if it is empty, and set result to FALSE if it is out of image */
+static void *HTS_Image_get_array(HTS_Image * image, const int offset, const size_t size, const int num, HTS_Boolean * result)
+{
+   if (num == 0)
+      return NULL;
+   if (num < 0 || offset <= 0 || offset % HTS_IMAGE_ALIGN != 0 || (size_t) offset > image->size || (image->size - offset) / size < (size_t) num) {
+      *result = FALSE;
+      return NULL;
+   }
+
+   return &image->data[offset];
+}
+
+/* HTS_Model_check_image: check all indices of model mapped from image, so that they need not be checked in synthesis */
+static HTS_Boolean HTS_Model_check_image(const HTS_Model * model, const int pdf_size)
+{
+   int i, j, k, child;
+   const HTS_Tree *tree;
+   const HTS_FlatNode *node;
+   const HTS_Question *question;
+   const HTS_Pattern *pattern;
+
+   if (model->ntree < 0 || model->nnode < 0 || model->nquestion < 0 || model->npattern < 0 || model->nstring < 0)
+      return FALSE;
+   /* PDFs of each tree */
+   if (model->npdf != NULL) {
+      if (model->pdf_offset == NULL || model->pdf == NULL || model->vector_length <= 0 || model->pdf_length < 2 * model->vector_length)
+         return FALSE;
+      for (i = 0; i < model->ntree; i++)
+         if (model->npdf[i] <= 0 || model->pdf_offset[i] < 0 || model->pdf_offset[i] > pdf_size
+             || (pdf_size - model->pdf_offset[i]) / model->pdf_length < model->npdf[i])
+            return FALSE;
+   }
+   /* patterns */
+   for (i = 0; i < model->npattern; i++) {
+      pattern = &model->pattern[i];
+      if (pattern->string < 0 || pattern->string >= model->nstring || pattern->body < 0 || pattern->body >= model->nstring || pattern->length < 0)
+         return FALSE;
+   }
+   /* questions */
+   for (i = 0; i < model->nquestion; i++) {
+      question = &model->question[i];
+      if (question->string < 0 || question->string >= model->nstring || question->pattern < 0 || question->npattern < 0
+          || question->npattern > model->npattern - question->pattern)
+         return FALSE;
+   }
+   /* trees, whose nodes are numbered in depth-first order so that the children follow their parent */
+   if (model->tree != NULL) {
+      for (i = 0; i < model->ntree; i++) {
+         tree = &model->tree[i];
+         if (tree->pattern < 0 || tree->npattern < 0 || tree->npattern > model->npattern - tree->pattern)
+            return FALSE;
+         if (tree->node < 0 || tree->nnode < 0 || tree->nnode > model->nnode - tree->node)
+            return FALSE;
+         if (tree->nnode == 0 && (tree->pdf < 0 || (model->npdf != NULL && (tree->pdf < 1 || tree->pdf > model->npdf[i]))))
+            return FALSE;
+         for (j = 0; j < tree->nnode; j++) {
+            node = &model->node[tree->node + j];
+            if (node->quest < 0 || node->quest >= model->nquestion)
+               return FALSE;
+            for (k = 0; k < 2; k++) {
+               child = node->child[k];
+               if (child >= 0 && (child <= j || child >= tree->nnode))
+                  return FALSE;
+               if (child < 0 && model->npdf != NULL && (child > -2 || -child - 1 > model->npdf[i]))
+                  return FALSE;
+            }
+         }
+      }
+   }
+
+   return TRUE;
+}
+
+/* HTS_Model_load_image: point arrays of model into mapped image */
+static HTS_Boolean HTS_Model_load_image(HTS_Model * model, HTS_Image * image, const HTS_ImageModel * im)
+{
+   HTS_Boolean result = TRUE;
+
+   HTS_Model_initialize(model);
+   model->mapped = TRUE;
+   model->vector_length = im->vector_length;
+   model->pdf_length = im->pdf_length;
+   model->ntree = im->ntree;
+   model->npdf = (int *) HTS_Image_get_array(image, im->npdf, sizeof(int), im->ntree, &result);
+   model->pdf_offset = (int *) HTS_Image_get_array(image, im->pdf_offset, sizeof(int), im->ntree, &result);
+   model->pdf = (float *) HTS_Image_get_array(image, im->pdf, sizeof(float), im->pdf_size, &result);
+   model->tree = (HTS_Tree *) HTS_Image_get_array(image, im->tree, sizeof(HTS_Tree), im->tree ? im->ntree : 0, &result);
+   model->nnode = im->nnode;
+   model->node = (HTS_FlatNode *) HTS_Image_get_array(image, im->node, sizeof(HTS_FlatNode), im->nnode, &result);
+   model->nquestion = im->nquestion;
+   model->question = (HTS_Question *) HTS_Image_get_array(image, im->question, sizeof(HTS_Question), im->nquestion, &result);
+   model->npattern = im->npattern;
+   model->pattern = (HTS_Pattern *) HTS_Image_get_array(image, im->pattern, sizeof(HTS_Pattern), im->npattern, &result);
+   model->nstring = im->nstring;
+   model->string = (char *) HTS_Image_get_array(image, im->string, sizeof(char), im->nstring, &result);
+   if (model->string != NULL && model->string[model->nstring - 1] != '\0')
+      result = FALSE;
+   if (result == TRUE && HTS_Model_check_image(model, im->pdf_size) == FALSE)
+      result = FALSE;
+
+   return result;
+}
+
+/* HTS_Stream_load_image: point models of stream into mapped image, and copy windows */
+static HTS_Boolean HTS_Stream_load_image(HTS_Stream * stream, HTS_Image * image, const HTS_ImageStream * is)
+{
+   int i, n, length;
+   const HTS_ImageModel *model;
+   const int *width;
+   const double *coefficient;
+   HTS_Window *win = &stream->window;
+   HTS_Boolean result = TRUE;
+
+   HTS_Stream_initialize(stream);
+   if (is == NULL)
+      return FALSE;
+   model = (const HTS_ImageModel *) HTS_Image_get_array(image, is->model, sizeof(HTS_ImageModel), is->interpolation_size, &result);
+   width = (const int *) HTS_Image_get_array(image, is->window_width, sizeof(int), 2 * is->window_size, &result);
+   coefficient = (const double *) HTS_Image_get_array(image, is->window_coefficient, sizeof(double), is->ncoefficient, &result);
+   for (i = 0, n = 0; result && i < is->window_size; i++) {
+      if (width[i] > 0 || width[is->window_size + i] < width[i])
+         result = FALSE;
+      n += width[is->window_size + i] - width[i] + 1;
+   }
+   if (result == FALSE || n != is->ncoefficient)
+      return FALSE;
+
+   stream->vector_length = is->vector_length;
+   stream->msd_flag = is->msd_flag;
+   stream->interpolation_size = is->interpolation_size;
+   if (is->interpolation_size > 0) {
+      stream->model = (HTS_Model *) HTS_calloc(is->interpolation_size, sizeof(HTS_Model));
+      for (i = 0; i < is->interpolation_size; i++)
+         if (HTS_Model_load_image(&stream->model[i], image, &model[i]) == FALSE)
+            result = FALSE;
+   }
+   /* windows are copied, as they have only a few coefficients */
+   if (is->window_size > 0) {
+      win->size = is->window_size;
+      win->l_width = (int *) HTS_calloc(win->size, sizeof(int));
+      win->r_width = (int *) HTS_calloc(win->size, sizeof(int));
+      win->coefficient = (double **) HTS_calloc(win->size, sizeof(double *));
+      for (i = 0, n = 0; i < win->size; i++) {
+         win->l_width[i] = width[i];
+         win->r_width[i] = width[win->size + i];
+         length = win->r_width[i] - win->l_width[i] + 1;
+         win->coefficient[i] = (double *) HTS_calloc(length, sizeof(double));
+         memcpy(win->coefficient[i], &coefficient[n], length * sizeof(double));
+         win->coefficient[i] -= win->l_width[i];
+         n += length;
+         if (win->max_width < abs(win->l_width[i]))
+            win->max_width = abs(win->l_width[i]);
+         if (win->max_width < abs(win->r_width[i]))
+            win->max_width = abs(win->r_width[i]);
+      }
+   }
+
+   return result;
+}
+
+/* HTS_ModelSet_load_image: map models of all streams from compiled voice image */
+/* PDFs, trees, questions and patterns are used in the mapped image directly without parsing, */
+/* and the read-only pages are shared by all processes using the same image. */
+HTS_Boolean HTS_ModelSet_load_image(HTS_ModelSet * ms, const char *fn)
+{
+   int i;
+   const HTS_ImageHeader *header;
+   const HTS_ImageStream *stream;
+   const HTS_ImageModel *gv_switch;
+   HTS_Boolean result = TRUE;
+
+   /* check */
+   if (ms == NULL || fn == NULL)
+      return FALSE;
+   if (ms->duration.model != NULL || ms->stream != NULL || ms->gv != NULL || ms->gv_switch.tree != NULL || ms->image.data != NULL) {
+      HTS_error(1, "HTS_ModelSet_load_image: Models are already loaded.\n");
+      return FALSE;
+   }
+   if (HTS_Image_open(&ms->image, fn) == FALSE) {
+      HTS_error(1, "HTS_ModelSet_load_image: Cannot open %s.\n", fn);
+      return FALSE;
+   }
+   header = (const HTS_ImageHeader *) ms->image.data;
+   if (ms->image.size < sizeof(HTS_ImageHeader) || memcmp(header->magic, HTS_IMAGE_MAGIC, sizeof(header->magic)) != 0
+       || header->byte_order != HTS_IMAGE_BYTE_ORDER || header->version != HTS_IMAGE_VERSION || (size_t) header->size != ms->image.size || header->nstream <= 0) {
+      HTS_error(1, "HTS_ModelSet_load_image: %s is not a voice image of version %d for this machine.\n", fn, HTS_IMAGE_VERSION);
+      HTS_ModelSet_clear(ms);
+      return FALSE;
+   }
+
+   /* map */
+   ms->nstream = header->nstream;
+   ms->nstate = header->nstate;
+   stream = (const HTS_ImageStream *) HTS_Image_get_array(&ms->image, header->duration, sizeof(HTS_ImageStream), 1, &result);
+   if (HTS_Stream_load_image(&ms->duration, &ms->image, stream) == FALSE)
+      result = FALSE;
+   stream = (const HTS_ImageStream *) HTS_Image_get_array(&ms->image, header->stream, sizeof(HTS_ImageStream), ms->nstream, &result);
+   if (stream != NULL) {
+      ms->stream = (HTS_Stream *) HTS_calloc(ms->nstream, sizeof(HTS_Stream));
+      for (i = 0; i < ms->nstream; i++)
+         if (HTS_Stream_load_image(&ms->stream[i], &ms->image, &stream[i]) == FALSE)
+            result = FALSE;
+   }
+   if (header->gv) {
+      stream = (const HTS_ImageStream *) HTS_Image_get_array(&ms->image, header->gv, sizeof(HTS_ImageStream), ms->nstream, &result);
+      if (stream != NULL) {
+         ms->gv = (HTS_Stream *) HTS_calloc(ms->nstream, sizeof(HTS_Stream));
+         for (i = 0; i < ms->nstream; i++)
+            if (HTS_Stream_load_image(&ms->gv[i], &ms->image, &stream[i]) == FALSE)
+               result = FALSE;
+      }
+   }
+   if (header->gv_switch) {
+      gv_switch = (const HTS_ImageModel *) HTS_Image_get_array(&ms->image, header->gv_switch, sizeof(HTS_ImageModel), 1, &result);
+      if (gv_switch != NULL && HTS_Model_load_image(&ms->gv_switch, &ms->image, gv_switch) == FALSE)
+         result = FALSE;
+   }
+   if (result == FALSE || ms->stream == NULL) {
+      HTS_error(1, "HTS_ModelSet_load_image: Failed to load %s.\n", fn);
+      HTS_ModelSet_clear(ms);
+      return FALSE;
+   }
+   HTS_ModelSet_compile_feature(ms);
+
+   return TRUE;
+}
+
+/* HTS_ModelSet_save_image: save models of all streams into compiled voice image */
+HTS_Boolean HTS_ModelSet_save_image(const HTS_ModelSet * ms, HTS_File * fp)
+{
+   int i;
+   HTS_ImageHeader header;
+   HTS_ImageStream *stream;
+   HTS_ImageModel gv_switch;
+   HTS_ImageBuffer buffer;
+   HTS_Boolean result;
+
+   /* check */
+   if (ms == NULL || fp == NULL || ms->duration.model == NULL || ms->stream == NULL) {
+      HTS_error(1, "HTS_ModelSet_save_image: Models are not loaded.\n");
+      return FALSE;
+   }
+
+   /* header is filled after all sections are appended */
+   memset(&header, 0, sizeof(header));
+   buffer.data = NULL;
+   buffer.size = 0;
+   HTS_ImageBuffer_append(&buffer, &header, sizeof(char), sizeof(header));
+
+   /* sections */
+   stream = (HTS_ImageStream *) HTS_calloc(ms->nstream, sizeof(HTS_ImageStream));
+   HTS_Stream_save_image(&ms->duration, &buffer, &stream[0]);
+   header.duration = HTS_ImageBuffer_append(&buffer, stream, sizeof(int), sizeof(HTS_ImageStream) / sizeof(int));
+   for (i = 0; i < ms->nstream; i++)
+      HTS_Stream_save_image(&ms->stream[i], &buffer, &stream[i]);
+   header.stream = HTS_ImageBuffer_append(&buffer, stream, sizeof(int), ms->nstream * sizeof(HTS_ImageStream) / sizeof(int));
+   if (ms->gv) {
+      for (i = 0; i < ms->nstream; i++)
+         HTS_Stream_save_image(&ms->gv[i], &buffer, &stream[i]);
+      header.gv = HTS_ImageBuffer_append(&buffer, stream, sizeof(int), ms->nstream * sizeof(HTS_ImageStream) / sizeof(int));
+   }
+   if (ms->gv_switch.tree) {
+      HTS_Model_save_image(&ms->gv_switch, &buffer, &gv_switch);
+      header.gv_switch = HTS_ImageBuffer_append(&buffer, &gv_switch, sizeof(int), sizeof(HTS_ImageModel) / sizeof(int));
+   }
+   HTS_free(stream);
+
+   /* header */
+   memcpy(header.magic, HTS_IMAGE_MAGIC, sizeof(header.magic));
+   header.version = HTS_IMAGE_VERSION;
+   header.byte_order = HTS_IMAGE_BYTE_ORDER;
+   header.size = buffer.size;
+   header.nstream = ms->nstream;
+   header.nstate = ms->nstate;
+   memcpy(buffer.data, &header, sizeof(header));
+   HTS_ImageBuffer_swap(&buffer.data[sizeof(header.magic)], sizeof(int), (sizeof(header) - sizeof(header.magic)) / sizeof(int));
+
+   result = HTS_fwrite(buffer.data, sizeof(char), buffer.size, fp) == (size_t) buffer.size ? TRUE : FALSE;
+   HTS_free(buffer.data);
+
+   return result;
+}
+
 /* HTS_ModelSet_get_nstate: get number of state */
-int HTS_ModelSet_get_nstate(HTS_ModelSet * ms)
+int HTS_ModelSet_get_nstate(const HTS_ModelSet * ms)
 {
    return ms->nstate;
 }
 
 /* HTS_ModelSet_get_nstream: get number of stream */
-int HTS_ModelSet_get_nstream(HTS_ModelSet * ms)
+int HTS_ModelSet_get_nstream(const HTS_ModelSet * ms)
 {
    return ms->nstream;
 }
 
 /* HTS_ModelSet_get_vector_length: get vector length */
-int HTS_ModelSet_get_vector_length(HTS_ModelSet * ms, int stream_index)
+int HTS_ModelSet_get_vector_length(const HTS_ModelSet * ms, int stream_index)
 {
    return ms->stream[stream_index].vector_length;
 }
 
 /* HTS_ModelSet_is_msd: get MSD flag */
-HTS_Boolean HTS_ModelSet_is_msd(HTS_ModelSet * ms, int stream_index)
+HTS_Boolean HTS_ModelSet_is_msd(const HTS_ModelSet * ms, int stream_index)
 {
    return ms->stream[stream_index].msd_flag;
 }
 
 /* HTS_ModelSet_get_window_size: get dynamic window size */
-int HTS_ModelSet_get_window_size(HTS_ModelSet * ms, int stream_index)
+int HTS_ModelSet_get_window_size(const HTS_ModelSet * ms, int stream_index)
 {
    return ms->stream[stream_index].window.size;
 }
 
 /* HTS_ModelSet_get_window_left_width: get left width of dynamic window */
-int HTS_ModelSet_get_window_left_width(HTS_ModelSet * ms, int stream_index, int window_index)
+int HTS_ModelSet_get_window_left_width(const HTS_ModelSet * ms, int stream_index, int window_index)
 {
    return ms->stream[stream_index].window.l_width[window_index];
 }
 
 /* HTS_ModelSet_get_window_right_width: get right width of dynamic window */
-int HTS_ModelSet_get_window_right_width(HTS_ModelSet * ms, int stream_index, int window_index)
+int HTS_ModelSet_get_window_right_width(const HTS_ModelSet * ms, int stream_index, int window_index)
 {
    return ms->stream[stream_index].window.r_width[window_index];
 }
 
 /* HTS_ModelSet_get_window_coefficient: get coefficient of dynamic window */
-double HTS_ModelSet_get_window_coefficient(HTS_ModelSet * ms, int stream_index, int window_index, int coefficient_index)
+double HTS_ModelSet_get_window_coefficient(const HTS_ModelSet * ms, int stream_index, int window_index, int coefficient_index)
 {
    return ms->stream[stream_index].window.coefficient[window_index][coefficient_index];
 }
 
 /* HTS_ModelSet_get_window_max_width: get max width of dynamic window */
-int HTS_ModelSet_get_window_max_width(HTS_ModelSet * ms, int stream_index)
+int HTS_ModelSet_get_window_max_width(const HTS_ModelSet * ms, int stream_index)
 {
    return ms->stream[stream_index].window.max_width;
 }
 
 /* HTS_ModelSet_get_duration_interpolation_size: get interpolation size (duration model) */
-int HTS_ModelSet_get_duration_interpolation_size(HTS_ModelSet * ms)
+int HTS_ModelSet_get_duration_interpolation_size(const HTS_ModelSet * ms)
 {
    return ms->duration.interpolation_size;
 }
 
 /* HTS_ModelSet_get_parameter_interpolation_size: get interpolation size (parameter model) */
-int HTS_ModelSet_get_parameter_interpolation_size(HTS_ModelSet * ms, int stream_index)
+int HTS_ModelSet_get_parameter_interpolation_size(const HTS_ModelSet * ms, int stream_index)
 {
    return ms->stream[stream_index].interpolation_size;
 }
 
 /* HTS_ModelSet_get_gv_interpolation_size: get interpolation size (GV model) */
-int HTS_ModelSet_get_gv_interpolation_size(HTS_ModelSet * ms, int stream_index)
+int HTS_ModelSet_get_gv_interpolation_size(const HTS_ModelSet * ms, int stream_index)
 {
    return ms->gv[stream_index].interpolation_size;
 }
 
 /* HTS_ModelSet_use_gv: get GV flag */
-HTS_Boolean HTS_ModelSet_use_gv(HTS_ModelSet * ms, int stream_index)
+HTS_Boolean HTS_ModelSet_use_gv(const HTS_ModelSet * ms, int stream_index)
 {
    if (!ms->gv)
       return FALSE;
@@ -1076,42 +1950,148 @@ HTS_Boolean HTS_ModelSet_use_gv(HTS_ModelSet * ms, int stream_index)
    return FALSE;
 }
 
-/* HTS_ModelSet_get_duration_index: get index of duration tree and PDF */
-void HTS_ModelSet_get_duration_index(HTS_ModelSet * ms, char *string, int *tree_index, int *pdf_index, int interpolation_index)
+/* HTS_ModelSet_get_feature_size: get # of words of context features of each label */
+int HTS_ModelSet_get_feature_size(const HTS_ModelSet * ms)
 {
-   HTS_Tree *tree;
-   HTS_Pattern *pattern;
-   HTS_Boolean find;
+   return ms->feature.size;
+}
 
-   find = FALSE;
-   (*tree_index) = 2;
-   (*pdf_index) = 1;
-   for (tree = ms->duration.model[interpolation_index].tree; tree; tree = tree->next) {
-      pattern = tree->head;
-      if (!pattern)
-         find = TRUE;
-      for (; pattern; pattern = pattern->next)
-         if (HTS_pattern_match(string, pattern->string)) {
-            find = TRUE;
-            break;
-         }
-      if (find)
+/* HTS_ModelSet_get_feature: parse label string into context features */
+/* Each field is found after every occurrence of its left delimiter, so that its bits are the answers of its patterns */
+void HTS_ModelSet_get_feature(const HTS_ModelSet * ms, const char *string, unsigned int *feature)
+{
+   int i;
+   const char *p;
+   const HTS_Field *field;
+   const HTS_FeatureSet *fs = &ms->feature;
+
+   HTS_ModelSet_initialize_feature(ms, feature);
+   for (i = 0; i < fs->nfield; i++) {
+      field = &fs->field[i];
+      if (field->nleft == 0) {
+         HTS_FeatureSet_match_field(fs, field, string, feature);
+         continue;
+      }
+      for (p = strstr(string, &fs->string[field->left]); p != NULL; p = strstr(p + 1, &fs->string[field->left]))
+         HTS_FeatureSet_match_field(fs, field, p + field->nleft, feature);
+   }
+   for (i = 0; i < fs->nother; i++)
+      if (HTS_pattern_match(string, &fs->string[fs->other[i].string]))
+         HTS_set_bit(feature, fs->other[i].bit);
+}
+
+/* HTS_ModelSet_get_field_size: get # of fields of context features (-1 if some patterns are matched with whole label string) */
+int HTS_ModelSet_get_field_size(const HTS_ModelSet * ms)
+{
+   return ms->feature.nother > 0 ? -1 : ms->feature.nfield;
+}
+
+/* HTS_ModelSet_get_field_list: get fields of value between given delimiters of label ("" at beginning or end), return # of fields */
+/* A field is tested on the value if its left delimiter ends the given left one and its right delimiter begins the given right one */
+int HTS_ModelSet_get_field_list(const HTS_ModelSet * ms, const char *left, const char *right, int *field_list)
+{
+   int i, size = 0;
+   const HTS_Field *field;
+   const HTS_FeatureSet *fs = &ms->feature;
+   const int nleft = strlen(left);
+
+   for (i = 0; i < fs->nfield; i++) {
+      field = &fs->field[i];
+      if (field->nleft == 0 ? nleft != 0 : (field->nleft > nleft || strncmp(&left[nleft - field->nleft], &fs->string[field->left], field->nleft) != 0))
+         continue;
+      if (field->nright == 0 ? right[0] != '\0' : strncmp(right, &fs->string[field->right], field->nright) != 0)
+         continue;
+      field_list[size++] = i;
+   }
+   return size;
+}
+
+/* HTS_ModelSet_add_pattern: add patterns tested by context features besides questions, and compile context features again */
+void HTS_ModelSet_add_pattern(HTS_ModelSet * ms, char **pattern, int size)
+{
+   int i;
+
+   for (i = 0; i < size; i++)
+      HTS_Model_add_pattern(&ms->pattern, pattern[i]);
+   HTS_ModelSet_compile_feature(ms);
+}
+
+/* HTS_ModelSet_get_pattern_bit: get bit of context features answering whether label matches given pattern (-1 if it is not tested) */
+int HTS_ModelSet_get_pattern_bit(const HTS_ModelSet * ms, const char *pattern)
+{
+   int i, first, length, nleft, nvalue, nright;
+   HTS_Boolean wildcard;
+   const HTS_Field *field = NULL;
+   const HTS_FeatureSet *fs = &ms->feature;
+   const int type = HTS_pattern_type(pattern, &first, &length);
+   const char *body = &pattern[first];
+
+   if (type == HTS_PATTERN_ANY)
+      return fs->any;
+   if (HTS_Pattern_split(body, type, length, &nleft, &nvalue, &nright, &wildcard) == FALSE) {
+      for (i = 0; i < fs->nother; i++)
+         if (strcmp(&fs->string[fs->other[i].string], pattern) == 0)
+            return fs->other[i].bit;
+      return -1;
+   }
+   for (i = 0; i < fs->nfield; i++) {
+      field = &fs->field[i];
+      if (field->nleft == nleft && field->nright == nright && memcmp(&fs->string[field->left], body, nleft) == 0 && memcmp(&fs->string[field->right], &body[nleft + nvalue], nright) == 0)
          break;
-      (*tree_index)++;
    }
+   if (i == fs->nfield)
+      return -1;
+   for (i = field->value; i < field->value + field->nliteral + field->nwildcard; i++)
+      if (HTS_compare_value(&body[nleft], nvalue, &fs->string[fs->value[i].string], fs->value[i].length) == 0)
+         return fs->value[i].bit;
+   return -1;
+}
+
+/* HTS_ModelSet_initialize_feature: initialize context features before setting values of fields */
+void HTS_ModelSet_initialize_feature(const HTS_ModelSet * ms, unsigned int *feature)
+{
+   memset(feature, 0, ms->feature.size * sizeof(unsigned int));
+   if (ms->feature.any >= 0)
+      HTS_set_bit(feature, ms->feature.any);
+}
+
+/* HTS_ModelSet_set_field: set bits of value of field into context features */
+void HTS_ModelSet_set_field(const HTS_ModelSet * ms, int field_index, const char *value, unsigned int *feature)
+{
+   int i;
+   const HTS_FeatureSet *fs = &ms->feature;
+   const HTS_Field *field = &fs->field[field_index];
+   const int length = strlen(value);
+
+   if (length > field->max_length)
+      return;
+   HTS_FeatureSet_set_literal(fs, field, value, length, feature);
+   for (i = field->value + field->nliteral; i < field->value + field->nliteral + field->nwildcard; i++)
+      if (fs->value[i].length == length && HTS_match_wildcard(value, &fs->string[fs->value[i].string], length, NULL, 0))
+         HTS_set_bit(feature, fs->value[i].bit);
+}
+
+/* HTS_ModelSet_get_duration_index: get index of duration tree and PDF */
+void HTS_ModelSet_get_duration_index(const HTS_ModelSet * ms, const unsigned int *feature, int *tree_index, int *pdf_index, int interpolation_index)
+{
+   const HTS_Model *model = &ms->duration.model[interpolation_index];
 
-   if (tree == NULL) {
-      HTS_error(1, "HTS_ModelSet_get_duration_index: Cannot find model %s.\n", string);
+   (*tree_index) = HTS_Model_find_tree(model, -1, feature);
+   (*pdf_index) = 1;
+   if ((*tree_index) < 0) {
+      (*tree_index) = 2;
+      HTS_error(1, "HTS_ModelSet_get_duration_index: Cannot find model of label.\n");
       return;
    }
-   (*pdf_index) = HTS_Tree_search_node(tree, string);
+   (*pdf_index) = HTS_Tree_search_node(model, &model->tree[(*tree_index) - 2], feature);
 }
 
 /* HTS_ModelSet_get_duration: get duration using interpolation weight */
-void HTS_ModelSet_get_duration(HTS_ModelSet * ms, char *string, double *mean, double *vari, double *iw)
+void HTS_ModelSet_get_duration(const HTS_ModelSet * ms, const unsigned int *feature, double *mean, double *vari, double *iw)
 {
    int i, j;
    int tree_index, pdf_index;
+   const float *pdf;
    const int vector_length = ms->duration.vector_length;
 
    for (i = 0; i < ms->nstate; i++) {
@@ -1119,52 +2099,36 @@ void HTS_ModelSet_get_duration(HTS_ModelSet * ms, char *string, double *mean, do
       vari[i] = 0.0;
    }
    for (i = 0; i < ms->duration.interpolation_size; i++) {
-      HTS_ModelSet_get_duration_index(ms, string, &tree_index, &pdf_index, i);
+      HTS_ModelSet_get_duration_index(ms, feature, &tree_index, &pdf_index, i);
+      pdf = HTS_Model_get_pdf(&ms->duration.model[i], tree_index, pdf_index);
       for (j = 0; j < ms->nstate; j++) {
-         mean[j] += iw[i] * ms->duration.model[i].pdf[tree_index][pdf_index][j];
-         vari[j] += iw[i] * iw[i] * ms->duration.model[i].pdf[tree_index][pdf_index][j + vector_length];
+         mean[j] += iw[i] * pdf[j];
+         vari[j] += iw[i] * iw[i] * pdf[j + vector_length];
       }
    }
 }
 
 /* HTS_ModelSet_get_parameter_index: get index of parameter tree and PDF */
-void HTS_ModelSet_get_parameter_index(HTS_ModelSet * ms, char *string, int *tree_index, int *pdf_index, int stream_index, int state_index, int interpolation_index)
+void HTS_ModelSet_get_parameter_index(const HTS_ModelSet * ms, const unsigned int *feature, int *tree_index, int *pdf_index, int stream_index, int state_index, int interpolation_index)
 {
-   HTS_Tree *tree;
-   HTS_Pattern *pattern;
-   HTS_Boolean find;
+   const HTS_Model *model = &ms->stream[stream_index].model[interpolation_index];
 
-   find = FALSE;
-   (*tree_index) = 2;
+   (*tree_index) = HTS_Model_find_tree(model, state_index, feature);
    (*pdf_index) = 1;
-   for (tree = ms->stream[stream_index].model[interpolation_index].tree; tree; tree = tree->next) {
-      if (tree->state == state_index) {
-         pattern = tree->head;
-         if (!pattern)
-            find = TRUE;
-         for (; pattern; pattern = pattern->next)
-            if (HTS_pattern_match(string, pattern->string)) {
-               find = TRUE;
-               break;
-            }
-         if (find)
-            break;
-      }
-      (*tree_index)++;
-   }
-
-   if (tree == NULL) {
-      HTS_error(1, "HTS_ModelSet_get_parameter_index: Cannot find model %s.\n", string);
+   if ((*tree_index) < 0) {
+      (*tree_index) = 2;
+      HTS_error(1, "HTS_ModelSet_get_parameter_index: Cannot find model of label.\n");
       return;
    }
-   (*pdf_index) = HTS_Tree_search_node(tree, string);
+   (*pdf_index) = HTS_Tree_search_node(model, &model->tree[(*tree_index) - 2], feature);
 }
 
 /* HTS_ModelSet_get_parameter: get parameter using interpolation weight */
-void HTS_ModelSet_get_parameter(HTS_ModelSet * ms, char *string, double *mean, double *vari, double *msd, int stream_index, int state_index, double *iw)
+void HTS_ModelSet_get_parameter(const HTS_ModelSet * ms, const unsigned int *feature, double *mean, double *vari, double *msd, int stream_index, int state_index, double *iw)
 {
    int i, j;
    int tree_index, pdf_index;
+   const float *pdf;
    const int vector_length = ms->stream[stream_index].vector_length;
 
    for (i = 0; i < vector_length; i++) {
@@ -1174,58 +2138,43 @@ void HTS_ModelSet_get_parameter(HTS_ModelSet * ms, char *string, double *mean, d
    if (msd)
       *msd = 0.0;
    for (i = 0; i < ms->stream[stream_index].interpolation_size; i++) {
-      HTS_ModelSet_get_parameter_index(ms, string, &tree_index, &pdf_index, stream_index, state_index, i);
+      HTS_ModelSet_get_parameter_index(ms, feature, &tree_index, &pdf_index, stream_index, state_index, i);
+      pdf = HTS_Model_get_pdf(&ms->stream[stream_index].model[i], tree_index, pdf_index);
       for (j = 0; j < vector_length; j++) {
-         mean[j] += iw[i] * ms->stream[stream_index].model[i].pdf[tree_index][pdf_index][j];
-         vari[j] += iw[i] * iw[i] * ms->stream[stream_index].model[i]
-             .pdf[tree_index][pdf_index][j + vector_length];
+         mean[j] += iw[i] * pdf[j];
+         vari[j] += iw[i] * iw[i] * pdf[j + vector_length];
       }
       if (ms->stream[stream_index].msd_flag) {
-         *msd += iw[i] * ms->stream[stream_index].model[i]
-             .pdf[tree_index][pdf_index][2 * vector_length];
+         *msd += iw[i] * pdf[2 * vector_length];
       }
    }
 }
 
 /* HTS_ModelSet_get_gv_index: get index of GV tree and PDF */
-void HTS_ModelSet_get_gv_index(HTS_ModelSet * ms, char *string, int *tree_index, int *pdf_index, int stream_index, int interpolation_index)
+void HTS_ModelSet_get_gv_index(const HTS_ModelSet * ms, const unsigned int *feature, int *tree_index, int *pdf_index, int stream_index, int interpolation_index)
 {
-   HTS_Tree *tree;
-   HTS_Pattern *pattern;
-   HTS_Boolean find;
+   const HTS_Model *model = &ms->gv[stream_index].model[interpolation_index];
 
-   find = FALSE;
    (*tree_index) = 2;
    (*pdf_index) = 1;
 
    if (HTS_ModelSet_have_gv_tree(ms, stream_index) == FALSE)
       return;
-   for (tree = ms->gv[stream_index].model[interpolation_index].tree; tree; tree = tree->next) {
-      pattern = tree->head;
-      if (!pattern)
-         find = TRUE;
-      for (; pattern; pattern = pattern->next)
-         if (HTS_pattern_match(string, pattern->string)) {
-            find = TRUE;
-            break;
-         }
-      if (find)
-         break;
-      (*tree_index)++;
-   }
-
-   if (tree == NULL) {
-      HTS_error(1, "HTS_ModelSet_get_gv_index: Cannot find model %s.\n", string);
+   (*tree_index) = HTS_Model_find_tree(model, -1, feature);
+   if ((*tree_index) < 0) {
+      (*tree_index) = 2;
+      HTS_error(1, "HTS_ModelSet_get_gv_index: Cannot find model of label.\n");
       return;
    }
-   (*pdf_index) = HTS_Tree_search_node(tree, string);
+   (*pdf_index) = HTS_Tree_search_node(model, &model->tree[(*tree_index) - 2], feature);
 }
 
 /* HTS_ModelSet_get_gv: get GV using interpolation weight */
-void HTS_ModelSet_get_gv(HTS_ModelSet * ms, char *string, double *mean, double *vari, int stream_index, double *iw)
+void HTS_ModelSet_get_gv(const HTS_ModelSet * ms, const unsigned int *feature, double *mean, double *vari, int stream_index, double *iw)
 {
    int i, j;
    int tree_index, pdf_index;
+   const float *pdf;
    const int vector_length = ms->gv[stream_index].vector_length;
 
    for (i = 0; i < vector_length; i++) {
@@ -1233,54 +2182,38 @@ void HTS_ModelSet_get_gv(HTS_ModelSet * ms, char *string, double *mean, double *
       vari[i] = 0.0;
    }
    for (i = 0; i < ms->gv[stream_index].interpolation_size; i++) {
-      HTS_ModelSet_get_gv_index(ms, string, &tree_index, &pdf_index, stream_index, i);
+      HTS_ModelSet_get_gv_index(ms, feature, &tree_index, &pdf_index, stream_index, i);
+      pdf = HTS_Model_get_pdf(&ms->gv[stream_index].model[i], tree_index, pdf_index);
       for (j = 0; j < vector_length; j++) {
-         mean[j] += iw[i] * ms->gv[stream_index].model[i].pdf[tree_index][pdf_index][j];
-         vari[j] += iw[i] * iw[i] * ms->gv[stream_index].model[i]
-             .pdf[tree_index][pdf_index][j + vector_length];
+         mean[j] += iw[i] * pdf[j];
+         vari[j] += iw[i] * iw[i] * pdf[j + vector_length];
       }
    }
 }
 
 /* HTS_ModelSet_get_gv_switch_index: get index of GV switch tree and PDF */
-void HTS_ModelSet_get_gv_switch_index(HTS_ModelSet * ms, char *string, int *tree_index, int *pdf_index)
+void HTS_ModelSet_get_gv_switch_index(const HTS_ModelSet * ms, const unsigned int *feature, int *tree_index, int *pdf_index)
 {
-   HTS_Tree *tree;
-   HTS_Pattern *pattern;
-   HTS_Boolean find;
+   const HTS_Model *model = &ms->gv_switch;
 
-   find = FALSE;
-   (*tree_index) = 2;
+   (*tree_index) = HTS_Model_find_tree(model, -1, feature);
    (*pdf_index) = 1;
-   for (tree = ms->gv_switch.tree; tree; tree = tree->next) {
-      pattern = tree->head;
-      if (!pattern)
-         find = TRUE;
-      for (; pattern; pattern = pattern->next)
-         if (HTS_pattern_match(string, pattern->string)) {
-            find = TRUE;
-            break;
-         }
-      if (find)
-         break;
-      (*tree_index)++;
-   }
-
-   if (tree == NULL) {
-      HTS_error(1, "HTS_ModelSet_get_gv_switch_index: Cannot find model %s.\n", string);
+   if ((*tree_index) < 0) {
+      (*tree_index) = 2;
+      HTS_error(1, "HTS_ModelSet_get_gv_switch_index: Cannot find model of label.\n");
       return;
    }
-   (*pdf_index) = HTS_Tree_search_node(tree, string);
+   (*pdf_index) = HTS_Tree_search_node(model, &model->tree[(*tree_index) - 2], feature);
 }
 
 /* HTS_ModelSet_get_gv_switch: get GV switch */
-HTS_Boolean HTS_ModelSet_get_gv_switch(HTS_ModelSet * ms, char *string)
+HTS_Boolean HTS_ModelSet_get_gv_switch(const HTS_ModelSet * ms, const unsigned int *feature)
 {
    int tree_index, pdf_index;
 
    if (ms->gv_switch.tree == NULL)
       return TRUE;
-   HTS_ModelSet_get_gv_switch_index(ms, string, &tree_index, &pdf_index);
+   HTS_ModelSet_get_gv_switch_index(ms, feature, &tree_index, &pdf_index);
    if (pdf_index == 1)
       return FALSE;
    else
@@ -1304,6 +2237,9 @@ void HTS_ModelSet_clear(HTS_ModelSet * ms)
       HTS_free(ms->gv);
    }
    HTS_Model_clear(&ms->gv_switch);
+   HTS_Model_clear(&ms->pattern);
+   HTS_FeatureSet_clear(&ms->feature);
+   HTS_Image_close(&ms->image);
    HTS_ModelSet_initialize(ms, -1);
 }
 
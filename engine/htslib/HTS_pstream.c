@@ -75,188 +75,321 @@ static double HTS_finv(const double x)
    return (1.0 / x);
 }
 
-/* HTS_PStream_calc_wuw_and_wum: calcurate W'U^{-1}W and W'U^{-1}M */
-static void HTS_PStream_calc_wuw_and_wum(HTS_PStream * pst, const int m)
+/* The parameter generation solves the static dimensions [m0, m1) together.             */
+/* The matrices are stored frame by frame with the dimensions in the innermost position, */
+/* i.e. wuw[t][i * static_length + m], wum[t][m], g[t][m] and par[t][m],                 */
+/* so that the innermost loops run over contiguous dimensions and can be vectorized.     */
+/* Each dimension is still calculated by the same operations in the same order.          */
+
+/* HTS_PStream_calc_wuw_and_wum: calcurate W'U^{-1}W and W'U^{-1}M for dimensions [m0, m1) and frames [start, end) */
+static void HTS_PStream_calc_wuw_and_wum(HTS_PStream * pst, const int m0, const int m1, const int start, const int end)
 {
-   int t, i, j, k;
-   double wu;
+   int t, i, j, k, m;
+   const int len = pst->static_length;
+   double coef, coef2;
+   double *wum, *wuw, *mean, *ivar;
 
-   for (t = 0; t < pst->length; t++) {
+   for (t = start; t < end; t++) {
       /* initialize */
-      pst->sm.wum[t] = 0.0;
-      for (i = 0; i < pst->width; i++)
-         pst->sm.wuw[t][i] = 0.0;
+      wum = pst->sm.wum[t];
+      for (m = m0; m < m1; m++)
+         wum[m] = 0.0;
+      for (i = 0; i < pst->width; i++) {
+         wuw = pst->sm.wuw[t] + i * len;
+         for (m = m0; m < m1; m++)
+            wuw[m] = 0.0;
+      }
 
       /* calc WUW & WUM */
       for (i = 0; i < pst->win_size; i++)
          for (j = pst->win_l_width[i]; j <= pst->win_r_width[i]; j++)
-            if ((t + j >= 0) && (t + j < pst->length)
+            if ((t + j >= start) && (t + j < end)
+                && (t + j + pst->win_l_width[i] >= start) && (t + j + pst->win_r_width[i] < end)
                 && (pst->win_coefficient[i][-j] != 0.0)) {
-               wu = pst->win_coefficient[i][-j] * pst->sm.ivar[t + j][i * pst->static_length + m];
-               pst->sm.wum[t] += wu * pst->sm.mean[t + j][i * pst->static_length + m];
-               for (k = 0; (k < pst->width) && (t + k < pst->length); k++)
+               coef = pst->win_coefficient[i][-j];
+               mean = pst->sm.mean[t + j] + i * len;
+               ivar = pst->sm.ivar[t + j] + i * len;
+               for (m = m0; m < m1; m++)
+                  wum[m] += (coef * ivar[m]) * mean[m];
+               for (k = 0; (k < pst->width) && (t + k < end); k++)
                   if ((k - j <= pst->win_r_width[i])
-                      && (pst->win_coefficient[i][k - j] != 0.0))
-                     pst->sm.wuw[t][k] += wu * pst->win_coefficient[i][k - j];
+                      && (pst->win_coefficient[i][k - j] != 0.0)) {
+                     coef2 = pst->win_coefficient[i][k - j];
+                     wuw = pst->sm.wuw[t] + k * len;
+                     for (m = m0; m < m1; m++)
+                        wuw[m] += (coef * ivar[m]) * coef2;
+                  }
             }
    }
 }
 
 
-/* HTS_PStream_ldl_factorization: Factorize W'*U^{-1}*W to L*D*L' (L: lower triangular, D: diagonal) */
-static void HTS_PStream_ldl_factorization(HTS_PStream * pst)
+/* HTS_PStream_ldl_factorization: Factorize W'*U^{-1}*W to L*D*L' (L: lower triangular, D: diagonal) for dimensions [m0, m1) and frames [start, end) */
+static void HTS_PStream_ldl_factorization(HTS_PStream * pst, const int m0, const int m1, const int start, const int end)
 {
-   int t, i, j;
-
-   for (t = 0; t < pst->length; t++) {
-      for (i = 1; (i < pst->width) && (t >= i); i++)
-         pst->sm.wuw[t][0] -= pst->sm.wuw[t - i][i] * pst->sm.wuw[t - i][i] * pst->sm.wuw[t - i][0];
+   int t, i, j, m;
+   const int len = pst->static_length;
+   double *d, *wuw, *prev, *prev_d;
+
+   for (t = start; t < end; t++) {
+      d = pst->sm.wuw[t];
+      for (i = 1; (i < pst->width) && (t - start >= i); i++) {
+         prev_d = pst->sm.wuw[t - i];
+         prev = prev_d + i * len;
+         for (m = m0; m < m1; m++)
+            d[m] -= prev[m] * prev[m] * prev_d[m];
+      }
 
       for (i = 1; i < pst->width; i++) {
-         for (j = 1; (i + j < pst->width) && (t >= j); j++)
-            pst->sm.wuw[t][i] -= pst->sm.wuw[t - j][j] * pst->sm.wuw[t - j][i + j] * pst->sm.wuw[t - j][0];
-         pst->sm.wuw[t][i] /= pst->sm.wuw[t][0];
+         wuw = pst->sm.wuw[t] + i * len;
+         for (j = 1; (i + j < pst->width) && (t - start >= j); j++) {
+            prev_d = pst->sm.wuw[t - j];
+            for (m = m0; m < m1; m++)
+               wuw[m] -= prev_d[j * len + m] * prev_d[(i + j) * len + m] * prev_d[m];
+         }
+         for (m = m0; m < m1; m++)
+            wuw[m] /= d[m];
       }
    }
 }
 
-/* HTS_PStream_forward_substitution: forward subtitution for mlpg */
-static void HTS_PStream_forward_substitution(HTS_PStream * pst)
+/* HTS_PStream_forward_substitution: forward subtitution for mlpg for dimensions [m0, m1) and frames [start, end) */
+static void HTS_PStream_forward_substitution(HTS_PStream * pst, const int m0, const int m1, const int start, const int end)
 {
-   int t, i;
-
-   for (t = 0; t < pst->length; t++) {
-      pst->sm.g[t] = pst->sm.wum[t];
-      for (i = 1; (i < pst->width) && (t >= i); i++)
-         pst->sm.g[t] -= pst->sm.wuw[t - i][i] * pst->sm.g[t - i];
+   int t, i, m;
+   double *g, *prev_g, *wuw;
+
+   for (t = start; t < end; t++) {
+      g = pst->sm.g[t];
+      for (m = m0; m < m1; m++)
+         g[m] = pst->sm.wum[t][m];
+      for (i = 1; (i < pst->width) && (t - start >= i); i++) {
+         prev_g = pst->sm.g[t - i];
+         wuw = pst->sm.wuw[t - i] + i * pst->static_length;
+         for (m = m0; m < m1; m++)
+            g[m] -= wuw[m] * prev_g[m];
+      }
    }
 }
 
-/* HTS_PStream_backward_substitution: backward subtitution for mlpg */
-static void HTS_PStream_backward_substitution(HTS_PStream * pst, const int m)
+/* HTS_PStream_backward_substitution: backward subtitution for mlpg for dimensions [m0, m1) and frames [start, end), parameters are output for frames [output, end) */
+static void HTS_PStream_backward_substitution(HTS_PStream * pst, const int m0, const int m1, const int output, const int end)
 {
-   int t, i;
-
-   for (t = pst->length - 1; t >= 0; t--) {
-      pst->par[t][m] = pst->sm.g[t] / pst->sm.wuw[t][0];
-      for (i = 1; (i < pst->width) && (t + i < pst->length); i++)
-         pst->par[t][m] -= pst->sm.wuw[t][i] * pst->par[t + i][m];
+   int t, i, m;
+   double *par, *next_par, *wuw;
+
+   for (t = end - 1; t >= output; t--) {
+      par = pst->par[t];
+      wuw = pst->sm.wuw[t];
+      for (m = m0; m < m1; m++)
+         par[m] = pst->sm.g[t][m] / wuw[m];
+      for (i = 1; (i < pst->width) && (t + i < end); i++) {
+         next_par = pst->par[t + i];
+         wuw = pst->sm.wuw[t] + i * pst->static_length;
+         for (m = m0; m < m1; m++)
+            par[m] -= wuw[m] * next_par[m];
+      }
    }
 }
 
 /* HTS_PStream_calc_gv: subfunction for mlpg using GV */
-static void HTS_PStream_calc_gv(HTS_PStream * pst, const int m, double *mean, double *vari)
+static void HTS_PStream_calc_gv(HTS_PStream * pst, const int m0, const int m1, double *mean, double *vari)
 {
-   int t;
+   int t, m;
+   double *par;
 
-   *mean = 0.0;
+   for (m = m0; m < m1; m++)
+      mean[m] = 0.0;
    for (t = 0; t < pst->length; t++)
-      if (pst->gv_switch[t])
-         *mean += pst->par[t][m];
-   *mean /= pst->gv_length;
-   *vari = 0.0;
+      if (pst->gv_switch[t]) {
+         par = pst->par[t];
+         for (m = m0; m < m1; m++)
+            mean[m] += par[m];
+      }
+   for (m = m0; m < m1; m++) {
+      mean[m] /= pst->gv_length;
+      vari[m] = 0.0;
+   }
    for (t = 0; t < pst->length; t++)
-      if (pst->gv_switch[t])
-         *vari += (pst->par[t][m] - *mean) * (pst->par[t][m] - *mean);
-   *vari /= pst->gv_length;
+      if (pst->gv_switch[t]) {
+         par = pst->par[t];
+         for (m = m0; m < m1; m++)
+            vari[m] += (par[m] - mean[m]) * (par[m] - mean[m]);
+      }
+   for (m = m0; m < m1; m++)
+      vari[m] /= pst->gv_length;
 }
 
 /* HTS_PStream_conv_gv: subfunction for mlpg using GV */
-static void HTS_PStream_conv_gv(HTS_PStream * pst, const int m)
+static void HTS_PStream_conv_gv(HTS_PStream * pst, const int m0, const int m1, double *mean, double *vari, double *ratio)
 {
-   int t;
-   double ratio;
-   double mean;
-   double vari;
+   int t, m;
+   double *par;
 
-   HTS_PStream_calc_gv(pst, m, &mean, &vari);
-   ratio = sqrt(pst->gv_mean[m] / vari);
+   HTS_PStream_calc_gv(pst, m0, m1, mean, vari);
+   for (m = m0; m < m1; m++)
+      ratio[m] = sqrt(pst->gv_mean[m] / vari[m]);
    for (t = 0; t < pst->length; t++)
-      if (pst->gv_switch[t])
-         pst->par[t][m] = ratio * (pst->par[t][m] - mean) + mean;
+      if (pst->gv_switch[t]) {
+         par = pst->par[t];
+         for (m = m0; m < m1; m++)
+            par[m] = ratio[m] * (par[m] - mean[m]) + mean[m];
+      }
 }
 
-/* HTS_PStream_calc_derivative: subfunction for mlpg using GV */
-static double HTS_PStream_calc_derivative(HTS_PStream * pst, const int m)
+/* HTS_PStream_calc_derivative: subfunction for mlpg using GV, the objective of each dimension is returned in obj */
+static void HTS_PStream_calc_derivative(HTS_PStream * pst, const int m0, const int m1, double *mean, double *vari, double *dv, double *hmmobj, double *obj)
 {
-   int t, i;
-   double mean;
-   double vari;
-   double dv;
+   int t, i, m;
    double h;
-   double gvobj;
-   double hmmobj;
+   double *g, *par, *wuw;
+   const int len = pst->static_length;
    const double w = 1.0 / (pst->win_size * pst->length);
 
-   HTS_PStream_calc_gv(pst, m, &mean, &vari);
-   gvobj = -0.5 * W2 * vari * pst->gv_vari[m] * (vari - 2.0 * pst->gv_mean[m]);
-   dv = -2.0 * pst->gv_vari[m] * (vari - pst->gv_mean[m]) / pst->length;
+   HTS_PStream_calc_gv(pst, m0, m1, mean, vari);
+   for (m = m0; m < m1; m++) {
+      obj[m] = -0.5 * W2 * vari[m] * pst->gv_vari[m] * (vari[m] - 2.0 * pst->gv_mean[m]);  /* GV objective */
+      dv[m] = -2.0 * pst->gv_vari[m] * (vari[m] - pst->gv_mean[m]) / pst->length;
+      hmmobj[m] = 0.0;
+   }
 
    for (t = 0; t < pst->length; t++) {
-      pst->sm.g[t] = pst->sm.wuw[t][0] * pst->par[t][m];
+      g = pst->sm.g[t];
+      par = pst->par[t];
+      wuw = pst->sm.wuw[t];
+      for (m = m0; m < m1; m++)
+         g[m] = wuw[m] * par[m];
       for (i = 1; i < pst->width; i++) {
-         if (t + i < pst->length)
-            pst->sm.g[t] += pst->sm.wuw[t][i] * pst->par[t + i][m];
-         if (t + 1 > i)
-            pst->sm.g[t] += pst->sm.wuw[t - i][i] * pst->par[t - i][m];
+         if (t + i < pst->length) {
+            wuw = pst->sm.wuw[t] + i * len;
+            par = pst->par[t + i];
+            for (m = m0; m < m1; m++)
+               g[m] += wuw[m] * par[m];
+         }
+         if (t + 1 > i) {
+            wuw = pst->sm.wuw[t - i] + i * len;
+            par = pst->par[t - i];
+            for (m = m0; m < m1; m++)
+               g[m] += wuw[m] * par[m];
+         }
       }
    }
 
-   for (t = 0, hmmobj = 0.0; t < pst->length; t++) {
-      hmmobj += W1 * w * pst->par[t][m] * (pst->sm.wum[t] - 0.5 * pst->sm.g[t]);
-      h = -W1 * w * pst->sm.wuw[t][1 - 1] - W2 * 2.0 / (pst->length * pst->length) * ((pst->length - 1) * pst->gv_vari[m] * (vari - pst->gv_mean[m]) + 2.0 * pst->gv_vari[m] * (pst->par[t][m] - mean) * (pst->par[t][m] - mean));
-      if (pst->gv_switch[t])
-         pst->sm.g[t] = 1.0 / h * (W1 * w * (-pst->sm.g[t] + pst->sm.wum[t]) + W2 * dv * (pst->par[t][m] - mean));
-      else
-         pst->sm.g[t] = 1.0 / h * (W1 * w * (-pst->sm.g[t] + pst->sm.wum[t]));
+   for (t = 0; t < pst->length; t++) {
+      g = pst->sm.g[t];
+      par = pst->par[t];
+      wuw = pst->sm.wuw[t];
+      for (m = m0; m < m1; m++) {
+         hmmobj[m] += W1 * w * par[m] * (pst->sm.wum[t][m] - 0.5 * g[m]);
+         h = -W1 * w * wuw[m] - W2 * 2.0 / (pst->length * pst->length) * ((pst->length - 1) * pst->gv_vari[m] * (vari[m] - pst->gv_mean[m]) + 2.0 * pst->gv_vari[m] * (par[m] - mean[m]) * (par[m] - mean[m]));
+         if (pst->gv_switch[t])
+            g[m] = 1.0 / h * (W1 * w * (-g[m] + pst->sm.wum[t][m]) + W2 * dv[m] * (par[m] - mean[m]));
+         else
+            g[m] = 1.0 / h * (W1 * w * (-g[m] + pst->sm.wum[t][m]));
+      }
    }
 
-   return (-(hmmobj + gvobj));
+   for (m = m0; m < m1; m++)
+      obj[m] = -(hmmobj[m] + obj[m]);
 }
 
-/* HTS_PStream_gv_parmgen: function for mlpg using GV */
-static void HTS_PStream_gv_parmgen(HTS_PStream * pst, const int m)
+/* HTS_PStream_gv_parmgen: function for mlpg using GV for dimensions [m0, m1), work is a buffer of 7 * static_length */
+static void HTS_PStream_gv_parmgen(HTS_PStream * pst, const int m0, const int m1, double *work)
 {
-   int t, i;
-   double step = STEPINIT;
-   double prev = -LZERO;
-   double obj;
+   int t, i, m;
+   const int len = pst->static_length;
+   double *mean = work;
+   double *vari = work + len;
+   double *dv = work + 2 * len;
+   double *hmmobj = work + 3 * len;
+   double *obj = work + 4 * len;
+   double *step = work + 5 * len;
+   double *prev = work + 6 * len;
+   double *par;
 
    if (pst->gv_length == 0)
       return;
 
-   HTS_PStream_conv_gv(pst, m);
+   HTS_PStream_conv_gv(pst, m0, m1, mean, vari, obj);
    if (GV_MAX_ITERATION > 0) {
-      HTS_PStream_calc_wuw_and_wum(pst, m);
+      HTS_PStream_calc_wuw_and_wum(pst, m0, m1, 0, pst->length);
+      for (m = m0; m < m1; m++) {
+         step[m] = STEPINIT;
+         prev[m] = -LZERO;
+      }
       for (i = 1; i <= GV_MAX_ITERATION; i++) {
-         obj = HTS_PStream_calc_derivative(pst, m);
-         if (obj > prev)
-            step *= STEPDEC;
-         if (obj < prev)
-            step *= STEPINC;
-         for (t = 0; t < pst->length; t++)
-            pst->par[t][m] += step * pst->sm.g[t];
-         prev = obj;
+         HTS_PStream_calc_derivative(pst, m0, m1, mean, vari, dv, hmmobj, obj);
+         for (m = m0; m < m1; m++) {
+            if (obj[m] > prev[m])
+               step[m] *= STEPDEC;
+            if (obj[m] < prev[m])
+               step[m] *= STEPINC;
+         }
+         for (t = 0; t < pst->length; t++) {
+            par = pst->par[t];
+            for (m = m0; m < m1; m++)
+               par[m] += step[m] * pst->sm.g[t][m];
+         }
+         for (m = m0; m < m1; m++)
+            prev[m] = obj[m];
       }
    }
 }
 
 /* HTS_PStream_mlpg: generate sequence of speech parameter vector maximizing its output probability for given pdf sequence */
-static void HTS_PStream_mlpg(HTS_PStream * pst)
+static void HTS_PStream_mlpg(HTS_PStream * pst, const int dim_block)
 {
-   int m;
+   int m0, m1;
+   const int block = (dim_block > 0) ? dim_block : pst->static_length;
+   double *work;
 
    if (pst->length == 0)
       return;
 
-   for (m = 0; m < pst->static_length; m++) {
-      HTS_PStream_calc_wuw_and_wum(pst, m);
-      HTS_PStream_ldl_factorization(pst);       /* LDL factorization */
-      HTS_PStream_forward_substitution(pst);    /* forward substitution   */
-      HTS_PStream_backward_substitution(pst, m);        /* backward substitution  */
+   work = (pst->gv_length > 0) ? (double *) HTS_calloc(7 * pst->static_length, sizeof(double)) : NULL;
+   for (m0 = 0; m0 < pst->static_length; m0 += block) {
+      m1 = (m0 + block < pst->static_length) ? m0 + block : pst->static_length;
+      HTS_PStream_calc_wuw_and_wum(pst, m0, m1, 0, pst->length);
+      HTS_PStream_ldl_factorization(pst, m0, m1, 0, pst->length);       /* LDL factorization */
+      HTS_PStream_forward_substitution(pst, m0, m1, 0, pst->length);    /* forward substitution   */
+      HTS_PStream_backward_substitution(pst, m0, m1, 0, pst->length);   /* backward substitution  */
       if (pst->gv_length > 0)
-         HTS_PStream_gv_parmgen(pst, m);
+         HTS_PStream_gv_parmgen(pst, m0, m1, work);
    }
+   if (work)
+      HTS_free(work);
+   pst->generated = pst->length;
+}
+
+/* HTS_PStream_mlpg_window: generate parameters of frames [start, end) by solving mlpg in window extended by overlap frames, conditioned on generated frames before start */
+static void HTS_PStream_mlpg_window(HTS_PStream * pst, const int start, const int end, const int overlap, const int dim_block)
+{
+   int t, i, m, m0, m1;
+   const int block = (dim_block > 0) ? dim_block : pst->static_length;
+   const int win_start = (start - pst->width > 0) ? start - pst->width : 0;
+   const int win_end = (end + overlap < pst->length) ? end + overlap : pst->length;
+   double *wum, *wuw, *par;
+
+   if (start >= end)
+      return;
+
+   for (m0 = 0; m0 < pst->static_length; m0 += block) {
+      m1 = (m0 + block < pst->static_length) ? m0 + block : pst->static_length;
+      HTS_PStream_calc_wuw_and_wum(pst, m0, m1, win_start, win_end);
+      /* move the terms of generated frames to right-hand side */
+      for (t = start; (t < start + pst->width) && (t < win_end); t++)
+         for (i = t - start + 1; (i < pst->width) && (t - i >= win_start); i++) {
+            wum = pst->sm.wum[t];
+            wuw = pst->sm.wuw[t - i] + i * pst->static_length;
+            par = pst->par[t - i];
+            for (m = m0; m < m1; m++)
+               wum[m] -= wuw[m] * par[m];
+         }
+      HTS_PStream_ldl_factorization(pst, m0, m1, start, win_end);
+      HTS_PStream_forward_substitution(pst, m0, m1, start, win_end);
+      HTS_PStream_backward_substitution(pst, m0, m1, start, win_end);
+   }
+   pst->generated = end;
 }
 
 /* HTS_PStreamSet_initialize: initialize parameter stream set */
@@ -265,10 +398,25 @@ void HTS_PStreamSet_initialize(HTS_PStreamSet * pss)
    pss->pstream = NULL;
    pss->nstream = 0;
    pss->total_frame = 0;
+   pss->generated_frame = 0;
+   pss->overlap = 0;
+   pss->dim_block = 0;
+}
+
+/* HTS_PStreamSet_set_dim_block: set number of static dimensions solved together in parameter generation (0 for all dimensions) */
+void HTS_PStreamSet_set_dim_block(HTS_PStreamSet * pss, int dim_block)
+{
+   pss->dim_block = (dim_block > 0) ? dim_block : 0;
 }
 
 /* HTS_PStreamSet_create: parameter generation using GV weight */
 HTS_Boolean HTS_PStreamSet_create(HTS_PStreamSet * pss, HTS_SStreamSet * sss, double *msd_threshold, double *gv_weight)
+{
+   return HTS_PStreamSet_create_window(pss, sss, msd_threshold, gv_weight, 0);
+}
+
+/* HTS_PStreamSet_create_window: prepare parameter generation in windows of given overlap (0 to generate whole utterance at once) */
+HTS_Boolean HTS_PStreamSet_create_window(HTS_PStreamSet * pss, HTS_SStreamSet * sss, double *msd_threshold, double *gv_weight, int overlap)
 {
    int i, j, k, l, m;
    int frame, msd_frame, state;
@@ -285,6 +433,8 @@ HTS_Boolean HTS_PStreamSet_create(HTS_PStreamSet * pss, HTS_SStreamSet * sss, do
    pss->nstream = HTS_SStreamSet_get_nstream(sss);
    pss->pstream = (HTS_PStream *) HTS_calloc(pss->nstream, sizeof(HTS_PStream));
    pss->total_frame = HTS_SStreamSet_get_total_frame(sss);
+   pss->overlap = overlap;
+   pss->generated_frame = (overlap > 0) ? 0 : pss->total_frame;
 
    /* create */
    for (i = 0; i < pss->nstream; i++) {
@@ -315,9 +465,9 @@ HTS_Boolean HTS_PStreamSet_create(HTS_PStreamSet * pss, HTS_SStreamSet * sss, do
       pst->static_length = pst->vector_length / pst->win_size;
       pst->sm.mean = HTS_alloc_matrix(pst->length, pst->vector_length);
       pst->sm.ivar = HTS_alloc_matrix(pst->length, pst->vector_length);
-      pst->sm.wum = (double *) HTS_calloc(pst->length, sizeof(double));
-      pst->sm.wuw = HTS_alloc_matrix(pst->length, pst->width);
-      pst->sm.g = (double *) HTS_calloc(pst->length, sizeof(double));
+      pst->sm.wum = HTS_alloc_matrix(pst->length, pst->static_length);
+      pst->sm.wuw = HTS_alloc_matrix(pst->length, pst->width * pst->static_length);
+      pst->sm.g = HTS_alloc_matrix(pst->length, pst->static_length);
       pst->par = HTS_alloc_matrix(pst->length, pst->static_length);
       /* copy dynamic window */
       pst->win_l_width = (int *) HTS_calloc(pst->win_size, sizeof(int));
@@ -413,13 +563,44 @@ HTS_Boolean HTS_PStreamSet_create(HTS_PStreamSet * pss, HTS_SStreamSet * sss, do
             }
          }
       }
-      /* parameter generation */
-      HTS_PStream_mlpg(pst);
+      /* parameter generation (GV is calculated over whole utterance, hence it is not generated in windows) */
+      pst->generated = 0;
+      if (overlap <= 0 || pst->gv_length > 0)
+         HTS_PStream_mlpg(pst, pss->dim_block);
    }
 
    return TRUE;
 }
 
+/* HTS_PStreamSet_generate_until: generate parameters of all streams until given frame (exclusive) */
+void HTS_PStreamSet_generate_until(HTS_PStreamSet * pss, int frame)
+{
+   int i, j, end;
+   HTS_PStream *pst;
+
+   if (frame > pss->total_frame)
+      frame = pss->total_frame;
+   if (frame <= pss->generated_frame)
+      return;
+
+   for (i = 0; i < pss->nstream; i++) {
+      pst = &pss->pstream[i];
+      if (pst->generated >= pst->length)
+         continue;
+      if (frame == pss->total_frame) {
+         end = pst->length;
+      } else if (pst->msd_flag) {       /* for MSD */
+         for (j = pss->generated_frame, end = pst->generated; j < frame; j++)
+            if (pst->msd_flag[j])
+               end++;
+      } else {                  /* for non MSD */
+         end = frame;
+      }
+      HTS_PStream_mlpg_window(pst, pst->generated, end, pss->overlap, pss->dim_block);
+   }
+   pss->generated_frame = frame;
+}
+
 /* HTS_PStreamSet_get_nstream: get number of stream */
 int HTS_PStreamSet_get_nstream(HTS_PStreamSet * pss)
 {
@@ -465,14 +646,14 @@ HTS_Boolean HTS_PStreamSet_is_msd(HTS_PStreamSet * pss, int stream_index)
 /* HTS_PStreamSet_clear: free parameter stream set */
 void HTS_PStreamSet_clear(HTS_PStreamSet * pss)
 {
-   int i, j;
+   int i, j, dim_block;
    HTS_PStream *pstream;
 
    if (pss->pstream) {
       for (i = 0; i < pss->nstream; i++) {
          pstream = &pss->pstream[i];
-         HTS_free(pstream->sm.wum);
-         HTS_free(pstream->sm.g);
+         HTS_free_matrix(pstream->sm.wum, pstream->length);
+         HTS_free_matrix(pstream->sm.g, pstream->length);
          HTS_free_matrix(pstream->sm.wuw, pstream->length);
          HTS_free_matrix(pstream->sm.ivar, pstream->length);
          HTS_free_matrix(pstream->sm.mean, pstream->length);
@@ -495,7 +676,9 @@ void HTS_PStreamSet_clear(HTS_PStreamSet * pss)
       }
       HTS_free(pss->pstream);
    }
+   dim_block = pss->dim_block;
    HTS_PStreamSet_initialize(pss);
+   pss->dim_block = dim_block;         /* setting is kept for next utterance */
 }
 
 HTS_PSTREAM_C_END;
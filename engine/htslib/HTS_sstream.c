@@ -143,6 +143,21 @@ static double HTS_set_duration(int *duration, double *mean, double *vari, int si
    return (double) target_length;
 }
 
+/* HTS_normalize_weight: copy interpolation weights and normalize them (given weights are not modified) */
+static double *HTS_normalize_weight(double *iw, int size)
+{
+   int i;
+   double temp;
+   double *w = (double *) HTS_calloc(size, sizeof(double));
+
+   for (i = 0, temp = 0.0; i < size; i++)
+      temp += iw[i];
+   for (i = 0; i < size; i++)
+      if (iw[i] != 0.0)
+         w[i] = iw[i] / temp;
+   return w;
+}
+
 /* HTS_SStreamSet_initialize: initialize state stream set */
 void HTS_SStreamSet_initialize(HTS_SStreamSet * sss)
 {
@@ -155,13 +170,14 @@ void HTS_SStreamSet_initialize(HTS_SStreamSet * sss)
 }
 
 /* HTS_SStreamSet_create: parse label and determine state duration */
-HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_Label * label, double *duration_iw, double **parameter_iw, double **gv_iw)
+HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, const HTS_ModelSet * ms, HTS_Label * label, double *duration_iw, double **parameter_iw, double **gv_iw)
 {
    int i, j, k;
    double temp;
    int state;
    HTS_SStream *sst;
    double *duration_mean, *duration_vari;
+   double *duration_w, **parameter_w, **gv_w;
    double frame_length;
    int next_time;
    int next_state;
@@ -183,6 +199,13 @@ HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_L
       }
    }
 
+   /* parse labels into context features once, unless they are given */
+   if (HTS_Label_get_feature(label, 0) == NULL) {
+      HTS_Label_set_feature_size(label, HTS_ModelSet_get_feature_size(ms));
+      for (i = 0; i < HTS_Label_get_size(label); i++)
+         HTS_ModelSet_get_feature(ms, HTS_Label_get_string(label, i), HTS_Label_get_feature(label, i));
+   }
+
    /* initialize state sequence */
    sss->nstate = HTS_ModelSet_get_nstate(ms);
    sss->nstream = HTS_ModelSet_get_nstream(ms);
@@ -208,32 +231,23 @@ HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_L
          sst->gv_switch[j] = TRUE;
    }
 
-   /* check interpolation weights */
-   for (i = 0, temp = 0.0; i < HTS_ModelSet_get_duration_interpolation_size(ms); i++)
-      temp += duration_iw[i];
-   for (i = 0; i < HTS_ModelSet_get_duration_interpolation_size(ms); i++)
-      if (duration_iw[i] != 0.0)
-         duration_iw[i] /= temp;
+   /* normalize interpolation weights */
+   duration_w = HTS_normalize_weight(duration_iw, HTS_ModelSet_get_duration_interpolation_size(ms));
+   parameter_w = (double **) HTS_calloc(sss->nstream, sizeof(double *));
+   gv_w = (double **) HTS_calloc(sss->nstream, sizeof(double *));
    for (i = 0; i < sss->nstream; i++) {
-      for (j = 0, temp = 0.0; j < HTS_ModelSet_get_parameter_interpolation_size(ms, i); j++)
-         temp += parameter_iw[i][j];
-      for (j = 0; j < HTS_ModelSet_get_parameter_interpolation_size(ms, i); j++)
-         if (parameter_iw[i][j] != 0.0)
-            parameter_iw[i][j] /= temp;
-      if (HTS_ModelSet_use_gv(ms, i)) {
-         for (j = 0, temp = 0.0; j < HTS_ModelSet_get_gv_interpolation_size(ms, i); j++)
-            temp += gv_iw[i][j];
-         for (j = 0; j < HTS_ModelSet_get_gv_interpolation_size(ms, i); j++)
-            if (gv_iw[i][j] != 0.0)
-               gv_iw[i][j] /= temp;
-      }
+      parameter_w[i] = HTS_normalize_weight(parameter_iw[i], HTS_ModelSet_get_parameter_interpolation_size(ms, i));
+      if (HTS_ModelSet_use_gv(ms, i))
+         gv_w[i] = HTS_normalize_weight(gv_iw[i], HTS_ModelSet_get_gv_interpolation_size(ms, i));
+      else
+         gv_w[i] = NULL;
    }
 
    /* determine state duration */
    duration_mean = (double *) HTS_calloc(sss->nstate * HTS_Label_get_size(label), sizeof(double));
    duration_vari = (double *) HTS_calloc(sss->nstate * HTS_Label_get_size(label), sizeof(double));
    for (i = 0; i < HTS_Label_get_size(label); i++)
-      HTS_ModelSet_get_duration(ms, HTS_Label_get_string(label, i), &duration_mean[i * sss->nstate], &duration_vari[i * sss->nstate], duration_iw);
+      HTS_ModelSet_get_duration(ms, HTS_Label_get_feature(label, i), &duration_mean[i * sss->nstate], &duration_vari[i * sss->nstate], duration_w);
    if (HTS_Label_get_frame_specified_flag(label)) {
       /* use duration set by user */
       next_time = 0;
@@ -278,9 +292,9 @@ HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_L
          for (k = 0; k < sss->nstream; k++) {
             sst = &sss->sstream[k];
             if (sst->msd)
-               HTS_ModelSet_get_parameter(ms, HTS_Label_get_string(label, i), sst->mean[state], sst->vari[state], &sst->msd[state], k, j, parameter_iw[k]);
+               HTS_ModelSet_get_parameter(ms, HTS_Label_get_feature(label, i), sst->mean[state], sst->vari[state], &sst->msd[state], k, j, parameter_w[k]);
             else
-               HTS_ModelSet_get_parameter(ms, HTS_Label_get_string(label, i), sst->mean[state], sst->vari[state], NULL, k, j, parameter_iw[k]);
+               HTS_ModelSet_get_parameter(ms, HTS_Label_get_feature(label, i), sst->mean[state], sst->vari[state], NULL, k, j, parameter_w[k]);
          }
          state++;
       }
@@ -313,7 +327,7 @@ HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_L
       if (HTS_ModelSet_use_gv(ms, i)) {
          sst->gv_mean = (double *) HTS_calloc(sst->vector_length / sst->win_size, sizeof(double));
          sst->gv_vari = (double *) HTS_calloc(sst->vector_length / sst->win_size, sizeof(double));
-         HTS_ModelSet_get_gv(ms, HTS_Label_get_string(label, 0), sst->gv_mean, sst->gv_vari, i, gv_iw[i]);
+         HTS_ModelSet_get_gv(ms, HTS_Label_get_feature(label, 0), sst->gv_mean, sst->gv_vari, i, gv_w[i]);
       } else {
          sst->gv_mean = NULL;
          sst->gv_vari = NULL;
@@ -322,11 +336,20 @@ HTS_Boolean HTS_SStreamSet_create(HTS_SStreamSet * sss, HTS_ModelSet * ms, HTS_L
 
    if (HTS_ModelSet_have_gv_switch(ms) == TRUE)
       for (i = 0; i < HTS_Label_get_size(label); i++)
-         if (HTS_ModelSet_get_gv_switch(ms, HTS_Label_get_string(label, i)) == FALSE)
+         if (HTS_ModelSet_get_gv_switch(ms, HTS_Label_get_feature(label, i)) == FALSE)
             for (j = 0; j < sss->nstream; j++)
                for (k = 0; k < sss->nstate; k++)
                   sss->sstream[j].gv_switch[i * sss->nstate + k] = FALSE;
 
+   HTS_free(duration_w);
+   for (i = 0; i < sss->nstream; i++) {
+      HTS_free(parameter_w[i]);
+      if (gv_w[i])
+         HTS_free(gv_w[i]);
+   }
+   HTS_free(parameter_w);
+   HTS_free(gv_w);
+
    return TRUE;
 }
 
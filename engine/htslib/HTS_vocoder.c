@@ -56,6 +56,7 @@
 HTS_VOCODER_C_START;
 
 #include <math.h>               /* for sqrt(),log(),exp(),pow(),cos() */
+#include <string.h>             /* for memmove() */
 
 /* hts_engine libraries */
 #include "HTS_hidden.h"
@@ -566,6 +567,222 @@ static double HTS_mglsadf(double x, const double *b, const int m, const double a
    return x;
 }
 
+/* kernels of single precision MLSA filter */
+#define HTS_KERNEL_C       0
+#define HTS_KERNEL_SSE     1
+#define HTS_KERNEL_AVX_FMA 2
+
+#if !defined(HTS_NO_SIMD)
+#if (defined(__GNUC__) && (__GNUC__ >= 5) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define HTS_SIMD_X86
+#define HTS_TARGET(t) __attribute__((target(t)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (_MSC_VER >= 1700) && (defined(_M_X64) || defined(_M_IX86))
+#define HTS_SIMD_X86
+#define HTS_TARGET(t)
+#include <intrin.h>
+#include <immintrin.h>
+#endif                          /* __GNUC__ || _MSC_VER */
+#endif                          /* !HTS_NO_SIMD */
+
+#if FLANES != 8 || PADEORDER > FLANES
+#error "The lanes of single precision MLSA filter should be 8, and not less than pade order."
+#endif                          /* FLANES != 8 || PADEORDER > FLANES */
+
+/* HTS_MlsafirLanes: FIR filters of all pade stages of MLSA filter, one lane for one stage */
+typedef void (*HTS_MlsafirLanes) (float *d, const float *x, const float *b, const int m, const float a, const float aa, float *y);
+
+/* HTS_mlsafir_lanes_c: sub functions for single precision MLSA filter (without SIMD) */
+static void HTS_mlsafir_lanes_c(float *d, const float *x, const float *b, const int m, const float a, const float aa, float *y)
+{
+   float *di;
+   int i, k;
+
+   for (k = 0; k < FLANES; k++) {
+      d[FLANES + k] = aa * x[k] + a * d[FLANES + k];
+      d[k] = d[FLANES + k];     /* d[1] is kept for next sample, as the delay lines slide by one */
+      y[k] = 0.0f;
+   }
+
+   for (i = 2, di = d + 2 * FLANES; i <= m; i++, di += FLANES)
+      for (k = 0; k < FLANES; k++) {
+         di[k] = (di[k] + a * di[FLANES + k]) - a * di[k - FLANES];
+         y[k] += di[k] * b[i];
+      }
+}
+
+#ifdef HTS_SIMD_X86
+/* HTS_mlsafir_lanes_sse: sub functions for single precision MLSA filter (SSE) */
+static HTS_TARGET("sse") void HTS_mlsafir_lanes_sse(float *d, const float *x, const float *b, const int m, const float a, const float aa, float *y)
+{
+   const __m128 va = _mm_set1_ps(a);
+   const __m128 vaa = _mm_set1_ps(aa);
+   __m128 p0, p1, y0, y1, bi;
+   float *di;
+   int i;
+
+   p0 = _mm_add_ps(_mm_mul_ps(vaa, _mm_load_ps(x)), _mm_mul_ps(va, _mm_load_ps(d + FLANES)));
+   p1 = _mm_add_ps(_mm_mul_ps(vaa, _mm_load_ps(x + 4)), _mm_mul_ps(va, _mm_load_ps(d + FLANES + 4)));
+   _mm_store_ps(d + FLANES, p0);
+   _mm_store_ps(d + FLANES + 4, p1);
+   _mm_store_ps(d, p0);         /* d[1] is kept for next sample, as the delay lines slide by one */
+   _mm_store_ps(d + 4, p1);
+   y0 = _mm_setzero_ps();
+   y1 = _mm_setzero_ps();
+
+   /* the previous delay is kept in register, only one multiplication and one subtraction depend on it */
+   for (i = 2, di = d + 2 * FLANES; i <= m; i++, di += FLANES) {
+      bi = _mm_set1_ps(b[i]);
+      p0 = _mm_sub_ps(_mm_add_ps(_mm_load_ps(di), _mm_mul_ps(va, _mm_load_ps(di + FLANES))), _mm_mul_ps(va, p0));
+      p1 = _mm_sub_ps(_mm_add_ps(_mm_load_ps(di + 4), _mm_mul_ps(va, _mm_load_ps(di + FLANES + 4))), _mm_mul_ps(va, p1));
+      _mm_store_ps(di, p0);
+      _mm_store_ps(di + 4, p1);
+      y0 = _mm_add_ps(y0, _mm_mul_ps(p0, bi));
+      y1 = _mm_add_ps(y1, _mm_mul_ps(p1, bi));
+   }
+
+   _mm_store_ps(y, y0);
+   _mm_store_ps(y + 4, y1);
+}
+
+/* HTS_mlsafir_lanes_avx: sub functions for single precision MLSA filter (AVX and FMA) */
+static HTS_TARGET("avx,fma") void HTS_mlsafir_lanes_avx(float *d, const float *x, const float *b, const int m, const float a, const float aa, float *y)
+{
+   const __m256 va = _mm256_set1_ps(a);
+   __m256 p, acc;
+   float *di;
+   int i;
+
+   p = _mm256_fmadd_ps(_mm256_set1_ps(aa), _mm256_load_ps(x), _mm256_mul_ps(va, _mm256_load_ps(d + FLANES)));
+   _mm256_store_ps(d + FLANES, p);
+   _mm256_store_ps(d, p);       /* d[1] is kept for next sample, as the delay lines slide by one */
+   acc = _mm256_setzero_ps();
+
+   /* the previous delay is kept in register, only one fused multiply-subtraction depends on it */
+   for (i = 2, di = d + 2 * FLANES; i <= m; i++, di += FLANES) {
+      p = _mm256_fnmadd_ps(va, p, _mm256_fmadd_ps(va, _mm256_load_ps(di + FLANES), _mm256_load_ps(di)));
+      _mm256_store_ps(di, p);
+      acc = _mm256_fmadd_ps(p, _mm256_set1_ps(b[i]), acc);
+   }
+
+   _mm256_store_ps(y, acc);
+   _mm256_zeroupper();
+}
+#endif                          /* HTS_SIMD_X86 */
+
+/* HTS_Vocoder_select_kernel: select kernel of single precision MLSA filter by CPU features */
+static int HTS_Vocoder_select_kernel(const int type)
+{
+#ifdef HTS_SIMD_X86
+#ifdef _MSC_VER
+   int info[4];
+#endif                          /* _MSC_VER */
+
+   if (type != HTS_VOCODER_FLOAT)
+      return HTS_KERNEL_C;
+#ifdef _MSC_VER
+   __cpuid(info, 1);
+   /* FMA, OSXSAVE and AVX, and YMM state is enabled by OS */
+   if ((info[2] & (1 << 12)) && (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6)
+      return HTS_KERNEL_AVX_FMA;
+   if (info[3] & (1 << 25))
+      return HTS_KERNEL_SSE;
+#else
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx") && __builtin_cpu_supports("fma"))
+      return HTS_KERNEL_AVX_FMA;
+   if (__builtin_cpu_supports("sse"))
+      return HTS_KERNEL_SSE;
+#endif                          /* _MSC_VER */
+#endif                          /* HTS_SIMD_X86 */
+   return HTS_KERNEL_C;
+}
+
+/* HTS_mlsadf1_float: sub functions for single precision MLSA filter */
+static float HTS_mlsadf1_float(float x, const float b1, const float a, const float aa, const int pd, float *d, const float *ppade)
+{
+   float v, out = 0.0f, *pt;
+   int i;
+
+   pt = &d[pd + 1];
+
+   for (i = pd; i >= 1; i--) {
+      d[i] = aa * pt[i - 1] + a * d[i];
+      pt[i] = d[i] * b1;
+      v = pt[i] * ppade[i];
+      x += (1 & i) ? v : -v;
+      out += v;
+   }
+
+   pt[0] = x;
+   out += x;
+
+   return (out);
+}
+
+/* HTS_mlsadf2_float: sub functions for single precision MLSA filter, the FIR filters of all pade stages are run together in lanes */
+static float HTS_mlsadf2_float(HTS_Vocoder * v, float x, const float *b, const int m, const float a, const float aa, const int pd, const float *ppade, HTS_MlsafirLanes mlsafir)
+{
+   float vv, out = 0.0f, *pt;
+   int i;
+
+   pt = &v->fd1[2 * (pd + 1)];
+
+   /* wrap the ring buffer of the delay lines */
+   if (v->fpos == 0) {
+      memmove(v->fd2 + FWINDOW * FLANES, v->fd2, (m + 2) * FLANES * sizeof(float));
+      v->fpos = FWINDOW;
+   }
+
+   /* the input of stage i is the output of stage i-1 at previous sample */
+   for (i = 0; i < pd; i++)
+      v->fin[i] = pt[i];
+   mlsafir(v->fd2 + v->fpos * FLANES, v->fin, b, m, a, aa, v->fout);
+   v->fpos--;
+
+   for (i = pd; i >= 1; i--) {
+      pt[i] = v->fout[i - 1];
+      vv = pt[i] * ppade[i];
+      x += (1 & i) ? vv : -vv;
+      out += vv;
+   }
+
+   pt[0] = x;
+   out += x;
+
+   return (out);
+}
+
+/* HTS_mglsadf_float: sub functions for single precision MGLSA filter, the delay lines slide in their ring buffers */
+static float HTS_mglsadf_float(HTS_Vocoder * v, float x, const float *b, const int m, const float a, const int n)
+{
+   const float aa = 1.0f - a * a;
+   const int size = FWINDOW + m + 1;
+   float y, *d;
+   int i, j;
+
+   /* wrap the ring buffers of the delay lines */
+   if (v->fpos == 0) {
+      for (j = 0; j < n; j++)
+         memmove(v->fd1 + j * size + FWINDOW, v->fd1 + j * size, (m + 1) * sizeof(float));
+      v->fpos = FWINDOW;
+   }
+
+   for (j = 0; j < n; j++) {
+      d = v->fd1 + j * size + v->fpos;
+      y = d[0] * b[1];
+      for (i = 1; i < m; i++) {
+         d[i] = (d[i] + a * d[i + 1]) - a * d[i - 1];
+         y += d[i] * b[i + 1];
+      }
+      x -= y;
+      d[-1] = a * d[0] + aa * x;        /* d[i] becomes d[i+1] by sliding instead of shifting */
+   }
+   v->fpos--;
+
+   return x;
+}
+
 /* HTS_white_noise: return white noise */
 static double HTS_white_noise(HTS_Vocoder * v)
 {
@@ -701,9 +918,82 @@ static void HTS_Vocoder_end_excitation(HTS_Vocoder * v, const int nlpf)
    v->p1 = v->p;
 }
 
+/* HTS_Vocoder_synthesize_float: filter the excitation of one frame in single precision */
+static void HTS_Vocoder_synthesize_float(HTS_Vocoder * v, const int m, const int nlpf, double *lpf, double alpha, double volume, short *rawdata, HTS_Audio * audio)
+{
+   const float a = (float) alpha;
+   const float aa = 1.0f - a * a;
+   const float fvolume = (float) volume;
+   float ppade[PADEORDER + 1];
+   HTS_MlsafirLanes mlsafir = HTS_mlsafir_lanes_c;
+   float x;
+   int i, j, k;
+   short xs;
+
+#ifdef HTS_SIMD_X86
+   if (v->kernel == HTS_KERNEL_AVX_FMA)
+      mlsafir = HTS_mlsafir_lanes_avx;
+   else if (v->kernel == HTS_KERNEL_SSE)
+      mlsafir = HTS_mlsafir_lanes_sse;
+#endif                          /* HTS_SIMD_X86 */
+
+   /* excitation of whole frame */
+   for (j = 0, i = (v->iprd + 1) / 2; j < v->fprd; j++) {
+      v->fx[j] = (float) HTS_Vocoder_get_excitation(v, j, i, nlpf, lpf);
+      if (!--i)
+         i = v->iprd;
+   }
+
+   for (i = 0; i <= m; i++) {
+      v->fc[i] = (float) v->c[i];
+      v->finc[i] = (float) v->cinc[i];
+   }
+   for (i = 0; i <= PADEORDER; i++)
+      ppade[i] = (float) HTS_pade[PADEORDER * (PADEORDER + 1) / 2 + i];
+
+   /* filter */
+   for (j = 0, i = (v->iprd + 1) / 2; j < v->fprd; j++) {
+      x = v->fx[j];
+      if (v->stage == 0) {      /* for MCP */
+         if (x != 0.0f)
+            x *= (float) exp(v->fc[0]);
+         x = HTS_mlsadf1_float(x, v->fc[1], a, aa, PADEORDER, v->fd1, ppade);
+         x = HTS_mlsadf2_float(v, x, v->fc, m, a, aa, PADEORDER, ppade, mlsafir);
+      } else {                  /* for LSP */
+         if (!NGAIN)
+            x *= v->fc[0];
+         x = HTS_mglsadf_float(v, x, v->fc, m, a, v->stage);
+      }
+      v->fx[j] = x * fvolume;
+
+      if (!--i) {
+         for (k = 0; k <= m; k++)
+            v->fc[k] += v->finc[k];
+         i = v->iprd;
+      }
+   }
+
+   /* output */
+   for (j = 0; j < v->fprd; j++) {
+      x = v->fx[j];
+      if (x > 32767.0f)
+         xs = 32767;
+      else if (x < -32768.0f)
+         xs = -32768;
+      else
+         xs = (short) x;
+      if (rawdata)
+         rawdata[j] = xs;
+      if (audio)
+         HTS_Audio_write(audio, xs);
+   }
+}
+
 /* HTS_Vocoder_initialize: initialize vocoder */
-void HTS_Vocoder_initialize(HTS_Vocoder * v, const int m, const int stage, HTS_Boolean use_log_gain, const int rate, const int fperiod)
+void HTS_Vocoder_initialize(HTS_Vocoder * v, const int m, const int stage, HTS_Boolean use_log_gain, const int rate, const int fperiod, const int type)
 {
+   int size;
+
    /* set parameter */
    v->stage = stage;
    if (stage != 0)
@@ -743,6 +1033,47 @@ void HTS_Vocoder_initialize(HTS_Vocoder * v, const int m, const int stage, HTS_B
       v->d1 = v->cinc + m + 1;
    }
    v->pulse_list = (double *) HTS_calloc(PULSELISTSIZE, sizeof(double));
+   /* for single precision filter */
+   v->type = type;
+   v->kernel = HTS_Vocoder_select_kernel(type);
+   v->fbuff = NULL;
+   v->fc = v->finc = v->fd1 = v->fd2 = v->fin = v->fout = v->fx = NULL;
+   v->fpos = FWINDOW;
+   if (type == HTS_VOCODER_FLOAT || type == HTS_VOCODER_FLOAT_C) {
+      if (v->stage == 0)        /* for MCP, the lanes are aligned for SIMD */
+         size = 8 + (FWINDOW + m + 2) * FLANES + 2 * FLANES + 3 * (PADEORDER + 1);
+      else                      /* for LSP */
+         size = v->stage * (FWINDOW + m + 1);
+      size += 2 * (m + 1) + fperiod;
+      v->fbuff = (float *) HTS_calloc(size, sizeof(float));
+      if (v->stage == 0) {
+         v->fd2 = (float *) (((size_t) v->fbuff + 31) & ~((size_t) 31));
+         v->fin = v->fd2 + (FWINDOW + m + 2) * FLANES;
+         v->fout = v->fin + FLANES;
+         v->fd1 = v->fout + FLANES;
+         v->fc = v->fd1 + 3 * (PADEORDER + 1);
+      } else {
+         v->fd1 = v->fbuff;
+         v->fc = v->fd1 + v->stage * (FWINDOW + m + 1);
+      }
+      v->finc = v->fc + m + 1;
+      v->fx = v->finc + m + 1;
+   }
+}
+
+/* HTS_Vocoder_get_kernel_name: get name of the filter kernel used by the vocoder type on this CPU */
+const char *HTS_Vocoder_get_kernel_name(const int type)
+{
+   if (type != HTS_VOCODER_FLOAT && type != HTS_VOCODER_FLOAT_C)
+      return "double";
+   switch (HTS_Vocoder_select_kernel(type)) {
+   case HTS_KERNEL_SSE:
+      return "float32 SSE";
+   case HTS_KERNEL_AVX_FMA:
+      return "float32 AVX/FMA";
+   default:
+      return "float32 C";
+   }
 }
 
 /* HTS_Vocoder_synthesize: pulse/noise excitation and MLSA/MGLSA filster based waveform synthesis */
@@ -798,6 +1129,13 @@ void HTS_Vocoder_synthesize(HTS_Vocoder * v, const int m, double lf0, double *sp
          v->cinc[i] = (v->cc[i] - v->c[i]) * v->iprd / v->fprd;
    }
 
+   if (v->type == HTS_VOCODER_FLOAT || v->type == HTS_VOCODER_FLOAT_C) {
+      HTS_Vocoder_synthesize_float(v, m, nlpf, lpf, alpha, volume, rawdata, audio);
+      HTS_Vocoder_end_excitation(v, nlpf);
+      HTS_movem(v->cc, v->c, m + 1);
+      return;
+   }
+
    for (j = 0, i = (v->iprd + 1) / 2; j < v->fprd; j++) {
       x = HTS_Vocoder_get_excitation(v, j, i, nlpf, lpf);
       if (v->stage == 0) {      /* for MCP */
@@ -896,6 +1234,10 @@ void HTS_Vocoder_clear(HTS_Vocoder * v)
       }
       if (v->pulse_list != NULL)
          HTS_free(v->pulse_list);
+      if (v->fbuff != NULL) {
+         HTS_free(v->fbuff);
+         v->fbuff = NULL;
+      }
    }
 }
 
@@ -24,14 +24,36 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2014/12/10
 ///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the trace of the latency of the synthesis phases and the counters
+/// - Version:  0.1.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Passed the HTS engine to the synthesis contexts as const instead of casting away const
+/// - Version:  0.1.3
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the builder of the context features of labels from the typed fields, and tested the unvoiced proportions by the context features
 ///
 
 
 #include "hts_synthesizer.h"
 #include <cmath>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <algorithm>
+
+#if defined(CST_DISABLE_TRACE)
+#   define HTS_TRACE_PHASE(trace, name)
+#   define HTS_TRACE_COUNT(trace, name, value)
+#else
+#   define HTS_TRACE_PHASE(trace, name)         CTracePhase tracePhase_(trace, name)
+#   define HTS_TRACE_COUNT(trace, name, value)  if ((trace) == NULL) {} else (trace)->addCount(name, value)
+#endif
 
 namespace cst
 {
@@ -39,6 +61,35 @@ namespace cst
     {
         namespace hts
         {
+            ///
+            ///	@brief  The phase of the synthesis trace which begins at construction and ends at destruction,
+            ///         the memory allocations of the current thread during the phase are added to the counter "allocations"
+            ///
+            class CTracePhase
+            {
+            public:
+                CTracePhase(CSynthTrace *trace, const char *name) : trace(trace), name(name), allocCount(0)
+                {
+                    if (trace == NULL)
+                        return;
+                    trace->beginPhase(name);
+                    allocCount = HTS_get_alloc_count();
+                }
+
+                ~CTracePhase()
+                {
+                    if (trace == NULL)
+                        return;
+                    trace->addCount("allocations", (long)(HTS_get_alloc_count() - allocCount));
+                    trace->endPhase(name);
+                }
+
+            private:
+                CSynthTrace  *trace;        ///< The trace, NULL if not traced
+                const char   *name;         ///< Name of the phase
+                unsigned long allocCount;   ///< Number of memory allocations at the beginning of the phase
+            };
+
             bool CHtsSynthesizer::loadConfig(const char *modelPath, const char *configFile, HtsCfg &htsCfg)
             {
                 std::string strPath = modelPath; strPath += "/";
@@ -181,6 +232,13 @@ namespace cst
                         htsCfg.fnGVSwitch = strPath+args[i+1];
                         ++i;
                         break;
+                    case 'v':
+                        if (*(argv+2) == 't')
+                            htsCfg.vocoderType = atoi(args[i+1].c_str());
+                        else if (*(argv+2) == 'i')
+                            htsCfg.fnVoiceImage = strPath+args[i+1];
+                        ++i;
+                        break;
                     default: // ignore this unknown option
                         ++i;
                         break;
@@ -194,6 +252,11 @@ namespace cst
                     htsCfg.rateInterp.push_back(1.0f);
                     num_interp = 1;
                 }
+                if (!htsCfg.fnVoiceImage.empty())
+                {
+                    // models of all streams are in voice image
+                    return true;
+                }
                 if (num_interp != htsCfg.fnTreeDur.size() || num_interp != htsCfg.fnTreeMgc.size() || num_interp != htsCfg.fnTreeLf0.size() ||
                     num_interp != htsCfg.fnModelDur.size()|| num_interp != htsCfg.fnModelMgc.size()|| num_interp != htsCfg.fnModelLf0.size())
                     return false;
@@ -274,67 +337,73 @@ namespace cst
 
                 // initialize HTS engine
                 //  (stream[0] = spectrum , stream[1] = lf0, stream[2] = low-pass filter)
-                if (num_ms_lpf > 0)
-                    HTS_Engine_initialize(&engine, 3);
-                else
-                    HTS_Engine_initialize(&engine, 2);
-
-                // load duration model
-                HTS_Engine_load_duration_from_fn(&engine, fn_ms_dur, fn_ts_dur, num_interp);
-                // load stream[0] (spectrum model)
-                HTS_Engine_load_parameter_from_fn(&engine, fn_ms_mgc, fn_ts_mgc, fn_ws_mgc, 0, FALSE, num_ws_mgc, num_interp);
-                // load stream[1] (lf0 model)
-                HTS_Engine_load_parameter_from_fn(&engine, fn_ms_lf0, fn_ts_lf0, fn_ws_lf0, 1, TRUE, num_ws_lf0, num_interp);
-                // load stream[2] (low-pass filter model)
-                if (num_ms_lpf > 0)
-                    HTS_Engine_load_parameter_from_fn(&engine, fn_ms_lpf, fn_ts_lpf, fn_ws_lpf, 2, FALSE, num_ws_lpf, num_interp);
-                // load gv[0] (GV for spectrum)
-                if (fn_ms_gvmgc != NULL)
-                    HTS_Engine_load_gv_from_fn(&engine, fn_ms_gvmgc, fn_ts_gvmgc, 0, num_interp);
-                // load gv[1] (GV for lf0)
-                if (fn_ms_gvlf0 != NULL)
-                    HTS_Engine_load_gv_from_fn(&engine, fn_ms_gvlf0, fn_ts_gvlf0, 1, num_interp);
-                // load gv[2] (GV for low-pass filter)
-                if (fn_ms_gvlpf != NULL)
-                    HTS_Engine_load_gv_from_fn(&engine, fn_ms_gvlpf, fn_ts_gvlpf, 2, num_interp);
-                // load GV switch
-                if (cfg.fnGVSwitch.size() > 0)
-                    HTS_Engine_load_gv_switch_from_fn(&engine, (char*)cfg.fnGVSwitch.c_str());
-
-                // set parameters
-                HTS_Engine_set_sampling_rate(&engine, sampling_rate);
-                HTS_Engine_set_fperiod(&engine, fperiod);
-                HTS_Engine_set_alpha(&engine, alpha);
-                HTS_Engine_set_gamma(&engine, (int)stage);
-                HTS_Engine_set_log_gain(&engine, use_log_gain);
-                HTS_Engine_set_beta(&engine, beta);
-                HTS_Engine_set_msd_threshold(&engine, 1, uv_threshold); // set voiced/unvoiced threshold for stream[1]
-                HTS_Engine_set_gv_weight(&engine, 0, gv_weight_mgc);
-                HTS_Engine_set_gv_weight(&engine, 1, gv_weight_lf0);
-                if (num_ms_lpf > 0)
-                    HTS_Engine_set_gv_weight(&engine, 2, gv_weight_lpf);
-                for (int i=0; i<num_interp; ++i)
-                {
-                    HTS_Engine_set_duration_interpolation_weight(&engine, i, rate_interp[i]);
-                    HTS_Engine_set_parameter_interpolation_weight(&engine, 0, i, rate_interp[i]);
-                    HTS_Engine_set_parameter_interpolation_weight(&engine, 1, i, rate_interp[i]);
-                    if (num_ms_lpf > 0)
-                        HTS_Engine_set_parameter_interpolation_weight(&engine, 2, i, rate_interp[i]);
-                }
-                if (fn_ms_gvmgc != NULL)
+                if (!cfg.fnVoiceImage.empty())
                 {
-                    for (int i=0; i<num_interp; ++i)
-                        HTS_Engine_set_gv_interpolation_weight(&engine, 0, i, rate_interp[i]);
+                    // map the models of all streams from compiled voice image
+                    HTS_Engine_initialize(&engine, 2);
+                    HTS_Engine_load_image_from_fn(&engine, (char*)cfg.fnVoiceImage.c_str());
                 }
-                if (fn_ms_gvlf0 != NULL)
+                else
                 {
-                    for (int i=0; i<num_interp; ++i)
-                        HTS_Engine_set_gv_interpolation_weight(&engine, 1, i, rate_interp[i]);
+                    if (num_ms_lpf > 0)
+                        HTS_Engine_initialize(&engine, 3);
+                    else
+                        HTS_Engine_initialize(&engine, 2);
+
+                    // load duration model
+                    HTS_Engine_load_duration_from_fn(&engine, fn_ms_dur, fn_ts_dur, num_interp);
+                    // load stream[0] (spectrum model)
+                    HTS_Engine_load_parameter_from_fn(&engine, fn_ms_mgc, fn_ts_mgc, fn_ws_mgc, 0, FALSE, num_ws_mgc, num_interp);
+                    // load stream[1] (lf0 model)
+                    HTS_Engine_load_parameter_from_fn(&engine, fn_ms_lf0, fn_ts_lf0, fn_ws_lf0, 1, TRUE, num_ws_lf0, num_interp);
+                    // load stream[2] (low-pass filter model)
+                    if (num_ms_lpf > 0)
+                        HTS_Engine_load_parameter_from_fn(&engine, fn_ms_lpf, fn_ts_lpf, fn_ws_lpf, 2, FALSE, num_ws_lpf, num_interp);
+                    // load gv[0] (GV for spectrum)
+                    if (fn_ms_gvmgc != NULL)
+                        HTS_Engine_load_gv_from_fn(&engine, fn_ms_gvmgc, fn_ts_gvmgc, 0, num_interp);
+                    // load gv[1] (GV for lf0)
+                    if (fn_ms_gvlf0 != NULL)
+                        HTS_Engine_load_gv_from_fn(&engine, fn_ms_gvlf0, fn_ts_gvlf0, 1, num_interp);
+                    // load gv[2] (GV for low-pass filter)
+                    if (fn_ms_gvlpf != NULL)
+                        HTS_Engine_load_gv_from_fn(&engine, fn_ms_gvlpf, fn_ts_gvlpf, 2, num_interp);
+                    // load GV switch
+                    if (cfg.fnGVSwitch.size() > 0)
+                        HTS_Engine_load_gv_switch_from_fn(&engine, (char*)cfg.fnGVSwitch.c_str());
                 }
-                if (fn_ms_gvlpf != NULL)
+                int  num_stream = HTS_ModelSet_get_nstream(&engine.ms);
+                bool succ = (num_stream >= 2 && HTS_ModelSet_get_duration_interpolation_size(&engine.ms) == num_interp);
+
+                // set parameters
+                if (succ)
                 {
+                    HTS_Engine_set_sampling_rate(&engine, sampling_rate);
+                    HTS_Engine_set_fperiod(&engine, fperiod);
+                    HTS_Engine_set_alpha(&engine, alpha);
+                    HTS_Engine_set_gamma(&engine, (int)stage);
+                    HTS_Engine_set_log_gain(&engine, use_log_gain);
+                    HTS_Engine_set_beta(&engine, beta);
+                    HTS_Engine_set_vocoder_type(&engine, cfg.vocoderType);
+                    HTS_Engine_set_msd_threshold(&engine, 1, uv_threshold); // set voiced/unvoiced threshold for stream[1]
+                    HTS_Engine_set_gv_weight(&engine, 0, gv_weight_mgc);
+                    HTS_Engine_set_gv_weight(&engine, 1, gv_weight_lf0);
+                    if (num_stream > 2)
+                        HTS_Engine_set_gv_weight(&engine, 2, gv_weight_lpf);
                     for (int i=0; i<num_interp; ++i)
-                        HTS_Engine_set_gv_interpolation_weight(&engine, 2, i, rate_interp[i]);
+                    {
+                        HTS_Engine_set_duration_interpolation_weight(&engine, i, rate_interp[i]);
+                        for (int s=0; s<num_stream; ++s)
+                            HTS_Engine_set_parameter_interpolation_weight(&engine, s, i, rate_interp[i]);
+                    }
+                    for (int s=0; s<num_stream; ++s)
+                    {
+                        if (HTS_ModelSet_use_gv(&engine.ms, s))
+                        {
+                            for (int i=0; i<num_interp; ++i)
+                                HTS_Engine_set_gv_interpolation_weight(&engine, s, i, rate_interp[i]);
+                        }
+                    }
                 }
 
                 // load unvoiced proportion for each phoneme
@@ -351,6 +420,27 @@ namespace cst
                         uvProps.insert(std::make_pair(phone, prop));
                     }
                     fclose(uvFp);
+
+                    // test the phonemes by the context features, with the patterns "*phoneme*" added besides the questions
+                    std::vector<std::string> uvPatterns;
+                    for (std::map<std::string, float>::const_iterator cit = uvProps.begin(); cit != uvProps.end(); ++cit)
+                    {
+                        if (cit->first.find_first_of("*?") != std::string::npos)
+                        {
+                            uvPatterns.clear();
+                            break;
+                        }
+                        uvPatterns.push_back("*" + cit->first + "*");
+                    }
+                    uvBits.clear();
+                    if (uvPatterns.size() != 0)
+                    {
+                        char **uv_patterns = newStrBuf(uvPatterns);
+                        HTS_ModelSet_add_pattern(&engine.ms, uv_patterns, (int)uvPatterns.size());
+                        delete []uv_patterns;
+                        for (size_t i = 0; i < uvPatterns.size(); i++)
+                            uvBits.push_back(HTS_ModelSet_get_pattern_bit(&engine.ms, uvPatterns[i].c_str()));
+                    }
                 }
 
                 delete []rate_interp;
@@ -372,6 +462,11 @@ namespace cst
                 delete []fn_ws_lf0;
                 delete []fn_ws_lpf;
 
+                if (!succ)
+                {
+                    HTS_Engine_clear(&engine);
+                    return false;
+                }
                 initialized = true;
                 return true;
             }
@@ -385,59 +480,174 @@ namespace cst
                 return true;
             }
 
-            bool CHtsSynthesizer::synthesize(const char *inLabel, SynthCfg &synCfg, bool isFile)
+            bool CHtsSynthesizer::saveVoiceImage(const char *fileName) const
+            {
+                if (!initialized)
+                    return false;
+                return HTS_Engine_save_image_to_fn(&engine, (char*)fileName) ? true : false;
+            }
+
+            bool CHtsSynthesizer::synthesize(const char *inLabel, SynthCfg &synCfg, bool isFile) const
+            {
+                // synthesis context of current request, sharing the models of the engine
+                HTS_Context context;
+                HTS_Context_initialize(&context, &engine);
+
+                // load label information
+                {
+                    HTS_TRACE_PHASE(synCfg.trace, "label");
+                    if (isFile)
+                        HTS_Context_load_label_from_fn(&context, (char*)inLabel);
+                    else
+                        HTS_Context_load_label_from_string(&context, (char*)inLabel);
+                }
+
+                // generate speech
+                bool succ = generate(context, synCfg);
+                HTS_Context_clear(&context);
+                return succ;
+            }
+
+            bool CHtsSynthesizer::synthesize(const std::vector<LabelInfo> &inLabel, SynthCfg &synCfg) const
+            {
+                if (inLabel.size() == 0)
+                    return false;
+
+                // load label information directly,
+                // the context features are used if they are given for all the labels, otherwise the names are parsed
+                const int size = (int)inLabel.size();
+                const int featureSize = HTS_ModelSet_get_feature_size(&engine.ms);
+                bool useFeature = featureSize > 0;
+                bool useName = true;
+                for (int i = 0; i < size; i++)
+                {
+                    if (inLabel[i].feature.size() != (size_t)featureSize)
+                        useFeature = false;
+                    if (inLabel[i].context.empty())
+                        useName = false;
+                }
+                std::vector<char*>  name(size);
+                std::vector<double> start(size);
+                std::vector<double> end(size);
+                std::vector<unsigned int> feature(useFeature ? size * featureSize : 0);
+                for (int i = 0; i < size; i++)
+                {
+                    name[i]  = (char*)inLabel[i].context.c_str();
+                    start[i] = inLabel[i].begTime;
+                    end[i]   = inLabel[i].endTime;
+                    if (useFeature)
+                        std::copy(inLabel[i].feature.begin(), inLabel[i].feature.end(), feature.begin() + i * featureSize);
+                }
+
+                // synthesis context of current request, sharing the models of the engine
+                HTS_Context context;
+                HTS_Context_initialize(&context, &engine);
+                {
+                    HTS_TRACE_PHASE(synCfg.trace, "label");
+                    if (useFeature)
+                        HTS_Context_load_label_from_feature_list(&context, &feature[0], useName ? &name[0] : NULL, &start[0], &end[0], size);
+                    else
+                        HTS_Context_load_label_from_context_list(&context, &name[0], &start[0], &end[0], size);
+                }
+
+                // generate speech
+                bool succ = generate(context, synCfg);
+                HTS_Context_clear(&context);
+                return succ;
+            }
+
+            HTS_Boolean CHtsSynthesizer::writeWaveSink(short *speech, int nsample, void *waveSink)
+            {
+                return ((CWaveSink*)waveSink)->write(speech, nsample) ? TRUE : FALSE;
+            }
+
+            bool CHtsSynthesizer::generate(HTS_Context &context, SynthCfg &synCfg) const
             {
                 HTS_Boolean phoneme_alignment = synCfg.usePhoneAlignment; // FALSE
                 double volume       = synCfg.volumeRate;// 1.0
                 double speech_speed = synCfg.speedRate; // 1.0
                 double half_tone    = synCfg.halfTone;  // 0.0
 
-                // load label information
-                if (isFile)
-                    HTS_Engine_load_label_from_fn(&engine, (char*)inLabel);
-                else
-                    HTS_Engine_load_label_from_string(&engine, (char*)inLabel);
                 // modify label
                 if (phoneme_alignment)
                 {
-                    HTS_Label_set_frame_specified_flag(&engine.label, TRUE);
+                    HTS_Label_set_frame_specified_flag(&context.label, TRUE);
                 }
                 // modify label
                 if (speech_speed != 1.0)
                 {
-                    HTS_Label_set_speech_speed(&engine.label, speech_speed);
+                    HTS_Label_set_speech_speed(&context.label, speech_speed);
                 }
 
                 // parse label and determine state duration
-                HTS_Engine_create_sstream(&engine);
+                {
+                    HTS_TRACE_PHASE(synCfg.trace, "sstream");
+                    HTS_Context_create_sstream(&context);
+                }
+                HTS_TRACE_COUNT(synCfg.trace, "labels", HTS_Label_get_size(&context.label));
 
                 // modify f0
                 if (half_tone != 0.0)
                 {
-                    for (int i=0; i<HTS_SStreamSet_get_total_state(&engine.sss); ++i)
+                    for (int i=0; i<HTS_SStreamSet_get_total_state(&context.sss); ++i)
                     {
-                        double f = HTS_SStreamSet_get_mean(&engine.sss, 1, i, 0);
+                        double f = HTS_SStreamSet_get_mean(&context.sss, 1, i, 0);
                         f += half_tone * log(2.0) / 12;
                         if (f < log(10.0))
                             f = log(10.0);
-                        HTS_SStreamSet_set_mean(&engine.sss, 1, i, 0, f);
+                        HTS_SStreamSet_set_mean(&context.sss, 1, i, 0, f);
                     }
                 }
 
                 // modify unvoiced proportion
                 if (uvProps.size() != 0)
                 {
-                    modifyUnvoicedProportion();
+                    modifyUnvoicedProportion(context);
                 }
 
-                // generate speech parameter vector sequence
-                HTS_Engine_create_pstream(&engine);
-
                 // set volume
-                HTS_Engine_set_volume(&engine, volume);
+                HTS_Context_set_volume(&context, volume);
+
+                // generate speech parameter vector sequence,
+                // or prepare generation in overlapped windows for streaming
+                {
+                    HTS_TRACE_PHASE(synCfg.trace, "pstream");
+                    if (synCfg.waveSink == NULL)
+                        HTS_Context_create_pstream(&context);
+                    else
+                        HTS_Context_create_pstream_window(&context, synCfg.overlapFrames);
+                }
+
+                // synthesize speech directly into output buffer, without copying
+                int numSamples = HTS_PStreamSet_get_total_frame(&context.pss) * engine.global.fperiod;
+                HTS_TRACE_COUNT(synCfg.trace, "frames", HTS_PStreamSet_get_total_frame(&context.pss));
+                HTS_TRACE_COUNT(synCfg.trace, "samples", numSamples);
+                short *speech  = NULL;
+                if (synCfg.waveBuffer != NULL)
+                {
+                    speech = synCfg.waveBuffer->getBuffer(numSamples);
+                    if (speech == NULL && numSamples > 0)
+                        return false;
+                }
+                else if (synCfg.outWavData)
+                {
+                    synCfg.wavData.resize(numSamples);
+                    speech = (numSamples > 0) ? &synCfg.wavData[0] : NULL;
+                }
+                HTS_Context_set_speech_buffer(&context, speech);
 
-                // synthesize speech
-                HTS_Engine_create_gstream(&engine);
+                if (synCfg.waveSink == NULL)
+                {
+                    // synthesize speech
+                    HTS_TRACE_PHASE(synCfg.trace, "gstream");
+                    HTS_Context_create_gstream(&context);
+                }
+                else
+                {
+                    // synthesize speech chunk by chunk which is passed to wave sink immediately
+                    HTS_TRACE_PHASE(synCfg.trace, "gstream");
+                    HTS_Context_create_gstream_incremental(&context, synCfg.chunkFrames, writeWaveSink, synCfg.waveSink);
+                }
 
                 // output trace information
                 if (synCfg.fnOutTrace.length() > 0)
@@ -445,7 +655,7 @@ namespace cst
                     FILE* fp = fopen(synCfg.fnOutTrace.c_str(), "wb");
                     if (fp)
                     {
-                        HTS_Engine_save_information(&engine, fp);
+                        HTS_Context_save_information(&context, fp);
                         fclose(fp);
                     }
                 }
@@ -456,7 +666,7 @@ namespace cst
                     FILE* fp = fopen(synCfg.fnOutDur.c_str(), "wb");
                     if (fp)
                     {
-                        HTS_Engine_save_label(&engine, fp);
+                        HTS_Context_save_label(&context, fp);
                         fclose(fp);
                     }
                 }
@@ -467,7 +677,7 @@ namespace cst
                     FILE* fp = fopen(synCfg.fnOutRaw.c_str(), "wb");
                     if (fp)
                     {
-                        HTS_Engine_save_generated_speech(&engine, fp);
+                        HTS_Context_save_generated_speech(&context, fp);
                         fclose(fp);
                     }
                 }
@@ -478,7 +688,7 @@ namespace cst
                     FILE* fp = fopen(synCfg.fnOutWav.c_str(), "wb");
                     if (fp)
                     {
-                        HTS_Engine_save_riff(&engine, fp);
+                        HTS_Context_save_riff(&context, fp);
                         fclose(fp);
                     }
                 }
@@ -489,7 +699,7 @@ namespace cst
                     FILE* fp = fopen(synCfg.fnOutMgc.c_str(), "wb");
                     if (fp)
                     {
-                        HTS_Engine_save_generated_parameter(&engine, fp, 0);
+                        HTS_Context_save_generated_parameter(&context, fp, 0);
                         fclose(fp);
                     }
                 }
@@ -500,7 +710,7 @@ namespace cst
                     FILE* fp = fopen(synCfg.fnOutLf0.c_str(), "wb");
                     if (fp)
                     {
-                        HTS_Engine_save_generated_parameter(&engine, fp, 1);
+                        HTS_Context_save_generated_parameter(&context, fp, 1);
                         fclose(fp);
                     }
                 }
@@ -511,7 +721,7 @@ namespace cst
                     FILE* fp = fopen(synCfg.fnOutLpf.c_str(), "wb");
                     if (fp)
                     {
-                        HTS_Engine_save_generated_parameter(&engine, fp, 2);
+                        HTS_Context_save_generated_parameter(&context, fp, 2);
                         fclose(fp);
                     }
                 }
@@ -519,30 +729,27 @@ namespace cst
                 // output wave data in buffer
                 if (synCfg.outWavData)
                 {
-                    synCfg.wavData.assign(engine.gss.gspeech, engine.gss.gspeech+engine.gss.total_nsample);
+                    // wave data is already generated into wavData (or waveBuffer)
                     // retrieve segment durations (in samples)
                     synCfg.segBeg.clear();
                     synCfg.segEnd.clear();
-                    const int nstate = HTS_ModelSet_get_nstate(&engine.ms);
+                    const int nstate = engine.ms.nstate;
                     const double rate = engine.global.fperiod * 1e+7 / engine.global.sampling_rate;
-                    for (int i = 0, state = 0, frame = 0; i < HTS_Label_get_size(&engine.label); i++)
+                    for (int i = 0, state = 0, frame = 0; i < HTS_Label_get_size(&context.label); i++)
                     {
                         int j, duration;
                         for (j = 0, duration = 0; j < nstate; j++)
-                            duration += HTS_SStreamSet_get_duration(&engine.sss, state++);
+                            duration += HTS_SStreamSet_get_duration(&context.sss, state++);
                         synCfg.segBeg.push_back(frame * rate);
                         frame += duration;
                         synCfg.segEnd.push_back(frame * rate);
                     }
                 }
 
-                // free
-                HTS_Engine_refresh(&engine);
-
                 return true;
             }
 
-            void CHtsSynthesizer::modifyUnvoicedProportion()
+            void CHtsSynthesizer::modifyUnvoicedProportion(HTS_Context &context) const
             {
                 int labFrameLength;
                 int labVoicedStartList[20][2];
@@ -552,17 +759,18 @@ namespace cst
                 int minErr;
                 int minErrId;
                 int lab,state;//,id;
+                const int nstate = engine.ms.nstate;
 
-                for (lab=0,state=0;lab<HTS_Label_get_size(&engine.label);lab++)
+                for (lab=0,state=0;lab<HTS_Label_get_size(&context.label);lab++)
                 {
                     labFrameLength=0;
                     labVoicedStartNum=0;
                     lastMsdFlag=FALSE;
 
                     // find every unvoiced to voiced change in the state sequence of the label
-                    for (int i=0; i<HTS_ModelSet_get_nstate(&engine.ms); i++, state++)
+                    for (int i=0; i<nstate; i++, state++)
                     {
-                        if (HTS_SStreamSet_get_msd(&engine.sss,1,state) > engine.global.msd_threshold[1])
+                        if (HTS_SStreamSet_get_msd(&context.sss,1,state) > engine.global.msd_threshold[1])
                         {
                             if (lastMsdFlag==FALSE)
                             {
@@ -576,29 +784,43 @@ namespace cst
                         {
                             lastMsdFlag = FALSE;
                         }
-                        labFrameLength += HTS_SStreamSet_get_duration(&engine.sss,state);
+                        labFrameLength += HTS_SStreamSet_get_duration(&context.sss,state);
                     }
 
-                    // load the best voiced start point of the label
-                    char *pLabString = HTS_Label_get_string(&engine.label,lab);
+                    // load the best voiced start point of the label,
+                    // the phonemes are tested by the context features if they are resolved into bits
                     std::map<std::string, float>::const_iterator cit = uvProps.begin();
-                    for (; cit != uvProps.end(); ++cit)
+                    if (uvBits.size() != 0)
                     {
-                        if (strstr(pLabString, cit->first.c_str()))
-                            break;
+                        for (size_t k = 0; cit != uvProps.end(); ++cit, ++k)
+                        {
+                            if (HTS_Label_test_feature(&context.label, lab, uvBits[k]))
+                                break;
+                        }
+                    }
+                    else
+                    {
+                        char *pLabString = HTS_Label_get_string(&context.label,lab);
+                        if (pLabString == NULL)
+                            continue;
+                        for (; cit != uvProps.end(); ++cit)
+                        {
+                            if (strstr(pLabString, cit->first.c_str()))
+                                break;
+                        }
                     }
                     if (cit != uvProps.end())
                     {
                         // force to be unvoiced from the 2nd state, and be voiced for the 1st state
                         if (cit->second == 1.0f)
                         {
-                            for (int i=lab*HTS_ModelSet_get_nstate(&engine.ms); i<lab*HTS_ModelSet_get_nstate(&engine.ms)+1; i++)
+                            for (int i=lab*nstate; i<lab*nstate+1; i++)
                             {
-                                engine.sss.sstream[1].msd[i] += 1;
+                                context.sss.sstream[1].msd[i] += 1;
                             }
-                            for (int i=lab*HTS_ModelSet_get_nstate(&engine.ms)+1; i<(lab+1)*HTS_ModelSet_get_nstate(&engine.ms); i++)
+                            for (int i=lab*nstate+1; i<(lab+1)*nstate; i++)
                             {
-                                engine.sss.sstream[1].msd[i] *= -1;
+                                context.sss.sstream[1].msd[i] *= -1;
                             }
                             continue;
                         }
@@ -606,9 +828,9 @@ namespace cst
                         // force to be voiced from the 1st state
                         if (cit->second == 0.0f)
                         {
-                            for (int i=lab*HTS_ModelSet_get_nstate(&engine.ms); i<(lab+1)*HTS_ModelSet_get_nstate(&engine.ms); i++)
+                            for (int i=lab*nstate; i<(lab+1)*nstate; i++)
                             {
-                                engine.sss.sstream[1].msd[i] += 1;
+                                context.sss.sstream[1].msd[i] += 1;
                             }
                             continue;
                         }
@@ -630,27 +852,121 @@ namespace cst
                         //regular the unvoiced and voiced state sequence
                         if (minErrId >= 0)
                         {
-                            for (int i=lab*HTS_ModelSet_get_nstate(&engine.ms); i<labVoicedStartList[minErrId][1]; i++)
+                            for (int i=lab*nstate; i<labVoicedStartList[minErrId][1]; i++)
                             {
-                                engine.sss.sstream[1].msd[i] *= -1;
+                                context.sss.sstream[1].msd[i] *= -1;
                             }
-                            for (int i=(lab+1)*HTS_ModelSet_get_nstate(&engine.ms)-1; i>=labVoicedStartList[minErrId][1]; i--)
+                            for (int i=(lab+1)*nstate-1; i>=labVoicedStartList[minErrId][1]; i--)
                             {
-                                engine.sss.sstream[1].msd[i] += 1.0;
+                                context.sss.sstream[1].msd[i] += 1.0;
                             }
                         }
                     }
                 }
             }
 
+            bool CHtsSynthesizer::needLabelString(const SynthCfg &synCfg) const
+            {
+                if (synCfg.fnOutDur.length() > 0 || synCfg.fnOutTrace.length() > 0 || uvProps.size() != uvBits.size())
+                    return true;
+                return !initialized || HTS_ModelSet_get_field_size(&engine.ms) < 0;
+            }
+
             int CHtsSynthesizer::getSampleRate() const
             {
                 if (initialized)
-                    return HTS_Engine_get_sampling_rate((HTS_Engine*)&engine);
+                    return HTS_Engine_get_sampling_rate(&engine);
                 else
                     return 16000;
             }
 
+            CHtsFeatureBuilder::CHtsFeatureBuilder(const CHtsSynthesizer &synthesizer) : modelSet(&synthesizer.engine.ms), feature(NULL), lastLeft(NULL), position(0), resolved(false), complete(false)
+            {
+                // the voice having patterns matched with whole label string can not be tested on the fields
+                int fieldSize = synthesizer.initialized ? HTS_ModelSet_get_field_size(modelSet) : -1;
+                if (fieldSize < 0)
+                    return;
+                fieldUsed.resize(fieldSize, false);
+                fieldOffset.push_back(0);
+                complete = true;
+            }
+
+            void CHtsFeatureBuilder::begin(std::vector<unsigned int> &feature)
+            {
+                this->feature = &feature;
+                position = 0;
+                if (!complete)
+                    return;
+                feature.resize(HTS_ModelSet_get_feature_size(modelSet));
+                if (feature.size() > 0)
+                    HTS_ModelSet_initialize_feature(modelSet, &feature[0]);
+            }
+
+            void CHtsFeatureBuilder::add(const char *left, const char *value)
+            {
+                if (!complete)
+                    return;
+                // the left delimiter of current value is the right delimiter of the last value
+                if (position > 0)
+                    setValue(left);
+                lastLeft  = left;
+                lastValue = value;
+                position++;
+            }
+
+            void CHtsFeatureBuilder::add(const char *left, int value)
+            {
+                char buf[16];
+                sprintf(buf, "%d", value);
+                add(left, buf);
+            }
+
+            bool CHtsFeatureBuilder::end()
+            {
+                if (!complete)
+                    return false;
+                if (position > 0)
+                    setValue("");
+                if (!resolved)
+                {
+                    // all the fields of the voice must be tested on the values
+                    resolved = true;
+                    if (std::find(fieldUsed.begin(), fieldUsed.end(), false) != fieldUsed.end())
+                        complete = false;
+                }
+                else if (position != fieldOffset.size() - 1)
+                {
+                    // the label has less values than the first one
+                    complete = false;
+                }
+                return complete;
+            }
+
+            void CHtsFeatureBuilder::setValue(const char *right)
+            {
+                const size_t index = position - 1;
+                if (!resolved)
+                {
+                    // resolve the fields tested on the value by its delimiters at the first label
+                    std::vector<int> fields(fieldUsed.size() + 1);
+                    int size = HTS_ModelSet_get_field_list(modelSet, lastLeft, right, &fields[0]);
+                    for (int i = 0; i < size; i++)
+                    {
+                        fieldList.push_back(fields[i]);
+                        fieldUsed[fields[i]] = true;
+                    }
+                    fieldOffset.push_back((int)fieldList.size());
+                }
+                else if (index + 1 >= fieldOffset.size())
+                {
+                    // the label has more values than the first one
+                    complete = false;
+                    return;
+                }
+                for (int i = fieldOffset[index]; i < fieldOffset[index + 1]; i++)
+                    HTS_ModelSet_set_field(modelSet, fieldList[i], lastValue.c_str(), &(*feature)[0]);
+            }
+
         }//namespace Putonghua
     }
 }
@@ -24,6 +24,18 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2014/12/10
 ///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the trace of the latency of the synthesis phases and the counters
+/// - Version:  0.1.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Passed the HTS engine to the synthesis contexts as const instead of casting away const
+/// - Version:  0.1.3
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the builder of the context features of labels from the typed fields
 ///
 
 #ifndef _CST_TTS_HTS_SYNTHESIZER_H_
@@ -45,7 +57,7 @@ namespace cst
             ///
             struct HtsCfg
             {
-                HtsCfg() : samplingRate(16000),framePeriod(80),valAlpha(0.42f),valGamma(0),valBeta(0.0f),uvThreshold(0.5f),gvWeightMgc(1.0f),gvWeightLf0(1.0f),gvWeightLpf(1.0f),useLogGain(false) {}
+                HtsCfg() : samplingRate(16000),framePeriod(80),valAlpha(0.42f),valGamma(0),valBeta(0.0f),uvThreshold(0.5f),gvWeightMgc(1.0f),gvWeightLf0(1.0f),gvWeightLpf(1.0f),useLogGain(false),vocoderType(0) {}
                 std::vector<std::string> fnTreeDur;     ///< -td tree: Decision tree files for state duration
                 std::vector<std::string> fnTreeMgc;     ///< -tm tree: Decision tree files for spectrum
                 std::vector<std::string> fnTreeLf0;     ///< -tf tree: Decision tree files for Log F0
@@ -74,13 +86,84 @@ namespace cst
                 float gvWeightLf0;                      ///< -jf f:    Weight of GV for Log F0,                                    [0.0--2.0], DEF [1.0]
                 float gvWeightLpf;                      ///< -jl f:    Weight of GV for log-pass filter,                           [0.0--2.0], DEF [1.0]
                 bool  useLogGain;                       ///< -l:       Regard input as log gain and output linear one (LSP)
+                int   vocoderType;                      ///< -vt i:    Vocoder type, 0: double, 1: float32 with SIMD, 2: float32 without SIMD,  [0--2], DEF [0]
                 std::string fnGVSwitch;                 ///< -k  tree: GV switch
                 std::string fnModelUVProp;              ///< -mu pdf:  Model file for unvoiced proportion
+                std::string fnVoiceImage;               ///< -vi img:  Compiled voice image, which replaces the tree, pdf, GV and window files of all streams
+            };
+
+            ///
+            ///	@brief  Interface for receiving the synthetic speech chunk by chunk during streaming synthesis
+            ///
+            class CWaveSink
+            {
+            public:
+                /// Destructor
+                virtual ~CWaveSink() {}
+
+                ///
+                ///	@brief  Receive the speech samples of one chunk, which is called as soon as the chunk is synthesized
+                ///
+                /// @param  [in]  wavData       The synthetic speech samples of current chunk
+                /// @param  [in]  numSamples    The number of samples in current chunk
+                ///
+                /// @return Return false to stop the synthesis
+                ///
+                virtual bool write(const short *wavData, int numSamples) = 0;
+            };
+
+            ///
+            ///	@brief  Interface for providing the buffer which the synthetic speech is generated into directly
+            ///
+            class CWaveBuffer
+            {
+            public:
+                /// Destructor
+                virtual ~CWaveBuffer() {}
+
+                ///
+                ///	@brief  Get the buffer for the synthetic speech, which is called before the speech is generated
+                ///
+                /// @param  [in]  numSamples    The number of samples of the synthetic speech
+                ///
+                /// @return The buffer holding at least numSamples samples, or NULL if it fails
+                ///
+                virtual short *getBuffer(int numSamples) = 0;
+            };
+
+            ///
+            ///	@brief  Interface for recording the latency of the synthesis phases and the counters of the synthesized items
+            ///
+            /// The phases are "label" (loading the labels), "sstream" (state durations and models), "pstream"
+            /// (parameter generation) and "gstream" (waveform generation, including the wave sink if streaming).
+            /// The counters are "labels", "frames", "samples" and "allocations" (memory allocations of the HTS engine).
+            /// The names are string literals. No phase is recorded when CST_DISABLE_TRACE is defined.
+            ///
+            class CSynthTrace
+            {
+            public:
+                /// Destructor
+                virtual ~CSynthTrace() {}
+
+                ///
+                ///	@brief  Begin the phase, which is called just before the phase
+                ///
+                virtual void beginPhase(const char *name) = 0;
+
+                ///
+                ///	@brief  End the phase, which is called just after the phase
+                ///
+                virtual void endPhase(const char *name) = 0;
+
+                ///
+                ///	@brief  Add the value to the counter
+                ///
+                virtual void addCount(const char *name, long value) = 0;
             };
 
             struct SynthCfg
             {
-                SynthCfg() : usePhoneAlignment(false),volumeRate(1),speedRate(1),halfTone(0),outWavData(false) {}
+                SynthCfg() : usePhoneAlignment(false),volumeRate(1),speedRate(1),halfTone(0),outWavData(false),waveBuffer(NULL),waveSink(NULL),chunkFrames(40),overlapFrames(30),trace(NULL) {}
                 bool  usePhoneAlignment;    ///< -vp:   Whether use phoneme alignment for duration
                 float volumeRate;           ///< -v  f: Volume rate,                                   [>=0.0], DEF [1.0]
                 float speedRate;            ///< -r  f: Speech speech rate,                        [0.0--10.0], DEF [1.0]
@@ -93,14 +176,39 @@ namespace cst
                 std::string fnOutWav;       ///< -ow s: Filename of output wav audio (generated speech)
                 std::string fnOutTrace;     ///< -ot s: Filename of output trace information
                 bool outWavData;            ///< Whether will output raw wave data in wavData
-                std::vector<short> wavData; ///< To retrieve raw wave data if needed
+                std::vector<short> wavData; ///< To retrieve raw wave data if needed (not used if waveBuffer is provided)
                 std::vector<int> segBeg;    ///< To retrieve segment begin time (in HTS format)
                 std::vector<int> segEnd;    ///< To retrieve segment end time (in HTS format)
+                CWaveBuffer *waveBuffer;    ///< To provide the buffer which speech is generated into directly, NULL to generate into wavData
+                CWaveSink *waveSink;        ///< To receive speech chunk by chunk during synthesis (streaming), NULL to generate whole utterance at once
+                int chunkFrames;            ///< Number of frames of each chunk passed to waveSink,        [1--], DEF [40]
+                int overlapFrames;          ///< Number of overlapped frames of windowed parameter generation for streaming, [1--], DEF [30]
+                CSynthTrace *trace;         ///< To record the latency of the synthesis phases, NULL if not traced
+            };
+
+            ///
+            ///	@brief  Full-context label of one segment, as structured input for the HTS engine
+            ///
+            /// The label is given either by the full-context name, or by the context feature built by
+            /// CHtsFeatureBuilder from the typed fields (the name is then optional and only used for output).
+            ///
+            struct LabelInfo
+            {
+                LabelInfo() : begTime(-1),endTime(-1) {}
+                int begTime;                ///< Begin time of segment (in HTS format), negative if not specified
+                int endTime;                ///< End time of segment (in HTS format), negative if not specified
+                std::string context;        ///< Full-context name of segment (without time information)
+                std::vector<unsigned int> feature;  ///< Context feature of segment, empty if it is parsed from the full-context name
             };
 
             ///
             ///	@brief  Class for HTS synthesizer (HMM based speech synthesis)
             ///
+            /// The models are loaded once by open() and are not modified by synthesis,
+            /// the synthesis context only holds a const pointer to the HTS engine.
+            /// Each call of synthesize() uses its own HTS synthesis context, hence
+            /// several threads can synthesize speech with the same synthesizer.
+            ///
             class CHtsSynthesizer
             {
             public:
@@ -131,6 +239,17 @@ namespace cst
                 ///
                 bool close();
 
+                ///
+                ///	@brief  Save the loaded models into the compiled voice image
+                ///
+                /// The voice image holds the trees, pdfs, GV and windows of all streams as flat little-endian arrays.
+                /// It is mapped read-only by open() when it is given by "-vi" in configuration, and is used directly
+                /// without parsing, hence the models are shared by all the processes using the same voice image.
+                ///
+                /// @param  [in] fileName   File name of the compiled voice image
+                ///
+                bool saveVoiceImage(const char *fileName) const;
+
                 ///
                 ///	@brief  Synthesize the speech from the input label file or label string
                 ///
@@ -138,19 +257,59 @@ namespace cst
                 /// @param  [in]  synCfg    Configuration for speech generation
                 /// @param  [in]  isFile    true if the input inLabel is label file, or false for label string
                 ///
-                bool synthesize(const char *inLabel, SynthCfg &synCfg, bool isFile=true);
+                bool synthesize(const char *inLabel, SynthCfg &synCfg, bool isFile=true) const;
+
+                ///
+                ///	@brief  Synthesize the speech from the structured label information
+                ///
+                /// The labels are passed to HTS engine directly. The context features are used if they are given
+                /// for all the labels, otherwise the full-context names are parsed.
+                ///
+                /// @param  [in]  inLabel   The input label information of all segments
+                /// @param  [in]  synCfg    Configuration for speech generation
+                ///
+                bool synthesize(const std::vector<LabelInfo> &inLabel, SynthCfg &synCfg) const;
 
                 ///
                 /// @brief  Return the sampling rate of the synthetic speech
                 ///
                 int getSampleRate() const;
 
+                ///
+                /// @brief  Return whether the full-context names of the labels are needed by the synthesis
+                ///
+                /// The names are needed for the output of the label and trace files, the unvoiced proportions
+                /// of phonemes not tested by questions, and the voice having questions not tested on the fields of labels.
+                ///
+                /// @param  [in]  synCfg    Configuration for speech generation
+                ///
+                bool needLabelString(const SynthCfg &synCfg) const;
+
             protected:
 
+                ///
+                ///	@brief  Generate speech from the label already loaded into the synthesis context
+                ///
+                /// @param  [in]  context   The synthesis context of current request
+                /// @param  [in]  synCfg    Configuration for speech generation
+                ///
+                bool generate(HTS_Context &context, SynthCfg &synCfg) const;
+
                 ///
                 ///	@brief  Modify the unvoiced proportion according to the input probability
                 ///
-                void modifyUnvoicedProportion();
+                /// @param  [in]  context   The synthesis context of current request
+                ///
+                void modifyUnvoicedProportion(HTS_Context &context) const;
+
+                ///
+                ///	@brief  Callback of HTS engine to pass the speech of one chunk to the wave sink
+                ///
+                /// @param  [in]  speech    The synthetic speech samples of current chunk
+                /// @param  [in]  nsample   The number of samples in current chunk
+                /// @param  [in]  waveSink  The wave sink (CWaveSink) to receive the speech
+                ///
+                static HTS_Boolean writeWaveSink(short *speech, int nsample, void *waveSink);
 
                 ///
                 ///	@brief  Load the HTS engine configurations from file
@@ -167,9 +326,73 @@ namespace cst
                 char** newStrBuf(const std::vector<std::string> &inStr);
 
             protected:
+                friend class CHtsFeatureBuilder;
                 bool initialized;                       ///< Whether HTS engine is initialized
-                HTS_Engine engine;                      ///< HTS engine
+                HTS_Engine engine;                      ///< HTS engine (models shared by all synthesis contexts)
                 std::map<std::string, float> uvProps;   ///< Unvoiced proportions for each phoneme
+                std::vector<int> uvBits;                ///< Bits of context features of the phonemes of uvProps, empty if some phoneme is not tested by questions
+            };
+
+            ///
+            ///	@brief  Builder of the context features of labels from the typed fields of the full-context names
+            ///
+            /// The values of a label are added in the order of its full-context name, each following its left
+            /// delimiter, and the bits of the questions on them are set into the context feature directly without
+            /// formatting and parsing the label string. The fields of the voice tested on each value are resolved
+            /// by the delimiters at the first label, hence all the labels must have the same layout.
+            ///
+            class CHtsFeatureBuilder
+            {
+            public:
+                /// Constructor
+                CHtsFeatureBuilder(const CHtsSynthesizer &synthesizer);
+
+            public:
+                ///
+                /// @brief  Begin the context feature of a label
+                ///
+                /// @param  [out] feature   Return the context feature of the label
+                ///
+                void begin(std::vector<unsigned int> &feature);
+
+                ///
+                /// @brief  Add the value following its left delimiter
+                ///
+                /// @param  [in]  left      The left delimiter of the value
+                /// @param  [in]  value     The value of the field
+                ///
+                void add(const char *left, const char *value);
+
+                /// Add the value following its left delimiter
+                void add(const char *left, const std::string &value) {add(left, value.c_str());}
+
+                /// Add the integer value following its left delimiter
+                void add(const char *left, int value);
+
+                ///
+                /// @brief  End the context feature of a label
+                ///
+                /// @return Whether the values cover all the fields of the voice, otherwise the full-context name must be used
+                ///
+                bool end();
+
+            protected:
+                ///
+                /// @brief  Set the last added value with its right delimiter into the context feature
+                ///
+                void setValue(const char *right);
+
+            protected:
+                const HTS_ModelSet *modelSet;   ///< Models of the HTS engine
+                std::vector<unsigned int> *feature; ///< Context feature of current label
+                std::vector<int> fieldList;     ///< Fields of the voice tested on each value of labels
+                std::vector<int> fieldOffset;   ///< Offset of the fields of each value in fieldList
+                std::vector<bool> fieldUsed;    ///< Whether each field of the voice is tested on some value
+                const char *lastLeft;           ///< Left delimiter of the last added value
+                std::string lastValue;          ///< The last added value
+                size_t position;                ///< Position of the last added value in label, 0 if no value is added
+                bool resolved;                  ///< Whether the fields of all values are resolved
+                bool complete;                  ///< Whether the values cover all the fields of the voice
             };
 
         }//namespace base
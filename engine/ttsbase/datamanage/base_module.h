@@ -24,6 +24,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/05/25
 ///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the trace of the processing stages
 ///
 
 #ifndef _CST_TTS_BASE_BASE_MODULE_H_
@@ -34,6 +38,9 @@ namespace cst
     // Forward declaration of SSML document class
     namespace xml {class CSSMLDocument;}
 
+    // Forward declaration of the trace class
+    namespace cmn {class CTrace;}
+
     namespace tts
     {
         namespace base
@@ -48,7 +55,7 @@ namespace cst
             {
             public:
                 /// Constructor
-                CModule(const CDataManager *pDataManager) : m_pDataManager(pDataManager) {}
+                CModule(const CDataManager *pDataManager) : m_pDataManager(pDataManager), m_pTrace(NULL) {}
 
                 /// Destructor
                 virtual ~CModule() {}
@@ -75,9 +82,22 @@ namespace cst
                     return cst_dynamic_cast<const _Ty*>(m_pDataManager);
                 }
 
+                ///
+                /// @brief  Set the trace recording the latency of the processing stages of the module, NULL to disable tracing
+                ///
+                void setTrace(cmn::CTrace *pTrace) {m_pTrace = pTrace;}
+
+                ///
+                /// @brief  Get the trace recording the latency of the processing stages, NULL if not traced
+                ///
+                cmn::CTrace *getTrace() const {return m_pTrace;}
+
             private:
                 /// Handle to the data manager which maintains the supporting data needed by TTS engine
                 const CDataManager *m_pDataManager;
+
+                /// The trace recording the latency of the processing stages, NULL if not traced
+                cmn::CTrace *m_pTrace;
             };
 
         }//namespace base
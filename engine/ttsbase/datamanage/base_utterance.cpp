@@ -0,0 +1,495 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Implementation file for the typed in-memory utterance passed between TTS modules
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+///
+
+#include <stack>
+#include <string.h>
+#include "base_utterance.h"
+#include "xml/ssml_traversal.h"
+#include "xml/ssml_helper.h"
+#include "cmn/cmn_error.h"
+
+namespace cst
+{
+    namespace tts
+    {
+        namespace base
+        {
+            void CUttSyllable::clear()
+            {
+                wstrText.clear();
+                wstrPhoneme.clear();
+                phones.clear();
+                unitID      = INVALID_UNITID;
+                duration    = 0;
+                amplitude   = 0;
+                pitchmean   = 0;
+                rate        = 1;
+                volume      = 1;
+                pitch       = 1;
+                memset(contour, 0, sizeof(float)*10);
+            }
+
+            void CUttWord::clear()
+            {
+                wstrText.clear();
+                wstrPOS.clear();
+                wstrPhoneme.clear();
+                wstrAlphabet.clear();
+                syllables.clear();
+                breakAfter.clear();
+                isWord          = false;
+                isPhonemeFixed  = false;
+                rate = volume = pitch = 1;
+            }
+
+            void CUtterance::clear()
+            {
+                wstrLang.clear();
+                paragraphs.clear();
+                stage = STAGE_TEXT;
+            }
+
+
+            //////////////////////////////////////////////////////////////////////////
+            //
+            //  Building the utterance from SSML document
+            //
+            //////////////////////////////////////////////////////////////////////////
+
+            ///
+            /// @brief  The SSML document traversal building the utterance
+            ///
+            class CUttBuilder : public xml::CSSMLTraversal
+            {
+            public:
+                /// Constructor
+                CUttBuilder(CUtterance &utt) : utterance(utt), inWord(false), inPhoneme(false) {}
+
+            protected:
+                ///
+                /// @brief  Relative prosody specified by SSML "prosody" and "emphasis" elements
+                ///
+                struct SSMLProsody
+                {
+                    float pitch, rate, volume;
+                    SSMLProsody() {pitch=rate=volume=1;}
+                };
+
+            protected:
+                /// Process SSML document node, for building the utterance by SSML traversing
+                virtual int processNode(xml::CXMLNode *pNode, bool &childProcessed);
+
+                /// Perform the post-processing of SSML document node, for SSML traversing
+                virtual int postProcessNode(xml::CXMLNode *pNode);
+
+                /// Append a new word (or text piece) to the last sentence
+                int appendWord(const std::wstring &wstrText, bool isWord);
+
+                /// Attach the break to the last word, or to the begin of the last sentence
+                int appendBreak(xml::CXMLElement *pBreak);
+
+                /// Get the relative prosody from "prosody" element
+                int parseProsodyInfo(xml::CXMLElement *pProsodyNode, SSMLProsody &prosInfo) const;
+
+                /// Get the relative prosody from "emphasis" element
+                int parseEmphasisInfo(xml::CXMLElement *pEmphasisNode, SSMLProsody &prosInfo) const;
+
+                /// Whether there is sentence to append word or break to
+                bool hasSentence() const {return !utterance.paragraphs.empty() && !utterance.paragraphs.back().sentences.empty();}
+
+                /// Get the last sentence of the utterance
+                CUttSentence &lastSentence() {return utterance.paragraphs.back().sentences.back();}
+
+            protected:
+                CUtterance &utterance;              ///< The utterance to be built
+                bool inWord;                        ///< Whether the text is under "w" element
+                bool inPhoneme;                     ///< Whether the text is under "phoneme" element (not under "w")
+                std::stack<SSMLProsody> stackProsody;   ///< Stacked SSML prosody, only the latest one takes effect
+            };
+
+            int CUttBuilder::processNode(xml::CXMLNode *pNode, bool &childProcessed)
+            {
+                childProcessed = false;
+                if (pNode->type() == xml::CXMLNode::XML_TEXT)
+                {
+                    // text
+                    if (!hasSentence())
+                        return ERROR_INVALID_SSML_DOCUMENT;
+                    if ((inWord || inPhoneme) && !lastSentence().words.empty())
+                        lastSentence().words.back().wstrText += pNode->value();
+                    else
+                        return appendWord(pNode->value(), false);
+                }
+                else if (pNode->type() == xml::CXMLNode::XML_ELEMENT)
+                {
+                    xml::CXMLElement *pElement = (xml::CXMLElement*)pNode;
+                    switch (pNode->nameId())
+                    {
+                    case xml::XML_NAME_SPEAK:
+                        utterance.wstrLang = pElement->getAttribute(xml::XML_NAME_XML_LANG);
+                        break;
+                    case xml::XML_NAME_P:
+                        utterance.paragraphs.resize(utterance.paragraphs.size() + 1);
+                        break;
+                    case xml::XML_NAME_S:
+                        if (utterance.paragraphs.empty())
+                            return ERROR_INVALID_SSML_DOCUMENT;
+                        utterance.paragraphs.back().sentences.resize(utterance.paragraphs.back().sentences.size() + 1);
+                        break;
+                    case xml::XML_NAME_W:
+                        {
+                            // "w" can not be under "w" or "phoneme"
+                            if (inWord || inPhoneme || !hasSentence())
+                                return ERROR_INVALID_SSML_DOCUMENT;
+                            int retVal = appendWord(L"", true);
+                            lastSentence().words.back().wstrPOS = pElement->getAttribute(xml::XML_NAME_ROLE);
+                            inWord = true;
+                            return retVal;
+                        }
+                    case xml::XML_NAME_PHONEME:
+                        {
+                            if (inPhoneme || !hasSentence())
+                                return ERROR_INVALID_SSML_DOCUMENT;
+                            if (!inWord)
+                            {
+                                // text piece with given phoneme
+                                appendWord(L"", false);
+                                inPhoneme = true;
+                            }
+                            CUttWord &word = lastSentence().words.back();
+                            word.wstrAlphabet   = pElement->getAttribute(xml::XML_NAME_ALPHABET);
+                            word.wstrPhoneme    = pElement->getAttribute(xml::XML_NAME_PH);
+                            word.isPhonemeFixed = true;
+                        }
+                        break;
+                    case xml::XML_NAME_SUB:
+                        {
+                            if (!hasSentence())
+                                return ERROR_INVALID_SSML_DOCUMENT;
+                            const std::wstring &alias = pElement->getAttribute(xml::XML_NAME_ALIAS);
+                            childProcessed = true;
+                            if ((inWord || inPhoneme) && !lastSentence().words.empty())
+                                lastSentence().words.back().wstrText += alias;
+                            else
+                                return appendWord(alias, false);
+                        }
+                        break;
+                    case xml::XML_NAME_BREAK:
+                        return appendBreak(pElement);
+                    case xml::XML_NAME_PROSODY:
+                    case xml::XML_NAME_EMPHASIS:
+                        {
+                            SSMLProsody prosInfo;
+                            int retVal = (pNode->nameId() == xml::XML_NAME_PROSODY) ?
+                                parseProsodyInfo(pElement, prosInfo) : parseEmphasisInfo(pElement, prosInfo);
+                            if (retVal != ERROR_SUCCESS)
+                                return retVal;
+                            stackProsody.push(prosInfo);
+                        }
+                        break;
+                    case xml::XML_NAME_UNIT:
+                        // units are generated from the utterance, not the other way round
+                        return ERROR_INVALID_SSML_DOCUMENT;
+                    default:
+                        // transparent
+                        break;
+                    }
+                }
+                return ERROR_SUCCESS;
+            }
+
+            int CUttBuilder::postProcessNode(xml::CXMLNode *pNode)
+            {
+                if (pNode->type() == xml::CXMLNode::XML_ELEMENT)
+                {
+                    switch (pNode->nameId())
+                    {
+                    case xml::XML_NAME_W:
+                        inWord = false;
+                        break;
+                    case xml::XML_NAME_PHONEME:
+                        inPhoneme = false;
+                        break;
+                    case xml::XML_NAME_PROSODY:
+                    case xml::XML_NAME_EMPHASIS:
+                        stackProsody.pop();
+                        break;
+                    }
+                }
+                return ERROR_SUCCESS;
+            }
+
+            int CUttBuilder::appendWord(const std::wstring &wstrText, bool isWord)
+            {
+                if (!hasSentence())
+                    return ERROR_INVALID_SSML_DOCUMENT;
+
+                std::vector<CUttWord> &words = lastSentence().words;
+                words.resize(words.size() + 1);
+                CUttWord &word = words.back();
+                word.wstrText = wstrText;
+                word.isWord   = isWord;
+                if (!stackProsody.empty())
+                {
+                    word.rate   = stackProsody.top().rate;
+                    word.volume = stackProsody.top().volume;
+                    word.pitch  = stackProsody.top().pitch;
+                }
+                return ERROR_SUCCESS;
+            }
+
+            int CUttBuilder::appendBreak(xml::CXMLElement *pBreak)
+            {
+                if (!hasSentence())
+                    return ERROR_INVALID_SSML_DOCUMENT;
+
+                // consecutive breaks are merged into one:
+                // the boundary type of the last break, and the total of the specified time
+                CUttSentence &sentence = lastSentence();
+                CUttBreak &breakInfo = sentence.words.empty() ? sentence.breakBefore : sentence.words.back().breakAfter;
+                const std::wstring &wstrTime = pBreak->getAttribute(xml::XML_NAME_TIME);
+                if (wstrTime.length() != 0)
+                {
+                    float time = xml::CSSMLHelper::parseTime(wstrTime);
+                    breakInfo.time = (breakInfo.time < 0) ? time : breakInfo.time + time;
+                }
+                breakInfo.boundaryType = xml::CSSMLHelper::getBoundaryType(pBreak);
+                breakInfo.exists = true;
+                return ERROR_SUCCESS;
+            }
+
+            int CUttBuilder::parseProsodyInfo(xml::CXMLElement *pProsodyNode, SSMLProsody &prosInfo) const
+            {
+                prosInfo.pitch  = xml::CSSMLHelper::parsePitch(pProsodyNode->getAttribute(xml::XML_NAME_PITCH));
+                prosInfo.rate   = xml::CSSMLHelper::parseRate(pProsodyNode->getAttribute(xml::XML_NAME_RATE));
+                prosInfo.volume = xml::CSSMLHelper::parseVolume(pProsodyNode->getAttribute(xml::XML_NAME_VOLUME));
+                if (prosInfo.pitch == -1 || prosInfo.rate == -1 || prosInfo.volume == -1)
+                {
+                    // invalid prosody value
+                    return ERROR_INVALID_SSML_DOCUMENT;
+                }
+                return ERROR_SUCCESS;
+            }
+
+            int CUttBuilder::parseEmphasisInfo(xml::CXMLElement *pEmphasisNode, SSMLProsody &prosInfo) const
+            {
+                // same as the emphasis levels of prosody prediction, default is "moderate"
+                const std::wstring &level = pEmphasisNode->getAttribute(xml::XML_NAME_LEVEL);
+                const wchar_t *pitch, *rate, *volume;
+                if (level.empty() || level == L"moderate")
+                {
+                    pitch = L"medium";  rate = L"slow";     volume = L"loud";
+                }
+                else if (level == L"strong")
+                {
+                    pitch = L"high";    rate = L"x-slow";   volume = L"x-loud";
+                }
+                else if (level == L"none")
+                {
+                    pitch = L"default"; rate = L"default";  volume = L"default";
+                }
+                else if (level == L"reduced")
+                {
+                    pitch = L"default"; rate = L"fast";     volume = L"soft";
+                }
+                else
+                {
+                    // invalid level value
+                    return ERROR_INVALID_SSML_DOCUMENT;
+                }
+                prosInfo.pitch  = xml::CSSMLHelper::parsePitch(pitch);
+                prosInfo.rate   = xml::CSSMLHelper::parseRate(rate);
+                prosInfo.volume = xml::CSSMLHelper::parseVolume(volume);
+                return ERROR_SUCCESS;
+            }
+
+            int CUtterance::fromSSML(xml::CSSMLDocument *pSSMLDocument)
+            {
+                clear();
+                CUttBuilder builder(*this);
+                int retVal = builder.traverse(pSSMLDocument);
+                if (retVal != ERROR_SUCCESS)
+                    clear();
+                return retVal;
+            }
+
+
+            //////////////////////////////////////////////////////////////////////////
+            //
+            //  Materializing the SSML document from the utterance
+            //
+            //////////////////////////////////////////////////////////////////////////
+
+            /// Append the text with "&, >, <" escaped
+            static void appendEscaped(std::wstring &wstrSSML, const std::wstring &wstrText)
+            {
+                std::wstring wstrTmp = wstrText;
+                xml::CXMLText::encodeEscapes(wstrTmp);
+                wstrSSML += wstrTmp;
+            }
+
+            /// Append the "break" element
+            static void appendBreak(std::wstring &wstrSSML, const CUttBreak &breakInfo)
+            {
+                if (!breakInfo.exists)
+                    return;
+                static const wchar_t *strengths[] = {L"none", L"x-weak", L"weak", L"medium", L"strong", L"x-strong"};
+                int boundaryType = breakInfo.boundaryType;
+                if (boundaryType < 0 || boundaryType >= xml::CSSMLDocument::PROSBOUND_LAST_ITEM)
+                    boundaryType = xml::CSSMLDocument::PROSBOUND_MEDIUM;
+                wstrSSML += L"<break strength=\"";
+                wstrSSML += strengths[boundaryType];
+                wstrSSML += L"\"";
+                if (breakInfo.time >= 0)
+                {
+                    std::wstring wstrTime;
+                    xml::CSSMLHelper::composeString(wstrTime, L" time=\"%dms\"", (int)breakInfo.time);
+                    wstrSSML += wstrTime;
+                }
+                wstrSSML += L"/>";
+            }
+
+            /// Append the "phoneme" element with text
+            static void appendPhoneme(std::wstring &wstrSSML, const std::wstring &wstrAlphabet, const std::wstring &wstrPhoneme, const std::wstring &wstrText)
+            {
+                wstrSSML += L"<phoneme alphabet=\"";
+                appendEscaped(wstrSSML, wstrAlphabet);
+                wstrSSML += L"\" ph=\"";
+                appendEscaped(wstrSSML, wstrPhoneme);
+                wstrSSML += L"\">";
+                appendEscaped(wstrSSML, wstrText);
+                wstrSSML += L"</phoneme>";
+            }
+
+            /// Append the "unit" element of the syllable
+            static void appendUnit(std::wstring &wstrSSML, const CUttSyllable &syllable, const std::wstring &wstrAlphabet, int stage)
+            {
+                std::wstring attVal, tmpVal;
+                wstrSSML += L"<unit";
+                if (stage >= CUtterance::STAGE_SYNTHESIS)
+                {
+                    xml::CSSMLHelper::composeString(attVal, L":%d", syllable.unitID);
+                    wstrSSML += L" uid=\"";
+                    appendEscaped(wstrSSML, syllable.wstrPhoneme + attVal);
+                    wstrSSML += L"\"";
+                }
+                wstrSSML += L">";
+                if (stage >= CUtterance::STAGE_SYNTHESIS)
+                {
+                    // only duration is kept after synthesis
+                    xml::CSSMLHelper::composeString(attVal, L"<prosody duration=\"%dms\">", (int)syllable.duration);
+                    wstrSSML += attVal;
+                }
+                else if (stage >= CUtterance::STAGE_PROSODY)
+                {
+                    xml::CSSMLHelper::composeString(attVal, L"<prosody dratio=\"%.3f\" vratio=\"%.3f\" pratio=\"%.3f\" duration=\"%dms\" volume=\"%d\" pitch=\"%dHz\" contour=\"",
+                        syllable.rate, syllable.volume, syllable.pitch, (int)syllable.duration, (int)syllable.amplitude, (int)syllable.pitchmean);
+                    wstrSSML += attVal;
+                    for (int i=0; i<10; i++)
+                    {
+                        xml::CSSMLHelper::composeString(tmpVal, L"%dHz ", (int)syllable.contour[i]);
+                        wstrSSML += tmpVal;
+                    }
+                    wstrSSML += L"\">";
+                }
+                appendPhoneme(wstrSSML, wstrAlphabet, syllable.wstrPhoneme, syllable.wstrText);
+                if (stage >= CUtterance::STAGE_PROSODY)
+                    wstrSSML += L"</prosody>";
+                wstrSSML += L"</unit>";
+            }
+
+            int CUtterance::toSSML(xml::CSSMLDocument &ssmlDocument) const
+            {
+                std::wstring wstrSSML = L"<?xml version=\"1.0\" ?><speak version=\"1.1\" xml:lang=\"";
+                appendEscaped(wstrSSML, wstrLang);
+                wstrSSML += L"\">";
+                for (std::vector<CUttParagraph>::const_iterator pit = paragraphs.begin(); pit != paragraphs.end(); ++pit)
+                {
+                    wstrSSML += L"<p>";
+                    for (std::vector<CUttSentence>::const_iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+                    {
+                        wstrSSML += L"<s>";
+                        appendBreak(wstrSSML, sit->breakBefore);
+                        for (std::vector<CUttWord>::const_iterator wit = sit->words.begin(); wit != sit->words.end(); ++wit)
+                        {
+                            const CUttWord &word = *wit;
+                            if (!word.isWord)
+                            {
+                                // text piece before word segmentation
+                                if (word.isPhonemeFixed)
+                                    appendPhoneme(wstrSSML, word.wstrAlphabet, word.wstrPhoneme, word.wstrText);
+                                else
+                                    appendEscaped(wstrSSML, word.wstrText);
+                            }
+                            else
+                            {
+                                if (stage >= STAGE_WORD || !word.wstrPOS.empty())
+                                {
+                                    wstrSSML += L"<w role=\"";
+                                    appendEscaped(wstrSSML, word.wstrPOS);
+                                    wstrSSML += L"\">";
+                                }
+                                else
+                                {
+                                    wstrSSML += L"<w>";
+                                }
+                                if (stage >= STAGE_UNIT && !word.syllables.empty())
+                                {
+                                    for (std::vector<CUttSyllable>::const_iterator it = word.syllables.begin(); it != word.syllables.end(); ++it)
+                                        appendUnit(wstrSSML, *it, word.wstrAlphabet, stage);
+                                }
+                                else if (stage >= STAGE_PHONEME || word.isPhonemeFixed)
+                                {
+                                    appendPhoneme(wstrSSML, word.wstrAlphabet, word.wstrPhoneme, word.wstrText);
+                                }
+                                else
+                                {
+                                    appendEscaped(wstrSSML, word.wstrText);
+                                }
+                                wstrSSML += L"</w>";
+                            }
+                            appendBreak(wstrSSML, word.breakAfter);
+                        }
+                        wstrSSML += L"</s>";
+                    }
+                    wstrSSML += L"</p>";
+                }
+                wstrSSML += L"</speak>";
+
+                ssmlDocument.clear();
+                if (!ssmlDocument.parse(wstrSSML.c_str()))
+                {
+                    return ERROR_INVALID_SSML_DOCUMENT;
+                }
+                return ERROR_SUCCESS;
+            }
+
+        }//namespace base
+    }
+}
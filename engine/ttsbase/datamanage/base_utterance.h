@@ -0,0 +1,209 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Head file for the typed in-memory utterance passed between TTS modules
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+///
+
+#ifndef _CST_TTS_BASE_BASE_UTTERANCE_H_
+#define _CST_TTS_BASE_BASE_UTTERANCE_H_
+
+#include <string>
+#include <vector>
+#include "xml/ssml_document.h"
+
+namespace cst
+{
+    namespace tts
+    {
+        namespace base
+        {
+            ///
+            /// @brief  The phone (segment) of a syllable, with the duration determined by the synthesizer
+            ///
+            class CUttPhone
+            {
+            public:
+                CUttPhone() : duration(0) {}    ///< Constructor
+                CUttPhone(const std::wstring &phone, float dur) : wstrPhone(phone), duration(dur) {} ///< Constructor
+                std::wstring    wstrPhone;      ///< Name of the phone
+                float           duration;       ///< Duration of the phone (Unit: ms)
+            };
+
+            ///
+            /// @brief  The syllable (basic unit of speech synthesis) of a word, corresponding to the "unit" element
+            ///
+            class CUttSyllable
+            {
+            public:
+                CUttSyllable() {clear();}       ///< Constructor
+                void clear();                   ///< Clear the content
+            public:
+                std::wstring    wstrText;       ///< Text content of the syllable
+                std::wstring    wstrPhoneme;    ///< Phoneme (pronunciation) of the syllable
+                uint32          unitID;         ///< The index of the selected unit, set by the synthesizer
+                float           duration;       ///< Target duration of the syllable (Unit: ms)
+                float           amplitude;      ///< Target amplitude of the syllable (Range: -32767, 32768)
+                float           pitchmean;      ///< Target mean (average) pitch of the syllable (Unit: Hz)
+                float           contour[10];    ///< Target pitch contour of the syllable, sampled at 10 equal distance points (Unit: Hz)
+                float           rate;           ///< Duration modification ratio
+                float           volume;         ///< Amplitude (volume) modification ratio
+                float           pitch;          ///< Mean (average) pitch modification ratio
+                std::vector<CUttPhone> phones;  ///< Phones of the syllable, set by the synthesizer if known
+            };
+
+            ///
+            /// @brief  The break between words, corresponding to the "break" element
+            ///
+            class CUttBreak
+            {
+            public:
+                CUttBreak() {clear();}          ///< Constructor
+                void clear() {exists = false; boundaryType = xml::CSSMLDocument::PROSBOUND_NONE; time = -1;}  ///< Clear the content
+            public:
+                bool            exists;         ///< Whether there is a break
+                int             boundaryType;   ///< Boundary type of the break (defined in xml::CSSMLDocument::EProsodyBoudaryType)
+                float           time;           ///< Duration of the break (Unit: ms), negative if not specified
+            };
+
+            ///
+            /// @brief  The word of a sentence, corresponding to the "w" element
+            ///
+            /// Before word segmentation, the word can also be a text piece to be segmented (isWord=false),
+            /// which is either pure text or the text under a "phoneme" element (isPhonemeFixed=true).
+            ///
+            class CUttWord
+            {
+            public:
+                CUttWord() {clear();}           ///< Constructor
+                void clear();                   ///< Clear the content
+            public:
+                std::wstring    wstrText;       ///< Text content of the word
+                std::wstring    wstrPOS;        ///< Part-of-speech (POS) of the word
+                std::wstring    wstrPhoneme;    ///< Phoneme (pronunciation) of the word
+                std::wstring    wstrAlphabet;   ///< Phoneme alphabet
+                bool            isWord;         ///< Whether it is a lexicon word, false for text piece before word segmentation
+                bool            isPhonemeFixed; ///< Whether phoneme is given in the input (should NOT be changed)
+                float           rate;           ///< Relative duration change specified by SSML "prosody" and "emphasis" elements
+                float           volume;         ///< Relative volume change specified by SSML "prosody" and "emphasis" elements
+                float           pitch;          ///< Relative pitch change specified by SSML "prosody" and "emphasis" elements
+                CUttBreak       breakAfter;     ///< The break after the word
+                std::vector<CUttSyllable> syllables;    ///< Syllables of the word after unit segmentation
+            };
+
+            ///
+            /// @brief  The sentence, corresponding to the "s" element
+            ///
+            class CUttSentence
+            {
+            public:
+                CUttBreak       breakBefore;    ///< The break before the first word (begin-of-sentence)
+                std::vector<CUttWord> words;    ///< Words of the sentence
+            };
+
+            ///
+            /// @brief  The paragraph, corresponding to the "p" element
+            ///
+            class CUttParagraph
+            {
+            public:
+                std::vector<CUttSentence> sentences;    ///< Sentences of the paragraph
+            };
+
+            ///
+            /// @brief  The typed in-memory utterance passed between the TTS modules
+            ///
+            /// The utterance is built once from the SSML document after text normalization,
+            /// and then passed from module to module (word segmentation to speech synthesis),
+            /// each of which reads and writes the typed fields directly instead of traversing
+            /// and rewriting the SSML document. The SSML document is only materialized on demand
+            /// (e.g. for display or debugging) by toSSML().
+            ///
+            /// Only the elements generated by the TTS modules are represented, i.e. "p", "s", "w",
+            /// "phoneme", "sub", "break", "unit"; the relative prosody of "prosody" and "emphasis"
+            /// elements is kept in each word. Other elements are transparent.
+            ///
+            class CUtterance
+            {
+            public:
+                ///
+                /// @brief  The processing stage the utterance has reached
+                ///
+                enum EStage
+                {
+                    STAGE_TEXT = 0,     ///< Text pieces after text normalization
+                    STAGE_WORD,         ///< After word segmentation
+                    STAGE_PROSSTRUCT,   ///< After prosodic structure generation
+                    STAGE_PHONEME,      ///< After grapheme to phoneme conversion
+                    STAGE_UNIT,         ///< After unit segmentation
+                    STAGE_PROSODY,      ///< After prosody prediction
+                    STAGE_SYNTHESIS,    ///< After speech synthesis
+                };
+
+            public:
+                /// Constructor
+                CUtterance() : stage(STAGE_TEXT) {}
+
+                ///
+                /// @brief  Clear the content
+                ///
+                void clear();
+
+                ///
+                /// @brief  Build the utterance from the SSML document after text normalization
+                ///
+                /// @param  [in]  pSSMLDocument The SSML document to be converted
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                /// @retval ERROR_INVALID_SSML_DOCUMENT The document contains structures which can not be represented,
+                ///         the SSML document should then be processed by the modules directly
+                ///
+                int fromSSML(xml::CSSMLDocument *pSSMLDocument);
+
+                ///
+                /// @brief  Materialize the SSML document of the current stage from the utterance
+                ///
+                /// The document is the same as the one generated by processing the SSML document directly,
+                /// except that the "prosody" and "emphasis" elements given in the input are not restored.
+                ///
+                /// @param  [out] ssmlDocument  Return the SSML document, all original data are CLEARed
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                ///
+                int toSSML(xml::CSSMLDocument &ssmlDocument) const;
+
+            public:
+                std::wstring    wstrLang;       ///< Language of the "speak" element
+                int             stage;          ///< The processing stage the utterance has reached, see EStage
+                std::vector<CUttParagraph> paragraphs;  ///< Paragraphs of the utterance
+            };
+
+        }//namespace base
+    }
+}
+
+#endif//_CST_TTS_BASE_BASE_UTTERANCE_H_
@@ -24,6 +24,14 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2007/06/03
 ///   Changed:  Created
+/// - Version:  0.2.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Made the settings per request, the data manager is read-only after initialization
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the search settings of unit selection
 ///
 
 #ifndef _CST_TTS_BASE_DATA_DATAMANAGER_H_
@@ -69,7 +77,10 @@ namespace cst
 
 
             ///
-            /// @brief  Global variables and settings for TTS engine
+            /// @brief  Settings of one text analysis or speech synthesis request
+            ///
+            /// The settings are passed with each processing call, so that concurrent requests
+            /// with different settings can share the same engine and data manager.
             ///
             class TTSSetting
             {
@@ -77,12 +88,16 @@ namespace cst
                 float   rate;               ///< Duration modification ratio            [0.0--10.0], DEF [1.0]
                 float   volume;             ///< Amplitude (volume) modification ratio      [>=0.0], DEF [1.0]
                 float   pitch;              ///< Mean (average) pitch modification ratio [0.5--2.0], DEF [1.0]
+                int     workers;            ///< Number of threads synthesizing sentences in parallel (0 for number of processors) [>=0], DEF [1]
+                int     chunkFrames;        ///< Number of frames of each speech chunk passed to wave sink when streaming [>=1], DEF [40]
+                int     maxCandidates;      ///< Maximum number of candidates of each unit searched by unit selection (0 for all candidates) [>=0], DEF [64]
+                int     beamWidth;          ///< Maximum number of paths kept at each unit by unit selection search (0 for full search) [>=0], DEF [16]
 
             public:
                 ///
                 /// @brief  Constructor
                 ///
-                TTSSetting() : rate(1), volume(1), pitch(1) {}
+                TTSSetting() : rate(1), volume(1), pitch(1), workers(1), chunkFrames(40), maxCandidates(64), beamWidth(16) {}
 
                 ///
                 /// @brief  Destructor
@@ -133,10 +148,12 @@ namespace cst
                 const DataConfig &getDataConfig() const {return m_config;}
 
                 ///
-                /// @brief  Get global variables and settings for TTS engine
+                /// @brief  Get default settings for the requests processed without their own settings
+                ///
+                /// The data manager is not modified after initialization, hence it can be shared
+                /// by concurrent requests without locking. Pass TTSSetting with each request instead.
                 ///
                 const TTSSetting &getGlobalSetting() const {return m_ttsSetting;}
-                TTSSetting &getGlobalSetting() {return m_ttsSetting;}
 
             protected:
                 ///
@@ -145,7 +162,7 @@ namespace cst
                 DataConfig m_config;
 
                 ///
-                /// @brief  Global variables and settings for the TTS engine
+                /// @brief  Default settings for the TTS engine
                 ///
                 TTSSetting m_ttsSetting;
 
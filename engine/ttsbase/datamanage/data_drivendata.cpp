@@ -24,6 +24,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/05/25
 ///   Changed:  Created
+/// - Version:  0.2.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Identified data managers by module name and configuration, created them by modules, and made the list thread safe
 ///
 
 
@@ -37,7 +41,76 @@ namespace cst
         namespace base
         {
             // The static vector maintaining the data mangers for all the TTS engines
-            std::vector<CDrivenData::CDataManagerRef> CDrivenData::m_vecDataManager;
+            std::vector<CDrivenData::CDataManagerRef> *CDrivenData::m_pDataManagers = new std::vector<CDrivenData::CDataManagerRef>();
+
+            // The mutex protecting the data manager list
+            cmn::CMutex *CDrivenData::m_pMutex = new cmn::CMutex();
+
+            CDataManager *CDrivenData::initDataManager(const ModuleInfo &module, const DataConfig &dataConfig)
+            {
+                if (module.createDataMan == NULL)
+                    return NULL;
+
+                // the data are initialized with the list locked, so that they are loaded only once
+                cmn::CAutoLock lock(*m_pMutex);
+
+                // search in the initialized data managers
+                std::vector<CDataManagerRef>::iterator it;
+                for (it = m_pDataManagers->begin(); it != m_pDataManagers->end(); it++)
+                {
+                    // judge whether two data manager modules are the same by module name and configuration information
+                    if (it->module.name == module.name && dataConfig == it->pDataManager->getDataConfig())
+                    {
+                        it->nReferenceCount ++;
+                        return it->pDataManager;
+                    }
+                }
+
+                // not initialized yet
+                // create new data manager by the module
+                CDataManager *pDataMan = module.createDataMan(dataConfig);
+                if (pDataMan == NULL)
+                {
+                    return NULL;
+                }
+
+                // add new data manager to the data manager list
+                m_pDataManagers->push_back(CDataManagerRef(module, pDataMan));
+                return pDataMan;
+            }
+
+            bool CDrivenData::freeDataManager(const CDataManager *pDataManager)
+            {
+                cmn::CAutoLock lock(*m_pMutex);
+                std::vector<CDataManagerRef>::iterator it;
+                for (it = m_pDataManagers->begin(); it != m_pDataManagers->end(); it++)
+                {
+                    if (it->pDataManager == pDataManager)
+                    {
+                        it->nReferenceCount --;
+                        if (it->nReferenceCount == 0)
+                        {
+                            // now the reference count is zero, the data manager could be released
+                            it->module.deleteDataMan(it->pDataManager);
+                            m_pDataManagers->erase(it);
+                        }
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            int CDrivenData::getReferenceCount(const CDataManager *pDataManager)
+            {
+                cmn::CAutoLock lock(*m_pMutex);
+                std::vector<CDataManagerRef>::iterator it;
+                for (it = m_pDataManagers->begin(); it != m_pDataManagers->end(); it++)
+                {
+                    if (it->pDataManager == pDataManager)
+                        return it->nReferenceCount;
+                }
+                return 0;
+            }
 
         }//namespace base
     }
@@ -24,6 +24,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/05/25
 ///   Changed:  Created
+/// - Version:  0.2.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Identified data managers by module name and configuration, created them by modules, and made the list thread safe
 ///
 
 #ifndef _CST_TTS_BASE_DATA_DRIVENDATA_H_
@@ -31,6 +35,8 @@
 
 #include <string>
 #include <vector>
+#include "cmn/cmn_thread.h"
+#include "base_moduleapi.h"
 #include "data_datamanager.h"
 
 namespace cst
@@ -46,77 +52,38 @@ namespace cst
             /// Once the data are initialized, they can be shared between different synthesizing threads even difference processes.
             ///
             /// A list of initialized driven data for different TTS engines are maintained in this global driven data manager, with
-            /// reference count for each initialized driven data.
+            /// reference count for each initialized driven data. The data managers are identified by the name of the data manager
+            /// module and the configuration information, e.g. the text parsers initialized with the same configuration file
+            /// share the same lexicon. The list is protected by a mutex, so engines can be initialized in different threads.
             ///
             class CDrivenData
             {
             public:
                 ///
-                /// @brief  Initialize a specific TTS engine related data manager module
-                /// @param  [in] strPath    The path where dictionary related data are stored.
+                /// @brief  Get the data manager with the configuration, initialize it if not initialized yet
                 ///
-                /// @return The code indicating whether dictionary is initialized successfully
-                /// @retval ERROR_SUCCESS   The dictionary is initialized successfully
+                /// @param  [in] module         The data manager module which creates and deletes the data manager
+                /// @param  [in] dataConfig     The configuration information
                 ///
-                template<class _Ty>
-                static const _Ty* initDataManager(const DataConfig &dataConfig)
-                {
-                    // search in the initialized data managers
-                    std::vector<CDataManagerRef>::iterator it;
-                    for (it = m_vecDataManager.begin(); it != m_vecDataManager.end(); it++)
-                    {
-                        // judge whether two data manager modules are the same by configuration information
-                        if (it->pDataManager && (dataConfig == it->pDataManager->getDataConfig()))
-                        {
-                            it->nReferenceCount ++;
-                            return cst_dynamic_cast<const _Ty*>(it->pDataManager);
-                        }
-                    }
-
-                    // not initialized yet
-                    // create new data manager
-                    CDataManager* pDataMan = new _Ty();
-                    if (pDataMan == NULL)
-                    {
-                        return NULL;
-                    }
-                    if (!pDataMan->initialize(dataConfig))
-                    {
-                        delete pDataMan;
-                        return NULL;
-                    }
-
-                    // add new data manager to the data manager list
-                    m_vecDataManager.push_back(CDataManagerRef(pDataMan));
-                    return cst_dynamic_cast<const _Ty*>(pDataMan);
-                }
+                /// @return Handle to the shared data manager, NULL if initialization failed
+                ///
+                static CDataManager *initDataManager(const ModuleInfo &module, const DataConfig &dataConfig);
 
                 ///
-                /// @brief  Free (terminate) a specific TTS engine related data manager module
+                /// @brief  Free (terminate) a data manager returned by initDataManager()
+                ///
+                /// The data manager is deleted when it is not used by any engine.
                 ///
                 /// @param  [in] pDataManager   Handle to the data manager to be freed
                 ///
                 /// @return Whether the operation is successful
                 ///
-                static bool freeDataManager(const CDataManager* pDataManager)
-                {
-                    std::vector<CDataManagerRef>::iterator it;
-                    for (it = m_vecDataManager.begin(); it != m_vecDataManager.end(); it++)
-                    {
-                        if (it->pDataManager == pDataManager)
-                        {
-                            it->nReferenceCount --;
-                            if (it->nReferenceCount == 0)
-                            {                            
-                                // now the reference count is zero, the data manager could be released
-                                delete it->pDataManager;
-                                m_vecDataManager.erase(it);
-                            }
-                            return true;
-                        }
-                    }
-                    return false;
-                }
+                static bool freeDataManager(const CDataManager *pDataManager);
+
+                ///
+                /// @brief  Get the number of engines using the data manager, 0 if not managed here
+                ///
+                static int getReferenceCount(const CDataManager *pDataManager);
 
             protected:
                 ///
@@ -125,7 +92,8 @@ namespace cst
                 class CDataManagerRef
                 {
                 public:
-                    CDataManagerRef(CDataManager *pData) : pDataManager(pData), nReferenceCount(1) {}   ///< Constructor
+                    CDataManagerRef(const ModuleInfo &mod, CDataManager *pData) : module(mod), pDataManager(pData), nReferenceCount(1) {}   ///< Constructor
+                    ModuleInfo    module;           ///< The module which created the data manager, for deleting it
                     CDataManager *pDataManager;     ///< Pointer to the TTS engine data manager
                     int           nReferenceCount;  ///< Reference count of the data manager
                 };
@@ -133,7 +101,15 @@ namespace cst
                 ///
                 /// @brief  The vector which maintains all the initialized data managers for each TTS engine
                 ///
-                static std::vector<CDataManagerRef> m_vecDataManager;
+                /// The vector and the mutex are never deleted, so the engines defined as global variables
+                /// can still free their data managers when they are destructed at exit.
+                ///
+                static std::vector<CDataManagerRef> *m_pDataManagers;
+
+                ///
+                /// @brief  The mutex protecting the data manager list
+                ///
+                static cmn::CMutex *m_pMutex;
 
             protected:
                 ///
@@ -96,6 +96,7 @@ namespace cst
                     return ERROR_OPEN_FAILED;
                 }
                 dataConfig.wstrLangTag = pModule->getAttribute(L"xml:lang");
+                std::vector<const xml::CXMLElement*> moduleAlias;
                 for (const xml::CXMLElement *pElement = (xml::CXMLElement*)pModule->firstChild(xml::CXMLNode::XML_ELEMENT); pElement != NULL; pElement=(xml::CXMLElement*)pElement->nextSibling(xml::CXMLNode::XML_ELEMENT))
                 {
                     if (pElement->value() == L"dlib")
@@ -119,6 +120,25 @@ namespace cst
                         // set voicedata info
                         dataConfig.wstrVoicePath = pElement->getAttribute(L"path");
                     }
+                    else if (pElement->value() == L"module")
+                    {
+                        // use another module instead, after all dynamic libraries are loaded
+                        moduleAlias.push_back(pElement);
+                    }
+                }
+
+                // replace modules, e.g. <module name="CWordSegment" use="CLatticeWordSegment"/>
+                for (std::vector<const xml::CXMLElement*>::iterator it = moduleAlias.begin(); it != moduleAlias.end(); ++it)
+                {
+                    std::string name = str::wcstombs((*it)->getAttribute(L"name"));
+                    std::string use  = str::wcstombs((*it)->getAttribute(L"use"));
+                    std::map<std::string, ModuleInfo>::iterator itUse = modules.find(use);
+                    if (itUse != modules.end() && modules.find(name) != modules.end())
+                    {
+                        // the configuration is shared by all module managers (e.g. text parser and synthesizer),
+                        // only the modules managed by current one are replaced
+                        modules[name] = itUse->second;
+                    }
                 }
                 return ERROR_SUCCESS;
             }
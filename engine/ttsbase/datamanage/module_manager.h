@@ -57,6 +57,9 @@ namespace cst
                 ///
                 /// @brief  Load modules from the dynamic libraries specified by the configuration file
                 ///
+                /// A module can be replaced by another loaded module with the "module" element
+                /// in the configuration file, e.g. &lt;module name="CWordSegment" use="CLatticeWordSegment"/&gt;.
+                ///
                 /// @param  [in]  configFile    Configuration file for loading modules
                 /// @param  [out] dataConfig    Return the configuration data for later module initialization
                 ///
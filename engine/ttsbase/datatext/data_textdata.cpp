@@ -24,9 +24,19 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2007/06/03
 ///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Loaded the Chinese conversion table
+/// - Version:  0.1.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Loaded the phrasing tree for prosodic structure generation
 ///
 
 
+#include <sstream>
+#include "cmn/cmn_textfile.h"
 #include "data_textdata.h"
 
 namespace cst
@@ -43,7 +53,17 @@ namespace cst
 
             bool CTextData::initialize(const DataConfig &dataConfig)
             {
-                return CDataManager::initialize(dataConfig);
+                if (!CDataManager::initialize(dataConfig))
+                    return false;
+
+                // load the conversion table (optional, the text is not converted without it)
+                if (m_config.bInitText)
+                    m_convertChinese.initialize((m_config.wstrLexiconPath + L"/sttable.dat").c_str());
+
+                // load the phrasing tree (optional, only the given boundaries are kept without it)
+                if (m_config.bInitText)
+                    m_pPhrasingTree = loadPhrasingTree(m_config.wstrLexiconPath);
+                return true;
             }
 
             bool CTextData::terminate()
@@ -54,9 +74,43 @@ namespace cst
                     delete m_pLexicon;
                     m_pLexicon = NULL;
                 }
+                if (m_pPOSBigram)
+                {
+                    delete m_pPOSBigram;
+                    m_pPOSBigram = NULL;
+                }
+                if (m_pPhrasingTree)
+                {
+                    delete m_pPhrasingTree;
+                    m_pPhrasingTree = NULL;
+                }
+                m_convertChinese.terminate();
                 return CDataManager::terminate();
             }
 
+            Wagon::CCompiledWagonTree *CTextData::loadPhrasingTree(const std::wstring &wstrPath)
+            {
+                Wagon::CCompiledWagonTree *pTree = new Wagon::CCompiledWagonTree();
+
+                // load compiled tree if available, otherwise the Wagon Tree in text format
+                if (!pTree->load((wstrPath + L"/phrase.dat").c_str()))
+                {
+                    cmn::CTextFile textFile;
+                    std::wstring wstrTree;
+                    if (textFile.open((wstrPath + L"/phrase.tree").c_str(), L"rb") && textFile.readString(wstrTree))
+                    {
+                        std::wistringstream treeStream(wstrTree);
+                        pTree->loadFromText(treeStream);
+                    }
+                }
+                if (pTree->empty())
+                {
+                    delete pTree;
+                    pTree = NULL;
+                }
+                return pTree;
+            }
+
             const CLexicon &CTextData::getLexicon() const
             {
                 // assert lexicon is not NULL
@@ -24,6 +24,14 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2007/06/03
 ///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the Chinese conversion table, shared with the lexicon by all text parsers
+/// - Version:  0.1.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Loaded the phrasing tree for prosodic structure generation
 ///
 
 #ifndef _CST_TTS_BASE_DATA_TEXTDATA_H_
@@ -31,6 +39,9 @@
 
 #include "../datamanage/data_datamanager.h"
 #include "lexicon_lexicon.h"
+#include "utils/utl_bigram.h"
+#include "utils/utl_chineseconv.h"
+#include "utils/utl_wagontree.h"
 
 namespace cst
 {
@@ -47,7 +58,7 @@ namespace cst
                 ///
                 /// @brief  Default constructor
                 ///
-                CTextData() : m_pLexicon(NULL) {}
+                CTextData() : m_pLexicon(NULL), m_pPOSBigram(NULL), m_pPhrasingTree(NULL) {}
 
                 ///
                 /// @brief  Default destructor
@@ -73,6 +84,29 @@ namespace cst
                 ///
                 virtual const CLexicon &getLexicon() const;
 
+                ///
+                /// @brief  Get the POS (part-of-speech) bigram model, NULL if the model is not available
+                ///
+                virtual const cmn::CBigram *getPOSBigram() const {return m_pPOSBigram;}
+
+                ///
+                /// @brief  Get the conversion table between Simplified and Traditional Chinese characters
+                ///
+                virtual const cmn::CChineseConvert &getChineseConvert() const {return m_convertChinese;}
+
+                ///
+                /// @brief  Get the tree predicting the prosodic boundaries, NULL if the model is not available
+                ///
+                virtual const Wagon::CCompiledWagonTree *getPhrasingTree() const {return m_pPhrasingTree;}
+
+            protected:
+                ///
+                /// @brief  Load the phrasing tree from "phrase.dat" (compiled) or "phrase.tree" (text) in the path
+                ///
+                /// @return The phrasing tree, NULL if neither file is loaded
+                ///
+                static Wagon::CCompiledWagonTree *loadPhrasingTree(const std::wstring &wstrPath);
+
             private:
                 ///
                 /// @brief  Declared to prevent calling, will not be implemented
@@ -84,7 +118,10 @@ namespace cst
                 CTextData(const CTextData &);
 
             protected:
-                CLexicon *m_pLexicon;   ///< Pronunciation lexicon
+                CLexicon *m_pLexicon;       ///< Pronunciation lexicon
+                cmn::CBigram *m_pPOSBigram; ///< POS bigram model for statistical word segmentation (optional)
+                cmn::CChineseConvert m_convertChinese;  ///< Simplified/Traditional Chinese conversion table (optional)
+                Wagon::CCompiledWagonTree *m_pPhrasingTree; ///< Tree predicting prosodic boundaries for prosodic structure generation (optional)
             };
 
         }//namespace base
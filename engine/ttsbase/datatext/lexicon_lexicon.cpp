@@ -56,6 +56,19 @@ namespace cst
                 return 0;
             }
 
+            size_t CLexicon::prefixSearch(const wchar_t *pText, size_t textLen, size_t *wordLens, size_t maxWords) const
+            {
+                size_t nCount = 0, maxWordLen = getWordMaxLen();
+                std::vector<CLexeme> vecLexeme;
+                for (size_t len = 1; len <= textLen && len <= maxWordLen && nCount < maxWords; len++)
+                {
+                    vecLexeme.clear();
+                    if (lookupWord(std::wstring(pText, len), vecLexeme) > 0)
+                        wordLens[nCount++] = len;
+                }
+                return nCount;
+            }
+
             const std::wstring &CLexicon::getPhoneme(const std::wstring &wstrWord, const std::wstring &wstrPOS, std::wstring &retPhoneme) const
             {
                 // The procedure will lookup the word in the lexicon by matching both text and POS.
@@ -148,6 +148,33 @@ namespace cst
                 ///
                 virtual size_t lookupWord(const std::wstring &wstrWord, const std::wstring &wstrPOS, CLexeme &lexeme) const;
 
+                ///
+                /// @brief  Search all the words in the lexicon which are the <b>prefixes</b> of the input text (common prefix search)
+                ///
+                /// All the words starting at the beginning of the text are found in one pass, e.g. for word segmentation.
+                /// This default implementation uses the above lookupWord() for each length up to getWordMaxLen().
+                /// Overriding class can re-implement this function to achieve better performance if possible.
+                ///
+                /// @param  [in]  pText     The input text from which the words start
+                /// @param  [in]  textLen   The length of the input text (number of characters)
+                /// @param  [out] wordLens  Return the lengths of the found words in ascending order
+                /// @param  [in]  maxWords  The maximum number of words which can be returned in wordLens
+                ///
+                /// @return The number of words found
+                ///
+                virtual size_t prefixSearch(const wchar_t *pText, size_t textLen, size_t *wordLens, size_t maxWords) const;
+
+                ///
+                /// @brief  Get appearance frequency of the given POS (part-of-speech), 0 if not found
+                ///
+                /// This default implementation returns 0, as appearance frequency is not supported.
+                ///
+                /// @param  [in] wstrPOS    POS to be queried
+                ///
+                /// @return Appearance frequency of the queried POS
+                ///
+                virtual size_t getPOSFrequency(const std::wstring &wstrPOS) const {return 0;}
+
                 ///
                 /// @brief  Get the phoneme (pronunciation) information for the word with part-of-speech
                 ///
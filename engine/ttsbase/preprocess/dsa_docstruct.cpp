@@ -236,7 +236,7 @@ namespace cst
                     if (ritParent-1 != ritCurrent)
                     {
                         // create "p"/"s" for left siblings
-                        xml::CXMLElement *pFragNode = new xml::CXMLElement(fragmentTag);
+                        xml::CXMLElement *pFragNode = pNode->ownerDocument()->createElement(fragmentTag.c_str());
                         std::vector< std::pair<xml::CXMLNode*, int> >::reverse_iterator rit = ritParent-1;
                         rit->first->insertBefore(pFragNode);
                         for (; rit != ritCurrent; rit--)
@@ -290,7 +290,7 @@ namespace cst
                     //
 
                     // create "p"/"s" for current node and left siblings
-                    xml::CXMLElement *pFragNode = new xml::CXMLElement(fragmentTag);
+                    xml::CXMLElement *pFragNode = pNode->ownerDocument()->createElement(fragmentTag.c_str());
                     std::vector< std::pair<xml::CXMLNode*, int> >::reverse_iterator rit = ritParent-1;
                     rit->first->insertBefore(pFragNode);
                     for (; rit != ritCurrent; rit --)
@@ -331,12 +331,12 @@ namespace cst
 
             bool CDocStruct::isTerminator(const xml::CXMLNode *pNode, const std::wstring &fragmentTag)
             {
-                if (pNode->type() == xml::CXMLNode::XML_ELEMENT && pNode->value() == L"say-as")
+                if (pNode->type() == xml::CXMLNode::XML_ELEMENT && pNode->nameId() == xml::XML_NAME_SAY_AS)
                 {
                     xml::CXMLElement *pSayAs = (xml::CXMLElement*)pNode;
-                    if ( pSayAs->getAttribute(L"interpret-as") == L"punctuation" )
+                    if ( pSayAs->getAttribute(xml::XML_NAME_INTERPRET_AS) == L"punctuation" )
                     {
-                        const std::wstring &format = pSayAs->getAttribute(L"format");
+                        const std::wstring &format = pSayAs->getAttribute(xml::XML_NAME_FORMAT);
                         if (format == L"p")
                         {
                             // paragraph must be sentence
@@ -221,14 +221,16 @@ namespace cst
                 // detect all punctuations
                 static const cmn::CRegexp regAllPunc((m_str_terminator_paragraph + L"|" + m_str_terminator_sentence).c_str(), false);
 
+                // matching results are kept here, as the regexps are shared by the threads
+                cmn::CRegexpMatch puncMatch, formatMatch;
                 const wchar_t *pText = wstrText.c_str();
                 while (*pText != L'\0')
                 {
                     // detect the punctuations (for paragraph and sentence)
-                    if (regAllPunc.compiled() && regAllPunc.match(pText))
+                    if (regAllPunc.compiled() && regAllPunc.match(pText, puncMatch))
                     {
-                        nSymStartPos = regAllPunc.substart(0) + pText - wstrText.c_str();
-                        nSymLength   = regAllPunc.sublength(0);
+                        nSymStartPos = puncMatch.substart(0) + pText - wstrText.c_str();
+                        nSymLength   = puncMatch.sublength(0);
                     }
                     else
                     {
@@ -241,10 +243,10 @@ namespace cst
                     const cmn::CRegexp *pRegExpFormat = &regTerminator[idxFormat];
                     while (pRegExpFormat->compiled())
                     {
-                        if (pRegExpFormat->match(pText + regAllPunc.substart(0)))
+                        if (pRegExpFormat->match(pText + puncMatch.substart(0), formatMatch))
                         {
                             // punctuation is matched in the text
-                            if (pRegExpFormat->sublength(0) == nSymLength)
+                            if (formatMatch.sublength(0) == nSymLength)
                                 break;
                         }
                         pRegExpFormat = &regTerminator[++idxFormat];
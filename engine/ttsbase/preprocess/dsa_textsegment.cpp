@@ -69,20 +69,20 @@ namespace cst
                         {
                             // it is special constructs
                             // create "say-as" node for this
-                            xml::CXMLText *pText = new xml::CXMLText(it->wstrText);
-                            xml::CXMLElement *pSayAs = new xml::CXMLElement(L"say-as");
-                            pSayAs->setAttribute(L"interpret-as", it->wstrInterpret);
+                            xml::CXMLText *pText = pSSMLDocument->createText(it->wstrText);
+                            xml::CXMLElement *pSayAs = pSSMLDocument->createElement(L"say-as");
+                            pSayAs->setAttribute(xml::XML_NAME_INTERPRET_AS, it->wstrInterpret);
                             if (it->wstrFormat != L"")
-                                pSayAs->setAttribute(L"format", it->wstrFormat);
+                                pSayAs->setAttribute(xml::XML_NAME_FORMAT, it->wstrFormat);
                             if (it->wstrDetail != L"")
-                                pSayAs->setAttribute(L"detail", it->wstrDetail);
+                                pSayAs->setAttribute(xml::XML_NAME_DETAIL, it->wstrDetail);
                             pSayAs->linkLastChild(pText);
                             pNewNode = pSayAs;
                         }
                         else
                         {
                             // it is text node
-                            xml::CXMLText *pText = new xml::CXMLText(it->wstrText);
+                            xml::CXMLText *pText = pSSMLDocument->createText(it->wstrText);
                             pNewNode = pText;
                         }
 
@@ -28,6 +28,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/05/28
 ///   Changed:  Re-implemented with new interface
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Used the conversion table of the shared text data instead of loading it for each instance
 ///
 
 
@@ -40,10 +44,8 @@ namespace cst
     {
         namespace base
         {
-            CLangConvert::CLangConvert(const wchar_t *strConvTableFile)
+            CLangConvert::CLangConvert(const cmn::CChineseConvert &convertChinese) : m_convertChinese(convertChinese)
             {
-                // initialize the Chinese converter
-                m_convertChinese.initialize(strConvTableFile);
             }
 
             int CLangConvert::process(xml::CSSMLDocument *pSSMLDocument)
@@ -67,11 +69,11 @@ namespace cst
 
                     pNode->setValue(wstrText);
                 }
-                else if (pNode->type() == xml::CXMLNode::XML_ELEMENT && pNode->value() == L"speak")
+                else if (pNode->type() == xml::CXMLNode::XML_ELEMENT && pNode->nameId() == xml::XML_NAME_SPEAK)
                 {
                     // "speak"
 
-                    const std::wstring &wstrSpeakLang = ((xml::CXMLElement*)pNode)->getAttribute(L"xml:lang");
+                    const std::wstring &wstrSpeakLang = ((xml::CXMLElement*)pNode)->getAttribute(xml::XML_NAME_XML_LANG);
 
                     // detect source written language
                     int ret = detectSourceLanguage(wstrSpeakLang, m_wstrSourceLang);
@@ -28,6 +28,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/05/28
 ///   Changed:  Re-implemented with new interface
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Used the conversion table of the shared text data instead of loading it for each instance
 ///
 
 #ifndef _CST_TTS_BASE_LANG_LANGCONVERT_H_
@@ -73,7 +77,10 @@ namespace cst
                 ///
                 /// @brief  Constructor
                 ///
-                CLangConvert(const wchar_t *strConvTableFile);
+                /// @param  [in] convertChinese The conversion table between Simplified and Traditional Chinese characters,
+                ///                             kept by the text data and shared by all instances
+                ///
+                CLangConvert(const cmn::CChineseConvert &convertChinese);
 
             public:
                 ///
@@ -127,7 +134,7 @@ namespace cst
                 virtual int doConversion(const std::wstring &srcLang, const std::wstring &tgtLang, std::wstring &textString);
 
             protected:
-                cmn::CChineseConvert m_convertChinese;  ///< Language conversion processor
+                const cmn::CChineseConvert &m_convertChinese;   ///< Language conversion processor
                 std::wstring         m_wstrSourceLang;  ///< Source written language
                 std::wstring         m_wstrTargetLang;  ///< Target written language
             };
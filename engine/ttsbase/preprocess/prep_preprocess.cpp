@@ -28,6 +28,10 @@
 ///   Author:   Jackie (jackiecao@gmail.com)
 ///   Date:     2007/06/05
 ///   Changed:  Implemented. See email for detailed change information.
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Passed the settings of each request instead of using the global settings
 ///
 
 #include "cmn/cmn_error.h"
@@ -49,16 +53,16 @@ namespace cst
             {
             }
 
-            int CPreProcess::process(xml::CSSMLDocument *pSSMLDocument, const cmn::string &strIn, str::EEncoding encodingIn, EInputTextType textTagIn)
+            int CPreProcess::process(xml::CSSMLDocument *pSSMLDocument, const cmn::string &strIn, str::EEncoding encodingIn, EInputTextType textTagIn, const TTSSetting &setting)
             {
                 // convert multi-byte string to wide-character string
                 cmn::wstring wstrIn = str::mbstowcs(strIn, encodingIn);
 
                 // process the wide-character string
-                return process(pSSMLDocument, wstrIn, textTagIn);
+                return process(pSSMLDocument, wstrIn, textTagIn, setting);
             }
 
-            int CPreProcess::process(xml::CSSMLDocument *pSSMLDocument, const cmn::wstring &wstrIn, EInputTextType textTagIn)
+            int CPreProcess::process(xml::CSSMLDocument *pSSMLDocument, const cmn::wstring &wstrIn, EInputTextType textTagIn, const TTSSetting &setting)
             {
                 /// @todo detect! for partial SSML, some node like xml declaration or "<speak>" node already exist.
                 //cmn::wstring wstrSSMLHeader = L"<?xml version=\"1.0\" encoding=\"UTF-16\" ?>\
@@ -110,7 +114,6 @@ namespace cst
                 case ITT_TEXT_SSML_NO_ROOT:
                     // adding SSML "speak" root element
                     {
-                        const TTSSetting &setting = getDataManager<CDataManager>()->getGlobalSetting();
                         std::wstring wstrProsodyHead = str::format(L"<prosody pitch=\"%.2f%%\" rate=\"%.2f%%\" volume=\"%.2f%%\">", setting.pitch*100, setting.rate*100, setting.volume*100);
                         std::wstring wstrProsodyTail = L"</prosody>";
 
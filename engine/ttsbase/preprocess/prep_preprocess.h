@@ -24,6 +24,10 @@
 ///   Author:   Jackie (jackiecao@gmail.com)
 ///   Date:     2007/05/22
 ///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Passed the settings of each request instead of using the global settings
 ///
 
 #ifndef _CST_TTS_BASE_PREP_PREPROCESS_H_
@@ -79,11 +83,12 @@ namespace cst
                 ///                             1) a well-formated SSML document with full SSML "speak" root element, or 
                 ///                             2) a text string with only partial SSML tags (without SSML "speak" root element), or 
                 ///                             3) a raw text string without any SSML tag
+                /// @param  [in]  setting       The settings (rate, volume and pitch) of current request
                 ///
                 /// @return Whether operation is successful
                 /// @retval ERROR_SUCCESS The operation is successful
                 ///
-                virtual int process(xml::CSSMLDocument *pSSMLDocument, const cmn::string &strIn, str::EEncoding encodingIn, EInputTextType textTagIn);
+                virtual int process(xml::CSSMLDocument *pSSMLDocument, const cmn::string &strIn, str::EEncoding encodingIn, EInputTextType textTagIn, const TTSSetting &setting);
 
                 ///
                 /// @brief  The main processing procedure of the preprocessing module
@@ -96,11 +101,13 @@ namespace cst
                 ///                             1) a well-formated SSML document with full SSML "speak" root element, or 
                 ///                             2) a text string with only partial SSML tags (without SSML "speak" root element), or 
                 ///                             3) a raw text string without any SSML tag
+                /// @param  [in]  setting       The settings (rate, volume and pitch) of current request,
+                ///                             which are added as the global prosody element of the document
                 ///
                 /// @return Whether operation is successful
                 /// @retval ERROR_SUCCESS The operation is successful
                 ///
-                virtual int process(xml::CSSMLDocument *pSSMLDocument, const cmn::wstring &wstrIn, EInputTextType textTagIn);
+                virtual int process(xml::CSSMLDocument *pSSMLDocument, const cmn::wstring &wstrIn, EInputTextType textTagIn, const TTSSetting &setting);
 
             protected:
                 ///
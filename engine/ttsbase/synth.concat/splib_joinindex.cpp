@@ -0,0 +1,407 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+///
+/// @file
+///
+/// @brief  Implementation file for the join index of speech library, used by the join cost of unit selection
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Limited the probes of the join cost lookup to the number of slots
+///
+
+
+#include <math.h>
+#include <string.h>
+#include "cmn/cmn_file.h"
+#include "dsp/dsp_wavedata.h"
+#include "splib_speechlib.h"
+#include "splib_joinindex.h"
+
+namespace cst
+{
+    namespace tts
+    {
+        namespace base
+        {
+            /// Magic string of the sidecar file of join index
+            static const char JOIN_INDEX_MAGIC[8] = "CSTJOIN";
+
+            /// Version of the format of the sidecar file of join index
+            static const uint32 JOIN_INDEX_VERSION = 1;
+
+            /// Length of the boundary frame (in second)
+            static const double BOUNDARY_FRAME_LENGTH = 0.02;
+
+            /// Order of the linear prediction of the boundary frame, the cepstrum has the same number of coefficients
+            static const int LPC_ORDER = CJoinIndex::FEATURE_DIMENSION - 2;
+
+            /// The quantized features are clipped at the given times of standard deviation from the mean
+            static const double QUANTIZE_DEVIATIONS = 4.0;
+
+            ///
+            /// @brief  Extract the features of one frame: log energy, zero crossing rate and LPC cepstrum
+            ///
+            static void extractFrameFeatures(const std::vector<double> &samples, size_t start, size_t length, float *feature)
+            {
+                // zero crossing rate of the original samples
+                size_t crossings = 0;
+                for (size_t i = start + 1; i < start + length; i++)
+                {
+                    if ((samples[i-1] < 0) != (samples[i] < 0))
+                        crossings++;
+                }
+
+                // autocorrelation of the frame with Hanning window
+                std::vector<double> frame(length);
+                for (size_t i = 0; i < length; i++)
+                    frame[i] = samples[start+i] * (0.5 - 0.5 * cos(2 * 3.14159265358979323846 * (i + 0.5) / length));
+                double autocorr[LPC_ORDER+1];
+                for (int k = 0; k <= LPC_ORDER; k++)
+                {
+                    autocorr[k] = 0;
+                    for (size_t i = k; i < length; i++)
+                        autocorr[k] += frame[i] * frame[i-k];
+                }
+
+                // linear prediction coefficients by Levinson-Durbin recursion, A(z) = 1 - sum(lpc[k]*z^-k)
+                double lpc[LPC_ORDER+1] = {0};
+                double error = autocorr[0];
+                for (int i = 1; i <= LPC_ORDER && error > autocorr[0] * 1e-9; i++)
+                {
+                    double reflection = autocorr[i];
+                    for (int k = 1; k < i; k++)
+                        reflection -= lpc[k] * autocorr[i-k];
+                    reflection /= error;
+
+                    double prev[LPC_ORDER+1];
+                    memcpy(prev, lpc, sizeof(lpc));
+                    lpc[i] = reflection;
+                    for (int k = 1; k < i; k++)
+                        lpc[k] = prev[k] - reflection * prev[i-k];
+                    error *= 1 - reflection * reflection;
+                }
+
+                // cepstrum of the all-pole model
+                double cepstrum[LPC_ORDER+1] = {0};
+                for (int n = 1; n <= LPC_ORDER; n++)
+                {
+                    cepstrum[n] = lpc[n];
+                    for (int k = 1; k < n; k++)
+                        cepstrum[n] += (double)k / n * cepstrum[k] * lpc[n-k];
+                }
+
+                feature[0] = (float)(0.5 * log(autocorr[0] / length + 1));
+                feature[1] = (float)((length > 1) ? (double)crossings / (length - 1) : 0);
+                for (int n = 1; n <= LPC_ORDER; n++)
+                    feature[n+1] = (float)cepstrum[n];
+            }
+
+            CJoinIndex::CJoinIndex() : m_pHeader(NULL), m_pFirstUnits(NULL), m_pFeatures(NULL), m_pPairs(NULL)
+            {
+            }
+
+            CJoinIndex::~CJoinIndex()
+            {
+                close();
+            }
+
+            bool CJoinIndex::extractFeatures(const CSpeechLib &splib, icode_t iCode, uint32 nIndex, float *headFeature, float *tailFeature)
+            {
+                if (splib.getBitsPerSample() != 8 && splib.getBitsPerSample() != 16)
+                    return false;
+                dsp::CWaveData waveData;
+                waveData.setFormat(splib.getSamplesPerSec(), splib.getBitsPerSample(), splib.getChannels());
+                uint32 waveLength = splib.getWaveLength(iCode, nIndex);
+                if (waveLength == 0 || !waveData.resize(waveLength))
+                    return false;
+                if (!splib.getWave(iCode, nIndex, waveData.getData(), waveLength))
+                    return false;
+
+                // samples of the first channel
+                size_t channels = (splib.getChannels() > 0) ? splib.getChannels() : 1;
+                size_t sampleNum = waveLength / (splib.getBitsPerSample() / 8) / channels;
+                if (sampleNum == 0)
+                    return false;
+                std::vector<double> samples(sampleNum);
+                for (size_t i = 0; i < sampleNum; i++)
+                    samples[i] = waveData.getSampleValue((unsigned long)(i * channels));
+
+                // the whole unit is one frame if it is shorter than the frame
+                size_t frameLength = (size_t)(BOUNDARY_FRAME_LENGTH * splib.getSamplesPerSec());
+                if (frameLength == 0 || frameLength > sampleNum)
+                    frameLength = sampleNum;
+                extractFrameFeatures(samples, 0, frameLength, headFeature);
+                extractFrameFeatures(samples, sampleNum - frameLength, frameLength, tailFeature);
+                return true;
+            }
+
+            double CJoinIndex::getDistance(const float *prevFeature, const float *feature)
+            {
+                double distance = 0;
+                for (int i = 0; i < FEATURE_DIMENSION; i++)
+                {
+                    double diff = prevFeature[i] - feature[i];
+                    distance += diff * diff;
+                }
+                return sqrt(distance);
+            }
+
+            uint32 CJoinIndex::hashPair(uint32 prevIndex, uint32 index)
+            {
+                return (prevIndex * 2654435761U) ^ (index * 40503U + (index >> 16));
+            }
+
+            bool CJoinIndex::save(const wchar_t *fileName, const CSpeechLib &splib, const std::vector<CUnitPair> &pairs)
+            {
+                // index of the first unit of each phoneme
+                uint32 numPhonemes = splib.getPhonemeNumber();
+                std::vector<uint32> firstUnits(numPhonemes + 1, 0);
+                for (uint32 p = 0; p < numPhonemes; p++)
+                    firstUnits[p+1] = firstUnits[p] + splib.getUnitNumber(p);
+                uint32 numUnits = firstUnits[numPhonemes];
+
+                // features of all units, the units without wave data are left at the mean
+                std::vector<float> features((size_t)numUnits * 2 * FEATURE_DIMENSION, 0);
+                std::vector<bool> extracted(numUnits, false);
+                double sum[FEATURE_DIMENSION] = {0}, sumSquare[FEATURE_DIMENSION] = {0};
+                size_t numExtracted = 0;
+                for (uint32 p = 0; p < numPhonemes; p++)
+                {
+                    for (uint32 u = firstUnits[p]; u < firstUnits[p+1]; u++)
+                    {
+                        float *head = &features[(size_t)u * 2 * FEATURE_DIMENSION];
+                        if (!extractFeatures(splib, p, u - firstUnits[p], head, head + FEATURE_DIMENSION))
+                            continue;
+                        extracted[u] = true;
+                        numExtracted++;
+                        for (int i = 0; i < 2 * FEATURE_DIMENSION; i++)
+                        {
+                            sum[i % FEATURE_DIMENSION]       += head[i];
+                            sumSquare[i % FEATURE_DIMENSION] += head[i] * head[i];
+                        }
+                    }
+                }
+
+                // header, the features are quantized to [-127, 127] within some deviations from the mean
+                IndexHeader header;
+                memset(&header, 0, sizeof(header));
+                memcpy(header.magic, JOIN_INDEX_MAGIC, sizeof(header.magic));
+                header.version     = JOIN_INDEX_VERSION;
+                header.byteOrder   = 0x01020304;
+                header.dimension   = FEATURE_DIMENSION;
+                header.numPhonemes = numPhonemes;
+                header.numUnits    = numUnits;
+                for (int i = 0; i < FEATURE_DIMENSION; i++)
+                {
+                    double count = (numExtracted > 0) ? 2.0 * numExtracted : 1.0;
+                    double mean  = sum[i] / count;
+                    double variance = sumSquare[i] / count - mean * mean;
+                    double deviation = (variance > 0) ? sqrt(variance) : 0;
+                    header.featureMean[i]  = (float)mean;
+                    header.featureScale[i] = (float)((deviation > 0) ? deviation * QUANTIZE_DEVIATIONS / 127 : 1);
+                }
+                std::vector<signed char> quantized(features.size(), 0);
+                for (size_t i = 0; i < features.size(); i++)
+                {
+                    int dim = (int)(i % FEATURE_DIMENSION);
+                    if (!extracted[i / (2 * FEATURE_DIMENSION)])
+                        continue;
+                    double value = floor((features[i] - header.featureMean[dim]) / header.featureScale[dim] + 0.5);
+                    quantized[i] = (signed char)((value > 127) ? 127 : ((value < -127) ? -127 : value));
+                }
+
+                // hash table of the pairs, the join costs are computed from the quantized features as loaded
+                std::vector<IndexPair> slots;
+                std::vector<double> costs;
+                uint32 numSlots = 0;
+                if (!pairs.empty())
+                {
+                    numSlots = 16;
+                    while (numSlots < pairs.size() * 2)
+                        numSlots *= 2;
+                    IndexPair empty = {INVALID_UNITID, INVALID_UNITID, 0, 0};
+                    slots.resize(numSlots, empty);
+                    costs.resize(numSlots, 0);
+                }
+                double maxCost = 0;
+                for (std::vector<CUnitPair>::const_iterator it = pairs.begin(); it != pairs.end(); ++it)
+                {
+                    if (it->prevPhonemeID >= numPhonemes || it->phonemeID >= numPhonemes ||
+                        it->prevUnitID >= firstUnits[it->prevPhonemeID+1] - firstUnits[it->prevPhonemeID] ||
+                        it->unitID >= firstUnits[it->phonemeID+1] - firstUnits[it->phonemeID])
+                        continue;
+                    uint32 prevIndex = firstUnits[it->prevPhonemeID] + it->prevUnitID;
+                    uint32 index     = firstUnits[it->phonemeID] + it->unitID;
+                    if (!extracted[prevIndex] || !extracted[index])
+                        continue;
+
+                    uint32 slot = hashPair(prevIndex, index) & (numSlots - 1);
+                    while (slots[slot].prevIndex != INVALID_UNITID && (slots[slot].prevIndex != prevIndex || slots[slot].index != index))
+                        slot = (slot + 1) & (numSlots - 1);
+                    if (slots[slot].prevIndex != INVALID_UNITID)
+                        continue;
+                    float prevTail[FEATURE_DIMENSION], head[FEATURE_DIMENSION];
+                    for (int i = 0; i < FEATURE_DIMENSION; i++)
+                    {
+                        prevTail[i] = header.featureMean[i] + header.featureScale[i] * quantized[((size_t)prevIndex * 2 + 1) * FEATURE_DIMENSION + i];
+                        head[i]     = header.featureMean[i] + header.featureScale[i] * quantized[(size_t)index * 2 * FEATURE_DIMENSION + i];
+                    }
+                    slots[slot].prevIndex = prevIndex;
+                    slots[slot].index     = index;
+                    costs[slot] = getDistance(prevTail, head);
+                    if (costs[slot] > maxCost)
+                        maxCost = costs[slot];
+                    header.numPairs++;
+                }
+                header.costScale = (float)((maxCost > 0) ? maxCost / 65535 : 1);
+                for (uint32 slot = 0; slot < numSlots; slot++)
+                {
+                    if (slots[slot].prevIndex != INVALID_UNITID)
+                        slots[slot].cost = (uint16)floor(costs[slot] / header.costScale + 0.5);
+                }
+
+                // sections aligned to 16 bytes
+                header.offFirstUnits = (uint32)((sizeof(IndexHeader) + 15) & ~15);
+                header.offFeatures   = (uint32)((header.offFirstUnits + firstUnits.size() * sizeof(uint32) + 15) & ~15);
+                header.numSlots      = numSlots;
+                header.offPairs      = (uint32)((header.offFeatures + quantized.size() + 15) & ~15);
+
+                cmn::CFile binFile;
+                if (!binFile.open(fileName, L"wb"))
+                    return false;
+                static const char padding[16] = {0};
+                bool succ = binFile.write(&header, sizeof(header), 1) == 1;
+                succ = succ && binFile.write(padding, 1, header.offFirstUnits - sizeof(header)) == header.offFirstUnits - sizeof(header);
+                succ = succ && binFile.write(&firstUnits[0], sizeof(uint32), firstUnits.size()) == firstUnits.size();
+                size_t written = header.offFirstUnits + firstUnits.size() * sizeof(uint32);
+                succ = succ && binFile.write(padding, 1, header.offFeatures - written) == header.offFeatures - written;
+                succ = succ && (quantized.empty() || binFile.write(&quantized[0], 1, quantized.size()) == quantized.size());
+                written = header.offFeatures + quantized.size();
+                succ = succ && binFile.write(padding, 1, header.offPairs - written) == header.offPairs - written;
+                succ = succ && (slots.empty() || binFile.write(&slots[0], sizeof(IndexPair), slots.size()) == slots.size());
+                return succ;
+            }
+
+            bool CJoinIndex::load(const wchar_t *fileName, const CSpeechLib &splib)
+            {
+                close();
+                if (!m_indexFile.open(fileName))
+                    return false;
+
+                // check the header and the sections
+                const char  *pData = (const char*)m_indexFile.getData();
+                const size_t nSize = m_indexFile.getSize();
+                const IndexHeader *pHeader = (const IndexHeader*)pData;
+                bool valid = nSize >= sizeof(IndexHeader)
+                    && memcmp(pHeader->magic, JOIN_INDEX_MAGIC, sizeof(JOIN_INDEX_MAGIC)) == 0
+                    && pHeader->version == JOIN_INDEX_VERSION
+                    && pHeader->byteOrder == 0x01020304
+                    && pHeader->dimension == FEATURE_DIMENSION
+                    && pHeader->numPhonemes < 0x40000000
+                    && pHeader->offFirstUnits <= nSize && pHeader->numPhonemes + 1 <= (nSize - pHeader->offFirstUnits) / sizeof(uint32)
+                    && pHeader->offFeatures <= nSize && pHeader->numUnits <= (nSize - pHeader->offFeatures) / (2 * FEATURE_DIMENSION)
+                    && pHeader->offPairs <= nSize && pHeader->numSlots <= (nSize - pHeader->offPairs) / sizeof(IndexPair)
+                    && (pHeader->numSlots & (pHeader->numSlots - 1)) == 0 && pHeader->numPairs <= pHeader->numSlots / 2;
+                if (!valid)
+                {
+                    m_indexFile.close();
+                    return false;
+                }
+
+                // the units must be the same as the speech library
+                const uint32 *pFirstUnits = (const uint32*)(pData + pHeader->offFirstUnits);
+                valid = pHeader->numPhonemes == splib.getPhonemeNumber() && pFirstUnits[0] == 0 && pFirstUnits[pHeader->numPhonemes] == pHeader->numUnits;
+                for (uint32 p = 0; valid && p < pHeader->numPhonemes; p++)
+                    valid = pFirstUnits[p] <= pFirstUnits[p+1] && pFirstUnits[p+1] - pFirstUnits[p] == splib.getUnitNumber(p);
+                if (!valid)
+                {
+                    m_indexFile.close();
+                    return false;
+                }
+
+                // use the data in the file directly
+                m_pHeader     = pHeader;
+                m_pFirstUnits = pFirstUnits;
+                m_pFeatures   = (const signed char*)(pData + pHeader->offFeatures);
+                m_pPairs      = (const IndexPair*)(pData + pHeader->offPairs);
+                return true;
+            }
+
+            void CJoinIndex::close()
+            {
+                m_indexFile.close();
+                m_pHeader     = NULL;
+                m_pFirstUnits = NULL;
+                m_pFeatures   = NULL;
+                m_pPairs      = NULL;
+            }
+
+            uint32 CJoinIndex::getPairNumber() const
+            {
+                return (m_pHeader != NULL) ? m_pHeader->numPairs : 0;
+            }
+
+            uint32 CJoinIndex::getIndex(icode_t iCode, uint32 nIndex) const
+            {
+                if (m_pHeader == NULL || iCode >= m_pHeader->numPhonemes || nIndex >= m_pFirstUnits[iCode+1] - m_pFirstUnits[iCode])
+                    return INVALID_UNITID;
+                return m_pFirstUnits[iCode] + nIndex;
+            }
+
+            bool CJoinIndex::getFeatures(uint32 index, float *headFeature, float *tailFeature) const
+            {
+                if (m_pHeader == NULL || index >= m_pHeader->numUnits)
+                    return false;
+                const signed char *pFeature = m_pFeatures + (size_t)index * 2 * FEATURE_DIMENSION;
+                for (int i = 0; i < FEATURE_DIMENSION; i++)
+                {
+                    headFeature[i] = m_pHeader->featureMean[i] + m_pHeader->featureScale[i] * pFeature[i];
+                    tailFeature[i] = m_pHeader->featureMean[i] + m_pHeader->featureScale[i] * pFeature[FEATURE_DIMENSION + i];
+                }
+                return true;
+            }
+
+            bool CJoinIndex::getJoinCost(uint32 prevIndex, uint32 index, double &cost) const
+            {
+                if (m_pHeader == NULL || m_pHeader->numPairs == 0)
+                    return false;
+
+                // linear probing until the empty slot, the table is at most half full,
+                // but at most all the slots are probed in case of a corrupt table without empty slot
+                uint32 mask = m_pHeader->numSlots - 1;
+                uint32 slot = hashPair(prevIndex, index) & mask;
+                for (uint32 probe = 0; probe < m_pHeader->numSlots && m_pPairs[slot].prevIndex != INVALID_UNITID; probe++, slot = (slot + 1) & mask)
+                {
+                    if (m_pPairs[slot].prevIndex == prevIndex && m_pPairs[slot].index == index)
+                    {
+                        cost = m_pPairs[slot].cost * m_pHeader->costScale;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+        }//namespace base
+    }
+}
@@ -0,0 +1,242 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+///
+/// @file
+///
+/// @brief  Head file for the join index of speech library, used by the join cost of unit selection
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+///
+
+#ifndef _CST_TTS_BASE_SPLIB_JOININDEX_H_
+#define _CST_TTS_BASE_SPLIB_JOININDEX_H_
+
+#include <vector>
+#include "cmn/cmn_type.h"
+#include "cmn/cmn_mapfile.h"
+
+namespace cst
+{
+    namespace tts
+    {
+        namespace base
+        {
+            // forward class reference
+            class CSpeechLib;
+
+            ///
+            /// @brief  A pair of adjacent speech units, whose join cost is precomputed in the join index
+            ///
+            class CUnitPair
+            {
+            public:
+                icode_t prevPhonemeID;      ///< Internal code of the phoneme of the preceding speech unit
+                uint32  prevUnitID;         ///< Index of the preceding speech unit in speech library
+                icode_t phonemeID;          ///< Internal code of the phoneme of the succeeding speech unit
+                uint32  unitID;             ///< Index of the succeeding speech unit in speech library
+
+            public:
+                CUnitPair(icode_t prevPhoneme = INVALID_ICODE, uint32 prevUnit = INVALID_UNITID, icode_t phoneme = INVALID_ICODE, uint32 unit = INVALID_UNITID)
+                    : prevPhonemeID(prevPhoneme), prevUnitID(prevUnit), phonemeID(phoneme), unitID(unit) {}
+            };
+
+            ///
+            /// @brief  The join index of speech library, which keeps the spectral features at the boundaries
+            ///         of all speech units, and the join costs of the frequent pairs of speech units
+            ///
+            /// The boundary features of a speech unit are extracted from the first and the last frames
+            /// of its wave data: the log energy, the zero crossing rate and the LPC cepstrum. The spectral
+            /// join cost of two adjacent units is the Euclidean distance between the features at the end of
+            /// the preceding unit and at the beginning of the succeeding unit.
+            ///
+            /// Extracting the features needs the wave data of every candidate in unit selection. The join
+            /// index is therefore compiled offline by save() into a sidecar file of the speech library, which
+            /// is mapped into memory read-only by load() and used directly. The features are quantized to
+            /// one byte per dimension, and the join costs of the pairs given to save() are looked up by hash.
+            ///
+            class CJoinIndex
+            {
+            public:
+                /// Number of dimensions of the boundary features
+                static const int FEATURE_DIMENSION = 12;
+
+                ///
+                /// @brief  Constructor
+                ///
+                CJoinIndex();
+
+                ///
+                /// @brief  Destructor
+                ///
+                virtual ~CJoinIndex();
+
+                ///
+                /// @brief  Extract the boundary features of the speech unit from its wave data
+                ///
+                /// @param  [in]  splib         The speech library
+                /// @param  [in]  iCode         The internal code of the phoneme
+                /// @param  [in]  nIndex        The index of the speech unit
+                /// @param  [out] headFeature   Return the features of the first frame, FEATURE_DIMENSION values
+                /// @param  [out] tailFeature   Return the features of the last frame, FEATURE_DIMENSION values
+                ///
+                /// @return Whether the wave data of the speech unit is retrieved
+                ///
+                static bool extractFeatures(const CSpeechLib &splib, icode_t iCode, uint32 nIndex, float *headFeature, float *tailFeature);
+
+                ///
+                /// @brief  Get the spectral join cost, i.e. the distance between the boundary features at the joint
+                ///
+                /// @param  [in]  prevFeature   The features at the end of the preceding unit (tail feature)
+                /// @param  [in]  feature       The features at the beginning of the succeeding unit (head feature)
+                ///
+                static double getDistance(const float *prevFeature, const float *feature);
+
+                ///
+                /// @brief  Compile the join index of the speech library into the sidecar file, which can be loaded by load()
+                ///
+                /// @param  [in]  fileName      Name of the sidecar file
+                /// @param  [in]  splib         The speech library
+                /// @param  [in]  pairs         The frequent pairs of speech units whose join costs are precomputed
+                ///
+                /// @return Whether the join index is saved successfully
+                ///
+                static bool save(const wchar_t *fileName, const CSpeechLib &splib, const std::vector<CUnitPair> &pairs);
+
+                ///
+                /// @brief  Map the sidecar file of the speech library into memory read-only
+                ///
+                /// The numbers of phonemes and speech units recorded in the file must match the speech library.
+                ///
+                /// @param  [in]  fileName      Name of the sidecar file compiled by save()
+                /// @param  [in]  splib         The speech library
+                ///
+                /// @return Whether the join index is loaded successfully
+                ///
+                bool load(const wchar_t *fileName, const CSpeechLib &splib);
+
+                ///
+                /// @brief  Unmap the sidecar file
+                ///
+                void close();
+
+                ///
+                /// @brief  Whether the join index is loaded
+                ///
+                bool opened() const {return m_pHeader != NULL;}
+
+                ///
+                /// @brief  Get the number of the pairs of speech units with precomputed join cost
+                ///
+                uint32 getPairNumber() const;
+
+                ///
+                /// @brief  Get the index of the speech unit in the join index, used for looking up the join costs
+                ///
+                /// @return The index of the speech unit, INVALID_UNITID(-1) if the join index is not loaded
+                ///
+                uint32 getIndex(icode_t iCode, uint32 nIndex) const;
+
+                ///
+                /// @brief  Get the boundary features of the speech unit stored in the join index
+                ///
+                /// @param  [in]  index         The index of the speech unit returned by getIndex()
+                /// @param  [out] headFeature   Return the features of the first frame, FEATURE_DIMENSION values
+                /// @param  [out] tailFeature   Return the features of the last frame, FEATURE_DIMENSION values
+                ///
+                /// @return Whether the features are found
+                ///
+                bool getFeatures(uint32 index, float *headFeature, float *tailFeature) const;
+
+                ///
+                /// @brief  Look up the precomputed join cost of the pair of speech units
+                ///
+                /// @param  [in]  prevIndex     The index of the preceding speech unit returned by getIndex()
+                /// @param  [in]  index         The index of the succeeding speech unit returned by getIndex()
+                /// @param  [out] cost          Return the join cost, the same as getDistance() up to quantization
+                ///
+                /// @return Whether the join cost of the pair is precomputed
+                ///
+                bool getJoinCost(uint32 prevIndex, uint32 index, double &cost) const;
+
+            protected:
+                ///
+                /// @brief  Header of the sidecar file of join index
+                ///
+                /// The header is followed by the sections of the index of the first unit of each phoneme,
+                /// the quantized features and the hash table of the join costs, each of which is aligned to 16 bytes.
+                /// The offset of each section is counted from the beginning of the file.
+                ///
+                struct IndexHeader
+                {
+                    char   magic[8];        ///< Magic string "CSTJOIN" for identifying the file
+                    uint32 version;         ///< Version of the format of the file
+                    uint32 byteOrder;       ///< 0x01020304 in the byte order of the machine where file is saved
+                    uint32 dimension;       ///< Number of dimensions of the features, FEATURE_DIMENSION
+                    uint32 numPhonemes;     ///< Number of phonemes of the speech library
+                    uint32 numUnits;        ///< Number of speech units of the speech library
+                    uint32 offFirstUnits;   ///< Offset of the section of the index of the first unit of each phoneme (numPhonemes+1 entries)
+                    uint32 offFeatures;     ///< Offset of the section of the features, head and tail features of each unit
+                    uint32 numPairs;        ///< Number of the pairs with precomputed join cost
+                    uint32 numSlots;        ///< Number of the slots of the hash table of the pairs, power of 2
+                    uint32 offPairs;        ///< Offset of the hash table of the pairs
+                    float  costScale;       ///< Scale of the quantized join cost
+                    float  featureMean[FEATURE_DIMENSION];  ///< Offset of the quantized features
+                    float  featureScale[FEATURE_DIMENSION]; ///< Scale of the quantized features
+                };
+
+                ///
+                /// @brief  Slot of the hash table of the pairs in the sidecar file, open addressing with linear probing
+                ///
+                struct IndexPair
+                {
+                    uint32 prevIndex;       ///< Index of the preceding speech unit, INVALID_UNITID for empty slot
+                    uint32 index;           ///< Index of the succeeding speech unit
+                    uint16 cost;            ///< Quantized join cost
+                    uint16 reserved;        ///< Reserved for alignment
+                };
+
+                ///
+                /// @brief  Hash value of the pair of speech units
+                ///
+                static uint32 hashPair(uint32 prevIndex, uint32 index);
+
+            private:
+                CJoinIndex(const CJoinIndex &);             ///< Forbid copy constructor
+                CJoinIndex &operator=(const CJoinIndex &);  ///< Forbid assignment operator
+
+            protected:
+                /// Mapped sidecar file
+                cmn::CMappedFile m_indexFile;
+                /// Header of the mapped file, NULL if the join index is not loaded
+                const IndexHeader *m_pHeader;
+                /// Index of the first unit of each phoneme in the mapped file
+                const uint32 *m_pFirstUnits;
+                /// Quantized features in the mapped file
+                const signed char *m_pFeatures;
+                /// Hash table of the pairs in the mapped file
+                const IndexPair *m_pPairs;
+            };
+
+        }//namespace base
+    }
+}
+
+#endif//_CST_TTS_BASE_SPLIB_JOININDEX_H_
@@ -28,6 +28,14 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/07/30
 ///   Changed:  Modified by using the new definitions
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the context and prosody used by the default unit selection
+/// - Version:  0.2.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the join index of speech library
 ///
 
 
@@ -35,6 +43,7 @@
 #define _CST_TTS_BASE_SPLIB_SPEECHLIB_H_
 
 #include "../datavoice/wav_synthesizer.h"
+#include "splib_joinindex.h"
 
 namespace cst
 {
@@ -46,9 +55,16 @@ namespace cst
             /// @brief  The base class for context label information of speech unit in speech library.
             ///         It can be inherited for different engines and modules.
             ///
+            /// The base class keeps the context used by the default unit selection.
+            ///
             class CContextLabel
             {
             public:
+                icode_t leftPhoneme;        ///< Internal code of the preceding phoneme in the recording, INVALID_ICODE for silence
+                icode_t rightPhoneme;       ///< Internal code of the succeeding phoneme in the recording, INVALID_ICODE for silence
+
+            public:
+                CContextLabel() : leftPhoneme(INVALID_ICODE), rightPhoneme(INVALID_ICODE) {}
                 virtual ~CContextLabel() {} ///< Only the object with virtual tables can use dynamic_cast
             };
 
@@ -56,9 +72,17 @@ namespace cst
             /// @brief  The base class for prosody tag information of speech unit in speech library.
             ///         It can be inherited for different engines and modules
             ///
+            /// The base class keeps the prosody used by the default unit selection, 0 for unknown value.
+            ///
             class CProsodyTag
             {
             public:
+                float   duration;           ///< Duration of the speech unit (Unit: ms)
+                float   amplitude;          ///< Amplitude of the speech unit (Range: -32767, 32768)
+                float   contour[10];        ///< Pitch contour of the speech unit, sampled at 10 equal distance points (Unit: Hz), 0 for unvoiced
+
+            public:
+                CProsodyTag() : duration(0), amplitude(0) {for (int i = 0; i < 10; i++) contour[i] = 0;}
                 virtual ~CProsodyTag() {}   ///< Only the object with virtual tables can use dynamic_cast
             };
 
@@ -186,6 +210,34 @@ namespace cst
                 ///
                 virtual uint32 getWaveLength(icode_t iCode, uint32 nIndex) const = 0;
 
+            public:
+                //////////////////////////////////////////////////////////////////////////
+                //
+                //  Join index for unit selection
+                //
+                //////////////////////////////////////////////////////////////////////////
+
+                ///
+                /// @brief  Map the join index compiled by CJoinIndex::save() for this speech library
+                ///
+                /// It is usually called in initialize() of the derived class, with the sidecar file of the library.
+                /// Without the join index, the boundary features are extracted from the wave data in unit selection.
+                ///
+                /// @param  [in] fileName   Name of the sidecar file of join index
+                ///
+                /// @return Whether the join index is loaded successfully
+                ///
+                bool loadJoinIndex(const wchar_t *fileName) {return m_joinIndex.load(fileName, *this);}
+
+                ///
+                /// @brief  Get the join index, which is not opened if it is not loaded
+                ///
+                const CJoinIndex &getJoinIndex() const {return m_joinIndex;}
+
+            protected:
+                /// Join index of the speech library
+                CJoinIndex m_joinIndex;
+
             private:
                 //////////////////////////////////////////////////////////////////////////
                 //
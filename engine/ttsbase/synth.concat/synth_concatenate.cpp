@@ -32,13 +32,32 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/07/29
 ///   Changed:  Re-implemented using the new architecture with internal representation
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Passed the settings of each request to synthesis
+/// - Version:  0.2.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Implemented unit selection by Viterbi search over target and join costs
+/// - Version:  0.2.3
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the spectral join cost using the join index of speech library
+/// - Version:  0.2.4
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Passed the trace to the synthesis of each sentence
 ///
 
 
+#include <math.h>
+#include <algorithm>
 #include "../datavoice/data_voicedata.h"
 #include "splib_speechlib.h"
 #include "synth_concatenate.h"
 #include "xml/ssml_helper.h"
+#include "utils/utl_viterbi.h"
 
 namespace cst
 {
@@ -46,13 +65,90 @@ namespace cst
     {
         namespace base
         {
+            ///
+            /// @brief  The lattice of candidate speech units searched by the Viterbi decoder
+            ///
+            /// The input items of the decoder point to the candidates of each target basic unit,
+            /// and the candidates returned to the decoder are named by the pointer to CCandidate.
+            ///
+            class CUnitLattice : public Viterbi::IVTDataSource
+            {
+            public:
+                CUnitLattice(const CSynthConcatenate &synth) : synthesizer(synth) {}
+
+                virtual Viterbi::CVTCandidate *getCandidateList(const Viterbi::CVTItem *item) const
+                {
+                    std::vector<CSynthConcatenate::CCandidate> &candidates = *(std::vector<CSynthConcatenate::CCandidate>*)item->data;
+                    Viterbi::CVTCandidate *head = NULL;
+                    for (size_t i = candidates.size(); i > 0; i--)
+                    {
+                        Viterbi::CVTCandidate *cand = new Viterbi::CVTCandidate();
+                        cand->score = candidates[i-1].targetCost;
+                        cand->name  = &candidates[i-1];
+                        cand->item  = item;
+                        cand->next  = head;
+                        head = cand;
+                    }
+                    return head;
+                }
+
+                virtual double getTransitionScore(const Viterbi::CVTCandidate *prevCand, const Viterbi::CVTCandidate *curCand) const
+                {
+                    const CSynthConcatenate::CCandidate &prev = *(const CSynthConcatenate::CCandidate*)prevCand->name;
+                    const CSynthConcatenate::CCandidate &cur  = *(const CSynthConcatenate::CCandidate*)curCand->name;
+
+                    // no joint when there is break or missing unit between them
+                    if (cur.position != prev.position + 1)
+                        return 0;
+                    return synthesizer.getJoinCost(prev, cur);
+                }
+
+                ///
+                /// @brief  Order the candidates by target cost, and then by index in speech library
+                ///
+                static bool lessTargetCost(const CSynthConcatenate::CCandidate &left, const CSynthConcatenate::CCandidate &right)
+                {
+                    if (left.targetCost != right.targetCost)
+                        return left.targetCost < right.targetCost;
+                    return left.unitID < right.unitID;
+                }
+
+            protected:
+                const CSynthConcatenate &synthesizer;
+            };
+
+            ///
+            /// @brief  The absolute difference of two positive values in logarithm, 0 if any value is unknown (not positive)
+            ///
+            static double logDistance(double left, double right)
+            {
+                if (left <= 0 || right <= 0)
+                    return 0;
+                return fabs(log(left / right));
+            }
+
+            /// Semitones in the pitch ratio of e (natural logarithm to semitone)
+            static const double SEMITONES_PER_NEPER = 12 / 0.69314718055994531;
+
+
+            CSynthConcatenate::CSynthConcatenate(const CDataManager *pDataManager) : CSynthesize(pDataManager)
+            {
+                durationWeight      = 1.0;
+                pitchWeight         = 0.5;
+                amplitudeWeight     = 0.5;
+                contextWeight       = 1.0;
+                joinPitchWeight     = 0.5;
+                joinAmplitudeWeight = 0.5;
+                joinSpectralWeight  = 1.0;
+            }
+
             //////////////////////////////////////////////////////////////////////////
             //
             //  Operations for performing the concatenation synthesis
             //
             //////////////////////////////////////////////////////////////////////////
 
-            int CSynthConcatenate::synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData)
+            int CSynthConcatenate::synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData, const TTSSetting &setting, cmn::CTrace *pTrace)
             {
                 // get phoneme internal code
                 const CSpeechLib *splib = (CSpeechLib*)&getDataManager<CVoiceData>()->getWavSynthesizer();
@@ -60,7 +156,7 @@ namespace cst
                     it->phonemeID = splib->getICodeFromPhoneme(it->wstrPhoneme);
 
                 // perform unit selection first
-                int flag = selectUnit(sentenceInfo);
+                int flag = selectUnit(sentenceInfo, setting);
                 if (flag != ERROR_SUCCESS)
                     return flag;
 
@@ -119,31 +215,162 @@ namespace cst
                 return ERROR_SUCCESS;
             }
 
-            int CSynthConcatenate::selectUnit(std::vector<CUnitItem> &sentenceInfo)
+            int CSynthConcatenate::selectUnit(std::vector<CUnitItem> &sentenceInfo, const TTSSetting &setting)
             {
-                // the default implementation of unit selection
-                // just select the first unit as result
+                // the candidates of each target basic unit, kept until the search result is retrieved
+                std::vector<std::vector<CCandidate> > lattice(sentenceInfo.size());
+                Viterbi::CVTList vitInput;
+                for (size_t i = 0; i < sentenceInfo.size(); i++)
+                {
+                    CUnitItem &unitInfo = sentenceInfo[i];
+                    unitInfo.unitID = INVALID_UNITID;
+                    if (unitInfo.isBreak || unitInfo.phonemeID == INVALID_ICODE)
+                        continue;
+
+                    // the unit without any speech unit is left INVALID_UNITID(-1)
+                    getCandidates(sentenceInfo, i, (setting.maxCandidates > 0) ? setting.maxCandidates : 0, lattice[i]);
+                    if (!lattice[i].empty())
+                        vitInput.append()->data = &lattice[i];
+                }
+                if (vitInput.head() == NULL)
+                    return ERROR_SUCCESS;
+
+                // search the path with minimum cost
+                CUnitLattice vitSource(*this);
+                Viterbi::CViterbiDecoder vitDecoder(&vitSource, false);
+                vitDecoder.setBeamWidth((setting.beamWidth > 0) ? setting.beamWidth : 0);
+                if (!vitDecoder.initialize(vitInput))
+                    return ERROR_OUTOFMEMORY;
+                vitDecoder.search();
+
+                // every unit in the input has candidates, the path is missing only when out of memory
+                Viterbi::CVTList vitOutput;
+                double score;
+                if (vitDecoder.getResult(&vitOutput, &score, 1) == 0)
+                    return ERROR_OUTOFMEMORY;
+
+                for (Viterbi::CVTItem *pItem = vitOutput.head(); pItem != NULL; pItem = pItem->next())
+                {
+                    const CCandidate &candidate = *(const CCandidate*)pItem->data;
+                    sentenceInfo[candidate.position].unitID = candidate.unitID;
+                }
+
+                return ERROR_SUCCESS;
+            }
 
+            void CSynthConcatenate::getCandidates(const std::vector<CUnitItem> &sentenceInfo, size_t position, size_t maxCandidates, std::vector<CCandidate> &candidates) const
+            {
                 const CSpeechLib *splib = (CSpeechLib*)&getDataManager<CVoiceData>()->getWavSynthesizer();
+                const CUnitItem &unitInfo = sentenceInfo[position];
 
-                for (std::vector<CUnitItem>::iterator it = sentenceInfo.begin(); it != sentenceInfo.end(); it++)
+                // the speech units with wave data
+                uint32 candNum = splib->getUnitNumber(unitInfo.phonemeID);
+                candidates.clear();
+                candidates.reserve(candNum);
+                for (uint32 idx = 0; idx < candNum; idx++)
                 {
-                    CUnitItem &unitInfo = *it;
+                    if (splib->getWaveLength(unitInfo.phonemeID, idx) == 0)
+                        continue;
 
-                    // search the speech unit with wave data
-                    uint idx, candNum = splib->getUnitNumber(unitInfo.phonemeID);
-                    for (idx = 0; idx < candNum; idx ++)
-                        if (splib->getWaveLength(unitInfo.phonemeID, idx) > 0)
-                            break;
+                    candidates.push_back(CCandidate());
+                    CCandidate &candidate = candidates.back();
+                    candidate.position  = position;
+                    candidate.phonemeID = unitInfo.phonemeID;
+                    candidate.unitID    = idx;
+                    // the unknown context and prosody are skipped in the costs
+                    splib->getContextLabel(unitInfo.phonemeID, idx, candidate.label);
+                    splib->getProsodyTag(unitInfo.phonemeID, idx, candidate.tag);
+                    candidate.targetCost = getTargetCost(sentenceInfo, candidate);
+                }
+
+                // keep the best candidates by target cost
+                if (maxCandidates > 0 && candidates.size() > maxCandidates)
+                {
+                    std::partial_sort(candidates.begin(), candidates.begin() + maxCandidates, candidates.end(), CUnitLattice::lessTargetCost);
+                    candidates.resize(maxCandidates);
+                }
+                else
+                {
+                    std::sort(candidates.begin(), candidates.end(), CUnitLattice::lessTargetCost);
+                }
 
-                    // set INVALID_UNITID(-1) if no unit with wave found
-                    if (idx == candNum)
-                        unitInfo.unitID = INVALID_UNITID;
+                // boundary features of the kept candidates for the join cost
+                if (joinSpectralWeight <= 0)
+                    return;
+                const CJoinIndex &joinIndex = splib->getJoinIndex();
+                for (std::vector<CCandidate>::iterator it = candidates.begin(); it != candidates.end(); ++it)
+                {
+                    if (joinIndex.opened())
+                    {
+                        uint32 indexID  = joinIndex.getIndex(it->phonemeID, it->unitID);
+                        it->hasFeatures = joinIndex.getFeatures(indexID, it->headFeature, it->tailFeature);
+                        // the join costs are looked up only if any pair is precomputed
+                        if (joinIndex.getPairNumber() > 0)
+                            it->indexID = indexID;
+                    }
                     else
-                        unitInfo.unitID = idx;
+                    {
+                        it->hasFeatures = CJoinIndex::extractFeatures(*splib, it->phonemeID, it->unitID, it->headFeature, it->tailFeature);
+                    }
+                }
+            }
+
+            double CSynthConcatenate::getTargetCost(const std::vector<CUnitItem> &sentenceInfo, const CCandidate &candidate) const
+            {
+                const CUnitItem &unitInfo = sentenceInfo[candidate.position];
+                const CProsodyTag &tag = candidate.tag;
+
+                // prosody
+                double pitchCost = 0;
+                int pitchPoints = 0;
+                for (int i = 0; i < 10; i++)
+                {
+                    if (unitInfo.contour[i] > 0 && tag.contour[i] > 0)
+                    {
+                        pitchCost += logDistance(unitInfo.contour[i], tag.contour[i]) * SEMITONES_PER_NEPER;
+                        pitchPoints++;
+                    }
                 }
+                double cost = 0;
+                if (pitchPoints > 0)
+                    cost += pitchWeight * pitchCost / pitchPoints;
+                cost += durationWeight  * logDistance(unitInfo.duration, tag.duration);
+                cost += amplitudeWeight * logDistance(unitInfo.amplitude, tag.amplitude);
 
-                return ERROR_SUCCESS;
+                // context, silence at the sentence boundary and the break
+                icode_t leftPhoneme  = INVALID_ICODE;
+                icode_t rightPhoneme = INVALID_ICODE;
+                if (candidate.position > 0 && !sentenceInfo[candidate.position-1].isBreak)
+                    leftPhoneme = sentenceInfo[candidate.position-1].phonemeID;
+                if (candidate.position + 1 < sentenceInfo.size() && !sentenceInfo[candidate.position+1].isBreak)
+                    rightPhoneme = sentenceInfo[candidate.position+1].phonemeID;
+                if (candidate.label.leftPhoneme != leftPhoneme)
+                    cost += contextWeight;
+                if (candidate.label.rightPhoneme != rightPhoneme)
+                    cost += contextWeight;
+
+                return cost;
+            }
+
+            double CSynthConcatenate::getJoinCost(const CCandidate &prevCandidate, const CCandidate &candidate) const
+            {
+                const CProsodyTag &prevTag = prevCandidate.tag;
+                const CProsodyTag &tag     = candidate.tag;
+
+                double cost = 0;
+                cost += joinPitchWeight     * logDistance(prevTag.contour[9], tag.contour[0]) * SEMITONES_PER_NEPER;
+                cost += joinAmplitudeWeight * logDistance(prevTag.amplitude, tag.amplitude);
+
+                // spectral distance, precomputed for the frequent pairs
+                if (joinSpectralWeight > 0 && prevCandidate.hasFeatures && candidate.hasFeatures)
+                {
+                    double spectralCost;
+                    if (prevCandidate.indexID == INVALID_UNITID || candidate.indexID == INVALID_UNITID ||
+                        !((CSpeechLib&)getDataManager<CVoiceData>()->getWavSynthesizer()).getJoinIndex().getJoinCost(prevCandidate.indexID, candidate.indexID, spectralCost))
+                        spectralCost = CJoinIndex::getDistance(prevCandidate.tailFeature, candidate.headFeature);
+                    cost += joinSpectralWeight * spectralCost;
+                }
+                return cost;
             }
 
         }//namespace base
@@ -32,12 +32,29 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/07/29
 ///   Changed:  Re-implemented using the new architecture with internal representation
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Passed the settings of each request to synthesis
+/// - Version:  0.2.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Implemented unit selection by Viterbi search over target and join costs
+/// - Version:  0.2.3
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the spectral join cost using the join index of speech library
+/// - Version:  0.2.4
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Passed the trace to the synthesis of each sentence
 ///
 
 #ifndef _CST_TTS_BASE_SYNTH_CONCATENATE_H_
 #define _CST_TTS_BASE_SYNTH_CONCATENATE_H_
 
 #include "ttsbase/synthesize/synth_synthesize.h"
+#include "splib_speechlib.h"
 
 namespace cst
 {
@@ -60,7 +77,31 @@ namespace cst
                 ///
                 /// @brief  Constructor
                 ///
-                CSynthConcatenate(const CDataManager *pDataManager) : CSynthesize(pDataManager) {}
+                CSynthConcatenate(const CDataManager *pDataManager);
+
+            protected:
+                friend class CUnitLattice;
+
+                ///
+                /// @brief  A candidate speech unit of a target basic unit in unit selection
+                ///
+                class CCandidate
+                {
+                public:
+                    size_t          position;       ///< Position of the target basic unit in the sentence
+                    icode_t         phonemeID;      ///< Internal code of the phoneme
+                    uint32          unitID;         ///< Index of the speech unit in speech library
+                    CContextLabel   label;          ///< Context of the speech unit
+                    CProsodyTag     tag;            ///< Prosody of the speech unit
+                    double          targetCost;     ///< Target cost between the target and the speech unit
+                    uint32          indexID;        ///< Index of the speech unit for looking up the precomputed join costs, INVALID_UNITID(-1) if not available
+                    bool            hasFeatures;    ///< Whether the boundary features of the speech unit are known
+                    float           headFeature[CJoinIndex::FEATURE_DIMENSION]; ///< Spectral features at the beginning of the speech unit
+                    float           tailFeature[CJoinIndex::FEATURE_DIMENSION]; ///< Spectral features at the end of the speech unit
+
+                public:
+                    CCandidate() : position(0), phonemeID(INVALID_ICODE), unitID(INVALID_UNITID), targetCost(0), indexID(INVALID_UNITID), hasFeatures(false) {}
+                };
 
             protected:
                 //////////////////////////////////////////////////////////////////////////
@@ -85,14 +126,15 @@ namespace cst
                 ///
                 /// @param  [in]  sentenceInfo  Target basic unit information for a sentence to be synthesized
                 /// @param  [out] waveData      Return the synthetic wave data by APPENDing the new data
+                /// @param  [in]  setting       The settings of current request
+                /// @param  [in]  pTrace        The trace to record the steps of the sentence, NULL if not recorded
                 ///
-                virtual int synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData);
+                virtual int synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData, const TTSSetting &setting, cmn::CTrace *pTrace);
 
                 ///
                 /// @brief  Selects the appropriate speech units from library (unit selection) for each basic unit in one sentence
                 ///
                 /// This function is called as the first step in the synthesize() procedure.
-                /// Every derived concatenation synthesis method should implement this function.
                 ///
                 /// The functionality of unit selection module is to select a speech unit from the speech library
                 /// which is mostly appropriate to match the target basic unit to be synthesized.
@@ -102,12 +144,67 @@ namespace cst
                 /// The index of the selected speech unit is stored in the "uid" attribute of "unit" element.
                 /// For example, "unit uid=zhong1:2" means the 2nd unit for phoneme (Pinyin) "zhong1".
                 ///
-                /// This default implementation of unit selection just selects the first unit as result
+                /// This default implementation searches the lattice of candidates for the path with the
+                /// minimum sum of target costs (see getTargetCost()) and join costs (see getJoinCost()) by
+                /// Viterbi decoding. Only the best TTSSetting::maxCandidates candidates of each unit by target
+                /// cost are searched, and the search is pruned to TTSSetting::beamWidth paths at each unit,
+                /// so that the search time of a sentence is bounded.
                 ///
                 /// @param  [in]  sentenceInfo  The target basic unit information for a sentence
                 /// @param  [out] sentenceInfo  Return the result with unit selection result
+                /// @param  [in]  setting       The settings of current request
+                ///
+                virtual int selectUnit(std::vector<CUnitItem> &sentenceInfo, const TTSSetting &setting);
+
+                ///
+                /// @brief  Collect the candidate speech units with wave data of a target basic unit, with their target costs
+                ///
+                /// @param  [in]  sentenceInfo  The target basic unit information for a sentence
+                /// @param  [in]  position      Position of the target basic unit in the sentence
+                /// @param  [in]  maxCandidates Maximum number of candidates with the least target costs, 0 for all candidates
+                /// @param  [out] candidates    Return the candidates in the order of target cost
+                ///
+                /// The boundary features of the candidates are retrieved from the join index of speech library
+                /// if it is loaded, or else they are extracted from the wave data of the candidates.
+                ///
+                virtual void getCandidates(const std::vector<CUnitItem> &sentenceInfo, size_t position, size_t maxCandidates, std::vector<CCandidate> &candidates) const;
+
                 ///
-                virtual int selectUnit(std::vector<CUnitItem> &sentenceInfo);
+                /// @brief  Get the target cost measuring how the speech unit matches the target basic unit
+                ///
+                /// The default implementation compares the pitch contour (in semitone), the duration and the
+                /// amplitude (in logarithm), and the phonemes of left and right context. The unknown values are skipped.
+                ///
+                /// @param  [in]  sentenceInfo  The target basic unit information for a sentence
+                /// @param  [in]  candidate     The candidate speech unit of the target basic unit at candidate.position
+                ///
+                /// @return The target cost, 0 for the perfect match
+                ///
+                virtual double getTargetCost(const std::vector<CUnitItem> &sentenceInfo, const CCandidate &candidate) const;
+
+                ///
+                /// @brief  Get the join cost measuring how smoothly two adjacent speech units are concatenated
+                ///
+                /// The default implementation compares the pitch (in semitone) at the joint, i.e. the end of
+                /// the preceding unit and the beginning of the succeeding unit, and the amplitude (in logarithm),
+                /// as well as the spectral features at the joint (see CJoinIndex). The spectral join cost of
+                /// the frequent pairs is looked up in the join index if it is precomputed.
+                ///
+                /// @param  [in]  prevCandidate The candidate speech unit of the preceding target basic unit
+                /// @param  [in]  candidate     The candidate speech unit of the succeeding target basic unit
+                ///
+                /// @return The join cost, 0 for the smooth concatenation
+                ///
+                virtual double getJoinCost(const CCandidate &prevCandidate, const CCandidate &candidate) const;
+
+            protected:
+                double  durationWeight;         ///< Weight of the duration difference in target cost
+                double  pitchWeight;            ///< Weight of the pitch contour difference in target cost
+                double  amplitudeWeight;        ///< Weight of the amplitude difference in target cost
+                double  contextWeight;          ///< Weight of each mismatched context phoneme in target cost
+                double  joinPitchWeight;        ///< Weight of the pitch difference at the joint in join cost
+                double  joinAmplitudeWeight;    ///< Weight of the amplitude difference at the joint in join cost
+                double  joinSpectralWeight;     ///< Weight of the spectral distance at the joint in join cost, 0 for not using spectral features
             };
 
         }//namespace base
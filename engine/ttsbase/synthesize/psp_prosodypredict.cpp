@@ -28,6 +28,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/07/29
 ///   Changed:  Re-implemented using the new architecture with internal representation
+/// - Version:  0.3.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
 ///
 
 #include "../datavoice/data_voicedata.h"
@@ -59,6 +63,25 @@ namespace cst
                 return writeResult(pSSMLDocument, prosodyDocument);
             }
 
+            int CProsodyPredict::process(CUtterance &utterance)
+            {
+                int retVal = ERROR_SUCCESS;
+                CPSPDocument prosodyDocument;
+
+                // retrieve data from typed utterance
+                retVal = prosodyDocument.build(utterance);
+                if (retVal != ERROR_SUCCESS)
+                    return retVal;
+
+                // process internal data for prosody prediction
+                retVal = predictProsody(prosodyDocument);
+                if (retVal != ERROR_SUCCESS)
+                    return retVal;
+
+                // write result back to typed utterance
+                return writeResult(utterance, prosodyDocument);
+            }
+
 
             //////////////////////////////////////////////////////////////////////////
             //
@@ -85,17 +108,17 @@ namespace cst
                 childProcessed = false;
                 if (pNode->type() == xml::CXMLNode::XML_ELEMENT)
                 {
-                    if (pNode->value() == L"p")
+                    if (pNode->nameId() == xml::XML_NAME_P)
                     {
                         // paragraph
                         appendParagraph();
                     }
-                    else if (pNode->value() == L"s")
+                    else if (pNode->nameId() == xml::XML_NAME_S)
                     {
                         // sentence
                         appendSentence();
                     }
-                    else if (pNode->value() == L"unit")
+                    else if (pNode->nameId() == xml::XML_NAME_UNIT)
                     {
                         // get unit information
                         CUnitItem unitInfo;
@@ -110,7 +133,7 @@ namespace cst
                         appendItem(unitInfo);
                         childProcessed = true;
                     }
-                    else if (pNode->value() == L"break")
+                    else if (pNode->nameId() == xml::XML_NAME_BREAK)
                     {
                         // break
                         CUnitItem unitInfo;
@@ -125,7 +148,7 @@ namespace cst
                         }
                         appendItem(unitInfo);
                     }
-                    else if (pNode->value() == L"prosody")
+                    else if (pNode->nameId() == xml::XML_NAME_PROSODY)
                     {
                         // prosody
                         SSMLProsody prosInfo;
@@ -134,7 +157,7 @@ namespace cst
                             return succ;
                         m_stackProsody.push(prosInfo);
                     }
-                    else if (pNode->value() == L"emphasis")
+                    else if (pNode->nameId() == xml::XML_NAME_EMPHASIS)
                     {
                         // emphasis
                         SSMLProsody prosInfo;
@@ -147,16 +170,62 @@ namespace cst
                 return ERROR_SUCCESS;
             }
 
+            int CProsodyPredict::CPSPDocument::build(CUtterance &utterance)
+            {
+                for (std::vector<CUttParagraph>::iterator pit = utterance.paragraphs.begin(); pit != utterance.paragraphs.end(); ++pit)
+                {
+                    appendParagraph();
+                    for (std::vector<CUttSentence>::iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+                    {
+                        appendSentence();
+                        std::vector<CUnitItem> &sentence = getLastSentence();
+
+                        // the items are in the same order as the "break" and "unit" elements
+                        CUnitItem breakInfo;
+                        breakInfo.isBreak = true;
+                        if (sit->breakBefore.exists)
+                        {
+                            breakInfo.boundaryType = sit->breakBefore.boundaryType;
+                            appendItem(breakInfo);
+                        }
+                        for (std::vector<CUttWord>::const_iterator wit = sit->words.begin(); wit != sit->words.end(); ++wit)
+                        {
+                            for (std::vector<CUttSyllable>::const_iterator it = wit->syllables.begin(); it != wit->syllables.end(); ++it)
+                            {
+                                CUnitItem unitInfo;
+                                unitInfo.wstrText    = it->wstrText;
+                                unitInfo.wstrPhoneme = it->wstrPhoneme;
+                                unitInfo.ssmlProsody.rate   = wit->rate;
+                                unitInfo.ssmlProsody.volume = wit->volume;
+                                unitInfo.ssmlProsody.pitch  = wit->pitch;
+                                appendItem(unitInfo);
+                            }
+                            if (wit->breakAfter.exists)
+                            {
+                                // set the boundary information of the previous unit
+                                breakInfo.boundaryType = wit->breakAfter.boundaryType;
+                                if (sentence.size() != 0)
+                                {
+                                    sentence.back().boundaryType = breakInfo.boundaryType;
+                                }
+                                appendItem(breakInfo);
+                            }
+                        }
+                    }
+                }
+                return ERROR_SUCCESS;
+            }
+
             int CProsodyPredict::CPSPDocument::postProcessNode(xml::CXMLNode *pNode)
             {
                 if (pNode->type() == xml::CXMLNode::XML_ELEMENT)
                 {
-                    if (pNode->value() == L"prosody")
+                    if (pNode->nameId() == xml::XML_NAME_PROSODY)
                     {
                         // end of prosody
                         m_stackProsody.pop();
                     }
-                    else if (pNode->value() == L"emphasis")
+                    else if (pNode->nameId() == xml::XML_NAME_EMPHASIS)
                     {
                         // end of emphasis
                         m_stackProsody.pop();
@@ -183,7 +252,7 @@ namespace cst
 
                 // get phoneme, text, boundary information
                 unitInfo.wstrText    = pText->value();
-                unitInfo.wstrPhoneme = pPhoneme->getAttribute(L"ph");
+                unitInfo.wstrPhoneme = pPhoneme->getAttribute(xml::XML_NAME_PH);
                 unitInfo.pXMLNode    = pWordNode;
                 unitInfo.boundaryType= xml::CSSMLDocument::PROSBOUND_SYLLABLE;
                 unitInfo.isStressed  = false;
@@ -195,7 +264,7 @@ namespace cst
             int CProsodyPredict::CPSPDocument::parseEmphasisInfo(xml::CXMLElement *pEmphasisNode, SSMLProsody &prosInfo) const
             {
                 // get level attribute, default is "moderate"
-                const std::wstring& level = pEmphasisNode->getAttribute(L"level");
+                const std::wstring& level = pEmphasisNode->getAttribute(xml::XML_NAME_LEVEL);
                 std::wstring pitch, rate, volume;
 
                 // set prosody value
@@ -243,7 +312,7 @@ namespace cst
             int CProsodyPredict::CPSPDocument::parseProsodyInfo(xml::CXMLElement *pProsodyNode, SSMLProsody &prosInfo) const
             {
                 // get pitch
-                prosInfo.pitch = xml::CSSMLHelper::parsePitch(pProsodyNode->getAttribute(L"pitch"));
+                prosInfo.pitch = xml::CSSMLHelper::parsePitch(pProsodyNode->getAttribute(xml::XML_NAME_PITCH));
                 if (prosInfo.pitch == -1)
                 {
                     // invalid pitch
@@ -251,7 +320,7 @@ namespace cst
                 }
 
                 // get rate
-                prosInfo.rate = xml::CSSMLHelper::parseRate(pProsodyNode->getAttribute(L"rate"));
+                prosInfo.rate = xml::CSSMLHelper::parseRate(pProsodyNode->getAttribute(xml::XML_NAME_RATE));
                 if (prosInfo.rate == -1)
                 {
                     // invalid rate
@@ -259,7 +328,7 @@ namespace cst
                 }
 
                 // get volume
-                prosInfo.volume = xml::CSSMLHelper::parseVolume(pProsodyNode->getAttribute(L"volume"));
+                prosInfo.volume = xml::CSSMLHelper::parseVolume(pProsodyNode->getAttribute(xml::XML_NAME_VOLUME));
                 if (prosInfo.volume == -1)
                 {
                     // invalid volume
@@ -290,13 +359,16 @@ namespace cst
                     {
                         const CUnitItem &unitInfo = *it;
 
-                        if (unitInfo.isBreak && unitInfo.pXMLNode != NULL && unitInfo.pXMLNode->getAttribute(L"time").length() == 0)
+                        if (unitInfo.isBreak)
                         {
                             // set break time information
                             // if original time exist, leave it unchanged!
-                            std::wstring times;
-                            xml::CSSMLHelper::composeString(times, L"%dms", (int)unitInfo.duration);
-                            unitInfo.pXMLNode->setAttribute(L"time", times);
+                            if (unitInfo.pXMLNode != NULL && unitInfo.pXMLNode->getAttribute(xml::XML_NAME_TIME).length() == 0)
+                            {
+                                std::wstring times;
+                                xml::CSSMLHelper::composeString(times, L"%dms", (int)unitInfo.duration);
+                                unitInfo.pXMLNode->setAttribute(xml::XML_NAME_TIME, times);
+                            }
                             continue;
                         }
 
@@ -309,26 +381,26 @@ namespace cst
 
                             // create "prosody" element
                             std::wstring attVal, tmpVal;
-                            xml::CXMLElement *pProsody = new xml::CXMLElement(L"prosody");
+                            xml::CXMLElement *pProsody = pSSMLDocument->createElement(L"prosody");
                             xml::CSSMLHelper::composeString(attVal, L"%.3f", unitInfo.ssmlProsody.rate);
-                            pProsody->setAttribute(L"dratio", attVal);
+                            pProsody->setAttribute(xml::XML_NAME_DRATIO, attVal);
                             xml::CSSMLHelper::composeString(attVal, L"%.3f", unitInfo.ssmlProsody.volume);
-                            pProsody->setAttribute(L"vratio", attVal);
+                            pProsody->setAttribute(xml::XML_NAME_VRATIO, attVal);
                             xml::CSSMLHelper::composeString(attVal, L"%.3f", unitInfo.ssmlProsody.pitch);
-                            pProsody->setAttribute(L"pratio", attVal);
+                            pProsody->setAttribute(xml::XML_NAME_PRATIO, attVal);
                             xml::CSSMLHelper::composeString(attVal, L"%dms", (int)unitInfo.duration);
-                            pProsody->setAttribute(L"duration", attVal);
+                            pProsody->setAttribute(xml::XML_NAME_DURATION, attVal);
                             xml::CSSMLHelper::composeString(attVal, L"%d", (int)unitInfo.amplitude);
-                            pProsody->setAttribute(L"volume", attVal);
+                            pProsody->setAttribute(xml::XML_NAME_VOLUME, attVal);
                             xml::CSSMLHelper::composeString(attVal, L"%dHz", (int)unitInfo.pitchmean);
-                            pProsody->setAttribute(L"pitch", attVal);
+                            pProsody->setAttribute(xml::XML_NAME_PITCH, attVal);
                             attVal = L"";
                             for (int i=0; i<10; i++)
                             {
                                 xml::CSSMLHelper::composeString(tmpVal, L"%dHz ", (int)unitInfo.contour[i]);
                                 attVal += tmpVal;
                             }
-                            pProsody->setAttribute(L"contour", attVal);
+                            pProsody->setAttribute(xml::XML_NAME_CONTOUR, attVal);
                             pProsody->linkLastChild(pPhoneme);
 
                             // insert "prosody" as child of "unit" element
@@ -340,6 +412,61 @@ namespace cst
                 return ERROR_SUCCESS;
             }
 
+            /// Set the break time from the prediction, if it is not specified in the input
+            static void setBreakTime(CUttBreak &breakInfo, float duration)
+            {
+                if (breakInfo.time < 0)
+                    breakInfo.time = (float)(int)duration;
+            }
+
+            int CProsodyPredict::writeResult(CUtterance &utterance, CPSPDocument &unitDocument)
+            {
+                unitDocument.resetCursor();
+                for (std::vector<CUttParagraph>::iterator pit = utterance.paragraphs.begin(); pit != utterance.paragraphs.end(); ++pit)
+                {
+                    for (std::vector<CUttSentence>::iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+                    {
+                        const std::vector<CUnitItem> *pSentence = unitDocument.getSentence();
+                        if (pSentence == NULL)
+                            return ERROR_INVALID_SSML_DOCUMENT;
+
+                        // visit the items in the same order as they are built
+                        std::vector<CUnitItem>::const_iterator it = pSentence->begin();
+                        if (sit->breakBefore.exists && it != pSentence->end())
+                        {
+                            setBreakTime(sit->breakBefore, it->duration);
+                            ++it;
+                        }
+                        for (std::vector<CUttWord>::iterator wit = sit->words.begin(); wit != sit->words.end(); ++wit)
+                        {
+                            for (std::vector<CUttSyllable>::iterator yit = wit->syllables.begin(); yit != wit->syllables.end() && it != pSentence->end(); ++yit, ++it)
+                            {
+                                const CUnitItem &unitInfo = *it;
+                                CUttSyllable &syllable = *yit;
+                                syllable.rate      = unitInfo.ssmlProsody.rate;
+                                syllable.volume    = unitInfo.ssmlProsody.volume;
+                                syllable.pitch     = unitInfo.ssmlProsody.pitch;
+                                syllable.duration  = (float)(int)unitInfo.duration;
+                                syllable.amplitude = (float)(int)unitInfo.amplitude;
+                                syllable.pitchmean = (float)(int)unitInfo.pitchmean;
+                                for (int i=0; i<10; i++)
+                                {
+                                    syllable.contour[i] = (float)(int)unitInfo.contour[i];
+                                }
+                            }
+                            if (wit->breakAfter.exists && it != pSentence->end())
+                            {
+                                setBreakTime(wit->breakAfter, it->duration);
+                                ++it;
+                            }
+                        }
+                    }
+                }
+                utterance.stage = CUtterance::STAGE_PROSODY;
+
+                return ERROR_SUCCESS;
+            }
+
             int CProsodyPredict::predictProsody(CPSPDocument &unitDocument)
             {
                 int retVal = ERROR_SUCCESS;
@@ -28,6 +28,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/07/29
 ///   Changed:  Re-implemented using the new architecture with internal representation
+/// - Version:  0.3.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
 ///
 
 #ifndef _CST_TTS_BASE_PSP_PROSODYPREDICT_H_
@@ -38,6 +42,7 @@
 #include "xml/ssml_traversal.h"
 #include "../datamanage/base_module.h"
 #include "../datamanage/base_ttsdocument.h"
+#include "../datamanage/base_utterance.h"
 
 namespace cst
 {
@@ -79,6 +84,17 @@ namespace cst
                 ///
                 virtual int process(xml::CSSMLDocument * pSSMLDocument);
 
+                ///
+                /// @brief  The main processing procedure of the prosody prediction module for typed utterance
+                ///
+                /// @param  [in]  utterance  The input utterance with syllable information
+                /// @param  [out] utterance  Return the utterance with prosody of each syllable and break
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                ///
+                virtual int process(CUtterance &utterance);
+
 
             protected:
                 //////////////////////////////////////////////////////////////////////////
@@ -131,6 +147,12 @@ namespace cst
                 ///
                 class CPSPDocument : public CTTSDocument<CUnitItem>, public xml::CSSMLTraversal
                 {
+                public:
+                    ///
+                    /// @brief  Build internal document from the typed utterance
+                    ///
+                    int build(CUtterance &utterance);
+
                 protected:
                     ///
                     /// @brief  Process a specific SSML document node, to build the internal document
@@ -185,6 +207,16 @@ namespace cst
                 ///
                 virtual int writeResult(xml::CSSMLDocument *pSSMLDocument, CPSPDocument &prosodyDocument);
 
+                ///
+                /// @brief  Write the result from internal result to the typed utterance
+                ///
+                /// The prosody values are truncated to integers, same as those written to SSML document.
+                ///
+                /// @param  [in]  prosodyDocument   The internal results to be written
+                /// @param  [out] utterance         Return the utterance with prosody prediction result
+                ///
+                virtual int writeResult(CUtterance &utterance, CPSPDocument &prosodyDocument);
+
                 ///
                 /// @brief  Perform the prosody prediction for the whole internal document
                 ///
@@ -32,11 +32,36 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/07/29
 ///   Changed:  Re-implemented using the new architecture with internal representation
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the parallel synthesis of the sentences by worker threads
+/// - Version:  0.3.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
+/// - Version:  0.3.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Passed the settings of each request to synthesis instead of using the global settings
+/// - Version:  0.3.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Kept the trace from the sentences synthesized in parallel
+/// - Version:  0.3.3
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Kept the worker threads of parallel synthesis instead of creating them for each document
+/// - Version:  0.3.4
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Passed the trace to the synthesis of each sentence instead of changing the trace of the module
 ///
 
 #include "../datavoice/data_voicedata.h"
 #include "synth_synthesize.h"
 #include "xml/ssml_helper.h"
+#include <algorithm>
 
 namespace cst
 {
@@ -45,6 +70,16 @@ namespace cst
         namespace base
         {
             int CSynthesize::process(xml::CSSMLDocument *pSSMLDocument, dsp::CWaveData &waveData)
+            {
+                return process(pSSMLDocument, waveData, NULL);
+            }
+
+            int CSynthesize::process(xml::CSSMLDocument *pSSMLDocument, dsp::CWaveData &waveData, dsp::CWaveSink *waveSink)
+            {
+                return process(pSSMLDocument, waveData, getDataManager<CVoiceData>()->getGlobalSetting(), waveSink);
+            }
+
+            int CSynthesize::process(xml::CSSMLDocument *pSSMLDocument, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink)
             {
                 CSynthDocument synthDocument;
 
@@ -62,12 +97,40 @@ namespace cst
                 waveData.setFormat(samplesPerSec, bitsPerSample, channels);
 
                 // perform synthesis based on the internal data
-                synthesize(synthDocument, waveData);
+                int retCode = synthesize(synthDocument, waveData, setting, waveSink);
 
                 // save new duration
                 writeResult(pSSMLDocument, synthDocument);
 
-                return ERROR_SUCCESS;
+                return (retCode == ERROR_OPERATION_ABORTED) ? retCode : ERROR_SUCCESS;
+            }
+
+            int CSynthesize::process(CUtterance &utterance, dsp::CWaveData &waveData, dsp::CWaveSink *waveSink)
+            {
+                return process(utterance, waveData, getDataManager<CVoiceData>()->getGlobalSetting(), waveSink);
+            }
+
+            int CSynthesize::process(CUtterance &utterance, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink)
+            {
+                CSynthDocument synthDocument;
+
+                // retrieve data from typed utterance
+                synthDocument.build(utterance);
+
+                // clear the original wave data
+                waveData.clear();
+
+                // set the wave format
+                const CWavSynthesizer &wavsyn = getDataManager<CVoiceData>()->getWavSynthesizer();
+                waveData.setFormat(wavsyn.getSamplesPerSec(), wavsyn.getBitsPerSample(), wavsyn.getChannels());
+
+                // perform synthesis based on the internal data
+                int retCode = synthesize(synthDocument, waveData, setting, waveSink);
+
+                // save new duration
+                writeResult(utterance, synthDocument);
+
+                return (retCode == ERROR_OPERATION_ABORTED) ? retCode : ERROR_SUCCESS;
             }
 
 
@@ -94,6 +157,62 @@ namespace cst
                 volume      = 0;
                 pitch       = 0;
                 memset(contour, 0, sizeof(float)*10);
+                phones.clear();
+            }
+
+            int CSynthesize::CSynthDocument::build(CUtterance &utterance)
+            {
+                // the items and boundary types are the same as those built by SSML traversing
+                for (std::vector<CUttParagraph>::iterator pit = utterance.paragraphs.begin(); pit != utterance.paragraphs.end(); ++pit)
+                {
+                    appendParagraph();
+                    for (std::vector<CUttSentence>::iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+                    {
+                        appendSentence();
+                        if (sit->breakBefore.exists)
+                        {
+                            appendBreak(sit->breakBefore);
+                        }
+                        for (std::vector<CUttWord>::const_iterator wit = sit->words.begin(); wit != sit->words.end(); ++wit)
+                        {
+                            for (std::vector<CUttSyllable>::const_iterator it = wit->syllables.begin(); it != wit->syllables.end(); ++it)
+                            {
+                                CUnitItem unitInfo;
+                                unitInfo.wstrPhoneme= it->wstrPhoneme;
+                                unitInfo.wstrText   = it->wstrText;
+                                unitInfo.duration   = it->duration;
+                                unitInfo.amplitude  = it->amplitude;
+                                unitInfo.pitchmean  = it->pitchmean;
+                                memcpy(unitInfo.contour, it->contour, sizeof(float)*10);
+                                unitInfo.rate       = it->rate;
+                                unitInfo.volume     = it->volume;
+                                unitInfo.pitch      = it->pitch;
+                                appendItem(unitInfo);
+                            }
+                            // set lexicon word boundary information
+                            setBoundaryTypeTillNonbreak(getLastSentence(), xml::CSSMLDocument::PROSBOUND_LWORD);
+                            if (wit->breakAfter.exists)
+                            {
+                                appendBreak(wit->breakAfter);
+                            }
+                        }
+                        // set sentence boundary information
+                        setBoundaryTypeTillNonbreak(getLastSentence(), xml::CSSMLDocument::PROSBOUND_SENTENCE);
+                    }
+                }
+                return ERROR_SUCCESS;
+            }
+
+            void CSynthesize::CSynthDocument::appendBreak(const CUttBreak &breakInfo)
+            {
+                CUnitItem unitInfo;
+                unitInfo.duration = (breakInfo.time < 0) ? 0 : breakInfo.time;
+                unitInfo.isBreak  = true;
+                unitInfo.boundaryType = breakInfo.boundaryType;
+                appendItem(unitInfo);
+
+                // set boundary information according to boundary type
+                setBoundaryTypeTillNonbreak(getLastSentence(), breakInfo.boundaryType);
             }
 
             int CSynthesize::CSynthDocument::processNode(xml::CXMLNode *pNode, bool &childProcessed)
@@ -101,17 +220,17 @@ namespace cst
                 childProcessed = false;
                 if (pNode->type() == xml::CXMLNode::XML_ELEMENT)
                 {
-                    if (pNode->value() == L"p")
+                    if (pNode->nameId() == xml::XML_NAME_P)
                     {
                         // paragraph
                         appendParagraph();
                     }
-                    else if (pNode->value() == L"s")
+                    else if (pNode->nameId() == xml::XML_NAME_S)
                     {
                         // sentence
                         appendSentence();
                     }
-                    else if (pNode->value() == L"break")
+                    else if (pNode->nameId() == xml::XML_NAME_BREAK)
                     {
                         // break
                         CUnitItem breakInfo;
@@ -120,7 +239,7 @@ namespace cst
 
                         childProcessed = true;
                     }
-                    else if (pNode->value() == L"unit")
+                    else if (pNode->nameId() == xml::XML_NAME_UNIT)
                     {
                         // get basic unit information
                         CUnitItem unitInfo;
@@ -138,17 +257,17 @@ namespace cst
                 // set the boundary information only after "s", "w" and "break" are processed
                 if (pNode->type() == xml::CXMLNode::XML_ELEMENT)
                 {
-                    if (pNode->value() == L"s")
+                    if (pNode->nameId() == xml::XML_NAME_S)
                     {
                         // set sentence boundary information
                         setBoundaryTypeTillNonbreak(getLastSentence(), xml::CSSMLDocument::PROSBOUND_SENTENCE);
                     }
-                    else if (pNode->value() == L"break")
+                    else if (pNode->nameId() == xml::XML_NAME_BREAK)
                     {
                         // set boundary information according to boundary type
                         setBoundaryTypeTillNonbreak(getLastSentence(), xml::CSSMLHelper::getBoundaryType((xml::CXMLElement*)pNode));
                     }
-                    else if (pNode->value() == L"w")
+                    else if (pNode->nameId() == xml::XML_NAME_W)
                     {
                         // set lexicon word boundary information
                         setBoundaryTypeTillNonbreak(getLastSentence(), xml::CSSMLDocument::PROSBOUND_LWORD);
@@ -174,7 +293,7 @@ namespace cst
 
             int CSynthesize::CSynthDocument::getBreakInfo(xml::CXMLElement *pBreakNode, CUnitItem &breakInfo) const
             {
-                float fBreakTime = xml::CSSMLHelper::parseTime(pBreakNode->getAttribute(L"time"));
+                float fBreakTime = xml::CSSMLHelper::parseTime(pBreakNode->getAttribute(xml::XML_NAME_TIME));
 
                 // get the break information
                 breakInfo.clear();
@@ -219,20 +338,20 @@ namespace cst
                 unitInfo.pXMLNode = pUnitNode;
 
                 // get phoneme, text information
-                unitInfo.wstrPhoneme= pPhoneme->getAttribute(L"ph");
+                unitInfo.wstrPhoneme= pPhoneme->getAttribute(xml::XML_NAME_PH);
                 unitInfo.wstrText   = pText->value();
                 unitInfo.phonemeID  = INVALID_ICODE;
                 unitInfo.unitID     = INVALID_UNITID;
 
                 // get prosody information
-                unitInfo.duration   = xml::CSSMLHelper::parseTime(pProsody->getAttribute(L"duration"));
-                unitInfo.amplitude  = xml::CSSMLHelper::parseFloatNumber(pProsody->getAttribute(L"volume"));
-                unitInfo.pitchmean  = xml::CSSMLHelper::parseFrequency(pProsody->getAttribute(L"pitch"));
-                if (pProsody->getAttribute(L"contour").length() > 0)
-                    memcpy(unitInfo.contour, &(xml::CSSMLHelper::parseFrequencyList(pProsody->getAttribute(L"contour"))[0]), sizeof(float)*10);
-                unitInfo.rate       = xml::CSSMLHelper::parseFloatNumber(pProsody->getAttribute(L"dratio"));
-                unitInfo.volume     = xml::CSSMLHelper::parseFloatNumber(pProsody->getAttribute(L"vratio"));
-                unitInfo.pitch      = xml::CSSMLHelper::parseFloatNumber(pProsody->getAttribute(L"pratio"));
+                unitInfo.duration   = xml::CSSMLHelper::parseTime(pProsody->getAttribute(xml::XML_NAME_DURATION));
+                unitInfo.amplitude  = xml::CSSMLHelper::parseFloatNumber(pProsody->getAttribute(xml::XML_NAME_VOLUME));
+                unitInfo.pitchmean  = xml::CSSMLHelper::parseFrequency(pProsody->getAttribute(xml::XML_NAME_PITCH));
+                if (pProsody->getAttribute(xml::XML_NAME_CONTOUR).length() > 0)
+                    memcpy(unitInfo.contour, &(xml::CSSMLHelper::parseFrequencyList(pProsody->getAttribute(xml::XML_NAME_CONTOUR))[0]), sizeof(float)*10);
+                unitInfo.rate       = xml::CSSMLHelper::parseFloatNumber(pProsody->getAttribute(xml::XML_NAME_DRATIO));
+                unitInfo.volume     = xml::CSSMLHelper::parseFloatNumber(pProsody->getAttribute(xml::XML_NAME_VRATIO));
+                unitInfo.pitch      = xml::CSSMLHelper::parseFloatNumber(pProsody->getAttribute(xml::XML_NAME_PRATIO));
                 unitInfo.isStressed = false;
 
                 // boundary information
@@ -271,14 +390,14 @@ namespace cst
                             // set break time information
                             std::wstring times;
                             xml::CSSMLHelper::composeString(times, L"%dms", (int)unitInfo.duration);
-                            unitInfo.pXMLNode->setAttribute(L"time", times);
+                            unitInfo.pXMLNode->setAttribute(xml::XML_NAME_TIME, times);
                         }
                         else
                         {
                             // save uid
                             std::wstring wstrUid;
                             xml::CSSMLHelper::composeString(wstrUid, L":%d", unitInfo.unitID);
-                            unitInfo.pXMLNode->setAttribute(L"uid", it->wstrPhoneme + wstrUid);
+                            unitInfo.pXMLNode->setAttribute(xml::XML_NAME_UID, it->wstrPhoneme + wstrUid);
 
                             // set prosody information
                             // "unit" element can only contain "prosody" element
@@ -288,7 +407,7 @@ namespace cst
                                 xml::CXMLElement *pProsody = (xml::CXMLElement*)pChild;
                                 std::wstring attVal;
                                 xml::CSSMLHelper::composeString(attVal, L"%dms", (int)unitInfo.duration);
-                                pProsody->setAttribute(L"duration", attVal);
+                                pProsody->setAttribute(xml::XML_NAME_DURATION, attVal);
                                 pProsody->removeAttribute(L"dratio");
                                 pProsody->removeAttribute(L"vratio");
                                 pProsody->removeAttribute(L"pratio");
@@ -303,8 +422,56 @@ namespace cst
                 return ERROR_SUCCESS;
             }
 
-            int CSynthesize::synthesize(CSynthDocument &synthDocument, dsp::CWaveData &waveData)
+            int CSynthesize::writeResult(CUtterance &utterance, CSynthDocument &synthDocument)
+            {
+                synthDocument.resetCursor();
+                for (std::vector<CUttParagraph>::iterator pit = utterance.paragraphs.begin(); pit != utterance.paragraphs.end(); ++pit)
+                {
+                    for (std::vector<CUttSentence>::iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+                    {
+                        const std::vector<CUnitItem> *pSentence = synthDocument.getSentence();
+                        if (pSentence == NULL)
+                            return ERROR_INVALID_SSML_DOCUMENT;
+
+                        // visit the items in the same order as they are built
+                        std::vector<CUnitItem>::const_iterator it = pSentence->begin();
+                        if (sit->breakBefore.exists && it != pSentence->end())
+                        {
+                            sit->breakBefore.time = it->duration;
+                            ++it;
+                        }
+                        for (std::vector<CUttWord>::iterator wit = sit->words.begin(); wit != sit->words.end(); ++wit)
+                        {
+                            for (std::vector<CUttSyllable>::iterator yit = wit->syllables.begin(); yit != wit->syllables.end() && it != pSentence->end(); ++yit, ++it)
+                            {
+                                yit->duration = it->duration;
+                                yit->unitID   = it->unitID;
+                                yit->phones   = it->phones;
+                            }
+                            if (wit->breakAfter.exists && it != pSentence->end())
+                            {
+                                wit->breakAfter.time = it->duration;
+                                ++it;
+                            }
+                        }
+                    }
+                }
+                utterance.stage = CUtterance::STAGE_SYNTHESIS;
+
+                return ERROR_SUCCESS;
+            }
+
+            int CSynthesize::synthesize(CSynthDocument &synthDocument, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink)
             {
+                // synthesize sentences in parallel if not streaming
+                int numWorkers = setting.workers;
+                if (numWorkers <= 0)
+                    numWorkers = cmn::CThread::getProcessorNumber();
+                if (waveSink == NULL && numWorkers > 1)
+                {
+                    return synthesizeParallel(synthDocument, waveData, setting, numWorkers);
+                }
+
                 synthDocument.resetCursor();
                 for (;;)
                 {
@@ -313,12 +480,176 @@ namespace cst
                         break;
 
                     // perform speech synthesis for a sentence
-                    synthesize(*pSentence, waveData);
+                    if (waveSink == NULL)
+                    {
+                        synthesize(*pSentence, waveData, setting, getTrace());
+                    }
+                    else if (synthesize(*pSentence, waveData, setting, *waveSink, getTrace()) == ERROR_OPERATION_ABORTED)
+                    {
+                        // stopped by wave sink
+                        return ERROR_OPERATION_ABORTED;
+                    }
                 }
                 return ERROR_SUCCESS;
             }
 
-            int CSynthesize::synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData)
+            int CSynthesize::synthesizeParallel(CSynthDocument &synthDocument, dsp::CWaveData &waveData, const TTSSetting &setting, int numWorkers)
+            {
+                CSynthJob synthJob(setting);
+
+                // collect all sentences
+                synthDocument.resetCursor();
+                for (;;)
+                {
+                    std::vector<CUnitItem> *pSentence = synthDocument.getSentence();
+                    if (pSentence == NULL)
+                        break;
+                    synthJob.sentences.push_back(pSentence);
+                }
+                synthJob.waveData.resize(synthJob.sentences.size());
+                for (size_t i = 0; i < synthJob.waveData.size(); i++)
+                {
+                    synthJob.waveData[i].setFormat(waveData.getSamplesPerSec(), waveData.getBitsPerSample(), waveData.getChannels(), waveData.getFormatTag());
+                }
+
+                {
+                    cmn::CAutoLock lock(m_mutex);
+
+                    // start the missing worker threads, current thread works as one of the workers
+                    if ((size_t)numWorkers > synthJob.sentences.size())
+                        numWorkers = (int)synthJob.sentences.size();
+                    while ((int)m_workers.size() < numWorkers - 1)
+                    {
+                        CSynthWorker *pWorker = new CSynthWorker(*this);
+                        if (!pWorker->start())
+                        {
+                            delete pWorker;
+                            break;
+                        }
+                        m_workers.push_back(pWorker);
+                    }
+
+                    // post the job to the workers
+                    synthJob.maxHelpers = numWorkers - 1;
+                    if (synthJob.maxHelpers > (int)m_workers.size())
+                        synthJob.maxHelpers = (int)m_workers.size();
+                    if (synthJob.maxHelpers > 0)
+                    {
+                        m_jobs.push_back(&synthJob);
+                        m_jobPosted.broadcast();
+                    }
+                    workOn(synthJob);
+
+                    // wait for the workers to finish the sentences they have taken
+                    while (synthJob.numDone < synthJob.sentences.size() || synthJob.numHelpers > 0)
+                        synthJob.finished.wait(m_mutex);
+                }
+
+                // append wave data in the order of sentences
+                unsigned long totalLength = waveData.getLength();
+                for (std::vector<dsp::CWaveData>::const_iterator it = synthJob.waveData.begin(); it != synthJob.waveData.end(); ++it)
+                {
+                    totalLength += it->getLength();
+                }
+                if (!waveData.reserve(totalLength))
+                {
+                    return ERROR_OUTOFMEMORY;
+                }
+                for (std::vector<dsp::CWaveData>::const_iterator it = synthJob.waveData.begin(); it != synthJob.waveData.end(); ++it)
+                {
+                    if (it->getLength() > 0 && !waveData.appendData(it->getData(), it->getLength()))
+                    {
+                        return ERROR_OUTOFMEMORY;
+                    }
+                }
+                return ERROR_SUCCESS;
+            }
+
+            void CSynthesize::serveJobs()
+            {
+                cmn::CAutoLock lock(m_mutex);
+                for (;;)
+                {
+                    // find the first job which needs more workers
+                    CSynthJob *pJob = NULL;
+                    for (std::deque<CSynthJob*>::iterator it = m_jobs.begin(); it != m_jobs.end(); ++it)
+                    {
+                        if ((*it)->numHelpers < (*it)->maxHelpers)
+                        {
+                            pJob = *it;
+                            break;
+                        }
+                    }
+                    if (pJob == NULL)
+                    {
+                        if (m_stopping)
+                            break;
+                        m_jobPosted.wait(m_mutex);
+                        continue;
+                    }
+
+                    // the job is not finished until all its workers leave
+                    pJob->numHelpers++;
+                    workOn(*pJob);
+                    pJob->numHelpers--;
+                    if (pJob->numHelpers == 0 && pJob->numDone == pJob->sentences.size())
+                        pJob->finished.signal();
+                }
+            }
+
+            void CSynthesize::workOn(CSynthJob &synthJob)
+            {
+                while (synthJob.nextSentence < synthJob.sentences.size())
+                {
+                    // take next sentence, and remove the job from queue after its last sentence is taken
+                    size_t index = synthJob.nextSentence++;
+                    if (synthJob.nextSentence == synthJob.sentences.size())
+                    {
+                        std::deque<CSynthJob*>::iterator it = std::find(m_jobs.begin(), m_jobs.end(), &synthJob);
+                        if (it != m_jobs.end())
+                            m_jobs.erase(it);
+                    }
+
+                    // perform speech synthesis for the sentence, without trace as the trace is not synchronized
+                    m_mutex.unlock();
+                    synthesize(*synthJob.sentences[index], synthJob.waveData[index], synthJob.setting, NULL);
+                    m_mutex.lock();
+
+                    synthJob.numDone++;
+                    if (synthJob.numDone == synthJob.sentences.size() && synthJob.numHelpers == 0)
+                        synthJob.finished.signal();
+                }
+            }
+
+            CSynthesize::~CSynthesize()
+            {
+                // no job is posted when the module is destroyed
+                m_mutex.lock();
+                m_stopping = true;
+                m_jobPosted.broadcast();
+                m_mutex.unlock();
+
+                for (std::vector<CSynthWorker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+                {
+                    (*it)->join();
+                    delete *it;
+                }
+            }
+
+            int CSynthesize::synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink &waveSink, cmn::CTrace *pTrace)
+            {
+                unsigned long oldLength = waveData.getLength();
+                int retCode = synthesize(sentenceInfo, waveData, setting, pTrace);
+
+                // pass the new wave data of the sentence
+                if (waveData.getLength() > oldLength && !waveSink.write(waveData.getData() + oldLength, waveData.getLength() - oldLength))
+                {
+                    return ERROR_OPERATION_ABORTED;
+                }
+                return retCode;
+            }
+
+            int CSynthesize::synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData, const TTSSetting &setting, cmn::CTrace *pTrace)
             {
                 const CWavSynthesizer &wavsyn = getDataManager<CVoiceData>()->getWavSynthesizer();
                 int samplesPerSec = wavsyn.getSamplesPerSec();
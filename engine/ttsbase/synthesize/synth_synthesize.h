@@ -32,16 +32,44 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/07/29
 ///   Changed:  Re-implemented using the new architecture with internal representation
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the parallel synthesis of the sentences by worker threads
+/// - Version:  0.3.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
+/// - Version:  0.3.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Passed the settings of each request to synthesis instead of using the global settings
+/// - Version:  0.3.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Kept the trace from the sentences synthesized in parallel
+/// - Version:  0.3.3
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Kept the worker threads of parallel synthesis instead of creating them for each document
+/// - Version:  0.3.4
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Passed the trace to the synthesis of each sentence instead of changing the trace of the module
 ///
 
 #ifndef _CST_TTS_BASE_SYNTH_SYNTHESIZE_H_
 #define _CST_TTS_BASE_SYNTH_SYNTHESIZE_H_
 
+#include <deque>
 #include "xml/ssml_document.h"
 #include "xml/ssml_traversal.h"
 #include "../datamanage/base_module.h"
 #include "../datamanage/base_ttsdocument.h"
+#include "../datamanage/base_utterance.h"
+#include "../datamanage/data_datamanager.h"
 #include "dsp/dsp_wavedata.h"
+#include "cmn/cmn_thread.h"
 
 namespace cst
 {
@@ -62,7 +90,12 @@ namespace cst
                 ///
                 /// @brief  Constructor
                 ///
-                CSynthesize(const CDataManager *pDataManager) : CModule(pDataManager) {}
+                CSynthesize(const CDataManager *pDataManager) : CModule(pDataManager), m_stopping(false) {}
+
+                ///
+                /// @brief  Destructor, stop the worker threads
+                ///
+                virtual ~CSynthesize();
 
             protected:
                 ///
@@ -82,6 +115,69 @@ namespace cst
                 ///
                 virtual int process(xml::CSSMLDocument *pSSMLDocument, dsp::CWaveData &waveData);
 
+                ///
+                /// @brief  The main processing procedure of the speech synthesis module, passing the wave data to sink incrementally
+                ///
+                /// The synthetic wave data is passed to the wave sink piece by piece as soon as it is generated,
+                /// at least once for each sentence. The whole wave data is also returned in waveData.
+                ///
+                /// @param  [in]  pSSMLDocument The input SSML document with unit selection and target prosodic information
+                /// @param  [out] waveData      Return the synthetic wave data with FORMAT set. All original data (if any) are to be CLEARed.
+                /// @param  [in]  waveSink      The wave sink to receive the synthetic wave data incrementally, NULL if not needed
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                /// @retval ERROR_OPERATION_ABORTED The operation is aborted by the wave sink
+                ///
+                virtual int process(xml::CSSMLDocument *pSSMLDocument, dsp::CWaveData &waveData, dsp::CWaveSink *waveSink);
+
+                ///
+                /// @brief  The main processing procedure of the speech synthesis module for typed utterance
+                ///
+                /// The synthetic duration, selected unit and phones (if known) are written back to the utterance.
+                ///
+                /// @param  [in]  utterance     The input utterance with syllable and target prosodic information
+                /// @param  [out] utterance     Return the utterance with synthetic duration information
+                /// @param  [out] waveData      Return the synthetic wave data with FORMAT set. All original data (if any) are to be CLEARed.
+                /// @param  [in]  waveSink      The wave sink to receive the synthetic wave data incrementally, NULL if not needed
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                /// @retval ERROR_OPERATION_ABORTED The operation is aborted by the wave sink
+                ///
+                virtual int process(CUtterance &utterance, dsp::CWaveData &waveData, dsp::CWaveSink *waveSink = NULL);
+
+                ///
+                /// @brief  The main processing procedure of the speech synthesis module with the settings of current request
+                ///
+                /// The above procedures use the default settings of the data manager.
+                ///
+                /// @param  [in]  pSSMLDocument The input SSML document with unit selection and target prosodic information
+                /// @param  [out] waveData      Return the synthetic wave data with FORMAT set. All original data (if any) are to be CLEARed.
+                /// @param  [in]  setting       The settings (e.g. rate, volume and pitch) of current request
+                /// @param  [in]  waveSink      The wave sink to receive the synthetic wave data incrementally, NULL if not needed
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                /// @retval ERROR_OPERATION_ABORTED The operation is aborted by the wave sink
+                ///
+                virtual int process(xml::CSSMLDocument *pSSMLDocument, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink = NULL);
+
+                ///
+                /// @brief  The main processing procedure of the speech synthesis module for typed utterance with the settings of current request
+                ///
+                /// @param  [in]  utterance     The input utterance with syllable and target prosodic information
+                /// @param  [out] utterance     Return the utterance with synthetic duration information
+                /// @param  [out] waveData      Return the synthetic wave data with FORMAT set. All original data (if any) are to be CLEARed.
+                /// @param  [in]  setting       The settings (e.g. rate, volume and pitch) of current request
+                /// @param  [in]  waveSink      The wave sink to receive the synthetic wave data incrementally, NULL if not needed
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                /// @retval ERROR_OPERATION_ABORTED The operation is aborted by the wave sink
+                ///
+                virtual int process(CUtterance &utterance, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink = NULL);
+
 
             protected:
                 //////////////////////////////////////////////////////////////////////////
@@ -114,6 +210,8 @@ namespace cst
                     float   rate;               ///< Duration modification ratio
                     float   volume;             ///< Amplitude (volume) modification ratio
                     float   pitch;              ///< Mean (average) pitch modification ratio
+                    // synthesis result
+                    std::vector<CUttPhone> phones;  ///< Phones of the unit with synthetic duration, set by the synthesizer if known
                 public:
                     CUnitItem() {clear();}      ///< Constructor
                     void clear();               ///< Clear the content
@@ -124,6 +222,12 @@ namespace cst
                 ///
                 class CSynthDocument : public CTTSDocument<CUnitItem>, public xml::CSSMLTraversal
                 {
+                public:
+                    ///
+                    /// @brief  Build internal document from the typed utterance
+                    ///
+                    int build(CUtterance &utterance);
+
                 protected:
                     ///
                     /// @brief  Process a specific SSML document node, to build the internal document
@@ -153,6 +257,11 @@ namespace cst
                     ///
                     int getBreakInfo(xml::CXMLElement *pBreakNode, CUnitItem &breakInfo) const;
 
+                    ///
+                    /// @brief  Append the break of typed utterance, and set the boundary type of the previous units
+                    ///
+                    void appendBreak(const CUttBreak &breakInfo);
+
                     ///
                     /// @brief  Set the boundary type for all units until one non-break unit
                     ///
@@ -178,6 +287,14 @@ namespace cst
                 ///
                 virtual int writeResult(xml::CSSMLDocument *pSSMLDocument, CSynthDocument &synthDocument);
 
+                ///
+                /// @brief  Write the result from internal result to the typed utterance
+                ///
+                /// @param  [in]  synthDocument     The internal results to be written
+                /// @param  [out] utterance         Return the utterance with speech synthesis result
+                ///
+                virtual int writeResult(CUtterance &utterance, CSynthDocument &synthDocument);
+
                 ///
                 /// @brief  Perform speech synthesis for the whole internal document
                 ///
@@ -186,11 +303,36 @@ namespace cst
                 ///
                 /// @param  [in]  synthDocument Internal document containing basic unit information to be synthesized
                 /// @param  [out] waveData      Return the synthetic wave data by APPENDing the new data
+                /// @param  [in]  setting       The settings of current request
+                /// @param  [in]  waveSink      The wave sink to receive the new wave data incrementally, NULL if not needed
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                ///
+                virtual int synthesize(CSynthDocument &synthDocument, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink = NULL);
+
+                ///
+                /// @brief  Perform speech synthesis for the whole internal document with several worker threads
+                ///
+                /// The sentences are posted as a job to the worker threads, which are started at the first
+                /// parallel synthesis and kept until the module is destroyed. The current thread and at most
+                /// (numWorkers - 1) workers synthesize the sentences by the per-sentence synthesize() procedure.
+                /// The wave data of the sentences are then APPENDed to waveData in the order of sentences,
+                /// same as the serial synthesis.
+                ///
+                /// @note   The per-sentence synthesize() procedure should be reentrant,
+                ///         i.e. it should not modify any data shared between sentences.
+                ///         The trace is not synchronized, so the sentences are synthesized without trace.
+                ///
+                /// @param  [in]  synthDocument Internal document containing basic unit information to be synthesized
+                /// @param  [out] waveData      Return the synthetic wave data by APPENDing the new data
+                /// @param  [in]  setting       The settings of current request
+                /// @param  [in]  numWorkers    Number of worker threads
                 ///
                 /// @return Whether operation is successful
                 /// @retval ERROR_SUCCESS The operation is successful
                 ///
-                virtual int synthesize(CSynthDocument &synthDocument, dsp::CWaveData &waveData);
+                virtual int synthesizeParallel(CSynthDocument &synthDocument, dsp::CWaveData &waveData, const TTSSetting &setting, int numWorkers);
 
                 ///
                 /// @brief  Perform speech synthesis for one sentence
@@ -203,8 +345,78 @@ namespace cst
                 ///
                 /// @param  [in]  sentenceInfo  Target basic unit information for a sentence to be synthesized
                 /// @param  [out] waveData      Return the synthetic wave data by APPENDing the new data
+                /// @param  [in]  setting       The settings of current request
+                /// @param  [in]  pTrace        The trace to record the steps of the sentence, NULL if not recorded
+                ///
+                virtual int synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData, const TTSSetting &setting, cmn::CTrace *pTrace);
+
+                ///
+                /// @brief  Perform speech synthesis for one sentence, passing the new wave data to sink incrementally
+                ///
+                /// The default implementation synthesizes the whole sentence by the above synthesize(),
+                /// and then passes the new wave data of the sentence to wave sink at once.
+                /// The derived class can override it to pass the wave data in smaller pieces.
+                ///
+                /// @param  [in]  sentenceInfo  Target basic unit information for a sentence to be synthesized
+                /// @param  [out] waveData      Return the synthetic wave data by APPENDing the new data
+                /// @param  [in]  setting       The settings of current request
+                /// @param  [in]  waveSink      The wave sink to receive the new wave data incrementally
+                /// @param  [in]  pTrace        The trace to record the steps of the sentence, NULL if not recorded
                 ///
-                virtual int synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData);
+                virtual int synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink &waveSink, cmn::CTrace *pTrace);
+
+            protected:
+                ///
+                /// @brief  The sentences to be synthesized by the worker threads
+                ///
+                /// All members except the sentences and the wave data are protected by the mutex of the module.
+                ///
+                class CSynthJob
+                {
+                public:
+                    const TTSSetting &setting;                      ///< The settings of current request
+                    std::vector<std::vector<CUnitItem>*> sentences; ///< The sentences to be synthesized
+                    std::vector<dsp::CWaveData> waveData;           ///< Synthetic wave data of each sentence
+                    size_t nextSentence;                            ///< Index of next sentence to be synthesized
+                    size_t numDone;                                 ///< Number of sentences synthesized
+                    int numHelpers;                                 ///< Number of worker threads working on the job
+                    int maxHelpers;                                 ///< Maximum number of worker threads working on the job
+                    cmn::CCondition finished;                       ///< Signaled when all sentences are synthesized
+                public:
+                    CSynthJob(const TTSSetting &set) : setting(set), nextSentence(0), numDone(0), numHelpers(0), maxHelpers(0) {}
+                };
+
+                ///
+                /// @brief  The persistent worker thread helping to synthesize the sentences of the posted jobs
+                ///
+                class CSynthWorker : public cmn::CThread
+                {
+                public:
+                    CSynthWorker(CSynthesize &owner) : synthesize(owner) {}
+                protected:
+                    virtual void run() {synthesize.serveJobs();}
+                protected:
+                    CSynthesize &synthesize;    ///< The synthesis module owning the worker
+                };
+
+                ///
+                /// @brief  Work on the posted jobs until the module is destroyed, called by the worker threads
+                ///
+                void serveJobs();
+
+                ///
+                /// @brief  Synthesize the remaining sentences of the job until all are taken
+                ///
+                /// @note   The mutex must be locked by the caller, and it is unlocked during synthesis.
+                ///
+                void workOn(CSynthJob &synthJob);
+
+            private:
+                std::vector<CSynthWorker*> m_workers;   ///< The persistent worker threads
+                std::deque<CSynthJob*> m_jobs;          ///< The posted jobs with sentences not yet taken
+                bool m_stopping;                        ///< Whether the worker threads are to be stopped
+                cmn::CMutex m_mutex;                    ///< Mutex for the workers and the jobs
+                cmn::CCondition m_jobPosted;            ///< Signaled when a job is posted or stopping
             };
 
         }//namespace base
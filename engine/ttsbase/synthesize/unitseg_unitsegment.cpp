@@ -28,6 +28,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/07/29
 ///   Changed:  Re-implemented using the new architecture with internal representation
+/// - Version:  0.3.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
 ///
 
 #include "unitseg_unitsegment.h"
@@ -58,6 +62,25 @@ namespace cst
                 return writeResult(pSSMLDocument, unitsegDocument);
             }
 
+            int CUnitSegment::process(CUtterance &utterance)
+            {
+                int retVal = ERROR_SUCCESS;
+                CUnitSegDocument unitsegDocument;
+
+                // retrieve data from typed utterance
+                retVal = unitsegDocument.build(utterance);
+                if (retVal != ERROR_SUCCESS)
+                    return retVal;
+
+                // process internal data for unit segmentation
+                retVal = convertToUnits(unitsegDocument);
+                if (retVal != ERROR_SUCCESS)
+                    return retVal;
+
+                // write result back to typed utterance
+                return writeResult(utterance, unitsegDocument);
+            }
+
 
             //////////////////////////////////////////////////////////////////////////
             //
@@ -71,6 +94,29 @@ namespace cst
                 wstrPhoneme.clear();
                 wstrText.clear();
                 pWordNode = NULL;
+                pUttWord  = NULL;
+            }
+
+            int CUnitSegment::CUnitSegDocument::build(CUtterance &utterance)
+            {
+                for (std::vector<CUttParagraph>::iterator pit = utterance.paragraphs.begin(); pit != utterance.paragraphs.end(); ++pit)
+                {
+                    appendParagraph();
+                    for (std::vector<CUttSentence>::iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+                    {
+                        appendSentence();
+                        for (std::vector<CUttWord>::iterator wit = sit->words.begin(); wit != sit->words.end(); ++wit)
+                        {
+                            CTextItem wordInfo;
+                            wordInfo.wstrText    = wit->wstrText;
+                            wordInfo.wstrPhoneme = wit->wstrPhoneme;
+                            wordInfo.wstrAlphabet= wit->wstrAlphabet;
+                            wordInfo.pUttWord    = &*wit;
+                            appendItem(wordInfo);
+                        }
+                    }
+                }
+                return ERROR_SUCCESS;
             }
 
             int CUnitSegment::CUnitSegDocument::processNode(xml::CXMLNode *pNode, bool &childProcessed)
@@ -78,17 +124,17 @@ namespace cst
                 childProcessed = false;
                 if (pNode->type() == xml::CXMLNode::XML_ELEMENT)
                 {
-                    if (pNode->value() == L"p")
+                    if (pNode->nameId() == xml::XML_NAME_P)
                     {
                         // paragraph
                         appendParagraph();
                     }
-                    else if (pNode->value() == L"s")
+                    else if (pNode->nameId() == xml::XML_NAME_S)
                     {
                         // sentence
                         appendSentence();
                     }
-                    else if (pNode->value() == L"w")
+                    else if (pNode->nameId() == xml::XML_NAME_W)
                     {
                         // word
                         // get text information under word
@@ -121,8 +167,8 @@ namespace cst
 
                 // get phoneme, text, boundary information
                 wordInfo.wstrText    = pText->value();
-                wordInfo.wstrPhoneme = pPhoneme->getAttribute(L"ph");
-                wordInfo.wstrAlphabet= pPhoneme->getAttribute(L"alphabet");
+                wordInfo.wstrPhoneme = pPhoneme->getAttribute(xml::XML_NAME_PH);
+                wordInfo.wstrAlphabet= pPhoneme->getAttribute(xml::XML_NAME_ALPHABET);
                 wordInfo.pWordNode   = pWordNode;
 
                 return ERROR_SUCCESS;
@@ -152,14 +198,14 @@ namespace cst
                         // word information
                         {
                             // create "phoneme" element
-                            xml::CXMLText *pText = new xml::CXMLText(textInfo.wstrText);
-                            xml::CXMLElement *pPhoneme = new xml::CXMLElement(L"phoneme");
-                            pPhoneme->setAttribute(L"alphabet", textInfo.wstrAlphabet);
-                            pPhoneme->setAttribute(L"ph", textInfo.wstrPhoneme);
+                            xml::CXMLText *pText = pSSMLDocument->createText(textInfo.wstrText);
+                            xml::CXMLElement *pPhoneme = pSSMLDocument->createElement(L"phoneme");
+                            pPhoneme->setAttribute(xml::XML_NAME_ALPHABET, textInfo.wstrAlphabet);
+                            pPhoneme->setAttribute(xml::XML_NAME_PH, textInfo.wstrPhoneme);
                             pPhoneme->linkLastChild(pText);
 
                             // create "unit" element
-                            xml::CXMLElement *pUnit = new xml::CXMLElement(L"unit");
+                            xml::CXMLElement *pUnit = pSSMLDocument->createElement(L"unit");
                             pUnit->linkLastChild(pPhoneme);
 
                             // remove original "phoneme" node
@@ -179,6 +225,38 @@ namespace cst
                 return ERROR_SUCCESS;
             }
 
+            int CUnitSegment::writeResult(CUtterance &utterance, CUnitSegDocument &unitDocument)
+            {
+                // the syllables of each word are rebuilt from the basic units,
+                // the word without any unit keeps its phoneme only
+
+                unitDocument.resetCursor();
+                for (std::vector<CUttParagraph>::iterator pit = utterance.paragraphs.begin(); pit != utterance.paragraphs.end(); ++pit)
+                {
+                    for (std::vector<CUttSentence>::iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+                    {
+                        const std::vector<CTextItem> *pSentence = unitDocument.getSentence();
+                        if (pSentence == NULL)
+                            return ERROR_INVALID_SSML_DOCUMENT;
+
+                        for (std::vector<CUttWord>::iterator wit = sit->words.begin(); wit != sit->words.end(); ++wit)
+                        {
+                            wit->syllables.clear();
+                        }
+                        for (std::vector<CTextItem>::const_iterator it = pSentence->begin(); it != pSentence->end(); it++)
+                        {
+                            CUttSyllable syllable;
+                            syllable.wstrText    = it->wstrText;
+                            syllable.wstrPhoneme = it->wstrPhoneme;
+                            it->pUttWord->syllables.push_back(syllable);
+                        }
+                    }
+                }
+                utterance.stage = CUtterance::STAGE_UNIT;
+
+                return ERROR_SUCCESS;
+            }
+
             int CUnitSegment::convertToUnits(CUnitSegDocument &unitDocument)
             {
                 int retVal = ERROR_SUCCESS;
@@ -221,6 +299,7 @@ namespace cst
                         unitItem.wstrPhoneme = unitPhonemes[i];
                         unitItem.wstrAlphabet= textInfo.wstrAlphabet;
                         unitItem.pWordNode   = textInfo.pWordNode;
+                        unitItem.pUttWord    = textInfo.pUttWord;
                         newSentence.push_back(unitItem);
                     }
                 }
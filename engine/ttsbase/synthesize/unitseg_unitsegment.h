@@ -28,6 +28,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/07/29
 ///   Changed:  Re-implemented using the new architecture with internal representation
+/// - Version:  0.3.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
 ///
 
 #ifndef _CST_TTS_BASE_UNITSEG_UNITSEGMENT_H_
@@ -37,6 +41,7 @@
 #include "xml/ssml_traversal.h"
 #include "../datamanage/base_module.h"
 #include "../datamanage/base_ttsdocument.h"
+#include "../datamanage/base_utterance.h"
 
 namespace cst
 {
@@ -70,6 +75,17 @@ namespace cst
                 ///
                 virtual int process(xml::CSSMLDocument * pSSMLDocument);
 
+                ///
+                /// @brief  The main processing procedure of the unit segmentation module for typed utterance
+                ///
+                /// @param  [in]  utterance  The input utterance with word and pronunciation information
+                /// @param  [out] utterance  Return the utterance with syllables of each word
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                ///
+                virtual int process(CUtterance &utterance);
+
 
             protected:
                 //////////////////////////////////////////////////////////////////////////
@@ -86,6 +102,7 @@ namespace cst
                 public:
                     // content
                     xml::CXMLElement *pWordNode;///< "w" element in SSML document
+                    CUttWord *pUttWord;         ///< Word in typed utterance, instead of pWordNode
                     std::wstring  wstrText;     ///< Text piece content
                     std::wstring  wstrPhoneme;  ///< Phoneme (pronunciation) of the text
                     std::wstring  wstrAlphabet; ///< Phoneme alphabet
@@ -99,6 +116,12 @@ namespace cst
                 ///
                 class CUnitSegDocument : public CTTSDocument<CTextItem>, public xml::CSSMLTraversal
                 {
+                public:
+                    ///
+                    /// @brief  Build internal document from the typed utterance
+                    ///
+                    int build(CUtterance &utterance);
+
                 protected:
                     ///
                     /// @brief  Process a specific SSML document node, to build the internal document
@@ -133,6 +156,14 @@ namespace cst
                 ///
                 virtual int writeResult(xml::CSSMLDocument *pSSMLDocument, CUnitSegDocument &unitDocument);
 
+                ///
+                /// @brief  Write the result from internal result to the typed utterance
+                ///
+                /// @param  [in]  unitDocument      The internal results to be written
+                /// @param  [out] utterance         Return the utterance with basic unit result
+                ///
+                virtual int writeResult(CUtterance &utterance, CUnitSegDocument &unitDocument);
+
                 ///
                 /// @brief  Convert the input text items to basic units for the whole internal document
                 ///
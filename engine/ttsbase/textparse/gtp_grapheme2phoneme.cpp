@@ -28,6 +28,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/05/28
 ///   Changed:  Converted SSML document to internal representation for processing
+/// - Version:  0.3.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
 ///
 
 #include "gtp_grapheme2phoneme.h"
@@ -44,17 +48,17 @@ namespace cst
                 childProcessed = false;
                 if (pNode->type() == xml::CXMLNode::XML_ELEMENT)
                 {
-                    if (pNode->value() == L"p")
+                    if (pNode->nameId() == xml::XML_NAME_P)
                     {
                         // paragraph
                         appendParagraph();
                     }
-                    else if (pNode->value() == L"s")
+                    else if (pNode->nameId() == xml::XML_NAME_S)
                     {
                         // sentence
                         appendSentence();
                     }
-                    else if (pNode->value() == L"w")
+                    else if (pNode->nameId() == xml::XML_NAME_W)
                     {
                         // word
                         CWordItem wordItem;
@@ -74,7 +78,7 @@ namespace cst
 
                 wordItem.pWordNode = pWord;
                 wordItem.bFixed    = false;
-                wordItem.wstrPOS   = pWord->getAttribute(L"role");
+                wordItem.wstrPOS   = pWord->getAttribute(xml::XML_NAME_ROLE);
 
                 xml::CXMLNode *pChild = pWord->firstChild();
                 if (pChild == NULL || pChild->nextSibling() != NULL)
@@ -83,12 +87,12 @@ namespace cst
                     return ERROR_INVALID_SSML_DOCUMENT;
                 }
 
-                if (pChild->type() == xml::CXMLNode::XML_ELEMENT && pChild->value() == L"phoneme")
+                if (pChild->type() == xml::CXMLNode::XML_ELEMENT && pChild->nameId() == xml::XML_NAME_PHONEME)
                 {
                     // under "phoneme"
                     xml::CXMLElement *pPhoneme = (xml::CXMLElement*)pChild;
-                    wordItem.wstrAlphabet = pPhoneme->getAttribute(L"alphabet");
-                    wordItem.wstrPhoneme  = pPhoneme->getAttribute(L"ph");
+                    wordItem.wstrAlphabet = pPhoneme->getAttribute(xml::XML_NAME_ALPHABET);
+                    wordItem.wstrPhoneme  = pPhoneme->getAttribute(xml::XML_NAME_PH);
                     wordItem.bFixed       = true;
 
                     // advance to text
@@ -109,6 +113,32 @@ namespace cst
                 return ERROR_SUCCESS;
             }
 
+            int CGrapheme2Phoneme::CG2PDocument::build(CUtterance &utterance)
+            {
+                for (std::vector<CUttParagraph>::iterator pit = utterance.paragraphs.begin(); pit != utterance.paragraphs.end(); ++pit)
+                {
+                    appendParagraph();
+                    for (std::vector<CUttSentence>::iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+                    {
+                        appendSentence();
+                        for (std::vector<CUttWord>::const_iterator wit = sit->words.begin(); wit != sit->words.end(); ++wit)
+                        {
+                            CWordItem wordItem;
+                            wordItem.wstrWord = wit->wstrText;
+                            wordItem.wstrPOS  = wit->wstrPOS;
+                            wordItem.bFixed   = wit->isPhonemeFixed;
+                            if (wordItem.bFixed)
+                            {
+                                wordItem.wstrAlphabet = wit->wstrAlphabet;
+                                wordItem.wstrPhoneme  = wit->wstrPhoneme;
+                            }
+                            appendItem(wordItem);
+                        }
+                    }
+                }
+                return ERROR_SUCCESS;
+            }
+
             int CGrapheme2Phoneme::process(xml::CSSMLDocument *pSSMLDocument)
             {
                 CG2PDocument g2pDocument;
@@ -148,9 +178,9 @@ namespace cst
                         }
 
                         // create new "phoneme" as the child of "w"
-                        xml::CXMLElement *pPhoneme = new xml::CXMLElement(L"phoneme");
-                        pPhoneme->setAttribute(L"alphabet", wordItem.wstrAlphabet);
-                        pPhoneme->setAttribute(L"ph", wordItem.wstrPhoneme);
+                        xml::CXMLElement *pPhoneme = pSSMLDocument->createElement(L"phoneme");
+                        pPhoneme->setAttribute(xml::XML_NAME_ALPHABET, wordItem.wstrAlphabet);
+                        pPhoneme->setAttribute(xml::XML_NAME_PH, wordItem.wstrPhoneme);
 
                         xml::CXMLNode *pText = wordItem.pWordNode->firstChild();
                         pText->insertBefore(pPhoneme);
@@ -162,6 +192,50 @@ namespace cst
                 return ERROR_SUCCESS;
             }
 
+            int CGrapheme2Phoneme::process(CUtterance &utterance)
+            {
+                CG2PDocument g2pDocument;
+
+                // retrieve data from typed utterance
+                g2pDocument.build(utterance);
+
+                // process internal data
+                getPhoneme(g2pDocument);
+
+                // write result back to typed utterance
+                writeResult(utterance, g2pDocument);
+
+                return ERROR_SUCCESS;
+            }
+
+            int CGrapheme2Phoneme::writeResult(CUtterance &utterance, CG2PDocument &g2pDocument)
+            {
+                // write the non-fixed phoneme to word directly
+
+                g2pDocument.resetCursor();
+                for (std::vector<CUttParagraph>::iterator pit = utterance.paragraphs.begin(); pit != utterance.paragraphs.end(); ++pit)
+                {
+                    for (std::vector<CUttSentence>::iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+                    {
+                        const std::vector<CWordItem> *pSentence = g2pDocument.getSentence();
+                        if (pSentence == NULL || pSentence->size() != sit->words.size())
+                            return ERROR_INVALID_SSML_DOCUMENT;
+
+                        for (size_t i = 0; i < pSentence->size(); i++)
+                        {
+                            const CWordItem &wordItem = (*pSentence)[i];
+                            if (wordItem.bFixed)
+                                continue;
+                            sit->words[i].wstrAlphabet = wordItem.wstrAlphabet;
+                            sit->words[i].wstrPhoneme  = wordItem.wstrPhoneme;
+                        }
+                    }
+                }
+                utterance.stage = CUtterance::STAGE_PHONEME;
+
+                return ERROR_SUCCESS;
+            }
+
             int CGrapheme2Phoneme::getPhoneme(CG2PDocument &g2pDocument)
             {
                 // get the phoneme for every non-fixed word item
@@ -28,6 +28,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/05/28
 ///   Changed:  Converted SSML document to internal representation for processing
+/// - Version:  0.3.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
 ///
 
 #ifndef _CST_TTS_BASE_GTP_GRAPHEME2PHONEME_H_
@@ -37,6 +41,7 @@
 #include "xml/ssml_traversal.h"
 #include "../datamanage/base_module.h"
 #include "../datamanage/base_ttsdocument.h"
+#include "../datamanage/base_utterance.h"
 #include "../datatext/data_textdata.h"
 
 namespace cst
@@ -77,6 +82,17 @@ namespace cst
                 ///
                 virtual int process(xml::CSSMLDocument *pSSMLDocument);
 
+                ///
+                /// @brief  The main processing procedure for grapheme to phoneme conversion of typed utterance
+                ///
+                /// @param  [in]  utterance  The input utterance with words
+                /// @param  [out] utterance  Return the utterance with phoneme of each word
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                ///
+                virtual int process(CUtterance &utterance);
+
 
             protected:
                 //////////////////////////////////////////////////////////////////////////
@@ -105,6 +121,12 @@ namespace cst
                 ///
                 class CG2PDocument : public CTTSDocument<CWordItem>, public xml::CSSMLTraversal
                 {
+                public:
+                    ///
+                    /// @brief  Build internal document from the typed utterance
+                    ///
+                    int build(CUtterance &utterance);
+
                 protected:
                     ///
                     /// @brief  Process a specific SSML document node, 
@@ -158,6 +180,14 @@ namespace cst
                 /// @param  [out] pSSMLDocument Return the SSML document with phoneme result
                 ///
                 virtual int writeResult(xml::CSSMLDocument *pSSMLDocument, CG2PDocument &g2pDocument);
+
+                ///
+                /// @brief  Write the result from internal result to the typed utterance
+                ///
+                /// @param  [in]  g2pDocument   The internal results to be written
+                /// @param  [out] utterance     Return the utterance with phoneme result
+                ///
+                virtual int writeResult(CUtterance &utterance, CG2PDocument &g2pDocument);
             };
 
         }//namespace base
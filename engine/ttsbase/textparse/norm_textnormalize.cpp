@@ -76,17 +76,17 @@ namespace cst
                 }
                 if (pNode->type() == xml::CXMLNode::XML_ELEMENT)
                 {
-                    if (pNode->value() == L"p")
+                    if (pNode->nameId() == xml::XML_NAME_P)
                     {
                         // paragraph
                         appendParagraph();
                     }
-                    else if (pNode->value() == L"s")
+                    else if (pNode->nameId() == xml::XML_NAME_S)
                     {
                         // sentence
                         appendSentence();
                     }
-                    else if (pNode->value() == L"say-as")
+                    else if (pNode->nameId() == xml::XML_NAME_SAY_AS)
                     {
                         // say-as
                         xml::CXMLNode *pText = pNode->firstChild(xml::CXMLNode::XML_TEXT);
@@ -131,9 +131,9 @@ namespace cst
                         // store the normalized result
 
                         // create "sub" element
-                        xml::CXMLText *pText = new xml::CXMLText(it->wstrText);
-                        xml::CXMLElement *pSub = new xml::CXMLElement(L"sub");
-                        pSub->setAttribute(L"alias", it->wstrNormWord);
+                        xml::CXMLText *pText = pSSMLDocument->createText(it->wstrText);
+                        xml::CXMLElement *pSub = pSSMLDocument->createElement(L"sub");
+                        pSub->setAttribute(xml::XML_NAME_ALIAS, it->wstrNormWord);
                         pSub->linkLastChild(pText);
 
                         // insert before current "say-as" element
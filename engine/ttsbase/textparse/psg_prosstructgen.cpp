@@ -36,11 +36,21 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2009/07/20
 ///   Changed:  The original user specific boundary type (i.e. bFixed is true) should be kept unchanged
+/// - Version:  0.3.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
+/// - Version:  0.3.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Predicted the prosodic boundaries by the phrasing tree
 ///
 
 #include "psg_prosstructgen.h"
 #include "cmn/cmn_error.h"
 #include "xml/ssml_helper.h"
+#include "utils/utl_string.h"
+#include "../datatext/data_textdata.h"
 
 namespace cst
 {
@@ -48,6 +58,24 @@ namespace cst
     {
         namespace base
         {
+            // maximum number (exclusive) of the numeric features matched by "is" questions
+            static const int MAX_NUMBER_SYMBOL = 1024;
+
+            const wchar_t *CProsodicStructGenerate::m_phrasingFeatureNames[PHRASEFEAT_MAX] =
+            {
+                L"pos",
+                L"prev_pos",
+                L"next_pos",
+                L"length",
+                L"prev_length",
+                L"next_length",
+                L"position",
+                L"words_to_end",
+                L"chars_from_phrase",
+                L"chars_to_end",
+                L"prev_boundary"
+            };
+
             int CProsodicStructGenerate::CPSGDocument::processNode(xml::CXMLNode *pNode, bool &childProcessed)
             {
                 childProcessed = false;
@@ -62,26 +90,26 @@ namespace cst
                 }
                 else if (pNode->type() == xml::CXMLNode::XML_ELEMENT)
                 {
-                    if (pNode->value() == L"p")
+                    if (pNode->nameId() == xml::XML_NAME_P)
                     {
                         // paragraph
                         appendParagraph();
                     }
-                    else if (pNode->value() == L"s")
+                    else if (pNode->nameId() == xml::XML_NAME_S)
                     {
                         // sentence
                         appendSentence();
                     }
-                    else if (pNode->value() == L"w")
+                    else if (pNode->nameId() == xml::XML_NAME_W)
                     {
                         // word
                         m_tmpItem.pWordNode = pNode;
-                        m_tmpItem.wstrPOS   = ((xml::CXMLElement*)pNode)->getAttribute(L"role");
+                        m_tmpItem.wstrPOS   = ((xml::CXMLElement*)pNode)->getAttribute(xml::XML_NAME_ROLE);
 
                         // only "break" after word is considered
                         // get the boundary type
                     }
-                    else if (pNode->value() == L"break")
+                    else if (pNode->nameId() == xml::XML_NAME_BREAK)
                     {
                         // break
                         // set the boundary information of the previous word
@@ -105,6 +133,39 @@ namespace cst
             }
 
 
+            int CProsodicStructGenerate::CPSGDocument::build(CUtterance &utterance)
+            {
+                for (std::vector<CUttParagraph>::iterator pit = utterance.paragraphs.begin(); pit != utterance.paragraphs.end(); ++pit)
+                {
+                    appendParagraph();
+                    for (std::vector<CUttSentence>::iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+                    {
+                        appendSentence();
+                        for (std::vector<CUttWord>::const_iterator wit = sit->words.begin(); wit != sit->words.end(); ++wit)
+                        {
+                            CWordItem wordItem;
+                            wordItem.wstrText = wit->wstrText;
+                            wordItem.wstrPOS  = wit->wstrPOS;
+                            wordItem.bBOS     = (wit == sit->words.begin());
+                            if (wit->breakAfter.exists)
+                            {
+                                // the boundary information of the break after word
+                                switch (wit->breakAfter.boundaryType)
+                                {
+                                case xml::CSSMLDocument::PROSBOUND_PWORD:    wordItem.nBoundaryType = PROSBOUNDTYPE_PWORD;    break;
+                                case xml::CSSMLDocument::PROSBOUND_PPHRASE:  wordItem.nBoundaryType = PROSBOUNDTYPE_PPHRASE;  break;
+                                case xml::CSSMLDocument::PROSBOUND_SENTENCE: wordItem.nBoundaryType = PROSBOUNDTYPE_SENTENCE; break;
+                                default:                                     wordItem.nBoundaryType = PROSBOUNDTYPE_SYLLABLE; break;
+                                }
+                                wordItem.bFixed = true;
+                            }
+                            appendItem(wordItem);
+                        }
+                    }
+                }
+                return ERROR_SUCCESS;
+            }
+
             int CProsodicStructGenerate::process(xml::CSSMLDocument * pSSMLDocument)
             {
                 CPSGDocument  psgDocument;
@@ -121,6 +182,71 @@ namespace cst
                 return ERROR_SUCCESS;
             }
 
+            int CProsodicStructGenerate::process(CUtterance &utterance)
+            {
+                CPSGDocument  psgDocument;
+
+                // retrieve data from typed utterance
+                psgDocument.build(utterance);
+
+                // process internal data for prosodic structure generation
+                generateProsodicStructure(psgDocument);
+
+                // write result back to typed utterance
+                writeResult(utterance, psgDocument);
+
+                return ERROR_SUCCESS;
+            }
+
+            int CProsodicStructGenerate::writeResult(CUtterance &utterance, CPSGDocument &psgDocument)
+            {
+                // set the breaks of the words, same as the "break" elements written to SSML document
+
+                psgDocument.resetCursor();
+                for (std::vector<CUttParagraph>::iterator pit = utterance.paragraphs.begin(); pit != utterance.paragraphs.end(); ++pit)
+                {
+                    for (std::vector<CUttSentence>::iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+                    {
+                        const std::vector<CWordItem> *pSentence = psgDocument.getSentence();
+                        if (pSentence == NULL || pSentence->size() != sit->words.size())
+                            return ERROR_INVALID_SSML_DOCUMENT;
+
+                        for (size_t i = 0; i < pSentence->size(); i++)
+                        {
+                            const CWordItem &wordItem = (*pSentence)[i];
+                            CUttWord &word = sit->words[i];
+
+                            if (wordItem.bBOS)
+                            {
+                                // break before BOS
+                                sit->breakBefore.exists = true;
+                                sit->breakBefore.boundaryType = xml::CSSMLDocument::PROSBOUND_SENTENCE;
+                            }
+
+                            if (wordItem.nBoundaryType == PROSBOUNDTYPE_SYLLABLE)
+                            {
+                                // none boundary (syllable / lexicon word)
+                                continue;
+                            }
+
+                            // set the break information
+                            int boundaryType = xml::CSSMLDocument::PROSBOUND_PPHRASE;
+                            switch (wordItem.nBoundaryType)
+                            {
+                            case PROSBOUNDTYPE_PWORD:    boundaryType = xml::CSSMLDocument::PROSBOUND_PWORD;     break;
+                            case PROSBOUNDTYPE_PPHRASE:  boundaryType = xml::CSSMLDocument::PROSBOUND_PPHRASE;   break;
+                            case PROSBOUNDTYPE_SENTENCE: boundaryType = xml::CSSMLDocument::PROSBOUND_SENTENCE;  break;
+                            }
+                            word.breakAfter.exists = true;
+                            word.breakAfter.boundaryType = boundaryType;
+                        }
+                    }
+                }
+                utterance.stage = CUtterance::STAGE_PROSSTRUCT;
+
+                return ERROR_SUCCESS;
+            }
+
             int CProsodicStructGenerate::writeResult(xml::CSSMLDocument *pSSMLDocument, CPSGDocument &psgDocument)
             {
                 // write "break" to the document
@@ -146,12 +272,12 @@ namespace cst
                             if (pBreak == NULL || pBreak != wordItem.pWordNode->prevSibling())
                             {
                                 // "break" should be the immediate sibling of "w"
-                                pBreak = new xml::CXMLElement(L"break");
+                                pBreak = pSSMLDocument->createElement(L"break");
                                 wordItem.pWordNode->insertBefore(pBreak);
                             }
                             xml::CSSMLHelper::setBoundaryType(pBreak, xml::CSSMLDocument::PROSBOUND_SENTENCE);
                             // remove continuous "break" element
-                            for (xml::CXMLNode *pNode = pBreak->prevSibling(); pNode != NULL && pNode->isCertainElement(L"break");)
+                            for (xml::CXMLNode *pNode = pBreak->prevSibling(); pNode != NULL && pNode->nameId() == xml::XML_NAME_BREAK;)
                             {
                                 xml::CXMLNode *pBrkNode = pNode;
                                 pNode = pNode->prevSibling();
@@ -170,7 +296,7 @@ namespace cst
                         if (pBreak == NULL || pBreak != wordItem.pWordNode->nextSibling())
                         {
                             // "break" should be the immediate sibling of "w"
-                            pBreak = new xml::CXMLElement(L"break");
+                            pBreak = pSSMLDocument->createElement(L"break");
                             wordItem.pWordNode->insertAfter(pBreak);
                         }
 
@@ -185,7 +311,7 @@ namespace cst
                         }
                         xml::CSSMLHelper::setBoundaryType(pBreak, boundaryType);
                         // remove continuous "break" element
-                        for (xml::CXMLNode *pNode = pBreak->nextSibling(); pNode != NULL && pNode->isCertainElement(L"break");)
+                        for (xml::CXMLNode *pNode = pBreak->nextSibling(); pNode != NULL && pNode->nameId() == xml::XML_NAME_BREAK;)
                         {
                             xml::CXMLNode *pBrkNode = pNode;
                             pNode = pNode->nextSibling();
@@ -216,9 +342,118 @@ namespace cst
 
             int CProsodicStructGenerate::generateProsodicStructure(std::vector<CWordItem> &sentenceInfo)
             {
+                // only the given boundaries are kept without the phrasing tree
+                const CTextData *pTextData = getDataManager<CTextData>();
+                const Wagon::CCompiledWagonTree *pTree = (pTextData != NULL) ? pTextData->getPhrasingTree() : NULL;
+                if (pTree == NULL || sentenceInfo.empty())
+                    return ERROR_SUCCESS;
+                if (pTree != m_pPhrasingTree)
+                    resolvePhrasingTree(pTree);
+
+                // POS symbols and number of characters of the sentence
+                size_t numWords = sentenceInfo.size();
+                size_t charsToEnd = 0;
+                m_posSymbols.resize(numWords);
+                for (size_t i = 0; i < numWords; i++)
+                {
+                    m_posSymbols[i] = pTree->getSymbolID(sentenceInfo[i].wstrPOS);
+                    charsToEnd += sentenceInfo[i].wstrText.length();
+                }
+
+                // predict the boundary after each word from left to right,
+                // the boundary after the last word is decided by the sentence
+                size_t charsFromPhrase = 0;
+                size_t prevLength = 0;
+                int prevBoundary = PROSBOUNDTYPE_SENTENCE;
+                for (size_t i = 0; i < numWords; i++)
+                {
+                    CWordItem &wordItem = sentenceInfo[i];
+                    size_t length = wordItem.wstrText.length();
+                    charsFromPhrase += length;
+                    charsToEnd      -= length;
+
+                    if (!wordItem.bFixed && i + 1 < numWords)
+                    {
+                        setPhrasingFeature(PHRASEFEAT_POS,               m_posSymbols[i]);
+                        setPhrasingFeature(PHRASEFEAT_PREV_POS,          (i > 0) ? m_posSymbols[i-1] : m_bosSymbol);
+                        setPhrasingFeature(PHRASEFEAT_NEXT_POS,          m_posSymbols[i+1]);
+                        setPhrasingFeature(PHRASEFEAT_LENGTH,            length);
+                        setPhrasingFeature(PHRASEFEAT_PREV_LENGTH,       prevLength);
+                        setPhrasingFeature(PHRASEFEAT_NEXT_LENGTH,       sentenceInfo[i+1].wstrText.length());
+                        setPhrasingFeature(PHRASEFEAT_POSITION,          i);
+                        setPhrasingFeature(PHRASEFEAT_WORDS_TO_END,      numWords - 1 - i);
+                        setPhrasingFeature(PHRASEFEAT_CHARS_FROM_PHRASE, charsFromPhrase);
+                        setPhrasingFeature(PHRASEFEAT_CHARS_TO_END,      charsToEnd);
+                        setPhrasingFeature(PHRASEFEAT_PREV_BOUNDARY,     (size_t)prevBoundary);
+
+                        int leaf = pTree->predictLeaf(m_phrasingFeatures.empty() ? NULL : &m_phrasingFeatures[0]);
+                        wordItem.nBoundaryType = m_valueBoundaries[pTree->getMostProbValue(leaf)];
+                    }
+
+                    if (wordItem.nBoundaryType >= PROSBOUNDTYPE_PPHRASE)
+                        charsFromPhrase = 0;
+                    prevBoundary = wordItem.nBoundaryType;
+                    prevLength   = length;
+                }
+
                 return ERROR_SUCCESS;
             }
 
+            void CProsodicStructGenerate::resolvePhrasingTree(const Wagon::CCompiledWagonTree *pTree)
+            {
+                m_pPhrasingTree = pTree;
+                for (int i = 0; i < PHRASEFEAT_MAX; i++)
+                    m_phrasingFeatureIDs[i] = pTree->getFeatureID(m_phrasingFeatureNames[i]);
+                m_bosSymbol = pTree->getSymbolID(L"<s>");
+
+                // the features not known by this module are always missing
+                m_phrasingFeatures.assign(pTree->getFeatureNumber(), Wagon::CCompiledWagonTree::CFeatureValue());
+
+                // symbols of the decimal strings of the numbers asked by "is" questions
+                m_numberSymbols.clear();
+                for (int number = 0; number < MAX_NUMBER_SYMBOL; number++)
+                {
+                    int symbol = pTree->getSymbolID(str::format(L"%d", number));
+                    if (symbol != Wagon::CCompiledWagonTree::SYMBOL_UNKNOWN)
+                    {
+                        m_numberSymbols.resize(number + 1, Wagon::CCompiledWagonTree::SYMBOL_UNKNOWN);
+                        m_numberSymbols[number] = symbol;
+                    }
+                }
+
+                // boundary types of the values, the sentence boundary is decided by the sentence only
+                m_valueBoundaries.resize(pTree->getValueNumber());
+                for (size_t i = 0; i < m_valueBoundaries.size(); i++)
+                {
+                    int boundaryType = (int)wcstol(pTree->getValue((int)i).c_str(), NULL, 10);
+                    if (boundaryType < PROSBOUNDTYPE_SYLLABLE)
+                        boundaryType = PROSBOUNDTYPE_SYLLABLE;
+                    if (boundaryType > PROSBOUNDTYPE_PPHRASE)
+                        boundaryType = PROSBOUNDTYPE_PPHRASE;
+                    m_valueBoundaries[i] = boundaryType;
+                }
+            }
+
+            void CProsodicStructGenerate::setPhrasingFeature(int feature, int symbol)
+            {
+                int featureID = m_phrasingFeatureIDs[feature];
+                if (featureID != Wagon::CCompiledWagonTree::INVALID_ID)
+                {
+                    m_phrasingFeatures[featureID].symbol = symbol;
+                    m_phrasingFeatures[featureID].number = 0;
+                }
+            }
+
+            void CProsodicStructGenerate::setPhrasingFeature(int feature, size_t number)
+            {
+                int featureID = m_phrasingFeatureIDs[feature];
+                if (featureID != Wagon::CCompiledWagonTree::INVALID_ID)
+                {
+                    m_phrasingFeatures[featureID].symbol = (number < m_numberSymbols.size()) ? m_numberSymbols[number] : Wagon::CCompiledWagonTree::SYMBOL_UNKNOWN;
+                    m_phrasingFeatures[featureID].number = (float)number;
+                }
+            }
+
         }//namespace base
     }
 }
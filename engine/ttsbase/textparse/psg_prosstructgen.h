@@ -36,6 +36,14 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2009/07/20
 ///   Changed:  Add the "bFixed" flag to indicate the original user specific boundary type.
+/// - Version:  0.3.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
+/// - Version:  0.3.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Predicted the prosodic boundaries by the phrasing tree
 ///
 
 #ifndef _CST_TTS_BASE_PSG_PROSSTRUCTGEN_H_
@@ -43,8 +51,10 @@
 
 #include "xml/ssml_document.h"
 #include "xml/ssml_traversal.h"
+#include "utils/utl_wagontree.h"
 #include "../datamanage/base_module.h"
 #include "../datamanage/base_ttsdocument.h"
+#include "../datamanage/base_utterance.h"
 #include "../datamanage/data_datamanager.h"
 
 namespace cst
@@ -66,13 +76,20 @@ namespace cst
             /// This module is to generate both prosodic word boundary and prosodic phrase boundary by 
             /// inserting appropriate "<break>" elements.
             ///
+            /// The boundaries are predicted by the phrasing tree of the text data (CTextData::getPhrasingTree)
+            /// if it is available, otherwise only the boundaries given in the input are kept. The tree is asked
+            /// once for the boundary after each word (except the last word of the sentence) whose boundary is not
+            /// given, from left to right, with the features named in m_phrasingFeatureNames. The numeric features
+            /// can also be asked as decimal strings by "is" questions. The most probable value of the leaf is the
+            /// boundary type, 0: none/syllable, 1: prosodic word, 2: prosodic phrase.
+            ///
             class CProsodicStructGenerate : public CModule
             {
             public:
                 ///
                 /// @brief  Constructor
                 ///
-                CProsodicStructGenerate(const CDataManager *pDataManager) : CModule(pDataManager) {}
+                CProsodicStructGenerate(const CDataManager *pDataManager) : CModule(pDataManager), m_pPhrasingTree(NULL) {}
 
             public:
                 ///
@@ -86,6 +103,17 @@ namespace cst
                 ///
                 virtual int process(xml::CSSMLDocument * pSSMLDocument);
 
+                ///
+                /// @brief  The main processing procedure of the prosodic structure generation for typed utterance
+                ///
+                /// @param  [in]  utterance  The input utterance with words
+                /// @param  [out] utterance  Return the utterance with breaks of prosodic structure
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                ///
+                virtual int process(CUtterance &utterance);
+
             protected:
                 //////////////////////////////////////////////////////////////////////////
                 //
@@ -126,6 +154,12 @@ namespace cst
                 ///
                 class CPSGDocument : public CTTSDocument<CWordItem>, public xml::CSSMLTraversal
                 {
+                public:
+                    ///
+                    /// @brief  Build internal document from the typed utterance
+                    ///
+                    int build(CUtterance &utterance);
+
                 protected:
                     ///
                     /// @brief  Process SSML document node, for building internal document by SSML traversing
@@ -157,6 +191,23 @@ namespace cst
                 ///
                 virtual int generateProsodicStructure(std::vector<CWordItem> &sentenceInfo);
 
+                ///
+                /// @brief  Resolve the feature IDs and the boundary types of the leaves of the phrasing tree
+                ///
+                /// @param  [in]  pTree     The phrasing tree, whose feature IDs are kept until another tree is given
+                ///
+                void resolvePhrasingTree(const Wagon::CCompiledWagonTree *pTree);
+
+                ///
+                /// @brief  Set the categorical feature of the feature vector for the phrasing tree
+                ///
+                void setPhrasingFeature(int feature, int symbol);
+
+                ///
+                /// @brief  Set the numeric feature of the feature vector for the phrasing tree
+                ///
+                void setPhrasingFeature(int feature, size_t number);
+
                 ///
                 /// @brief  Write the result from internal result to the SSML document
                 ///
@@ -164,6 +215,52 @@ namespace cst
                 /// @param  [out] pSSMLDocument Return the SSML document with prosodic structure information
                 ///
                 virtual int writeResult(xml::CSSMLDocument *pSSMLDocument, CPSGDocument &psgDocument);
+
+                ///
+                /// @brief  Write the result from internal result to the typed utterance
+                ///
+                /// @param  [in]  psgDocument   The internal results to be written
+                /// @param  [out] utterance     Return the utterance with prosodic structure information
+                ///
+                virtual int writeResult(CUtterance &utterance, CPSGDocument &psgDocument);
+
+            protected:
+                ///
+                /// @brief  Definition for the features asked by the phrasing tree for the boundary after a word
+                ///
+                enum EPhrasingFeature
+                {
+                    PHRASEFEAT_POS = 0,             ///< POS of the word
+                    PHRASEFEAT_PREV_POS,            ///< POS of the previous word, "<s>" for the first word
+                    PHRASEFEAT_NEXT_POS,            ///< POS of the next word
+                    PHRASEFEAT_LENGTH,              ///< Number of characters of the word
+                    PHRASEFEAT_PREV_LENGTH,         ///< Number of characters of the previous word, 0 for the first word
+                    PHRASEFEAT_NEXT_LENGTH,         ///< Number of characters of the next word
+                    PHRASEFEAT_POSITION,            ///< Number of words before the word in the sentence
+                    PHRASEFEAT_WORDS_TO_END,        ///< Number of words after the word in the sentence
+                    PHRASEFEAT_CHARS_FROM_PHRASE,   ///< Number of characters from the last prosodic phrase boundary to the end of the word
+                    PHRASEFEAT_CHARS_TO_END,        ///< Number of characters after the word in the sentence
+                    PHRASEFEAT_PREV_BOUNDARY,       ///< Boundary type after the previous word, 3 for the first word
+                    PHRASEFEAT_MAX,
+                };
+
+                /// Names of the features asked by the phrasing tree
+                static const wchar_t *m_phrasingFeatureNames[PHRASEFEAT_MAX];
+
+                /// The phrasing tree whose feature IDs are resolved
+                const Wagon::CCompiledWagonTree *m_pPhrasingTree;
+                /// Feature ID in the phrasing tree of each feature, INVALID_ID if the feature is not asked
+                int m_phrasingFeatureIDs[PHRASEFEAT_MAX];
+                /// Symbol ID of "<s>" in the phrasing tree
+                int m_bosSymbol;
+                /// Symbol ID of the decimal string of each number, for "is" questions on the numeric features
+                std::vector<int> m_numberSymbols;
+                /// Boundary type of each value of the phrasing tree
+                std::vector<int> m_valueBoundaries;
+                /// Feature vector for the phrasing tree, reused for all words
+                std::vector<Wagon::CCompiledWagonTree::CFeatureValue> m_phrasingFeatures;
+                /// Symbol IDs of the POS of the words of the sentence, reused for all sentences
+                std::vector<int> m_posSymbols;
             };
 
         }//namespace base
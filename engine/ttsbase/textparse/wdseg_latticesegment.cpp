@@ -0,0 +1,219 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Implementation file for statistical word segmentation and POS tagging based on word lattice
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the unknown character whenever no word of one character is added
+///
+
+#include <math.h>
+#include <algorithm>
+#include "wdseg_latticesegment.h"
+#include "cmn/cmn_error.h"
+
+namespace cst
+{
+    namespace tts
+    {
+        namespace base
+        {
+            // score (log10) of the unknown character which is not in lexicon
+            static const double UNKNOWN_WORD_SCORE = -8.0;
+
+            int CLatticeWordSegment::segmentSentence(std::vector<CTextItem> &sentenceInfo)
+            {
+                const CTextData *pTextData = getDataManager<CTextData>();
+                const CLexicon &lexicon = pTextData->getLexicon();
+                const cmn::CBigram *pBigram = pTextData->getPOSBigram();
+
+                for (std::vector<CTextItem>::iterator it = sentenceInfo.begin(); it != sentenceInfo.end(); )
+                {
+                    CTextItem &textItem = *it;
+                    if (textItem.bWord || textItem.bPhoneme)
+                    {
+                        // advance directly, no necessary for processing
+                        it ++;
+                    }
+                    else
+                    {
+                        // perform the word segmentation
+                        std::vector<CTextItem> wdsegResult;
+                        latticeMatch(lexicon, pBigram, textItem, wdsegResult);
+
+                        // insert the result to original vector
+                        size_t span = it - sentenceInfo.begin();
+                        sentenceInfo.insert(it, wdsegResult.begin(), wdsegResult.end());
+                        it = sentenceInfo.begin() + span + wdsegResult.size();
+                        it = sentenceInfo.erase(it);
+                    }
+                }
+                return ERROR_SUCCESS;
+            }
+
+            CLatticeWordSegment::LatticeNode &CLatticeWordSegment::addNode(size_t start, size_t length)
+            {
+                if (m_numNodes >= m_nodes.size())
+                    m_nodes.resize(m_numNodes + 1);
+                LatticeNode &node = m_nodes[m_numNodes];
+                node.start     = start;
+                node.length    = length;
+                node.posIndex  = -1;
+                node.wordScore = 0;
+                node.pathScore = 0;
+                node.prevNode  = -1;
+
+                // chain to the nodes ending at the same position
+                size_t end = start + length;
+                node.nextSameEnd = m_endHeads[end];
+                m_endHeads[end]  = (int)m_numNodes;
+                m_numNodes ++;
+                return node;
+            }
+
+            int CLatticeWordSegment::latticeMatch(const CLexicon &lexicon, const cmn::CBigram *pBigram, const CTextItem &srcText, std::vector<CTextItem> &resTextList)
+            {
+                const std::wstring &wstrText = srcText.wstrText;
+                size_t totalTextLen = wstrText.length();
+                if (totalTextLen == 0)
+                    return ERROR_SUCCESS;
+
+                // reset the lattice, the arrays are kept for the next text
+                m_numNodes = 0;
+                m_endHeads.assign(totalTextLen + 1, -1);
+                m_wordLens.resize(lexicon.getWordMaxLen() + 1);
+
+                int bosIndex = pBigram ? pBigram->getPOSIndex(L"<s>")  : -1;
+                int eosIndex = pBigram ? pBigram->getPOSIndex(L"</s>") : -1;
+
+                // build the lattice, and search the best path along with building
+                // (all the nodes ending at current position have been added before,
+                // and each position is reachable as there is always a node with one character)
+                for (size_t pos = 0; pos < totalTextLen; pos++)
+                {
+                    size_t firstNode = m_numNodes;
+                    size_t nCount = lexicon.prefixSearch(wstrText.c_str() + pos, totalTextLen - pos, &m_wordLens[0], m_wordLens.size());
+                    for (size_t i = 0; i < nCount; i++)
+                    {
+                        m_lexemes.clear();
+                        lexicon.lookupWord(wstrText.substr(pos, m_wordLens[i]), m_lexemes);
+                        for (std::vector<CLexeme>::const_iterator it = m_lexemes.begin(); it != m_lexemes.end(); ++it)
+                        {
+                            // skip the duplicated POS of the same word (different pronunciations)
+                            size_t n = firstNode;
+                            for (; n < m_numNodes; n++)
+                            {
+                                if (m_nodes[n].length == m_wordLens[i] && m_nodes[n].wstrPOS == it->wstrPOS)
+                                    break;
+                            }
+                            if (n < m_numNodes)
+                            {
+                                continue;
+                            }
+
+                            // P(word|POS) estimated by word and POS frequency
+                            double wordFreq = (double)it->nFrequency;
+                            double posFreq  = (double)lexicon.getPOSFrequency(it->wstrPOS);
+                            if (posFreq < wordFreq)
+                                posFreq = wordFreq;
+                            LatticeNode &node = addNode(pos, m_wordLens[i]);
+                            node.wstrPOS   = it->wstrPOS;
+                            node.posIndex  = pBigram ? pBigram->getPOSIndex(node.wstrPOS) : -1;
+                            node.wordScore = log10((wordFreq + 1) / (posFreq + 1));
+                        }
+                    }
+                    // the words found may have no lexeme, and the lengths may be in any order
+                    bool hasSingleChar = false;
+                    for (size_t n = firstNode; n < m_numNodes && !hasSingleChar; n++)
+                    {
+                        hasSingleChar = (m_nodes[n].length == 1);
+                    }
+                    if (!hasSingleChar)
+                    {
+                        // unknown character, "x" represents unknown word
+                        LatticeNode &node = addNode(pos, 1);
+                        node.wstrPOS   = L"x";
+                        node.posIndex  = pBigram ? pBigram->getPOSIndex(node.wstrPOS) : -1;
+                        node.wordScore = UNKNOWN_WORD_SCORE;
+                    }
+
+                    // best path to the new nodes
+                    for (size_t n = firstNode; n < m_numNodes; n++)
+                    {
+                        LatticeNode &node = m_nodes[n];
+                        if (pos == 0)
+                        {
+                            double transScore = (pBigram && bosIndex >= 0 && node.posIndex >= 0) ? pBigram->getBigramValue(bosIndex, node.posIndex) : 0;
+                            node.pathScore = node.wordScore + transScore;
+                            continue;
+                        }
+                        for (int prev = m_endHeads[pos]; prev >= 0; prev = m_nodes[prev].nextSameEnd)
+                        {
+                            const LatticeNode &prevNode = m_nodes[prev];
+                            double transScore = (pBigram && prevNode.posIndex >= 0 && node.posIndex >= 0) ? pBigram->getBigramValue(prevNode.posIndex, node.posIndex) : 0;
+                            double score = prevNode.pathScore + transScore + node.wordScore;
+                            if (node.prevNode < 0 || score > node.pathScore)
+                            {
+                                node.pathScore = score;
+                                node.prevNode  = prev;
+                            }
+                        }
+                    }
+                }
+
+                // best node at the end of text
+                int bestNode = -1;
+                double bestScore = 0;
+                for (int n = m_endHeads[totalTextLen]; n >= 0; n = m_nodes[n].nextSameEnd)
+                {
+                    const LatticeNode &node = m_nodes[n];
+                    double score = node.pathScore + ((pBigram && eosIndex >= 0 && node.posIndex >= 0) ? pBigram->getBigramValue(node.posIndex, eosIndex) : 0);
+                    if (bestNode < 0 || score > bestScore)
+                    {
+                        bestScore = score;
+                        bestNode  = n;
+                    }
+                }
+
+                // trace back the best path
+                size_t firstWord = resTextList.size();
+                for (int n = bestNode; n >= 0; n = m_nodes[n].prevNode)
+                {
+                    const LatticeNode &node = m_nodes[n];
+                    resTextList.push_back(srcText);
+                    CTextItem &wordItem = resTextList.back();
+                    wordItem.wstrText = wstrText.substr(node.start, node.length);
+                    wordItem.wstrPOS  = node.wstrPOS;
+                }
+                std::reverse(resTextList.begin() + firstWord, resTextList.end());
+
+                return ERROR_SUCCESS;
+            }
+
+        }//namespace base
+    }
+}
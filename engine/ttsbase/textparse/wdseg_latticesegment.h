@@ -0,0 +1,115 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Head file for statistical word segmentation and POS tagging based on word lattice
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+///
+
+#ifndef _CST_TTS_BASE_WDSEG_LATTICESEGMENT_H_
+#define _CST_TTS_BASE_WDSEG_LATTICESEGMENT_H_
+
+#include "wdseg_wordsegment.h"
+
+namespace cst
+{
+    namespace tts
+    {
+        namespace base
+        {
+            ///
+            /// @brief  The class which performs word segmentation and POS tagging with word lattice
+            ///
+            /// All the lexicon words (with all their POS) which can be found in the text are put into
+            /// a word lattice, and the best path through the lattice is searched by Viterbi algorithm.
+            /// The path is scored by the word frequency given the POS, and the POS bigram if the
+            /// POS bigram model is available in text data (see CTextData::getPOSBigram()).
+            ///
+            /// The lattice is kept in arrays which are reused for all the text pieces,
+            /// the nodes ending at the same position are chained by their indices.
+            ///
+            /// This module can be used instead of the forward maximum matching CWordSegment by
+            /// "<module name="CWordSegment" use="CLatticeWordSegment"/>" in configuration file.
+            ///
+            class CLatticeWordSegment : public CWordSegment
+            {
+            public:
+                ///
+                /// @brief  Constructor
+                ///
+                CLatticeWordSegment(const CDataManager *pDataManager) : CWordSegment(pDataManager), m_numNodes(0) {}
+
+            protected:
+                ///
+                /// @brief  Perform the word segmentation for each text piece in one sentence, using word lattice
+                ///
+                /// @param  [in]  sentenceInfo  The text piece information for a sentence
+                /// @param  [out] sentenceInfo  Return the result with word segmentation result
+                ///
+                virtual int segmentSentence(std::vector<CTextItem> &sentenceInfo);
+
+                ///
+                /// @brief  Perform the lattice based segmentation for one text item, return the result in CTextItem vector
+                ///
+                /// @param  [in]  lexicon       The lexicon data from which word entries are matched
+                /// @param  [in]  pBigram       The POS bigram model for scoring the POS transitions, NULL if not available
+                /// @param  [in]  srcText       The source text piece item to be segmented
+                /// @param  [out] resTextList   Return the segmentation result (with POS)
+                ///
+                virtual int latticeMatch(const CLexicon &lexicon, const cmn::CBigram *pBigram, const CTextItem &srcText, std::vector<CTextItem> &resTextList);
+
+            protected:
+                ///
+                /// @brief  Node of the word lattice, i.e. one word with one POS
+                ///
+                struct LatticeNode
+                {
+                    size_t       start;         ///< Start position of the word in text
+                    size_t       length;        ///< Length of the word
+                    std::wstring wstrPOS;       ///< Part-of-speech of the word
+                    int          posIndex;      ///< Index of POS in bigram model
+                    double       wordScore;     ///< Log probability of the word given the POS
+                    double       pathScore;     ///< Score of the best path ending with this node
+                    int          prevNode;      ///< Previous node in the best path, -1 for the beginning of text
+                    int          nextSameEnd;   ///< Next node ending at the same position, -1 for the last one
+                };
+
+                ///
+                /// @brief  Add one node to the lattice, the node is reused if it exists
+                ///
+                LatticeNode &addNode(size_t start, size_t length);
+
+            protected:
+                std::vector<LatticeNode> m_nodes;   ///< Nodes of the lattice (reused, only the first m_numNodes are valid)
+                size_t m_numNodes;                  ///< Number of valid nodes in the lattice
+                std::vector<int> m_endHeads;        ///< First node ending at each position, -1 if none
+                std::vector<size_t> m_wordLens;     ///< Buffer for the lengths of words found by prefix search
+                std::vector<CLexeme> m_lexemes;     ///< Buffer for the lexemes of word
+            };
+
+        }//namespace base
+    }
+}
+
+#endif//_CST_TTS_BASE_WDSEG_LATTICESEGMENT_H_
@@ -28,6 +28,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/05/28
 ///   Changed:  Added the default implementation by internal document processing
+/// - Version:  0.3.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
 ///
 
 #include "wdseg_wordsegment.h"
@@ -52,24 +56,24 @@ namespace cst
                 }
                 else if (pNode->type() == xml::CXMLNode::XML_ELEMENT)
                 {
-                    if (pNode->value() == L"p")
+                    if (pNode->nameId() == xml::XML_NAME_P)
                     {
                         // paragraph
                         appendParagraph();
                     }
-                    else if (pNode->value() == L"s")
+                    else if (pNode->nameId() == xml::XML_NAME_S)
                     {
                         // sentence
                         appendSentence();
                     }
-                    else if (pNode->value() == L"w")
+                    else if (pNode->nameId() == xml::XML_NAME_W)
                     {
                         // word
                         if (!m_tmpItem.bPhoneme)
                         {
                             m_tmpItem.bWord = true;
                             m_tmpItem.pXMLNode = pNode;
-                            m_tmpItem.wstrPOS = ((xml::CXMLElement*)pNode)->getAttribute(L"role");
+                            m_tmpItem.wstrPOS = ((xml::CXMLElement*)pNode)->getAttribute(xml::XML_NAME_ROLE);
                         }
                         else
                         {
@@ -77,7 +81,7 @@ namespace cst
                             return ERROR_INVALID_SSML_DOCUMENT;
                         }
                     }
-                    else if (pNode->value() == L"phoneme")
+                    else if (pNode->nameId() == xml::XML_NAME_PHONEME)
                     {
                         // phoneme
                         if (!m_tmpItem.bWord)
@@ -86,12 +90,12 @@ namespace cst
                             m_tmpItem.pXMLNode = pNode;
                         }
                     }
-                    else if (pNode->value() == L"sub")
+                    else if (pNode->nameId() == xml::XML_NAME_SUB)
                     {
                         // sub
                         if (!m_tmpItem.bPhoneme && !m_tmpItem.bWord)
                             m_tmpItem.pXMLNode = pNode;
-                        m_tmpItem.wstrText = ((xml::CXMLElement*)pNode)->getAttribute(L"alias");
+                        m_tmpItem.wstrText = ((xml::CXMLElement*)pNode)->getAttribute(xml::XML_NAME_ALIAS);
                         appendItem(m_tmpItem);
                         childProcessed = true;
                     }
@@ -104,12 +108,12 @@ namespace cst
                 if (pNode->type() == xml::CXMLNode::XML_ELEMENT)
                 {
                     // restore the flag for "w" and "phoneme"
-                    if (pNode->value() == L"w")
+                    if (pNode->nameId() == xml::XML_NAME_W)
                     {
                         m_tmpItem.bWord = false;
                         m_tmpItem.wstrPOS = L"";
                     }
-                    else if (pNode->value() == L"phoneme")
+                    else if (pNode->nameId() == xml::XML_NAME_PHONEME)
                     {
                         m_tmpItem.bPhoneme = false;
                     }
@@ -117,6 +121,29 @@ namespace cst
                 return ERROR_SUCCESS;
             }
 
+            int CWordSegment::CWdSegDocument::build(CUtterance &utterance)
+            {
+                for (std::vector<CUttParagraph>::iterator pit = utterance.paragraphs.begin(); pit != utterance.paragraphs.end(); ++pit)
+                {
+                    appendParagraph();
+                    for (std::vector<CUttSentence>::iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+                    {
+                        appendSentence();
+                        for (std::vector<CUttWord>::iterator wit = sit->words.begin(); wit != sit->words.end(); ++wit)
+                        {
+                            CTextItem textItem;
+                            textItem.pUttWord = &*wit;
+                            textItem.bWord    = wit->isWord;
+                            textItem.bPhoneme = !wit->isWord && wit->isPhonemeFixed;
+                            textItem.wstrText = wit->wstrText;
+                            textItem.wstrPOS  = wit->wstrPOS;
+                            appendItem(textItem);
+                        }
+                    }
+                }
+                return ERROR_SUCCESS;
+            }
+
             int CWordSegment::process(xml::CSSMLDocument * pSSMLDocument)
             {
                 CWdSegDocument  wdsegDocument;
@@ -133,6 +160,60 @@ namespace cst
                 return ERROR_SUCCESS;
             }
 
+            int CWordSegment::process(CUtterance &utterance)
+            {
+                CWdSegDocument  wdsegDocument;
+
+                // retrieve data from typed utterance
+                wdsegDocument.build(utterance);
+
+                // process internal data for word segmentation
+                segmentToWord(wdsegDocument);
+
+                // write result back to typed utterance
+                writeResult(utterance, wdsegDocument);
+
+                return ERROR_SUCCESS;
+            }
+
+            int CWordSegment::writeResult(CUtterance &utterance, CWdSegDocument &wdsegDocument)
+            {
+                // replace the text pieces of each sentence by the segmented words,
+                // the break after a text piece is kept after its last word
+
+                wdsegDocument.resetCursor();
+                for (std::vector<CUttParagraph>::iterator pit = utterance.paragraphs.begin(); pit != utterance.paragraphs.end(); ++pit)
+                {
+                    for (std::vector<CUttSentence>::iterator sit = pit->sentences.begin(); sit != pit->sentences.end(); ++sit)
+                    {
+                        const std::vector<CTextItem> *pSentence = wdsegDocument.getSentence();
+                        if (pSentence == NULL)
+                            return ERROR_INVALID_SSML_DOCUMENT;
+
+                        std::vector<CUttWord> newWords;
+                        newWords.reserve(pSentence->size());
+                        for (std::vector<CTextItem>::const_iterator it = pSentence->begin(); it != pSentence->end(); it++)
+                        {
+                            const CTextItem &wordItem = *it;
+                            newWords.push_back(*wordItem.pUttWord);
+                            CUttWord &word = newWords.back();
+                            word.wstrText = wordItem.wstrText;
+                            word.wstrPOS  = wordItem.wstrPOS;
+                            word.isWord   = true;
+                            if (it + 1 != pSentence->end() && (it + 1)->pUttWord == wordItem.pUttWord)
+                            {
+                                // not the last word of the text piece
+                                word.breakAfter.clear();
+                            }
+                        }
+                        std::swap(sit->words, newWords);
+                    }
+                }
+                utterance.stage = CUtterance::STAGE_WORD;
+
+                return ERROR_SUCCESS;
+            }
+
             int CWordSegment::writeResult(xml::CSSMLDocument *pSSMLDocument, CWdSegDocument &wdsegDocument)
             {
                 // write the word segmentation result to the SSML document
@@ -155,13 +236,13 @@ namespace cst
                         {
                             // set POS for word if necessary
                             xml::CXMLElement *pWord = (xml::CXMLElement*)wordItem.pXMLNode;
-                            pWord->setAttribute(L"role", wordItem.wstrPOS);
+                            pWord->setAttribute(xml::XML_NAME_ROLE, wordItem.wstrPOS);
                         }
                         else if (wordItem.bPhoneme)
                         {
                             // phoneme, add "w" element
-                            xml::CXMLElement *pWord = new xml::CXMLElement(L"w");
-                            pWord->setAttribute(L"role", wordItem.wstrPOS);
+                            xml::CXMLElement *pWord = pSSMLDocument->createElement(L"w");
+                            pWord->setAttribute(xml::XML_NAME_ROLE, wordItem.wstrPOS);
 
                             // link "phoneme"
                             wordItem.pXMLNode->insertBefore(pWord);
@@ -171,9 +252,9 @@ namespace cst
                         else
                         {
                             // text, create "w" element
-                            xml::CXMLText *pText = new xml::CXMLText(wordItem.wstrText);
-                            xml::CXMLElement *pWord = new xml::CXMLElement(L"w");
-                            pWord->setAttribute(L"role", wordItem.wstrPOS);
+                            xml::CXMLText *pText = pSSMLDocument->createText(wordItem.wstrText);
+                            xml::CXMLElement *pWord = pSSMLDocument->createElement(L"w");
+                            pWord->setAttribute(xml::XML_NAME_ROLE, wordItem.wstrPOS);
                             pWord->linkLastChild(pText);
 
                             // insert before current "text" node
@@ -245,24 +326,13 @@ namespace cst
             {
                 size_t lastPos = 0, totalTextLen = srcText.wstrText.length(), maxWordLen = lexicon.getWordMaxLen(), curWordLen;
                 size_t nCount = 0;
-                std::wstring wstrDupPiece;
+                std::vector<size_t> wordLens(maxWordLen + 1);
                 std::vector<CLexeme> wordEntries;
 
                 while (lastPos < totalTextLen)
                 {
-                    // duplicate the original piece with the maximum word length
-                    curWordLen = totalTextLen - lastPos;
-                    wstrDupPiece = srcText.wstrText.substr(lastPos, (curWordLen > maxWordLen) ? maxWordLen : curWordLen);
-
-                    // query the words from maximum length until 1 or word is matched
-                    while (wstrDupPiece.length() >= 1)
-                    {
-                        nCount = lexicon.lookupWord(wstrDupPiece, wordEntries);
-                        if (nCount > 0)
-                            break;
-                        wstrDupPiece.erase(wstrDupPiece.length()-1, 1);
-                        nCount = 0;
-                    }
+                    // query all the words starting at current position, the last one is the longest
+                    nCount = lexicon.prefixSearch(srcText.wstrText.c_str() + lastPos, totalTextLen - lastPos, &wordLens[0], wordLens.size());
 
                     // save word information
                     resTextList.push_back(srcText);
@@ -270,19 +340,22 @@ namespace cst
                     if (nCount > 0)
                     {
                         // word matched in lexicon
-                        wordItem.wstrText = wstrDupPiece;
-                        wordItem.wstrPOS  = wordEntries[0].wstrPOS;
+                        curWordLen = wordLens[nCount-1];
+                        wordItem.wstrText = srcText.wstrText.substr(lastPos, curWordLen);
+                        wordEntries.clear();
+                        lexicon.lookupWord(wordItem.wstrText, wordEntries);
+                        wordItem.wstrPOS  = wordEntries.empty() ? L"x" : wordEntries[0].wstrPOS;
                     }
                     else
                     {
                         // process unknown character
-                        wstrDupPiece = srcText.wstrText.substr(lastPos, 1);
-                        wordItem.wstrText = wstrDupPiece;
+                        curWordLen = 1;
+                        wordItem.wstrText = srcText.wstrText.substr(lastPos, 1);
                         wordItem.wstrPOS  = L"x";   // "x" represents unknown word
                     }
 
                     // advance to next word
-                    lastPos += wstrDupPiece.length();
+                    lastPos += curWordLen;
                 }
                 return ERROR_SUCCESS;
             }
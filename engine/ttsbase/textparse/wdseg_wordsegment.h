@@ -28,6 +28,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2008/05/28
 ///   Changed:  Added the default implementation by internal document processing
+/// - Version:  0.3.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
 ///
 
 #ifndef _CST_TTS_BASE_WDSEG_WORDSEGMENT_H_
@@ -37,6 +41,7 @@
 #include "xml/ssml_traversal.h"
 #include "../datamanage/base_module.h"
 #include "../datamanage/base_ttsdocument.h"
+#include "../datamanage/base_utterance.h"
 #include "../datatext/data_textdata.h"
 
 namespace cst
@@ -79,6 +84,17 @@ namespace cst
                 ///
                 virtual int process(xml::CSSMLDocument * pSSMLDocument);
 
+                ///
+                /// @brief  The main processing procedure of the word segmentation module for typed utterance
+                ///
+                /// @param  [in]  utterance  The input utterance with text pieces
+                /// @param  [out] utterance  Return the utterance with words
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                ///
+                virtual int process(CUtterance &utterance);
+
             protected:
                 //////////////////////////////////////////////////////////////////////////
                 //
@@ -102,8 +118,9 @@ namespace cst
                 class CTextItem
                 {
                 public:
-                    CTextItem() : pXMLNode(NULL), bWord(false), bPhoneme(false) {}  ///< Constructor
+                    CTextItem() : pXMLNode(NULL), pUttWord(NULL), bWord(false), bPhoneme(false) {}  ///< Constructor
                     xml::CXMLNode   *pXMLNode;      ///< Handle to the xml node in SSML document, see CTextItem for details
+                    CUttWord        *pUttWord;      ///< Handle to the word (or text piece) in typed utterance, instead of pXMLNode
                     bool            bWord;          ///< Whether text piece is under "w" element (i.e. pXMLNode is "w" element)
                     bool            bPhoneme;       ///< Whether text piece is under "phoneme" element (i.e. pXMLNode is "phoneme" element)
                     std::wstring    wstrText;       ///< The text piece
@@ -115,6 +132,12 @@ namespace cst
                 ///
                 class CWdSegDocument : public CTTSDocument<CTextItem>, public xml::CSSMLTraversal
                 {
+                public:
+                    ///
+                    /// @brief  Build internal document from the typed utterance
+                    ///
+                    int build(CUtterance &utterance);
+
                 protected:
                     ///
                     /// @brief  Process SSML document node, for building internal document by SSML traversing
@@ -147,6 +170,14 @@ namespace cst
                 ///
                 virtual int writeResult(xml::CSSMLDocument *pSSMLDocument, CWdSegDocument &wdsegDocument);
 
+                ///
+                /// @brief  Write the result from internal result to the typed utterance
+                ///
+                /// @param  [in]  wdsegDocument   The internal results to be written
+                /// @param  [out] utterance       Return the utterance with word segmentation result
+                ///
+                virtual int writeResult(CUtterance &utterance, CWdSegDocument &wdsegDocument);
+
                 ///
                 /// @brief  Perform the forward match for one text item, return the result in CTextItem vector
                 ///
@@ -0,0 +1,173 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Implementation file for the cache of synthesis results for the Text-to-Speech (TTS) service
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Kept the unit selection search settings in the speech key
+///
+
+#include "tts_cache.h"
+#include "utils/utl_string.h"
+
+namespace cst
+{
+    namespace tts
+    {
+        namespace base
+        {
+            CSynthCacheStatistics::CSynthCacheStatistics()
+            {
+                numSpeechHits       = 0;
+                numSpeechMisses     = 0;
+                numUtteranceHits    = 0;
+                numUtteranceMisses  = 0;
+                numSpeechEntries    = 0;
+                numUtteranceEntries = 0;
+                speechBytes         = 0;
+            }
+
+            CSynthCache::CSynthCache(size_t maxSpeechBytes, size_t maxUtteranceEntries)
+            {
+                this->maxSpeechBytes      = maxSpeechBytes;
+                this->maxUtteranceEntries = maxUtteranceEntries;
+            }
+
+            CSynthCache::~CSynthCache()
+            {
+            }
+
+            void CSynthCache::composeKey(const std::wstring &wstrVoice, const std::wstring &wstrText, std::wstring &wstrKey)
+            {
+                // the voice identity does not contain line feed
+                wstrKey.reserve(wstrVoice.size() + wstrText.size() + 1);
+                wstrKey = wstrVoice;
+                wstrKey += L'\n';
+                wstrKey += wstrText;
+            }
+
+            void CSynthCache::composeSpeechKey(const std::wstring &wstrKey, const TTSSetting &setting, std::wstring &wstrSpeechKey)
+            {
+                // settings go first for comparing different keys quickly, unit selection search affects the concatenative voice
+                wstrSpeechKey = str::format(L"%g %g %g %d %d\n", setting.rate, setting.volume, setting.pitch, setting.maxCandidates, setting.beamWidth);
+                wstrSpeechKey += wstrKey;
+            }
+
+            size_t CSynthCache::entryBytes(const std::wstring &wstrKey, const std::vector<unsigned char> &speech)
+            {
+                return wstrKey.size() * sizeof(wchar_t) + speech.size();
+            }
+
+            bool CSynthCache::getSpeech(const std::wstring &wstrKey, const TTSSetting &setting, std::vector<unsigned char> &speech)
+            {
+                std::wstring wstrSpeechKey;
+                composeSpeechKey(wstrKey, setting, wstrSpeechKey);
+
+                cmn::CAutoLock lock(mutex);
+                std::vector<unsigned char> *pSpeech = speeches.find(wstrSpeechKey);
+                if (pSpeech == NULL)
+                {
+                    statistics.numSpeechMisses++;
+                    return false;
+                }
+                statistics.numSpeechHits++;
+                speech = *pSpeech;
+                return true;
+            }
+
+            void CSynthCache::putSpeech(const std::wstring &wstrKey, const TTSSetting &setting, const unsigned char *pData, unsigned long nByteLen)
+            {
+                std::wstring wstrSpeechKey;
+                composeSpeechKey(wstrKey, setting, wstrSpeechKey);
+                if (entryBytes(wstrSpeechKey, std::vector<unsigned char>()) + nByteLen > maxSpeechBytes)
+                    return;
+
+                cmn::CAutoLock lock(mutex);
+                bool inserted;
+                std::vector<unsigned char> &speech = speeches.insert(wstrSpeechKey, inserted);
+                if (!inserted)
+                    return;
+                speech.assign(pData, pData + nByteLen);
+                statistics.speechBytes += entryBytes(wstrSpeechKey, speech);
+
+                // discard the least recently used speeches, the new one is at the front
+                while (statistics.speechBytes > maxSpeechBytes)
+                {
+                    statistics.speechBytes -= entryBytes(speeches.last().first, speeches.last().second);
+                    speeches.removeLast();
+                }
+                statistics.numSpeechEntries = (unsigned long)speeches.size();
+            }
+
+            bool CSynthCache::getUtterance(const std::wstring &wstrKey, CUtterance &utterance)
+            {
+                cmn::CAutoLock lock(mutex);
+                CUtterance *pUtterance = utterances.find(wstrKey);
+                if (pUtterance == NULL)
+                {
+                    statistics.numUtteranceMisses++;
+                    return false;
+                }
+                statistics.numUtteranceHits++;
+                utterance = *pUtterance;
+                return true;
+            }
+
+            void CSynthCache::putUtterance(const std::wstring &wstrKey, const CUtterance &utterance)
+            {
+                if (maxUtteranceEntries == 0)
+                    return;
+
+                cmn::CAutoLock lock(mutex);
+                bool inserted;
+                CUtterance &cached = utterances.insert(wstrKey, inserted);
+                if (!inserted)
+                    return;
+                cached = utterance;
+
+                while (utterances.size() > maxUtteranceEntries)
+                    utterances.removeLast();
+                statistics.numUtteranceEntries = (unsigned long)utterances.size();
+            }
+
+            void CSynthCache::getStatistics(CSynthCacheStatistics &statistics)
+            {
+                cmn::CAutoLock lock(mutex);
+                statistics = this->statistics;
+            }
+
+            void CSynthCache::clear()
+            {
+                cmn::CAutoLock lock(mutex);
+                speeches.clear();
+                utterances.clear();
+                statistics = CSynthCacheStatistics();
+            }
+
+        }//namespace base
+    }
+}
@@ -0,0 +1,269 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Head file defining the cache of synthesis results for the Text-to-Speech (TTS) service
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Kept the unit selection search settings in the speech key
+///
+
+#ifndef _CST_TTS_BASE_TTS_CACHE_H_
+#define _CST_TTS_BASE_TTS_CACHE_H_
+
+#include <map>
+#include <list>
+#include <string>
+#include <vector>
+#include "cmn/cmn_thread.h"
+#include "ttsbase/datamanage/data_datamanager.h"
+#include "ttsbase/datamanage/base_utterance.h"
+
+namespace cst
+{
+    namespace tts
+    {
+        namespace base
+        {
+            ///
+            /// @brief  Hit/miss and memory counters of the synthesis cache
+            ///
+            class CSynthCacheStatistics
+            {
+            public:
+                unsigned long   numSpeechHits;      ///< Number of requests whose speech is found in the cache
+                unsigned long   numSpeechMisses;    ///< Number of requests whose speech is not found in the cache
+                unsigned long   numUtteranceHits;   ///< Number of requests whose analyzed utterance is found in the cache
+                unsigned long   numUtteranceMisses; ///< Number of requests whose analyzed utterance is not found in the cache
+                unsigned long   numSpeechEntries;   ///< Number of speeches kept in the cache
+                unsigned long   numUtteranceEntries;///< Number of analyzed utterances kept in the cache
+                size_t          speechBytes;        ///< Memory used by the cached speeches (in byte, including the keys)
+
+            public:
+                ///
+                /// @brief  Constructor
+                ///
+                CSynthCacheStatistics();
+            };
+
+            ///
+            /// @brief  The bounded in-memory cache of synthesis results, shared by the workers of TTS service
+            ///
+            /// The cache has two tiers, both keyed by the normalized text and the identity of the voice:
+            /// - the speech tier keeps the final PCM samples of the text synthesized with certain rate,
+            ///   volume, pitch and unit selection search, so that repeated prompts are returned without synthesis;
+            /// - the utterance tier keeps the utterance after unit segmentation and prosody prediction,
+            ///   which the synthesis back end builds its labels from. The rate, volume and pitch are
+            ///   applied by the wave synthesizer, hence requests of the same text with different
+            ///   settings skip the text analysis and prosody prediction.
+            ///
+            /// Each tier discards its least recently used entries when it exceeds its capacity. The keys are
+            /// looked up by hash, and compared in full to rule out collisions. All methods are thread-safe.
+            ///
+            class CSynthCache
+            {
+            public:
+                ///
+                /// @brief  Constructor
+                ///
+                /// @param  [in] maxSpeechBytes         Maximum memory of the speech tier (in byte), 0 to disable the tier
+                /// @param  [in] maxUtteranceEntries    Maximum number of utterances of the utterance tier, 0 to disable the tier
+                ///
+                CSynthCache(size_t maxSpeechBytes, size_t maxUtteranceEntries);
+
+                ///
+                /// @brief  Destructor
+                ///
+                virtual ~CSynthCache();
+
+                ///
+                /// @brief  Compose the key of the text for looking up the cache
+                ///
+                /// @param  [in]  wstrVoice     Identity of the voice (e.g. language, lexicon and voice data paths)
+                /// @param  [in]  wstrText      The normalized text, e.g. the printed SSML document after pre-processing
+                /// @param  [out] wstrKey       Return the key of the text
+                ///
+                static void composeKey(const std::wstring &wstrVoice, const std::wstring &wstrText, std::wstring &wstrKey);
+
+                ///
+                /// @brief  Get the speech of the text synthesized with the settings
+                ///
+                /// @param  [in]  wstrKey   The key of the text composed by composeKey()
+                /// @param  [in]  setting   The settings of the request, only those affecting the speech are compared
+                /// @param  [out] speech    Return the PCM samples of the speech
+                ///
+                /// @return Whether the speech is found in the cache
+                ///
+                bool getSpeech(const std::wstring &wstrKey, const TTSSetting &setting, std::vector<unsigned char> &speech);
+
+                ///
+                /// @brief  Keep the speech of the text synthesized with the settings
+                ///
+                /// @param  [in]  wstrKey   The key of the text composed by composeKey()
+                /// @param  [in]  setting   The settings of the request, only those affecting the speech are kept
+                /// @param  [in]  pData     The PCM samples of the speech
+                /// @param  [in]  nByteLen  The length of the speech (in byte)
+                ///
+                void putSpeech(const std::wstring &wstrKey, const TTSSetting &setting, const unsigned char *pData, unsigned long nByteLen);
+
+                ///
+                /// @brief  Get the utterance of the text after unit segmentation and prosody prediction
+                ///
+                /// @param  [in]  wstrKey   The key of the text composed by composeKey()
+                /// @param  [out] utterance Return a copy of the cached utterance
+                ///
+                /// @return Whether the utterance is found in the cache
+                ///
+                bool getUtterance(const std::wstring &wstrKey, CUtterance &utterance);
+
+                ///
+                /// @brief  Keep the utterance of the text after unit segmentation and prosody prediction
+                ///
+                /// @param  [in]  wstrKey   The key of the text composed by composeKey()
+                /// @param  [in]  utterance The utterance to be copied into the cache
+                ///
+                void putUtterance(const std::wstring &wstrKey, const CUtterance &utterance);
+
+                ///
+                /// @brief  Get the hit/miss and memory counters
+                ///
+                void getStatistics(CSynthCacheStatistics &statistics);
+
+                ///
+                /// @brief  Remove all entries and reset the counters
+                ///
+                void clear();
+
+            protected:
+                ///
+                /// @brief  The least recently used list with hash index, the most recently used entry is at the front
+                ///
+                template<class Value>
+                class CLRUList
+                {
+                public:
+                    typedef std::pair<std::wstring, Value> Entry;
+                    typedef typename std::list<Entry>::iterator Iterator;
+
+                    ///
+                    /// @brief  Find the entry of the key and move it to the front, NULL if not found
+                    ///
+                    Value *find(const std::wstring &wstrKey)
+                    {
+                        Iterator it = lookup(wstrKey);
+                        if (it == entries.end())
+                            return NULL;
+                        entries.splice(entries.begin(), entries, it);
+                        return &it->second;
+                    }
+
+                    ///
+                    /// @brief  Insert an empty entry of the key at the front, or return the existing one
+                    ///
+                    Value &insert(const std::wstring &wstrKey, bool &inserted)
+                    {
+                        Iterator it = lookup(wstrKey);
+                        inserted = (it == entries.end());
+                        if (inserted)
+                        {
+                            entries.push_front(Entry(wstrKey, Value()));
+                            it = entries.begin();
+                            index.insert(std::make_pair(hash(wstrKey), it));
+                        }
+                        else
+                            entries.splice(entries.begin(), entries, it);
+                        return it->second;
+                    }
+
+                    ///
+                    /// @brief  Remove the least recently used entry
+                    ///
+                    void removeLast()
+                    {
+                        Iterator last = --entries.end();
+                        unsigned long key = hash(last->first);
+                        typename std::multimap<unsigned long, Iterator>::iterator pos = index.lower_bound(key);
+                        while (pos->second != last)
+                            ++pos;
+                        index.erase(pos);
+                        entries.pop_back();
+                    }
+
+                    const Entry &last() const {return entries.back();}
+                    size_t size() const {return index.size();}
+                    void clear() {entries.clear(); index.clear();}
+
+                protected:
+                    Iterator lookup(const std::wstring &wstrKey)
+                    {
+                        typedef typename std::multimap<unsigned long, Iterator>::iterator IndexIterator;
+                        std::pair<IndexIterator, IndexIterator> range = index.equal_range(hash(wstrKey));
+                        for (IndexIterator pos = range.first; pos != range.second; ++pos)
+                        {
+                            if (pos->second->first == wstrKey)
+                                return pos->second;
+                        }
+                        return entries.end();
+                    }
+
+                    static unsigned long hash(const std::wstring &wstrKey)
+                    {
+                        // FNV-1a over the characters
+                        unsigned long value = 2166136261UL;
+                        for (size_t i = 0; i < wstrKey.size(); i++)
+                            value = ((value ^ (unsigned long)wstrKey[i]) * 16777619UL) & 0xFFFFFFFFUL;
+                        return value;
+                    }
+
+                protected:
+                    std::list<Entry> entries;                           ///< Entries in the order of use
+                    std::multimap<unsigned long, Iterator> index;       ///< Hash of the key to the entries
+                };
+
+                ///
+                /// @brief  Compose the key of the speech from the key of the text and the settings
+                ///
+                static void composeSpeechKey(const std::wstring &wstrKey, const TTSSetting &setting, std::wstring &wstrSpeechKey);
+
+                ///
+                /// @brief  Memory used by a speech entry (in byte)
+                ///
+                static size_t entryBytes(const std::wstring &wstrKey, const std::vector<unsigned char> &speech);
+
+            protected:
+                size_t maxSpeechBytes;                                  ///< Maximum memory of the speech tier
+                size_t maxUtteranceEntries;                             ///< Maximum number of entries of the utterance tier
+                CLRUList<std::vector<unsigned char> > speeches;         ///< The speech tier
+                CLRUList<CUtterance> utterances;                        ///< The utterance tier
+                CSynthCacheStatistics statistics;                       ///< Hit/miss and memory counters
+                cmn::CMutex mutex;                                      ///< Mutex for all the above
+            };
+
+        }//namespace base
+    }
+}
+
+#endif//_CST_TTS_BASE_TTS_CACHE_H_
@@ -0,0 +1,590 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Implementation file for the multi-threaded service of Text-to-Speech (TTS) engine
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the cache of synthesis results
+///
+
+#if defined(WIN32) || defined(WINCE)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include <algorithm>
+#include <sstream>
+#include "tts_service.h"
+#include "cmn/cmn_error.h"
+#include "ttsbase/datamanage/base_utterance.h"
+#include "xml/ssml_document.h"
+#include "dsp/dsp_wavedata.h"
+
+namespace cst
+{
+    namespace tts
+    {
+        namespace base
+        {
+            ///
+            /// @brief  Get the wall clock time (in second) for measuring latency
+            ///
+            static double getWallTime()
+            {
+#if defined(WIN32) || defined(WINCE)
+                LARGE_INTEGER freq, count;
+                QueryPerformanceFrequency(&freq);
+                QueryPerformanceCounter(&count);
+                return (double)count.QuadPart / freq.QuadPart;
+#else
+                struct timeval tv;
+                gettimeofday(&tv, NULL);
+                return tv.tv_sec + tv.tv_usec / 1e6;
+#endif
+            }
+
+            ///
+            /// @brief  Compose the RIFF WAV header of the speech (little-endian)
+            ///
+            /// @param  [in]  waveData      The speech providing the format
+            /// @param  [in]  dataLength    Length of the speech data (in byte), 0xFFFFFFFF for unknown length of streaming speech
+            /// @param  [out] header        Return the 44-byte WAV header
+            ///
+            static void composeWaveHeader(const dsp::CWaveData &waveData, unsigned long dataLength, std::vector<unsigned char> &header)
+            {
+                unsigned long blockAlign  = waveData.getChannels() * waveData.getBitsPerSample() / 8;
+                unsigned long riffSize    = (dataLength == 0xFFFFFFFF) ? 0xFFFFFFFF : dataLength + 36;
+                unsigned long fields[][2] = {
+                    {0x46464952, 4},                                    // "RIFF"
+                    {riffSize, 4},
+                    {0x45564157, 4},                                    // "WAVE"
+                    {0x20746d66, 4},                                    // "fmt "
+                    {16, 4},
+                    {waveData.getFormatTag(), 2},
+                    {waveData.getChannels(), 2},
+                    {waveData.getSamplesPerSec(), 4},
+                    {waveData.getSamplesPerSec() * blockAlign, 4},
+                    {blockAlign, 2},
+                    {waveData.getBitsPerSample(), 2},
+                    {0x61746164, 4},                                    // "data"
+                    {dataLength, 4},
+                };
+
+                header.clear();
+                for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+                {
+                    for (unsigned long j = 0; j < fields[i][1]; j++)
+                        header.push_back((unsigned char)((fields[i][0] >> (j * 8)) & 0xFF));
+                }
+            }
+
+            ///
+            /// @brief  The wave sink passing the speech of a streaming request to its callback, and checking the cancellation
+            ///
+            class CServiceWaveSink : public dsp::CWaveSink
+            {
+            public:
+                CServiceWaveSink(CTTSService &owner, CTTSRequest &request) : service(owner), request(request), started(false) {}
+
+                virtual bool write(const unsigned char *pData, unsigned long nByteLen)
+                {
+                    if (service.isCancelled(request))
+                        return false;
+
+                    if (!started)
+                    {
+                        started = true;
+                        request.latency[CTTSRequest::STAGE_FIRST_SPEECH] = getWallTime() - request.submitTime;
+                        if (request.outputFormat == CTTSRequest::OUTPUT_WAV)
+                        {
+                            // the length of streaming speech is unknown
+                            std::vector<unsigned char> header;
+                            dsp::CWaveData waveFormat;
+                            ushort nChannels, nBitsPerSample;
+                            ulong  nSamplesPerSec;
+                            service.getWaveFormat(nChannels, nBitsPerSample, nSamplesPerSec);
+                            waveFormat.setFormat(nSamplesPerSec, nBitsPerSample, nChannels);
+                            composeWaveHeader(waveFormat, 0xFFFFFFFF, header);
+                            if (!request.pCallback->onSpeech(request, &header[0], (unsigned long)header.size()))
+                                return false;
+                        }
+                    }
+                    return request.pCallback->onSpeech(request, pData, nByteLen);
+                }
+
+            protected:
+                CTTSService &service;
+                CTTSRequest &request;
+                bool started;
+            };
+
+
+            //////////////////////////////////////////////////////////////////////////
+            //
+            //  TTS request and statistics
+            //
+            //////////////////////////////////////////////////////////////////////////
+
+            CTTSRequest::CTTSRequest()
+            {
+                inputTextType = ITT_TEXT_RAW;
+                priority      = PRIORITY_NORMAL;
+                outputFormat  = OUTPUT_PCM;
+                streaming     = false;
+                pCallback     = NULL;
+                pUserData     = NULL;
+                retCode       = ERROR_SUCCESS;
+                speechLength  = 0;
+                submitTime    = 0;
+                cancelled     = false;
+                for (int i = 0; i < NUM_STAGES; i++)
+                    latency[i] = 0;
+            }
+
+            CTTSStatistics::CTTSStatistics()
+            {
+                clear();
+            }
+
+            void CTTSStatistics::add(const double latency[CTTSRequest::NUM_STAGES])
+            {
+                for (int i = 0; i < CTTSRequest::NUM_STAGES; i++)
+                {
+                    if (samples[i].size() < MAX_SAMPLES)
+                        samples[i].push_back(latency[i]);
+                    else
+                        samples[i][nextSample] = latency[i];
+                }
+                nextSample = (nextSample + 1) % MAX_SAMPLES;
+            }
+
+            double CTTSStatistics::percentile(CTTSRequest::EStage stage, double percent) const
+            {
+                if (samples[stage].empty())
+                    return 0;
+
+                // nearest rank on a copy, the samples are kept in order of completion
+                std::vector<double> sorted(samples[stage]);
+                size_t rank = (size_t)(percent / 100 * (sorted.size() - 1) + 0.5);
+                if (rank >= sorted.size())
+                    rank = sorted.size() - 1;
+                std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+                return sorted[rank];
+            }
+
+            void CTTSStatistics::clear()
+            {
+                numCompleted = 0;
+                numFailed    = 0;
+                numCancelled = 0;
+                numRejected  = 0;
+                nextSample   = 0;
+                for (int i = 0; i < CTTSRequest::NUM_STAGES; i++)
+                    samples[i].clear();
+            }
+
+
+            //////////////////////////////////////////////////////////////////////////
+            //
+            //  TTS service
+            //
+            //////////////////////////////////////////////////////////////////////////
+
+            CTTSService::CTTSService()
+            {
+                initialized = false;
+                stopping    = false;
+                cache       = NULL;
+                numPending  = 0;
+                maxPending  = 0;
+            }
+
+            CTTSService::~CTTSService()
+            {
+                terminate();
+            }
+
+            int CTTSService::initialize(const wchar_t *configFile, int numWorkers, size_t maxPending)
+            {
+                // close service first if initialized
+                terminate();
+
+                // the voice data are loaded once for all workers
+                int retCode = synthesizer.initialize(configFile);
+                if (retCode != ERROR_SUCCESS)
+                    return retCode;
+
+                // the results of different voices are kept apart in the cache
+                DataConfig dataConfig;
+                synthesizer.getDataConfig(dataConfig);
+                voiceIdentity = dataConfig.wstrLangTag + L"|" + dataConfig.wstrLexiconPath + L"|" + dataConfig.wstrVoicePath;
+
+                if (numWorkers <= 0)
+                    numWorkers = cmn::CThread::getProcessorNumber();
+                this->maxPending = (maxPending > 0) ? maxPending : 1;
+                stopping = false;
+                statistics.clear();
+
+                // the text parser keeps intermediate results in its modules, hence each worker has its own one
+                for (int i = 0; i < numWorkers; i++)
+                {
+                    CWorker *pWorker = new CWorker(*this);
+                    retCode = pWorker->textParser.initialize(configFile);
+                    if (retCode != ERROR_SUCCESS)
+                    {
+                        delete pWorker;
+                        break;
+                    }
+                    workers.push_back(pWorker);
+                }
+
+                initialized = true;
+                if (retCode != ERROR_SUCCESS)
+                {
+                    terminate();
+                    return retCode;
+                }
+
+                for (size_t i = 0; i < workers.size(); i++)
+                {
+                    if (!workers[i]->start())
+                    {
+                        terminate();
+                        return ERROR_NOT_INITIALIZED;
+                    }
+                }
+                return ERROR_SUCCESS;
+            }
+
+            int CTTSService::terminate()
+            {
+                if (!initialized)
+                    return ERROR_SUCCESS;
+
+                // stop the workers after the requests being processed
+                mutex.lock();
+                stopping = true;
+                notEmpty.broadcast();
+                notFull.broadcast();
+                mutex.unlock();
+
+                for (size_t i = 0; i < workers.size(); i++)
+                {
+                    workers[i]->join();
+                    workers[i]->textParser.terminate();
+                    delete workers[i];
+                }
+                workers.clear();
+
+                // cancel the pending requests
+                std::vector<CTTSRequest*> pending;
+                mutex.lock();
+                for (int i = CTTSRequest::NUM_PRIORITIES - 1; i >= 0; i--)
+                {
+                    pending.insert(pending.end(), queues[i].begin(), queues[i].end());
+                    queues[i].clear();
+                }
+                numPending = 0;
+                mutex.unlock();
+                for (size_t i = 0; i < pending.size(); i++)
+                    complete(*pending[i], ERROR_OPERATION_ABORTED);
+
+                initialized = false;
+                return synthesizer.terminate();
+            }
+
+            int CTTSService::submit(CTTSRequest &request, long timeout)
+            {
+                if (!initialized)
+                    return ERROR_NOT_INITIALIZED;
+                if (request.pCallback == NULL || request.priority < 0 || request.priority >= CTTSRequest::NUM_PRIORITIES)
+                    return ERROR_INVALID_PARAMETER;
+
+                request.retCode      = ERROR_SUCCESS;
+                request.speechLength = 0;
+                request.speech.clear();
+                for (int i = 0; i < CTTSRequest::NUM_STAGES; i++)
+                    request.latency[i] = 0;
+                request.cancelled  = false;
+                request.submitTime = getWallTime();
+
+                cmn::CAutoLock lock(mutex);
+
+                // backpressure: wait until there is room in the queue, or reject the request
+                double deadline = request.submitTime + timeout / 1000.0;
+                while (numPending >= maxPending && !stopping)
+                {
+                    long remain = -1;
+                    if (timeout >= 0)
+                        remain = (long)((deadline - getWallTime()) * 1000);
+                    if (timeout >= 0 && remain <= 0)
+                    {
+                        statistics.numRejected++;
+                        return ERROR_SERVICE_BUSY;
+                    }
+                    notFull.wait(mutex, remain);
+                }
+                if (stopping)
+                    return ERROR_OPERATION_ABORTED;
+
+                queues[request.priority].push_back(&request);
+                numPending++;
+                notEmpty.signal();
+                return ERROR_SUCCESS;
+            }
+
+            void CTTSService::cancel(CTTSRequest &request)
+            {
+                mutex.lock();
+                if (request.priority >= 0 && request.priority < CTTSRequest::NUM_PRIORITIES)
+                {
+                    std::deque<CTTSRequest*> &queue = queues[request.priority];
+                    std::deque<CTTSRequest*>::iterator it = std::find(queue.begin(), queue.end(), &request);
+                    if (it != queue.end())
+                    {
+                        // the pending request is finished at once
+                        queue.erase(it);
+                        numPending--;
+                        notFull.signal();
+                        mutex.unlock();
+                        complete(request, ERROR_OPERATION_ABORTED);
+                        return;
+                    }
+                }
+                // the request being processed is stopped by the worker
+                request.cancelled = true;
+                mutex.unlock();
+            }
+
+            void CTTSService::setCache(CSynthCache *pCache)
+            {
+                cache = pCache;
+            }
+
+            size_t CTTSService::getPendingNumber()
+            {
+                cmn::CAutoLock lock(mutex);
+                return numPending;
+            }
+
+            void CTTSService::getStatistics(CTTSStatistics &statistics)
+            {
+                cmn::CAutoLock lock(mutex);
+                statistics = this->statistics;
+            }
+
+            int CTTSService::getWaveFormat(ushort& nChannels, ushort& nBitsPerSample, ulong& nSamplesPerSec)
+            {
+                return synthesizer.getWaveFormat(nChannels, nBitsPerSample, nSamplesPerSec);
+            }
+
+            CTTSRequest *CTTSService::nextRequest()
+            {
+                cmn::CAutoLock lock(mutex);
+                while (numPending == 0 && !stopping)
+                    notEmpty.wait(mutex);
+                if (stopping)
+                    return NULL;
+
+                // higher priority first, and then first come first served
+                for (int i = CTTSRequest::NUM_PRIORITIES - 1; i >= 0; i--)
+                {
+                    if (!queues[i].empty())
+                    {
+                        CTTSRequest *pRequest = queues[i].front();
+                        queues[i].pop_front();
+                        numPending--;
+                        notFull.signal();
+                        return pRequest;
+                    }
+                }
+                return NULL;
+            }
+
+            bool CTTSService::isCancelled(CTTSRequest &request)
+            {
+                cmn::CAutoLock lock(mutex);
+                return request.cancelled;
+            }
+
+            void CTTSService::processRequest(CTTSRequest &request, CTextParser &textParser)
+            {
+                double startTime = getWallTime();
+                request.latency[CTTSRequest::STAGE_QUEUE] = startTime - request.submitTime;
+                if (isCancelled(request))
+                {
+                    complete(request, ERROR_OPERATION_ABORTED);
+                    return;
+                }
+
+                // the speech of repeated prompt is returned from the cache at once
+                std::wstring wstrKey;
+                bool useCache = (cache != NULL) && composeCacheKey(request, textParser, wstrKey);
+                std::vector<unsigned char> cachedSpeech;
+                if (useCache && cache->getSpeech(wstrKey, request.setting, cachedSpeech))
+                {
+                    request.latency[CTTSRequest::STAGE_TEXT]  = 0;
+                    request.latency[CTTSRequest::STAGE_SYNTH] = getWallTime() - startTime;
+                    complete(request, outputSpeech(request, cachedSpeech.empty() ? NULL : &cachedSpeech[0], (unsigned long)cachedSpeech.size()));
+                    return;
+                }
+
+                // text analysis, with the typed utterance if the input can be represented by it,
+                // the cached utterance is analyzed with the default settings, which are applied by the wave synthesizer
+                CUtterance utterance;
+                xml::CSSMLDocument ssmlDocument;
+                TTSSetting defaultSetting;
+                bool analyzed = useCache && cache->getUtterance(wstrKey, utterance);
+                bool useDocument = false;
+                int retCode = ERROR_SUCCESS;
+                if (!analyzed)
+                {
+                    retCode = textParser.process(request.wstrText.c_str(), request.inputTextType, utterance, useCache ? defaultSetting : request.setting);
+                    useDocument = (retCode == ERROR_INVALID_SSML_DOCUMENT);
+                    if (useDocument)
+                        retCode = textParser.process(request.wstrText.c_str(), request.inputTextType, ssmlDocument, request.setting);
+                }
+                double textTime = getWallTime();
+                request.latency[CTTSRequest::STAGE_TEXT] = textTime - startTime;
+                if (retCode != ERROR_SUCCESS || isCancelled(request))
+                {
+                    complete(request, (retCode != ERROR_SUCCESS) ? retCode : ERROR_OPERATION_ABORTED);
+                    return;
+                }
+
+                // speech synthesis, the sink of streaming request passes the speech piece by piece and checks cancellation,
+                // the whole speech is synthesized without sink, as the streaming synthesis is approximated by chunks
+                dsp::CWaveData waveData;
+                CServiceWaveSink waveSink(*this, request);
+                dsp::CWaveSink *pWaveSink = request.streaming ? &waveSink : NULL;
+                if (useDocument)
+                    retCode = synthesizer.process(ssmlDocument, waveData, request.setting, pWaveSink);
+                else
+                {
+                    if (!analyzed)
+                    {
+                        retCode = synthesizer.unitSegment(utterance);
+                        if (retCode == ERROR_SUCCESS)
+                            retCode = synthesizer.prosodyPredict(utterance);
+                        if (retCode == ERROR_SUCCESS && useCache)
+                            cache->putUtterance(wstrKey, utterance);
+                    }
+                    if (retCode == ERROR_SUCCESS)
+                        retCode = synthesizer.waveSynthesize(utterance, waveData, request.setting, pWaveSink);
+                }
+                request.latency[CTTSRequest::STAGE_SYNTH] = getWallTime() - textTime;
+                request.speechLength = waveData.getLength();
+                if (retCode != ERROR_SUCCESS || isCancelled(request))
+                {
+                    complete(request, (retCode != ERROR_SUCCESS) ? retCode : ERROR_OPERATION_ABORTED);
+                    return;
+                }
+
+                // only the whole speech is cached, which differs slightly from the speech synthesized by chunks
+                if (!request.streaming)
+                {
+                    if (useCache)
+                        cache->putSpeech(wstrKey, request.setting, waveData.getData(), waveData.getLength());
+                    outputSpeech(request, waveData.getData(), waveData.getLength());
+                }
+                complete(request, ERROR_SUCCESS);
+            }
+
+            bool CTTSService::composeCacheKey(CTTSRequest &request, CTextParser &textParser, std::wstring &wstrKey)
+            {
+                // the text is pre-processed without the settings, which are compared separately
+                xml::CSSMLDocument ssmlDocument;
+                TTSSetting defaultSetting;
+                if (textParser.preProcess(&ssmlDocument, request.wstrText, request.inputTextType, defaultSetting) != ERROR_SUCCESS ||
+                    textParser.langConvert(&ssmlDocument) != ERROR_SUCCESS)
+                    return false;
+
+                std::wostringstream text;
+                ssmlDocument.print(text);
+                CSynthCache::composeKey(voiceIdentity, text.str(), wstrKey);
+                return true;
+            }
+
+            int CTTSService::outputSpeech(CTTSRequest &request, const unsigned char *pData, unsigned long nByteLen)
+            {
+                request.speechLength = nByteLen;
+                if (request.streaming)
+                {
+                    CServiceWaveSink waveSink(*this, request);
+                    if (nByteLen > 0 && !waveSink.write(pData, nByteLen))
+                        return ERROR_OPERATION_ABORTED;
+                    return ERROR_SUCCESS;
+                }
+
+                request.speech.clear();
+                if (request.outputFormat == CTTSRequest::OUTPUT_WAV)
+                {
+                    dsp::CWaveData waveFormat;
+                    ushort nChannels, nBitsPerSample;
+                    ulong  nSamplesPerSec;
+                    synthesizer.getWaveFormat(nChannels, nBitsPerSample, nSamplesPerSec);
+                    waveFormat.setFormat(nSamplesPerSec, nBitsPerSample, nChannels);
+                    composeWaveHeader(waveFormat, nByteLen, request.speech);
+                }
+                request.speech.insert(request.speech.end(), pData, pData + nByteLen);
+                return ERROR_SUCCESS;
+            }
+
+            void CTTSService::complete(CTTSRequest &request, int retCode)
+            {
+                request.retCode = retCode;
+                request.latency[CTTSRequest::STAGE_TOTAL] = getWallTime() - request.submitTime;
+                if (!request.streaming || request.latency[CTTSRequest::STAGE_FIRST_SPEECH] == 0)
+                    request.latency[CTTSRequest::STAGE_FIRST_SPEECH] = request.latency[CTTSRequest::STAGE_TOTAL];
+
+                mutex.lock();
+                if (retCode == ERROR_SUCCESS)
+                {
+                    statistics.numCompleted++;
+                    statistics.add(request.latency);
+                }
+                else if (retCode == ERROR_OPERATION_ABORTED)
+                    statistics.numCancelled++;
+                else
+                    statistics.numFailed++;
+                mutex.unlock();
+
+                // the request may be deleted by the callback
+                request.pCallback->onComplete(request);
+            }
+
+            void CTTSService::CWorker::run()
+            {
+                CTTSRequest *pRequest;
+                while ((pRequest = service.nextRequest()) != NULL)
+                    service.processRequest(*pRequest, textParser);
+            }
+
+        }//namespace base
+    }
+}
@@ -0,0 +1,367 @@
+//
+//  Crystal Text-to-Speech Engine
+//
+//  Copyright (c) 2007 THU-CUHK Joint Research Center for
+//  Media Sciences, Technologies and Systems. All rights reserved.
+//
+//  http://mjrc.sz.tsinghua.edu.cn
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, is not allowed, unless a valid written license is
+//  granted by THU-CUHK Joint Research Center.
+//
+//  THU-CUHK Joint Research Center has the rights to create, modify,
+//  copy, compile, remove, rename, explain and deliver the source codes.
+//
+
+
+///
+/// @file
+///
+/// @brief  Head file defining the multi-threaded service interfaces for Text-to-Speech (TTS) engine
+///
+/// <b>History:</b>
+/// - Version:  0.1.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Shared the text data by all workers
+/// - Version:  0.1.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the cache of synthesis results
+///
+
+#ifndef _CST_TTS_BASE_TTS_SERVICE_H_
+#define _CST_TTS_BASE_TTS_SERVICE_H_
+
+#include <deque>
+#include <vector>
+#include "cmn/cmn_thread.h"
+#include "ttsbase/tts.text/tts_textparser.h"
+#include "ttsbase/tts.synth/tts_synthesizer.h"
+#include "tts_cache.h"
+
+namespace cst
+{
+    namespace tts
+    {
+        namespace base
+        {
+            class CTTSRequest;
+
+            ///
+            /// @brief  The interface for receiving the result of a TTS request
+            ///
+            /// The procedures are called in the worker thread processing the request.
+            ///
+            class CTTSCallback
+            {
+            public:
+                ///
+                /// @brief  Destructor
+                ///
+                virtual ~CTTSCallback() {}
+
+                ///
+                /// @brief  Receive a piece of synthetic speech of a streaming request as soon as it is available
+                ///
+                /// The speech is in the output format of the request, i.e. the WAV header is passed first for WAV output.
+                ///
+                /// @param  [in] request    The request being processed
+                /// @param  [in] pData      The new piece of speech
+                /// @param  [in] nByteLen   The length of the new speech (in byte)
+                ///
+                /// @return Whether to continue synthesis, return false to cancel the request
+                ///
+                virtual bool onSpeech(CTTSRequest &request, const unsigned char *pData, unsigned long nByteLen) {return true;}
+
+                ///
+                /// @brief  Called once when the request is finished (completed, failed or cancelled)
+                ///
+                /// The request is no longer used by the service after this call, hence it can be deleted here.
+                ///
+                /// @param  [in] request    The finished request, see CTTSRequest::retCode for the result
+                ///
+                virtual void onComplete(CTTSRequest &request) = 0;
+            };
+
+            ///
+            /// @brief  A text-to-speech request processed by the TTS service
+            ///
+            /// The request is created by the caller, and should be kept until CTTSCallback::onComplete() is called.
+            ///
+            class CTTSRequest
+            {
+            public:
+                /// Priorities of request, requests with higher priority are processed first
+                enum EPriority
+                {
+                    PRIORITY_LOW = 0,
+                    PRIORITY_NORMAL,
+                    PRIORITY_HIGH,
+                    NUM_PRIORITIES
+                };
+
+                /// Formats of synthetic speech
+                enum EOutputFormat
+                {
+                    OUTPUT_PCM = 0,             ///< Raw PCM samples
+                    OUTPUT_WAV,                 ///< PCM samples with RIFF WAV header
+                };
+
+                /// Stages of request processing for measuring latency
+                enum EStage
+                {
+                    STAGE_QUEUE = 0,            ///< Waiting in the queue
+                    STAGE_TEXT,                 ///< Text analysis
+                    STAGE_SYNTH,                ///< Speech synthesis
+                    STAGE_FIRST_SPEECH,         ///< From submitting to the first piece of speech
+                    STAGE_TOTAL,                ///< From submitting to completion
+                    NUM_STAGES
+                };
+
+            public:
+                std::wstring    wstrText;           ///< The text to be synthesized
+                EInputTextType  inputTextType;      ///< Type of the input text, DEF [ITT_TEXT_RAW]
+                TTSSetting      setting;            ///< Settings (rate, volume, pitch, streaming chunk size, ...) of the request
+                EPriority       priority;           ///< Priority of the request, DEF [PRIORITY_NORMAL]
+                EOutputFormat   outputFormat;       ///< Format of the synthetic speech, DEF [OUTPUT_PCM]
+                bool            streaming;          ///< Synthesize by chunks and pass the speech to CTTSCallback::onSpeech() piece by piece, or return the whole speech in speech, DEF [false]
+                CTTSCallback   *pCallback;          ///< The callback receiving the result
+                void           *pUserData;          ///< Data of the caller, not used by the service
+
+            public:
+                int             retCode;            ///< Result of the request, ERROR_OPERATION_ABORTED if cancelled
+                std::vector<unsigned char> speech;  ///< The whole synthetic speech in output format, empty for streaming request
+                unsigned long   speechLength;       ///< Length of the synthetic speech (in byte, without WAV header)
+                double          latency[NUM_STAGES];///< Latency of each stage (in second)
+
+            public:
+                ///
+                /// @brief  Constructor
+                ///
+                CTTSRequest();
+
+            protected:
+                friend class CTTSService;
+                friend class CServiceWaveSink;
+                double          submitTime;         ///< Time of submitting the request
+                bool            cancelled;          ///< Whether the request is cancelled, accessed with the service locked
+            };
+
+            ///
+            /// @brief  Latency statistics of the requests processed by the TTS service
+            ///
+            /// The latencies of the most recent requests (at most MAX_SAMPLES) are kept for percentiles.
+            ///
+            class CTTSStatistics
+            {
+            public:
+                static const size_t MAX_SAMPLES = 10000;
+
+                unsigned long   numCompleted;       ///< Number of requests completed successfully
+                unsigned long   numFailed;          ///< Number of requests failed
+                unsigned long   numCancelled;       ///< Number of requests cancelled
+                unsigned long   numRejected;        ///< Number of requests rejected because of full queue
+
+            public:
+                ///
+                /// @brief  Constructor
+                ///
+                CTTSStatistics();
+
+                ///
+                /// @brief  Add the latencies of a completed request
+                ///
+                void add(const double latency[CTTSRequest::NUM_STAGES]);
+
+                ///
+                /// @brief  Get the percentile of latency of a stage
+                ///
+                /// @param  [in] stage      The stage of request processing
+                /// @param  [in] percent    The percent in [0, 100], e.g. 50 for median, 99 for tail latency
+                ///
+                /// @return The latency (in second), 0 if no request is completed
+                ///
+                double percentile(CTTSRequest::EStage stage, double percent) const;
+
+                ///
+                /// @brief  Clear all statistics
+                ///
+                void clear();
+
+            protected:
+                std::vector<double> samples[CTTSRequest::NUM_STAGES];   ///< Latencies of recent requests (circular buffer)
+                size_t nextSample;                                      ///< Position for next sample in circular buffer
+            };
+
+            ///
+            /// @brief  The multi-threaded service processing TTS requests with a pool of workers
+            ///
+            /// The text and voice data are loaded once and shared by all workers (see CDrivenData),
+            /// each worker keeps its own text parser for the intermediate results of text analysis.
+            /// Requests are put into a bounded queue by any thread, and processed by the workers in the
+            /// order of priority and then submission. When the queue is full, submit() waits or fails
+            /// with ERROR_SERVICE_BUSY (backpressure), so the caller can shed load instead of piling up latency.
+            /// An optional cache (see CSynthCache) returns the speech of repeated prompts without synthesis.
+            ///
+            class CTTSService
+            {
+            public:
+                ///
+                /// @brief  Constructor
+                ///
+                CTTSService();
+
+                ///
+                /// @brief  Destructor
+                ///
+                virtual ~CTTSService();
+
+                ///
+                /// @brief  Initialize the TTS engine and start the workers
+                ///
+                /// @param  [in] configFile     Configuration file for initializing TTS engine
+                /// @param  [in] numWorkers     Number of worker threads, 0 for number of processors
+                /// @param  [in] maxPending     Maximum number of requests waiting in the queue
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                ///
+                virtual int initialize(const wchar_t *configFile, int numWorkers, size_t maxPending);
+
+                ///
+                /// @brief  Stop the workers after the requests being processed, cancel the pending requests, and close the TTS engine
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                ///
+                virtual int terminate();
+
+                ///
+                /// @brief  Submit a request to the queue
+                ///
+                /// @param  [in] request    The request to be processed, kept until CTTSCallback::onComplete() is called
+                /// @param  [in] timeout    Maximum time to wait (in millisecond) when the queue is full,
+                ///                         0 for returning immediately, negative for waiting infinitely
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The request is queued, onComplete() will be called
+                /// @retval ERROR_SERVICE_BUSY The queue is full, onComplete() will NOT be called
+                ///
+                virtual int submit(CTTSRequest &request, long timeout = 0);
+
+                ///
+                /// @brief  Cancel a submitted request
+                ///
+                /// The pending request is removed from the queue, and the request being processed is stopped
+                /// after current stage (or current piece of speech for streaming request). onComplete() is called
+                /// with ERROR_OPERATION_ABORTED, unless the request has been completed.
+                ///
+                /// @param  [in] request    The request to be cancelled, which should not be deleted by onComplete() yet
+                ///
+                virtual void cancel(CTTSRequest &request);
+
+                ///
+                /// @brief  Set the cache of synthesis results used by the workers
+                ///
+                /// The cache should be set before submitting requests, and kept until the service is terminated.
+                /// It can be shared by the services of different voices, as the results are keyed by the voice.
+                ///
+                /// @param  [in] pCache     The cache of synthesis results, NULL for not using cache
+                ///
+                void setCache(CSynthCache *pCache);
+
+                ///
+                /// @brief  Get the number of requests waiting in the queue
+                ///
+                size_t getPendingNumber();
+
+                ///
+                /// @brief  Get the latency statistics of the processed requests
+                ///
+                void getStatistics(CTTSStatistics &statistics);
+
+                ///
+                /// @brief  Get the format of the synthetic speech
+                ///
+                int getWaveFormat(ushort& nChannels, ushort& nBitsPerSample, ulong& nSamplesPerSec);
+
+            protected:
+                ///
+                /// @brief  The worker thread processing requests with its own text parser
+                ///
+                class CWorker : public cmn::CThread
+                {
+                public:
+                    CWorker(CTTSService &owner) : service(owner) {}
+                protected:
+                    virtual void run();
+                public:
+                    CTTSService &service;       ///< The service owning the worker
+                    CTextParser textParser;     ///< Text parser of the worker
+                };
+
+                ///
+                /// @brief  Wait for and take the next request in the order of priority, NULL if the service is stopping
+                ///
+                CTTSRequest *nextRequest();
+
+                ///
+                /// @brief  Process a request by the worker
+                ///
+                virtual void processRequest(CTTSRequest &request, CTextParser &textParser);
+
+                ///
+                /// @brief  Compose the key of the request for looking up the cache from its pre-processed text
+                ///
+                /// @return Whether the key is composed, false if the text can not be pre-processed
+                ///
+                bool composeCacheKey(CTTSRequest &request, CTextParser &textParser, std::wstring &wstrKey);
+
+                ///
+                /// @brief  Pass the speech (PCM samples) to the request in its output format
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                /// @retval ERROR_OPERATION_ABORTED The streaming request is cancelled
+                ///
+                int outputSpeech(CTTSRequest &request, const unsigned char *pData, unsigned long nByteLen);
+
+                ///
+                /// @brief  Finish the request: update statistics, and call the callback
+                ///
+                void complete(CTTSRequest &request, int retCode);
+
+                ///
+                /// @brief  Whether the request is cancelled
+                ///
+                bool isCancelled(CTTSRequest &request);
+
+            protected:
+                friend class CServiceWaveSink;
+
+                bool initialized;                                           ///< Whether the service is initialized
+                bool stopping;                                              ///< Whether the workers are to be stopped
+                CSynthesizer synthesizer;                                   ///< Synthesizer shared by all workers
+                CSynthCache *cache;                                         ///< Cache of synthesis results, NULL if not used
+                std::wstring voiceIdentity;                                 ///< Identity of the voice for the cache keys
+                std::vector<CWorker*> workers;                              ///< The worker threads
+                std::deque<CTTSRequest*> queues[CTTSRequest::NUM_PRIORITIES];   ///< Pending requests of each priority
+                size_t numPending;                                          ///< Number of pending requests
+                size_t maxPending;                                          ///< Maximum number of pending requests
+                CTTSStatistics statistics;                                  ///< Latency statistics
+                cmn::CMutex mutex;                                          ///< Mutex for the queue, cancellation and statistics
+                cmn::CCondition notEmpty;                                   ///< Signaled when a request is queued or stopping
+                cmn::CCondition notFull;                                    ///< Signaled when a request is taken from the queue
+            };
+
+        }//namespace base
+    }
+}
+
+#endif//_CST_TTS_BASE_TTS_SERVICE_H_
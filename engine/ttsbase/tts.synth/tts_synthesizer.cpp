@@ -28,6 +28,26 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2007/11/16
 ///   Changed:  Implemented the framework and basic interfaces
+/// - Version:  0.2.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the settings of each request, kept the default settings in the synthesizer instead of the data manager
+/// - Version:  0.2.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Shared the voice data of the same configuration by the global driven data manager
+/// - Version:  0.2.3
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the data configuration for identifying the voice
+/// - Version:  0.2.4
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the trace of the latency of each processing stage
 ///
 
 #include "tts_synthesizer.h"
@@ -36,6 +56,7 @@
 #include "../synthesize/unitseg_unitsegment.h"
 #include "../synthesize/psp_prosodypredict.h"
 #include "../synthesize/synth_synthesize.h"
+#include "cmn/cmn_trace.h"
 #include <iostream>
 
 namespace cst
@@ -51,6 +72,7 @@ namespace cst
                 unitSegmentor       = NULL;
                 prosodyPredictor    = NULL;
                 waveSynthesizer     = NULL;
+                trace               = NULL;
 
                 initialized   = false;
             }
@@ -84,21 +106,37 @@ namespace cst
                     std::wcout << str::mbstowcs(modules["CSynthesize"].name) << std::endl;
                 }
 
-                // initialize modules
-                dataManager = dynamic_cast<CVoiceData*>(modules["CVoiceData"].createDataMan(dataConfig));
+                // initialize modules, the voice data are loaded once and shared by the synthesizers with the same configuration
+                CDataManager *pDataManager = CDrivenData::initDataManager(modules["CVoiceData"], dataConfig);
+                dataManager = dynamic_cast<const CVoiceData*>(pDataManager);
                 if (dataManager == NULL)
                 {
+                    CDrivenData::freeDataManager(pDataManager);
                     initialized = false;
                     return ERROR_OPEN_FAILED;
                 }
                 unitSegmentor    = dynamic_cast<CUnitSegment*>(modules["CUnitSegment"].createModule(dataManager));
                 prosodyPredictor = dynamic_cast<CProsodyPredict*>(modules["CProsodyPredict"].createModule(dataManager));
                 waveSynthesizer  = dynamic_cast<CSynthesize*>(modules["CSynthesize"].createModule(dataManager));
+                defaultSetting   = dataManager->getGlobalSetting();
 
                 initialized = true;
+                setTrace(trace);
                 return ERROR_SUCCESS;
             }
 
+            void CSynthesizer::setTrace(cmn::CTrace *pTrace)
+            {
+                trace = pTrace;
+                if (!initialized)
+                    return;
+
+                // the modules may record the spans of their own steps
+                unitSegmentor->setTrace(pTrace);
+                prosodyPredictor->setTrace(pTrace);
+                waveSynthesizer->setTrace(pTrace);
+            }
+
             int CSynthesizer::terminate()
             {
                 if (!initialized)
@@ -109,8 +147,8 @@ namespace cst
                 modules["CProsodyPredict"].deleteModule(prosodyPredictor);
                 modules["CSynthesize"].deleteModule(waveSynthesizer);
 
-                // free the data manager
-                modules["CVoiceData"].deleteDataMan(dataManager);
+                // free the data manager, which is deleted when not used by other synthesizers
+                CDrivenData::freeDataManager(dataManager);
 
                 // reset modules
                 dataManager         = NULL;
@@ -127,7 +165,7 @@ namespace cst
                 if (!initialized)
                     return ERROR_NOT_INITIALIZED;
 
-                setting = dataManager->getGlobalSetting();
+                setting = defaultSetting;
                 return ERROR_SUCCESS;
             }
 
@@ -136,9 +174,7 @@ namespace cst
                 if (!initialized)
                     return ERROR_NOT_INITIALIZED;
 
-                // cast to non-const
-                CDataManager* pDataManager = (CDataManager*)dataManager;
-                pDataManager->getGlobalSetting() = setting;
+                defaultSetting = setting;
                 return ERROR_SUCCESS;
             }
 
@@ -156,11 +192,42 @@ namespace cst
                 return ERROR_SUCCESS;
             }
 
+            int CSynthesizer::getDataConfig(DataConfig &dataConfig)
+            {
+                if (!initialized)
+                    return ERROR_NOT_INITIALIZED;
+
+                dataConfig = dataManager->getDataConfig();
+                return ERROR_SUCCESS;
+            }
+
             int CSynthesizer::process(xml::CSSMLDocument &ssmlDocument, dsp::CWaveData &waveData)
+            {
+                return process(ssmlDocument, waveData, defaultSetting, NULL);
+            }
+
+            int CSynthesizer::process(xml::CSSMLDocument &ssmlDocument, dsp::CWaveData &waveData, dsp::CWaveSink &waveSink)
+            {
+                return process(ssmlDocument, waveData, defaultSetting, &waveSink);
+            }
+
+            int CSynthesizer::process(CUtterance &utterance, dsp::CWaveData &waveData)
+            {
+                return process(utterance, waveData, defaultSetting, NULL);
+            }
+
+            int CSynthesizer::process(CUtterance &utterance, dsp::CWaveData &waveData, dsp::CWaveSink &waveSink)
+            {
+                return process(utterance, waveData, defaultSetting, &waveSink);
+            }
+
+            int CSynthesizer::process(xml::CSSMLDocument &ssmlDocument, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink)
             {
                 if (!initialized)
                     return ERROR_NOT_INITIALIZED;
 
+                CST_TRACE_SPAN(trace, "synthesize");
+
                 // clear data first
                 waveData.clear();
 
@@ -177,27 +244,84 @@ namespace cst
                 if (retCode != ERROR_SUCCESS)
                     return retCode;
 
-                // speech synthesize
-                retCode = waveSynthesize(pDocument, waveData);
+                // speech synthesize, passing wave data to sink incrementally if needed
+                retCode = waveSynthesize(pDocument, waveData, setting, waveSink);
                 if (retCode != ERROR_SUCCESS)
                     return retCode;
 
                 return ERROR_SUCCESS;
             }
 
+            int CSynthesizer::process(CUtterance &utterance, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink)
+            {
+                if (!initialized)
+                    return ERROR_NOT_INITIALIZED;
+
+                CST_TRACE_SPAN(trace, "synthesize");
+
+                // clear data first
+                waveData.clear();
+
+                // unit segment
+                int retCode = unitSegment(utterance);
+                if (retCode != ERROR_SUCCESS)
+                    return retCode;
+
+                // prosodic prediction
+                retCode = prosodyPredict(utterance);
+                if (retCode != ERROR_SUCCESS)
+                    return retCode;
+
+                // speech synthesize, passing wave data to sink incrementally if needed
+                return waveSynthesize(utterance, waveData, setting, waveSink);
+            }
+
             int CSynthesizer::unitSegment(xml::CSSMLDocument *pSSMLDocument)
             {
+                CST_TRACE_SPAN(trace, "unitSegment");
                 return unitSegmentor->process(pSSMLDocument);
             }
 
             int CSynthesizer::prosodyPredict(xml::CSSMLDocument *pSSMLDocument)
             {
+                CST_TRACE_SPAN(trace, "prosodyPredict");
                 return prosodyPredictor->process(pSSMLDocument);
             }
 
-            int CSynthesizer::waveSynthesize(xml::CSSMLDocument *pSSMLDocument, dsp::CWaveData &waveData)
+            int CSynthesizer::waveSynthesize(xml::CSSMLDocument *pSSMLDocument, dsp::CWaveData &waveData, dsp::CWaveSink *waveSink)
+            {
+                CST_TRACE_SPAN(trace, "waveSynthesize");
+                return waveSynthesizer->process(pSSMLDocument, waveData, defaultSetting, waveSink);
+            }
+
+            int CSynthesizer::waveSynthesize(xml::CSSMLDocument *pSSMLDocument, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink)
+            {
+                CST_TRACE_SPAN(trace, "waveSynthesize");
+                return waveSynthesizer->process(pSSMLDocument, waveData, setting, waveSink);
+            }
+
+            int CSynthesizer::unitSegment(CUtterance &utterance)
+            {
+                CST_TRACE_SPAN(trace, "unitSegment");
+                return unitSegmentor->process(utterance);
+            }
+
+            int CSynthesizer::prosodyPredict(CUtterance &utterance)
+            {
+                CST_TRACE_SPAN(trace, "prosodyPredict");
+                return prosodyPredictor->process(utterance);
+            }
+
+            int CSynthesizer::waveSynthesize(CUtterance &utterance, dsp::CWaveData &waveData, dsp::CWaveSink *waveSink)
+            {
+                CST_TRACE_SPAN(trace, "waveSynthesize");
+                return waveSynthesizer->process(utterance, waveData, defaultSetting, waveSink);
+            }
+
+            int CSynthesizer::waveSynthesize(CUtterance &utterance, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink)
             {
-                return waveSynthesizer->process(pSSMLDocument, waveData);
+                CST_TRACE_SPAN(trace, "waveSynthesize");
+                return waveSynthesizer->process(utterance, waveData, setting, waveSink);
             }
 
 
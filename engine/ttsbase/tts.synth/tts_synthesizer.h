@@ -28,6 +28,26 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2007/11/16
 ///   Changed:  Implemented the framework and basic interfaces
+/// - Version:  0.2.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the settings of each request, kept the default settings in the synthesizer instead of the data manager
+/// - Version:  0.2.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Shared the voice data of the same configuration by the global driven data manager
+/// - Version:  0.2.3
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the data configuration for identifying the voice
+/// - Version:  0.2.4
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the trace of the latency of each processing stage
 ///
 
 #ifndef _CST_TTS_BASE_TTS_SYNTHESIZER_H_
@@ -40,8 +60,9 @@
 
 namespace cst
 {
-    namespace dsp {class CWaveData;}
+    namespace dsp {class CWaveData; class CWaveSink;}
     namespace xml {class CSSMLDocument;}
+    namespace cmn {class CTrace;}
 
     namespace tts
     {
@@ -55,6 +76,7 @@ namespace cst
             class CUnitSegment;
             class CProsodyPredict;
             class CSynthesize;
+            class CUtterance;
 
 
             ///
@@ -108,6 +130,87 @@ namespace cst
                 ///
                 virtual int process(xml::CSSMLDocument &ssmlDocument, dsp::CWaveData &waveData);
 
+                ///
+                /// @brief  Performing streaming speech synthesis: synthesize wave data according to input SSML document,
+                ///         and pass the wave data to sink piece by piece as soon as it is generated
+                ///
+                /// The first piece of wave data is available before the whole document is synthesized,
+                /// which reduces the latency for playing the synthetic speech.
+                ///
+                /// @param  [in]  ssmlDocument  SSML document containing the related information for speech synthesis
+                /// @param  [out] ssmlDocument  Return the SSML document containing the related information of synthetic result
+                /// @param  [out] waveData      Return the whole synthetic wave data
+                /// @param  [in]  waveSink      The wave sink to receive the synthetic wave data incrementally
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                /// @retval ERROR_OPERATION_ABORTED The operation is aborted by the wave sink
+                ///
+                virtual int process(xml::CSSMLDocument &ssmlDocument, dsp::CWaveData &waveData, dsp::CWaveSink &waveSink);
+
+                ///
+                /// @brief  Performing speech synthesis: synthesize wave data according to input typed utterance
+                ///
+                /// The utterance is passed from module to module without SSML document traversing and rewriting.
+                ///
+                /// @param  [in]  utterance     Utterance containing the related information for speech synthesis
+                /// @param  [out] utterance     Return the utterance containing the related information of synthetic result
+                /// @param  [out] waveData      Return the synthetic wave data
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                ///
+                virtual int process(CUtterance &utterance, dsp::CWaveData &waveData);
+
+                ///
+                /// @brief  Performing streaming speech synthesis according to input typed utterance,
+                ///         and pass the wave data to sink piece by piece as soon as it is generated
+                ///
+                /// @param  [in]  utterance     Utterance containing the related information for speech synthesis
+                /// @param  [out] utterance     Return the utterance containing the related information of synthetic result
+                /// @param  [out] waveData      Return the whole synthetic wave data
+                /// @param  [in]  waveSink      The wave sink to receive the synthetic wave data incrementally
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                /// @retval ERROR_OPERATION_ABORTED The operation is aborted by the wave sink
+                ///
+                virtual int process(CUtterance &utterance, dsp::CWaveData &waveData, dsp::CWaveSink &waveSink);
+
+                ///
+                /// @brief  Performing speech synthesis according to input SSML document with the settings of current request
+                ///
+                /// The settings (e.g. rate, volume, pitch and streaming chunk size) are only used by this call,
+                /// and the shared data are not modified, hence the requests with different settings can be
+                /// processed concurrently by the same synthesizer. The above procedures use the default settings.
+                ///
+                /// @param  [in]  ssmlDocument  SSML document containing the related information for speech synthesis
+                /// @param  [out] ssmlDocument  Return the SSML document containing the related information of synthetic result
+                /// @param  [out] waveData      Return the whole synthetic wave data
+                /// @param  [in]  setting       The settings of current request
+                /// @param  [in]  waveSink      The wave sink to receive the synthetic wave data incrementally, NULL if not needed
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                /// @retval ERROR_OPERATION_ABORTED The operation is aborted by the wave sink
+                ///
+                virtual int process(xml::CSSMLDocument &ssmlDocument, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink = NULL);
+
+                ///
+                /// @brief  Performing speech synthesis according to input typed utterance with the settings of current request
+                ///
+                /// @param  [in]  utterance     Utterance containing the related information for speech synthesis
+                /// @param  [out] utterance     Return the utterance containing the related information of synthetic result
+                /// @param  [out] waveData      Return the whole synthetic wave data
+                /// @param  [in]  setting       The settings of current request
+                /// @param  [in]  waveSink      The wave sink to receive the synthetic wave data incrementally, NULL if not needed
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                /// @retval ERROR_OPERATION_ABORTED The operation is aborted by the wave sink
+                ///
+                virtual int process(CUtterance &utterance, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink = NULL);
+
                 ///
                 /// @brief  Get the format of the synthetic wave result
                 ///
@@ -121,7 +224,17 @@ namespace cst
                 virtual int getWaveFormat(ushort& nChannels, ushort& nBitsPerSample, ulong& nSamplesPerSec);
 
                 ///
-                /// @brief  Get global variables and settings for TTS engine
+                /// @brief  Get the configuration of the data used by the synthesizer, which identifies the voice
+                ///
+                /// @param  [out] dataConfig    Return the data configuration loaded from the configuration file
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                ///
+                virtual int getDataConfig(DataConfig &dataConfig);
+
+                ///
+                /// @brief  Get default settings for the requests processed without their own settings
                 ///
                 /// @return Whether operation is successful
                 /// @retval ERROR_SUCCESS The operation is successful
@@ -130,7 +243,10 @@ namespace cst
 
                 ///
                 ///
-                /// @brief  Set global variables and settings for TTS engine
+                /// @brief  Set default settings for the requests processed without their own settings
+                ///
+                /// @note   The default settings should not be changed during processing,
+                ///         pass the settings with each request for concurrent processing.
                 ///
                 /// @return Whether operation is successful
                 /// @retval ERROR_SUCCESS The operation is successful
@@ -138,10 +254,33 @@ namespace cst
                 ///
                 virtual int setSetting(const TTSSetting& setting);
 
+                ///
+                /// @brief  Set the trace recording the latency of each processing stage, NULL to disable tracing
+                ///
+                /// The spans of the stages (unitSegment, prosodyPredict and waveSynthesize, and the steps of the
+                /// synthesis module if recorded) and the counters of the synthesis module (e.g. labels, frames and
+                /// samples) are added to the trace within the span "synthesize" of each call, and the trace can be
+                /// read after the call. The trace is not synchronized, do not set it when the synthesizer is used
+                /// by several threads concurrently.
+                ///
+                /// @param  [in]  pTrace        The trace to be used by the synthesizer and its modules
+                ///
+                virtual void setTrace(cmn::CTrace *pTrace);
+
+                ///
+                /// @brief  Get the trace recording the latency of each processing stage, NULL if not traced
+                ///
+                cmn::CTrace *getTrace() const {return trace;}
+
             public:
                 int unitSegment(xml::CSSMLDocument *pSSMLDocument);
                 int prosodyPredict(xml::CSSMLDocument *pSSMLDocument);
-                int waveSynthesize(xml::CSSMLDocument *pSSMLDocument, dsp::CWaveData &waveData);
+                int waveSynthesize(xml::CSSMLDocument *pSSMLDocument, dsp::CWaveData &waveData, dsp::CWaveSink *waveSink = NULL);
+                int waveSynthesize(xml::CSSMLDocument *pSSMLDocument, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink = NULL);
+                int unitSegment(CUtterance &utterance);
+                int prosodyPredict(CUtterance &utterance);
+                int waveSynthesize(CUtterance &utterance, dsp::CWaveData &waveData, dsp::CWaveSink *waveSink = NULL);
+                int waveSynthesize(CUtterance &utterance, dsp::CWaveData &waveData, const TTSSetting &setting, dsp::CWaveSink *waveSink = NULL);
 
             protected:
                 ///
@@ -152,14 +291,18 @@ namespace cst
             protected:
                 /// whether engine is initialized
                 bool initialized;
-                /// data manager
-                CVoiceData *dataManager;
+                /// voice data manager, shared by the synthesizers with the same configuration
+                const CVoiceData *dataManager;
                 /// unit segmentation
                 CUnitSegment *unitSegmentor;
                 /// prosodic prediction
                 CProsodyPredict *prosodyPredictor;
                 /// speech synthesize
                 CSynthesize *waveSynthesizer;
+                /// default settings for the requests without their own settings
+                TTSSetting defaultSetting;
+                /// trace of the processing stages, NULL if not traced
+                cmn::CTrace *trace;
             };
 
         }//namespace base
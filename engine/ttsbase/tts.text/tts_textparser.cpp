@@ -28,6 +28,22 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2007/11/16
 ///   Changed:  Implemented the framework and basic interfaces
+/// - Version:  0.2.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the settings of each request
+/// - Version:  0.2.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Shared the text data of the same configuration by the global driven data manager
+/// - Version:  0.2.3
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the trace of the latency of each processing stage
 ///
 
 #include "tts_textparser.h"
@@ -39,8 +55,10 @@
 #include "../preprocess/lang_langconvert.h"
 #include "../textparse/norm_textnormalize.h"
 #include "../textparse/wdseg_wordsegment.h"
+#include "../textparse/wdseg_latticesegment.h"
 #include "../textparse/psg_prosstructgen.h"
 #include "../textparse/gtp_grapheme2phoneme.h"
+#include "cmn/cmn_trace.h"
 #include <iostream>
 
 namespace cst
@@ -61,6 +79,7 @@ namespace cst
                 wordSegmenter       = NULL;
                 psgGenerator        = NULL;
                 gtpConverter        = NULL;
+                trace               = NULL;
 
                 initialized   = false;
             }
@@ -99,15 +118,17 @@ namespace cst
                     std::wcout << str::mbstowcs(modules["CGrapheme2Phoneme"].name) << std::endl;
                 }
 
-                // initialize modules
-                dataManager = dynamic_cast<CTextData*>(modules["CTextData"].createDataMan(dataConfig));
+                // initialize modules, the text data are loaded once and shared by the text parsers with the same configuration
+                CDataManager *pDataManager = CDrivenData::initDataManager(modules["CTextData"], dataConfig);
+                dataManager = dynamic_cast<const CTextData*>(pDataManager);
                 if (dataManager == NULL)
                 {
+                    CDrivenData::freeDataManager(pDataManager);
                     initialized = false;
                     return ERROR_OPEN_FAILED;
                 }
                 preProcessor    = new base::CPreProcess(dataManager, dataConfig.wstrLangTag.c_str());
-                langConverter   = new base::CLangConvert((dataConfig.wstrLexiconPath + L"/sttable.dat").c_str());
+                langConverter   = new base::CLangConvert(dataManager->getChineseConvert());
                 textSegmenter   = dynamic_cast<CTextSegment*>(modules["CTextSegment"].createModule(dataManager));
                 dsaAnalyzer     = dynamic_cast<CDocStruct*>(modules["CDocStruct"].createModule(dataManager));
                 textNormalizer  = dynamic_cast<CTextNormalize*>(modules["CTextNormalize"].createModule(dataManager));
@@ -116,9 +137,26 @@ namespace cst
                 gtpConverter    = dynamic_cast<CGrapheme2Phoneme*>(modules["CGrapheme2Phoneme"].createModule(dataManager));
 
                 initialized = true;
+                setTrace(trace);
                 return ERROR_SUCCESS;
             }
 
+            void CTextParser::setTrace(cmn::CTrace *pTrace)
+            {
+                trace = pTrace;
+                if (!initialized)
+                    return;
+
+                // the modules may record the spans of their own steps
+                preProcessor->setTrace(pTrace);
+                textSegmenter->setTrace(pTrace);
+                dsaAnalyzer->setTrace(pTrace);
+                textNormalizer->setTrace(pTrace);
+                wordSegmenter->setTrace(pTrace);
+                psgGenerator->setTrace(pTrace);
+                gtpConverter->setTrace(pTrace);
+            }
+
             int CTextParser::terminate()
             {
                 if (!initialized)
@@ -134,8 +172,8 @@ namespace cst
                 modules["CProsodicStructGenerate"].deleteModule(psgGenerator);
                 modules["CGrapheme2Phoneme"].deleteModule(gtpConverter);
 
-                // free the data manager
-                modules["CTextData"].deleteDataMan(dataManager);
+                // free the data manager, which is deleted when not used by other text parsers
+                CDrivenData::freeDataManager(dataManager);
 
                 // reset modules
                 dataManager         = NULL;
@@ -157,14 +195,32 @@ namespace cst
                 if (!initialized)
                     return ERROR_NOT_INITIALIZED;
 
+                return process(szText, inputTextType, ssmlDocument, dataManager->getGlobalSetting());
+            }
+
+            int CTextParser::process(const wchar_t *szText, EInputTextType inputTextType, CUtterance &utterance)
+            {
+                if (!initialized)
+                    return ERROR_NOT_INITIALIZED;
+
+                return process(szText, inputTextType, utterance, dataManager->getGlobalSetting());
+            }
+
+            int CTextParser::process(const wchar_t *szText, EInputTextType inputTextType, xml::CSSMLDocument &ssmlDocument, const TTSSetting &setting)
+            {
+                if (!initialized)
+                    return ERROR_NOT_INITIALIZED;
+
+                CST_TRACE_SPAN(trace, "text");
+
                 // clear data first
-                ssmlDocument.clearChildren();
+                ssmlDocument.clear();
 
                 // the SSML document
                 xml::CSSMLDocument *pDocument = &ssmlDocument;
 
                 // pre-process
-                int retCode = preProcess(pDocument, szText, inputTextType);
+                int retCode = preProcess(pDocument, szText, inputTextType, setting);
                 if (retCode != ERROR_SUCCESS)
                     return retCode;
 
@@ -206,50 +262,149 @@ namespace cst
                 return ERROR_SUCCESS;
             }
 
+            int CTextParser::process(const wchar_t *szText, EInputTextType inputTextType, CUtterance &utterance, const TTSSetting &setting)
+            {
+                if (!initialized)
+                    return ERROR_NOT_INITIALIZED;
+
+                CST_TRACE_SPAN(trace, "text");
+
+                // clear data first
+                utterance.clear();
+
+                // the SSML document, only used until text normalization
+                xml::CSSMLDocument ssmlDocument;
+                xml::CSSMLDocument *pDocument = &ssmlDocument;
+
+                // pre-process
+                int retCode = preProcess(pDocument, szText, inputTextType, setting);
+                if (retCode != ERROR_SUCCESS)
+                    return retCode;
+
+                // encoding conversion
+                retCode = langConvert(pDocument);
+                if (retCode != ERROR_SUCCESS)
+                    return retCode;
+
+                // text piece segmentation
+                retCode = textSegment(pDocument);
+                if (retCode != ERROR_SUCCESS)
+                    return retCode;
+
+                // document structure analysis
+                retCode = docStructAnalyze(pDocument);
+                if (retCode != ERROR_SUCCESS)
+                    return retCode;
+
+                // text normalization
+                retCode = textNormalize(pDocument);
+                if (retCode != ERROR_SUCCESS)
+                    return retCode;
+
+                // convert to typed utterance
+                {
+                    CST_TRACE_SPAN(trace, "fromSSML");
+                    retCode = utterance.fromSSML(pDocument);
+                }
+                if (retCode != ERROR_SUCCESS)
+                    return retCode;
+
+                // word segmentation
+                retCode = wordSegment(utterance);
+                if (retCode != ERROR_SUCCESS)
+                    return retCode;
+
+                // prosodic structure generation
+                retCode = prosodyStructGenerate(utterance);
+                if (retCode != ERROR_SUCCESS)
+                    return retCode;
+
+                // grapheme to phoneme
+                return graphemeToPhoneme(utterance);
+            }
+
             int CTextParser::preProcess(xml::CSSMLDocument *pSSMLDocument, const cmn::wstring &wstrIn, EInputTextType inputTextType)
             {
-                return preProcessor->process(pSSMLDocument, wstrIn, inputTextType);
+                CST_TRACE_SPAN(trace, "preProcess");
+                return preProcessor->process(pSSMLDocument, wstrIn, inputTextType, dataManager->getGlobalSetting());
+            }
+
+            int CTextParser::preProcess(xml::CSSMLDocument *pSSMLDocument, const cmn::wstring &wstrIn, EInputTextType inputTextType, const TTSSetting &setting)
+            {
+                CST_TRACE_SPAN(trace, "preProcess");
+                return preProcessor->process(pSSMLDocument, wstrIn, inputTextType, setting);
             }
 
             int CTextParser::textSegment(xml::CSSMLDocument *pSSMLDocument)
             {
+                CST_TRACE_SPAN(trace, "textSegment");
                 return textSegmenter->process(pSSMLDocument);
             }
 
             int CTextParser::docStructAnalyze(xml::CSSMLDocument *pSSMLDocument)
             {
+                CST_TRACE_SPAN(trace, "docStructAnalyze");
                 return dsaAnalyzer->process(pSSMLDocument);
             }
 
             int CTextParser::langConvert(xml::CSSMLDocument *pSSMLDocument)
             {
+                CST_TRACE_SPAN(trace, "langConvert");
                 return langConverter->process(pSSMLDocument);
             }
 
             int CTextParser::textNormalize(xml::CSSMLDocument *pSSMLDocument)
             {
+                CST_TRACE_SPAN(trace, "textNormalize");
                 return textNormalizer->process(pSSMLDocument);
             }
 
             int CTextParser::wordSegment(xml::CSSMLDocument *pSSMLDocument)
             {
+                CST_TRACE_SPAN(trace, "wordSegment");
                 return wordSegmenter->process(pSSMLDocument);
             }
 
             int CTextParser::prosodyStructGenerate(xml::CSSMLDocument *pSSMLDocument)
             {
+                CST_TRACE_SPAN(trace, "prosodyStructGenerate");
                 return psgGenerator->process(pSSMLDocument);
             }
 
             int CTextParser::graphemeToPhoneme(xml::CSSMLDocument *pSSMLDocument)
             {
+                CST_TRACE_SPAN(trace, "graphemeToPhoneme");
                 return gtpConverter->process(pSSMLDocument);
             }
 
+            int CTextParser::wordSegment(CUtterance &utterance)
+            {
+                CST_TRACE_SPAN(trace, "wordSegment");
+                return wordSegmenter->process(utterance);
+            }
+
+            int CTextParser::prosodyStructGenerate(CUtterance &utterance)
+            {
+                CST_TRACE_SPAN(trace, "prosodyStructGenerate");
+                return psgGenerator->process(utterance);
+            }
+
+            int CTextParser::graphemeToPhoneme(CUtterance &utterance)
+            {
+                CST_TRACE_SPAN(trace, "graphemeToPhoneme");
+                return gtpConverter->process(utterance);
+            }
+
 
             base::CDataManager *CreateTextData(const base::DataConfig &dataConfig)
             {
-                return new base::CTextData();
+                base::CTextData *pDataManager = new base::CTextData();
+                if (pDataManager == NULL || !pDataManager->initialize(dataConfig))
+                {
+                    delete pDataManager;
+                    pDataManager = NULL;
+                }
+                return pDataManager;
             }
 
             void DeleteTextData(base::CDataManager *pDataManager)
@@ -277,6 +432,11 @@ namespace cst
                 return new base::CWordSegment(pDataManager);
             }
 
+            base::CModule *CreateLatticeWordSegment(const base::CDataManager *pDataManager)
+            {
+                return new base::CLatticeWordSegment(pDataManager);
+            }
+
             base::CModule *CreateProsodicStructGenerate(const base::CDataManager *pDataManager)
             {
                 return new base::CProsodicStructGenerate(pDataManager);
@@ -299,6 +459,7 @@ namespace cst
                 modules["CDocStruct"] = ModuleInfo("cst::tts::base::CDocStruct", CreateDocStruct, DeleteTextModule);
                 modules["CTextNormalize"] = ModuleInfo("cst::tts::base::CTextNormalize", CreateTextNormalize, DeleteTextModule);
                 modules["CWordSegment"] = ModuleInfo("cst::tts::base::CWordSegment", CreateWordSegment, DeleteTextModule);
+                modules["CLatticeWordSegment"] = ModuleInfo("cst::tts::base::CLatticeWordSegment", CreateLatticeWordSegment, DeleteTextModule);
                 modules["CProsodicStructGenerate"] = ModuleInfo("cst::tts::base::CProsodicStructGenerate", CreateProsodicStructGenerate, DeleteTextModule);
                 modules["CGrapheme2Phoneme"] = ModuleInfo("cst::tts::base::CGrapheme2Phoneme", CreateGrapheme2Phoneme, DeleteTextModule);
             }
@@ -28,17 +28,35 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2007/11/16
 ///   Changed:  Implemented the framework and basic interfaces
+/// - Version:  0.2.0
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the processing of typed utterance
+/// - Version:  0.2.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the settings of each request
+/// - Version:  0.2.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Shared the text data of the same configuration by the global driven data manager
+/// - Version:  0.2.3
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Added the trace of the latency of each processing stage
 ///
 
 #ifndef _CST_TTS_BASE_TTS_TEXTPARSER_H_
 #define _CST_TTS_BASE_TTS_TEXTPARSER_H_
 
 #include "ttsbase/datamanage/module_manager.h"
+#include "ttsbase/datamanage/data_datamanager.h"
 #include "xml/ssml_document.h"
 
 namespace cst
 {
     namespace xml {class CSSMLDocument;}
+    namespace cmn {class CTrace;}
 
     namespace tts
     {
@@ -67,6 +85,7 @@ namespace cst
             class CWordSegment;
             class CProsodicStructGenerate;
             class CGrapheme2Phoneme;
+            class CUtterance;
 
 
             ///
@@ -120,8 +139,75 @@ namespace cst
                 ///
                 virtual int process(const wchar_t *szText, EInputTextType inputTextType, xml::CSSMLDocument &ssmlDocument);
 
+                ///
+                /// @brief  Performing the text analysis, returning the typed utterance
+                ///
+                /// The SSML document is processed until text normalization, and then converted to the
+                /// utterance which is passed from module to module without SSML document traversing and rewriting.
+                ///
+                /// @param  [in]  szText        The text to be analyzed
+                /// @param  [in]  inputTextType Type of input text string. See declaration of "EInputTextType"
+                /// @param  [out] utterance     Return the utterance containing the related information of text analysis result
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                /// @retval ERROR_INVALID_SSML_DOCUMENT The input can not be represented by the utterance,
+                ///         use the processing of SSML document instead
+                ///
+                virtual int process(const wchar_t *szText, EInputTextType inputTextType, CUtterance &utterance);
+
+                ///
+                /// @brief  Performing the text analysis with the settings of current request
+                ///
+                /// The settings (rate, volume and pitch) are added to the SSML document as the global prosody element.
+                /// The shared data are not modified, hence the requests with different settings can be processed
+                /// concurrently with the same data. The above procedures use the default settings of the data manager.
+                ///
+                /// @param  [in]  szText        The text to be analyzed
+                /// @param  [in]  inputTextType Type of input text string. See declaration of "EInputTextType"
+                /// @param  [out] ssmlDocument  Return the SSML document containing the related information of text analysis result
+                /// @param  [in]  setting       The settings of current request
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                ///
+                virtual int process(const wchar_t *szText, EInputTextType inputTextType, xml::CSSMLDocument &ssmlDocument, const TTSSetting &setting);
+
+                ///
+                /// @brief  Performing the text analysis with the settings of current request, returning the typed utterance
+                ///
+                /// @param  [in]  szText        The text to be analyzed
+                /// @param  [in]  inputTextType Type of input text string. See declaration of "EInputTextType"
+                /// @param  [out] utterance     Return the utterance containing the related information of text analysis result
+                /// @param  [in]  setting       The settings of current request
+                ///
+                /// @return Whether operation is successful
+                /// @retval ERROR_SUCCESS The operation is successful
+                /// @retval ERROR_INVALID_SSML_DOCUMENT The input can not be represented by the utterance,
+                ///         use the processing of SSML document instead
+                ///
+                virtual int process(const wchar_t *szText, EInputTextType inputTextType, CUtterance &utterance, const TTSSetting &setting);
+
+                ///
+                /// @brief  Set the trace recording the latency of each processing stage, NULL to disable tracing
+                ///
+                /// The spans of the stages (preProcess, langConvert, textSegment, docStructAnalyze, textNormalize,
+                /// fromSSML, wordSegment, prosodyStructGenerate and graphemeToPhoneme) are added to the trace
+                /// within the span "text" of each call, and the trace can be read after the call. The trace is
+                /// not synchronized, do not set it when the text parser is used by several threads concurrently.
+                ///
+                /// @param  [in]  pTrace        The trace to be used by the text parser and its modules
+                ///
+                virtual void setTrace(cmn::CTrace *pTrace);
+
+                ///
+                /// @brief  Get the trace recording the latency of each processing stage, NULL if not traced
+                ///
+                cmn::CTrace *getTrace() const {return trace;}
+
             public:
                 int preProcess(xml::CSSMLDocument *pSSMLDocument, const cmn::wstring &wstrIn, EInputTextType inputTextType);
+                int preProcess(xml::CSSMLDocument *pSSMLDocument, const cmn::wstring &wstrIn, EInputTextType inputTextType, const TTSSetting &setting);
                 int textSegment(xml::CSSMLDocument *pSSMLDocument);
                 int docStructAnalyze(xml::CSSMLDocument *pSSMLDocument);
                 int langConvert(xml::CSSMLDocument *pSSMLDocument);
@@ -129,6 +215,9 @@ namespace cst
                 int wordSegment(xml::CSSMLDocument *pSSMLDocument);
                 int prosodyStructGenerate(xml::CSSMLDocument *pSSMLDocument);
                 int graphemeToPhoneme(xml::CSSMLDocument *pSSMLDocument);
+                int wordSegment(CUtterance &utterance);
+                int prosodyStructGenerate(CUtterance &utterance);
+                int graphemeToPhoneme(CUtterance &utterance);
 
             protected:
                 ///
@@ -139,8 +228,8 @@ namespace cst
             protected:
                 /// whether engine is initialized
                 bool initialized;
-                /// text data manager
-                CTextData *dataManager;
+                /// text data manager, shared by the text parsers with the same configuration
+                const CTextData *dataManager;
                 /// pre-process for text analysis
                 CPreProcess *preProcessor;
                 /// text piece segmentation
@@ -157,6 +246,8 @@ namespace cst
                 CProsodicStructGenerate *psgGenerator;
                 /// grapheme to phoneme
                 CGrapheme2Phoneme *gtpConverter;
+                /// trace of the processing stages, NULL if not traced
+                cmn::CTrace *trace;
             };
 
         }//namespace base
@@ -24,6 +24,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2014/12/10
 ///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Wrote the fields of the full-context name either into string or into the context features
 ///
 
 
@@ -39,6 +43,34 @@ namespace cst
     {
         namespace Chinese
         {
+            // append integer to the end of string without formatting through stream
+            static inline void appendNumber(std::string &str, int value)
+            {
+                char buf[16];
+                char *p = buf + sizeof(buf);
+                unsigned int uval = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+                do
+                {
+                    *--p = (char)('0' + uval % 10);
+                    uval /= 10;
+                } while (uval != 0);
+                if (value < 0)
+                    *--p = '-';
+                str.append(p, buf + sizeof(buf) - p);
+            }
+
+            // writer of the full-context name, appending the values with their left delimiters to string
+            class CContextWriter
+            {
+            public:
+                CContextWriter(std::string &ctx) : ctx(ctx) {}
+                void add(const char *left, const std::string &value) {ctx += left; ctx += value;}
+                void add(const char *left, const char *value) {ctx += left; ctx += value;}
+                void add(const char *left, int value) {ctx += left; appendNumber(ctx, value);}
+            protected:
+                std::string &ctx;
+            };
+
             int CSSML2Lab::buildLabInfo(std::vector<CUnitItem> &inSenUnits, std::vector<CSegInfo> &outSenSegs)
             {
                 // build the context information for a sentence
@@ -55,21 +87,27 @@ namespace cst
                 return ERROR_SUCCESS;
             }
 
-            const std::string &CSSML2Lab::CSegInfo::asLabel() const
+            std::string CSSML2Lab::CSegInfo::asLabel() const
             {
-                static std::string label;
                 std::ostringstream fout;
                 print(fout);
-                label = fout.str();
-                return label;
+                return fout.str();
             }
 
             void CSSML2Lab::CSegInfo::print(std::ostream &fp) const
             {
-                std::string pprPhoneme = preSeg==NULL ? "X" : (preSeg->preSeg==NULL ? "X" : preSeg->preSeg->segPhoneme);
-                std::string prePhoneme = preSeg==NULL ? "X" : preSeg->segPhoneme;
-                std::string nxtPhoneme = nxtSeg==NULL ? "X" : nxtSeg->segPhoneme;
-                std::string nntPhoneme = nxtSeg==NULL ? "X" : (nxtSeg->nxtSeg==NULL ? "X" : nxtSeg->nxtSeg->segPhoneme);
+                std::string ctx;
+                format(ctx);
+                fp << begTime << "\t" << endTime << "\t" << ctx << std::endl;
+            }
+
+            template<class T> void CSSML2Lab::CSegInfo::write(T &out) const
+            {
+                static const std::string strX = "X";
+                const std::string &pprPhoneme = preSeg==NULL ? strX : (preSeg->preSeg==NULL ? strX : preSeg->preSeg->segPhoneme);
+                const std::string &prePhoneme = preSeg==NULL ? strX : preSeg->segPhoneme;
+                const std::string &nxtPhoneme = nxtSeg==NULL ? strX : nxtSeg->segPhoneme;
+                const std::string &nntPhoneme = nxtSeg==NULL ? strX : (nxtSeg->nxtSeg==NULL ? strX : nxtSeg->nxtSeg->segPhoneme);
                 int preSylTone   = preSyl==NULL ? 0 : preSyl->sylTone;
                 int nxtSylTone   = nxtSyl==NULL ? 0 : nxtSyl->sylTone;
                 int preSylSegNum = preSyl==NULL ? 0 : preSyl->sylSegNumber;
@@ -83,102 +121,112 @@ namespace cst
 
                 //////////////////////////////////////////////////////////////////////////
                 //// SEGMENT
-                fp << begTime << "\t";
-                fp << endTime << "\t";
                 // pp.name, p.name, c.name, n.name, nn.name
-                fp <<          pprPhoneme;                  //    p1    LL-Seg
-                fp <<   "^" << prePhoneme;                  //   ^p2    L-Seg
-                fp <<   "-" << segPhoneme;                  //   -p3    C-Seg
-                fp <<   "+" << nxtPhoneme;                  //   +p4    R-Seg
-                fp <<   "=" << nntPhoneme;                  //   =p5    RR-Seg
+                out.add("", pprPhoneme);                        //    p1    LL-Seg
+                out.add("^", prePhoneme);                       //   ^p2    L-Seg
+                out.add("-", segPhoneme);                       //   -p3    C-Seg
+                out.add("+", nxtPhoneme);                       //   +p4    R-Seg
+                out.add("=", nntPhoneme);                       //   =p5    RR-Seg
                 // position in syllable (segment)
-                fp <<   "@" << segPos2SylHead;              //   @p6    Seg_Fw
-                fp <<   "_" << segPos2SylTail;              //   _p7    Seg_Bw
+                out.add("@", segPos2SylHead);                   //   @p6    Seg_Fw
+                out.add("_", segPos2SylTail);                   //   _p7    Seg_Bw
                 //////////////////////////////////////////////////////////////////////////
                 //// SYLLABLE
                 // p.stress, p.accent, p.length
-                fp << "/A:" << preSylTone;                  // /A:a1    L-Syl_tone
-                fp <<   "_" << 0;                           //   _a2    0
-                fp <<   "_" << preSylSegNum;                //   _a3    L-Syl_Num-Segs
+                out.add("/A:", preSylTone);                     // /A:a1    L-Syl_tone
+                out.add("_", 0);                                //   _a2    0
+                out.add("_", preSylSegNum);                     //   _a3    L-Syl_Num-Segs
                 // c.stress, c.accent, c.length
-                fp << "/B:" << sylTone;                     // /B:b1    C-Syl_tone
-                fp <<   "-" << 0;                           //   -b2    0
-                fp <<   "-" << sylSegNumber;                //   -b3    C-Syl_Num-Segs
+                out.add("/B:", sylTone);                        // /B:b1    C-Syl_tone
+                out.add("-", 0);                                //   -b2    0
+                out.add("-", sylSegNumber);                     //   -b3    C-Syl_Num-Segs
                 // position in word (syllable)
-                fp <<   "@" << sylPos2PWdHead;              //   @b4    Pos_C-Syl_in_C-Word(Fw)
-                fp <<   "-" << sylPos2PWdTail;              //   -b5    Pos_C-Syl_in_C-Word(Bw)
+                out.add("@", sylPos2PWdHead);                   //   @b4    Pos_C-Syl_in_C-Word(Fw)
+                out.add("-", sylPos2PWdTail);                   //   -b5    Pos_C-Syl_in_C-Word(Bw)
                 // position in phrase (syllable)
-                fp <<   "&" << sylPos2PPhHead;              //   &b6    Pos_C-Syl_in_C-Phrase(Fw)
-                fp <<   "-" << sylPos2PPhTail;              //   -b7    Pos_C-Syl_in_C-Phrase(Bw)
+                out.add("&", sylPos2PPhHead);                   //   &b6    Pos_C-Syl_in_C-Phrase(Fw)
+                out.add("-", sylPos2PPhTail);                   //   -b7    Pos_C-Syl_in_C-Phrase(Bw)
                 // position in phrase (stressed syllable)
-                fp <<   "#" << sylPos2IPhHead;              //   #b8    Pos_C-Syl_in_C-BreathGroup(Fw)
-                fp <<   "-" << sylPos2IPhTail;              //   -b9    Pos_C-Syl_in_C-BreathGroup(Bw)
+                out.add("#", sylPos2IPhHead);                   //   #b8    Pos_C-Syl_in_C-BreathGroup(Fw)
+                out.add("-", sylPos2IPhTail);                   //   -b9    Pos_C-Syl_in_C-BreathGroup(Bw)
                 // position in phrase (accented syllable)
-                fp <<   "$" << 0;                           //   $b10   0
-                fp <<   "-" << 0;                           //   -b11   0
+                out.add("$", 0);                                //   $b10   0
+                out.add("-", 0);                                //   -b11   0
                 // distance from stressed syllable
-                fp <<   "!" << 0;                           //   !b12   0
-                fp <<   "-" << 0;                           //   -b13   0
+                out.add("!", 0);                                //   !b12   0
+                out.add("-", 0);                                //   -b13   0
                 // distance from accented syllable
-                fp <<   ";" << sylPreBoundaryType;          //   ;b14   L-Syl_Type_Boundary
-                fp <<   "-" << sylNxtBoundaryType;          //   -b15   R-Syl_Type_Boundary
+                out.add(";", sylPreBoundaryType);               //   ;b14   L-Syl_Type_Boundary
+                out.add("-", sylNxtBoundaryType);               //   -b15   R-Syl_Type_Boundary
                 // name of the vowel of current syllable
-                fp <<   "|" << sylFinal;                    //   |b16   C-Syl_Final
+                out.add("|", sylFinal);                         //   |b16   C-Syl_Final
                 // n.stress, n.accent, n.length
-                fp << "/C:" << nxtSylTone;                  // /C:c1    R-Syl_tone
-                fp <<   "+" << 0;                           //   +c2    0
-                fp <<   "+" << nxtSylSegNum;                //   +c3    R-Syl_Num-Segs
+                out.add("/C:", nxtSylTone);                     // /C:c1    R-Syl_tone
+                out.add("+", 0);                                //   +c2    0
+                out.add("+", nxtSylSegNum);                     //   +c3    R-Syl_Num-Segs
                 //////////////////////////////////////////////////////////////////////////
                 //// WORD
                 // p.gpos, p.length (syllable)
-                fp << "/D:" << "X";                         // /D:d1    X
-                fp <<   "_" << prePWdSylNum;                //   _d2    L-Word_Num-Syls
+                out.add("/D:", "X");                            // /D:d1    X
+                out.add("_", prePWdSylNum);                     //   _d2    L-Word_Num-Syls
                 // c.gpos, c.length (syllable)
-                fp << "/E:" << "X";                         // /E:e1    X
-                fp <<   "+" << pwdSylNumber;                //   +e2    C-Word_Num-Syls
+                out.add("/E:", "X");                            // /E:e1    X
+                out.add("+", pwdSylNumber);                     //   +e2    C-Word_Num-Syls
                 // position in phrase (word)
-                fp <<   "@" << pwdPos2PPhHead;              //   @e3    Pos_C-Word_in_C-Phrase(Fw)
-                fp <<   "+" << pwdPos2PPhTail;              //   +e4    Pos_C-Word_in_C-Phrase(Bw)
+                out.add("@", pwdPos2PPhHead);                   //   @e3    Pos_C-Word_in_C-Phrase(Fw)
+                out.add("+", pwdPos2PPhTail);                   //   +e4    Pos_C-Word_in_C-Phrase(Bw)
                 // position in phrase (content word)
-                fp <<   "&" << pwdPos2IPhHead;              //   &e5    Pos_C-Word_in_C-BreathGroup(Fw)
-                fp <<   "+" << pwdPos2IPhTail;              //   +e6    Pos_C-Word_in_C-BreathGroup(Bw)
+                out.add("&", pwdPos2IPhHead);                   //   &e5    Pos_C-Word_in_C-BreathGroup(Fw)
+                out.add("+", pwdPos2IPhTail);                   //   +e6    Pos_C-Word_in_C-BreathGroup(Bw)
                 // distance from content word in phrase
-                fp <<   "#" << 0;                           //   #e7    0
-                fp <<   "+" << 0;                           //   +e8    0
+                out.add("#", 0);                                //   #e7    0
+                out.add("+", 0);                                //   +e8    0
                 // n.gpos, n.length (syllable)
-                fp << "/F:" << "X";                         // /F:f1    X
-                fp <<   "_" << nxtPWdSylNum;                //   _f2    R-Word_Num-Syls
+                out.add("/F:", "X");                            // /F:f1    X
+                out.add("_", nxtPWdSylNum);                     //   _f2    R-Word_Num-Syls
                 //////////////////////////////////////////////////////////////////////////
                 //// PHRASE
                 // length of previous phrase (syllable)
                 // length of previous phrase (word)
-                fp << "/G:" << prePPhSylNum;                // /G:g1    L-Phrase_Num-Syls
-                fp <<   "_" << prePPhPWdNum;                //   _g2    L-Phrase_Num-Words
+                out.add("/G:", prePPhSylNum);                   // /G:g1    L-Phrase_Num-Syls
+                out.add("_", prePPhPWdNum);                     //   _g2    L-Phrase_Num-Words
                 // length of current phrase (syllable)
                 // length of current phrase (word)
-                fp << "/H:" << pphSylNumber;                // /H:h1    C-Phrase_Num-Syls
-                fp <<   "=" << pphPWdNumber;                //   =h2    C-Phrase_Num-Words
+                out.add("/H:", pphSylNumber);                   // /H:h1    C-Phrase_Num-Syls
+                out.add("=", pphPWdNumber);                     //   =h2    C-Phrase_Num-Words
                 // position in major phrase (phrase)
-                fp <<   "^" << pphPos2IPhHead;              //   ^h3    Pos_C-Phrase_in_BreathGroup(Fw)
-                fp <<   "=" << pphPos2IPhTail;              //   =h4    Pos_C-Phrase_in_BreathGroup(Bw)
+                out.add("^", pphPos2IPhHead);                   //   ^h3    Pos_C-Phrase_in_BreathGroup(Fw)
+                out.add("=", pphPos2IPhTail);                   //   =h4    Pos_C-Phrase_in_BreathGroup(Bw)
                 // type of tobi endtone of current phrase
-                fp <<   "|" << "X";                         //   |h5    X
+                out.add("|", "X");                              //   |h5    X
                 // length of next phrase (syllable)
                 // length of next phrase (word)
-                fp << "/I:" << nxtPPhSylNum;                // /I:i1    R-Phrase_Num-Syls
-                fp <<   "=" << nxtPPhPWdNum;                //   =i2    R-Phrase_Num_words
+                out.add("/I:", nxtPPhSylNum);                   // /I:i1    R-Phrase_Num-Syls
+                out.add("=", nxtPPhPWdNum);                     //   =i2    R-Phrase_Num_words
                 //////////////////////////////////////////////////////////////////////////
                 //// INTONATION PHRASE
-                fp << "/K:" << iphPWdNumber;                // /K:k1    Num-Words_in_Breath
-                fp <<   "#" << iphPPhNumber;                //   #k2    Num-Phrases_in_Breat
-                fp <<   "!" << 0;                           //   !k3    0
-                fp <<   "@" << 0;                           //   @k4    0
-                fp << "/M:" << 0;                           // /M:m1    0
-                fp <<   "+" << 0;                           //   +m2    0
-                fp <<   "-" << 0;                           //   -m3    0
-                fp <<   "^" << 0;                           //   ^m4    0
-                fp << "/N:" << iphIntonationType;           // /N:n1    Type_BreathGroups
-                fp << std::endl;
+                out.add("/K:", iphPWdNumber);                   // /K:k1    Num-Words_in_Breath
+                out.add("#", iphPPhNumber);                     //   #k2    Num-Phrases_in_Breat
+                out.add("!", 0);                                //   !k3    0
+                out.add("@", 0);                                //   @k4    0
+                out.add("/M:", 0);                              // /M:m1    0
+                out.add("+", 0);                                //   +m2    0
+                out.add("-", 0);                                //   -m3    0
+                out.add("^", 0);                                //   ^m4    0
+                out.add("/N:", iphIntonationType);              // /N:n1    Type_BreathGroups
+            }
+
+            void CSSML2Lab::CSegInfo::format(std::string &ctx) const
+            {
+                CContextWriter writer(ctx);
+                write(writer);
+            }
+
+            bool CSSML2Lab::CSegInfo::format(hts::CHtsFeatureBuilder &builder, std::vector<unsigned int> &feature) const
+            {
+                builder.begin(feature);
+                write(builder);
+                return builder.end();
             }
 
             void CSSML2Lab::CSegInfo::clear()
@@ -254,8 +302,10 @@ namespace cst
                     else
                     {
                         // Other phonemes (e.g. English)
-                        static std::wstring delimiters = L"_/"; // for segmenting phonemes
-                        static cmn::CRegexp regvowel   = L"^([a-zA-Z]+)([0-2])$";
+                        // the regexp is shared by the threads, as matching results are kept in vowelMatch
+                        const std::wstring delimiters = L"_/"; // for segmenting phonemes
+                        static const cmn::CRegexp regvowel = L"^([a-zA-Z]+)([0-2])$";
+                        cmn::CRegexpMatch vowelMatch;
                         std::vector<std::wstring> segs;
                         str::tokenize(seg.pUnit->wstrPhoneme, delimiters, segs);
                         // save information
@@ -267,10 +317,10 @@ namespace cst
                                 continue;
                             std::string pstr = str::wcstombs(L"E"+*cit); // prepend "E"
                             seg.sylSegs.push_back(pstr);
-                            if (regvowel.match(cit->c_str()))
+                            if (regvowel.match(cit->c_str(), vowelMatch))
                             {
                                 seg.sylFinal = pstr;
-                                seg.sylTone  = pstr[regvowel.substart(2)+1]-'0'; // add "1" for "E" is added
+                                seg.sylTone  = pstr[vowelMatch.substart(2)+1]-'0'; // add "1" for "E" is added
                             }
                         }
                     }
@@ -24,12 +24,17 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2014/12/10
 ///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Wrote the fields of the full-context name either into string or into the context features
 ///
 
 #ifndef _CST_TTS_CHINESE_HTS_SSML2LAB_H_
 #define _CST_TTS_CHINESE_HTS_SSML2LAB_H_
 
 #include "ttsbase/synthesize/synth_synthesize.h"
+#include "htslib/hts_synthesizer.h"
 
 namespace cst
 {
@@ -109,10 +114,17 @@ namespace cst
                     void asBreak(const char *name) {clear(); segPhoneme=name; sylFinal="X";}
                     // write the unit information to file in LAB format
                     void print(std::ostream &fp) const;
+                    // append the full-context name (without time information) to string
+                    void format(std::string &ctx) const;
+                    // build the context feature from the fields of the full-context name, return false if the name must be used instead
+                    bool format(hts::CHtsFeatureBuilder &builder, std::vector<unsigned int> &feature) const;
                     // return label string in LAB format
-                    const std::string &asLabel() const;
+                    std::string asLabel() const;
                     // clear data
                     void clear();
+                protected:
+                    // write the values of the full-context name with their left delimiters to output
+                    template<class T> void write(T &out) const;
                 };
 
                 ///
@@ -24,11 +24,32 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2014/12/10
 ///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Saved the phones of each unit with synthetic duration
+/// - Version:  0.1.2
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Used the settings of each request for rate, volume, pitch and streaming chunk size
+/// - Version:  0.1.3
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Recorded the synthesis phases and counters of HTS synthesizer in the trace
+/// - Version:  0.1.4
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Passed the trace to the synthesis of each sentence
+/// - Version:  0.1.5
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Built the context features of labels from the typed fields, formatting the full-context names only if needed
 ///
 
 
 #include "data_voicedata.h"
 #include "hts_synthesize.h"
+#include "cmn/cmn_trace.h"
 #include <cmath>
 
 namespace cst
@@ -37,35 +58,132 @@ namespace cst
     {
         namespace Chinese
         {
-            int CHtsSynthesize::synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData)
+            ///
+            /// @brief  Adapter passing the speech chunks of HTS synthesizer to the wave sink
+            ///
+            class CHtsWaveSink : public hts::CWaveSink
             {
-                // convert to segment information
-                std::vector<CSegInfo> segInfo;
-                CSSML2Lab::buildLabInfo(sentenceInfo, segInfo);
+            public:
+                CHtsWaveSink(dsp::CWaveSink *sink) : waveSink(sink), aborted(false) {}
+                virtual bool write(const short *wavData, int numSamples)
+                {
+                    aborted = !waveSink->write((const byte*)wavData, numSamples*sizeof(short));
+                    return !aborted;
+                }
+            public:
+                dsp::CWaveSink *waveSink;   ///< The wave sink to receive the wave data
+                bool aborted;               ///< Whether synthesis is aborted by the wave sink
+            };
 
-                // get LAB string for HTS engine
-                std::string labString;
-                for (std::vector<CSegInfo>::const_iterator it = segInfo.begin(); it != segInfo.end(); ++it)
+            ///
+            /// @brief  Adapter providing the end of wave data as the buffer which HTS synthesizer generates speech into
+            ///
+            class CHtsWaveBuffer : public hts::CWaveBuffer
+            {
+            public:
+                CHtsWaveBuffer(dsp::CWaveData &wave) : waveData(wave), oldLength(wave.getLength()) {}
+                virtual short *getBuffer(int numSamples)
+                {
+                    if (!waveData.resize(oldLength + numSamples*sizeof(short)))
+                        return NULL;
+                    return (short*)(waveData.getData() + oldLength);
+                }
+            public:
+                dsp::CWaveData &waveData;   ///< The wave data to receive the speech
+                unsigned long oldLength;    ///< The length of wave data before synthesis
+            };
+
+            ///
+            /// @brief  Adapter recording the synthesis phases and counters of HTS synthesizer in the trace
+            ///
+            class CHtsTrace : public hts::CSynthTrace
+            {
+            public:
+                CHtsTrace(cmn::CTrace *pTrace) : trace(pTrace) {}
+                virtual void beginPhase(const char *name)
                 {
-                    labString += it->asLabel();
+                    spans.push_back(trace->beginSpan(name));
                 }
+                virtual void endPhase(const char *name)
+                {
+                    // the phases are nested
+                    if (spans.empty())
+                        return;
+                    trace->endSpan(spans.back());
+                    spans.pop_back();
+                }
+                virtual void addCount(const char *name, long value)
+                {
+                    trace->addCount(name, value);
+                }
+            public:
+                cmn::CTrace *trace;         ///< The trace to record the phases and counters
+                std::vector<int> spans;     ///< Indexes of the spans of the phases not ended
+            };
+
+            int CHtsSynthesize::synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData, const base::TTSSetting &setting, cmn::CTrace *pTrace)
+            {
+                return synthesizeSentence(sentenceInfo, waveData, setting, NULL, pTrace);
+            }
+
+            int CHtsSynthesize::synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData, const base::TTSSetting &setting, dsp::CWaveSink &waveSink, cmn::CTrace *pTrace)
+            {
+                return synthesizeSentence(sentenceInfo, waveData, setting, &waveSink, pTrace);
+            }
 
+            int CHtsSynthesize::synthesizeSentence(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData, const base::TTSSetting &setting, dsp::CWaveSink *waveSink, cmn::CTrace *pTrace)
+            {
                 // synthesize speech with HTS engine
                 const CVoiceData *dataManager = base::CSynthesize::getDataManager<CVoiceData>();
-                hts::CHtsSynthesizer *htsEngine = (hts::CHtsSynthesizer*)&(dataManager->getWavSynthesizer());
+                const CHtsSynthesizer &htsEngine = dataManager->getWavSynthesizer();
                 hts::SynthCfg htsOut;
                 htsOut.outWavData = true;
-                htsOut.speedRate  = dataManager->getGlobalSetting().rate;
-                htsOut.volumeRate = dataManager->getGlobalSetting().volume;
-                htsOut.halfTone   = 12.0f*log(dataManager->getGlobalSetting().pitch)/log(2.0f); // change pitch (f0*=2 if half_tone=12; f0/=2 if half_tone=-12)
-                bool succ = htsEngine->synthesize(labString.c_str(), htsOut, false);
-                if (!succ)
-                    return ERROR_DATA_READ_FAULT;
+                htsOut.speedRate  = setting.rate;
+                htsOut.volumeRate = setting.volume;
+                htsOut.halfTone   = 12.0f*log(setting.pitch)/log(2.0f); // change pitch (f0*=2 if half_tone=12; f0/=2 if half_tone=-12)
+                if (setting.chunkFrames > 0)
+                    htsOut.chunkFrames = setting.chunkFrames;
+                CHtsWaveSink htsSink(waveSink);
+                htsOut.waveSink   = (waveSink == NULL) ? NULL : &htsSink;
+                CHtsWaveBuffer htsBuffer(waveData);
+                htsOut.waveBuffer = &htsBuffer;     // generate waveform directly to the end of waveData
+                CHtsTrace htsTrace(pTrace);
+                htsOut.trace      = (pTrace == NULL) ? NULL : &htsTrace;
 
-                // return waveform
-                if (htsOut.wavData.size() > 0)
+                // convert to segment information
+                std::vector<CSegInfo> segInfo;
+                std::vector<hts::LabelInfo> labInfo;
                 {
-                    waveData.appendData((const byte*)&htsOut.wavData[0], htsOut.wavData.size()*sizeof(short));
+                    CST_TRACE_SPAN(pTrace, "buildLabel");
+                    CSSML2Lab::buildLabInfo(sentenceInfo, segInfo);
+
+                    // get structured label information for HTS engine,
+                    // the context features are built from the fields directly, and the full-context names are only formatted if needed
+                    labInfo.resize(segInfo.size());
+                    bool useName = htsEngine.needLabelString(htsOut);
+                    hts::CHtsFeatureBuilder builder(htsEngine.getHtsSynthesizer());
+                    for (size_t i = 0; i < segInfo.size() && !useName; i++)
+                    {
+                        if (!segInfo[i].format(builder, labInfo[i].feature))
+                            useName = true;
+                    }
+                    for (size_t i = 0; i < segInfo.size(); i++)
+                    {
+                        labInfo[i].begTime = segInfo[i].begTime;
+                        labInfo[i].endTime = segInfo[i].endTime;
+                        if (useName)
+                        {
+                            labInfo[i].feature.clear();
+                            segInfo[i].format(labInfo[i].context);
+                        }
+                    }
+                }
+
+                bool succ = htsEngine.synthesize(labInfo, htsOut);
+                if (!succ)
+                {
+                    waveData.resize(htsBuffer.oldLength);
+                    return ERROR_DATA_READ_FAULT;
                 }
 
                 // save begin, end time for each segment
@@ -77,20 +195,23 @@ namespace cst
                     it->endTime = *eit;
                 }
 
-                // save duration for each unit
+                // save duration and phones for each unit
                 for (std::vector<CSegInfo>::iterator it = segInfo.begin(); it != segInfo.end(); )
                 {
                     CUnitItem *unit = it->pUnit;
                     float dur  = 0;
+                    unit->phones.clear();
                     while (it != segInfo.end() && it->pUnit == unit)
                     {
-                        dur += (it->endTime - it->begTime) / (float)1e4;
+                        float segDur = (it->endTime - it->begTime) / (float)1e4;
+                        unit->phones.push_back(base::CUttPhone(str::mbstowcs(it->segPhoneme), segDur));
+                        dur += segDur;
                         it++;
                     }
                     unit->duration = dur;
                 }
 
-                return ERROR_SUCCESS;
+                return htsSink.aborted ? ERROR_OPERATION_ABORTED : ERROR_SUCCESS;
             }
 
         }//namespace Chinese
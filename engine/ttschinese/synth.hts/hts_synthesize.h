@@ -24,6 +24,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2014/12/10
 ///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Used the settings of each request for rate, volume, pitch and streaming chunk size
 ///
 
 
@@ -58,8 +62,36 @@ namespace cst
                 ///
                 /// @param  [in]  sentenceInfo  Target basic unit information for a sentence to be synthesized
                 /// @param  [out] waveData      Return the synthetic wave data by APPENDing the new data
+                /// @param  [in]  setting       The settings of current request
+                /// @param  [in]  pTrace        The trace to record the steps of the sentence, NULL if not recorded
                 ///
-                virtual int synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData);
+                virtual int synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData, const base::TTSSetting &setting, cmn::CTrace *pTrace);
+
+                ///
+                /// @brief  Perform speech synthesis for one sentence, passing the new wave data to sink incrementally
+                ///
+                /// The wave data is passed to the wave sink every few frames during HTS synthesis,
+                /// the speech parameters are generated in overlapped windows for this purpose.
+                ///
+                /// @param  [in]  sentenceInfo  Target basic unit information for a sentence to be synthesized
+                /// @param  [out] waveData      Return the synthetic wave data by APPENDing the new data
+                /// @param  [in]  setting       The settings of current request
+                /// @param  [in]  waveSink      The wave sink to receive the new wave data incrementally
+                /// @param  [in]  pTrace        The trace to record the steps of the sentence, NULL if not recorded
+                ///
+                virtual int synthesize(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData, const base::TTSSetting &setting, dsp::CWaveSink &waveSink, cmn::CTrace *pTrace);
+
+            protected:
+                ///
+                /// @brief  Perform speech synthesis for one sentence with HTS engine
+                ///
+                /// @param  [in]  sentenceInfo  Target basic unit information for a sentence to be synthesized
+                /// @param  [out] waveData      Return the synthetic wave data by APPENDing the new data
+                /// @param  [in]  setting       The settings of current request
+                /// @param  [in]  waveSink      The wave sink to receive the new wave data incrementally, NULL if not needed
+                /// @param  [in]  pTrace        The trace to record the steps of the sentence, NULL if not recorded
+                ///
+                int synthesizeSentence(std::vector<CUnitItem> &sentenceInfo, dsp::CWaveData &waveData, const base::TTSSetting &setting, dsp::CWaveSink *waveSink, cmn::CTrace *pTrace);
             };
 
         }//namespace Chinese
@@ -32,6 +32,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2018/07/30
 ///   Changed:  Modified by using HTS synthesizer
+/// - Version:  0.2.6
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Exposed the HTS synthesizer for building the context features of labels
 ///
 
 
@@ -89,6 +93,21 @@ namespace cst
                 ///
                 virtual int getChannels() const {return 1;}
 
+                ///
+                /// @brief  Synthesize the speech with HTS engine (thread safe, see hts::CHtsSynthesizer)
+                ///
+                using hts::CHtsSynthesizer::synthesize;
+
+                ///
+                /// @brief  Return whether the full-context names of the labels are needed (see hts::CHtsSynthesizer)
+                ///
+                using hts::CHtsSynthesizer::needLabelString;
+
+                ///
+                /// @brief  Return the HTS synthesizer, for building the context features of labels by hts::CHtsFeatureBuilder
+                ///
+                const hts::CHtsSynthesizer &getHtsSynthesizer() const {return *this;}
+
             protected:
                 //////////////////////////////////////////////////////////////////////////
                 //
@@ -130,7 +130,7 @@ namespace cst
                 //  Pass 2: 2) phoneme string of Chinese Pinyin will be segmented further by tones.
 
                 static std::wstring delimiters = L"- \t\u3000";         // for segmenting phonemes in pass 1
-                static cmn::CRegexp regPinyin  = L"^[a-zA-Z]+[0-9]?";   // for match Pinyin in pass 2
+                static const cmn::CRegexp regPinyin = L"^[a-zA-Z]+[0-9]?";  // for match Pinyin in pass 2 (shared by threads)
 
                 // Pass 1: segment phonemes according to delimiters
                 std::vector<std::wstring> vecPhonemes;
@@ -155,12 +155,13 @@ namespace cst
                         // Pass 2:
                         // 2) phoneme string of Chinese Pinyin: segment it into syllables
                         const wchar_t* pstr = ph.c_str();
+                        cmn::CRegexpMatch pinyinMatch;
                         while (*pstr)
                         {
                             // match phoneme string
                             int len = 1;
-                            if (regPinyin.match(pstr))
-                                len = regPinyin.sublength(0);
+                            if (regPinyin.match(pstr, pinyinMatch))
+                                len = pinyinMatch.sublength(0);
 
                             // add phoneme string
                             phonemes.push_back(std::wstring(pstr, len));
@@ -24,6 +24,10 @@
 ///   Author:   John (john.zywu@gmail.com)
 ///   Date:     2007/06/03
 ///   Changed:  Created
+/// - Version:  0.1.1
+///   Author:   agent (agent@local)
+///   Date:     2026/10/17
+///   Changed:  Initialized the base text data (e.g. Chinese conversion table) first
 ///
 
 
@@ -38,7 +42,8 @@ namespace cst
         {
             bool CTextData::initialize(const base::DataConfig &dataConfig)
             {
-                m_config = dataConfig;
+                if (!base::CTextData::initialize(dataConfig))
+                    return false;
                 if (!m_config.bInitText)
                     return true;
 
@@ -51,11 +56,15 @@ namespace cst
                 {
                     std::wstring wstrPath = m_config.wstrLexiconPath;
 
-                    // load default lexicon (for GBK characters)
-                    bsucc = bsucc && pLexicon->load((wstrPath+L"/gbk.bin").c_str());
+                    // load compiled lexicon image if available (mapped into memory, no parsing needed)
+                    if (!pLexicon->load((wstrPath+L"/lexicon.dat").c_str()))
+                    {
+                        // load default lexicon (for GBK characters)
+                        bsucc = bsucc && pLexicon->load((wstrPath+L"/gbk.bin").c_str());
 
-                    // load char lexicon (for English/Greek letters and key words)
-                    bsucc = bsucc && pLexicon->load((wstrPath+L"/symbol.lex").c_str());
+                        // load char lexicon (for English/Greek letters and key words)
+                        bsucc = bsucc && pLexicon->load((wstrPath+L"/symbol.lex").c_str());
+                    }
                 }
                 if (!bsucc)
                 {
@@ -64,6 +73,18 @@ namespace cst
                     pLexicon = NULL;
                 }
 
+                // load POS bigram model (optional, for statistical word segmentation)
+                if (bsucc)
+                {
+                    cmn::CBigram *pPOSBigram = new cmn::CBigram();
+                    if (!pPOSBigram->loadBigramFromARPA(m_config.wstrLexiconPath + L"/posbigram.arpa"))
+                    {
+                        delete pPOSBigram;
+                        pPOSBigram = NULL;
+                    }
+                    m_pPOSBigram = pPOSBigram;
+                }
+
                 // save text data
                 m_pLexicon = pLexicon;
                 return bsucc;
@@ -29,7 +29,10 @@
 
 #include "lexicon_data.h"
 #include "cmn/cmn_textfile.h"
+#include "cmn/cmn_file.h"
 #include <sstream>
+#include <algorithm>
+#include <string.h>
 
 namespace cst
 {
@@ -37,10 +40,123 @@ namespace cst
     {
         namespace Chinese
         {
+            /// Magic string identifying the binary image file of lexicon
+            static const char LEXICON_IMAGE_MAGIC[8] = "CSTLEXI";
+
+            /// Version of the format of the binary image file of lexicon
+            static const uint32 LEXICON_IMAGE_VERSION = 1;
+
+            ///
+            /// @brief  Convert the wide character at the position to UTF-8, and advance the position to the last one converted
+            ///
+            /// @return The number of UTF-8 bytes (at most 4)
+            ///
+            static size_t wcharToUTF8(const wchar_t *wcs, size_t len, size_t &pos, char *utf8)
+            {
+                unsigned long c = (unsigned long)wcs[pos];
+                if (sizeof(wchar_t) == 2 && c >= 0xD800 && c < 0xDC00 && pos+1 < len && wcs[pos+1] >= 0xDC00 && wcs[pos+1] < 0xE000)
+                {
+                    // UTF-16 surrogate pair
+                    c = 0x10000 + ((c - 0xD800) << 10) + ((unsigned long)wcs[++pos] - 0xDC00);
+                }
+                if (c < 0x80)
+                {
+                    utf8[0] = (char)c;
+                    return 1;
+                }
+                else if (c < 0x800)
+                {
+                    utf8[0] = (char)(0xC0 | (c >> 6));
+                    utf8[1] = (char)(0x80 | (c & 0x3F));
+                    return 2;
+                }
+                else if (c < 0x10000)
+                {
+                    utf8[0] = (char)(0xE0 | (c >> 12));
+                    utf8[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+                    utf8[2] = (char)(0x80 | (c & 0x3F));
+                    return 3;
+                }
+                else
+                {
+                    utf8[0] = (char)(0xF0 | (c >> 18));
+                    utf8[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+                    utf8[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+                    utf8[3] = (char)(0x80 | (c & 0x3F));
+                    return 4;
+                }
+            }
+
+            ///
+            /// @brief  Convert the wide-character string to UTF-8 (for the keys and strings in binary image)
+            ///
+            /// The conversion is done directly as it is called for every lookup.
+            ///
+            static void wcsToUTF8(const wchar_t *wcs, size_t len, std::string &utf8)
+            {
+                char buf[4];
+                utf8.clear();
+                for (size_t i = 0; i < len; i++)
+                {
+                    utf8.append(buf, wcharToUTF8(wcs, len, i, buf));
+                }
+            }
+
+            ///
+            /// @brief  Convert the UTF-8 string (null-terminated) to wide-character string
+            ///
+            static void utf8ToWcs(const char *utf8, std::wstring &wcs)
+            {
+                wcs.clear();
+                const unsigned char *p = (const unsigned char*)utf8;
+                while (*p != 0)
+                {
+                    unsigned long c = *p++;
+                    int trail = 0;
+                    if (c >= 0xF0)      {c &= 0x07; trail = 3;}
+                    else if (c >= 0xE0) {c &= 0x0F; trail = 2;}
+                    else if (c >= 0xC0) {c &= 0x1F; trail = 1;}
+                    for (; trail > 0 && (*p & 0xC0) == 0x80; trail--)
+                    {
+                        c = (c << 6) | (*p++ & 0x3F);
+                    }
+                    if (sizeof(wchar_t) == 2 && c >= 0x10000)
+                    {
+                        // UTF-16 surrogate pair
+                        c -= 0x10000;
+                        wcs += (wchar_t)(0xD800 + (c >> 10));
+                        wcs += (wchar_t)(0xDC00 + (c & 0x3FF));
+                    }
+                    else
+                    {
+                        wcs += (wchar_t)c;
+                    }
+                }
+            }
+
+            ///
+            /// @brief  Add the string into the string section of binary image, the same strings are stored only once
+            ///
+            /// @return Offset of the string in the string section
+            ///
+            static uint32 addImageString(const std::wstring &wstr, std::string &strings, std::map<std::string, uint32> &mapStrings)
+            {
+                std::string str;
+                wcsToUTF8(wstr.c_str(), wstr.length(), str);
+                std::map<std::string, uint32>::const_iterator it = mapStrings.find(str);
+                if (it != mapStrings.end())
+                    return it->second;
+                uint32 offset = (uint32)strings.size();
+                strings.append(str.c_str(), str.length() + 1);
+                mapStrings.insert(std::make_pair(str, offset));
+                return offset;
+            }
+
             CLexiconData::CLexiconData(bool ignorePOS)
             {
                 m_ignorePOS    = ignorePOS;
                 m_nMaxWordLen  = 0;
+                m_pImage       = NULL;
             }
 
             CLexiconData::~CLexiconData()
@@ -50,6 +166,9 @@ namespace cst
 
             bool CLexiconData::clear()
             {
+                m_wordTrie.clear();
+                m_imageFile.close();
+                m_pImage = NULL;
                 m_vecLexemes.clear();
                 m_mapLexemes.clear();
                 m_mapPOSFrequency.clear();
@@ -59,6 +178,46 @@ namespace cst
 
             bool CLexiconData::load(const wchar_t *fileName)
             {
+                // detect binary image file
+                char magic[sizeof(LEXICON_IMAGE_MAGIC)] = {0};
+                cmn::CFile binFile;
+                if (binFile.open(fileName, L"rb") && binFile.read(magic, sizeof(magic), 1) == 1 && memcmp(magic, LEXICON_IMAGE_MAGIC, sizeof(magic)) == 0)
+                {
+                    binFile.close();
+                    if (m_pImage == NULL && m_vecLexemes.empty())
+                    {
+                        // use the binary image directly
+                        return loadImage(fileName);
+                    }
+
+                    // merge into existing lexicon data
+                    CLexiconData tmpLexicon(m_ignorePOS);
+                    if (!tmpLexicon.loadImage(fileName))
+                        return false;
+                    unpackImage();
+                    m_descriptor = tmpLexicon.m_descriptor;
+                    const ImageWord *pWords = (const ImageWord*)((const char*)tmpLexicon.m_pImage + tmpLexicon.m_pImage->offWords);
+                    const ImageLexeme *pLexemes = (const ImageLexeme*)((const char*)tmpLexicon.m_pImage + tmpLexicon.m_pImage->offLexemes);
+                    CLexeme lexItem;
+                    for (uint32 i = 0; i < tmpLexicon.m_pImage->numWords; i++)
+                    {
+                        lexItem.wstrGrapheme = tmpLexicon.getImageString(pWords[i].grapheme);
+                        for (uint32 j = pWords[i].firstLexeme; j < pWords[i].firstLexeme + pWords[i].numLexemes && j < tmpLexicon.m_pImage->numLexemes; j++)
+                        {
+                            lexItem.wstrPhoneme = tmpLexicon.getImageString(pLexemes[j].phoneme);
+                            lexItem.wstrPOS     = tmpLexicon.getImageString(pLexemes[j].pos);
+                            lexItem.nFrequency  = pLexemes[j].frequency;
+                            addWord(lexItem);
+                        }
+                    }
+                    buildPOSFrequencyTable();
+                    return buildWordTrie();
+                }
+                binFile.close();
+
+                // binary image is read-only, convert it before merging the text file
+                unpackImage();
+
                 // open the text file
                 std::wstring txtBuf;
                 cmn::CTextFile txtFile;
@@ -118,11 +277,18 @@ namespace cst
                 // initialize POS frequency table
                 buildPOSFrequencyTable();
 
-                return true;
+                // build trie for prefix search
+                return buildWordTrie();
             }
 
             bool CLexiconData::addWord(const CLexeme &lexemeInfo)
             {
+                // binary image is read-only, convert it before modification
+                unpackImage();
+
+                // trie is out of date, it is rebuilt after loading
+                m_wordTrie.clear();
+
                 std::map<std::wstring, size_t>::iterator it = m_mapLexemes.find(lexemeInfo.wstrGrapheme);
 
                 RawLexeme newLexeme;
@@ -180,6 +346,26 @@ namespace cst
 
             size_t CLexiconData::lookupWord(const std::wstring &wstrWord, std::vector<CLexeme> &vecLexeme) const
             {
+                if (m_pImage != NULL)
+                {
+                    // search in binary image
+                    const ImageWord *pWord = findImageWord(wstrWord);
+                    if (pWord == NULL)
+                        return 0;
+                    const ImageLexeme *pLexemes = (const ImageLexeme*)((const char*)m_pImage + m_pImage->offLexemes);
+                    CLexeme tmpLexeme;
+                    tmpLexeme.wstrGrapheme = wstrWord;
+                    size_t nCount = 0;
+                    for (uint32 i = pWord->firstLexeme; i < pWord->firstLexeme + pWord->numLexemes && i < m_pImage->numLexemes; i++, nCount++)
+                    {
+                        tmpLexeme.wstrPhoneme = getImageString(pLexemes[i].phoneme);
+                        tmpLexeme.wstrPOS     = getImageString(pLexemes[i].pos);
+                        tmpLexeme.nFrequency  = pLexemes[i].frequency;
+                        vecLexeme.push_back(tmpLexeme);
+                    }
+                    return nCount;
+                }
+
                 std::map<std::wstring, size_t>::const_iterator itFind = m_mapLexemes.find(wstrWord);
                 if (itFind == m_mapLexemes.end())
                 {
@@ -205,6 +391,31 @@ namespace cst
 
             size_t CLexiconData::lookupWord(const std::wstring &wstrWord, const std::wstring &wstrPOS, CLexeme &lexeme) const
             {
+                if (m_pImage != NULL)
+                {
+                    // search in binary image
+                    const ImageWord *pWord = findImageWord(wstrWord);
+                    if (pWord == NULL)
+                        return 0;
+                    std::string strPOS;
+                    wcsToUTF8(wstrPOS.c_str(), wstrPOS.length(), strPOS);
+                    const char *pStrings = (const char*)m_pImage + m_pImage->offStrings;
+                    const ImageLexeme *pLexemes = (const ImageLexeme*)((const char*)m_pImage + m_pImage->offLexemes);
+                    for (uint32 i = pWord->firstLexeme; i < pWord->firstLexeme + pWord->numLexemes && i < m_pImage->numLexemes; i++)
+                    {
+                        if (pLexemes[i].pos < m_pImage->sizeStrings && strcmp(pStrings + pLexemes[i].pos, strPOS.c_str()) == 0)
+                        {
+                            // found
+                            lexeme.wstrGrapheme = wstrWord;
+                            lexeme.wstrPhoneme  = getImageString(pLexemes[i].phoneme);
+                            lexeme.wstrPOS      = wstrPOS;
+                            lexeme.nFrequency   = pLexemes[i].frequency;
+                            return 1;
+                        }
+                    }
+                    return 0;
+                }
+
                 std::map<std::wstring, size_t>::const_iterator itFind = m_mapLexemes.find(wstrWord);
                 if (itFind == m_mapLexemes.end())
                 {
@@ -233,6 +444,28 @@ namespace cst
 
             size_t CLexiconData::getPOSFrequency(const std::wstring &wstrPOS) const
             {
+                if (m_pImage != NULL)
+                {
+                    // binary search in the sorted POS entries of binary image
+                    std::string strPOS;
+                    wcsToUTF8(wstrPOS.c_str(), wstrPOS.length(), strPOS);
+                    const char *pStrings = (const char*)m_pImage + m_pImage->offStrings;
+                    const ImagePOS *pPOS = (const ImagePOS*)((const char*)m_pImage + m_pImage->offPOS);
+                    size_t low = 0, high = m_pImage->numPOS;
+                    while (low < high)
+                    {
+                        size_t mid = (low + high) / 2;
+                        int cmp = (pPOS[mid].pos < m_pImage->sizeStrings) ? strcmp(pStrings + pPOS[mid].pos, strPOS.c_str()) : 1;
+                        if (cmp == 0)
+                            return pPOS[mid].frequency;
+                        if (cmp < 0)
+                            low = mid + 1;
+                        else
+                            high = mid;
+                    }
+                    return 0;
+                }
+
                 std::map<std::wstring, size_t>::const_iterator it = m_mapPOSFrequency.find(wstrPOS);
                 if (it != m_mapPOSFrequency.end())
                 {
@@ -241,6 +474,50 @@ namespace cst
                 return 0;
             }
 
+            size_t CLexiconData::prefixSearch(const wchar_t *pText, size_t textLen, size_t *wordLens, size_t maxWords) const
+            {
+                if (m_wordTrie.getSize() == 0)
+                {
+                    // trie is not built
+                    return CLexicon::prefixSearch(pText, textLen, wordLens, maxWords);
+                }
+
+                // walk along the trie character by character
+                size_t nCount = 0, node = 0;
+                char utf8[4];
+                for (size_t i = 0; i < textLen && nCount < maxWords; i++)
+                {
+                    if (!m_wordTrie.traverse(node, utf8, wcharToUTF8(pText, textLen, i, utf8)))
+                        break;
+                    if (m_wordTrie.getValue(node) >= 0)
+                        wordLens[nCount++] = i + 1;
+                }
+                return nCount;
+            }
+
+            bool CLexiconData::buildWordTrie()
+            {
+                // sort the words by the UTF-8 keys
+                std::vector<std::pair<std::string, int> > sortedWords;
+                sortedWords.reserve(m_mapLexemes.size());
+                for (std::map<std::wstring, size_t>::const_iterator it = m_mapLexemes.begin(); it != m_mapLexemes.end(); ++it)
+                {
+                    std::string key;
+                    wcsToUTF8(it->first.c_str(), it->first.length(), key);
+                    sortedWords.push_back(std::make_pair(key, (int)it->second));
+                }
+                std::sort(sortedWords.begin(), sortedWords.end());
+
+                std::vector<std::string> keys(sortedWords.size());
+                std::vector<int> values(sortedWords.size());
+                for (size_t i = 0; i < sortedWords.size(); i++)
+                {
+                    keys[i]   = sortedWords[i].first;
+                    values[i] = sortedWords[i].second;
+                }
+                return m_wordTrie.build(keys, values);
+            }
+
             void CLexiconData::buildPOSFrequencyTable()
             {
                 std::map<std::wstring, size_t>::iterator itPOS;
@@ -269,6 +546,196 @@ namespace cst
                 }
             }
 
+            bool CLexiconData::loadImage(const wchar_t *fileName)
+            {
+                clear();
+                if (!m_imageFile.open(fileName))
+                    return false;
+
+                // check the header and the sections
+                const char  *pData = (const char*)m_imageFile.getData();
+                const size_t nSize = m_imageFile.getSize();
+                const ImageHeader *pHeader = (const ImageHeader*)pData;
+                bool valid = nSize >= sizeof(ImageHeader)
+                    && memcmp(pHeader->magic, LEXICON_IMAGE_MAGIC, sizeof(LEXICON_IMAGE_MAGIC)) == 0
+                    && pHeader->version == LEXICON_IMAGE_VERSION
+                    && pHeader->byteOrder == 0x01020304
+                    && pHeader->offUnits   <= nSize && pHeader->numUnits   <= (nSize - pHeader->offUnits)   / sizeof(cmn::CDoubleArrayTrie::Unit)
+                    && pHeader->offWords   <= nSize && pHeader->numWords   <= (nSize - pHeader->offWords)   / sizeof(ImageWord)
+                    && pHeader->offLexemes <= nSize && pHeader->numLexemes <= (nSize - pHeader->offLexemes) / sizeof(ImageLexeme)
+                    && pHeader->offPOS     <= nSize && pHeader->numPOS     <= (nSize - pHeader->offPOS)     / sizeof(ImagePOS)
+                    && pHeader->offStrings <= nSize && pHeader->sizeStrings <= nSize - pHeader->offStrings
+                    && pHeader->sizeStrings > 0 && pData[pHeader->offStrings + pHeader->sizeStrings - 1] == 0;
+                if (!valid)
+                {
+                    m_imageFile.close();
+                    return false;
+                }
+
+                // use the data in the image directly
+                m_pImage = pHeader;
+                m_wordTrie.assign((const cmn::CDoubleArrayTrie::Unit*)(pData + pHeader->offUnits), pHeader->numUnits);
+                m_nMaxWordLen = pHeader->maxWordLen;
+                m_descriptor.wstrLanguage = getImageString(pHeader->language);
+                m_descriptor.wstrAlphabet = getImageString(pHeader->alphabet);
+                return true;
+            }
+
+            void CLexiconData::unpackImage()
+            {
+                if (m_pImage == NULL)
+                    return;
+
+                // convert word entries
+                const ImageWord *pWords = (const ImageWord*)((const char*)m_pImage + m_pImage->offWords);
+                const ImageLexeme *pLexemes = (const ImageLexeme*)((const char*)m_pImage + m_pImage->offLexemes);
+                m_vecLexemes.resize(m_pImage->numWords);
+                for (uint32 i = 0; i < m_pImage->numWords; i++)
+                {
+                    RawLexeme newLexeme;
+                    newLexeme.wstrGrapheme = getImageString(pWords[i].grapheme);
+                    for (uint32 j = pWords[i].firstLexeme; j < pWords[i].firstLexeme + pWords[i].numLexemes && j < m_pImage->numLexemes; j++)
+                    {
+                        newLexeme.wstrPhoneme = getImageString(pLexemes[j].phoneme);
+                        newLexeme.wstrPOS     = getImageString(pLexemes[j].pos);
+                        newLexeme.nFrequency  = pLexemes[j].frequency;
+                        m_vecLexemes[i].push_back(newLexeme);
+                    }
+                    m_mapLexemes.insert(std::make_pair(newLexeme.wstrGrapheme, (size_t)i));
+                }
+
+                // convert POS frequency table
+                const ImagePOS *pPOS = (const ImagePOS*)((const char*)m_pImage + m_pImage->offPOS);
+                for (uint32 i = 0; i < m_pImage->numPOS; i++)
+                {
+                    m_mapPOSFrequency[getImageString(pPOS[i].pos)] = pPOS[i].frequency;
+                }
+
+                // unmap the image
+                m_wordTrie.clear();
+                m_imageFile.close();
+                m_pImage = NULL;
+            }
+
+            std::wstring CLexiconData::getImageString(uint32 offset) const
+            {
+                std::wstring wstr;
+                if (offset < m_pImage->sizeStrings)
+                {
+                    utf8ToWcs((const char*)m_pImage + m_pImage->offStrings + offset, wstr);
+                }
+                return wstr;
+            }
+
+            const CLexiconData::ImageWord *CLexiconData::findImageWord(const std::wstring &wstrWord) const
+            {
+                std::string key;
+                wcsToUTF8(wstrWord.c_str(), wstrWord.length(), key);
+                int index = m_wordTrie.exactMatch(key.c_str(), key.length());
+                if (index < 0 || (uint32)index >= m_pImage->numWords)
+                    return NULL;
+                return (const ImageWord*)((const char*)m_pImage + m_pImage->offWords) + index;
+            }
+
+            bool CLexiconData::save(const wchar_t *fileName) const
+            {
+                cmn::CFile binFile;
+                if (!binFile.open(fileName, L"wb"))
+                    return false;
+
+                if (m_pImage != NULL)
+                {
+                    // save the binary image directly
+                    return binFile.write(m_imageFile.getData(), m_imageFile.getSize(), 1) == 1;
+                }
+
+                // string section
+                std::string strings(1, '\0');  // empty string at offset 0
+                std::map<std::string, uint32> mapStrings;
+                mapStrings[""] = 0;
+
+                // sort words by the UTF-8 keys for building the double-array trie
+                std::vector<std::pair<std::string, size_t> > sortedWords;
+                sortedWords.reserve(m_mapLexemes.size());
+                for (std::map<std::wstring, size_t>::const_iterator it = m_mapLexemes.begin(); it != m_mapLexemes.end(); ++it)
+                {
+                    std::string key;
+                    wcsToUTF8(it->first.c_str(), it->first.length(), key);
+                    sortedWords.push_back(std::make_pair(key, it->second));
+                }
+                std::sort(sortedWords.begin(), sortedWords.end());
+
+                // word and lexeme entries
+                std::vector<std::string> keys(sortedWords.size());
+                std::vector<int> values(sortedWords.size());
+                std::vector<ImageWord> words(sortedWords.size());
+                std::vector<ImageLexeme> lexemes;
+                for (size_t i = 0; i < sortedWords.size(); i++)
+                {
+                    const std::vector<RawLexeme> &rawLexemes = m_vecLexemes[sortedWords[i].second];
+                    keys[i]   = sortedWords[i].first;
+                    values[i] = (int)i;
+                    words[i].grapheme    = addImageString(rawLexemes.empty() ? std::wstring() : rawLexemes[0].wstrGrapheme, strings, mapStrings);
+                    words[i].firstLexeme = (uint32)lexemes.size();
+                    words[i].numLexemes  = (uint32)rawLexemes.size();
+                    for (std::vector<RawLexeme>::const_iterator it = rawLexemes.begin(); it != rawLexemes.end(); ++it)
+                    {
+                        ImageLexeme lexeme;
+                        lexeme.phoneme   = addImageString(it->wstrPhoneme, strings, mapStrings);
+                        lexeme.pos       = addImageString(it->wstrPOS, strings, mapStrings);
+                        lexeme.frequency = (uint32)it->nFrequency;
+                        lexemes.push_back(lexeme);
+                    }
+                }
+                cmn::CDoubleArrayTrie trie;
+                if (!trie.build(keys, values))
+                    return false;
+
+                // POS frequency entries, sorted by UTF-8 POS for binary search
+                std::vector<std::pair<std::string, std::pair<uint32, uint32> > > sortedPOS;
+                for (std::map<std::wstring, size_t>::const_iterator it = m_mapPOSFrequency.begin(); it != m_mapPOSFrequency.end(); ++it)
+                {
+                    uint32 offset = addImageString(it->first, strings, mapStrings);
+                    sortedPOS.push_back(std::make_pair(std::string(strings.c_str() + offset), std::make_pair(offset, (uint32)it->second)));
+                }
+                std::sort(sortedPOS.begin(), sortedPOS.end());
+                std::vector<ImagePOS> posEntries(sortedPOS.size());
+                for (size_t i = 0; i < sortedPOS.size(); i++)
+                {
+                    posEntries[i].pos       = sortedPOS[i].second.first;
+                    posEntries[i].frequency = sortedPOS[i].second.second;
+                }
+
+                // header
+                ImageHeader header;
+                memset(&header, 0, sizeof(header));
+                memcpy(header.magic, LEXICON_IMAGE_MAGIC, sizeof(header.magic));
+                header.version     = LEXICON_IMAGE_VERSION;
+                header.byteOrder   = 0x01020304;
+                header.maxWordLen  = (uint32)m_nMaxWordLen;
+                header.language    = addImageString(m_descriptor.wstrLanguage, strings, mapStrings);
+                header.alphabet    = addImageString(m_descriptor.wstrAlphabet, strings, mapStrings);
+                header.numUnits    = (uint32)trie.getSize();
+                header.offUnits    = (uint32)sizeof(ImageHeader);
+                header.numWords    = (uint32)words.size();
+                header.offWords    = header.offUnits + header.numUnits * sizeof(cmn::CDoubleArrayTrie::Unit);
+                header.numLexemes  = (uint32)lexemes.size();
+                header.offLexemes  = header.offWords + header.numWords * sizeof(ImageWord);
+                header.numPOS      = (uint32)posEntries.size();
+                header.offPOS      = header.offLexemes + header.numLexemes * sizeof(ImageLexeme);
+                header.sizeStrings = (uint32)strings.size();
+                header.offStrings  = header.offPOS + header.numPOS * sizeof(ImagePOS);
+
+                // write all sections
+                bool succ = binFile.write(&header, sizeof(header), 1) == 1;
+                succ = succ && (header.numUnits   == 0 || binFile.write(trie.getUnits(), sizeof(cmn::CDoubleArrayTrie::Unit), header.numUnits) == header.numUnits);
+                succ = succ && (header.numWords   == 0 || binFile.write(&words[0], sizeof(ImageWord), header.numWords) == header.numWords);
+                succ = succ && (header.numLexemes == 0 || binFile.write(&lexemes[0], sizeof(ImageLexeme), header.numLexemes) == header.numLexemes);
+                succ = succ && (header.numPOS     == 0 || binFile.write(&posEntries[0], sizeof(ImagePOS), header.numPOS) == header.numPOS);
+                succ = succ && binFile.write(strings.c_str(), 1, strings.size()) == strings.size();
+                return succ;
+            }
+
         }//namespace Chinese
     }
 }
@@ -31,6 +31,9 @@
 #define _CST_TTS_CHINESE_LEXICON_DATA_H_
 
 #include "ttsbase/datatext/lexicon_lexicon.h"
+#include "cmn/cmn_type.h"
+#include "cmn/cmn_mapfile.h"
+#include "utils/utl_datrie.h"
 #include <map>
 
 namespace cst
@@ -49,6 +52,11 @@ namespace cst
             ///
             ///
             /// This implementation extends basic Lexicon by incorporating "word appearance frequency" information.
+            ///
+            /// The lexicon can be loaded from CSV file, or from the binary image compiled by save().
+            /// The binary image is mapped into memory read-only and is used directly without parsing,
+            /// where the words are searched with a double-array trie. It is converted into the
+            /// in-memory data only when it is modified (e.g. by addWord() or loading another file).
             /// 
             class CLexiconData : public base::CLexicon
             {
@@ -73,14 +81,23 @@ namespace cst
                 virtual ~CLexiconData();
 
                 ///
-                /// @brief  Load lexicon data from CSV (comma-separated values) file
+                /// @brief  Load lexicon data from CSV (comma-separated values) file, or from binary image file
                 ///
-                /// @param  [in] fileName   Name of the CSV file where lexicon data are stored
+                /// @param  [in] fileName   Name of the CSV file or binary image file where lexicon data are stored
                 ///
                 /// @param  Whether lexicon data are loaded successfully
                 ///
                 virtual bool load(const wchar_t *fileName);
 
+                ///
+                /// @brief  Save lexicon data into binary image file, which can be loaded by load()
+                ///
+                /// @param  [in] fileName   Name of the binary image file where lexicon data are saved
+                ///
+                /// @param  Whether lexicon data are saved successfully
+                ///
+                virtual bool save(const wchar_t *fileName) const;
+
                 ///
                 /// @brief  Clear lexicon data
                 ///
@@ -123,6 +140,20 @@ namespace cst
                 ///
                 virtual size_t lookupWord(const std::wstring &wstrWord, const std::wstring &wstrPOS, CLexeme &lexeme) const;
 
+                ///
+                /// @brief  Search all the words in the lexicon which are the <b>prefixes</b> of the input text (common prefix search)
+                ///
+                /// The text is walked along the double-array trie once, without any memory allocation.
+                ///
+                /// @param  [in]  pText     The input text from which the words start
+                /// @param  [in]  textLen   The length of the input text (number of characters)
+                /// @param  [out] wordLens  Return the lengths of the found words in ascending order
+                /// @param  [in]  maxWords  The maximum number of words which can be returned in wordLens
+                ///
+                /// @return The number of words found
+                ///
+                virtual size_t prefixSearch(const wchar_t *pText, size_t textLen, size_t *wordLens, size_t maxWords) const;
+
                 ///
                 /// @brief  Add one word entry into the lexicon
                 ///
@@ -152,6 +183,13 @@ namespace cst
                 ///
                 void buildPOSFrequencyTable();
 
+                ///
+                /// @brief  Build the double-array trie of the in-memory data for prefix search
+                ///
+                /// The trie is rebuilt after the lexicon file is loaded, and is cleared when word is added.
+                ///
+                bool buildWordTrie();
+
                 ///
                 /// @brief  Internal raw lexeme item, used for each lexeme in lexicon.
                 ///         Each word in lexicon has a vector of such raw items.
@@ -166,7 +204,94 @@ namespace cst
                     size_t       nFrequency;        ///< Appearance frequency of the word
                 };
 
+                ///
+                /// @brief  Header of the binary image file of lexicon.
+                ///
+                /// The header is followed by the sections of double-array trie units, word entries,
+                /// lexeme entries, POS frequency entries and UTF-8 strings, each of which is aligned to 4 bytes.
+                /// The offset of each section is counted from the beginning of the file.
+                ///
+                struct ImageHeader
+                {
+                    char   magic[8];        ///< Magic string "CSTLEXI" for identifying the file
+                    uint32 version;         ///< Version of the format of the binary image
+                    uint32 byteOrder;       ///< 0x01020304 in the byte order of the machine where image is saved
+                    uint32 maxWordLen;      ///< Maximum word length (number of characters)
+                    uint32 language;        ///< Offset of the string of language in the string section
+                    uint32 alphabet;        ///< Offset of the string of alphabet in the string section
+                    uint32 numUnits;        ///< Number of units of double-array trie, which maps word to word entry index
+                    uint32 offUnits;        ///< Offset of the double-array trie section
+                    uint32 numWords;        ///< Number of word entries
+                    uint32 offWords;        ///< Offset of the word entry section
+                    uint32 numLexemes;      ///< Number of lexeme entries
+                    uint32 offLexemes;      ///< Offset of the lexeme entry section
+                    uint32 numPOS;          ///< Number of POS frequency entries (sorted by POS)
+                    uint32 offPOS;          ///< Offset of the POS frequency section
+                    uint32 sizeStrings;     ///< Size of string section (in byte)
+                    uint32 offStrings;      ///< Offset of the string section
+                };
+
+                ///
+                /// @brief  Word entry of the binary image file of lexicon
+                ///
+                struct ImageWord
+                {
+                    uint32 grapheme;        ///< Offset of the string of word text
+                    uint32 firstLexeme;     ///< Index of the first lexeme entry of the word
+                    uint32 numLexemes;      ///< Number of lexeme entries of the word
+                };
+
+                ///
+                /// @brief  Lexeme entry of the binary image file of lexicon
+                ///
+                struct ImageLexeme
+                {
+                    uint32 phoneme;         ///< Offset of the string of phoneme
+                    uint32 pos;             ///< Offset of the string of part-of-speech
+                    uint32 frequency;       ///< Appearance frequency of the word
+                };
+
+                ///
+                /// @brief  POS frequency entry of the binary image file of lexicon
+                ///
+                struct ImagePOS
+                {
+                    uint32 pos;             ///< Offset of the string of part-of-speech
+                    uint32 frequency;       ///< Appearance frequency of the POS
+                };
+
+                ///
+                /// @brief  Map the binary image file into memory and use it as the lexicon data
+                ///
+                /// @param  [in] fileName   Name of the binary image file
+                ///
+                /// @param  Whether binary image is loaded successfully
+                ///
+                bool loadImage(const wchar_t *fileName);
+
+                ///
+                /// @brief  Convert the data of the mapped binary image into the in-memory data, and unmap the image
+                ///
+                void unpackImage();
+
+                ///
+                /// @brief  Retrieve the string stored in the binary image
+                ///
+                std::wstring getImageString(uint32 offset) const;
+
+                ///
+                /// @brief  Search the word in the binary image, return NULL if not found
+                ///
+                const ImageWord *findImageWord(const std::wstring &wstrWord) const;
+
             protected:
+                /// Mapped binary image file, which is used as the lexicon data if it is opened
+                cmn::CMappedFile m_imageFile;
+                /// Double-array trie which maps word (UTF-8) to word entry index in binary image (or in m_vecLexemes)
+                cmn::CDoubleArrayTrie m_wordTrie;
+                /// Header of the binary image, NULL if binary image is not used
+                const ImageHeader *m_pImage;
+
                 /// Vector storing lexicon data
                 std::vector<std::vector<RawLexeme> > m_vecLexemes;
                 /// Mapping between word and lexeme index
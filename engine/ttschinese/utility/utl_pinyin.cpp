@@ -28,7 +28,6 @@
 
 
 #include "cmn/cmn_string.h"
-#include "utils/utl_regexp.h"
 #include "utl_pinyin.h"
 
 namespace cst
@@ -105,13 +104,14 @@ namespace cst
                 {
                     // with initial and final
                     // initial should be: b p m f d t n l g k h j q x z c s r zh ch sh
-                    static std::wstring strInitial = L"b|p|m|f|d|t|n|l|g|k|h|j|q|x|zh?|ch?|sh?|r";
-                    static std::wstring strPinyin = L"^("+strInitial+L")(.+)$";
-                    static cmn::CRegexp regPinyin = cmn::CRegexp(strPinyin.c_str());
-                    if (regPinyin.compiled() && regPinyin.match(p))
+                    // (matched directly instead of shared regular expression, so that it can be called by several threads)
+                    size_t len = 0;
+                    if (p[0] != 0 && wcschr(L"bpmfdtnlgkhjqxzcsr", p[0]) != NULL)
+                        len = (p[1] == L'h' && p[2] != 0 && wcschr(L"zcs", p[0]) != NULL) ? 2 : 1;
+                    if (len > 0 && p[len] != 0)
                     {
-                        wcsncpy(initial, p+regPinyin.substart(1), regPinyin.sublength(1));
-                        initial[regPinyin.sublength(1)] = 0;
+                        wcsncpy(initial, p, len);
+                        initial[len] = 0;
                     }
                     wcscpy(final, p+wcslen(initial));
 